@@ -0,0 +1,32 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Weave::Inet project configuration for standalone builds on Linux and OS X.
+ *
+ */
+#ifndef INETPROJECTCONFIG_H
+#define INETPROJECTCONFIG_H
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+// Exercise UDP batch mode in the standalone tests.
+#define INET_CONFIG_UDP_BATCH_SIZE 16
+#endif
+
+#endif /* INETPROJECTCONFIG_H */
@@ -27,6 +27,17 @@
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 // Uncomment this for larger buffers (e.g. to support a bigger WEAVE_CONFIG_TUNNEL_INTERFACE_MTU).
 //#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX 9050
+
+// Exercise the size-classed buffer pools, the per-thread buffer caches and their statistics in the standalone tests.
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL 32
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM 16
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE 4
+#define WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS 1
+
+// Exercise the epoll readiness backend where the platform has one.
+#if defined(__linux__)
+#define WEAVE_SYSTEM_CONFIG_USE_EPOLL 1
+#endif
 #endif
 
 #endif /* SYSTEMPROJECTCONFIG_H */
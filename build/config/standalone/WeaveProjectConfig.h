@@ -39,11 +39,29 @@
 
 #define WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT 1
 
+#define WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS 4
+
+#define WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE 8
+
+#define WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE 1
+
+#define WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING 1
+
 #define WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE 300
 
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE 4
+
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE 512
+
+// Run windowed BDX transfers between the standalone tools; only enable this where every peer understands the window extension.
+#define WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE 4
+
 // Uncomment this for a large Tunnel MTU.
 //#define WEAVE_CONFIG_TUNNEL_INTERFACE_MTU                           (9000)
 
+// Estimate the WRMP retransmission timeout from the observed round-trip times.
+#define WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT 1
+
 // Max number of Bindings per WeaveExchangeManager
 #define WEAVE_CONFIG_MAX_BINDINGS 8
 
@@ -3345,6 +3345,10 @@ WEAVE_ERROR WeaveDeviceManager::StartConnectDevice(uint64_t deviceId, IPAddress
     mDeviceCon->OnConnectionComplete = HandleConnectionComplete;
     mDeviceCon->OnConnectionClosed = HandleConnectionClosed;
 
+    // Receive each message from the device whole, in a buffer of its own, once the connection is up.
+    err = mDeviceCon->SetFramedReceive(true);
+    SuccessOrExit(err);
+
     mConState = kConnectionState_ConnectDevice;
 
     targetIntf = (mDeviceAddr.IsIPv6LinkLocal()) ? mDeviceIntf : INET_NULL_INTERFACEID;
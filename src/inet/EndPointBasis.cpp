@@ -42,7 +42,45 @@ void EndPointBasis::InitEndPointBasis(InetLayer& aInetLayer, void* aAppState)
     mSocket = INET_INVALID_SOCKET_FD;
     mPendingIO.Clear();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    mSocketsEndPointType = kSocketsEndPointType_Unknown;
+    mIOWatch.Init(InetLayer::PrepareEndPointIO, InetLayer::HandleEndPointIO, this);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+/**
+ *  Register the encapsulated socket with the system layer readiness backend.
+ *
+ *  @param[in]  aType   The concrete endpoint class, one of the \c kSocketsEndPointType_* values.
+ *
+ *  @return INET_NO_ERROR on success, otherwise the error reported by Weave::System::Layer::RegisterIO.
+ */
+INET_ERROR EndPointBasis::WatchSocket(uint8_t aType)
+{
+    mSocketsEndPointType = aType;
+
+    return SystemLayer().RegisterIO(mIOWatch, mSocket);
+}
+
+/**
+ *  Remove the encapsulated socket from the system layer readiness backend. Must be called before the socket is closed.
+ */
+void EndPointBasis::UnwatchSocket(void)
+{
+    SystemLayer().UnregisterIO(mIOWatch);
+}
+
+/**
+ *  Have the system layer readiness backend re-evaluate the I/O events the endpoint is interested in before it next waits for
+ *  events. Must be called whenever that interest may have grown outside of the endpoint's own I/O handling.
+ */
+void EndPointBasis::UpdateSocketWatch(void)
+{
+    SystemLayer().UpdateIO(mIOWatch);
 }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
 } // namespace Inet
 } // namespace nl
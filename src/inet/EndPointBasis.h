@@ -34,6 +34,10 @@
 
 #include <Weave/Support/NLDLLUtil.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <SystemLayer/SystemLayer.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 //--- Declaration of LWIP protocol control buffer structure names
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
@@ -60,6 +64,10 @@ namespace Inet {
  */
 class NL_DLL_EXPORT EndPointBasis : public InetLayerBasis
 {
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    friend class InetLayer;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 public:
     /** Common state codes */
     enum {
@@ -84,6 +92,25 @@ protected:
     int mSocket;                    /**< Encapsulated socket descriptor. */
     IPAddressType mAddrType;        /**< Protocol family, i.e. IPv4 or IPv6. */
     SocketEvents mPendingIO;        /**< Socket event masks */
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    enum
+    {
+        kSocketsEndPointType_Unknown = 0,
+
+        kSocketsEndPointType_Raw     = 1,
+        kSocketsEndPointType_UDP     = 2,
+        kSocketsEndPointType_TCP     = 3,
+        kSocketsEndPointType_Tun     = 4
+    };
+
+    uint8_t mSocketsEndPointType;   /**< Concrete endpoint class, used to dispatch readiness events. */
+    Weave::System::IOWatch mIOWatch; /**< Registration of the socket with the system layer readiness backend. */
+
+    INET_ERROR WatchSocket(uint8_t aType);
+    void UnwatchSocket(void);
+    void UpdateSocketWatch(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
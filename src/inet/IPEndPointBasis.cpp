@@ -96,6 +96,152 @@ union PeerSockAddr
     sockaddr_in  in;
     sockaddr_in6 in6;
 };
+
+/*
+ *  Fill in the header of a message that receives a datagram, its sender address and its control messages into the given
+ *  storage.
+ */
+static void BuildRecvMsgHeader(PacketBuffer *aBuffer, struct msghdr &aMsgHeader, struct iovec &aMsgIOV,
+    PeerSockAddr &aPeerSockAddr, uint8_t *aControlData, size_t aControlDataSize)
+{
+    aMsgIOV.iov_base = aBuffer->Start();
+    aMsgIOV.iov_len = aBuffer->AvailableDataLength();
+
+    memset(&aPeerSockAddr, 0, sizeof (aPeerSockAddr));
+
+    memset(&aMsgHeader, 0, sizeof (aMsgHeader));
+
+    aMsgHeader.msg_name = &aPeerSockAddr;
+    aMsgHeader.msg_namelen = sizeof (aPeerSockAddr);
+    aMsgHeader.msg_iov = &aMsgIOV;
+    aMsgHeader.msg_iovlen = 1;
+    aMsgHeader.msg_control = aControlData;
+    aMsgHeader.msg_controllen = aControlDataSize;
+}
+
+/*
+ *  Extract the source, destination and interface of a received datagram from the header of the message that received it.
+ */
+static INET_ERROR GetRecvPacketInfo(struct msghdr &aMsgHeader, IPPacketInfo &aPacketInfo)
+{
+    const PeerSockAddr &lPeerSockAddr = *static_cast<const PeerSockAddr *>(aMsgHeader.msg_name);
+
+    if (lPeerSockAddr.any.sa_family == AF_INET6)
+    {
+        aPacketInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
+        aPacketInfo.SrcPort = ntohs(lPeerSockAddr.in6.sin6_port);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (lPeerSockAddr.any.sa_family == AF_INET)
+    {
+        aPacketInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
+        aPacketInfo.SrcPort = ntohs(lPeerSockAddr.in.sin_port);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+    {
+        return INET_ERROR_INCORRECT_STATE;
+    }
+
+    for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&aMsgHeader);
+         controlHdr != NULL;
+         controlHdr = CMSG_NXTHDR(&aMsgHeader, controlHdr))
+    {
+#if INET_CONFIG_ENABLE_IPV4
+#ifdef IP_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
+        {
+            struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
+            aPacketInfo.Interface = inPktInfo->ipi_ifindex;
+            aPacketInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
+            continue;
+        }
+#endif // defined(IP_PKTINFO)
+#endif // INET_CONFIG_ENABLE_IPV4
+
+#ifdef IPV6_PKTINFO
+        if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
+        {
+            struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
+            aPacketInfo.Interface = in6PktInfo->ipi6_ifindex;
+            aPacketInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
+            continue;
+        }
+#endif // defined(IPV6_PKTINFO)
+    }
+
+    return INET_NO_ERROR;
+}
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+/*
+ *  The size of the control data kept for each datagram of a batch, enough for an IP_PKTINFO or IPV6_PKTINFO message.
+ */
+enum
+{
+    kBatchControlDataSize = 64
+};
+
+#if HAVE_RECVMMSG && HAVE_SENDMMSG
+typedef struct mmsghdr MMsgHeader;
+#else // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+struct MMsgHeader
+{
+    struct msghdr msg_hdr;
+    unsigned int msg_len;
+};
+#endif // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+
+/*
+ *  Receive up to \c aCount pending datagrams without blocking. Returns the number received, or -1 with errno set if none was.
+ *  Where recvmmsg() is unavailable, this falls back to one recvmsg() call per datagram.
+ */
+static int RecvMMsg(int aSocket, MMsgHeader *aMsgHeaders, unsigned int aCount)
+{
+#if HAVE_RECVMMSG && HAVE_SENDMMSG
+    return recvmmsg(aSocket, aMsgHeaders, aCount, MSG_DONTWAIT, NULL);
+#else // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+    unsigned int i;
+
+    for (i = 0; i < aCount; i++)
+    {
+        const ssize_t rcvLen = recvmsg(aSocket, &aMsgHeaders[i].msg_hdr, MSG_DONTWAIT);
+
+        if (rcvLen < 0)
+            break;
+
+        aMsgHeaders[i].msg_len = static_cast<unsigned int>(rcvLen);
+    }
+
+    return (i > 0) ? static_cast<int>(i) : -1;
+#endif // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+}
+
+/*
+ *  Send up to \c aCount datagrams. Returns the number sent, or -1 with errno set if none was. Where sendmmsg() is
+ *  unavailable, this falls back to one sendmsg() call per datagram.
+ */
+static int SendMMsg(int aSocket, MMsgHeader *aMsgHeaders, unsigned int aCount)
+{
+#if HAVE_RECVMMSG && HAVE_SENDMMSG
+    return sendmmsg(aSocket, aMsgHeaders, aCount, 0);
+#else // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+    unsigned int i;
+
+    for (i = 0; i < aCount; i++)
+    {
+        const ssize_t lenSent = sendmsg(aSocket, &aMsgHeaders[i].msg_hdr, 0);
+
+        if (lenSent < 0)
+            break;
+
+        aMsgHeaders[i].msg_len = static_cast<unsigned int>(lenSent);
+    }
+
+    return (i > 0) ? static_cast<int>(i) : -1;
+#endif // !(HAVE_RECVMMSG && HAVE_SENDMMSG)
+}
+#endif // INET_CONFIG_UDP_BATCH_SIZE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -760,17 +906,19 @@ INET_ERROR IPEndPointBasis::BindInterface(IPAddressType aAddressType, InterfaceI
     return (lRetval);
 }
 
-INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System::PacketBuffer *aBuffer, uint16_t aSendFlags)
+/*
+ *  Fill in the header of a message that sends the single buffer \c aBuffer as specified by \c aPktInfo, from a socket of
+ *  address type \c aAddrType bound to the interface \c aBoundIntfId.
+ */
+static INET_ERROR BuildSendMsgHeader(IPAddressType aAddrType, InterfaceId aBoundIntfId, const IPPacketInfo *aPktInfo,
+    PacketBuffer *aBuffer, struct msghdr &msgHeader, struct iovec &msgIOV, PeerSockAddr &peerSockAddr, uint8_t *controlData,
+    size_t controlDataSize)
 {
     INET_ERROR     res = INET_NO_ERROR;
-    PeerSockAddr   peerSockAddr;
-    struct iovec   msgIOV;
-    uint8_t        controlData[256];
-    struct msghdr  msgHeader;
     InterfaceId    intfId = aPktInfo->Interface;
 
     // Ensure the destination address type is compatible with the endpoint address type.
-    VerifyOrExit(mAddrType == aPktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
+    VerifyOrExit(aAddrType == aPktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
 
     // For now the entire message must fit within a single buffer.
     VerifyOrExit(aBuffer->Next() == NULL, res = INET_ERROR_MESSAGE_TOO_LONG);
@@ -785,7 +933,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
     // Construct a sockaddr_in/sockaddr_in6 structure containing the destination information.
     memset(&peerSockAddr, 0, sizeof (peerSockAddr));
     msgHeader.msg_name = &peerSockAddr;
-    if (mAddrType == kIPAddressType_IPv6)
+    if (aAddrType == kIPAddressType_IPv6)
     {
         peerSockAddr.in6.sin6_family    = AF_INET6;
         peerSockAddr.in6.sin6_port      = htons(aPktInfo->DestPort);
@@ -811,7 +959,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
     // don't seem to get sent out the correct interface, despite
     // the socket being bound.
     if (intfId == INET_NULL_INTERFACEID)
-        intfId = mBoundIntfId;
+        intfId = aBoundIntfId;
 
     // If the packet should be sent over a specific interface, or with a specific source
     // address, construct an IP_PKTINFO/IPV6_PKTINFO "control message" to that effect
@@ -820,15 +968,15 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
     if (intfId != INET_NULL_INTERFACEID || aPktInfo->SrcAddress.Type() != kIPAddressType_Any)
     {
 #if defined(IP_PKTINFO) || defined(IPV6_PKTINFO)
-        memset(controlData, 0, sizeof(controlData));
+        memset(controlData, 0, controlDataSize);
         msgHeader.msg_control = controlData;
-        msgHeader.msg_controllen = sizeof(controlData);
+        msgHeader.msg_controllen = controlDataSize;
 
         struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
 
 #if INET_CONFIG_ENABLE_IPV4
 
-        if (mAddrType == kIPAddressType_IPv4)
+        if (aAddrType == kIPAddressType_IPv4)
         {
 #if defined(IP_PKTINFO)
             controlHdr->cmsg_level = IPPROTO_IP;
@@ -847,7 +995,7 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
 
 #endif // INET_CONFIG_ENABLE_IPV4
 
-        if (mAddrType == kIPAddressType_IPv6)
+        if (aAddrType == kIPAddressType_IPv6)
         {
 #if defined(IPV6_PKTINFO)
             controlHdr->cmsg_level = IPPROTO_IPV6;
@@ -871,6 +1019,22 @@ INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System:
 #endif // !(defined(IP_PKTINFO) && defined(IPV6_PKTINFO))
     }
 
+exit:
+    return (res);
+}
+
+INET_ERROR IPEndPointBasis::SendMsg(const IPPacketInfo *aPktInfo, Weave::System::PacketBuffer *aBuffer, uint16_t aSendFlags)
+{
+    INET_ERROR     res = INET_NO_ERROR;
+    PeerSockAddr   peerSockAddr;
+    struct iovec   msgIOV;
+    uint8_t        controlData[256];
+    struct msghdr  msgHeader;
+
+    res = BuildSendMsgHeader(mAddrType, mBoundIntfId, aPktInfo, aBuffer, msgHeader, msgIOV, peerSockAddr, controlData,
+        sizeof (controlData));
+    SuccessOrExit(res);
+
     // Send IP packet.
     {
         const ssize_t lenSent = sendmsg(mSocket, &msgHeader, 0);
@@ -884,6 +1048,60 @@ exit:
     return (res);
 }
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+/**
+ *  Send up to \c aCount single-buffer messages, specified by the arrays \c aPktInfo and \c aBuffers, as one batch.
+ *
+ *  @param[out]  aNumSent  the number of messages, from the start of the arrays, that were sent.
+ *
+ *  @retval  INET_NO_ERROR  at least one message was sent, or \c aCount was zero.
+ *  @retval  other          the error that prevented sending the first message.
+ */
+INET_ERROR IPEndPointBasis::SendMsgs(const IPPacketInfo *aPktInfo, PacketBuffer *const *aBuffers, size_t aCount, size_t &aNumSent)
+{
+    INET_ERROR      res = INET_NO_ERROR;
+    PeerSockAddr    peerSockAddr[INET_CONFIG_UDP_BATCH_SIZE];
+    struct iovec    msgIOV[INET_CONFIG_UDP_BATCH_SIZE];
+    uint8_t         controlData[INET_CONFIG_UDP_BATCH_SIZE][kBatchControlDataSize];
+    MMsgHeader      msgHeaders[INET_CONFIG_UDP_BATCH_SIZE];
+    unsigned int    count;
+    int             numSent;
+
+    aNumSent = 0;
+
+    if (aCount > INET_CONFIG_UDP_BATCH_SIZE)
+        aCount = INET_CONFIG_UDP_BATCH_SIZE;
+
+    // Stop the batch at the first message that cannot be sent, so that its error is reported when it leads the next batch.
+    for (count = 0; count < aCount; count++)
+    {
+        res = BuildSendMsgHeader(mAddrType, mBoundIntfId, &aPktInfo[count], aBuffers[count], msgHeaders[count].msg_hdr,
+            msgIOV[count], peerSockAddr[count], controlData[count], sizeof (controlData[count]));
+        if (res != INET_NO_ERROR)
+            break;
+
+        msgHeaders[count].msg_len = 0;
+    }
+
+    VerifyOrExit(count > 0, );
+
+    numSent = SendMMsg(mSocket, msgHeaders, count);
+    VerifyOrExit(numSent >= 0, res = Weave::System::MapErrorPOSIX(errno));
+
+    res = INET_NO_ERROR;
+    aNumSent = static_cast<size_t>(numSent);
+
+    for (size_t i = 0; i < aNumSent; i++)
+    {
+        if (msgHeaders[i].msg_len != aBuffers[i]->DataLength())
+            res = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED;
+    }
+
+exit:
+    return (res);
+}
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
 INET_ERROR IPEndPointBasis::GetSocket(IPAddressType aAddressType, int aType, int aProtocol)
 {
     INET_ERROR res = INET_NO_ERROR;
@@ -1025,19 +1243,7 @@ void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
         uint8_t controlData[256];
         struct msghdr msgHeader;
 
-        msgIOV.iov_base = lBuffer->Start();
-        msgIOV.iov_len = lBuffer->AvailableDataLength();
-
-        memset(&lPeerSockAddr, 0, sizeof (lPeerSockAddr));
-
-        memset(&msgHeader, 0, sizeof (msgHeader));
-
-        msgHeader.msg_name = &lPeerSockAddr;
-        msgHeader.msg_namelen = sizeof (lPeerSockAddr);
-        msgHeader.msg_iov = &msgIOV;
-        msgHeader.msg_iovlen = 1;
-        msgHeader.msg_control = controlData;
-        msgHeader.msg_controllen = sizeof (controlData);
+        BuildRecvMsgHeader(lBuffer, msgHeader, msgIOV, lPeerSockAddr, controlData, sizeof (controlData));
 
         ssize_t rcvLen = recvmsg(mSocket, &msgHeader, MSG_DONTWAIT);
 
@@ -1053,52 +1259,7 @@ void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
         {
             lBuffer->SetDataLength((uint16_t) rcvLen);
 
-            if (lPeerSockAddr.any.sa_family == AF_INET6)
-            {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv6(lPeerSockAddr.in6.sin6_addr);
-                lPacketInfo.SrcPort = ntohs(lPeerSockAddr.in6.sin6_port);
-            }
-#if INET_CONFIG_ENABLE_IPV4
-            else if (lPeerSockAddr.any.sa_family == AF_INET)
-            {
-                lPacketInfo.SrcAddress = IPAddress::FromIPv4(lPeerSockAddr.in.sin_addr);
-                lPacketInfo.SrcPort = ntohs(lPeerSockAddr.in.sin_port);
-            }
-#endif // INET_CONFIG_ENABLE_IPV4
-            else
-            {
-                lStatus = INET_ERROR_INCORRECT_STATE;
-            }
-        }
-
-        if (lStatus == INET_NO_ERROR)
-        {
-            for (struct cmsghdr *controlHdr = CMSG_FIRSTHDR(&msgHeader);
-                 controlHdr != NULL;
-                 controlHdr = CMSG_NXTHDR(&msgHeader, controlHdr))
-            {
-#if INET_CONFIG_ENABLE_IPV4
-#ifdef IP_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IP && controlHdr->cmsg_type == IP_PKTINFO)
-                {
-                    struct in_pktinfo *inPktInfo = (struct in_pktinfo *)CMSG_DATA(controlHdr);
-                    lPacketInfo.Interface = inPktInfo->ipi_ifindex;
-                    lPacketInfo.DestAddress = IPAddress::FromIPv4(inPktInfo->ipi_addr);
-                    continue;
-                }
-#endif // defined(IP_PKTINFO)
-#endif // INET_CONFIG_ENABLE_IPV4
-
-#ifdef IPV6_PKTINFO
-                if (controlHdr->cmsg_level == IPPROTO_IPV6 && controlHdr->cmsg_type == IPV6_PKTINFO)
-                {
-                    struct in6_pktinfo *in6PktInfo = (struct in6_pktinfo *)CMSG_DATA(controlHdr);
-                    lPacketInfo.Interface = in6PktInfo->ipi6_ifindex;
-                    lPacketInfo.DestAddress = IPAddress::FromIPv6(in6PktInfo->ipi6_addr);
-                    continue;
-                }
-#endif // defined(IPV6_PKTINFO)
-            }
+            lStatus = GetRecvPacketInfo(msgHeader, lPacketInfo);
         }
     }
     else
@@ -1119,6 +1280,96 @@ void IPEndPointBasis::HandlePendingIO(uint16_t aPort)
 
     return;
 }
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+/**
+ *  Receive up to #INET_CONFIG_UDP_BATCH_SIZE pending datagrams at once, and deliver each of them, with its own addressing
+ *  information, to the message reception delegate.
+ */
+void IPEndPointBasis::HandlePendingIOBatch(uint16_t aPort)
+{
+    INET_ERROR      lStatus = INET_NO_ERROR;
+    PacketBuffer *  lBuffers[INET_CONFIG_UDP_BATCH_SIZE];
+    PeerSockAddr    lPeerSockAddr[INET_CONFIG_UDP_BATCH_SIZE];
+    struct iovec    lMsgIOV[INET_CONFIG_UDP_BATCH_SIZE];
+    uint8_t         lControlData[INET_CONFIG_UDP_BATCH_SIZE][kBatchControlDataSize];
+    MMsgHeader      lMsgHeaders[INET_CONFIG_UDP_BATCH_SIZE];
+    unsigned int    lNumBuffers;
+    int             lNumReceived;
+
+    for (lNumBuffers = 0; lNumBuffers < INET_CONFIG_UDP_BATCH_SIZE; lNumBuffers++)
+    {
+        PacketBuffer *lBuffer = PacketBuffer::New(0);
+
+        if (lBuffer == NULL)
+            break;
+
+        lBuffers[lNumBuffers] = lBuffer;
+        BuildRecvMsgHeader(lBuffer, lMsgHeaders[lNumBuffers].msg_hdr, lMsgIOV[lNumBuffers], lPeerSockAddr[lNumBuffers],
+            lControlData[lNumBuffers], sizeof (lControlData[lNumBuffers]));
+        lMsgHeaders[lNumBuffers].msg_len = 0;
+    }
+
+    VerifyOrExit(lNumBuffers > 0, lStatus = INET_ERROR_NO_MEMORY);
+
+    lNumReceived = RecvMMsg(mSocket, lMsgHeaders, lNumBuffers);
+    VerifyOrExit(lNumReceived >= 0, lStatus = Weave::System::MapErrorPOSIX(errno));
+
+    // Release the buffers left unfilled before delivery, so that the delegates may allocate them.
+    while (lNumBuffers > static_cast<unsigned int>(lNumReceived))
+        PacketBuffer::Free(lBuffers[--lNumBuffers]);
+
+    // A delegate may close or free the endpoint, so hold it until the whole batch has been delivered.
+    Retain();
+
+    for (int i = 0; i < lNumReceived; i++)
+    {
+        INET_ERROR      lMsgStatus;
+        IPPacketInfo    lPacketInfo;
+        PacketBuffer *  lBuffer = lBuffers[i];
+
+        lBuffers[i] = NULL;
+
+        lPacketInfo.Clear();
+        lPacketInfo.DestPort = aPort;
+
+        if (lMsgHeaders[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            lMsgStatus = INET_ERROR_INBOUND_MESSAGE_TOO_BIG;
+        }
+        else
+        {
+            lBuffer->SetDataLength(static_cast<uint16_t>(lMsgHeaders[i].msg_len));
+
+            lMsgStatus = GetRecvPacketInfo(lMsgHeaders[i].msg_hdr, lPacketInfo);
+        }
+
+        if (mState != kState_Listening || OnMessageReceived == NULL)
+        {
+            PacketBuffer::Free(lBuffer);
+        }
+        else if (lMsgStatus == INET_NO_ERROR)
+        {
+            OnMessageReceived(this, lBuffer, &lPacketInfo);
+        }
+        else
+        {
+            PacketBuffer::Free(lBuffer);
+            if (OnReceiveError != NULL)
+                OnReceiveError(this, lMsgStatus, NULL);
+        }
+    }
+
+    Release();
+
+exit:
+    for (unsigned int i = 0; i < lNumBuffers; i++)
+        PacketBuffer::Free(lBuffers[i]);
+
+    if (lStatus != INET_NO_ERROR && OnReceiveError != NULL && lStatus != Weave::System::MapErrorPOSIX(EAGAIN))
+        OnReceiveError(this, lStatus, NULL);
+}
+#endif // INET_CONFIG_UDP_BATCH_SIZE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
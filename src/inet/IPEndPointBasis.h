@@ -146,6 +146,11 @@ protected:
     INET_ERROR GetSocket(IPAddressType aAddressType, int aType, int aProtocol);
     SocketEvents PrepareIO(void);
     void HandlePendingIO(uint16_t aPort);
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+    INET_ERROR SendMsgs(const IPPacketInfo *aPktInfo, Weave::System::PacketBuffer *const *aBuffers, size_t aCount, size_t &aNumSent);
+    void HandlePendingIOBatch(uint16_t aPort);
+#endif // INET_CONFIG_UDP_BATCH_SIZE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 private:
@@ -273,6 +273,41 @@
 #define INET_CONFIG_NUM_UDP_ENDPOINTS                       64
 #endif // INET_CONFIG_NUM_UDP_ENDPOINTS
 
+/**
+ *  @def INET_CONFIG_UDP_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the maximum number of datagrams that a UDP end point in
+ *    batch mode receives for each readiness event, or queues for
+ *    sending together, when using BSD sockets.
+ *
+ *    Where the system provides recvmmsg() and sendmmsg(), each batch
+ *    is transferred with a single system call. Batch mode is enabled
+ *    for an end point with UDPEndPoint::SetBatchMode(). Zero (0)
+ *    disables support for batch mode.
+ *
+ */
+#ifndef INET_CONFIG_UDP_BATCH_SIZE
+#define INET_CONFIG_UDP_BATCH_SIZE                          0
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_MAX_IOVECS
+ *
+ *  @brief
+ *    This is the maximum number of queued buffers that a TCP end
+ *    point hands to the system with a single sendmsg() call when
+ *    draining its send queue, when using BSD sockets.
+ *
+ *    Gathering the queue lets bursts of small messages share one
+ *    system call. One (1) sends each buffer with its own send()
+ *    call.
+ *
+ */
+#ifndef INET_CONFIG_TCP_SEND_MAX_IOVECS
+#define INET_CONFIG_TCP_SEND_MAX_IOVECS                     16
+#endif // INET_CONFIG_TCP_SEND_MAX_IOVECS
+
 /**
  *  @def INET_CONFIG_NUM_TUN_ENDPOINTS
  *
@@ -286,6 +321,23 @@
 #define INET_CONFIG_NUM_TUN_ENDPOINTS                       64
 #endif // INET_CONFIG_NUM_TUN_ENDPOINTS
 
+/**
+ *  @def INET_CONFIG_TUN_RECEIVE_BATCH_SIZE
+ *
+ *  @brief
+ *    This is the maximum number of packets that a TUN end point reads
+ *    from its device for each readiness event, when using BSD sockets.
+ *
+ *    The end point signals the end of each batch with its
+ *    \c OnReceiveComplete delegate, letting the application send the
+ *    results of the batch together. Values above one (1) put the
+ *    device in non-blocking mode.
+ *
+ */
+#ifndef INET_CONFIG_TUN_RECEIVE_BATCH_SIZE
+#define INET_CONFIG_TUN_RECEIVE_BATCH_SIZE                  8
+#endif // INET_CONFIG_TUN_RECEIVE_BATCH_SIZE
+
 /**
  *  @def INET_CONFIG_NUM_DNS_RESOLVERS
  *
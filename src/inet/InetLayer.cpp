@@ -1609,6 +1609,93 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
 #endif // INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+/*
+ * The readiness backend reports events with the same bit values as SocketEvents, so the masks below are exchanged as-is.
+ */
+
+/**
+ *  Returns the I/O events the endpoint that owns \c aWatch is currently interested in.
+ */
+uint8_t InetLayer::PrepareEndPointIO(Weave::System::IOWatch& aWatch)
+{
+    EndPointBasis* lBasis = static_cast<EndPointBasis*>(aWatch.AppState);
+    SocketEvents lEvents;
+
+    switch (lBasis->mSocketsEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Raw:
+        lEvents = static_cast<RawEndPoint*>(lBasis)->PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_UDP:
+        lEvents = static_cast<UDPEndPoint*>(lBasis)->PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_TCP:
+        lEvents = static_cast<TCPEndPoint*>(lBasis)->PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Tun:
+        lEvents = static_cast<TunEndPoint*>(lBasis)->PrepareIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+
+    return static_cast<uint8_t>(lEvents.Value);
+}
+
+/**
+ *  Delivers the I/O events reported by the readiness backend to the endpoint that owns \c aWatch.
+ */
+void InetLayer::HandleEndPointIO(Weave::System::IOWatch& aWatch, uint8_t aEvents)
+{
+    EndPointBasis* lBasis = static_cast<EndPointBasis*>(aWatch.AppState);
+
+    lBasis->mPendingIO.Value = aEvents;
+
+    switch (lBasis->mSocketsEndPointType)
+    {
+#if INET_CONFIG_ENABLE_RAW_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Raw:
+        static_cast<RawEndPoint*>(lBasis)->HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_RAW_ENDPOINT
+
+#if INET_CONFIG_ENABLE_UDP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_UDP:
+        static_cast<UDPEndPoint*>(lBasis)->HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_UDP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TCP_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_TCP:
+        static_cast<TCPEndPoint*>(lBasis)->HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TCP_ENDPOINT
+
+#if INET_CONFIG_ENABLE_TUN_ENDPOINT
+    case EndPointBasis::kSocketsEndPointType_Tun:
+        static_cast<TunEndPoint*>(lBasis)->HandlePendingIO();
+        break;
+#endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+    default:
+        break;
+    }
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 /**
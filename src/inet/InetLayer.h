@@ -186,6 +186,10 @@ class NL_DLL_EXPORT InetLayer
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    friend class EndPointBasis;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
   public:
     /**
      *  The current state of the InetLayer object.
@@ -372,6 +376,10 @@ private:
     AsyncDNSResolverSockets mAsyncDNSResolver;
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    static uint8_t PrepareEndPointIO(Weave::System::IOWatch& aWatch);
+    static void HandleEndPointIO(Weave::System::IOWatch& aWatch, uint8_t aEvents);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
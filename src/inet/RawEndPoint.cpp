@@ -353,6 +353,9 @@ INET_ERROR RawEndPoint::BindIPv6LinkLocal(InterfaceId intf, IPAddress addr)
 
 optfail:
     res = Weave::System::MapErrorPOSIX(errno);
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UnwatchSocket();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
     ::close(mSocket);
     mSocket = INET_INVALID_SOCKET_FD;
     mAddrType = kIPAddressType_Unknown;
@@ -426,6 +429,10 @@ INET_ERROR RawEndPoint::Listen(void)
     // Wake the thread calling select so that it starts selecting on the new socket.
     lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     if (res == INET_NO_ERROR)
@@ -479,6 +486,9 @@ void RawEndPoint::Close(void)
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -1110,6 +1120,14 @@ INET_ERROR RawEndPoint::GetSocket(IPAddressType aAddressType)
     lRetval = IPEndPointBasis::GetSocket(aAddressType, lType, lProtocol);
     SuccessOrExit(lRetval);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (!mIOWatch.IsRegistered())
+    {
+        lRetval = WatchSocket(kSocketsEndPointType_Raw);
+        SuccessOrExit(lRetval);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 exit:
     return (lRetval);
 }
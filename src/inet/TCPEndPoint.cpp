@@ -41,6 +41,7 @@
 #include <InetLayer/InetLayer.h>
 #include <InetLayer/InetFaultInjection.h>
 
+#include <Weave/Core/WeaveEncoding.h>
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Support/logging/WeaveLogging.h>
 
@@ -54,6 +55,7 @@
 #include <sys/select.h>
 #include <net/if.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -283,6 +285,10 @@ INET_ERROR TCPEndPoint::Listen(uint16_t backlog)
     // Wake the thread calling select so that it recognizes the new socket.
     lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     if (res == INET_NO_ERROR)
@@ -504,6 +510,10 @@ INET_ERROR TCPEndPoint::Connect(IPAddress addr, uint16_t port, InterfaceId intf)
     // Wake the thread calling select so that it recognizes the new socket.
     lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     StartConnectTimerIfSet();
@@ -706,6 +716,10 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer *data, bool push)
     else
         mSendQueue->AddToEnd(data);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     if (mUnsentQueue == NULL)
@@ -732,6 +746,17 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer *data, bool push)
     return res;
 }
 
+INET_ERROR TCPEndPoint::PushSendQueue()
+{
+    if (State != kState_Connected && State != kState_ReceiveShutdown)
+        return INET_ERROR_INCORRECT_STATE;
+
+    if (mSendQueue == NULL)
+        return INET_NO_ERROR;
+
+    return DriveSending();
+}
+
 void TCPEndPoint::DisableReceive()
 {
     ReceiveEnabled = false;
@@ -753,6 +778,10 @@ void TCPEndPoint::EnableReceive()
     // in the select read fd_set.
     lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -1073,6 +1102,38 @@ uint32_t TCPEndPoint::PendingReceiveLength()
         return 0;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+void TCPEndPoint::GetSendStatistics(uint32_t &aNumSendCalls, uint64_t &aNumBytesSent) const
+{
+    aNumSendCalls = mNumSendCalls;
+    aNumBytesSent = mNumBytesSent;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+INET_ERROR TCPEndPoint::SetFramedReceive(bool aEnable, uint16_t aReserveSize, uint16_t aTrailerSize)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    if (mFrameBuf != NULL || mFrameRemaining != 0 || mFrameLengthLen != 0)
+        return INET_ERROR_INCORRECT_STATE;
+
+    // Data already queued unframed would be taken for the start of a frame.
+    if (aEnable && !mFramedReceive && mRcvQueue != NULL)
+        return INET_ERROR_INCORRECT_STATE;
+
+    mFramedReceive = aEnable;
+    mFrameReserveSize = aReserveSize;
+    mFrameTrailerSize = aTrailerSize;
+
+    return INET_NO_ERROR;
+#else // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    static_cast<void>(aEnable);
+    static_cast<void>(aReserveSize);
+    static_cast<void>(aTrailerSize);
+
+    return INET_ERROR_NOT_IMPLEMENTED;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+}
+
 INET_ERROR TCPEndPoint::Shutdown()
 {
     INET_ERROR err = INET_NO_ERROR;
@@ -1099,6 +1160,9 @@ INET_ERROR TCPEndPoint::Close()
     // Clear the receive queue.
     PacketBuffer::Free(mRcvQueue);
     mRcvQueue = NULL;
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    DiscardPartialFrame();
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     // Suppress closing callbacks, since the application explicitly called Close().
     OnConnectionClosed = NULL;
@@ -1176,6 +1240,17 @@ void TCPEndPoint::Init(InetLayer *inetLayer)
     // Initialize to zero for using system defaults.
     mConnectTimeoutMsecs = 0;
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    mNumSendCalls = 0;
+    mNumBytesSent = 0;
+    mFrameBuf = NULL;
+    mFrameRemaining = 0;
+    mFrameLengthLen = 0;
+    mFrameReserveSize = 0;
+    mFrameTrailerSize = 0;
+    mFramedReceive = false;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 #if INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
     mUserTimeoutMillis = INET_CONFIG_DEFAULT_TCP_USER_TIMEOUT_MSEC;
 
@@ -1309,9 +1384,34 @@ INET_ERROR TCPEndPoint::DriveSending()
 
     while (mSendQueue != NULL)
     {
-        uint16_t bufLen = mSendQueue->DataLength();
+#if INET_CONFIG_TCP_SEND_MAX_IOVECS > 1
+        // Gather as much of the send queue as fits in one call, keeping the total within the range reported to OnDataSent.
+        struct iovec sendIOV[INET_CONFIG_TCP_SEND_MAX_IOVECS];
+        struct msghdr sendMsg;
+        size_t sendLen = 0;
+        size_t numIOV = 0;
+
+        for (PacketBuffer *buf = mSendQueue; buf != NULL && numIOV < INET_CONFIG_TCP_SEND_MAX_IOVECS; buf = buf->Next())
+        {
+            if (sendLen + buf->DataLength() > UINT16_MAX)
+                break;
+
+            sendIOV[numIOV].iov_base = buf->Start();
+            sendIOV[numIOV].iov_len = buf->DataLength();
+            sendLen += buf->DataLength();
+            numIOV++;
+        }
 
-        ssize_t lenSent = send(mSocket, mSendQueue->Start(), (size_t) bufLen, sendFlags);
+        memset(&sendMsg, 0, sizeof(sendMsg));
+        sendMsg.msg_iov = sendIOV;
+        sendMsg.msg_iovlen = numIOV;
+
+        ssize_t lenSent = sendmsg(mSocket, &sendMsg, sendFlags);
+#else // INET_CONFIG_TCP_SEND_MAX_IOVECS <= 1
+        size_t sendLen = mSendQueue->DataLength();
+
+        ssize_t lenSent = send(mSocket, mSendQueue->Start(), sendLen, sendFlags);
+#endif // INET_CONFIG_TCP_SEND_MAX_IOVECS <= 1
 
         if (lenSent == -1)
         {
@@ -1320,13 +1420,26 @@ INET_ERROR TCPEndPoint::DriveSending()
             break;
         }
 
+        mNumSendCalls++;
+        mNumBytesSent += lenSent;
+
         // Mark the connection as being active.
         MarkActive();
 
-        if (lenSent < bufLen)
-            mSendQueue->ConsumeHead(lenSent);
-        else
+        // Release the buffers that were sent in full, and trim the first one that was sent in part.
+        for (size_t lenRemaining = (size_t) lenSent; mSendQueue != NULL; )
+        {
+            uint16_t bufLen = mSendQueue->DataLength();
+
+            if (lenRemaining < bufLen)
+            {
+                mSendQueue->ConsumeHead(lenRemaining);
+                break;
+            }
+
+            lenRemaining -= bufLen;
             mSendQueue = PacketBuffer::FreeHead(mSendQueue);
+        }
 
         if (OnDataSent != NULL)
             OnDataSent(this, (uint16_t) lenSent);
@@ -1364,7 +1477,7 @@ INET_ERROR TCPEndPoint::DriveSending()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if ((size_t) lenSent < sendLen)
             break;
     }
 
@@ -1544,6 +1657,9 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
                     WeaveLogError(Inet, "SO_LINGER: %d", errno);
             }
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
             if (close(mSocket) != 0 && err == INET_NO_ERROR)
                 err = Weave::System::MapErrorPOSIX(errno);
             mSocket = INET_INVALID_SOCKET_FD;
@@ -1571,6 +1687,9 @@ INET_ERROR TCPEndPoint::DoClose(INET_ERROR err, bool suppressCallback)
         mSendQueue = NULL;
         PacketBuffer::Free(mRcvQueue);
         mRcvQueue = NULL;
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+        DiscardPartialFrame();
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
         // Call the appropriate app callback if allowed.
         if (!suppressCallback)
@@ -2235,6 +2354,16 @@ INET_ERROR TCPEndPoint::GetSocket(IPAddressType addrType)
             return Weave::System::MapErrorPOSIX(errno);
         mAddrType = addrType;
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        INET_ERROR err = WatchSocket(kSocketsEndPointType_TCP);
+        if (err != INET_NO_ERROR)
+        {
+            close(mSocket);
+            mSocket = INET_INVALID_SOCKET_FD;
+            return err;
+        }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
         // If creating an IPv6 socket, tell the kernel that it will be IPv6 only.  This makes it
         // posible to bind two sockets to the same port, one for IPv4 and one for IPv6.
 #ifdef IPV6_V6ONLY
@@ -2338,6 +2467,12 @@ void TCPEndPoint::ReceiveData()
     PacketBuffer *rcvBuf;
     bool isNewBuf = true;
 
+    if (mFramedReceive)
+    {
+        ReceiveFramedData();
+        return;
+    }
+
     if (mRcvQueue == NULL)
         rcvBuf = PacketBuffer::New(0);
     else
@@ -2364,6 +2499,165 @@ void TCPEndPoint::ReceiveData()
     // Attempt to receive data from the socket.
     ssize_t rcvLen = recv(mSocket, rcvBuf->Start() + rcvBuf->DataLength(), rcvBuf->AvailableDataLength(), 0);
 
+    // If new data was received, add it onto the receive queue.
+    if (rcvLen > 0)
+    {
+        if (isNewBuf)
+        {
+            rcvBuf->SetDataLength(rcvBuf->DataLength() + (uint16_t) rcvLen);
+            if (mRcvQueue == NULL)
+                mRcvQueue = rcvBuf;
+            else
+                mRcvQueue->AddToEnd(rcvBuf);
+        }
+
+        else
+            rcvBuf->SetDataLength(rcvBuf->DataLength() + (uint16_t) rcvLen, mRcvQueue);
+    }
+
+    else if (isNewBuf)
+        PacketBuffer::Free(rcvBuf);
+
+    HandleReceiveResult(rcvLen);
+}
+
+void TCPEndPoint::ReceiveFramedData()
+{
+    bool isFirstRead = true;
+
+    // Keep reading until the socket has been drained, so that a burst of frames is received on a single readiness
+    // event rather than one read per event. A read that returns less than was asked for has emptied the socket,
+    // and ends the loop without a further system call. The app may close the endpoint, or stop receiving, as frames
+    // are delivered to it, so the conditions for receiving are checked again before each read.
+    while ((State == kState_Connected || State == kState_SendShutdown) && ReceiveEnabled && OnDataReceived != NULL && mFramedReceive)
+    {
+        struct iovec iov[2];
+        int iovCount = 1;
+        size_t readLen;
+        ssize_t rcvLen;
+        uint16_t bufLen;
+
+        // If a new frame is starting and its length field has not been received in full, read the remainder
+        // of the length field.
+        if (mFrameBuf == NULL && mFrameRemaining == 0 && mFrameLengthLen < kFrameLengthSize)
+        {
+            readLen = kFrameLengthSize - mFrameLengthLen;
+            rcvLen = recv(mSocket, mFrameLength + mFrameLengthLen, readLen, 0);
+            if (rcvLen > 0)
+                mFrameLengthLen += (uint8_t) rcvLen;
+        }
+
+        else
+        {
+            // If a new frame is starting, allocate a buffer able to hold the entire frame.
+            if (mFrameBuf == NULL && mFrameRemaining == 0)
+            {
+                mFrameRemaining = kFrameLengthSize + static_cast<uint32_t>(Weave::Encoding::LittleEndian::Get16(mFrameLength));
+
+                // Surround the frame with the space requested by the app where it fits. A frame larger than the
+                // largest buffer is received into a chain of full-sized buffers.
+                if (mFrameRemaining + mFrameReserveSize + mFrameTrailerSize <= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+                    mFrameBuf = PacketBuffer::NewWithAvailableSize(mFrameReserveSize, mFrameRemaining + mFrameTrailerSize);
+                else if (mFrameRemaining <= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX)
+                    mFrameBuf = PacketBuffer::NewWithAvailableSize(0, mFrameRemaining);
+                else
+                    mFrameBuf = PacketBuffer::New(0);
+                if (mFrameBuf == NULL)
+                {
+                    DoClose(INET_ERROR_NO_MEMORY, false);
+                    return;
+                }
+
+                memcpy(mFrameBuf->Start(), mFrameLength, kFrameLengthSize);
+                mFrameBuf->SetDataLength(kFrameLengthSize);
+                mFrameRemaining -= kFrameLengthSize;
+                mFrameLengthLen = 0;
+
+                // A frame with no contents is complete as soon as its length field is.
+                if (mFrameRemaining == 0)
+                {
+                    QueueFrameBuffer();
+                    DriveReceiving();
+                    continue;
+                }
+            }
+
+            // Otherwise, if the previous buffer of an oversized frame was filled, continue the frame in a new buffer.
+            else if (mFrameBuf == NULL)
+            {
+                mFrameBuf = PacketBuffer::New(0);
+                if (mFrameBuf == NULL)
+                {
+                    DoClose(INET_ERROR_NO_MEMORY, false);
+                    return;
+                }
+            }
+
+            // Read as much of the frame as the buffer will hold. If this can complete the frame, also read the
+            // length field of the following frame, if it has already arrived, to save a separate recv() call.
+            bufLen = mFrameBuf->AvailableDataLength();
+            if (bufLen > mFrameRemaining)
+                bufLen = (uint16_t) mFrameRemaining;
+
+            iov[0].iov_base = mFrameBuf->Start() + mFrameBuf->DataLength();
+            iov[0].iov_len = bufLen;
+            readLen = bufLen;
+
+            if (bufLen == mFrameRemaining)
+            {
+                iov[1].iov_base = mFrameLength;
+                iov[1].iov_len = kFrameLengthSize;
+                iovCount = 2;
+                readLen += kFrameLengthSize;
+            }
+
+            rcvLen = readv(mSocket, iov, iovCount);
+
+            if (rcvLen > 0)
+            {
+                uint16_t frameDataLen = (rcvLen > bufLen) ? bufLen : (uint16_t) rcvLen;
+
+                mFrameBuf->SetDataLength(mFrameBuf->DataLength() + frameDataLen);
+                mFrameRemaining -= frameDataLen;
+                mFrameLengthLen = (uint8_t) (rcvLen - frameDataLen);
+            }
+
+            // Queue the buffer for the app once the frame, or the buffer, is complete. If the peer closed the
+            // connection part way through a frame, queue whatever was received of it.
+            if (mFrameRemaining == 0 || mFrameBuf->AvailableDataLength() == 0 || rcvLen == 0)
+                QueueFrameBuffer();
+        }
+
+        // Having found the socket empty after an earlier read of this event, wait quietly for the next readiness
+        // event.
+        if (rcvLen < 0 && !isFirstRead && errno == EAGAIN)
+            break;
+
+        HandleReceiveResult(rcvLen);
+
+        if (rcvLen <= 0 || static_cast<size_t>(rcvLen) < readLen)
+            break;
+
+        isFirstRead = false;
+    }
+}
+
+void TCPEndPoint::QueueFrameBuffer()
+{
+    if (mFrameBuf->DataLength() == 0)
+        PacketBuffer::Free(mFrameBuf);
+    else if (mRcvQueue == NULL)
+        mRcvQueue = mFrameBuf;
+    else
+        mRcvQueue->AddToEnd(mFrameBuf);
+
+    mFrameBuf = NULL;
+}
+
+void TCPEndPoint::HandleReceiveResult(ssize_t rcvLen)
+{
+    int systemErrno = errno;
+
 #if INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
     INET_ERROR err;
     bool isProgressing = false;
@@ -2401,13 +2695,6 @@ void TCPEndPoint::ReceiveData()
     // If an error occurred, abort the connection.
     if (rcvLen < 0)
     {
-        int systemErrno = errno;
-
-        if (isNewBuf)
-        {
-            PacketBuffer::Free(rcvBuf);
-        }
-
         if (systemErrno == EAGAIN)
         {
             // Note: in this case, we opt to not retry the recv call,
@@ -2430,9 +2717,6 @@ void TCPEndPoint::ReceiveData()
         // If the peer closed their end of the connection...
         if (rcvLen == 0)
         {
-            if (isNewBuf)
-                PacketBuffer::Free(rcvBuf);
-
             // If in the Connected state and the app has provided an OnPeerClose callback,
             // enter the ReceiveShutdown state.  Providing an OnPeerClose callback allows
             // the app to decide whether to keep the send side of the connection open after
@@ -2447,25 +2731,20 @@ void TCPEndPoint::ReceiveData()
             if (OnPeerClose != NULL)
                 OnPeerClose(this);
         }
-
-        // Otherwise, add the new data onto the receive queue.
-        else if (isNewBuf)
-        {
-            rcvBuf->SetDataLength(rcvBuf->DataLength() + (uint16_t) rcvLen);
-            if (mRcvQueue == NULL)
-                mRcvQueue = rcvBuf;
-            else
-                mRcvQueue->AddToEnd(rcvBuf);
-        }
-
-        else
-            rcvBuf->SetDataLength(rcvBuf->DataLength() + (uint16_t) rcvLen, mRcvQueue);
     }
 
     // Drive any received data into the app.
     DriveReceiving();
 }
 
+void TCPEndPoint::DiscardPartialFrame()
+{
+    PacketBuffer::Free(mFrameBuf);
+    mFrameBuf = NULL;
+    mFrameRemaining = 0;
+    mFrameLengthLen = 0;
+}
+
 void TCPEndPoint::HandleIncomingConnection()
 {
     INET_ERROR err = INET_NO_ERROR;
@@ -2531,6 +2810,19 @@ void TCPEndPoint::HandleIncomingConnection()
 #endif // !INET_CONFIG_ENABLE_IPV4
         conEP->Retain();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        err = conEP->WatchSocket(kSocketsEndPointType_TCP);
+        if (err != INET_NO_ERROR)
+        {
+            // The end point now owns the socket; aborting it closes the socket and releases the end point.
+            conEP->Abort();
+            conEP->Release();
+            if (OnAcceptError != NULL)
+                OnAcceptError(this, err);
+            return;
+        }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
         // Call the app's callback function.
         OnConnectionReceived(this, conEP, peerAddr, peerPort);
     }
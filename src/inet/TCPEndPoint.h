@@ -199,6 +199,18 @@ public:
      */
     INET_ERROR Send(Weave::System::PacketBuffer *data, bool push = true);
 
+    /**
+     * @brief   Send the message text queued on TCP connection.
+     *
+     * @retval  INET_NO_ERROR           success: queued text sent.
+     * @retval  INET_ERROR_INCORRECT_STATE  TCP connection not established.
+     *
+     * @details
+     *  Sends the text queued by calls to \c Send with \c push set to
+     *  \c false, as the next call with \c push set to \c true would.
+     */
+    INET_ERROR PushSendQueue(void);
+
     /**
      * @brief   Disable reception.
      *
@@ -327,6 +339,60 @@ public:
      */
     uint32_t PendingReceiveLength(void);
 
+    /**
+     * @brief   Enable or disable length-framed reception.
+     *
+     * @param[in]   aEnable         true to receive whole frames, false to
+     *                              receive data as it arrives.
+     *
+     * @param[in]   aReserveSize    space to reserve ahead of each frame.
+     *
+     * @param[in]   aTrailerSize    space to leave free after each frame.
+     *
+     * @retval  INET_NO_ERROR               success: reception mode changed.
+     * @retval  INET_ERROR_INCORRECT_STATE  a frame is partially received,
+     *                                      or framing is being enabled with
+     *                                      data already in the receive queue.
+     * @retval  INET_ERROR_NOT_IMPLEMENTED  system does not support framing.
+     *
+     * @details
+     *  In framed mode, the data on the connection is taken to be a sequence
+     *  of frames, each preceded by its length as a 16-bit little-endian
+     *  integer, as on a Weave TCP connection. The endpoint reads the length
+     *  of each frame before reading its contents into a buffer sized to
+     *  hold it, and only queues the frame for the application once it has
+     *  been received entirely. Each frame is then delivered contiguous, in
+     *  a buffer of its own. A frame too large for a single buffer is instead
+     *  delivered as a chain of full-sized buffers, queued a buffer at a
+     *  time, the last of which ends with the frame.
+     *
+     *  Each readiness event of the socket reads until the socket has been
+     *  drained, so that a burst of frames is received together. The read
+     *  that completes a frame also takes the length field of the next frame
+     *  when it has already arrived, saving a separate read of it.
+     *
+     *  The reserved and trailing space, when it fits in the buffer, lets
+     *  the application reuse the buffer of a received frame to send a reply.
+     *
+     *  Framing must be enabled before any data has been received, as data
+     *  received and queued before then cannot be split into frames.
+     */
+    INET_ERROR SetFramedReceive(bool aEnable, uint16_t aReserveSize = 0, uint16_t aTrailerSize = 0);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    /**
+     * @brief   Extract the send statistics of the endpoint.
+     *
+     * @param[out]  aNumSendCalls   Number of system calls made to send data.
+     * @param[out]  aNumBytesSent   Number of bytes accepted by those calls.
+     *
+     * @details
+     *  Together, the two counters give the average number of bytes written
+     *  per system call on the connection.
+     */
+    void GetSendStatistics(uint32_t &aNumSendCalls, uint64_t &aNumBytesSent) const;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
     /**
      * @brief   Initiate TCP half close, in other words, finished with sending.
      *
@@ -553,6 +619,23 @@ private:
 
     Weave::System::PacketBuffer *mRcvQueue;
     Weave::System::PacketBuffer *mSendQueue;
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    uint32_t mNumSendCalls;                             // Number of send system calls made on the socket.
+    uint64_t mNumBytesSent;                             // Number of bytes written to the socket.
+
+    enum
+    {
+        kFrameLengthSize = 2                            // Size of the length field preceding each received frame.
+    };
+
+    Weave::System::PacketBuffer *mFrameBuf;             // Buffer holding the frame being received, in framed mode.
+    uint32_t mFrameRemaining;                           // Number of bytes of the current frame yet to be received.
+    uint8_t mFrameLength[kFrameLengthSize];             // Length field of the next frame, as received so far.
+    uint8_t mFrameLengthLen;                            // Number of bytes of the length field received so far.
+    uint16_t mFrameReserveSize;                         // Space to reserve ahead of each received frame.
+    uint16_t mFrameTrailerSize;                         // Space to leave free after each received frame.
+    bool mFramedReceive;                                // Indicates whether framed reception is enabled.
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_TCP_IDLE_CHECK_INTERVAL > 0
     uint16_t mIdleTimeout;                              // in units of INET_TCP_IDLE_CHECK_INTERVAL; zero means no timeout
     uint16_t mRemainingIdleTime;                        // in units of INET_TCP_IDLE_CHECK_INTERVAL
@@ -643,6 +726,10 @@ private:
     SocketEvents PrepareIO(void);
     void HandlePendingIO(void);
     void ReceiveData(void);
+    void ReceiveFramedData(void);
+    void QueueFrameBuffer(void);
+    void HandleReceiveResult(ssize_t rcvLen);
+    void DiscardPartialFrame(void);
     void HandleIncomingConnection(void);
     INET_ERROR BindSrcAddrFromIntf(IPAddressType addrType, InterfaceId intf);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
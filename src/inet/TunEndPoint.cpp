@@ -62,6 +62,9 @@ using namespace nl::Weave::Encoding;
 void TunEndPoint::Init(InetLayer *inetLayer)
 {
     InitEndPointBasis(*inetLayer);
+
+    OnReceiveComplete = NULL;
+    mReceiveEnabled = true;
 }
 
 /**
@@ -396,6 +399,41 @@ exit:
     return err;
 }
 
+/**
+ * @brief   Resume delivering packets read from the tunnel interface.
+ *
+ * @details
+ *  Reverses DisableReceive(). Packets that arrived in the meantime are
+ *  read and delivered to \c OnPacketReceived.
+ */
+void TunEndPoint::EnableReceive (void)
+{
+    mReceiveEnabled = true;
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    // Wake the thread calling select so that it includes the device in the read fd_set.
+    SystemLayer().WakeSelect();
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+}
+
+/**
+ * @brief   Stop delivering packets read from the tunnel interface.
+ *
+ * @details
+ *  Lets a higher layer that cannot accept more packets push back on the
+ *  sender. On POSIX, the packets are left queued in the tunnel device,
+ *  which drops them once its own queue is full. On LwIP, the packets
+ *  are dropped.
+ */
+void TunEndPoint::DisableReceive (void)
+{
+    mReceiveEnabled = false;
+}
+
 /**
  * @brief   Get the tunnel interface identifier.
  *
@@ -519,12 +557,17 @@ exit:
 void TunEndPoint::HandleDataReceived (PacketBuffer *msg)
 {
     INET_ERROR err = INET_NO_ERROR;
-    if (mState == kState_Open && OnPacketReceived != NULL)
+    if (mState == kState_Open && OnPacketReceived != NULL && mReceiveEnabled)
     {
         err = CheckV6Sanity(msg);
         if (err == INET_NO_ERROR)
         {
             OnPacketReceived(this, msg);
+
+            if (OnReceiveComplete != NULL)
+            {
+                OnReceiveComplete(this);
+            }
         }
         else
         {
@@ -684,6 +727,14 @@ INET_ERROR TunEndPoint::TunDevOpen (const char *intfName)
         ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
     }
 
+#if INET_CONFIG_TUN_RECEIVE_BATCH_SIZE > 1
+    // Reading a batch of packets relies on the read after the last one failing rather than blocking.
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) < 0)
+    {
+        ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
+    }
+#endif // INET_CONFIG_TUN_RECEIVE_BATCH_SIZE > 1
+
     //Verify name
     memset(&ifr, 0, sizeof(ifr));
     if (TunGetInterface(fd, &ifr) < 0)
@@ -701,6 +752,11 @@ INET_ERROR TunEndPoint::TunDevOpen (const char *intfName)
         ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
     }
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    ret = WatchSocket(kSocketsEndPointType_Tun);
+    SuccessOrExit(ret);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 exit:
 
     if (ret != INET_NO_ERROR)
@@ -716,6 +772,9 @@ void TunEndPoint::TunDevClose (void)
 {
     if (mSocket >= 0)
     {
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        UnwatchSocket();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
         close(mSocket);
     }
     mSocket = INET_INVALID_SOCKET_FD;
@@ -758,7 +817,7 @@ SocketEvents TunEndPoint::PrepareIO ()
 {
     SocketEvents res;
 
-    if (mState == kState_Open && OnPacketReceived != NULL)
+    if (mState == kState_Open && OnPacketReceived != NULL && mReceiveEnabled)
     {
         res.SetRead();
     }
@@ -766,13 +825,18 @@ SocketEvents TunEndPoint::PrepareIO ()
     return res;
 }
 
-/* Read from the Tun device in Linux and pass up to upper layer callback */
+/* Read a batch of packets from the Tun device in Linux and pass each up to upper layer callback */
 void TunEndPoint::HandlePendingIO ()
 {
     INET_ERROR err = INET_NO_ERROR;
+    bool received = false;
 
-    if (mState == kState_Open && OnPacketReceived != NULL && mPendingIO.IsReadable())
+    for (int i = 0; i < INET_CONFIG_TUN_RECEIVE_BATCH_SIZE; i++)
     {
+        if (!(mState == kState_Open && OnPacketReceived != NULL && mReceiveEnabled && mPendingIO.IsReadable()))
+        {
+            break;
+        }
 
         PacketBuffer *buf = PacketBuffer::New(0);
 
@@ -780,6 +844,14 @@ void TunEndPoint::HandlePendingIO ()
         {
             //Read data from Tun Device
             err = TunDevRead(buf);
+
+            // Finding the device empty ends the batch.
+            if (err == Weave::System::MapErrorPOSIX(EAGAIN))
+            {
+                PacketBuffer::Free(buf);
+                break;
+            }
+
             if (err == INET_NO_ERROR)
             {
                 err = CheckV6Sanity(buf);
@@ -793,6 +865,7 @@ void TunEndPoint::HandlePendingIO ()
         if (err == INET_NO_ERROR)
         {
             OnPacketReceived(this, buf);
+            received = true;
         }
         else
         {
@@ -801,9 +874,17 @@ void TunEndPoint::HandlePendingIO ()
             {
                 OnReceiveError(this, err);
             }
+
+            // Leave any further packets for the next event.
+            break;
         }
     }
 
+    if (received && mState == kState_Open && OnReceiveComplete != NULL)
+    {
+        OnReceiveComplete(this);
+    }
+
     mPendingIO.Clear();
 }
 
@@ -98,6 +98,7 @@ class IPPacketInfo;
 class NL_DLL_EXPORT TunEndPoint: public EndPointBasis
 {
     friend class InetLayer;
+    friend class TunEndPointTestObject;
 
 public:
 
@@ -151,6 +152,10 @@ public:
 
     INET_ERROR InterfaceDown(void);
 
+    void EnableReceive(void);
+
+    void DisableReceive(void);
+
     /**
      * @brief   Type of packet receive event handler.
      *
@@ -179,6 +184,19 @@ public:
     typedef void (*OnReceiveErrorFunct)(TunEndPoint *endPoint, INET_ERROR err);
     OnReceiveErrorFunct OnReceiveError;
 
+    /**
+     * @brief   Type of receive complete event handler.
+     *
+     * @details
+     *  Type of delegate to a higher layer to act upon the end of a batch of
+     *  packets delivered by \c OnPacketReceived, such as by sending out
+     *  together the messages the batch produced.
+     *
+     * @param[in] endPoint      The TunEndPoint object.
+     */
+    typedef void (*OnReceiveCompleteFunct)(TunEndPoint *endPoint);
+    OnReceiveCompleteFunct OnReceiveComplete;
+
     InterfaceId GetTunnelInterfaceId(void);
 
 private:
@@ -189,6 +207,8 @@ private:
 
     static Weave::System::ObjectPool<TunEndPoint, INET_CONFIG_NUM_TUN_ENDPOINTS> sPool;
 
+    bool mReceiveEnabled;
+
     /** Close the tunnel. */
     void Close(void);
 
@@ -65,6 +65,10 @@
 #define SOCK_FLAGS 0
 #endif
 
+#if INET_CONFIG_UDP_BATCH_SIZE > UINT8_MAX
+#error "INET_CONFIG_UDP_BATCH_SIZE must not exceed 255"
+#endif // INET_CONFIG_UDP_BATCH_SIZE > UINT8_MAX
+
 namespace nl {
 namespace Inet {
 
@@ -317,6 +321,10 @@ INET_ERROR UDPEndPoint::Listen(void)
     // Wake the thread calling select so that it starts selecting on the new socket.
     lSystemLayer.WakeSelect();
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     if (res == INET_NO_ERROR)
@@ -370,6 +378,15 @@ void UDPEndPoint::Close(void)
             // Wake the thread calling select so that it recognizes the socket is closed.
             lSystemLayer.WakeSelect();
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+            // Send what can still be sent of the queued messages.
+            FlushQueuedMsgs();
+            DiscardQueuedMsgs();
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+            UnwatchSocket();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
             close(mSocket);
             mSocket = INET_INVALID_SOCKET_FD;
         }
@@ -655,7 +672,14 @@ INET_ERROR UDPEndPoint::SendMsg(const IPPacketInfo *pktInfo, PacketBuffer *msg,
     res = GetSocket(destAddr.Type());
     SuccessOrExit(res);
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+    if (mBatchMode)
+        res = QueueMsg(pktInfo, msg, sendFlags);
+    else
+        res = IPEndPointBasis::SendMsg(pktInfo, msg, sendFlags);
+#else // !INET_CONFIG_UDP_BATCH_SIZE
     res = IPEndPointBasis::SendMsg(pktInfo, msg, sendFlags);
+#endif // !INET_CONFIG_UDP_BATCH_SIZE
 
     if ((sendFlags & kSendFlag_RetainBuffer) == 0)
         PacketBuffer::Free(msg);
@@ -667,6 +691,47 @@ exit:
     return res;
 }
 
+/**
+ * @brief   Enable or disable batch mode.
+ *
+ * @param[in]   aEnable     \c true to enable batch mode, \c false to disable it.
+ *
+ * @retval  INET_NO_ERROR               success: batch mode set as requested
+ * @retval  INET_ERROR_NOT_IMPLEMENTED  batch mode is not supported by the system configuration.
+ *
+ * @details
+ *  In batch mode, up to #INET_CONFIG_UDP_BATCH_SIZE pending datagrams are
+ *  received for each readiness event of the socket, with one recvmmsg()
+ *  call where available, and each of them is delivered to the
+ *  \c OnMessageReceived delegate with its own packet information.
+ *
+ *  Sent messages are queued, then sent together, with one sendmmsg() call
+ *  where available, as soon as the event loop finds the socket writable
+ *  or the queue is full. A queued message is sent from a copy if the
+ *  sender retains its buffer. Errors that occur when a queued message is
+ *  eventually sent are not reported to its sender.
+ *
+ *  Disabling batch mode sends the messages still queued.
+ */
+INET_ERROR UDPEndPoint::SetBatchMode(bool aEnable)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_UDP_BATCH_SIZE
+    if (mBatchMode && !aEnable)
+    {
+        FlushQueuedMsgs();
+        DiscardQueuedMsgs();
+    }
+
+    mBatchMode = aEnable;
+
+    return INET_NO_ERROR;
+#else // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_UDP_BATCH_SIZE)
+    static_cast<void>(aEnable);
+
+    return INET_ERROR_NOT_IMPLEMENTED;
+#endif // !(WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_UDP_BATCH_SIZE)
+}
+
 /**
  * @brief   Bind the endpoint to a network interface.
  *
@@ -736,6 +801,11 @@ exit:
 void UDPEndPoint::Init(InetLayer *inetLayer)
 {
     IPEndPointBasis::Init(inetLayer);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_UDP_BATCH_SIZE
+    mBatchMode = false;
+    mNumQueuedMsgs = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_UDP_BATCH_SIZE
 }
 
 /**
@@ -909,13 +979,28 @@ INET_ERROR UDPEndPoint::GetSocket(IPAddressType aAddressType)
     lRetval = IPEndPointBasis::GetSocket(aAddressType, lType, lProtocol);
     SuccessOrExit(lRetval);
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (!mIOWatch.IsRegistered())
+    {
+        lRetval = WatchSocket(kSocketsEndPointType_UDP);
+        SuccessOrExit(lRetval);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 exit:
     return (lRetval);
 }
 
 SocketEvents UDPEndPoint::PrepareIO(void)
 {
-    return (IPEndPointBasis::PrepareIO());
+    SocketEvents res = IPEndPointBasis::PrepareIO();
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+    if (mNumQueuedMsgs > 0)
+        res.SetWrite();
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
+    return (res);
 }
 
 void UDPEndPoint::HandlePendingIO(void)
@@ -924,12 +1009,145 @@ void UDPEndPoint::HandlePendingIO(void)
     {
         const uint16_t lPort = mBoundPort;
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+        if (mBatchMode)
+            IPEndPointBasis::HandlePendingIOBatch(lPort);
+        else
+            IPEndPointBasis::HandlePendingIO(lPort);
+#else // !INET_CONFIG_UDP_BATCH_SIZE
         IPEndPointBasis::HandlePendingIO(lPort);
+#endif // !INET_CONFIG_UDP_BATCH_SIZE
     }
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+    if (mNumQueuedMsgs > 0 && mPendingIO.IsWriteable())
+        FlushQueuedMsgs();
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
     mPendingIO.Clear();
 }
 
+#if INET_CONFIG_UDP_BATCH_SIZE
+/*
+ *  Queue a message to be sent with the rest of its batch, first sending the queued messages if the queue is full. The queue
+ *  holds its own reference to the buffer, or to a copy of it if the sender retains the buffer.
+ */
+INET_ERROR UDPEndPoint::QueueMsg(const IPPacketInfo *pktInfo, PacketBuffer *msg, uint16_t sendFlags)
+{
+    INET_ERROR res = INET_NO_ERROR;
+    QueuedMsg *lQueuedMsg;
+
+    // Check what can be checked now, as errors found when the message is eventually sent are not reported to the sender.
+    VerifyOrExit(mAddrType == pktInfo->DestAddress.Type(), res = INET_ERROR_BAD_ARGS);
+    VerifyOrExit(msg->Next() == NULL, res = INET_ERROR_MESSAGE_TOO_LONG);
+
+    if (mNumQueuedMsgs == INET_CONFIG_UDP_BATCH_SIZE)
+    {
+        res = FlushQueuedMsgs();
+        VerifyOrExit(mNumQueuedMsgs < INET_CONFIG_UDP_BATCH_SIZE, );
+        res = INET_NO_ERROR;
+    }
+
+    lQueuedMsg = &mQueuedMsgs[mNumQueuedMsgs];
+
+    if (sendFlags & kSendFlag_RetainBuffer)
+    {
+        lQueuedMsg->Buffer = PacketBuffer::NewWithAvailableSize(0, msg->DataLength());
+
+        // Without a buffer for the copy, send the message right away.
+        if (lQueuedMsg->Buffer == NULL)
+            ExitNow(res = IPEndPointBasis::SendMsg(pktInfo, msg, sendFlags));
+
+        memcpy(lQueuedMsg->Buffer->Start(), msg->Start(), msg->DataLength());
+        lQueuedMsg->Buffer->SetDataLength(msg->DataLength());
+    }
+    else
+    {
+        msg->AddRef();
+        lQueuedMsg->Buffer = msg;
+    }
+
+    lQueuedMsg->SrcAddress = pktInfo->SrcAddress;
+    lQueuedMsg->DestAddress = pktInfo->DestAddress;
+    lQueuedMsg->Interface = pktInfo->Interface;
+    lQueuedMsg->DestPort = pktInfo->DestPort;
+
+    // Wake the thread calling select so that it watches for the socket to become writable.
+    if (mNumQueuedMsgs++ == 0)
+    {
+        SystemLayer().WakeSelect();
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+        UpdateSocketWatch();
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    }
+
+exit:
+    return res;
+}
+
+/*
+ *  Send as many of the queued messages as the socket accepts without blocking. A message that fails for any other reason is
+ *  dropped. Returns the last error encountered.
+ */
+INET_ERROR UDPEndPoint::FlushQueuedMsgs(void)
+{
+    INET_ERROR res = INET_NO_ERROR;
+
+    while (mNumQueuedMsgs > 0)
+    {
+        IPPacketInfo lPktInfo[INET_CONFIG_UDP_BATCH_SIZE];
+        PacketBuffer *lBuffers[INET_CONFIG_UDP_BATCH_SIZE];
+        INET_ERROR lErr;
+        size_t lNumSent;
+        size_t i;
+
+        for (i = 0; i < mNumQueuedMsgs; i++)
+        {
+            lPktInfo[i].Clear();
+            lPktInfo[i].SrcAddress = mQueuedMsgs[i].SrcAddress;
+            lPktInfo[i].DestAddress = mQueuedMsgs[i].DestAddress;
+            lPktInfo[i].Interface = mQueuedMsgs[i].Interface;
+            lPktInfo[i].DestPort = mQueuedMsgs[i].DestPort;
+            lBuffers[i] = mQueuedMsgs[i].Buffer;
+        }
+
+        lErr = SendMsgs(lPktInfo, lBuffers, mNumQueuedMsgs, lNumSent);
+
+        if (lErr != INET_NO_ERROR)
+            res = lErr;
+
+        if (lNumSent == 0)
+        {
+            // Keep the queue until the socket becomes writable again.
+            if (lErr == Weave::System::MapErrorPOSIX(EAGAIN) || lErr == Weave::System::MapErrorPOSIX(EWOULDBLOCK))
+                break;
+
+            WeaveLogError(Inet, "UDP batch send failed: %d", lErr);
+            lNumSent = 1;
+        }
+
+        for (i = 0; i < lNumSent; i++)
+            PacketBuffer::Free(mQueuedMsgs[i].Buffer);
+
+        for (i = lNumSent; i < mNumQueuedMsgs; i++)
+            mQueuedMsgs[i - lNumSent] = mQueuedMsgs[i];
+
+        mNumQueuedMsgs = static_cast<uint8_t>(mNumQueuedMsgs - lNumSent);
+    }
+
+    return res;
+}
+
+/*
+ *  Free the queued messages without sending them.
+ */
+void UDPEndPoint::DiscardQueuedMsgs(void)
+{
+    while (mNumQueuedMsgs > 0)
+        PacketBuffer::Free(mQueuedMsgs[--mNumQueuedMsgs].Buffer);
+}
+#endif // INET_CONFIG_UDP_BATCH_SIZE
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
@@ -61,6 +61,7 @@ public:
     INET_ERROR SendTo(IPAddress addr, uint16_t port, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
     INET_ERROR SendTo(IPAddress addr, uint16_t port, InterfaceId intfId, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
     INET_ERROR SendMsg(const IPPacketInfo *pktInfo, Weave::System::PacketBuffer *msg, uint16_t sendFlags = 0);
+    INET_ERROR SetBatchMode(bool aEnable);
     void Close(void);
     void Free(void);
 
@@ -89,6 +90,26 @@ private:
     INET_ERROR GetSocket(IPAddressType addrType);
     SocketEvents PrepareIO(void);
     void HandlePendingIO(void);
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+    /** A message waiting to be sent with the rest of its batch. */
+    struct QueuedMsg
+    {
+        Weave::System::PacketBuffer *Buffer;
+        IPAddress SrcAddress;
+        IPAddress DestAddress;
+        InterfaceId Interface;
+        uint16_t DestPort;
+    };
+
+    bool mBatchMode;
+    uint8_t mNumQueuedMsgs;
+    QueuedMsg mQueuedMsgs[INET_CONFIG_UDP_BATCH_SIZE];
+
+    INET_ERROR QueueMsg(const IPPacketInfo *pktInfo, Weave::System::PacketBuffer *msg, uint16_t sendFlags);
+    INET_ERROR FlushQueuedMsgs(void);
+    void DiscardQueuedMsgs(void);
+#endif // INET_CONFIG_UDP_BATCH_SIZE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 };
 
@@ -111,7 +111,15 @@ bool ExchangeContext::IsResponseExpected(void) const
  */
 void ExchangeContext::SetInitiator(bool inInitiator)
 {
+    // The exchange manager indexes contexts by role, so move an indexed context to the bucket for its new role.
+    const bool reindex = (ExchangeMgr != NULL) && ExchangeMgr->UnindexContext(this);
+
     SetFlag(mFlags, static_cast<uint16_t>(kFlagInitiator), inInitiator);
+
+    if (reindex)
+    {
+        ExchangeMgr->IndexContext(this);
+    }
 }
 
 /**
@@ -452,7 +460,7 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
     }
 
     // Abort early if Throttle is already set;
-    VerifyOrExit(mWRMPThrottleTimeout == 0, err = WEAVE_ERROR_SEND_THROTTLED);
+    VerifyOrExit(!IsWRMPThrottled(), err = WEAVE_ERROR_SEND_THROTTLED);
 
 #else // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
@@ -599,7 +607,7 @@ WEAVE_ERROR ExchangeContext::SendMessage(uint32_t profileId, uint8_t msgType, Pa
             SuccessOrExit(err);
 
             WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMDoubleTx,
-                               entry->nextRetransTime = 0;
+                               ExchangeMgr->WRMPScheduleRetrans(entry, System::Timer::GetCurrentEpoch());
                                ExchangeMgr->WRMPStartTimer()
                                );
 
@@ -744,9 +752,6 @@ WEAVE_ERROR ExchangeContext::EncodeExchHeader(WeaveExchangeHeader *exchangeHeade
         //     to avoid piggybacking uninitialized AckId.
         if (HasPeerRequestedAck())
         {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            ExchangeMgr->WRMPExpireTicks();
-
             exchangeHeader->Flags |= kWeaveExchangeFlag_AckId;
             exchangeHeader->AckMsgId = mPendingPeerAckId;
 
@@ -807,9 +812,6 @@ void ExchangeContext::DoClose(bool clearRetransTable)
     OnKeyError = NULL;
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
-
     OnThrottleRcvd = NULL;
     OnDDRcvd = NULL;
     OnSendError = NULL;
@@ -904,9 +906,8 @@ void ExchangeContext::Release(void)
 
         DoClose(false);
         mRefCount = 0;
-        ExchangeMgr = NULL;
 
-        em->mContextsInUse--;
+        em->FreeContext(this);
         em->MessageLayer->SignalMessageLayerActivityChanged();
 #if defined(WEAVE_EXCHANGE_CONTEXT_DETAIL_LOGGING)
         WeaveLogProgress(ExchangeManager, "ec-- id: %d [%04" PRIX16 "], inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(this - em->ContextPool), tmpid,  em->mContextsInUse, this);
@@ -1161,6 +1162,23 @@ void ExchangeContext::HandleResponseTimeout(System::Layer* aSystemLayer, void* a
 }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+/**
+ *  Determine whether the peer has throttled sending on this exchange.
+ *  A throttle whose pause time has elapsed is cleared.
+ *
+ *  @return Returns 'true' if sending is throttled, else 'false'.
+ */
+bool ExchangeContext::IsWRMPThrottled(void)
+{
+    if (mWRMPThrottleTimeout != 0 &&
+        !System::Timer::IsEarlierEpoch(System::Timer::GetCurrentEpoch(), mWRMPThrottleTimeout))
+    {
+        mWRMPThrottleTimeout = 0;
+    }
+
+    return mWRMPThrottleTimeout != 0;
+}
+
 bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtxt)
 {
     bool res = false;
@@ -1173,6 +1191,16 @@ bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtx
             //Return context value
             *rCtxt = ExchangeMgr->RetransTable[i].msgCtxt;
 
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+            // Only a message sent once yields an RTT sample, since the Ack of a
+            // retransmitted message cannot be matched to one transmission.
+            if (ExchangeMgr->RetransTable[i].sendCount == 1)
+            {
+                ExchangeMgr->WRMPUpdatePeerRTT(PeerNodeId, static_cast<uint32_t>(System::Timer::GetCurrentEpoch() -
+                                                                                 ExchangeMgr->RetransTable[i].sendTime));
+            }
+#endif
+
             //Clear the entry from the retransmision table.
             ExchangeMgr->ClearRetransmitTable(ExchangeMgr->RetransTable[i]);
 
@@ -1217,14 +1245,22 @@ WEAVE_ERROR ExchangeContext::WRMPFlushAcks(void)
 /**
  *  Get the current retransmit timeout. It would be either the initial or
  *  the active retransmit timeout based on whether the ExchangeContext has
- *  an active message exchange going with its peer.
+ *  an active message exchange going with its peer. When
+ *  #WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT is set, this is reduced
+ *  to the timeout estimated from the round-trip times observed for the peer.
  *
  *  @return the current retransmit time.
  */
 uint32_t ExchangeContext::GetCurrentRetransmitTimeout(void)
 {
-  return (HasRcvdMsgFromPeer() ? mWRMPConfig.mActiveRetransTimeout :
-                                 mWRMPConfig.mInitialRetransTimeout);
+  uint32_t timeout = (HasRcvdMsgFromPeer() ? mWRMPConfig.mActiveRetransTimeout :
+                                             mWRMPConfig.mInitialRetransTimeout);
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+  timeout = ExchangeMgr->WRMPGetPeerRetransTimeout(PeerNodeId, timeout);
+#endif
+
+  return timeout;
 }
 
 /**
@@ -1391,9 +1427,6 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
 {
     WEAVE_ERROR  err = WEAVE_NO_ERROR;
 
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
-
     // If the message IS a duplicate.
     if (msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage)
     {
@@ -1439,7 +1472,8 @@ WEAVE_ERROR ExchangeContext::WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo)
 
         // Replace the Pending ack id.
         mPendingPeerAckId = msgInfo->MessageId;
-        mWRMPNextAckTime = ExchangeMgr->GetTickCounterFromTimeDelta(mWRMPConfig.mAckPiggybackTimeout + System::Timer::GetCurrentEpoch(), ExchangeMgr->mWRMPTimeStampBase);
+        mWRMPNextAckTime = System::Timer::GetCurrentEpoch() + mWRMPConfig.mAckPiggybackTimeout;
+        ExchangeMgr->WRMPScheduleAck(mWRMPNextAckTime);
         SetAckPending(true);
     }
 
@@ -1451,16 +1485,12 @@ exit:
 
 WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    ExchangeMgr->WRMPExpireTicks();
-
     // Flow Control Message Received; Adjust Throttle timeout accordingly.
     // A PauseTimeMillis of zero indicates that peer is unthrottling this Exchange.
 
     if (0 != PauseTimeMillis)
     {
-        mWRMPThrottleTimeout = ExchangeMgr->GetTickCounterFromTimeDelta((System::Timer::GetCurrentEpoch() + PauseTimeMillis),
-                                                                        ExchangeMgr->mWRMPTimeStampBase);
+        mWRMPThrottleTimeout = System::Timer::GetCurrentEpoch() + PauseTimeMillis;
     }
     else
     {
@@ -1478,12 +1508,13 @@ WEAVE_ERROR ExchangeContext::HandleThrottleFlow(uint32_t PauseTimeMillis)
             // Adjust the retrans timer value to account for throttling.
             if (0 != PauseTimeMillis)
             {
-                ExchangeMgr->RetransTable[i].nextRetransTime += PauseTimeMillis / ExchangeMgr->mWRMPTimerInterval;
+                ExchangeMgr->WRMPScheduleRetrans(&ExchangeMgr->RetransTable[i],
+                                                 ExchangeMgr->RetransTable[i].nextRetransTime + PauseTimeMillis);
             }
             // UnThrottle when PauseTimeMillis is set to 0
             else
             {
-                ExchangeMgr->RetransTable[i].nextRetransTime = 0;
+                ExchangeMgr->WRMPScheduleRetrans(&ExchangeMgr->RetransTable[i], System::Timer::GetCurrentEpoch());
             }
             break;
         }
@@ -145,6 +145,48 @@
 #define WEAVE_CONFIG_BDX_SEND_INIT_MAX_METADATA_BYTES 64
 #endif // WEAVE_CONFIG_BDX_SEND_INIT_MAX_METADATA_BYTES
 
+/**
+ *  @def WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE
+ *
+ *  @brief
+ *      Max number of blocks in flight in a sender drive V1 transfer.
+ *
+ *  The window size is negotiated in the SendInit/ReceiveInit and accept
+ *      messages; transfers with legacy peers use a window of 1, i.e.
+ *      stop-and-wait.  Each transfer holds up to this many blocks for
+ *      retransmission (as sender) or reordering (as receiver).  Must not
+ *      exceed 32.
+ *
+ *  Defaults to 1, which disables windowed transfers and leaves the
+ *      messages unchanged on the wire.  Both peers must be built with a
+ *      larger value, e.g. 4, for their transfers to be windowed; the
+ *      larger upload in test-bdx-development.sh then runs windowed.
+ *
+ *  The proposed window size travels as a TLV element appended to the
+ *      metadata of the init and accept messages.  Peers built without
+ *      windowing support cannot tell it apart from the metadata and hand
+ *      it to their application, so only raise this value on devices
+ *      whose BDX peers all understand the window extension.
+ */
+#ifndef WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE
+#define WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE 1
+#endif // WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE
+
+#if (WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE < 1) || (WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE > 32)
+#error "WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE must be between 1 and 32"
+#endif // (WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE < 1) || (WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE > 32)
+
+/**
+ *  @def WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES
+ *
+ *  @brief
+ *      Number of times the unacknowledged blocks of a windowed transfer
+ *      are retransmitted, one exchange response timeout apart, before
+ *      the transfer fails with #WEAVE_ERROR_TIMEOUT.
+ */
+#ifndef WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES
+#define WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES 3
+#endif // WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES
 
 #if (WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT == 0) && (WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT == 0)
 #error "At least one of WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT or WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT must be enabled"
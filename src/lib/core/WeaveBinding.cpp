@@ -446,6 +446,7 @@ void Binding::ResetConfig()
     mDefaultWRMPConfig = gDefaultWRMPConfig;
 #endif
     mUDPPathMTU = WEAVE_CONFIG_DEFAULT_UDP_MTU_SIZE;
+    mMaxChainedPayloadSize = 0;
 
     mSecurityOption = kSecurityOption_NotSpecified;
     mKeyId = WeaveKeyId::kNone;
@@ -1282,6 +1283,54 @@ uint32_t Binding::GetMaxWeavePayloadSize(const System::PacketBuffer *msgBuf)
     return WeaveMessageLayer::GetMaxWeavePayloadSize(msgBuf, isUDP, mUDPPathMTU);
 }
 
+/**
+ * Get the maximum payload size of a message that may be sent over this binding in a chain of
+ * PacketBuffers.
+ *
+ * Chained messages are only supported on TCP connections, where the Weave message length is not
+ * bound by the path MTU and the receiver reassembles messages longer than a buffer.  BLE
+ * connections deliver each message in a single buffer.  The returned size is the limit
+ * configured via Configuration::Transport_MaxChainedPayloadSize(), capped at the largest payload
+ * that fits in a single Weave message.  The limit defaults to 0; set it only when the peer is
+ * known to accept chained messages.
+ *
+ * A peer accepts chained messages only on connections for which it has enabled framed receive,
+ * by calling WeaveConnection::SetFramedReceive() before any data is received.  Without framed
+ * receive, a message longer than a buffer cannot be reassembled, and the peer closes the
+ * connection with #WEAVE_ERROR_MESSAGE_TOO_LONG.
+ *
+ * @return                              The maximum chained payload size, or 0 if messages sent over
+ *                                      this binding must fit in a single PacketBuffer.
+ */
+uint32_t Binding::GetMaxChainedPayloadSize(void) const
+{
+    const uint32_t maxWeavePayloadSize = UINT16_MAX - WEAVE_HEADER_RESERVE_SIZE - WEAVE_TRAILER_RESERVE_SIZE;
+
+    if (!IsConnectionTransport() || (mCon != NULL && mCon->NetworkType != WeaveConnection::kNetworkType_IP))
+        return 0;
+
+    return nl::Weave::min(mMaxChainedPayloadSize, maxWeavePayloadSize);
+}
+
+/**
+ * Set the maximum payload size of a message that may be sent over this binding in a chain of
+ * PacketBuffers.
+ *
+ * Unlike Configuration::Transport_MaxChainedPayloadSize(), this may be called on a binding that
+ * has already been prepared, such as one created by a protocol layer to respond to an incoming
+ * request.
+ *
+ * As with Configuration::Transport_MaxChainedPayloadSize(), the peer must have enabled framed
+ * receive on the connection (see WeaveConnection::SetFramedReceive()) to accept chained messages.
+ *
+ * @param[in] aMaxPayloadSize           The maximum payload size of a chained message, or 0 to
+ *                                      restrict messages to a single PacketBuffer.
+ */
+void Binding::SetMaxChainedPayloadSize(uint32_t aMaxPayloadSize)
+{
+    mMaxChainedPayloadSize = aMaxPayloadSize;
+}
+
 /**
  * Constructs a string describing the peer node and its associated address / connection information.
  *
@@ -1665,6 +1714,27 @@ Binding::Configuration& Binding::Configuration::Transport_UDP_PathMTU(uint32_t a
     return *this;
 }
 
+/**
+ * Allow messages of up to the given payload size to be sent over the binding in a chain of
+ * PacketBuffers, rather than being limited to the capacity of a single buffer.  Only honored for
+ * TCP connections; the peer must be able to receive messages of this size.
+ *
+ * The peer must also have enabled framed receive on its end of the connection, by calling
+ * WeaveConnection::SetFramedReceive() before any data is received.  Otherwise it cannot
+ * reassemble a message longer than a buffer, and closes the connection with
+ * #WEAVE_ERROR_MESSAGE_TOO_LONG.
+ *
+ * @param[in] aMaxPayloadSize           The maximum payload size of a chained message, or 0 to
+ *                                      restrict messages to a single PacketBuffer.
+ *
+ * @return                              A reference to the binding object.
+ */
+Binding::Configuration& Binding::Configuration::Transport_MaxChainedPayloadSize(uint32_t aMaxPayloadSize)
+{
+    mBinding.mMaxChainedPayloadSize = aMaxPayloadSize;
+    return *this;
+}
+
 /**
  * Set the default WRMP configuration for exchange contexts created from this Binding object.
  *
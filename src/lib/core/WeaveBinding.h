@@ -223,6 +223,8 @@ public:
     bool IsAuthenticMessageFromPeer(const WeaveMessageInfo *msgInfo);
 
     uint32_t GetMaxWeavePayloadSize(const System::PacketBuffer *msgBuf);
+    uint32_t GetMaxChainedPayloadSize(void) const;
+    void SetMaxChainedPayloadSize(uint32_t aMaxPayloadSize);
 
     static void DefaultEventHandler(void *apAppState, EventType aEvent, const InEventParam& aInParam, OutEventParam& aOutParam);
 
@@ -298,6 +300,7 @@ private:
     WeaveConnection *mCon;
     uint32_t mDefaultResponseTimeoutMsec;
     uint32_t mUDPPathMTU;
+    uint32_t mMaxChainedPayloadSize;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
     WRMPConfig mDefaultWRMPConfig;
 #endif
@@ -373,6 +376,7 @@ public:
     Configuration& Transport_UDP(void);
     Configuration& Transport_UDP_WRM(void);
     Configuration& Transport_UDP_PathMTU(uint32_t aPathMTU);
+    Configuration& Transport_MaxChainedPayloadSize(uint32_t aMaxPayloadSize);
     Configuration& Transport_DefaultWRMPConfig(const WRMPConfig& aWRMPConfig);
     Configuration& Transport_ExistingConnection(WeaveConnection *apConnection);
 
@@ -1013,6 +1013,20 @@
 #define WEAVE_CONFIG_MAX_PEER_NODES                         128
 #endif // WEAVE_CONFIG_MAX_PEER_NODES
 
+/**
+ *  @def WEAVE_CONFIG_PEER_NODE_HASH_SIZE
+ *
+ *  @brief
+ *    Number of slots in the open-addressed index that the fabric state
+ *    uses to find the state of a peer node by its node identifier.
+ *
+ *  @note This must be greater than #WEAVE_CONFIG_MAX_PEER_NODES.
+ *
+ */
+#ifndef WEAVE_CONFIG_PEER_NODE_HASH_SIZE
+#define WEAVE_CONFIG_PEER_NODE_HASH_SIZE                    (2 * WEAVE_CONFIG_MAX_PEER_NODES)
+#endif // WEAVE_CONFIG_PEER_NODE_HASH_SIZE
+
 /**
  *  @def WEAVE_CONFIG_MAX_CONNECTIONS
  *
@@ -1077,6 +1091,21 @@
 #define WEAVE_CONFIG_MAX_SESSION_KEYS                       WEAVE_CONFIG_MAX_CONNECTIONS
 #endif // WEAVE_CONFIG_MAX_SESSION_KEYS
 
+/**
+ *  @def WEAVE_CONFIG_SESSION_KEY_HASH_SIZE
+ *
+ *  @brief
+ *    Number of slots in the open-addressed index that the fabric state
+ *    uses to find a session key by its key identifier and peer node
+ *    identifier.
+ *
+ *  @note This must be greater than #WEAVE_CONFIG_MAX_SESSION_KEYS.
+ *
+ */
+#ifndef WEAVE_CONFIG_SESSION_KEY_HASH_SIZE
+#define WEAVE_CONFIG_SESSION_KEY_HASH_SIZE                  (2 * WEAVE_CONFIG_MAX_SESSION_KEYS)
+#endif // WEAVE_CONFIG_SESSION_KEY_HASH_SIZE
+
 /**
  *  @def WEAVE_CONFIG_MAX_APPLICATION_EPOCH_KEYS
  *
@@ -1267,6 +1296,32 @@
 #define WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS                  16
 #endif // WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
 
+/**
+ *  @def WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE
+ *
+ *  @brief
+ *    Number of buckets in the index that the exchange manager uses to
+ *    find the exchange context of an inbound message by its exchange
+ *    identifier.
+ *
+ */
+#ifndef WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE
+#define WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE             WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS
+#endif // WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE
+
+/**
+ *  @def WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE
+ *
+ *  @brief
+ *    Number of buckets in the table that the exchange manager uses to
+ *    find the unsolicited message handler of an inbound message by its
+ *    profile identifier and message type.
+ *
+ */
+#ifndef WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE
+#define WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE  WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS
+#endif // WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE
+
 /**
  *  @def WEAVE_CONFIG_MAX_BINDINGS
  *
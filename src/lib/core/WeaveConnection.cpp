@@ -666,7 +666,10 @@ WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffe
     }
 
     // Copy msg to a right-sized buffer if applicable
-    msgBuf = PacketBuffer::RightSize(msgBuf);
+    if (msgBuf->Next() == NULL)
+    {
+        msgBuf = PacketBuffer::RightSize(msgBuf);
+    }
 
 #if CONFIG_NETWORK_LAYER_BLE
     if (mBleEndPoint != NULL)
@@ -676,7 +679,7 @@ WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffe
     else
 #endif
     {
-        res = mTcpEndPoint->Send(msgBuf, true);
+        res = mTcpEndPoint->Send(msgBuf, !GetFlag(mFlags, kFlag_SendDeferred));
     }
     msgBuf = NULL;
 
@@ -690,6 +693,51 @@ exit:
     return res;
 }
 
+/**
+ *  Hold back the messages sent over this connection until FlushSending() is called.
+ *
+ *  The messages are encoded and queued on the TCP connection as they are sent, and are then
+ *  written to the network together, letting a burst of small messages share TCP segments and
+ *  system calls. Messages still queued when the event loop next services the connection are
+ *  written then, so deferral is only meant to span work done without returning to the event
+ *  loop. This has no effect on BLE connections.
+ *
+ *  @sa FlushSending()
+ *
+ */
+void WeaveConnection::DeferSending()
+{
+    SetFlag(mFlags, kFlag_SendDeferred, true);
+}
+
+/**
+ *  Send the messages held back since DeferSending() was called, and resume sending each
+ *  message as it is queued.
+ *
+ *  @retval    #WEAVE_NO_ERROR                on successfully sending the held back messages down
+ *                                            to the network layer, or if there were none.
+ *  @retval    other Inet layer errors related to the TCP endpoint send operation.
+ *
+ *  @sa DeferSending()
+ *
+ */
+WEAVE_ERROR WeaveConnection::FlushSending()
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(GetFlag(mFlags, kFlag_SendDeferred), /* no-op */);
+
+    SetFlag(mFlags, kFlag_SendDeferred, false);
+
+    if (mTcpEndPoint != NULL && StateAllowsSend())
+    {
+        err = mTcpEndPoint->PushSendQueue();
+    }
+
+exit:
+    return err;
+}
+
 /**
  *  Performs a graceful TCP send-shutdown, ensuring all outgoing data has been sent and received
  *  by the peer's TCP stack. With most (but not all) TCP implementations, receipt of a send-shutdown
@@ -1030,6 +1078,44 @@ WEAVE_ERROR WeaveConnection::ResetUserTimeout(void)
     return SetUserTimeout(0);
 }
 
+/**
+ *  Enable or disable framed reception of messages on the connection.
+ *
+ *  With framed reception enabled, the underlying TCP endpoint reads each message whole, using
+ *  the length that precedes it on the connection, and delivers it contiguous in a buffer of its
+ *  own, with room to reuse the buffer for a reply. A message too long for one buffer arrives in
+ *  a chain of full buffers instead. Otherwise, data is received as it arrives and messages are
+ *  split out of it. Messages are received the same way in either mode.
+ *
+ *  Framed reception must be enabled before any data has been received on the connection: either
+ *  before the connection is established, in which case it takes effect once it is, or, for an
+ *  incoming connection, from the callback that delivers the connection to the app. Enabling it
+ *  once data has been received fails with INET_ERROR_INCORRECT_STATE. This has no effect on BLE
+ *  connections.
+ *
+ *  @param[in]    enable       true to receive each message whole, false to receive data as it arrives.
+ *
+ *  @retval  #WEAVE_NO_ERROR                     on successfully changing the mode of reception.
+ *  @retval  other Inet layer errors related to the TCP endpoint framed receive operation, such as
+ *           when a message is partially received or data has already been received.
+ *
+ */
+WEAVE_ERROR WeaveConnection::SetFramedReceive(bool enable)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    if (mTcpEndPoint != NULL)
+    {
+        err = mTcpEndPoint->SetFramedReceive(enable, WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE, WEAVE_TRAILER_RESERVE_SIZE);
+        SuccessOrExit(err);
+    }
+
+    SetFlag(mFlags, kFlag_FramedReceive, enable);
+
+exit:
+    return err;
+}
+
 /**
  *  Set the idle timeout on the underlying network layer connection.
  *
@@ -1347,6 +1433,10 @@ void WeaveConnection::HandleConnectComplete(TCPEndPoint *endPoint, INET_ERROR co
         endPoint->OnDataSent = NULL; // TODO: should handle flow control
         endPoint->OnConnectionClosed = HandleTcpConnectionClosed;
 
+        // If the app asked for it before connecting, receive each message whole, in a buffer of its own.
+        if (GetFlag(con->mFlags, kFlag_FramedReceive))
+            endPoint->SetFramedReceive(true, WEAVE_SYSTEM_CONFIG_HEADER_RESERVE_SIZE, WEAVE_TRAILER_RESERVE_SIZE);
+
         // Disable TCP Nagle buffering by setting TCP_NODELAY socket option to true
         err = endPoint->EnableNoDelay();
         if (err != INET_NO_ERROR)
@@ -1406,6 +1496,20 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
         // Attempt to parse an message from the head of the received data.
         err = msgLayer->DecodeMessageWithLength(data, con->PeerNodeId, con, &msgInfo, &payload, &payloadLen, &frameLen);
 
+        // A message too long for one buffer arrives in a chain of buffers of its own; decode it in place.
+        if (err == WEAVE_ERROR_MESSAGE_TOO_LONG)
+        {
+            err = msgLayer->DecodeChainedMessageWithLength(data, con->PeerNodeId, con, &msgInfo, &payloadBuf, &frameLen);
+
+            // If the message has not been received in full, wait for the rest of it.
+            if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
+            {
+                err = endPoint->AckReceive(frameLen - data->TotalLength());
+                if (err == WEAVE_NO_ERROR)
+                    break;
+            }
+        }
+
         // If the data buffer contains only part of a message...
         if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
         {
@@ -1439,7 +1543,7 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
                 err = WEAVE_ERROR_INVALID_DESTINATION_NODE_ID;
         }
 
-        if (err == WEAVE_NO_ERROR)
+        if (err == WEAVE_NO_ERROR && payloadBuf == NULL)
         {
             // If there's no more data in the current buffer beyond the message that was just parsed,
             // then avoid a copy by giving the buffer to the application layer.
@@ -1474,6 +1578,12 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
         {
             WeaveLogError(MessageLayer, "Con rcv data err %04X %ld", con->LogId(), err);
 
+            if (payloadBuf != NULL)
+            {
+                PacketBuffer::Free(payloadBuf);
+                payloadBuf = NULL;
+            }
+
             // Send key error response to the peer if required.
             if (msgLayer->SecurityMgr->IsKeyError(err))
             {
@@ -386,6 +386,13 @@
  *      IntermediateSolver:
  *          The nominal solver for most applications. Generates reasonably compact notifies in most
  *          cases.
+ *
+ *      BitmapSolver:
+ *          Tracks dirtiness as a per-subscription bitmap of property handles for every subscribed
+ *          trait instance. Trades some RAM (see #WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES)
+ *          for a dirty store that cannot overflow and that is cleared independently for each
+ *          subscriber. Dictionary changes are tracked per key up to
+ *          #WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS, beyond which the dictionary is replaced.
  */
 #ifndef WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER
 #define WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER IntermediateGraphSolver
@@ -416,6 +423,47 @@
 #define WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET 4
 #endif
 
+/**
+ *  @def WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES
+ *
+ *  @brief
+ *    Determines the number of property schema handles the bitmap solver tracks individually for each subscribed trait instance.
+ *    Changes to handles beyond this limit mark the entire trait instance dirty for the affected subscriptions. Only used when
+ *    #WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER is set to BitmapGraphSolver.
+ *
+ */
+#ifndef WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES
+#define WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES 64
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS
+ *
+ *  @brief
+ *    Determines the number of modified and, separately, deleted dictionary elements the bitmap solver tracks by key for each
+ *    subscribed trait instance. Further changes to a dictionary result in it being replaced as a whole. Only used when
+ *    #WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER is set to BitmapGraphSolver.
+ *
+ */
+#ifndef WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS
+#define WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS 4
+#endif
+
+/**
+ *  @def WDM_SCHEMA_TREE_INFO_POOL_SIZE
+ *
+ *  @brief
+ *    Determines the number of entries shared by the tree tables of all trait schemas. A schema's table (first child, next
+ *    sibling, depth and tag-sorted children of every schema handle) is built when the first trait data sink or source over the
+ *    schema is constructed, and makes the tree queries of the schema engine independent of the size of the schema. A schema
+ *    takes one entry per schema handle, plus one for the root. A schema whose table no longer fits is scanned instead.
+ *    0 disables the tables.
+ *
+ */
+#ifndef WDM_SCHEMA_TREE_INFO_POOL_SIZE
+#define WDM_SCHEMA_TREE_INFO_POOL_SIZE 256
+#endif
+
 /**
  *  @def WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE
  *
@@ -428,6 +476,19 @@
 #define WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE  10
 #endif
 
+/**
+ *  @def WDM_UPDATE_PATH_STORE_INDEX_SIZE
+ *
+ *  @brief
+ *    Determines the number of entries in the hash index kept alongside each of the update path stores of a subscription
+ *    client. Every stored path takes one entry for itself and one for each of its ancestors, so this should cover the number
+ *    of items times the typical schema depth. The index turns path deduplication and ancestor/descendant checks into a
+ *    handful of lookups; if it runs out of entries the stores fall back to scanning. 0 disables the index.
+ */
+#ifndef WDM_UPDATE_PATH_STORE_INDEX_SIZE
+#define WDM_UPDATE_PATH_STORE_INDEX_SIZE  (4 * WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE)
+#endif
+
 /**
  *  @def WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT
  *
@@ -441,6 +502,59 @@
 #define WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT 4
 #endif
 
+/**
+ *  @def WDM_PUBLISHER_DEFAULT_MIN_NOTIFY_INTERVAL_MSEC
+ *
+ *  @brief
+ *    The default quiet period, in milliseconds, that an established subscription waits after the most recent change to its
+ *    data before a notify is generated. Rapid successive changes are thereby coalesced into a single notify. 0 disables
+ *    coalescing. Can be adjusted per subscription through SubscriptionHandler::SetNotifyIntervals().
+ *
+ */
+#ifndef WDM_PUBLISHER_DEFAULT_MIN_NOTIFY_INTERVAL_MSEC
+#define WDM_PUBLISHER_DEFAULT_MIN_NOTIFY_INTERVAL_MSEC 0
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_DEFAULT_MAX_NOTIFY_INTERVAL_MSEC
+ *
+ *  @brief
+ *    The default upper bound, in milliseconds, on how long changes to the data of an established subscription can be held back
+ *    by coalescing (see #WDM_PUBLISHER_DEFAULT_MIN_NOTIFY_INTERVAL_MSEC), measured from the first of those changes. 0 bounds
+ *    it by the minimum interval itself.
+ *
+ */
+#ifndef WDM_PUBLISHER_DEFAULT_MAX_NOTIFY_INTERVAL_MSEC
+#define WDM_PUBLISHER_DEFAULT_MAX_NOTIFY_INTERVAL_MSEC 0
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+ *
+ *  @brief
+ *    Determines the maximum number of encoded data elements the notification engine retains within a single evaluation cycle.
+ *    Subscribers that are interested in the same dirty trait instance are handed a copy of the data element encoded for the first
+ *    of them rather than having the trait data serialized again. The cache costs #WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE
+ *    bytes of RAM plus a few bytes per entry and only pays off on publishers with several subscribers to the same traits, so it
+ *    is compiled out (0) by default.
+ *
+ */
+#ifndef WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE 0
+#endif
+
+/**
+ *  @def WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE
+ *
+ *  @brief
+ *    Size in bytes of the arena backing the encoded data element cache (see #WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE). Data elements
+ *    that do not fit in the space left in the arena are encoded directly into each notify.
+ *
+ */
+#ifndef WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE
+#define WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE 512
+#endif
+
 /**
  * The auto-generated schema tables key off this define to enable/disable certain fields in the tables. Enable this for now, but remove this define
  * once it has been similarly removed from the auto-generated code since all products are expected to need dictionary support, so the savings in flash/ram
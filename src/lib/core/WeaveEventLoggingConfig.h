@@ -48,6 +48,141 @@
 #define WEAVE_CONFIG_EVENT_SIZE_INCREMENT 8
 #endif /* WEAVE_CONFIG_EVENT_SIZE_INCREMENT */
 
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
+ *
+ * @brief
+ *   Number of staging buffers into which concurrent producers encode
+ *   their event data before entering the logging critical section.
+ *   Each producer claims a buffer without locking, runs its event
+ *   writer into it, and only holds the critical section while the
+ *   event ID and timestamps are assigned and the pre-encoded data is
+ *   copied into the event buffers.  When all staging buffers are busy,
+ *   or the event data does not fit, the event is encoded under the
+ *   critical section as before.  0 disables staging.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
+#define WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS 0
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_STAGING_BUFFER_SIZE
+ *
+ * @brief
+ *   Size, in bytes, of each staging buffer; see
+ *   #WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_STAGING_BUFFER_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_STAGING_BUFFER_SIZE WEAVE_CONFIG_EVENT_SIZE_RESERVE
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_STAGING_BUFFER_SIZE */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+ *
+ * @brief
+ *   Number of checkpoints kept per importance level to speed up
+ *   locating an event by ID.  A checkpoint records where an event
+ *   lives in the circular buffers together with the state needed to
+ *   resume a scan from it, so that FetchEventsSince and the external
+ *   event lookup do not have to parse the log from the oldest event.
+ *   Checkpoints are dropped as the events they refer to are evicted.
+ *   0 disables the index.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE 0
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL
+ *
+ * @brief
+ *   Minimum number of events between two consecutive checkpoints;
+ *   see #WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL
+#define WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL 16
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+ *
+ * @brief
+ *   Store events in the in-memory event buffers in a compact
+ *   encoding.  The event metadata (importance, timestamp delta,
+ *   trait profile, resource and trait instance, event type and
+ *   related event) is packed into a single byte string of varints,
+ *   and the trait profile, resource and trait instance of an event
+ *   are replaced with an index into a table of recently seen event
+ *   sources.  Events are expanded back into the regular encoding
+ *   when they are fetched from the log.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+#define WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING 0
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES
+ *
+ * @brief
+ *   Number of event sources (trait profile, resource and trait
+ *   instance) the compact encoding refers to by index; see
+ *   #WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING.  Entries are
+ *   assigned on first use and kept for the lifetime of the logging
+ *   subsystem; events from further sources are stored in full.
+ *   Must not exceed 128.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES
+#define WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES 16
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+ *
+ * @brief
+ *   Enable or disable the file-backed archive for events evicted from
+ *   the in-memory event buffers; see EventLogArchive.  Requires a
+ *   POSIX file system with mmap().
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+#define WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE 0
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE
+ *
+ * @brief
+ *   Size, in bytes, of each event archive segment file.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE
+#define WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE 65536
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS
+ *
+ * @brief
+ *   Maximum number of archive segments kept per importance level.
+ *   Once reached, the oldest segment is deleted to make room for a
+ *   new one.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS
+#define WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS 16
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS */
+
+/**
+ * @def WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS
+ *
+ * @brief
+ *   Number of empty archive segments kept ready per importance level,
+ *   to switch to when the current segment fills up.  Archiving the
+ *   events evicted to make room for a single new event may switch
+ *   segments twice before the spares can be replenished; events that
+ *   find no spare segment are dropped.
+ */
+#ifndef WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS
+#define WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS 2
+#endif /* WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS */
+
 /**
  *  @def WEAVE_CONFIG_EVENT_LOGGING_BDX_OFFLOAD
  *
@@ -89,9 +89,20 @@ WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
     memset(ContextPool, 0, sizeof(ContextPool));
     mContextsInUse = 0;
 
+    // Thread every context onto the free list, lowest first.
+    mFreeContexts = NULL;
+    for (int i = WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS - 1; i >= 0; i--)
+    {
+        ContextPool[i].mNextContext = mFreeContexts;
+        mFreeContexts = &ContextPool[i];
+    }
+
+    memset(mContextIndex, 0, sizeof(mContextIndex));
+
     InitBindingPool();
 
     memset(UMHandlerPool, 0, sizeof(UMHandlerPool));
+    memset(UMHandlerIndex, 0, sizeof(UMHandlerIndex));
     OnExchangeContextChanged = NULL;
 
     msgLayer->ExchangeMgr = this;
@@ -99,13 +110,18 @@ WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
     msgLayer->OnAcceptError = HandleAcceptError;
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    mWRMPTimerInterval  = WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD;       //WRMP Timer tick period
-
     memset(RetransTable, 0, sizeof(RetransTable));
-
-    mWRMPTimeStampBase = System::Timer::GetCurrentEpoch();
+    mRetransQueue = NULL;
 
     mWRMPCurrentTimerExpiry = 0;
+    mWRMPTimerArmed = false;
+    mWRMPNextAckTime = 0;
+    mWRMPAckScheduled = false;
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    memset(mPeerRTTTable, 0, sizeof(mPeerRTTTable));
+    mNextPeerRTTVictim = 0;
+#endif
 #endif
 
     State = kState_Initialized;
@@ -242,6 +258,7 @@ ExchangeContext *WeaveExchangeManager::NewContext(const uint64_t &peerNodeId, co
 #if WEAVE_CONFIG_ENABLE_EPHEMERAL_UDP_PORT
         ec->SetUseEphemeralUDPPort(MessageLayer->EphemeralUDPPortEnabled());
 #endif // WEAVE_CONFIG_ENABLE_EPHEMERAL_UDP_PORT
+        IndexContext(ec);
         WeaveLogProgress(ExchangeManager, "ec id: %d, AppState: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), ec->AppState);
     }
     return ec;
@@ -515,6 +532,7 @@ void WeaveExchangeManager::HandleConnectionClosed(WeaveConnection *con, WEAVE_ER
         if (umh->Handler != NULL && umh->Con == con)
         {
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
+            UnindexUMH(umh);
             umh->Handler = NULL;
         }
 }
@@ -549,36 +567,129 @@ size_t WeaveExchangeManager::ExpireExchangeTimers(void)
 
 ExchangeContext *WeaveExchangeManager::AllocContext()
 {
-    ExchangeContext *ec = (ExchangeContext *) ContextPool;
+    ExchangeContext *ec = mFreeContexts;
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_AllocExchangeContext,
                        return NULL);
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
-        if (ec->ExchangeMgr == NULL)
-        {
-            *ec = ExchangeContext();
-            ec->ExchangeMgr = this;
-            ec->mRefCount = 1;
-            mContextsInUse++;
-            MessageLayer->SignalMessageLayerActivityChanged();
+    if (ec == NULL)
+    {
+        WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
+        return NULL;
+    }
+
+    mFreeContexts = ec->mNextContext;
+
+    *ec = ExchangeContext();
+    ec->ExchangeMgr = this;
+    ec->mRefCount = 1;
+    mContextsInUse++;
+    MessageLayer->SignalMessageLayerActivityChanged();
 #if defined(WEAVE_EXCHANGE_CONTEXT_DETAIL_LOGGING)
-            WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
+    WeaveLogProgress(ExchangeManager, "ec++ id: %d, inUse: %d, addr: 0x%x", EXCHANGE_CONTEXT_ID(ec - ContextPool), mContextsInUse, ec);
 #endif
-            SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
+    SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumContexts);
 
-            return ec;
-        }
-    WeaveLogError(ExchangeManager, "Alloc ctxt FAILED");
-    return NULL;
+    return ec;
+}
+
+/**
+ *  Return an ExchangeContext whose last reference has been released to the free list.
+ *
+ *  @param[in]    ec            A pointer to the ExchangeContext object.
+ *
+ */
+void WeaveExchangeManager::FreeContext(ExchangeContext *ec)
+{
+    UnindexContext(ec);
+
+    ec->ExchangeMgr = NULL;
+    ec->mNextContext = mFreeContexts;
+    mFreeContexts = ec;
+
+    mContextsInUse--;
+}
+
+size_t WeaveExchangeManager::ContextIndexHash(uint16_t exchangeId, bool isInitiator)
+{
+    return ((static_cast<size_t>(exchangeId) << 1) | (isInitiator ? 1 : 0)) % WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE;
+}
+
+/**
+ *  Add an ExchangeContext to the index used to dispatch inbound messages, once its exchange identifier
+ *  and initiator flag have been assigned.
+ *
+ *  @note
+ *    The index is keyed on the exchange identifier and initiator flag only. The peer node identifier
+ *    may be kAnyNodeId and, like the connection, may be changed after the context is created, so both
+ *    are left to MatchExchange(). SetInitiator() moves an indexed context to the bucket for its new role.
+ *
+ *  @param[in]    ec            A pointer to the ExchangeContext object.
+ *
+ */
+void WeaveExchangeManager::IndexContext(ExchangeContext *ec)
+{
+    ExchangeContext **link = &mContextIndex[ContextIndexHash(ec->ExchangeId, ec->IsInitiator())];
+
+    // Keep each bucket in pool order, so that a lookup finds the same context as a scan of the pool.
+    while (*link != NULL && *link < ec)
+        link = &(*link)->mNextContext;
+
+    ec->mNextContext = *link;
+    *link = ec;
+}
+
+/**
+ *  Remove an ExchangeContext from the index used to dispatch inbound messages.
+ *
+ *  @param[in]    ec            A pointer to the ExchangeContext object.
+ *
+ *  @return   true if the context was in the index, false otherwise.
+ *
+ */
+bool WeaveExchangeManager::UnindexContext(ExchangeContext *ec)
+{
+    ExchangeContext **link = &mContextIndex[ContextIndexHash(ec->ExchangeId, ec->IsInitiator())];
+
+    while (*link != NULL && *link != ec)
+        link = &(*link)->mNextContext;
+
+    if (*link == NULL)
+        return false;
+
+    *link = ec->mNextContext;
+    ec->mNextContext = NULL;
+    return true;
+}
+
+/**
+ *  Find the ExchangeContext that an inbound message applies to.
+ *
+ *  @param[in]    msgCon            A pointer to the WeaveConnection over which the message was received, or NULL for UDP.
+ *
+ *  @param[in]    msgInfo           A pointer to the Weave message info structure.
+ *
+ *  @param[in]    exchangeHeader    A pointer to the decoded exchange header of the message.
+ *
+ *  @return   A pointer to the matching ExchangeContext object, or NULL on no match.
+ *
+ */
+ExchangeContext *WeaveExchangeManager::LookupContext(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo,
+        const WeaveExchangeHeader *exchangeHeader)
+{
+    // A message sent by an initiator belongs to an exchange of which the local node is the responder, and vice versa.
+    const bool isInitiator = (exchangeHeader->Flags & kWeaveExchangeFlag_Initiator) == 0;
+    ExchangeContext *ec = mContextIndex[ContextIndexHash(exchangeHeader->ExchangeId, isInitiator)];
+
+    while (ec != NULL && !ec->MatchExchange(msgCon, msgInfo, exchangeHeader))
+        ec = ec->mNextContext;
+
+    return ec;
 }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64_t DelayedNodeId)
 {
-    // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-    WRMPExpireTicks();
-
     //Go through the retrans table entries for that node and adjust the timer.
     for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
     {
@@ -590,7 +701,7 @@ void WeaveExchangeManager::WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64
             {
 
                 //Paustime is specified in milliseconds; Update retrans values
-                RetransTable[i].nextRetransTime += (PauseTimeMillis / mWRMPTimerInterval);
+                WRMPScheduleRetrans(&RetransTable[i], RetransTable[i].nextRetransTime + PauseTimeMillis);
 
                 //Call the application callback
                 if (RetransTable[i].exchContext->OnDDRcvd)
@@ -627,7 +738,6 @@ static void DefaultOnMessageReceived(ExchangeContext *ec, const IPPacketInfo *pk
 void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
 {
     WeaveExchangeHeader exchangeHeader;
-    UnsolicitedMessageHandler *umh         = NULL;
     UnsolicitedMessageHandler *matchingUMH = NULL;
     ExchangeContext *ec                    = NULL;
     WeaveConnection *msgCon                = NULL;
@@ -726,27 +836,24 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
 #endif
 
     // Search for an existing exchange that the message applies to. If a match is found...
-    ec = (ExchangeContext *) ContextPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    ec = LookupContext(msgCon, msgInfo, &exchangeHeader);
+    if (ec != NULL)
     {
-        if (ec->ExchangeMgr != NULL && ec->MatchExchange(msgCon, msgInfo, &exchangeHeader))
-        {
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-            // Found a matching exchange. Set flag for correct subsequent WRM
-            // retransmission timeout selection.
-            if (!ec->HasRcvdMsgFromPeer())
-            {
-                ec->SetMsgRcvdFromPeer(true);
-            }
+        // Found a matching exchange. Set flag for correct subsequent WRM
+        // retransmission timeout selection.
+        if (!ec->HasRcvdMsgFromPeer())
+        {
+            ec->SetMsgRcvdFromPeer(true);
+        }
 #endif
 
-            //Matched ExchangeContext; send to message handler.
-            ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
+        //Matched ExchangeContext; send to message handler.
+        ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf);
 
-            msgBuf = NULL;
+        msgBuf = NULL;
 
-            ExitNow(err = WEAVE_NO_ERROR);
-        }
+        ExitNow(err = WEAVE_NO_ERROR);
     }
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -762,23 +869,8 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
     {
         // Search for an unsolicited message handler that can handle the message. Prefer handlers that can explicitly
         // handle the message type over handlers that handle all messages for a profile.
-        umh = (UnsolicitedMessageHandler *) UMHandlerPool;
-
-        matchingUMH = NULL;
-
-        for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
-            if (umh->Handler != NULL && umh->ProfileId == exchangeHeader.ProfileId && (umh->Con == NULL || umh->Con == msgCon)
-                && (!(msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage) || umh->AllowDuplicateMsgs))
-            {
-                if (umh->MessageType == exchangeHeader.MessageType)
-                {
-                    matchingUMH = umh;
-                    break;
-                }
-
-                if (umh->MessageType == -1)
-                    matchingUMH = umh;
-            }
+        matchingUMH = LookupUMH(exchangeHeader.ProfileId, exchangeHeader.MessageType, msgCon,
+                                (msgInfo->Flags & kWeaveMessageFlag_DuplicateMessage) != 0);
     }
     // Discard the message if it isn't marked as being sent by an initiator and the message is not a duplicate
     // that needs to send ack to the peer.
@@ -898,6 +990,9 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
         // Arrange to automatically release the encryption key when the exchange is freed.
         ec->SetAutoReleaseKey(true);
 
+        // Now that the role of the exchange is known, make it visible to subsequent messages.
+        IndexContext(ec);
+
         ec->HandleMessage(msgInfo, &exchangeHeader, msgBuf, umhandler);
         msgBuf = NULL;
 
@@ -951,6 +1046,7 @@ WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgTyp
     selected->Con = con;
     selected->MessageType = msgType;
     selected->AllowDuplicateMsgs = allowDups;
+    IndexUMH(selected);
 
     SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
 
@@ -959,11 +1055,12 @@ WEAVE_ERROR WeaveExchangeManager::RegisterUMH(uint32_t profileId, int16_t msgTyp
 
 WEAVE_ERROR WeaveExchangeManager::UnregisterUMH(uint32_t profileId, int16_t msgType, WeaveConnection *con)
 {
-    UnsolicitedMessageHandler *umh = (UnsolicitedMessageHandler *) UMHandlerPool;
-    for (int i = 0; i < WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS; i++, umh++)
+    UnsolicitedMessageHandler *umh = UMHandlerIndex[UMHIndexHash(profileId, msgType)];
+    for (; umh != NULL; umh = umh->Next)
     {
-        if (umh->Handler != NULL && umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
+        if (umh->ProfileId == profileId && umh->MessageType == msgType && umh->Con == con)
         {
+            UnindexUMH(umh);
             umh->Handler = NULL;
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
             return WEAVE_NO_ERROR;
@@ -972,6 +1069,73 @@ WEAVE_ERROR WeaveExchangeManager::UnregisterUMH(uint32_t profileId, int16_t msgT
     return WEAVE_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER;
 }
 
+size_t WeaveExchangeManager::UMHIndexHash(uint32_t profileId, int16_t msgType)
+{
+    return ((profileId ^ (profileId >> 16)) * 31 + static_cast<uint16_t>(msgType)) % WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE;
+}
+
+void WeaveExchangeManager::IndexUMH(UnsolicitedMessageHandler *umh)
+{
+    UnsolicitedMessageHandler **link = &UMHandlerIndex[UMHIndexHash(umh->ProfileId, umh->MessageType)];
+
+    // Keep each bucket in pool order, so that lookups prefer the same handler as a scan of the pool.
+    while (*link != NULL && *link < umh)
+        link = &(*link)->Next;
+
+    umh->Next = *link;
+    *link = umh;
+}
+
+void WeaveExchangeManager::UnindexUMH(UnsolicitedMessageHandler *umh)
+{
+    UnsolicitedMessageHandler **link = &UMHandlerIndex[UMHIndexHash(umh->ProfileId, umh->MessageType)];
+
+    while (*link != NULL && *link != umh)
+        link = &(*link)->Next;
+
+    if (*link != NULL)
+    {
+        *link = umh->Next;
+        umh->Next = NULL;
+    }
+}
+
+/**
+ *  Find the unsolicited message handler for an inbound message that does not belong to an existing exchange.
+ *
+ *  The first registered handler for the message type is preferred, in pool order. Failing that, the last
+ *  registered handler for all messages of the profile is used.
+ *
+ *  @param[in]    profileId     The profile identifier of the received message.
+ *
+ *  @param[in]    msgType       The message type of the received message.
+ *
+ *  @param[in]    msgCon        A pointer to the WeaveConnection over which the message was received, or NULL for UDP.
+ *
+ *  @param[in]    isDuplicate   Boolean indicator of whether the message is a duplicate.
+ *
+ *  @return   A pointer to the matching handler, or NULL on no match.
+ *
+ */
+WeaveExchangeManager::UnsolicitedMessageHandler *WeaveExchangeManager::LookupUMH(uint32_t profileId, int16_t msgType,
+        WeaveConnection *msgCon, bool isDuplicate)
+{
+    UnsolicitedMessageHandler *umh;
+    UnsolicitedMessageHandler *matchingUMH = NULL;
+
+    for (umh = UMHandlerIndex[UMHIndexHash(profileId, msgType)]; umh != NULL; umh = umh->Next)
+        if (umh->ProfileId == profileId && umh->MessageType == msgType && (umh->Con == NULL || umh->Con == msgCon)
+            && (!isDuplicate || umh->AllowDuplicateMsgs))
+            return umh;
+
+    for (umh = UMHandlerIndex[UMHIndexHash(profileId, -1)]; umh != NULL; umh = umh->Next)
+        if (umh->ProfileId == profileId && umh->MessageType == -1 && (umh->Con == NULL || umh->Con == msgCon)
+            && (!isDuplicate || umh->AllowDuplicateMsgs))
+            matchingUMH = umh;
+
+    return matchingUMH;
+}
+
 void WeaveExchangeManager::HandleMessageReceived(WeaveMessageLayer *msgLayer, WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
 {
     msgLayer->ExchangeMgr->DispatchMessage(msgInfo, msgBuf);
@@ -1215,51 +1379,17 @@ void WeaveExchangeManager::RetransPendingAppGroupMsgs(uint64_t peerNodeId)
     }
 }
 
-/**
-* Return a tick counter value given a time difference and a tick interval.
-* The difference in time is not expected to exceed (2^32 - 1) within the
-* scope of two timestamp comparisons in WRMP and, thus, it makes sense to cast
-* the time delta to uint32_t. This also avoids invocation of 64 bit divisions
-* in constrained platforms that do not support them.
-*
-* @param[in]  newTime        Timestamp value of in milliseconds.
-* @param[in]  oldTime        Timestamp value of in milliseconds.
-* @param[in]  tickInterval   Timer tick interval in milliseconds.
-*
-* @return Tick count for the time delta.
-*/
-uint32_t WeaveExchangeManager::GetTickCounterFromTimeDelta (uint64_t newTime,
-                                                            uint64_t oldTime)
-{
-    // Note on math: we have a utility function that will compute U64 var / U32
-    // compile-time const => U32.  At the moment, we are leaving
-    // mWRMPTimerInterval as a member variable in WeaveExchangeManager, however,
-    // given its current usage, it could be replaced by a compile time const.
-    // Should we make that change, I would recommend making the timeDelta a u64,
-    // and replacing the plain 32-bit division below with the utility function.
-    // Note that the 32bit timeDelta overflows at around 46 days; pursuing the
-    // above code strategy would extend that overflow by a factor if 200 given
-    // the default mWRMPPTimerInterval.  If and when such change is made, please
-    // update the comment around line 1426.
-    uint32_t timeDelta = static_cast<uint32_t>(newTime - oldTime);
-
-    return (timeDelta / mWRMPTimerInterval);
-}
-
 #if defined(WRMP_TICKLESS_DEBUG)
 void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log)
 {
      WeaveLogProgress(ExchangeManager, log);
 
-     for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+     for (RetransTableEntry *entry = mRetransQueue; entry != NULL; entry = entry->next)
      {
-         if (RetransTable[i].exchContext)
-         {
-             WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTimeCtr:%04" PRIX16,
-                              RetransTable[i].exchContext,
-                              RetransTable[i].msgId,
-                              RetransTable[i].nextRetransTime);
-         }
+         WeaveLogProgress(ExchangeManager, "EC:%04" PRIX16 " MsgId:%08" PRIX32 " NextRetransTime:%" PRIu64,
+                          entry->exchContext->ExchangeId,
+                          entry->msgId,
+                          static_cast<uint64_t>(entry->nextRetransTime));
      }
 }
 #else
@@ -1267,89 +1397,102 @@ void WeaveExchangeManager::TicklessDebugDumpRetransTable(const char *log) { retu
 #endif // WRMP_TICKLESS_DEBUG
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
-* If an action needs to be triggered by WRMP time facilities, execute
-* that action.
+* Execute the WRMP actions that are due: send the solitary acks whose
+* piggyback timeout has expired, and retransmit or give up on the
+* messages at the head of the retransmission queue whose retransmission
+* time has passed.
 *
 */
 void WeaveExchangeManager::WRMPExecuteActions(void)
 {
+    const System::Timer::Epoch now    = System::Timer::GetCurrentEpoch();
     ExchangeContext *ec               = NULL;
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
-
 #if defined(WRMP_TICKLESS_DEBUG)
     WeaveLogProgress(ExchangeManager, "WRMPExecuteActions");
 #endif
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    //Process Ack Tables for all ExchangeContexts, but only once the earliest pending Ack is due
+    if (mWRMPAckScheduled && !System::Timer::IsEarlierEpoch(now, mWRMPNextAckTime))
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
+        mWRMPAckScheduled = false;
+
+        ec = (ExchangeContext *)ContextPool;
+
+        for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
         {
-            if (0 == ec->mWRMPNextAckTime)
+            if (ec->ExchangeMgr != NULL && ec->IsAckPending())
             {
+                if (!System::Timer::IsEarlierEpoch(now, ec->mWRMPNextAckTime))
+                {
 #if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
+                    WeaveLogProgress(ExchangeManager, "WRMPExecuteActions sending ACK");
 #endif
-                //Send the Ack in a Common::Null message
-                ec->SendCommonNullMessage();
-                ec->SetAckPending(false);
+                    //Send the Ack in a Common::Null message
+                    ec->SendCommonNullMessage();
+                    ec->SetAckPending(false);
+                }
+                else
+                {
+                    WRMPScheduleAck(ec->mWRMPNextAckTime);
+                }
             }
         }
     }
 
     TicklessDebugDumpRetransTable("WRMPExecuteActions Dumping RetransTable entries before processing");
 
-    // Retransmit / cancel anything in the retrans table whose retrans timeout
-    // has expired
+    // Retransmit / cancel the entries at the head of the retransmission queue
+    // whose retrans timeout has expired. Each entry is either requeued behind
+    // the current time or removed, so a single pass visits each at most once.
     for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
+        RetransTableEntry *entry = mRetransQueue;
+        WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+        if (entry == NULL || System::Timer::IsEarlierEpoch(now, entry->nextRetransTime))
         {
-            WEAVE_ERROR err = WEAVE_NO_ERROR;
+            break;
+        }
 
-            if (0 == RetransTable[i].nextRetransTime)
-            {
-                uint8_t sendCount = RetransTable[i].sendCount;
-                void * msgCtxt = RetransTable[i].msgCtxt;
+        ec = entry->exchContext;
 
-                if (sendCount > ec->mWRMPConfig.mMaxRetrans)
-                {
-                    err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
+        uint8_t sendCount = entry->sendCount;
+        void * msgCtxt = entry->msgCtxt;
 
-                    WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
-                                  RetransTable[i].msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
+        if (sendCount > ec->mWRMPConfig.mMaxRetrans)
+        {
+            err = WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED;
 
-                    // Remove from Table
-                    ClearRetransmitTable(RetransTable[i]);
-                }
+            WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
+                          entry->msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // Resend from Table (if the operation fails, the entry is cleared)
-                    err = SendFromRetransTable(&(RetransTable[i]));
-                }
+            // Remove from Table
+            ClearRetransmitTable(*entry);
+        }
 
-                if (err == WEAVE_NO_ERROR)
-                {
-                    // If the retransmission was successful, update the passive timer
-                    RetransTable[i].nextRetransTime = ec->GetCurrentRetransmitTimeout() / mWRMPTimerInterval;
+        if (err == WEAVE_NO_ERROR)
+        {
+            // Resend from Table (if the operation fails, the entry is cleared)
+            err = SendFromRetransTable(entry);
+        }
+
+        if (err == WEAVE_NO_ERROR)
+        {
+            // If the retransmission was successful, requeue the entry for its next retransmission
+            WRMPScheduleRetrans(entry, System::Timer::GetCurrentEpoch() + ec->GetCurrentRetransmitTimeout());
 #if defined(DEBUG)
-                    WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
-                            RetransTable[i].msgId, RetransTable[i].sendCount);
+            WeaveLogProgress(ExchangeManager, "Retransmit MsgId:%08" PRIX32 " Send Cnt %d",
+                    entry->msgId, entry->sendCount);
 #endif
-                }
+        }
 
-                if (err != WEAVE_NO_ERROR)
-                {
-                    if (ec->OnSendError)
-                    {
-                        ec->OnSendError(ec, err, msgCtxt);
-                    }
-                }
-            } //nextRetransTime = 0
+        if (err != WEAVE_NO_ERROR)
+        {
+            if (ec->OnSendError)
+            {
+                ec->OnSendError(ec, err, msgCtxt);
+            }
         }
     }
 
@@ -1357,112 +1500,171 @@ void WeaveExchangeManager::WRMPExecuteActions(void)
 }
 
 /**
-* Calculate number of virtual WRMP ticks that have expired since we last
-* called this function. Iterate through active exchange contexts and
-* retrans table entries, subtracting expired virtual ticks to synchronize
-* wakeup times with the current system time. Do not perform any actions
-* beyond updating tick counts, actions will be performed by the physical
-* WRMP timer tick expiry.
-*
-*/
-void WeaveExchangeManager::WRMPExpireTicks(void)
+ * Record that a solitary Ack is due at the specified time, so that the
+ * WRMP timer wakes the system no later than that.
+ *
+ * @param[in]  ackTime   The time at which the Ack is due.
+ *
+ */
+void WeaveExchangeManager::WRMPScheduleAck(System::Timer::Epoch ackTime)
+{
+    if (!mWRMPAckScheduled || System::Timer::IsEarlierEpoch(ackTime, mWRMPNextAckTime))
+    {
+        mWRMPNextAckTime = ackTime;
+        mWRMPAckScheduled = true;
+    }
+}
+
+/**
+ * (Re)insert an entry into the retransmission queue, which is ordered by
+ * retransmission time. Entries due at the same time keep the order in
+ * which they were scheduled.
+ *
+ * @param[in]  entry         A pointer to a retransmission table entry in use.
+ *
+ * @param[in]  retransTime   The time at which the entry is next due for retransmission.
+ *
+ */
+void WeaveExchangeManager::WRMPScheduleRetrans(RetransTableEntry *entry, System::Timer::Epoch retransTime)
 {
-    uint64_t            now         = 0;
-    ExchangeContext*    ec          = NULL;
-    uint32_t            deltaTicks;
+    RetransTableEntry **link = &mRetransQueue;
 
-    //Process Ack Tables for all ExchangeContexts
-    ec = (ExchangeContext *)ContextPool;
+    WRMPUnscheduleRetrans(entry);
 
-    now = System::Timer::GetCurrentEpoch();
+    entry->nextRetransTime = retransTime;
 
-    // Number of full ticks elapsed since last timer processing.  We always round down
-    // to the previous tick.  If we are between tick boundaries, the extra time since the
-    // last virtual tick is not accounted for here (it will be accounted for when resetting
-    // the WRMP timer)
+    while (*link != NULL && !System::Timer::IsEarlierEpoch(retransTime, (*link)->nextRetransTime))
+    {
+        link = &(*link)->next;
+    }
 
-    deltaTicks = GetTickCounterFromTimeDelta(now, mWRMPTimeStampBase);
+    entry->next = *link;
+    *link = entry;
+}
 
-    // Note on math involving deltaTicks: in the code below, deltaTicks, a
-    // 32-bit value, is being subtracted from 16-bit expiration times.  In each
-    // case, we compare the expiration time prior to subtraction to guard
-    // against underflow.
+/**
+ * Remove an entry from the retransmission queue, if it is queued.
+ *
+ * @param[in]  entry   A pointer to a retransmission table entry.
+ *
+ */
+void WeaveExchangeManager::WRMPUnscheduleRetrans(RetransTableEntry *entry)
+{
+    for (RetransTableEntry **link = &mRetransQueue; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == entry)
+        {
+            *link = entry->next;
+            break;
+        }
+    }
 
-#if defined(WRMP_TICKLESS_DEBUG)
-    WeaveLogProgress(ExchangeManager, "WRMPExpireTicks at %" PRIu64 ", %" PRIu64 ", %u", now, mWRMPTimeStampBase, deltaTicks);
-#endif
+    entry->next = NULL;
+}
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+/**
+ * Find the round-trip time estimate kept for a peer node.
+ *
+ * @param[in]  peerNodeId   The node identifier of the peer.
+ *
+ * @return A pointer to the estimate, or NULL if none is kept for the peer.
+ *
+ */
+WeaveExchangeManager::PeerRTTEntry *WeaveExchangeManager::WRMPFindPeerRTT(uint64_t peerNodeId)
+{
+    for (int i = 0; i < WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE; i++)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending())
+        if (mPeerRTTTable[i].peerNodeId == peerNodeId)
         {
-            //Decrement counter of Ack timestamp by the elapsed timer ticks
-            if (ec->mWRMPNextAckTime >= deltaTicks)
-            {
-                ec->mWRMPNextAckTime -= deltaTicks;
-            }
-            else
-            {
-                ec->mWRMPNextAckTime = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPNextAckTime to %u", ec->mWRMPNextAckTime);
-#endif
+            return &mPeerRTTTable[i];
         }
     }
 
-    //Process Throttle Time
-    //Check Throttle timeout stored in EC to set/unset Throttle flag
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    return NULL;
+}
+
+/**
+ * Fold a round-trip time sample into the estimate kept for a peer node,
+ * following RFC 6298. When the table is full, the estimates are reused
+ * in round-robin order.
+ *
+ * @param[in]  peerNodeId   The node identifier of the peer that acknowledged the message.
+ *
+ * @param[in]  rtt          The time, in milliseconds, between sending the message and receiving its Ack.
+ *
+ */
+void WeaveExchangeManager::WRMPUpdatePeerRTT(uint64_t peerNodeId, uint32_t rtt)
+{
+    PeerRTTEntry *entry = NULL;
+
+    VerifyOrExit(peerNodeId != kNodeIdNotSpecified && peerNodeId != kAnyNodeId, );
+
+    entry = WRMPFindPeerRTT(peerNodeId);
+    if (entry != NULL)
+    {
+        const uint32_t delta = (entry->srtt > rtt) ? (entry->srtt - rtt) : (rtt - entry->srtt);
+
+        // RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R|, then SRTT = 7/8 SRTT + 1/8 R
+        entry->rttVar = entry->rttVar - (entry->rttVar >> 2) + (delta >> 2);
+        entry->srtt = entry->srtt - (entry->srtt >> 3) + (rtt >> 3);
+    }
+    else
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
+        entry = WRMPFindPeerRTT(kNodeIdNotSpecified);
+        if (entry == NULL)
         {
-            //Process Retransmit Table
-            //Decrement Throttle timeout by elapsed timeticks
-            if (ec->mWRMPThrottleTimeout >= deltaTicks)
-            {
-                ec->mWRMPThrottleTimeout -= deltaTicks;
-            }
-            else
-            {
-                ec->mWRMPThrottleTimeout = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set mWRMPThrottleTimeout to %u", RetransTable[i].nextRetransTime);
-#endif
+            entry = &mPeerRTTTable[mNextPeerRTTVictim];
+            mNextPeerRTTVictim = (mNextPeerRTTVictim + 1) % WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE;
+        }
 
-            //Decrement Retransmit timeout by elapsed timeticks
-            if (RetransTable[i].nextRetransTime >= deltaTicks)
-            {
-                RetransTable[i].nextRetransTime -= deltaTicks;
-            }
-            else
-            {
-                RetransTable[i].nextRetransTime = 0;
-            }
-#if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPExpireTicks set nextRetransTime to %u", RetransTable[i].nextRetransTime);
-#endif
-        } //ec entry is allocated
+        entry->peerNodeId = peerNodeId;
+        entry->srtt = rtt;
+        entry->rttVar = rtt / 2;
     }
 
-    // Re-Adjust the base time stamp to the most recent tick boundary
-
-    // Note on math: we cast deltaTicks to a 64bit value to ensure that that we
-    // produce a full 64 bit product.  At the moment this is a bit of a moot
-    // conversion: right now, the math in GetTickCounterFromTimeDelta ensures
-    // that the deltaTicks * mWRMPTimerTick fits in 32bits.  However, I'm
-    // leaving the math in this form, because I'm leaving the door open to
-    // refactoring the division in GetTickCounterFromTimeDelta to use our
-    // specialized utility function that computes U64 var/ U32 compile-time
-    // const ==> U32
-    mWRMPTimeStampBase += static_cast<uint64_t>(deltaTicks) * mWRMPTimerInterval;
-#if defined(WRMP_TICKLESS_DEBUG)
-    WeaveLogProgress(ExchangeManager, "WRMPExpireTicks mWRMPTimeStampBase to %" PRIu64, mWRMPTimeStampBase);
-#endif
+exit:
+    return;
 }
 
+/**
+ * Get the retransmission timeout for a peer node from its round-trip time
+ * estimate, bounded by #WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT and \c maxTimeout.
+ *
+ * @param[in]  peerNodeId   The node identifier of the peer.
+ *
+ * @param[in]  maxTimeout   The retransmission timeout configured for the exchange, in milliseconds.
+ *
+ * @return The retransmission timeout in milliseconds, which is \c maxTimeout if no estimate is kept for the peer.
+ *
+ */
+uint32_t WeaveExchangeManager::WRMPGetPeerRetransTimeout(uint64_t peerNodeId, uint32_t maxTimeout)
+{
+    PeerRTTEntry *entry = NULL;
+    uint32_t timeout = maxTimeout;
+
+    VerifyOrExit(peerNodeId != kNodeIdNotSpecified, );
+
+    entry = WRMPFindPeerRTT(peerNodeId);
+    VerifyOrExit(entry != NULL, );
+
+    timeout = entry->srtt + 4 * entry->rttVar;
+
+    if (timeout < WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT)
+    {
+        timeout = WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT;
+    }
+
+    if (timeout > maxTimeout)
+    {
+        timeout = maxTimeout;
+    }
+
+exit:
+    return timeout;
+}
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
 /**
  * Handle physical wakeup of system due to WRMP wakeup.
  *
@@ -1477,10 +1679,9 @@ void WeaveExchangeManager::WRMPTimeout(System::Layer* aSystemLayer, void* aAppSt
     WeaveLogProgress(ExchangeManager, "WRMPTimeout\n");
 #endif
 
-    // Make sure all tick counts are sync'd to the current time
-    exchangeMgr->WRMPExpireTicks();
+    exchangeMgr->mWRMPTimerArmed = false;
 
-    // Execute any actions that are due this tick
+    // Execute any actions that are due
     exchangeMgr->WRMPExecuteActions();
 
     // Calculate next physical wakeup
@@ -1515,14 +1716,11 @@ WEAVE_ERROR WeaveExchangeManager::AddToRetransTable(ExchangeContext *ec, PacketB
         //Check the exchContext pointer for finding an empty slot in Table
         if (!RetransTable[i].exchContext)
         {
-            // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-            WRMPExpireTicks();
-
             RetransTable[i].exchContext = ec;
             RetransTable[i].msgId = messageId;
             RetransTable[i].msgBuf = msgBuf;
             RetransTable[i].sendCount = 0;
-            RetransTable[i].nextRetransTime = GetTickCounterFromTimeDelta(ec->GetCurrentRetransmitTimeout() + System::Timer::GetCurrentEpoch(), mWRMPTimeStampBase);
+            WRMPScheduleRetrans(&RetransTable[i], System::Timer::GetCurrentEpoch() + ec->GetCurrentRetransmitTimeout());
 
             RetransTable[i].msgCtxt = msgCtxt;
             *rEntry = &RetransTable[i];
@@ -1567,7 +1765,7 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
 
     WEAVE_FAULT_INJECT(FaultInjection::kFault_WRMSendError,
                        entry->sendCount = (ec->mWRMPConfig.mMaxRetrans + 1);
-                       entry->nextRetransTime = 0;
+                       WRMPScheduleRetrans(entry, System::Timer::GetCurrentEpoch());
                        WRMPStartTimer();
                        ExitNow());
 
@@ -1591,6 +1789,13 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
         entry->msgBuf->SetStart(p);
         entry->msgBuf->SetDataLength(len);
 
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+        if (entry->sendCount == 0)
+        {
+            entry->sendTime = System::Timer::GetCurrentEpoch();
+        }
+#endif
+
         //Update the counters
         entry->sendCount++;
     }
@@ -1651,8 +1856,7 @@ void WeaveExchangeManager::ClearRetransmitTable(RetransTableEntry &rEntry)
 {
     if (rEntry.exchContext)
     {
-        // Expire any virtual ticks that have expired so all wakeup sources reflect the current time
-        WRMPExpireTicks();
+        WRMPUnscheduleRetrans(&rEntry);
 
         rEntry.exchContext->Release();
         rEntry.exchContext = NULL;
@@ -1699,88 +1903,64 @@ void WeaveExchangeManager::FailRetransmitTableEntries(ExchangeContext *ec, WEAVE
 }
 
 /**
-* Iterate through active exchange contexts and retrans table entries.
-* Determine how many WRMP ticks we need to sleep before we need to physically
-* wake the CPU to perform an action.  Set a timer to go off when we
-* next need to wake the system.
+* Determine when the system next needs to be woken to perform a WRMP action,
+* which is the earlier of the time the head of the retransmission queue is
+* due and the time the earliest pending solitary Ack is due, and set the
+* WRMP timer to go off then.
 *
 */
 void WeaveExchangeManager::WRMPStartTimer()
 {
     WEAVE_ERROR res                   = WEAVE_NO_ERROR;
-    uint32_t nextWakeTime             = UINT32_MAX;
+    System::Timer::Epoch nextWakeTime = 0;
     bool foundWake                    = false;
-    ExchangeContext *ec               = NULL;
 
     // When do we need to next wake up to send an ACK?
-    ec = (ExchangeContext *)ContextPool;
-
-    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    if (mWRMPAckScheduled)
     {
-        if (ec->ExchangeMgr != NULL && ec->IsAckPending() && ec->mWRMPNextAckTime < nextWakeTime) {
-            nextWakeTime = ec->mWRMPNextAckTime;
-            foundWake = true;
+        nextWakeTime = mWRMPNextAckTime;
+        foundWake = true;
 #if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPStartTimer next ACK time %u", nextWakeTime);
+        WeaveLogProgress(ExchangeManager, "WRMPStartTimer next ACK time %" PRIu64, static_cast<uint64_t>(nextWakeTime));
 #endif
-        }
     }
 
-    for (int i = 0; i < WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE; i++)
+    // When do we need to next wake up for WRMP retransmit?
+    if (mRetransQueue != NULL && (!foundWake || System::Timer::IsEarlierEpoch(mRetransQueue->nextRetransTime, nextWakeTime)))
     {
-        ec = RetransTable[i].exchContext;
-        if (ec)
-        {
-            // When do we need to next wake up for throttle retransmission?
-            if (ec->mWRMPThrottleTimeout != 0 && ec->mWRMPThrottleTimeout < nextWakeTime) {
-                nextWakeTime = ec->mWRMPThrottleTimeout;
-                foundWake = true;
+        nextWakeTime = mRetransQueue->nextRetransTime;
+        foundWake = true;
 #if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer throttle timeout %u", nextWakeTime);
+        WeaveLogProgress(ExchangeManager, "WRMPStartTimer RetransTime %" PRIu64, static_cast<uint64_t>(nextWakeTime));
 #endif
-            }
-
-            // When do we need to next wake up for WRMP retransmit?
-            if (RetransTable[i].nextRetransTime < nextWakeTime) {
-                nextWakeTime = RetransTable[i].nextRetransTime;
-                foundWake = true;
-#if defined(WRMP_TICKLESS_DEBUG)
-                WeaveLogProgress(ExchangeManager, "WRMPStartTimer RetransTime %u", nextWakeTime);
-#endif
-            }
-        }
     }
 
     if (foundWake) {
-        // Set timer for next tick boundary - subtract the elapsed time from the current tick
-        System::Timer::Epoch currentTime = System::Timer::GetCurrentEpoch();
-        int32_t timerArmValue = nextWakeTime * mWRMPTimerInterval - (currentTime - mWRMPTimeStampBase);
-        System::Timer::Epoch timerExpiryEpoch = currentTime + timerArmValue;
-
-#if defined(WRMP_TICKLESS_DEBUG)
-        WeaveLogProgress(ExchangeManager, "WRMPStartTimer wake in %d ms (%" PRIu64" %u %" PRIu64 " %" PRIu64 ")",
-                timerArmValue,
-                timerExpiryEpoch, nextWakeTime, currentTime, mWRMPTimeStampBase);
-#endif
-        if (timerExpiryEpoch != mWRMPCurrentTimerExpiry)
+        if (!mWRMPTimerArmed || nextWakeTime != mWRMPCurrentTimerExpiry)
         {
-            // If the tick boundary has expired in the past (delayed processing of event due to other system activity),
+            System::Timer::Epoch currentTime = System::Timer::GetCurrentEpoch();
+            uint32_t timerArmValue = 0;
+
+            // If the wake time has passed (delayed processing of event due to other system activity),
             // expire the timer immediately
-            if (timerArmValue < 0) {
-                timerArmValue = 0;
+            if (System::Timer::IsEarlierEpoch(currentTime, nextWakeTime))
+            {
+                timerArmValue = static_cast<uint32_t>(nextWakeTime - currentTime);
             }
 
 #if defined(WRMP_TICKLESS_DEBUG)
-            WeaveLogProgress(ExchangeManager, "WRMPStartTimer set timer for %d %" PRIu64, timerArmValue, timerExpiryEpoch);
+            WeaveLogProgress(ExchangeManager, "WRMPStartTimer set timer for %" PRIu32 " %" PRIu64, timerArmValue,
+                             static_cast<uint64_t>(nextWakeTime));
 #endif
             WRMPStopTimer();
-            res = MessageLayer->SystemLayer->StartTimer((uint32_t)timerArmValue, WRMPTimeout, this);
+            res = MessageLayer->SystemLayer->StartTimer(timerArmValue, WRMPTimeout, this);
 
             VerifyOrDieWithMsg(res == WEAVE_NO_ERROR, ExchangeManager, "Cannot start WRMPTimeout\n");
-            mWRMPCurrentTimerExpiry = timerExpiryEpoch;
+            mWRMPCurrentTimerExpiry = nextWakeTime;
+            mWRMPTimerArmed = true;
 #if defined(WRMP_TICKLESS_DEBUG)
         } else {
-            WeaveLogProgress(ExchangeManager, "WRMPStartTimer timer already set for %" PRIu64, timerExpiryEpoch);
+            WeaveLogProgress(ExchangeManager, "WRMPStartTimer timer already set for %" PRIu64, static_cast<uint64_t>(nextWakeTime));
 #endif
         }
     } else {
@@ -1796,6 +1976,7 @@ void WeaveExchangeManager::WRMPStartTimer()
 void WeaveExchangeManager::WRMPStopTimer()
 {
     MessageLayer->SystemLayer->CancelTimer(WRMPTimeout, this);
+    mWRMPTimerArmed = false;
 }
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
@@ -121,6 +121,7 @@ class NL_DLL_EXPORT ExchangeContext
 {
     friend class WeaveExchangeManager;
     friend class WeaveMessageLayer;
+    friend class WeaveExchangeManagerTestObject;
 
 public:
 
@@ -353,6 +354,7 @@ private:
     uint8_t rebroadcastThreshold;               // re-broadcast threshold
 
     uint16_t mFlags;                            // Internal state flags
+    ExchangeContext *mNextContext;              // Next context in the same index bucket of the exchange manager, or in its free list
 
     WEAVE_ERROR ResendMessage(void);
     bool MatchExchange(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchangeHeader);
@@ -366,8 +368,8 @@ private:
 
     uint32_t mPendingPeerAckId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    uint16_t mWRMPNextAckTime;                  //Next time for triggering Solo Ack
-    uint16_t mWRMPThrottleTimeout;              //Timeout until when Throttle is On when WRMPThrottleEnabled is set
+    System::Timer::Epoch mWRMPNextAckTime;      //Time at which a Solo Ack is due
+    System::Timer::Epoch mWRMPThrottleTimeout;  //Time until which Throttle is On, or 0 when not throttled
 #endif
     void DoClose(bool clearRetransTable);
     WEAVE_ERROR HandleMessage(WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchHeader, PacketBuffer *msgBuf);
@@ -376,6 +378,7 @@ private:
     void HandleConnectionClosed(WEAVE_ERROR conErr);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    bool IsWRMPThrottled(void);
     bool WRMPCheckAndRemRetransTable(uint32_t msgId, void **rCtxt);
     WEAVE_ERROR WRMPHandleRcvdAck(const WeaveExchangeHeader *exchHeader, const WeaveMessageInfo *msgInfo);
     WEAVE_ERROR WRMPHandleNeedsAck(const WeaveMessageInfo *msgInfo);
@@ -402,6 +405,7 @@ class NL_DLL_EXPORT WeaveExchangeManager
     friend class WeaveConnection;
     friend class WeaveSecurityManager;
     friend class WeaveFabricState;
+    friend class WeaveExchangeManagerTestObject;
 
 public:
     enum State
@@ -457,9 +461,10 @@ public:
 private:
     uint16_t NextExchangeId;
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
-    uint64_t mWRMPTimeStampBase;    //WRMP timer base value to add offsets to evaluate timeouts
     System::Timer::Epoch mWRMPCurrentTimerExpiry; //Tracks when the WRM timer will next expire
-    uint16_t mWRMPTimerInterval;    //WRMP Timer tick period
+    bool mWRMPTimerArmed;                         //Set when the WRM timer is running
+    System::Timer::Epoch mWRMPNextAckTime;        //No Solo Ack is due before this time
+    bool mWRMPAckScheduled;                       //Set when mWRMPNextAckTime is valid
     /**
      *  @class RetransTableEntry
      *
@@ -477,18 +482,44 @@ private:
        ExchangeContext      *exchContext;       /**< The ExchangeContext for the stored Weave message. */
        PacketBuffer         *msgBuf;            /**< A pointer to the PacketBuffer object holding the Weave message. */
        void                 *msgCtxt;           /**< A pointer to an application level context object associated with the message. */
-       uint16_t             nextRetransTime;    /**< A counter representing the next retransmission time for the message. */
+       RetransTableEntry    *next;              /**< The next entry in the retransmission queue. */
+       System::Timer::Epoch nextRetransTime;    /**< The time at which the message is next due for retransmission. */
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+       System::Timer::Epoch sendTime;           /**< The time at which the message was first sent. */
+#endif
        uint8_t              sendCount;          /**< A counter representing the number of times the message has been sent. */
     };
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    /**
+     *  @class PeerRTTEntry
+     *
+     *  @brief
+     *    This class is part of the Weave Reliable Messaging Protocol and holds
+     *    the smoothed round-trip time estimate for a peer node, from which the
+     *    retransmission timeout for messages sent to that peer is derived.
+     *
+     */
+    class PeerRTTEntry
+    {
+      public:
+       uint64_t             peerNodeId;         /**< The node identifier of the peer, or kNodeIdNotSpecified if the entry is free. */
+       uint32_t             srtt;               /**< The smoothed round-trip time, in milliseconds. */
+       uint32_t             rttVar;             /**< The round-trip time variation, in milliseconds. */
+    };
+#endif
     void     WRMPExecuteActions(void);
-    void     WRMPExpireTicks(void);
     void     WRMPStartTimer(void);
     void     WRMPStopTimer(void);
+    void     WRMPScheduleAck(System::Timer::Epoch ackTime);
+    void     WRMPScheduleRetrans(RetransTableEntry *entry, System::Timer::Epoch retransTime);
+    void     WRMPUnscheduleRetrans(RetransTableEntry *entry);
     void     WRMPProcessDDMessage(uint32_t PauseTimeMillis, uint64_t DelayedNodeId);
-    uint32_t GetTickCounterFromTimeDelta (uint64_t newTime,
-                                          uint64_t oldTime);
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    PeerRTTEntry *WRMPFindPeerRTT(uint64_t peerNodeId);
+    void     WRMPUpdatePeerRTT(uint64_t peerNodeId, uint32_t rtt);
+    uint32_t WRMPGetPeerRetransTimeout(uint64_t peerNodeId, uint32_t maxTimeout);
+#endif
     static void WRMPTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
-    static bool isLaterInWRMP(uint64_t t2, uint64_t t1);
     bool IsSendErrorCritical(WEAVE_ERROR err) const;
     WEAVE_ERROR AddToRetransTable(ExchangeContext *ec, PacketBuffer *inetBuff, uint32_t msgId, void *msgCtxt, RetransTableEntry **rEntry);
     WEAVE_ERROR SendFromRetransTable(RetransTableEntry *entry);
@@ -501,6 +532,11 @@ private:
 
     //WRMP Global tables for timer context
     RetransTableEntry RetransTable[WEAVE_CONFIG_WRMP_RETRANS_TABLE_SIZE];
+    RetransTableEntry *mRetransQueue;   //Entries in use, earliest nextRetransTime first
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    PeerRTTEntry mPeerRTTTable[WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE];
+    uint8_t mNextPeerRTTVictim;         //Entry of mPeerRTTTable to reuse when all are taken
+#endif
 #endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
     class UnsolicitedMessageHandler
@@ -512,19 +548,28 @@ private:
         WeaveConnection *Con; // NULL means any connection, or no connection (i.e. UDP)
         int16_t MessageType; // -1 represents any message type
         bool AllowDuplicateMsgs;
+        UnsolicitedMessageHandler *Next; // Next handler in the same bucket of UMHandlerIndex, in pool order
     };
 
 
     ExchangeContext ContextPool[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
     size_t mContextsInUse;
+    ExchangeContext *mFreeContexts;
+    ExchangeContext *mContextIndex[WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE];
 
     Binding BindingPool[WEAVE_CONFIG_MAX_BINDINGS];
     size_t mBindingsInUse;
 
     UnsolicitedMessageHandler UMHandlerPool[WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
+    UnsolicitedMessageHandler *UMHandlerIndex[WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE];
     void (*OnExchangeContextChanged)(size_t numContextsInUse);
 
     ExchangeContext *AllocContext(void);
+    void FreeContext(ExchangeContext *ec);
+    void IndexContext(ExchangeContext *ec);
+    bool UnindexContext(ExchangeContext *ec);
+    ExchangeContext *LookupContext(WeaveConnection *msgCon, const WeaveMessageInfo *msgInfo, const WeaveExchangeHeader *exchangeHeader);
+    static size_t ContextIndexHash(uint16_t exchangeId, bool isInitiator);
 
     void HandleConnectionReceived(WeaveConnection *con);
     void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
@@ -532,6 +577,10 @@ private:
     WEAVE_ERROR RegisterUMH(uint32_t profileId, int16_t msgType, WeaveConnection *con, bool allowDups,
             ExchangeContext::MessageReceiveFunct handler, void *appState);
     WEAVE_ERROR UnregisterUMH(uint32_t profileId, int16_t msgType, WeaveConnection *con);
+    void IndexUMH(UnsolicitedMessageHandler *umh);
+    void UnindexUMH(UnsolicitedMessageHandler *umh);
+    UnsolicitedMessageHandler *LookupUMH(uint32_t profileId, int16_t msgType, WeaveConnection *msgCon, bool isDuplicate);
+    static size_t UMHIndexHash(uint32_t profileId, int16_t msgType);
 
     static void HandleAcceptError(WeaveMessageLayer *msgLayer, WEAVE_ERROR err);
     static void HandleMessageReceived(WeaveMessageLayer *msgLayer, WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
@@ -90,6 +90,36 @@ using namespace nl::Weave::Profiles::Security::AppKeys;
   alignment_type varName[(((bytes)+(sizeof(alignment_type)-1))/sizeof(alignment_type))]
 #endif
 
+#if WEAVE_CONFIG_PEER_NODE_HASH_SIZE <= WEAVE_CONFIG_MAX_PEER_NODES
+#error "WEAVE_CONFIG_PEER_NODE_HASH_SIZE must be greater than WEAVE_CONFIG_MAX_PEER_NODES"
+#endif
+
+#if WEAVE_CONFIG_SESSION_KEY_HASH_SIZE <= WEAVE_CONFIG_MAX_SESSION_KEYS
+#error "WEAVE_CONFIG_SESSION_KEY_HASH_SIZE must be greater than WEAVE_CONFIG_MAX_SESSION_KEYS"
+#endif
+
+// Slot of a node id in the peer index. Node ids often differ only in their low-order bits,
+// so the id is folded and mixed before it is reduced to the size of the index.
+static inline size_t PeerIndexHome(uint64_t nodeId)
+{
+    nodeId ^= nodeId >> 32;
+    return static_cast<size_t>((nodeId * 0x9E3779B97F4A7C15ULL) >> 32) % WEAVE_CONFIG_PEER_NODE_HASH_SIZE;
+}
+
+// Slot of a key id / peer node id pair in the session key index.
+static inline size_t SessionKeyIndexHome(uint16_t keyId, uint64_t peerNodeId)
+{
+    peerNodeId ^= (peerNodeId >> 32) ^ (static_cast<uint64_t>(keyId) * 0x9E3779B1U);
+    return static_cast<size_t>((peerNodeId * 0x9E3779B97F4A7C15ULL) >> 32) % WEAVE_CONFIG_SESSION_KEY_HASH_SIZE;
+}
+
+// Whether an entry whose home slot is 'home' may be moved back into the empty slot 'hole' from the
+// later slot 'slot' of the same probe sequence, without becoming unreachable from its home slot.
+static inline bool CanShiftIndexEntry(size_t home, size_t hole, size_t slot)
+{
+    return (hole <= slot) ? (home <= hole || home > slot) : (home <= hole && home > slot);
+}
+
 // Identifies the scheme used to rotate fabric secret. The use of this
 // identifier is deprecated because fabric secret value never rotates.
 //
@@ -235,11 +265,12 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     LocalNodeId = 1;
     PairingCode = NULL;
     DefaultSubnet = kWeaveSubnetId_PrimaryWiFi;
-    PeerCount = 0;
     NextUnencUDPMsgId.Init(GetRandU32());
     NextUnencTCPMsgId.Init(0);
     for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
         SessionKeys[i].Init();
+    for (int i = 0; i < WEAVE_CONFIG_SESSION_KEY_HASH_SIZE; i++)
+        SessionKeyIndex[i] = WEAVE_CONFIG_MAX_SESSION_KEYS;
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     WEAVE_ERROR err = NextGroupKeyMsgId.Init(WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID, WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_EPOCH);
     if (err != WEAVE_NO_ERROR)
@@ -249,7 +280,7 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     MsgCounterSyncStatus = 0;
     AppKeyCache.Init();
 #endif
-    memset(&PeerStates, 0, sizeof(PeerStates));
+    ResetPeerStates();
     Delegate = NULL;
     memset(SharedSessionsNodes, 0, sizeof(SharedSessionsNodes));
 
@@ -314,6 +345,7 @@ WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, uint16_t keyI
 
     sessionKey->MsgEncKey.KeyId = keyId;
     sessionKey->NodeId = peerNodeId;
+    AddSessionKeyToIndex(sessionKey);
     sessionKey->MsgEncKey.EncType = kWeaveEncryptionType_None;
     sessionKey->NextMsgId.Init(UINT32_MAX);
     sessionKey->MaxRcvdMsgId = UINT32_MAX;
@@ -392,6 +424,7 @@ void WeaveFabricState::RemoveSessionKey(WeaveSessionKey *sessionKey, bool wasIdl
             (wasIdle) ? "idle " : "", sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
 
     RemoveSharedSessionEndNodes(sessionKey);
+    RemoveSessionKeyFromIndex(sessionKey);
     sessionKey->Clear();
 }
 
@@ -769,6 +802,7 @@ WEAVE_ERROR WeaveFabricState::RestoreSession(uint8_t * serializedSession, uint16
     {
         sessionKey->MsgEncKey.KeyId = keyId;
         sessionKey->NodeId = peerNodeId;
+        AddSessionKeyToIndex(sessionKey);
         sessionKey->BoundCon = NULL;
         sessionKey->ReserveCount = 0;
         sessionKey->Flags = 0;
@@ -1237,22 +1271,16 @@ exit:
  */
 bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex)
 {
-    uint16_t i;
-    bool retVal = false;
+    size_t slot = FindPeerIndexSlot(peerNodeId);
 
     // Find peer entry in the peer state table.
-    for (i = 0; i < PeerCount; i++)
+    if (PeerStates.NodeIdIndex[slot] != WEAVE_CONFIG_MAX_PEER_NODES)
     {
-        retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
-        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
-        {
-            retVal = true;
-            break;
-        }
+        retPeerIndex = PeerStates.NodeIdIndex[slot];
     }
 
     // If peer entry is not found in the peer state table and allocation was requested.
-    if (!retVal && allocEntry)
+    else if (allocEntry)
     {
         // If PeerStates table is full then the least recently used entry is discarded
         // and allocated for the new peer node. The replacement algorithms tries to find
@@ -1261,33 +1289,36 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         if (PeerCount == WEAVE_CONFIG_MAX_PEER_NODES)
         {
             // Choose the least recently used peer entry by default.
-            i = WEAVE_CONFIG_MAX_PEER_NODES - 1;
+            retPeerIndex = PeerStates.LeastRecentlyUsed;
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
             // Try to find the least recently used peer entry that didn't use encryption.
-            for (int j = WEAVE_CONFIG_MAX_PEER_NODES - 1; j >= 0; j--)
+            for (PeerIndexType peerInd = PeerStates.LeastRecentlyUsed; peerInd != WEAVE_CONFIG_MAX_PEER_NODES;
+                 peerInd = PeerStates.NextMoreRecentlyUsed[peerInd])
             {
-                PeerIndexType peerInd = PeerStates.MostRecentlyUsedIndexes[j];
                 if ((PeerStates.GroupKeyRcvFlags[peerInd] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) == 0)
                 {
-                    i = j;
+                    retPeerIndex = peerInd;
                     break;
                 }
             }
 #endif
 
-            // The peer index chosen for replacement.
-            retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
+            // Remove the discarded peer from the index and find the slot of the new peer again, since
+            // removal may have moved entries of its probe sequence.
+            RemovePeerIndexSlot(FindPeerIndexSlot(PeerStates.NodeId[retPeerIndex]));
+            slot = FindPeerIndexSlot(peerNodeId);
         }
 
-        // If PeerStates table is not full then the next available entry is "i".
+        // If PeerStates table is not full then the next available entry is PeerCount.
         // Entries in the table are allocated sequentially and never discarded until
         // the table is full. Only when table is full the least recently used entry
         // is discarded and replaced with the new entry.
         else
         {
-            PeerCount++;
-            retPeerIndex = i;
+            retPeerIndex = PeerCount++;
+            PeerStates.NextLessRecentlyUsed[retPeerIndex] = WEAVE_CONFIG_MAX_PEER_NODES;
+            PeerStates.NextMoreRecentlyUsed[retPeerIndex] = WEAVE_CONFIG_MAX_PEER_NODES;
         }
 
         PeerStates.NodeId[retPeerIndex] = peerNodeId;
@@ -1297,19 +1328,106 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         PeerStates.GroupKeyRcvFlags[retPeerIndex] = 0;
 #endif
         PeerStates.UnencRcvFlags[retPeerIndex] = 0;
-        retVal = true;
+        PeerStates.NodeIdIndex[slot] = retPeerIndex;
     }
 
-    // Move the requested entry to the top of the most recently used indexes list.
-    if (retVal)
+    else
     {
-        memmove(&PeerStates.MostRecentlyUsedIndexes[1],
-                &PeerStates.MostRecentlyUsedIndexes[0],
-                i * sizeof(PeerIndexType));
-        PeerStates.MostRecentlyUsedIndexes[0] = retPeerIndex;
+        return false;
     }
 
-    return retVal;
+    // Move the requested entry to the head of the most recently used list.
+    MarkPeerMostRecentlyUsed(retPeerIndex);
+
+    return true;
+}
+
+/**
+ * Clear the peer state table, its index, and its most recently used list.
+ */
+void WeaveFabricState::ResetPeerStates(void)
+{
+    PeerCount = 0;
+    memset(&PeerStates, 0, sizeof(PeerStates));
+    PeerStates.MostRecentlyUsed = WEAVE_CONFIG_MAX_PEER_NODES;
+    PeerStates.LeastRecentlyUsed = WEAVE_CONFIG_MAX_PEER_NODES;
+    for (int i = 0; i < WEAVE_CONFIG_PEER_NODE_HASH_SIZE; i++)
+        PeerStates.NodeIdIndex[i] = WEAVE_CONFIG_MAX_PEER_NODES;
+}
+
+/**
+ * Return the slot of the peer index that holds the entry for the given node id or, if the node has
+ * no entry, the empty slot in which its entry would be added.
+ */
+size_t WeaveFabricState::FindPeerIndexSlot(uint64_t peerNodeId)
+{
+    size_t slot = PeerIndexHome(peerNodeId);
+
+    while (PeerStates.NodeIdIndex[slot] != WEAVE_CONFIG_MAX_PEER_NODES &&
+           PeerStates.NodeId[PeerStates.NodeIdIndex[slot]] != peerNodeId)
+    {
+        slot = (slot + 1) % WEAVE_CONFIG_PEER_NODE_HASH_SIZE;
+    }
+
+    return slot;
+}
+
+/**
+ * Empty a slot of the peer index, moving later entries of the same probe sequence back into the hole
+ * so that lookups never need to skip deleted slots.
+ */
+void WeaveFabricState::RemovePeerIndexSlot(size_t hole)
+{
+    size_t slot = hole;
+
+    while (true)
+    {
+        slot = (slot + 1) % WEAVE_CONFIG_PEER_NODE_HASH_SIZE;
+
+        if (PeerStates.NodeIdIndex[slot] == WEAVE_CONFIG_MAX_PEER_NODES)
+            break;
+
+        if (CanShiftIndexEntry(PeerIndexHome(PeerStates.NodeId[PeerStates.NodeIdIndex[slot]]), hole, slot))
+        {
+            PeerStates.NodeIdIndex[hole] = PeerStates.NodeIdIndex[slot];
+            hole = slot;
+        }
+    }
+
+    PeerStates.NodeIdIndex[hole] = WEAVE_CONFIG_MAX_PEER_NODES;
+}
+
+/**
+ * Move a peer entry to the head of the most recently used list.
+ */
+void WeaveFabricState::MarkPeerMostRecentlyUsed(PeerIndexType peerIndex)
+{
+    PeerIndexType lessRecent = PeerStates.NextLessRecentlyUsed[peerIndex];
+    PeerIndexType moreRecent = PeerStates.NextMoreRecentlyUsed[peerIndex];
+
+    if (PeerStates.MostRecentlyUsed == peerIndex)
+        return;
+
+    // Unlink the entry, if it is already on the list.
+    if (moreRecent != WEAVE_CONFIG_MAX_PEER_NODES)
+    {
+        PeerStates.NextLessRecentlyUsed[moreRecent] = lessRecent;
+
+        if (lessRecent != WEAVE_CONFIG_MAX_PEER_NODES)
+            PeerStates.NextMoreRecentlyUsed[lessRecent] = moreRecent;
+        else
+            PeerStates.LeastRecentlyUsed = moreRecent;
+    }
+
+    PeerStates.NextLessRecentlyUsed[peerIndex] = PeerStates.MostRecentlyUsed;
+    PeerStates.NextMoreRecentlyUsed[peerIndex] = WEAVE_CONFIG_MAX_PEER_NODES;
+
+    if (PeerStates.MostRecentlyUsed != WEAVE_CONFIG_MAX_PEER_NODES)
+        PeerStates.NextMoreRecentlyUsed[PeerStates.MostRecentlyUsed] = peerIndex;
+    else
+        PeerStates.LeastRecentlyUsed = peerIndex;
+
+    PeerStates.MostRecentlyUsed = peerIndex;
 }
 
 WEAVE_ERROR WeaveFabricState::GetPassword(uint8_t pwSrc, const char *& ps, uint16_t& pwLen)
@@ -1795,8 +1913,8 @@ exit:
  */
 WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId, bool create, WeaveSessionKey *& retRec)
 {
-    WeaveSessionKey *curRec = SessionKeys;
-    WeaveSessionKey *freeRec = NULL;
+    WeaveSessionKey *curRec;
+    SessionKeyIndexType sessionKeyIndex;
 
     if (!WeaveKeyId::IsSessionKey(keyId))
         return WEAVE_ERROR_WRONG_KEY_TYPE;
@@ -1804,16 +1922,20 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (peerNodeId == kNodeIdNotSpecified || peerNodeId == kAnyNodeId)
         return WEAVE_ERROR_INVALID_ARGUMENT;
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, curRec++)
+    // Look up the session key established with the peer node.
+    sessionKeyIndex = SessionKeyIndex[FindSessionKeyIndexSlot(keyId, peerNodeId)];
+    if (sessionKeyIndex != WEAVE_CONFIG_MAX_SESSION_KEYS)
     {
-        if (!curRec->IsAllocated())
-        {
-            if (freeRec == NULL)
-                freeRec = curRec;
-        }
-        else if (curRec->MsgEncKey.KeyId == keyId &&
-                 (curRec->NodeId == peerNodeId ||
-                  (curRec->IsSharedSession() && FindSharedSessionEndNode(peerNodeId, curRec))))
+        retRec = &SessionKeys[sessionKeyIndex];
+        return WEAVE_NO_ERROR;
+    }
+
+    // Otherwise the peer node may be an alternate end node of a shared session.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES; i++)
+    {
+        curRec = SharedSessionsNodes[i].SessionKey;
+        if (SharedSessionsNodes[i].EndNodeId == peerNodeId && curRec != NULL && curRec->IsAllocated() &&
+            curRec->IsSharedSession() && curRec->MsgEncKey.KeyId == keyId)
         {
             retRec = curRec;
             return WEAVE_NO_ERROR;
@@ -1823,12 +1945,78 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (!create)
         return WEAVE_ERROR_KEY_NOT_FOUND;
 
-    if (freeRec == NULL)
-        return WEAVE_ERROR_TOO_MANY_KEYS;
+    curRec = SessionKeys;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, curRec++)
+    {
+        if (!curRec->IsAllocated())
+        {
+            retRec = curRec;
+            return WEAVE_NO_ERROR;
+        }
+    }
 
-    retRec = freeRec;
+    return WEAVE_ERROR_TOO_MANY_KEYS;
+}
 
-    return WEAVE_NO_ERROR;
+/**
+ * Return the slot of the session key index that holds the session key with the given key id and peer
+ * node id or, if there is no such key, the empty slot in which it would be added.
+ */
+size_t WeaveFabricState::FindSessionKeyIndexSlot(uint16_t keyId, uint64_t peerNodeId)
+{
+    size_t slot = SessionKeyIndexHome(keyId, peerNodeId);
+
+    while (SessionKeyIndex[slot] != WEAVE_CONFIG_MAX_SESSION_KEYS)
+    {
+        const WeaveSessionKey& sessionKey = SessionKeys[SessionKeyIndex[slot]];
+
+        if (sessionKey.MsgEncKey.KeyId == keyId && sessionKey.NodeId == peerNodeId)
+            break;
+
+        slot = (slot + 1) % WEAVE_CONFIG_SESSION_KEY_HASH_SIZE;
+    }
+
+    return slot;
+}
+
+/**
+ * Add a newly allocated session key to the session key index, once its key id and peer node id
+ * have been set.
+ */
+void WeaveFabricState::AddSessionKeyToIndex(const WeaveSessionKey *sessionKey)
+{
+    SessionKeyIndex[FindSessionKeyIndexSlot(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId)] =
+        static_cast<SessionKeyIndexType>(sessionKey - SessionKeys);
+}
+
+/**
+ * Remove a session key from the session key index, moving later entries of the same probe sequence
+ * back into the hole so that lookups never need to skip deleted slots.
+ */
+void WeaveFabricState::RemoveSessionKeyFromIndex(const WeaveSessionKey *sessionKey)
+{
+    size_t hole = FindSessionKeyIndexSlot(sessionKey->MsgEncKey.KeyId, sessionKey->NodeId);
+    size_t slot = hole;
+
+    if (SessionKeyIndex[hole] == WEAVE_CONFIG_MAX_SESSION_KEYS)
+        return;
+
+    while (true)
+    {
+        slot = (slot + 1) % WEAVE_CONFIG_SESSION_KEY_HASH_SIZE;
+
+        if (SessionKeyIndex[slot] == WEAVE_CONFIG_MAX_SESSION_KEYS)
+            break;
+
+        const WeaveSessionKey& other = SessionKeys[SessionKeyIndex[slot]];
+        if (CanShiftIndexEntry(SessionKeyIndexHome(other.MsgEncKey.KeyId, other.NodeId), hole, slot))
+        {
+            SessionKeyIndex[hole] = SessionKeyIndex[slot];
+            hole = slot;
+        }
+    }
+
+    SessionKeyIndex[hole] = WEAVE_CONFIG_MAX_SESSION_KEYS;
 }
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
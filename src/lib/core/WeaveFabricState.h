@@ -479,6 +479,12 @@ public:
     typedef uint16_t PeerIndexType;
 #endif
 
+#if WEAVE_CONFIG_MAX_SESSION_KEYS <= UINT8_MAX
+    typedef uint8_t SessionKeyIndexType;
+#else
+    typedef uint16_t SessionKeyIndexType;
+#endif
+
     enum State
     {
         kState_NotInitialized = 0, kState_Initialized = 1
@@ -573,6 +579,9 @@ private:
     MonotonicallyIncreasingCounter NextUnencUDPMsgId;
     MonotonicallyIncreasingCounter NextUnencTCPMsgId;
     WeaveSessionKey SessionKeys[WEAVE_CONFIG_MAX_SESSION_KEYS];
+    // Open-addressed index of the allocated session keys by key id and peer node id. Empty slots hold
+    // WEAVE_CONFIG_MAX_SESSION_KEYS.
+    SessionKeyIndexType SessionKeyIndex[WEAVE_CONFIG_SESSION_KEY_HASH_SIZE];
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     PersistedCounter NextGroupKeyMsgId;
 
@@ -605,8 +614,14 @@ private:
         WeaveSessionState::ReceiveFlagsType GroupKeyRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
 #endif
         WeaveSessionState::ReceiveFlagsType UnencRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
-        // Array of peer indexes in sorted order from most- to least- recently used.
-        PeerIndexType MostRecentlyUsedIndexes[WEAVE_CONFIG_MAX_PEER_NODES];
+        // Doubly-linked list of peer indexes in order from most- to least- recently used. Links to no
+        // entry hold WEAVE_CONFIG_MAX_PEER_NODES.
+        PeerIndexType NextLessRecentlyUsed[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType NextMoreRecentlyUsed[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType MostRecentlyUsed;
+        PeerIndexType LeastRecentlyUsed;
+        // Open-addressed index of the peer entries by node id. Empty slots hold WEAVE_CONFIG_MAX_PEER_NODES.
+        PeerIndexType NodeIdIndex[WEAVE_CONFIG_PEER_NODE_HASH_SIZE];
     } PeerStates;
     FabricStateDelegate *Delegate;
 
@@ -627,6 +642,13 @@ private:
 #endif
 
     bool FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex);
+    void ResetPeerStates(void);
+    size_t FindPeerIndexSlot(uint64_t peerNodeId);
+    void RemovePeerIndexSlot(size_t slot);
+    void MarkPeerMostRecentlyUsed(PeerIndexType peerIndex);
+    size_t FindSessionKeyIndexSlot(uint16_t keyId, uint64_t peerNodeId);
+    void AddSessionKeyToIndex(const WeaveSessionKey *sessionKey);
+    void RemoveSessionKeyFromIndex(const WeaveSessionKey *sessionKey);
     WEAVE_ERROR FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec);
     WEAVE_ERROR DeriveMsgEncAppKey(uint32_t keyId, uint8_t encType, WeaveMsgEncryptionKey & appKey, uint32_t& appGroupGlobalId);
 };
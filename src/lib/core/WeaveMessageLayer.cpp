@@ -1317,7 +1317,15 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
     // in the final encoded message.
     uint16_t headLen = 6;
     uint16_t tailLen = 0;
-    uint16_t payloadLen = msgBuf->DataLength();
+    uint16_t payloadLen = msgBuf->TotalLength();
+
+    // The payload may only span a chain of buffers when the message is sent over a connection.
+    PacketBuffer *lastBuf = msgBuf;
+    while (lastBuf->Next() != NULL)
+        lastBuf = lastBuf->Next();
+    if (lastBuf != msgBuf && con == NULL)
+        return WEAVE_ERROR_MESSAGE_TOO_LONG;
+
     if (msgInfo->Flags & kWeaveMessageFlag_SourceNodeId)
         headLen += 8;
     if (msgInfo->Flags & kWeaveMessageFlag_DestNodeId)
@@ -1338,7 +1346,7 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
     }
 
     // Error if the encoded message would be longer than the requested maximum.
-    if ((headLen + msgBuf->DataLength() + tailLen) > maxLen)
+    if ((headLen + payloadLen + tailLen) > maxLen)
         return WEAVE_ERROR_MESSAGE_TOO_LONG;
 
     // Ensure there's enough room before the payload to hold the message header.
@@ -1346,9 +1354,18 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
     if (!msgBuf->EnsureReservedSize(headLen + reserve))
         return WEAVE_ERROR_BUFFER_TOO_SMALL;
 
-    // Error if not enough space after the message payload.
-    if ((msgBuf->DataLength() + tailLen) > msgBuf->MaxDataLength())
-        return WEAVE_ERROR_BUFFER_TOO_SMALL;
+    // Error if not enough space after the message payload.  For a buffer chain, append a
+    // buffer to hold the trailer if the last one is full.
+    if ((lastBuf->DataLength() + tailLen) > lastBuf->MaxDataLength())
+    {
+        if (lastBuf == msgBuf)
+            return WEAVE_ERROR_BUFFER_TOO_SMALL;
+
+        lastBuf = PacketBuffer::New(0);
+        if (lastBuf == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+        msgBuf->AddToEnd(lastBuf);
+    }
 
     uint8_t *payloadStart = msgBuf->Start();
 
@@ -1430,21 +1447,24 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
         // so skip over the payload data.
         p += payloadLen;
 
-        // Compute the integrity check value and store it immediately after the payload data.
+        // Compute the integrity check value and store it immediately after the payload data, in the last buffer.
         ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
-                                            payloadStart, payloadLen, p);
+                                            msgBuf, payloadStart, payloadLen, lastBuf->Start() + lastBuf->DataLength());
         p += HMACSHA1::kDigestLength;
 
-        // Encrypt the message payload and the integrity check value that follows it, in place, in the message buffer.
+        // Encrypt the message payload and the integrity check value that follows it, in place, in the message buffers.
         Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
-                              payloadStart, payloadLen + HMACSHA1::kDigestLength, payloadStart);
+                              msgBuf, payloadStart, payloadLen + HMACSHA1::kDigestLength);
 
         break;
     }
 
     msgInfo->Flags |= kWeaveMessageFlag_MessageEncoded;
     // Update the buffer length to reflect the entire encoded message.
-    msgBuf->SetDataLength(headLen + payloadLen + tailLen);
+    if (lastBuf == msgBuf)
+        msgBuf->SetDataLength(headLen + payloadLen + tailLen);
+    else
+        lastBuf->SetDataLength(lastBuf->DataLength() + tailLen, msgBuf);
 
     // We update the cursor (p) out of good hygiene,
     // such that if the code is extended in the future such that the cursor is used,
@@ -1454,6 +1474,27 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
     return WEAVE_NO_ERROR;
 }
 
+/**
+ *  Update the header of a decoded message with the state of the session it was received on.
+ */
+static void SetReceivedMessageState(WeaveSessionState &sessionState, WeaveMessageInfo *msgInfo)
+{
+    // Set flag in the message header indicating that the message is a duplicate if:
+    //  - A message with the same message identifier has already been received from that peer.
+    //  - This is the first message from that peer encrypted with application keys.
+    if (sessionState.IsDuplicateMessage(msgInfo->MessageId))
+        msgInfo->Flags |= kWeaveMessageFlag_DuplicateMessage;
+
+#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
+    // Set flag if peer group key message counter is not synchronized.
+    if (sessionState.MessageIdNotSynchronized() && WeaveKeyId::IsAppGroupKey(msgInfo->KeyId))
+        msgInfo->Flags |= kWeaveMessageFlag_PeerGroupMsgIdNotSynchronized;
+#endif
+
+    // Pass the peer authentication mode back to the application via the weave message header structure.
+    msgInfo->PeerAuthMode = sessionState.AuthMode;
+}
+
 WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
         WeaveMessageInfo *msgInfo, uint8_t **rPayload, uint16_t *rPayloadLen) // TODO: use references
 {
@@ -1519,20 +1560,7 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sour
         return WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE;
     }
 
-    // Set flag in the message header indicating that the message is a duplicate if:
-    //  - A message with the same message identifier has already been received from that peer.
-    //  - This is the first message from that peer encrypted with application keys.
-    if (sessionState.IsDuplicateMessage(msgInfo->MessageId))
-        msgInfo->Flags |= kWeaveMessageFlag_DuplicateMessage;
-
-#if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
-    // Set flag if peer group key message counter is not synchronized.
-    if (sessionState.MessageIdNotSynchronized() && WeaveKeyId::IsAppGroupKey(msgInfo->KeyId))
-        msgInfo->Flags |= kWeaveMessageFlag_PeerGroupMsgIdNotSynchronized;
-#endif
-
-    // Pass the peer authentication mode back to the application via the weave message header structure.
-    msgInfo->PeerAuthMode = sessionState.AuthMode;
+    SetReceivedMessageState(sessionState, msgInfo);
 
     return err;
 }
@@ -1547,7 +1575,7 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessageWithLength(WeaveMessageInfo *msgInfo
 
     // Prepend the message length to the beginning of the message.
     uint8_t * newMsgStart = msgBuf->Start() - 2;
-    uint16_t msgLen = msgBuf->DataLength();
+    uint16_t msgLen = msgBuf->TotalLength();
     msgBuf->SetStart(newMsgStart);
     LittleEndian::Put16(newMsgStart, msgLen);
 
@@ -1608,6 +1636,164 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessageWithLength(PacketBuffer *msgBuf, uin
     return err;
 }
 
+// Copy the last len bytes of the data in a buffer chain, which may span more than one buffer.
+static void CopyChainTail(PacketBuffer *buf, uint8_t *outBuf, uint16_t len)
+{
+    uint32_t skip = buf->TotalLength() - len;
+
+    for (; buf != NULL; buf = buf->Next())
+    {
+        if (skip >= buf->DataLength())
+        {
+            skip -= buf->DataLength();
+            continue;
+        }
+
+        memcpy(outBuf, buf->Start() + skip, buf->DataLength() - skip);
+        outBuf += buf->DataLength() - skip;
+        skip = 0;
+    }
+}
+
+/**
+ *  Decode a length-prefixed Weave message that is too long for a single buffer.
+ *
+ *  Such a message can only be received over a connection, in a chain of buffers that holds nothing but the message (see
+ *  TCPEndPoint::SetFramedReceive()).  On success, the message is split off the received data and returned as a chain of
+ *  buffers holding its payload.
+ *
+ *  @param[inout]  msgBuf         On input, the received data, starting with the message length field.  On success, the
+ *                                data following the message, or NULL if there is none.
+ *
+ *  @param[in]     sourceNodeId   The node identifier of the peer.
+ *
+ *  @param[in]     con            The connection the message was received on.
+ *
+ *  @param[out]    msgInfo        The decoded message header.
+ *
+ *  @param[out]    rPayload       On success, the chain of buffers holding the message payload.
+ *
+ *  @param[out]    rFrameLen      The length of the message, including the length field.
+ *
+ *  @retval  #WEAVE_NO_ERROR                       On success.
+ *  @retval  #WEAVE_ERROR_MESSAGE_INCOMPLETE       If the message has not been received in full.
+ *  @retval  #WEAVE_ERROR_MESSAGE_TOO_LONG         If the message does not end on a buffer boundary.
+ *  @retval  #WEAVE_ERROR_INTEGRITY_CHECK_FAILED   If the message fails its integrity check.
+ *  @retval  other                                 Errors from decoding the message header.
+ */
+WEAVE_ERROR WeaveMessageLayer::DecodeChainedMessageWithLength(PacketBuffer *&msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
+        WeaveMessageInfo *msgInfo, PacketBuffer **rPayload, uint32_t *rFrameLen)
+{
+    WEAVE_ERROR err;
+    WeaveSessionState sessionState;
+    PacketBuffer *msg = NULL;
+    PacketBuffer *buf;
+    uint32_t chainLen = 0;
+    uint16_t msgLen;
+    uint16_t payloadLen;
+    uint8_t *p;
+    uint8_t integrityCheck[HMACSHA1::kDigestLength];
+    uint8_t expectedIntegrityCheck[HMACSHA1::kDigestLength];
+
+    // Error if the message buffer doesn't contain the entire message length field.
+    if (msgBuf->DataLength() < 2)
+    {
+        *rFrameLen = 8; // Assume absolute minimum frame length.
+        return WEAVE_ERROR_MESSAGE_INCOMPLETE;
+    }
+
+    *rFrameLen = static_cast<uint32_t>(LittleEndian::Get16(msgBuf->Start())) + 2;
+
+    // The message must end exactly at the end of a buffer.
+    for (buf = msgBuf; buf != NULL && chainLen < *rFrameLen; buf = buf->Next())
+        chainLen += buf->DataLength();
+    if (chainLen < *rFrameLen)
+        return WEAVE_ERROR_MESSAGE_INCOMPLETE;
+    if (chainLen != *rFrameLen)
+        return WEAVE_ERROR_MESSAGE_TOO_LONG;
+
+    // Split the buffers holding the message off the received data.
+    for (chainLen = 0; chainLen < *rFrameLen; )
+    {
+        buf = msgBuf;
+        msgBuf = (buf->Next() != NULL) ? buf->DetachTail() : NULL;
+        chainLen += buf->DataLength();
+
+        if (msg == NULL)
+            msg = buf;
+        else
+            msg->AddToEnd(buf);
+    }
+
+    msg->SetStart(msg->Start() + 2);
+    msgLen = msg->TotalLength();
+    p = msg->Start();
+
+    msgInfo->SourceNodeId = sourceNodeId;
+    err = DecodeHeader(msg, msgInfo, &p);
+    SuccessOrExit(err);
+
+    err = FabricState->GetSessionState(msgInfo->SourceNodeId, msgInfo->KeyId, msgInfo->EncryptionType, con, sessionState);
+    SuccessOrExit(err);
+
+    switch (msgInfo->EncryptionType)
+    {
+    case kWeaveEncryptionType_None:
+        break;
+
+    case kWeaveEncryptionType_AES128CTRSHA1:
+        // Error if the message is short given the expected fields.
+        VerifyOrExit((p - msg->Start()) + kMinPayloadLen + HMACSHA1::kDigestLength <= msgLen,
+                     err = WEAVE_ERROR_INVALID_MESSAGE_LENGTH);
+
+        // Decrypt the message payload and the integrity check value that follows it, in place, in the message buffers.
+        payloadLen = msgLen - (p - msg->Start()) - HMACSHA1::kDigestLength;
+        Encrypt_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.DataKey,
+                              msg, p, payloadLen + HMACSHA1::kDigestLength);
+
+        // Compute the expected integrity check value from the decrypted payload, and error if it doesn't match the
+        // integrity check value at the end of the message, which may span two buffers.
+        ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, sessionState.MsgEncKey->EncKey.AES128CTRSHA1.IntegrityKey,
+                                            msg, p, payloadLen, expectedIntegrityCheck);
+        CopyChainTail(msg, integrityCheck, HMACSHA1::kDigestLength);
+        VerifyOrExit(ConstantTimeCompare(integrityCheck, expectedIntegrityCheck, HMACSHA1::kDigestLength),
+                     err = WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+
+        // Drop the integrity check value from the end of the chain, along with any buffers left empty.
+        msgLen -= HMACSHA1::kDigestLength;
+        chainLen = 0;
+        for (buf = msg; buf != NULL; buf = buf->Next())
+        {
+            if (chainLen + buf->DataLength() >= msgLen)
+            {
+                for (PacketBuffer *tail = buf->Next(); tail != NULL; tail = tail->Next())
+                    tail->SetDataLength(0, msg);
+                buf->SetDataLength(static_cast<uint16_t>(msgLen - chainLen), msg);
+                if (buf->Next() != NULL)
+                    PacketBuffer::Free(buf->DetachTail());
+                break;
+            }
+            chainLen += buf->DataLength();
+        }
+        break;
+
+    default:
+        ExitNow(err = WEAVE_ERROR_UNSUPPORTED_ENCRYPTION_TYPE);
+    }
+
+    SetReceivedMessageState(sessionState, msgInfo);
+
+    // Adjust the buffers to hold just the payload.
+    msg->SetStart(p);
+    *rPayload = msg;
+    msg = NULL;
+
+exit:
+    if (msg != NULL)
+        PacketBuffer::Free(msg);
+    return err;
+}
+
 void WeaveMessageLayer::HandleUDPMessage(UDPEndPoint *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -2201,19 +2387,9 @@ exit:
     return err;
 }
 
-void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                              const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
+// Begin the HMAC of a message and hash the message header fields covered by the integrity check.
+static void BeginIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key, HMACSHA1 &hmacSHA1)
 {
-    AES128CTRMode aes128CTR;
-    aes128CTR.SetKey(key);
-    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
-    aes128CTR.EncryptData(inData, inLen, outBuf);
-}
-
-void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
-                                                            const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
-{
-    HMACSHA1 hmacSHA1;
     uint8_t encodedBuf[2 * sizeof(uint64_t) + sizeof(uint16_t) + sizeof(uint32_t)];
     uint8_t *p = encodedBuf;
 
@@ -2240,6 +2416,45 @@ void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageIn
 
     // Hash encoded message header fields.
     hmacSHA1.AddData(encodedBuf, p - encodedBuf);
+}
+
+void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                              const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
+{
+    AES128CTRMode aes128CTR;
+    aes128CTR.SetKey(key);
+    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
+    aes128CTR.EncryptData(inData, inLen, outBuf);
+}
+
+// Encrypt, in place, data starting within the first buffer of a chain and continuing through the buffers that follow.
+// Any data past the end of the chain, such as an integrity check value not yet counted in the length of the last
+// buffer, is taken from the space after the data in the last buffer.
+void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                              PacketBuffer *msgBuf, uint8_t *data, uint32_t len)
+{
+    AES128CTRMode aes128CTR;
+    aes128CTR.SetKey(key);
+    aes128CTR.SetWeaveMessageCounter(msgInfo->SourceNodeId, msgInfo->MessageId);
+
+    for (; len > 0 && msgBuf != NULL; msgBuf = msgBuf->Next(), data = (msgBuf != NULL) ? msgBuf->Start() : NULL)
+    {
+        uint32_t bufLen = len;
+
+        if (msgBuf->Next() != NULL && static_cast<uint32_t>(msgBuf->Start() + msgBuf->DataLength() - data) < bufLen)
+            bufLen = msgBuf->Start() + msgBuf->DataLength() - data;
+
+        aes128CTR.EncryptData(data, static_cast<uint16_t>(bufLen), data);
+        len -= bufLen;
+    }
+}
+
+void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                                            const uint8_t *inData, uint16_t inLen, uint8_t *outBuf)
+{
+    HMACSHA1 hmacSHA1;
+
+    BeginIntegrityCheck_AES128CTRSHA1(msgInfo, key, hmacSHA1);
 
     // Handle payload data.
     hmacSHA1.AddData(inData, inLen);
@@ -2248,6 +2463,32 @@ void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageIn
     hmacSHA1.Finish(outBuf);
 }
 
+// Compute the integrity check value of a message payload that starts within the first buffer of a chain and continues
+// through the buffers that follow.
+void WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                                            PacketBuffer *msgBuf, const uint8_t *inData, uint32_t inLen,
+                                                            uint8_t *outBuf)
+{
+    HMACSHA1 hmacSHA1;
+
+    BeginIntegrityCheck_AES128CTRSHA1(msgInfo, key, hmacSHA1);
+
+    // Handle payload data, a buffer at a time.
+    for (; inLen > 0 && msgBuf != NULL; msgBuf = msgBuf->Next(), inData = (msgBuf != NULL) ? msgBuf->Start() : NULL)
+    {
+        uint32_t bufLen = msgBuf->Start() + msgBuf->DataLength() - inData;
+
+        if (bufLen > inLen)
+            bufLen = inLen;
+
+        hmacSHA1.AddData(inData, static_cast<uint16_t>(bufLen));
+        inLen -= bufLen;
+    }
+
+    // Generate the MAC.
+    hmacSHA1.Finish(outBuf);
+}
+
 /**
  *  Close all open TCP and UDP endpoints. Then abort any
  *  open WeaveConnections and shutdown any open
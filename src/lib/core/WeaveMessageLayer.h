@@ -60,7 +60,6 @@ enum
     kWeavePeerDescription_MaxLength = 100,  /**< Maximum length of string (including NUL character) returned by WeaveMessageLayer::GetPeerDescription(). */
 };
 
-
 /**
  *  @brief
  *    Definitions pertaining to the header of an encoded Weave message.
@@ -283,6 +282,9 @@ public:
     WEAVE_ERROR SendTunneledMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
 #endif
 
+    void DeferSending(void);
+    WEAVE_ERROR FlushSending(void);
+
     // TODO COM-311: implement EnableReceived/DisableReceive for BLE WeaveConnections.
     void EnableReceive(void);
     void DisableReceive(void);
@@ -303,6 +305,9 @@ public:
 
     WEAVE_ERROR SetUserTimeout(uint32_t userTimeoutMillis);
     WEAVE_ERROR ResetUserTimeout(void);
+
+    WEAVE_ERROR SetFramedReceive(bool enable);
+
     uint16_t LogId(void) const { return static_cast<uint16_t>(reinterpret_cast<intptr_t>(this)); }
 
     TCPEndPoint * GetTCPEndPoint(void) const { return mTcpEndPoint; }
@@ -394,6 +399,8 @@ private:
     enum FlagsEnum
     {
         kFlag_IsIncoming              = 0x01,           /**< The connection was initiated by external node. */
+        kFlag_SendDeferred            = 0x02,           /**< Sent messages are held back until FlushSending() is called. */
+        kFlag_FramedReceive           = 0x04,           /**< Each received message is read whole, into a buffer of its own. */
     };
 
     uint8_t mFlags;                                     /**< Various flags associated with the connection. */
@@ -716,6 +723,7 @@ public:
     static void GetPeerDescription(char *buf, size_t bufSize, uint64_t nodeId, const IPAddress *addr, uint16_t port, InterfaceId interfaceId, const WeaveConnection *con);
     static void GetPeerDescription(char *buf, size_t bufSize, const WeaveMessageInfo *msgInfo);
 
+
 private:
     enum
     {
@@ -780,6 +788,8 @@ private:
             uint16_t maxLen);
     WEAVE_ERROR DecodeMessageWithLength(PacketBuffer *msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
             WeaveMessageInfo *msgInfo, uint8_t **rPayload, uint16_t *rPayloadLen, uint32_t *rFrameLen);
+    WEAVE_ERROR DecodeChainedMessageWithLength(PacketBuffer *&msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
+            WeaveMessageInfo *msgInfo, PacketBuffer **rPayload, uint32_t *rFrameLen);
     void GetIncomingTCPConCount(const IPAddress &peerAddr, uint16_t &count, uint16_t &countFromIP);
     void CheckForceRefreshUDPEndPointsNeeded(WEAVE_ERROR udpSendErr);
 
@@ -790,8 +800,12 @@ private:
     static void HandleAcceptError(TCPEndPoint *endPoint, INET_ERROR err);
     static void Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
                                       const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
+    static void Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                      PacketBuffer *msgBuf, uint8_t *data, uint32_t len);
     static void ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
                                                     const uint8_t *inData, uint16_t inLen, uint8_t *outBuf);
+    static void ComputeIntegrityCheck_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
+                                                    PacketBuffer *msgBuf, const uint8_t *inData, uint32_t inLen, uint8_t *outBuf);
     static WEAVE_ERROR FilterUDPSendError(WEAVE_ERROR err, bool isMulticast);
     static bool IsIgnoredMulticastSendError(WEAVE_ERROR err);
 
@@ -66,6 +66,25 @@ enum {
     kTLVControlByte_NotSpecified = 0xFFFF
 };
 
+/**
+ * Records the position of a single TLV element within a container, as captured by
+ * TLVReader::BuildIndex().
+ *
+ * An index entry holds the state of the reader immediately after the head of the element
+ * has been decoded, allowing TLVReader::FindIndexedElement() to reposition a reader on the
+ * element without re-scanning or re-decoding the container.
+ */
+struct TLVIndexEntry
+{
+    uint64_t Tag;
+    uint64_t LenOrVal;
+    uintptr_t BufHandle;
+    const uint8_t *ReadPoint;
+    const uint8_t *BufEnd;
+    uint32_t LenRead;
+    uint16_t ControlByte;
+};
+
 /**
  * Provides a memory efficient parser for data encoded in Weave TLV format.
  *
@@ -145,6 +164,10 @@ public:
 
     WEAVE_ERROR Skip(void);
 
+    WEAVE_ERROR BuildIndex(TLVIndexEntry *index, size_t maxEntries, size_t& numEntries) const;
+    WEAVE_ERROR FindIndexedElement(const TLVIndexEntry *index, size_t numEntries, uint64_t tag,
+            TLVReader& reader) const;
+
     uint32_t ImplicitProfileId;
     void *AppData;
 
@@ -37,6 +37,20 @@ using namespace nl::Weave::Encoding;
 
 static const uint8_t sTagSizes[] = { 0, 1, 2, 4, 2, 4, 6, 8 };
 
+// Number of bytes in the length/value field of each TLV element type, indexed by element type.
+static const uint8_t sLenOrValSizes[] =
+{
+    1, 2, 4, 8,         // Signed integers
+    1, 2, 4, 8,         // Unsigned integers
+    0, 0,               // Booleans
+    4, 8,               // Floating point numbers
+    1, 2, 4, 8,         // UTF8 string lengths
+    1, 2, 4, 8,         // Byte string lengths
+    0,                  // Null
+    0, 0, 0,            // Structure, array, path
+    0                   // End of container
+};
+
 /**
  * @fn uint32_t TLVReader::GetLengthRead() const
  *
@@ -1203,6 +1217,131 @@ WEAVE_ERROR TLVReader::Skip()
     return WEAVE_NO_ERROR;
 }
 
+/**
+ * Records the position of each element that follows the reader's current position, up to the
+ * end of the enclosing container, in a caller-supplied index.
+ *
+ * The BuildIndex() method scans the remaining elements of the current container once, recording
+ * for each element the reader state needed to reposition a reader on that element.  The resulting
+ * entries are sorted by tag, allowing subsequent lookups via FindIndexedElement() to be answered
+ * with a binary search, without re-reading the container.  Where a tag occurs more than once,
+ * lookups return the first occurrence.  Members of nested containers are not indexed.
+ *
+ * The reader itself is not modified.  Typically the method is called immediately after entering
+ * a structure or path, before the first call to Next().
+ *
+ * The index refers directly into the underlying TLV data, and thus remains valid only as long as
+ * that data is retained and unmodified.  Indexing is not supported for readers whose GetNextBuffer
+ * function discards previously read data.
+ *
+ * @param[in]  index                    A pointer to an array of TLVIndexEntry objects to be filled.
+ * @param[in]  maxEntries               The number of entries in the @p index array.
+ * @param[out] numEntries               The number of elements recorded in the index.
+ *
+ * @retval #WEAVE_NO_ERROR              If the index was built successfully.
+ * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL
+ *                                      If the container holds more than @p maxEntries elements.
+ * @retval #WEAVE_ERROR_TLV_UNDERRUN    If the underlying TLV encoding ended prematurely.
+ * @retval #WEAVE_ERROR_INVALID_TLV_ELEMENT
+ *                                      If the reader encountered an invalid or unsupported TLV
+ *                                      element type.
+ * @retval #WEAVE_ERROR_INVALID_TLV_TAG If the reader encountered a TLV tag in an invalid context.
+ * @retval other                        Other Weave or platform error codes returned by the configured
+ *                                      GetNextBuffer() function. Only possible when GetNextBuffer is
+ *                                      non-NULL.
+ *
+ */
+WEAVE_ERROR TLVReader::BuildIndex(TLVIndexEntry *index, size_t maxEntries, size_t& numEntries) const
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+
+    numEntries = 0;
+
+    reader.Init(*this);
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        if (numEntries == maxEntries)
+            return WEAVE_ERROR_BUFFER_TOO_SMALL;
+
+        TLVIndexEntry entry;
+
+        entry.Tag = reader.mElemTag;
+        entry.LenOrVal = reader.mElemLenOrVal;
+        entry.BufHandle = reader.mBufHandle;
+        entry.ReadPoint = reader.mReadPoint;
+        entry.BufEnd = reader.mBufEnd;
+        entry.LenRead = reader.mLenRead;
+        entry.ControlByte = reader.mControlByte;
+
+        // Insert the entry in tag order.  Entries with equal tags are kept in encoding order, so that
+        // lookups find the first occurrence of a tag.
+        size_t i = numEntries;
+        for (; i > 0 && index[i - 1].Tag > entry.Tag; i--)
+            index[i] = index[i - 1];
+        index[i] = entry;
+
+        numEntries++;
+    }
+
+    if (err == WEAVE_END_OF_TLV)
+        err = WEAVE_NO_ERROR;
+
+    return err;
+}
+
+/**
+ * Positions a TLVReader object on an element previously recorded by BuildIndex().
+ *
+ * On success, @p reader is initialized from this reader and positioned on the first element of the
+ * index having the specified tag, exactly as if it had been reached by calling Next().  The index
+ * must have been built from this reader, or from a copy of it at the same position.
+ *
+ * @param[in]  index                    A pointer to an array of TLVIndexEntry objects filled by
+ *                                      BuildIndex().
+ * @param[in]  numEntries               The number of entries in the @p index array.
+ * @param[in]  tag                      The tag of the element to find.
+ * @param[out] reader                   A reference to a TLVReader object to be positioned on the
+ *                                      element.
+ *
+ * @retval #WEAVE_NO_ERROR              If the element was found.
+ * @retval #WEAVE_END_OF_TLV            If no element with the specified tag was recorded in the index.
+ *
+ */
+WEAVE_ERROR TLVReader::FindIndexedElement(const TLVIndexEntry *index, size_t numEntries, uint64_t tag,
+        TLVReader& reader) const
+{
+    size_t low = 0;
+    size_t high = numEntries;
+
+    while (low < high)
+    {
+        size_t mid = low + (high - low) / 2;
+
+        if (index[mid].Tag < tag)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    if (low == numEntries || index[low].Tag != tag)
+        return WEAVE_END_OF_TLV;
+
+    reader.Init(*this);
+
+    reader.mElemTag = index[low].Tag;
+    reader.mElemLenOrVal = index[low].LenOrVal;
+    reader.mBufHandle = index[low].BufHandle;
+    reader.mReadPoint = index[low].ReadPoint;
+    reader.mBufEnd = index[low].BufEnd;
+    reader.mLenRead = index[low].LenRead;
+    reader.mControlByte = index[low].ControlByte;
+    reader.SetContainerOpen(false);
+
+    return WEAVE_NO_ERROR;
+}
+
 /**
  * Clear the state of the TLVReader.
  * This method is used to position the reader before the first TLV,
@@ -1307,16 +1446,26 @@ WEAVE_ERROR TLVReader::ReadElement()
     // Determine the number of bytes in the element's tag, if any.
     uint8_t tagBytes = sTagSizes[tagControl >> kTLVTagControlShift];
 
-    // Extract the size of length/value field from the control byte.
-    TLVFieldSize lenOrValFieldSize = GetTLVFieldSize(elemType);
-
     // Determine the number of bytes in the length/value field.
-    uint8_t valOrLenBytes = TLVFieldSizeToBytes(lenOrValFieldSize);
+    uint8_t valOrLenBytes = sLenOrValSizes[elemType];
 
     // Determine the number of bytes in the element's 'head'. This includes: the control byte, the tag bytes (if present), the
     // length bytes (if present), and for elements that don't have a length (e.g. integers), the value bytes.
     uint8_t elemHeadBytes = 1 + tagBytes + valOrLenBytes;
 
+    // Fast path for the most common element heads: an anonymous or context-specific tag, followed by a length/value
+    // field of at most one byte (e.g. small integers, booleans, short strings and containers), located entirely within
+    // the input buffer.
+    if (tagBytes <= 1 && valOrLenBytes <= 1 && elemHeadBytes <= (mBufEnd - mReadPoint))
+    {
+        p = mReadPoint + 1;
+        mElemTag = (tagBytes != 0) ? ContextTag(p[0]) : AnonymousTag;
+        mElemLenOrVal = (valOrLenBytes != 0) ? p[tagBytes] : 0;
+        mReadPoint += elemHeadBytes;
+        mLenRead += elemHeadBytes;
+        return VerifyElement();
+    }
+
     // If the head of the element overlaps the end of the input buffer, read the bytes into the staging buffer
     // and arrange to parse them from there. Otherwise read them directly from the input buffer.
     if (elemHeadBytes > (mBufEnd - mReadPoint))
@@ -1340,21 +1489,21 @@ WEAVE_ERROR TLVReader::ReadElement()
     mElemTag = ReadTag(tagControl, p);
 
     // Read the length/value field, if present.
-    switch (lenOrValFieldSize)
+    switch (valOrLenBytes)
     {
-    case kTLVFieldSize_0Byte:
+    case 0:
         mElemLenOrVal = 0;
         break;
-    case kTLVFieldSize_1Byte:
+    case 1:
         mElemLenOrVal = Read8(p);
         break;
-    case kTLVFieldSize_2Byte:
+    case 2:
         mElemLenOrVal = LittleEndian::Read16(p);
         break;
-    case kTLVFieldSize_4Byte:
+    case 4:
         mElemLenOrVal = LittleEndian::Read32(p);
         break;
-    case kTLVFieldSize_8Byte:
+    case 8:
         mElemLenOrVal = LittleEndian::Read64(p);
         break;
     }
@@ -72,11 +72,49 @@
  *    destined for the Service when the connection to the Service
  *    is not yet established.
  *
+ *    This sizes the queue itself, independently of the number of
+ *    bytes it may hold (see #WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED),
+ *    and bounds the number of packet buffers held by the queue. It must
+ *    not exceed 255.
+ *
  */
 #ifndef WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
 #define WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED              (8)
 #endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
 
+#if WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED > 255
+#error "WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED must not exceed 255"
+#endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED > 255
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED
+ *
+ *  @brief
+ *    This defines the total size, in bytes, of the data packets
+ *    that may be queued for the Service while the connection to
+ *    the Service is not yet established.
+ *
+ *    When a packet does not fit, the oldest queued packets of bulk
+ *    IP traffic are dropped to make room for it. ICMPv6 and Weave
+ *    traffic is only dropped when no bulk traffic is left to drop.
+ *
+ *    Each queued packet carries the tunnel header ahead of the IP
+ *    packet. The default leaves room for four packets of the tunnel
+ *    interface MTU, so that a queue of small packets, such as ICMPv6
+ *    and Weave traffic, is limited by its depth and a queue of large
+ *    bulk packets by its size.
+ *
+ *    While the queue holds only ICMPv6 and Weave traffic and has no
+ *    room for another packet, reading from the tunnel interface is
+ *    paused. As the destination of a packet is not known until it is
+ *    read, this also holds back traffic for shortcut tunnels and the
+ *    local network until the queue drains.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED
+#define WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED                (4 * (WEAVE_CONFIG_TUNNEL_INTERFACE_MTU + TUN_HDR_SIZE_IN_BYTES))
+#endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED
+
 /**
  *  @def WEAVE_CONFIG_TUNNELING_MAX_NUM_SHORTCUT_TUNNEL_PEERS
  *
@@ -46,7 +46,13 @@ namespace Weave {
  *  @def WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD
  *
  *  @brief
- *    The default WRMP timer tick interval in milliseconds.
+ *    The default WRMP timer period in milliseconds, from which the
+ *    default acknowledgment timeout is derived.
+ *
+ *  @note
+ *    Retransmissions and solitary acknowledgments are scheduled at
+ *    their exact deadlines; this value no longer sets a tick at which
+ *    the WRMP timer runs.
  *
  */
 #ifndef WEAVE_CONFIG_WRMP_TIMER_DEFAULT_PERIOD
@@ -113,6 +119,47 @@ namespace Weave {
 #define WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS               (3)
 #endif // WEAVE_CONFIG_WRMP_DEFAULT_MAX_RETRANS
 
+/**
+ *  @def WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    If set to (1), the retransmission timeout for a peer node is
+ *    estimated from the round-trip times observed for the messages
+ *    acknowledged by that node (SRTT + 4 * RTTVAR, as in RFC 6298),
+ *    bounded by #WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT and by the
+ *    retransmission timeout configured for the exchange. Default
+ *    value is (0) or disabled.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+#define WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT          0
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT
+ *
+ *  @brief
+ *    The lower bound, in milliseconds, of an adaptive retransmission
+ *    timeout. It leaves room for the peer to hold back its
+ *    acknowledgment for up to the default acknowledgment timeout.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT
+#define WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT               (2 * WEAVE_CONFIG_WRMP_DEFAULT_ACK_TIMEOUT)
+#endif // WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT
+
+/**
+ *  @def WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE
+ *
+ *  @brief
+ *    The number of peer nodes for which a round-trip time estimate
+ *    is kept when #WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT is set.
+ *
+ */
+#ifndef WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE
+#define WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE               (8)
+#endif // WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE
+
 /**
  *  @brief
  *    The WRMP configuration.
@@ -64,6 +64,18 @@ enum
     kMsgType_BlockEOFV1 =                   0x12,
     kMsgType_BlockAckV1 =                   0x13,
     kMsgType_BlockEOFAckV1 =                0x14,
+    kMsgType_BlockSelectiveAckV1 =          0x15,
+};
+
+/*
+ * tags of the extension fields that SendInit, ReceiveInit and their
+ * accept messages carry as profile-tagged TLV elements after any
+ * metadata. legacy nodes treat them as part of the metadata and never
+ * echo them, so a missing extension means the peer does not support it.
+ */
+enum
+{
+    kTag_WindowSize =                       0x01,   // uint, number of blocks in flight
 };
 
 /*
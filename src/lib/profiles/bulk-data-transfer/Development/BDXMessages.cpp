@@ -26,6 +26,7 @@
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXMessages.h>
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Core/WeaveMessageLayer.h>
+#include <Weave/Core/WeaveTLV.h>
 #include <Weave/Profiles/ProfileCommon.h>
 #include <Weave/Support/CodeUtils.h>
 
@@ -38,6 +39,89 @@ using namespace ::nl::Weave::Profiles::StatusReporting;
 
 #define VERSION_MASK 0x0F
 
+// <control>+<fully-qualified profile tag>+<1 byte uint>
+#define WINDOW_SIZE_EXTENSION_LEN 8
+
+/*
+ * -- helpers for the window size extension field --
+ *
+ * the window size is appended after any metadata as a profile-tagged TLV
+ * element, and only when windowing is proposed so that stop-and-wait
+ * messages are unchanged on the wire. a legacy peer sees the element as
+ * part of the metadata, see WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE.
+ */
+static WEAVE_ERROR PackWindowSize(MessageIterator &i, uint8_t aWindowSize)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *buffer = i.GetBuffer();
+    uint16_t prevDataLength = buffer->DataLength();
+    TLV::TLVWriter writer;
+
+    VerifyOrExit(aWindowSize > 1, /* not proposed */);
+
+    writer.Init(buffer);
+
+    err = writer.Put(TLV::ProfileTag(kWeaveProfile_BDX, kTag_WindowSize), aWindowSize);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    i.thePoint += buffer->DataLength() - prevDataLength;
+
+exit:
+    return err;
+}
+
+static uint16_t WindowSizePackedLength(uint8_t aWindowSize)
+{
+    return (aWindowSize > 1) ? WINDOW_SIZE_EXTENSION_LEN : 0;
+}
+
+/*
+ * if the last TLV element of the parsed metadata is the window size
+ * extension, move it from the metadata into aWindowSize. otherwise the
+ * peer did not propose windowing and the window size is 1.
+ */
+static void ParseWindowSize(ReferencedTLVData &aMetaData, uint8_t &aWindowSize)
+{
+    WEAVE_ERROR err;
+    TLV::TLVReader reader;
+    uint32_t elemStart = 0;
+    uint32_t extStart = 0;
+    uint8_t windowSize = 1;
+    bool found = false;
+
+    aWindowSize = 1;
+
+    reader.Init(aMetaData.theData, aMetaData.theLength);
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        found = (reader.GetTag() == TLV::ProfileTag(kWeaveProfile_BDX, kTag_WindowSize) &&
+                 reader.Get(windowSize) == WEAVE_NO_ERROR);
+
+        err = reader.Skip();
+        SuccessOrExit(err);
+
+        extStart = elemStart;
+        elemStart = reader.GetLengthRead();
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV && found && windowSize > 0, /* not proposed */);
+
+    aWindowSize = windowSize;
+
+    aMetaData.theLength = extStart;
+    if (aMetaData.theLength == 0)
+    {
+        aMetaData.theData = NULL;
+    }
+
+exit:
+    return;
+}
+
 /*
  * -- definitions for SendInit and its supporting classes --
  *
@@ -58,6 +142,7 @@ SendInit::SendInit()
     , mLength(0)
     , mMetaDataWriteCallback(NULL)
     , mMetaDataAppState(NULL)
+    , mWindowSize(1)
 {
 }
 
@@ -310,6 +395,9 @@ WEAVE_ERROR SendInit::pack(PacketBuffer *aBuffer)
         mMetaData.pack(i);
     }
 
+    err = PackWindowSize(i, mWindowSize);
+    SuccessOrExit(err);
+
 exit:
     return err;
 }
@@ -355,7 +443,7 @@ uint16_t SendInit::GetWrittenMetaDataCallbackLength(void)
  */
 uint16_t SendInit::packedLength()
 {
-    // <xfer cctl>+<range ctl>+<max block>+<start offset (optional)>+<length (optional)>+<designator>+<metadata (optional)>
+    // <xfer cctl>+<range ctl>+<max block>+<start offset (optional)>+<length (optional)>+<designator>+<metadata (optional)>+<window size (optional)>
     uint16_t startOffsetLength = mStartOffsetPresent ? (mWideRange ? 8 : 4) : 0;
     uint16_t lengthLength = mDefiniteLength ? (mWideRange ? 8 : 4) : 0;
     uint16_t metaDataLength = 0;
@@ -369,7 +457,8 @@ uint16_t SendInit::packedLength()
         metaDataLength = mMetaData.packedLength();
     }
 
-    return 1 + 1 + 2 + startOffsetLength + lengthLength + (2 + mFileDesignator.theLength) + metaDataLength;
+    return 1 + 1 + 2 + startOffsetLength + lengthLength + (2 + mFileDesignator.theLength) + metaDataLength +
+        WindowSizePackedLength(mWindowSize);
 }
 
 /**
@@ -442,6 +531,7 @@ WEAVE_ERROR SendInit::parse(PacketBuffer *aBuffer, SendInit &aRequest)
     err = ReferencedString::parse(i, aRequest.mFileDesignator);
     SuccessOrExit(err);
     ReferencedTLVData::parse(i, aRequest.mMetaData);
+    ParseWindowSize(aRequest.mMetaData, aRequest.mWindowSize);
 
 exit:
     return err;
@@ -467,7 +557,8 @@ bool SendInit::operator == (const SendInit &another) const
             mMaxBlockSize == another.mMaxBlockSize &&
             mStartOffset == another.mStartOffset &&
             mFileDesignator == another.mFileDesignator &&
-            mMetaData == another.mMetaData);
+            mMetaData == another.mMetaData &&
+            mWindowSize == another.mWindowSize);
 }
 
 // -- definitions for SendAccept and its supporting classes --
@@ -479,6 +570,7 @@ SendAccept::SendAccept()
     : mVersion(0)
     , mTransferMode(kMode_SenderDrive)
     , mMaxBlockSize(0)
+    , mWindowSize(1)
 {
 }
 
@@ -539,6 +631,9 @@ WEAVE_ERROR SendAccept::pack(PacketBuffer *aBuffer)
 
     mMetaData.pack(i);
 
+    err = PackWindowSize(i, mWindowSize);
+    SuccessOrExit(err);
+
 exit:
     return err;
 }
@@ -551,8 +646,8 @@ exit:
  */
 uint16_t SendAccept::packedLength()
 {
-    // <transfer mode>+<max block size>+<meta data (optional)>
-    return 1 + 2 + mMetaData.packedLength();
+    // <transfer mode>+<max block size>+<meta data (optional)>+<window size (optional)>
+    return 1 + 2 + mMetaData.packedLength() + WindowSizePackedLength(mWindowSize);
 }
 
 /**
@@ -582,6 +677,7 @@ WEAVE_ERROR SendAccept::parse(PacketBuffer *aBuffer, SendAccept &aResponse)
     SuccessOrExit(err);
 
     ReferencedTLVData::parse(i, aResponse.mMetaData);
+    ParseWindowSize(aResponse.mMetaData, aResponse.mWindowSize);
 
 exit:
     return err;
@@ -600,7 +696,8 @@ bool SendAccept::operator == (const SendAccept &another) const
     return (mVersion == another.mVersion &&
             mTransferMode == another.mTransferMode &&
             mMaxBlockSize == another.mMaxBlockSize &&
-            mMetaData == another.mMetaData);
+            mMetaData == another.mMetaData &&
+            mWindowSize == another.mWindowSize);
 }
 
 // -- definitions for ReceiveInit and its supporting classes --
@@ -740,6 +837,9 @@ WEAVE_ERROR ReceiveAccept::pack(PacketBuffer *aBuffer)
 
     mMetaData.pack(i);
 
+    err = PackWindowSize(i, mWindowSize);
+    SuccessOrExit(err);
+
 exit:
     return err;
 }
@@ -752,8 +852,9 @@ exit:
  */
 uint16_t ReceiveAccept::packedLength()
 {
-    // <transfer mode>+<range control>+<max block size>+<length (optional)>+<meta data (optional)>
-    return 1 + 1 + 2 + (mDefiniteLength ? (mWideRange ? 8 : 4) : 0) + mMetaData.packedLength();
+    // <transfer mode>+<range control>+<max block size>+<length (optional)>+<meta data (optional)>+<window size (optional)>
+    return 1 + 1 + 2 + (mDefiniteLength ? (mWideRange ? 8 : 4) : 0) + mMetaData.packedLength() +
+        WindowSizePackedLength(mWindowSize);
 }
 
 /**
@@ -807,6 +908,7 @@ WEAVE_ERROR ReceiveAccept::parse(PacketBuffer *aBuffer, ReceiveAccept &aResponse
     }
 
     ReferencedTLVData::parse(i, aResponse.mMetaData);
+    ParseWindowSize(aResponse.mMetaData, aResponse.mWindowSize);
 
 exit:
     return err;
@@ -827,7 +929,8 @@ bool ReceiveAccept::operator == (const ReceiveAccept &another) const
             mWideRange == another.mWideRange &&
             mMaxBlockSize == another.mMaxBlockSize &&
             mLength == another.mLength &&
-            mMetaData == another.mMetaData);
+            mMetaData == another.mMetaData &&
+            mWindowSize == another.mWindowSize);
 }
 
 // -- definitions for BlockQuery and its supporting classes --
@@ -1212,6 +1315,108 @@ bool BlockSendV1::operator == (const BlockSendV1 &another) const
             memcmp(mData, another.mData, mLength) == 0);
 }
 
+// -- definitions for BlockSelectiveAckV1 and its supporting classes --
+
+/**
+ * The no-arg constructor with defaults for the block selective ack message.
+ */
+BlockSelectiveAckV1::BlockSelectiveAckV1()
+    : mBlockCounter(0)
+    , mReceivedMask(0)
+{
+}
+
+/**
+ * @brief
+ *  Initialize a BlockSelectiveAckV1 message
+ *
+ * @param[in]   aCounter        Counter of the first block not yet received
+ * @param[in]   aReceivedMask   Bit n set if block aCounter + 1 + n was received
+ *
+ * @return #WEAVE_NO_ERROR if successful
+ */
+WEAVE_ERROR BlockSelectiveAckV1::init(uint32_t aCounter, uint32_t aReceivedMask)
+{
+    mBlockCounter = aCounter;
+    mReceivedMask = aReceivedMask;
+
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ * @brief
+ *  Pack a block selective ack message into an PacketBuffer
+ *
+ * @param[out]  aBuffer         An PacketBuffer to pack the BlockSelectiveAckV1 message in
+ *
+ * @retval  #WEAVE_NO_ERROR                 If successful
+ * @retval  #WEAVE_ERROR_BUFFER_TOO_SMALL   If buffer is too small
+ */
+WEAVE_ERROR BlockSelectiveAckV1::pack(PacketBuffer *aBuffer)
+{
+    MessageIterator i(aBuffer);
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    i.append();
+    err = i.write32(mBlockCounter);
+    SuccessOrExit(err);
+
+    err = i.write32(mReceivedMask);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  Returns the packed length of this block selective ack message
+ *
+ * @return length of the message when packed
+ */
+uint16_t BlockSelectiveAckV1::packedLength()
+{
+    // <block counter>+<received mask>
+    return sizeof(mBlockCounter) + sizeof(mReceivedMask);
+}
+
+/**
+ * @brief
+ *  Parse data from an PacketBuffer into a BlockSelectiveAckV1 message format
+ *
+ * @param[in]   aBuffer     Pointer to an PacketBuffer which has the data we want to parse out
+ * @param[out]  aAck        Pointer to a BlockSelectiveAckV1 object where we should store the results
+ *
+ * @retval  #WEAVE_NO_ERROR                 If successful
+ * @retval  #WEAVE_ERROR_BUFFER_TOO_SMALL   If buffer is too small
+ */
+WEAVE_ERROR BlockSelectiveAckV1::parse(PacketBuffer *aBuffer, BlockSelectiveAckV1 &aAck)
+{
+    MessageIterator i(aBuffer);
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    err = i.read32(&aAck.mBlockCounter);
+    SuccessOrExit(err);
+
+    err = i.read32(&aAck.mReceivedMask);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  Equality comparison between BlockSelectiveAckV1 messages
+ *
+ * @param[in]   another     Another BlockSelectiveAckV1 message to compare this one to
+ *
+ * @return true iff they have all the same fields.
+ */
+bool BlockSelectiveAckV1::operator == (const BlockSelectiveAckV1 &another) const
+{
+    return (mBlockCounter == another.mBlockCounter &&
+            mReceivedMask == another.mReceivedMask);
+}
+
 } // namespace BulkDataTransfer
 } // namespace Profiles
 } // namespace Weave
@@ -154,6 +154,8 @@ public:
     ReferencedTLVData mMetaData;        /**< Optional TLV Metadata. */
     MetaDataTLVWriteCallback mMetaDataWriteCallback; /**< Optional function to write out TLV Metadata. */
     void *mMetaDataAppState;            /**< Optional app state for TLV Metadata. */
+    // Extension fields
+    uint8_t mWindowSize;                /**< Proposed number of blocks in flight, 1 for stop-and-wait. */
 };
 
 /**
@@ -181,6 +183,7 @@ public:
     uint8_t mTransferMode;          /**< Transfer mode that we decided on. */
     uint16_t mMaxBlockSize;         /**< Maximum block size we decided on. */
     ReferencedTLVData mMetaData;    /**< Optional TLV Metadata. */
+    uint8_t mWindowSize;            /**< Number of blocks in flight we decided on, 1 for stop-and-wait. */
 };
 
 /**
@@ -421,6 +424,38 @@ class BlockAckV1 : public BlockQueryV1 { };
  */
 class BlockEOFAckV1 : public BlockQueryV1 { };
 
+/**
+ * @class BlockSelectiveAckV1
+ *
+ * @brief
+ *   The BlockSelectiveAckV1 message is used by the receiver of a windowed
+ *   transfer to acknowledge every block before a 4 byte block counter,
+ *   and which of the blocks that follow it have already been received.
+ */
+class NL_DLL_EXPORT BlockSelectiveAckV1
+{
+public:
+    BlockSelectiveAckV1(void);
+
+    WEAVE_ERROR init(uint32_t aCounter, uint32_t aReceivedMask);
+
+    WEAVE_ERROR pack(PacketBuffer *aBuffer);
+    uint16_t packedLength(void);
+    static WEAVE_ERROR parse(PacketBuffer *aBuffer, BlockSelectiveAckV1 &aAck);
+
+    // BlockSelectiveAckV1 payload length
+    enum
+    {
+        kPayloadLen = 8,
+    };
+
+public:
+    bool operator == (const BlockSelectiveAckV1&) const;
+
+    uint32_t mBlockCounter;     /**< Counter of the first block that has not been received. */
+    uint32_t mReceivedMask;     /**< Bit n set if block mBlockCounter + 1 + n has been received. */
+};
+
 } // namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development)
 } // namespace Profiles
 } // namespace Weave
@@ -747,6 +747,8 @@ void BdxNode::HandleReceiveInit(ExchangeContext *anEc, const IPPacketInfo *aPktI
     // TODO: validate max block size?  anything else?
     WeaveLogDetail(BDX, "HandleReceiveInit validated request\n");
 
+    xfer->NegotiateWindowSize(receiveInit.mWindowSize);
+
     err = SendReceiveAccept(anEc, xfer);
     VerifyOrExit(err == WEAVE_NO_ERROR, statusCode = kStatus_FailureToSend);
 
@@ -885,6 +887,8 @@ void BdxNode::HandleSendInit(ExchangeContext *anEc, const IPPacketInfo *aPktInfo
 
     WeaveLogDetail(BDX, "HandleSendInit validated request\n");
 
+    xfer->NegotiateWindowSize(sendInit.mWindowSize);
+
     err = SendSendAccept(anEc, xfer);
     VerifyOrExit(err == WEAVE_NO_ERROR, statusCode = kStatus_FailureToSend);
 
@@ -1006,6 +1010,8 @@ WEAVE_ERROR BdxNode::SendReceiveAccept(ExchangeContext *anEc, BDXTransfer *aXfer
     VerifyOrExit(err == WEAVE_NO_ERROR,
                  WeaveLogDetail(BDX, "SendReceiveAccept error calling Init on receiveAccept: %d", err));
 
+    receiveAccept.mWindowSize = aXfer->mWindowSize;
+
     payload = PacketBuffer::New();
     VerifyOrExit(payload != NULL,
                  err = WEAVE_ERROR_NO_MEMORY;
@@ -1031,7 +1037,7 @@ WEAVE_ERROR BdxNode::SendReceiveAccept(ExchangeContext *anEc, BDXTransfer *aXfer
         WeaveLogDetail(BDX, "ReceiveAccept sent: Am driving so sending first block");
         if (aXfer->mVersion == 1)
         {
-            err = BdxProtocol::SendNextBlockV1(*aXfer);
+            err = aXfer->IsWindowed() ? BdxProtocol::SendWindowV1(*aXfer) : BdxProtocol::SendNextBlockV1(*aXfer);
         }
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
         else if (aXfer->mVersion == 0)
@@ -1072,6 +1078,8 @@ WEAVE_ERROR BdxNode::SendSendAccept(ExchangeContext *anEc, BDXTransfer *aXfer)
     VerifyOrExit(err == WEAVE_NO_ERROR,
                  WeaveLogDetail(BDX, "SendSendAccept error calling Init on sendAccept: %d", err));
 
+    sendAccept.mWindowSize = aXfer->mWindowSize;
+
     payload = PacketBuffer::New();
     VerifyOrExit(payload != NULL,
                  err = WEAVE_ERROR_NO_MEMORY;
@@ -78,6 +78,8 @@ WEAVE_ERROR InitBdxReceive(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+    msg.mWindowSize = aXfer.mWindowSize;
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -134,6 +136,8 @@ WEAVE_ERROR InitBdxSend(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+    msg.mWindowSize = aXfer.mWindowSize;
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -190,6 +194,8 @@ WEAVE_ERROR InitBdxSend(BDXTransfer &aXfer, bool aICanDrive, bool aUCanDrive,
         SuccessOrExit(err);
     }
 
+    msg.mWindowSize = aXfer.mWindowSize;
+
     err = msg.pack(buffer);
     SuccessOrExit(err);
 
@@ -461,6 +467,43 @@ exit:
     return err;
 }
 
+/**
+ * @brief
+ *  This function sends a BlockSelectiveAckV1 message for the given windowed BDXTransfer.
+ *  The acknowledged block number is equal to aXfer.mBlockCounter, the first block not yet
+ *  received, and the blocks received ahead of it are reported from aXfer.mWindowReceivedMask.
+ *
+ * @param[in]       aXfer       The BDXTransfer we're sending a BlockSelectiveAckV1 for.
+ *
+ * @retval          #WEAVE_NO_ERROR         If we successfully sent the message.
+ * @retval          #WEAVE_ERROR_NO_MEMORY  If no available PacketBuffers.
+ */
+static WEAVE_ERROR SendBlockSelectiveAckV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR             err     = WEAVE_NO_ERROR;
+    PacketBuffer*           buffer  = PacketBuffer::NewWithAvailableSize(BlockSelectiveAckV1::kPayloadLen);
+    BlockSelectiveAckV1     outMsg;
+    uint16_t                flags;
+
+    VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    SuccessOrExit(err = outMsg.init(aXfer.mBlockCounter, aXfer.mWindowReceivedMask));
+    SuccessOrExit(err = outMsg.pack(buffer));
+
+    flags = aXfer.GetDefaultFlags(false);
+
+    err = aXfer.mExchangeContext->SendMessage(kWeaveProfile_BDX, kMsgType_BlockSelectiveAckV1, buffer, flags);
+    buffer = NULL;
+
+exit:
+    if (buffer != NULL)
+    {
+        PacketBuffer::Free(buffer);
+    }
+
+    return err;
+}
+
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
 /**
  * @brief
@@ -554,27 +597,25 @@ exit:
 
 /**
  * @brief
- *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
+ *  This function fills a new PacketBuffer with the block counter and the
+ *  data of the next block, retrieved by calling the BDXTransfer's
  *  GetBlockHandler.
  *
- * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
- *                          next block before sending it using the associated ExchangeContext
+ * @param[in]       aXfer       The BDXTransfer whose GetBlockHandler is called to get the
+ *                              block aXfer.mBlockCounter
+ * @param[out]      aBuffer     The PacketBuffer holding the BlockSendV1 payload
+ * @param[out]      aIsLast     True if the block should be sent as a BlockEOFV1
  *
  * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
  */
-WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+static WEAVE_ERROR GetNextBlockV1(BDXTransfer &aXfer, PacketBuffer *&aBuffer, bool &aIsLast)
 {
     WEAVE_ERROR     err         = WEAVE_NO_ERROR;
     uint64_t        length;
     uint8_t*        data;
-    bool            isLast;
-    uint8_t         msgType;
     PacketBuffer*   buffer      = PacketBuffer::New();
-    uint16_t        flags;
     uint32_t        blockCounter;
 
-    WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mBlockCounter);
-
     VerifyOrExit(aXfer.mHandlers.mGetBlockHandler != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
 
     VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
@@ -595,7 +636,7 @@ WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
         length = aXfer.mMaxBlockSize;
     }
 
-    aXfer.DispatchGetBlockHandler(&length, &data, &isLast);
+    aXfer.DispatchGetBlockHandler(&length, &data, &aIsLast);
 
     // Ensure that we can fit the buffer within the PacketBuffer, fail
     // if we cannot.
@@ -612,6 +653,41 @@ WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
 
     buffer->SetDataLength(length + sizeof(aXfer.mBlockCounter));
 
+    aBuffer = buffer;
+    buffer = NULL;
+
+exit:
+    if (buffer != NULL)
+    {
+        PacketBuffer::Free(buffer);
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
+ *  GetBlockHandler.
+ *
+ * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
+ *                          next block before sending it using the associated ExchangeContext
+ *
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    bool            isLast;
+    uint8_t         msgType;
+    PacketBuffer*   buffer      = NULL;
+    uint16_t        flags;
+
+    WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mBlockCounter);
+
+    err = GetNextBlockV1(aXfer, buffer, isLast);
+    SuccessOrExit(err);
+
     if (isLast)
     {
         msgType = kMsgType_BlockEOFV1;
@@ -637,6 +713,171 @@ exit:
     return err;
 }
 
+/**
+ * @brief
+ *  This function sends a copy of a block held in the window of a windowed
+ *  transfer, keeping the block itself for retransmission.
+ *
+ * @param[in]       aXfer       The BDXTransfer we're sending a block for.
+ * @param[in]       aCounter    Counter of the block, between aXfer.mWindowBase and
+ *                              aXfer.mBlockCounter
+ *
+ * @retval          #WEAVE_NO_ERROR         If we successfully sent the message.
+ * @retval          #WEAVE_ERROR_NO_MEMORY  If no available PacketBuffers.
+ */
+static WEAVE_ERROR SendWindowBlockV1(BDXTransfer &aXfer, uint32_t aCounter)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    PacketBuffer*   block   = aXfer.mWindowBlocks[aCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE];
+    PacketBuffer*   buffer  = PacketBuffer::NewWithAvailableSize(block->DataLength());
+    uint8_t         msgType;
+    uint16_t        flags;
+
+    VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    // The message layer encodes and encrypts the message in place, so send a copy.
+
+    memcpy(buffer->Start(), block->Start(), block->DataLength());
+    buffer->SetDataLength(block->DataLength());
+
+    if (aXfer.mWindowEOF && aCounter == aXfer.mWindowEOFCounter)
+    {
+        msgType = kMsgType_BlockEOFV1;
+    }
+    else
+    {
+        msgType = kMsgType_BlockSendV1;
+    }
+
+    // Only one message of an exchange may await a response, so the blocks of
+    // a window are sent without and the window timer covers their loss.
+    flags = aXfer.GetDefaultFlags(false);
+
+    err = aXfer.mExchangeContext->SendMessage(kWeaveProfile_BDX, msgType, buffer, flags);
+    buffer = NULL;
+
+exit:
+    if (buffer != NULL)
+    {
+        PacketBuffer::Free(buffer);
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *  This function (re)starts the retransmission timer of a windowed transfer
+ *  while blocks are awaiting acknowledgement, using the response timeout of
+ *  its ExchangeContext, and stops it otherwise.
+ *
+ * @param[in]       aXfer       The windowed BDXTransfer
+ */
+static void StartWindowTimer(BDXTransfer &aXfer)
+{
+    ExchangeContext *ec = aXfer.mExchangeContext;
+    System::Layer *systemLayer = ec->ExchangeMgr->MessageLayer->SystemLayer;
+
+    if (ec->ResponseTimeout > 0 && aXfer.mBlockCounter != aXfer.mWindowBase)
+    {
+        systemLayer->StartTimer(ec->ResponseTimeout, HandleWindowTimeout, &aXfer);
+    }
+    else
+    {
+        systemLayer->CancelTimer(HandleWindowTimeout, &aXfer);
+    }
+}
+
+/**
+ * @brief
+ *  This function retransmits the blocks of a windowed transfer, from the
+ *  oldest unacknowledged one up to aEnd, that the receiver has not reported
+ *  as received and that were not already retransmitted since the window
+ *  last moved.
+ *
+ * @param[in]       aXfer       The BDXTransfer we're retransmitting blocks for.
+ * @param[in]       aEnd        Counter of the block after the last one to retransmit
+ */
+static WEAVE_ERROR ResendWindowBlocksV1(BDXTransfer &aXfer, uint32_t aEnd)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    uint32_t        counter = (aXfer.mWindowResendEnd > aXfer.mWindowBase) ? aXfer.mWindowResendEnd : aXfer.mWindowBase;
+
+    for (; counter < aEnd; counter++)
+    {
+        if (counter == aXfer.mWindowBase || (aXfer.mWindowReceivedMask & (1UL << (counter - aXfer.mWindowBase - 1))) == 0)
+        {
+            WeaveLogDetail(BDX, "Resending block # %d\n", counter);
+
+            err = SendWindowBlockV1(aXfer, counter);
+            SuccessOrExit(err);
+        }
+
+        aXfer.mWindowResendEnd = counter + 1;
+    }
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *  This function drives the sending side of a windowed transfer.  It first
+ *  retransmits the blocks that the receiver reported missing ahead of blocks
+ *  it did receive, then sends new blocks retrieved by calling the
+ *  BDXTransfer's GetBlockHandler until aXfer.mWindowSize blocks are awaiting
+ *  acknowledgement or the BlockEOFV1 has been sent.
+ *
+ * @param[in]       aXfer   The BDXTransfer whose window is to be filled
+ *
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendWindowV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    PacketBuffer*   buffer      = NULL;
+    uint32_t        receivedEnd = aXfer.mWindowBase;
+    bool            isLast;
+
+    for (uint32_t n = 0; n < 32; n++)
+    {
+        if (aXfer.mWindowReceivedMask & (1UL << n))
+        {
+            receivedEnd = aXfer.mWindowBase + 1 + n;
+        }
+    }
+
+    err = ResendWindowBlocksV1(aXfer, receivedEnd);
+    SuccessOrExit(err);
+
+    while (!aXfer.mWindowEOF && aXfer.mBlockCounter - aXfer.mWindowBase < aXfer.mWindowSize)
+    {
+        WeaveLogDetail(BDX, "Sending next block # %d\n", aXfer.mBlockCounter);
+
+        err = GetNextBlockV1(aXfer, buffer, isLast);
+        SuccessOrExit(err);
+
+        aXfer.mWindowBlocks[aXfer.mBlockCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] = buffer;
+        buffer = NULL;
+
+        if (isLast)
+        {
+            aXfer.mWindowEOF = true;
+            aXfer.mWindowEOFCounter = aXfer.mBlockCounter;
+        }
+
+        aXfer.mBlockCounter++;
+
+        err = SendWindowBlockV1(aXfer, aXfer.mBlockCounter - 1);
+        SuccessOrExit(err);
+    }
+
+    StartWindowTimer(aXfer);
+
+exit:
+    return err;
+}
+
 /**
  * @brief
  *  The main handler for messages arriving on the BDX exchange.  It essentially
@@ -741,6 +982,42 @@ void HandleResponseTimeout(ExchangeContext *anEc)
     xfer->DispatchErrorHandler(WEAVE_ERROR_TIMEOUT);
 }
 
+/**
+ * @brief
+ *  Handler for when a windowed transfer made no progress within the response timeout.
+ *  Retransmits the unacknowledged blocks that were not reported received, up to
+ *  #WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES times, then calls the transfer's error handler.
+ *
+ * @param[in]   aSystemLayer    Unused, but need to match the function prototype
+ * @param[in]   aAppState       The BDXTransfer whose window timed out
+ * @param[in]   aError          Unused, but need to match the function prototype
+ */
+void HandleWindowTimeout(System::Layer *aSystemLayer, void *aAppState, System::Error aError)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    BDXTransfer *xfer = static_cast<BDXTransfer *>(aAppState);
+
+    VerifyOrExit(xfer->mIsInitiated && xfer->mBlockCounter != xfer->mWindowBase, err = WEAVE_NO_ERROR);
+    VerifyOrExit(xfer->mWindowRetries < WEAVE_CONFIG_BDX_WINDOW_MAX_RETRIES, err = WEAVE_ERROR_TIMEOUT;
+                 WeaveLogDetail(BDX, "Window timed out waiting for block # %d", xfer->mWindowBase));
+
+    WeaveLogDetail(BDX, "Window timed out, resending from block # %d", xfer->mWindowBase);
+
+    xfer->mWindowRetries++;
+    xfer->mWindowResendEnd = xfer->mWindowBase;
+
+    err = ResendWindowBlocksV1(*xfer, xfer->mBlockCounter);
+    SuccessOrExit(err);
+
+    StartWindowTimer(*xfer);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        xfer->DispatchErrorHandler(err);
+    }
+}
+
 /**
  * @brief
  *  Handler for when the key used to encrypt and authenticate Weave messages is no longer usable.
@@ -944,6 +1221,48 @@ WEAVE_ERROR HandleResponseTransmit(BDXTransfer &aXfer, uint32_t aProfileId, uint
 
                 break;
 
+            case kMsgType_BlockSelectiveAckV1:
+                {
+                    BlockSelectiveAckV1 sackV1;
+                    uint32_t inFlight;
+
+                    VerifyOrExit(aXfer.IsWindowed(), err = WEAVE_NO_ERROR);
+
+                    err = BlockSelectiveAckV1::parse(aPacketBuffer, sackV1);
+                    VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "BlockSelectiveAckV1 parse failed."));
+
+                    rcvdCounter = sackV1.mBlockCounter;
+
+                    if (rcvdCounter < aXfer.mWindowBase)
+                    {
+                        // A stale acknowledgement overtaken by a later one
+                        WeaveLogDetail(BDX, "Received stale block counter: %d, expected: %d", rcvdCounter, aXfer.mWindowBase);
+                    }
+                    else if (rcvdCounter > aXfer.mBlockCounter)
+                    {
+                        WeaveLogDetail(BDX, "Received bad block counter: %d, expected at most: %d", rcvdCounter, aXfer.mBlockCounter);
+                        aXfer.mNext = SendBadBlockCounterStatusReport;
+                    }
+                    else
+                    {
+                        // Slide the window past the blocks received in order
+                        for (; aXfer.mWindowBase < rcvdCounter; aXfer.mWindowBase++)
+                        {
+                            PacketBuffer::Free(aXfer.mWindowBlocks[aXfer.mWindowBase % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE]);
+                            aXfer.mWindowBlocks[aXfer.mWindowBase % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] = NULL;
+                            aXfer.mWindowRetries = 0;
+                        }
+
+                        // Only blocks that were sent can have been received
+                        inFlight = aXfer.mBlockCounter - aXfer.mWindowBase;
+                        aXfer.mWindowReceivedMask = (inFlight > 1) ? (sackV1.mReceivedMask & ((1UL << (inFlight - 1)) - 1)) : 0;
+
+                        aXfer.mNext = SendWindowV1;
+                    }
+                }
+
+                break;
+
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
             case kMsgType_BlockQuery:
                 {
@@ -1046,8 +1365,10 @@ WEAVE_ERROR HandleResponseTransmit(BDXTransfer &aXfer, uint32_t aProfileId, uint
 
                     rcvdCounter = EOFAckV1.mBlockCounter;
 
-                    if (rcvdCounter == aXfer.mBlockCounter)
+                    if (aXfer.IsWindowed() ? (aXfer.mWindowEOF && rcvdCounter == aXfer.mWindowEOFCounter) :
+                                             (rcvdCounter == aXfer.mBlockCounter))
                     {
+                        aXfer.ReleaseWindowBlocks();
                         aXfer.mIsCompletedSuccessfully = true;
                         aXfer.DispatchXferDoneHandler();
                         aXfer.mFirstQuery = true;
@@ -1092,6 +1413,108 @@ exit:
 #endif // WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT
 
 #if WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT
+/**
+ * @brief
+ *  Handles a BlockSendV1 or BlockEOFV1 of a windowed transfer.  Blocks received ahead of
+ *  a missing one are held until it arrives, then handed to the PutBlockHandler in order.
+ *
+ * @param[in]   aXfer           The windowed BDXTransfer receiving the block
+ * @param[in]   aPacketBuffer   The BlockSendV1 or BlockEOFV1 message
+ * @param[in]   aIsEOF          True if the message is a BlockEOFV1
+ *
+ * @return an error value
+ */
+static WEAVE_ERROR ReceiveWindowBlockV1(BDXTransfer &aXfer, PacketBuffer *aPacketBuffer, bool aIsEOF)
+{
+    WEAVE_ERROR     err     = WEAVE_NO_ERROR;
+    BlockSendV1     block;
+    uint32_t        rcvdCounter;
+    uint32_t        offset;
+    PacketBuffer*   held    = NULL;
+    bool            isLast;
+
+    err = BlockSendV1::parse(aPacketBuffer, block);
+    VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "BlockSendV1 parse failed."));
+
+    rcvdCounter = block.mBlockCounter;
+
+    if (rcvdCounter < aXfer.mBlockCounter)
+    {
+        // A retransmission of a block we already have; our acknowledgement was lost.
+        WeaveLogDetail(BDX, "Received duplicate block counter: %d, expected: %d", rcvdCounter, aXfer.mBlockCounter);
+        ExitNow(aXfer.mNext = SendBlockSelectiveAckV1);
+    }
+
+    offset = rcvdCounter - aXfer.mBlockCounter;
+
+    if (offset >= aXfer.mWindowSize || (aXfer.mWindowEOF && rcvdCounter > aXfer.mWindowEOFCounter))
+    {
+        WeaveLogDetail(BDX, "Received bad block counter: %d, expected: %d", rcvdCounter, aXfer.mBlockCounter);
+        ExitNow(aXfer.mNext = SendBadBlockCounterStatusReport);
+    }
+
+    if (aIsEOF)
+    {
+        aXfer.mWindowEOF = true;
+        aXfer.mWindowEOFCounter = rcvdCounter;
+    }
+
+    if (offset > 0)
+    {
+        // Hold the block until the ones before it arrive
+        if (aXfer.mWindowBlocks[rcvdCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] == NULL)
+        {
+            aPacketBuffer->AddRef();
+            aXfer.mWindowBlocks[rcvdCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] = aPacketBuffer;
+            aXfer.mWindowReceivedMask |= 1UL << (offset - 1);
+        }
+
+        ExitNow(aXfer.mNext = SendBlockSelectiveAckV1);
+    }
+
+    while (true)
+    {
+        isLast = aXfer.mWindowEOF && aXfer.mBlockCounter == aXfer.mWindowEOFCounter;
+
+        aXfer.DispatchPutBlockHandler(block.mLength, block.mData, isLast);
+
+        // The block's data points into the held buffer, so it is only released once handed over
+        PacketBuffer::Free(held);
+        held = NULL;
+
+        // The application may have shut the transfer down
+        VerifyOrExit(aXfer.mIsInitiated, err = WEAVE_NO_ERROR);
+
+        if (isLast)
+        {
+            ExitNow(aXfer.mNext = SendBlockEOFAckV1);
+        }
+
+        aXfer.mBlockCounter++;
+
+        if ((aXfer.mWindowReceivedMask & 1) == 0)
+        {
+            aXfer.mWindowReceivedMask >>= 1;
+            break;
+        }
+
+        aXfer.mWindowReceivedMask >>= 1;
+
+        held = aXfer.mWindowBlocks[aXfer.mBlockCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE];
+        aXfer.mWindowBlocks[aXfer.mBlockCounter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] = NULL;
+
+        err = BlockSendV1::parse(held, block);
+        SuccessOrExit(err);
+    }
+
+    aXfer.mNext = SendBlockSelectiveAckV1;
+
+exit:
+    PacketBuffer::Free(held);
+
+    return err;
+}
+
 /*
  * otherwise, I'm the receiver. I should expect to get
  * a block here and then, If I'm driving, send out a
@@ -1135,6 +1558,11 @@ WEAVE_ERROR HandleResponseReceive(BDXTransfer &aXfer, uint32_t aProfileId, uint8
 #endif // WEAVE_CONFIG_BDX_V0_SUPPORT
 
             case kMsgType_BlockSendV1:
+                if (aXfer.IsWindowed())
+                {
+                    err = ReceiveWindowBlockV1(aXfer, aPacketBuffer, false);
+                }
+                else
                 {
                     BlockSendV1 blockSendV1;
                     err = BlockSendV1::parse(aPacketBuffer, blockSendV1);
@@ -1193,6 +1621,11 @@ WEAVE_ERROR HandleResponseReceive(BDXTransfer &aXfer, uint32_t aProfileId, uint8
 #endif // WEAVE_CONFIG_BDX_V0_SUPPORT
 
             case kMsgType_BlockEOFV1:
+                if (aXfer.IsWindowed())
+                {
+                    err = ReceiveWindowBlockV1(aXfer, aPacketBuffer, true);
+                }
+                else
                 {
                     BlockEOFV1 blockEOFV1;
                     err = BlockEOFV1::parse(aPacketBuffer, blockEOFV1);
@@ -1306,6 +1739,7 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                     aXfer.mMaxBlockSize = inMsg.mMaxBlockSize;
                     aXfer.mTransferMode = inMsg.mTransferMode;
                     aXfer.mVersion = inMsg.mVersion;
+                    aXfer.NegotiateWindowSize(inMsg.mWindowSize);
                     err = aXfer.DispatchSendAccept(&inMsg);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "DispatchSendAccept failed."));
 
@@ -1318,9 +1752,9 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                             VerifyOrExit(aXfer.mVersion < 2, err = WEAVE_ERROR_UNSUPPORTED_MESSAGE_VERSION);
 
 #if WEAVE_CONFIG_BDX_V0_SUPPORT
-                            aXfer.mNext = aXfer.mVersion == 1 ? SendNextBlockV1 : SendNextBlock;
+                            aXfer.mNext = aXfer.mVersion == 1 ? (aXfer.IsWindowed() ? SendWindowV1 : SendNextBlockV1) : SendNextBlock;
 #else
-                            aXfer.mNext = aXfer.mVersion == 1 ? SendNextBlockV1 : NULL;
+                            aXfer.mNext = aXfer.mVersion == 1 ? (aXfer.IsWindowed() ? SendWindowV1 : SendNextBlockV1) : NULL;
 #endif // WEAVE_CONFIG_BDX_V0_SUPPORT
                             break;
 
@@ -1380,6 +1814,7 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                     aXfer.mMaxBlockSize = inMsg.mMaxBlockSize;
                     aXfer.mTransferMode = inMsg.mTransferMode;
                     aXfer.mVersion = inMsg.mVersion;
+                    aXfer.NegotiateWindowSize(inMsg.mWindowSize);
                     aXfer.mLength = inMsg.mLength;
                     err = aXfer.DispatchReceiveAccept(&inMsg);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "DispatchReceiveAccept failed."));
@@ -66,6 +66,8 @@ WEAVE_ERROR SendNextBlock(BDXTransfer &aXfer);
 
 WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer);
 
+WEAVE_ERROR SendWindowV1(BDXTransfer &aXfer);
+
 // The following handlers are stateless callbacks meant to be passed to the
 // ExchangeContext in order to handle incoming BDX messages.
 // They handle the actual BDX protocol interaction and defer to the previously
@@ -78,6 +80,8 @@ void HandleConnectionClosed(ExchangeContext *anEc, WeaveConnection *aCon, WEAVE_
 
 void HandleResponseTimeout(ExchangeContext *anEc);
 
+void HandleWindowTimeout(System::Layer *aSystemLayer, void *aAppState, System::Error aError);
+
 void HandleKeyError(ExchangeContext *anEc, WEAVE_ERROR aKeyErr);
 
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
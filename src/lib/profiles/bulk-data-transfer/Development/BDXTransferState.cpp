@@ -25,6 +25,7 @@
 #include <Weave/Support/logging/WeaveLogging.h>
 
 #include <Weave/Profiles/bulk-data-transfer/Development/BDXTransferState.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXProtocol.h>
 
 namespace nl {
 namespace Weave {
@@ -53,6 +54,8 @@ using namespace nl::Weave::Logging;
  */
 void BDXTransfer::Shutdown(void)
 {
+    ReleaseWindowBlocks();
+
     if (mExchangeContext != NULL)
     {
         if (mIsCompletedSuccessfully)
@@ -86,6 +89,14 @@ void BDXTransfer::Reset(void)
     mIsWideRange                    = false;
     mIsCompletedSuccessfully        = false;
     mAmInitiator                    = false;
+    mWindowSize                     = WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE;
+    mWindowEOF                      = false;
+    mWindowRetries                  = 0;
+    mWindowBase                     = 0;
+    mWindowEOFCounter               = 0;
+    mWindowReceivedMask             = 0;
+    mWindowResendEnd                = 0;
+    memset(mWindowBlocks, 0, sizeof(mWindowBlocks));
 
     mHandlers.mSendAcceptHandler    = NULL;
     mHandlers.mReceiveAcceptHandler = NULL;
@@ -123,6 +134,68 @@ bool BDXTransfer::IsDriver(void)
             (!mAmSender && (mTransferMode & kMode_ReceiverDrive)));
 }
 
+/**
+ * @brief
+ *      Returns true if this transfer keeps more than one block in flight, false otherwise.
+ *
+ * @return true iff the transfer is windowed.
+ */
+bool BDXTransfer::IsWindowed(void)
+{
+    return mWindowSize > 1;
+}
+
+/**
+ * @brief
+ *      Settles the window size of this transfer once its version and transfer
+ *      mode are known.
+ *
+ *  The window size is the smallest of the local one and the one proposed or
+ *  accepted by the peer, which is 1 for peers that do not support windowed
+ *  transfers.  Only sender drive V1 transfers are windowed.
+ *
+ * @param[in]   aPeerWindowSize     Window size carried in the peer's init or accept message
+ */
+void BDXTransfer::NegotiateWindowSize(uint8_t aPeerWindowSize)
+{
+    if (mWindowSize > WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE)
+    {
+        mWindowSize = WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE;
+    }
+
+    if (aPeerWindowSize < mWindowSize)
+    {
+        mWindowSize = aPeerWindowSize;
+    }
+
+    if (mWindowSize == 0 || mVersion != 1 || mTransferMode != kMode_SenderDrive)
+    {
+        mWindowSize = 1;
+    }
+}
+
+/**
+ * @brief
+ *      Frees the blocks held for retransmission or reordering and stops
+ *      the retransmission timer.
+ */
+void BDXTransfer::ReleaseWindowBlocks(void)
+{
+    if (mExchangeContext != NULL)
+    {
+        mExchangeContext->ExchangeMgr->MessageLayer->SystemLayer->CancelTimer(BdxProtocol::HandleWindowTimeout, this);
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE; i++)
+    {
+        if (mWindowBlocks[i] != NULL)
+        {
+            PacketBuffer::Free(mWindowBlocks[i]);
+            mWindowBlocks[i] = NULL;
+        }
+    }
+}
+
 /**
  * @brief
  *  This function sets the handlers on this BDXTransfer object.  You should always
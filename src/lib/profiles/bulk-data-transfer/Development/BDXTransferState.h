@@ -290,6 +290,24 @@ struct BDXTransfer
      */
     uint32_t            mBlockCounter;
 
+    /** Windowed transfer related data members, used when mWindowSize > 1.
+     * When sending, mBlockCounter is the next block to get from the
+     * GetBlockHandler and mWindowBase the oldest block not yet acknowledged;
+     * mWindowBlocks holds a copy of every block from mWindowBase on for
+     * retransmission.  When receiving, mWindowBlocks holds the blocks that
+     * arrived ahead of mBlockCounter.  In both cases bit n of
+     * mWindowReceivedMask is set if the receiver has block base + 1 + n,
+     * base being mWindowBase or mBlockCounter respectively.
+     */
+    uint8_t             mWindowSize; // Number of blocks in flight, 1 for stop-and-wait
+    bool                mWindowEOF; // true once the BlockEOF was sent (sender) or received (receiver)
+    uint8_t             mWindowRetries; // Retransmissions on timeout since the last acknowledged block
+    uint32_t            mWindowBase;
+    uint32_t            mWindowEOFCounter; // Counter of the BlockEOF, if mWindowEOF
+    uint32_t            mWindowReceivedMask;
+    uint32_t            mWindowResendEnd; // Blocks before this one have been retransmitted since last acknowledged
+    PacketBuffer *      mWindowBlocks[WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE]; // Indexed by block counter modulo the max window size
+
     // application-supplied handlers
     //TODO: make these private when BdxProtocol doesn't inspect them directly
     //before calling DispatchGetBlockHandler().  We'll have to remove that check
@@ -306,6 +324,12 @@ struct BDXTransfer
 
     bool IsDriver(void);
 
+    bool IsWindowed(void);
+
+    void NegotiateWindowSize(uint8_t aPeerWindowSize);
+
+    void ReleaseWindowBlocks(void);
+
     void SetHandlers(BDXHandlers aHandlers);
 
     uint16_t GetDefaultFlags(bool aExpectResponse);
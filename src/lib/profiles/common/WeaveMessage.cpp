@@ -586,8 +586,8 @@ WEAVE_ERROR ReferencedString::pack(MessageIterator &i)
  * @param &aString  A place to put the result of parsing.
  *
  * @retval WEAVE_NO_ERROR                    String parsed successfully.
- * @retval WEAVE_ERROR_INVALID_STRING_LENGTH The string is too long for the buffer
- *                                           (this should never happen).
+ * @retval WEAVE_ERROR_INVALID_STRING_LENGTH The string runs past the end of the
+ *                                           message.
  */
 
 WEAVE_ERROR ReferencedString::parse(MessageIterator &i, ReferencedString &aString)
@@ -601,7 +601,7 @@ WEAVE_ERROR ReferencedString::parse(MessageIterator &i, ReferencedString &aStrin
     else
         i.read16(&len);
 
-    if (i.hasRoom(len))
+    if (i.hasData(len))
     {
         aString.theLength = len;
         aString.theString = (char *)i.thePoint;
@@ -75,6 +75,7 @@
 #include <Weave/Profiles/data-management/LoggingConfiguration.h>
 #include <Weave/Profiles/data-management/EventProcessor.h>
 #include <Weave/Profiles/data-management/LogBDXUpload.h>
+#include <Weave/Profiles/data-management/EventLogArchive.h>
 
 #include <SystemLayer/SystemStats.h>
 
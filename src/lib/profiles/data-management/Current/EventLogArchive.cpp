@@ -0,0 +1,796 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * @brief
+ *   Implementation of the file-backed archive for evicted events.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+#include <Weave/Profiles/data-management/DataManagement.h>
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
+#include <Weave/Core/WeaveEncoding.h>
+#include <SystemLayer/SystemError.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace nl::Weave::TLV;
+using namespace nl::Weave::Encoding::LittleEndian;
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+// Segment header: magic, version, importance, sequence number, reserved.
+// Record header: payload length, event ID, checksum.  A zero length
+// marks the end of the records in a segment.
+#define EVENT_LOG_ARCHIVE_MAGIC 0x41564557 // "WEVA"
+#define EVENT_LOG_ARCHIVE_VERSION 1
+#define EVENT_LOG_ARCHIVE_FILE_FORMAT "events-%u-%08" PRIx32 ".seg"
+
+EventLogArchive::EventLogArchive(void) : mNextSequence(0), mNeedsMaintenance(false)
+{
+    mDirectory[0] = '\0';
+
+    for (size_t i = 0; i < kImportanceType_Last - kImportanceType_First + 1; i++)
+    {
+        mSegmentLists[i].mNumSegments = 0;
+        mSegmentLists[i].mNumSpares   = 0;
+        mSegmentLists[i].mNumRemoved  = 0;
+    }
+}
+
+/**
+ * @brief
+ *   Open the archive stored in the specified directory.
+ *
+ * Existing segments are mapped and validated; records past the first
+ * damaged one in a segment, e.g. a record torn by a crash, are
+ * discarded.  Spare segments are set up for every importance.
+ *
+ * @param[in] inDirectory An existing directory holding the segment files.
+ *
+ * @retval #WEAVE_NO_ERROR               On success.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT The directory name is too long.
+ * @retval other                         The directory could not be read.
+ */
+WEAVE_ERROR EventLogArchive::Init(const char * inDirectory)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    DIR * dir       = NULL;
+    struct dirent * entry;
+
+    Shutdown();
+
+    VerifyOrExit(strlen(inDirectory) < sizeof(mDirectory), err = WEAVE_ERROR_INVALID_ARGUMENT);
+    strcpy(mDirectory, inDirectory);
+
+    dir = opendir(mDirectory);
+    VerifyOrExit(dir != NULL, err = System::MapErrorPOSIX(errno));
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+        // Skip files which are not segments or which cannot be loaded;
+        // a damaged segment is not a reason to lose the rest.
+        LoadSegment(entry->d_name);
+    }
+
+    // Spares must sort after the segments in use.
+    for (size_t i = 0; i < kImportanceType_Last - kImportanceType_First + 1; i++)
+    {
+        SegmentList & list = mSegmentLists[i];
+
+        while ((list.mNumSpares > 0) && (list.mNumSegments > 0) &&
+               (list.mSpares[0].mSequence < list.mSegments[list.mNumSegments - 1].mSequence))
+        {
+            DestroySegment(static_cast<ImportanceType>(i + kImportanceType_First), list.mSpares[0]);
+            list.mNumSpares--;
+            memmove(&list.mSpares[0], &list.mSpares[1], list.mNumSpares * sizeof(Segment));
+        }
+    }
+
+exit:
+    if (dir != NULL)
+    {
+        closedir(dir);
+    }
+    if (err == WEAVE_NO_ERROR)
+    {
+        SetNeedsMaintenance();
+        Maintain();
+    }
+    else
+    {
+        mDirectory[0] = '\0';
+    }
+    return err;
+}
+
+/**
+ * @brief
+ *   Unmap all segments.  The segment files are left in place, apart
+ *   from those removed from the archive.
+ */
+void EventLogArchive::Shutdown(void)
+{
+    for (size_t i = 0; i < kImportanceType_Last - kImportanceType_First + 1; i++)
+    {
+        SegmentList & list = mSegmentLists[i];
+
+        for (size_t j = 0; j < list.mNumSegments; j++)
+        {
+            munmap(list.mSegments[j].mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE);
+        }
+        list.mNumSegments = 0;
+
+        for (size_t j = 0; j < list.mNumSpares; j++)
+        {
+            munmap(list.mSpares[j].mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE);
+        }
+        list.mNumSpares = 0;
+
+        for (size_t j = 0; j < list.mNumRemoved; j++)
+        {
+            DestroySegment(static_cast<ImportanceType>(i + kImportanceType_First), list.mRemoved[j]);
+        }
+        list.mNumRemoved = 0;
+    }
+
+    mNextSequence     = 0;
+    mNeedsMaintenance = false;
+    mDirectory[0]     = '\0';
+}
+
+/**
+ * @brief
+ *   Prepare to append an event.
+ *
+ * On success, \c outWriter writes directly into the archive.  The
+ * caller writes a single event, an anonymous TLV structure, and calls
+ * CommitAppend() to make it durable.  Abandoning the writer discards
+ * the event.
+ *
+ * @param[in]  inImportance The importance of the event.
+ * @param[in]  inMaxLength  An upper bound of the encoded event size.
+ * @param[out] outWriter    The writer to encode the event with.
+ *
+ * @retval #WEAVE_NO_ERROR               On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE  The archive is not initialized.
+ * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL The event cannot fit in a segment.
+ * @retval #WEAVE_ERROR_NO_MEMORY        The current segment is full and
+ *                                       no spare segment is available.
+ */
+WEAVE_ERROR EventLogArchive::BeginAppend(ImportanceType inImportance, size_t inMaxLength, TLVWriter & outWriter)
+{
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    SegmentList & list = GetSegmentList(inImportance);
+    Segment * segment;
+
+    VerifyOrExit(mDirectory[0] != '\0', err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(inMaxLength <= WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE - kSegmentHeaderSize - kRecordHeaderSize,
+                 err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    if ((list.mNumSegments == 0) ||
+        (list.mSegments[list.mNumSegments - 1].mLength + kRecordHeaderSize + inMaxLength >
+         WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE))
+    {
+        err = AddSegment(inImportance);
+        SuccessOrExit(err);
+    }
+
+    segment = &list.mSegments[list.mNumSegments - 1];
+
+    outWriter.Init(segment->mBase + segment->mLength + kRecordHeaderSize,
+                   WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE - segment->mLength - kRecordHeaderSize);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Complete an append started with BeginAppend().
+ *
+ * Event IDs within an importance must increase.  An event ID that
+ * does not means the event ID counter was reset, e.g. on reboot
+ * without persisted counters; the events archived so far can no
+ * longer be told apart from the new ones and are discarded.
+ *
+ * @param[in] inImportance The importance passed to BeginAppend().
+ * @param[in] inEventID    The ID of the event.
+ * @param[in] inWriter     The writer returned by BeginAppend(), finalized.
+ *
+ * @retval #WEAVE_NO_ERROR              On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE No append is in progress.
+ */
+WEAVE_ERROR EventLogArchive::CommitAppend(ImportanceType inImportance, event_id_t inEventID, TLVWriter & inWriter)
+{
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    SegmentList & list = GetSegmentList(inImportance);
+    uint32_t length    = inWriter.GetLengthWritten();
+    Segment * segment;
+    Segment * lastSegment;
+    uint8_t * record;
+
+    VerifyOrExit(list.mNumSegments > 0 && length > 0, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    segment = &list.mSegments[list.mNumSegments - 1];
+    record  = segment->mBase + segment->mLength;
+
+    // Only the last segment may be empty, having just been added.
+    lastSegment = (segment->mNumEvents > 0) ? segment : ((list.mNumSegments > 1) ? segment - 1 : NULL);
+
+    if ((lastSegment != NULL) && (inEventID <= lastSegment->mLastEventID))
+    {
+        WeaveLogError(EventLogging, "Event ID %" PRIu32 " reused, discarding archived events of importance %d", inEventID,
+                      inImportance);
+
+        // Keep the current segment, which holds the event being
+        // committed, but drop everything archived before it.
+        while (list.mNumSegments > 1)
+        {
+            RemoveSegment(inImportance, 0);
+        }
+        segment = &list.mSegments[0];
+
+        if (segment->mNumEvents > 0)
+        {
+            memmove(segment->mBase + kSegmentHeaderSize, record, kRecordHeaderSize + length);
+            memset(segment->mBase + kSegmentHeaderSize + kRecordHeaderSize + length, 0,
+                   segment->mLength - kSegmentHeaderSize);
+            segment->mLength    = kSegmentHeaderSize;
+            segment->mNumEvents = 0;
+            record              = segment->mBase + segment->mLength;
+        }
+    }
+
+    // Write the length last: a zero length ends the segment, so the
+    // record only becomes visible once it is complete.
+    Put32(record + 4, inEventID);
+    Put32(record + 8, ComputeChecksum(record + kRecordHeaderSize, length, inEventID));
+    Put32(record, length);
+
+    if (segment->mNumEvents == 0)
+    {
+        segment->mFirstEventID = inEventID;
+    }
+    segment->mLastEventID = inEventID;
+    segment->mNumEvents++;
+    segment->mLength += kRecordHeaderSize + length;
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Copy archived events of the specified importance, starting with
+ *   the specified event ID.
+ *
+ * The function copies events until it runs out of space in the
+ * writer or of archived events, terminating on an event boundary.
+ * Every event carries its event ID and absolute timestamp.
+ *
+ * @param[in]    ioWriter     The writer to copy the events to.
+ * @param[in]    inImportance The importance of the events.
+ * @param[inout] ioEventID    On input, the ID of the first event to
+ *                            copy.  On return, the ID of the event
+ *                            following the last event copied.
+ *
+ * @retval #WEAVE_END_OF_TLV             All archived events were copied.
+ * @retval #WEAVE_ERROR_NO_MEMORY        The writer ran out of space.
+ * @retval #WEAVE_ERROR_BUFFER_TOO_SMALL The writer ran out of space.
+ */
+WEAVE_ERROR EventLogArchive::FetchEventsSince(TLVWriter & ioWriter, ImportanceType inImportance, event_id_t & ioEventID)
+{
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    SegmentList & list = GetSegmentList(inImportance);
+    TLVWriter checkpoint;
+    TLVReader reader;
+
+    for (size_t i = 0; i < list.mNumSegments; i++)
+    {
+        const Segment & segment = list.mSegments[i];
+        uint32_t offset         = kSegmentHeaderSize;
+
+        if ((segment.mNumEvents == 0) || (segment.mLastEventID < ioEventID))
+        {
+            continue;
+        }
+
+        while (offset < segment.mLength)
+        {
+            const uint8_t * record = segment.mBase + offset;
+            uint32_t length        = Get32(record);
+            event_id_t eventID     = Get32(record + 4);
+
+            offset += kRecordHeaderSize + length;
+
+            if (eventID < ioEventID)
+            {
+                continue;
+            }
+
+            reader.Init(record + kRecordHeaderSize, length);
+            err = reader.Next();
+            SuccessOrExit(err);
+
+            checkpoint = ioWriter;
+            err        = ioWriter.CopyElement(reader);
+            VerifyOrExit(err == WEAVE_NO_ERROR, ioWriter = checkpoint);
+
+            ioEventID = eventID + 1;
+        }
+    }
+
+    err = WEAVE_END_OF_TLV;
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Flush all segments to stable storage.
+ */
+WEAVE_ERROR EventLogArchive::Sync(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (size_t i = 0; i < kImportanceType_Last - kImportanceType_First + 1; i++)
+    {
+        SegmentList & list = mSegmentLists[i];
+
+        for (size_t j = 0; j < list.mNumSegments; j++)
+        {
+            if (msync(list.mSegments[j].mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE, MS_SYNC) != 0)
+            {
+                err = System::MapErrorPOSIX(errno);
+            }
+        }
+    }
+
+    return err;
+}
+
+/**
+ * @brief
+ *   Carry out the file system work deferred by appends: delete the
+ *   segments removed from the archive and create the spare segments
+ *   that have been used up.
+ *
+ * Must be called outside of the logging critical section, which it
+ * only takes to exchange segments with the appending side.  Returns
+ * at once when there is nothing to do.
+ */
+void EventLogArchive::Maintain(void)
+{
+    VerifyOrExit(__sync_bool_compare_and_swap(&mNeedsMaintenance, true, false), /* no-op */);
+
+    for (size_t i = 0; i < kImportanceType_Last - kImportanceType_First + 1; i++)
+    {
+        const ImportanceType importance = static_cast<ImportanceType>(i + kImportanceType_First);
+        SegmentList & list              = mSegmentLists[i];
+        Segment removed[WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS];
+        Segment spare;
+        size_t numRemoved;
+        size_t numSpares  = 0;
+        uint32_t sequence = 0;
+
+        Platform::CriticalSectionEnter();
+
+        numRemoved = list.mNumRemoved;
+        memcpy(removed, list.mRemoved, numRemoved * sizeof(Segment));
+        list.mNumRemoved = 0;
+
+        if (mDirectory[0] != '\0')
+        {
+            numSpares = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS - list.mNumSpares;
+            sequence  = mNextSequence;
+            mNextSequence += numSpares;
+        }
+
+        Platform::CriticalSectionExit();
+
+        for (size_t j = 0; j < numRemoved; j++)
+        {
+            DestroySegment(importance, removed[j]);
+        }
+
+        for (size_t j = 0; j < numSpares; j++)
+        {
+            bool added = false;
+
+            if (CreateSegment(importance, sequence + j, spare) != WEAVE_NO_ERROR)
+            {
+                // Try again after the next append.
+                SetNeedsMaintenance();
+                break;
+            }
+
+            Platform::CriticalSectionEnter();
+
+            // A concurrent call may have topped up the spares already,
+            // or have had one of its spares put to use, which this one
+            // would no longer sort after.
+            if ((list.mNumSpares < WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS) &&
+                ((list.mNumSegments == 0) || (list.mSegments[list.mNumSegments - 1].mSequence < spare.mSequence)))
+            {
+                size_t k;
+
+                for (k = list.mNumSpares; k > 0 && list.mSpares[k - 1].mSequence > spare.mSequence; k--)
+                {
+                    list.mSpares[k] = list.mSpares[k - 1];
+                }
+                list.mSpares[k] = spare;
+                list.mNumSpares++;
+                added = true;
+            }
+
+            Platform::CriticalSectionExit();
+
+            if (!added)
+            {
+                DestroySegment(importance, spare);
+            }
+        }
+    }
+
+exit:
+    return;
+}
+
+/**
+ * @brief
+ *   Return the number of archived events of the specified importance.
+ */
+size_t EventLogArchive::GetNumEvents(ImportanceType inImportance) const
+{
+    const SegmentList & list = mSegmentLists[inImportance - kImportanceType_First];
+    size_t retval            = 0;
+
+    for (size_t i = 0; i < list.mNumSegments; i++)
+    {
+        retval += list.mSegments[i].mNumEvents;
+    }
+
+    return retval;
+}
+
+EventLogArchive::SegmentList & EventLogArchive::GetSegmentList(ImportanceType inImportance)
+{
+    return mSegmentLists[inImportance - kImportanceType_First];
+}
+
+WEAVE_ERROR EventLogArchive::GetSegmentPath(ImportanceType inImportance, uint32_t inSequence, char * outPath,
+                                            size_t inPathSize) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    int len;
+
+    len = snprintf(outPath, inPathSize, "%s/" EVENT_LOG_ARCHIVE_FILE_FORMAT, mDirectory, static_cast<unsigned>(inImportance),
+                   inSequence);
+    VerifyOrExit(len > 0 && static_cast<size_t>(len) < inPathSize, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR EventLogArchive::MapSegment(const char * inPath, bool inCreate, uint8_t *& outBase) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    int fd          = -1;
+    struct stat st;
+    void * base;
+
+    fd = open(inPath, inCreate ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+    VerifyOrExit(fd >= 0, err = System::MapErrorPOSIX(errno));
+
+    if (inCreate)
+    {
+        VerifyOrExit(ftruncate(fd, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE) == 0, err = System::MapErrorPOSIX(errno));
+    }
+    else
+    {
+        VerifyOrExit(fstat(fd, &st) == 0, err = System::MapErrorPOSIX(errno));
+        VerifyOrExit(st.st_size == WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    base = mmap(NULL, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    VerifyOrExit(base != MAP_FAILED, err = System::MapErrorPOSIX(errno));
+
+    outBase = static_cast<uint8_t *>(base);
+
+exit:
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return err;
+}
+
+WEAVE_ERROR EventLogArchive::LoadSegment(const char * inFileName)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char path[kMaxPathLength];
+    unsigned importance;
+    uint32_t sequence;
+    int consumed = 0;
+    Segment segment;
+    size_t i;
+
+    VerifyOrExit(sscanf(inFileName, "events-%u-%" SCNx32 ".seg%n", &importance, &sequence, &consumed) == 2 &&
+                     inFileName[consumed] == '\0',
+                 err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(importance >= kImportanceType_First && importance <= kImportanceType_Last, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = GetSegmentPath(static_cast<ImportanceType>(importance), sequence, path, sizeof(path));
+    SuccessOrExit(err);
+
+    err = MapSegment(path, false, segment.mBase);
+    SuccessOrExit(err);
+
+    if ((Get32(segment.mBase) != EVENT_LOG_ARCHIVE_MAGIC) || (Get16(segment.mBase + 4) != EVENT_LOG_ARCHIVE_VERSION) ||
+        (Get16(segment.mBase + 6) != importance) || (Get32(segment.mBase + 8) != sequence))
+    {
+        munmap(segment.mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE);
+        unlink(path);
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    segment.mSequence = sequence;
+    ScanSegment(segment);
+
+    if (sequence >= mNextSequence)
+    {
+        mNextSequence = sequence + 1;
+    }
+
+    // Keep the lists ordered by sequence number, oldest first.  If one
+    // is full, the oldest segment gives way.  An empty segment is a
+    // spare of the previous run; only the newest ones are kept.
+    {
+        SegmentList & list = GetSegmentList(static_cast<ImportanceType>(importance));
+
+        if (segment.mNumEvents == 0)
+        {
+            if (list.mNumSpares == WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS)
+            {
+                if (sequence < list.mSpares[0].mSequence)
+                {
+                    DestroySegment(static_cast<ImportanceType>(importance), segment);
+                    ExitNow();
+                }
+
+                DestroySegment(static_cast<ImportanceType>(importance), list.mSpares[0]);
+                list.mNumSpares--;
+                memmove(&list.mSpares[0], &list.mSpares[1], list.mNumSpares * sizeof(Segment));
+            }
+
+            for (i = list.mNumSpares; i > 0 && list.mSpares[i - 1].mSequence > sequence; i--)
+            {
+                list.mSpares[i] = list.mSpares[i - 1];
+            }
+            list.mSpares[i] = segment;
+            list.mNumSpares++;
+            ExitNow();
+        }
+
+        if (list.mNumSegments == WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS)
+        {
+            if (sequence < list.mSegments[0].mSequence)
+            {
+                munmap(segment.mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE);
+                unlink(path);
+                ExitNow();
+            }
+
+            RemoveSegment(static_cast<ImportanceType>(importance), 0);
+        }
+
+        for (i = list.mNumSegments; i > 0 && list.mSegments[i - 1].mSequence > sequence; i--)
+        {
+            list.mSegments[i] = list.mSegments[i - 1];
+        }
+        list.mSegments[i] = segment;
+        list.mNumSegments++;
+    }
+
+exit:
+    return err;
+}
+
+// Create and map a new, empty segment file.
+WEAVE_ERROR EventLogArchive::CreateSegment(ImportanceType inImportance, uint32_t inSequence, Segment & outSegment) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char path[kMaxPathLength];
+
+    err = GetSegmentPath(inImportance, inSequence, path, sizeof(path));
+    SuccessOrExit(err);
+
+    err = MapSegment(path, true, outSegment.mBase);
+    SuccessOrExit(err);
+
+    Put32(outSegment.mBase, EVENT_LOG_ARCHIVE_MAGIC);
+    Put16(outSegment.mBase + 4, EVENT_LOG_ARCHIVE_VERSION);
+    Put16(outSegment.mBase + 6, static_cast<uint16_t>(inImportance));
+    Put32(outSegment.mBase + 8, inSequence);
+    Put32(outSegment.mBase + 12, 0);
+
+    outSegment.mSequence     = inSequence;
+    outSegment.mLength       = kSegmentHeaderSize;
+    outSegment.mNumEvents    = 0;
+    outSegment.mFirstEventID = 0;
+    outSegment.mLastEventID  = 0;
+
+exit:
+    return err;
+}
+
+// Unmap a segment and delete its file.
+void EventLogArchive::DestroySegment(ImportanceType inImportance, const Segment & inSegment) const
+{
+    char path[kMaxPathLength];
+
+    munmap(inSegment.mBase, WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE);
+
+    if (GetSegmentPath(inImportance, inSegment.mSequence, path, sizeof(path)) == WEAVE_NO_ERROR)
+    {
+        unlink(path);
+    }
+}
+
+// Switch to the oldest spare segment of an importance, making room
+// for it if needed.  No file system work is done here; see Maintain().
+WEAVE_ERROR EventLogArchive::AddSegment(ImportanceType inImportance)
+{
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    SegmentList & list = GetSegmentList(inImportance);
+
+    SetNeedsMaintenance();
+
+    VerifyOrExit(list.mNumSpares > 0, err = WEAVE_ERROR_NO_MEMORY);
+
+    if (list.mNumSegments == WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS)
+    {
+        RemoveSegment(inImportance, 0);
+    }
+
+    list.mSegments[list.mNumSegments++] = list.mSpares[0];
+    list.mNumSpares--;
+    memmove(&list.mSpares[0], &list.mSpares[1], list.mNumSpares * sizeof(Segment));
+
+exit:
+    return err;
+}
+
+// Take a segment out of the archive.  Its file is deleted by the next
+// Maintain(), or right away if too many removals are pending.
+void EventLogArchive::RemoveSegment(ImportanceType inImportance, size_t inIndex)
+{
+    SegmentList & list = GetSegmentList(inImportance);
+
+    if (list.mNumRemoved < WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS)
+    {
+        list.mRemoved[list.mNumRemoved++] = list.mSegments[inIndex];
+        SetNeedsMaintenance();
+    }
+    else
+    {
+        DestroySegment(inImportance, list.mSegments[inIndex]);
+    }
+
+    list.mNumSegments--;
+    memmove(&list.mSegments[inIndex], &list.mSegments[inIndex + 1], (list.mNumSegments - inIndex) * sizeof(Segment));
+}
+
+// Flag work for Maintain(), which tests and clears the flag without
+// taking the logging critical section.
+void EventLogArchive::SetNeedsMaintenance(void)
+{
+    __sync_bool_compare_and_swap(&mNeedsMaintenance, false, true);
+}
+
+// Walk the records of a freshly mapped segment, stopping at the first
+// record that is incomplete or damaged.
+void EventLogArchive::ScanSegment(Segment & ioSegment)
+{
+    uint32_t offset = kSegmentHeaderSize;
+
+    ioSegment.mNumEvents    = 0;
+    ioSegment.mFirstEventID = 0;
+    ioSegment.mLastEventID  = 0;
+
+    while (offset + kRecordHeaderSize <= WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE)
+    {
+        const uint8_t * record = ioSegment.mBase + offset;
+        uint32_t length        = Get32(record);
+        event_id_t eventID     = Get32(record + 4);
+
+        if ((length == 0) || (length > WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE - offset - kRecordHeaderSize) ||
+            (Get32(record + 8) != ComputeChecksum(record + kRecordHeaderSize, length, eventID)) ||
+            ((ioSegment.mNumEvents > 0) && (eventID <= ioSegment.mLastEventID)))
+        {
+            break;
+        }
+
+        if (ioSegment.mNumEvents == 0)
+        {
+            ioSegment.mFirstEventID = eventID;
+        }
+        ioSegment.mLastEventID = eventID;
+        ioSegment.mNumEvents++;
+        offset += kRecordHeaderSize + length;
+    }
+
+    ioSegment.mLength = offset;
+
+    // Clear whatever follows the valid records, so that appends
+    // resume on a clean end marker.
+    if (offset + kRecordHeaderSize <= WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE)
+    {
+        memset(ioSegment.mBase + offset, 0, kRecordHeaderSize);
+    }
+}
+
+// 32-bit FNV-1a over the event ID and the record payload
+uint32_t EventLogArchive::ComputeChecksum(const uint8_t * inRecord, uint32_t inLength, event_id_t inEventID)
+{
+    uint32_t hash = 2166136261u;
+    uint8_t id[4];
+
+    Put32(id, inEventID);
+
+    for (size_t i = 0; i < sizeof(id); i++)
+    {
+        hash = (hash ^ id[i]) * 16777619u;
+    }
+
+    for (uint32_t i = 0; i < inLength; i++)
+    {
+        hash = (hash ^ inRecord[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+} // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
@@ -0,0 +1,143 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ * @file
+ *
+ * @brief
+ *   A file-backed archive for events evicted from the in-memory event log.
+ *
+ */
+#ifndef _WEAVE_DATA_MANAGEMENT_EVENT_LOG_ARCHIVE_CURRENT_H
+#define _WEAVE_DATA_MANAGEMENT_EVENT_LOG_ARCHIVE_CURRENT_H
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+#include <Weave/Profiles/data-management/EventLoggingTypes.h>
+#include <Weave/Core/WeaveTLV.h>
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+/**
+ * @brief
+ *   An append-only store for events that are dropped from the
+ *   in-memory event buffers.
+ *
+ * Once attached via LoggingManagement::SetArchive(), every event that
+ * is evicted from its final CircularEventBuffer is appended to the
+ * archive as a self-contained event, carrying its event ID and
+ * absolute timestamp.  LoggingManagement::FetchEventsSince() serves
+ * events older than the in-memory log from the archive, so readers
+ * see a single contiguous log.
+ *
+ * Events of each importance are stored in a sequence of fixed-size
+ * segment files of #WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE
+ * bytes, mapped into memory.  Each record carries a checksum and is
+ * only made visible once completely written, so a crash mid-append
+ * loses at most the record being written; Init() recovers the valid
+ * prefix of every segment.  When an importance reaches
+ * #WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS segments, its
+ * oldest segment is removed to make room for a new one.
+ *
+ * Appends run within the logging critical section and never touch the
+ * file system: each importance keeps
+ * #WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS spare segments,
+ * created ahead of time, to switch to when its current segment fills
+ * up, and removed segments are only unmapped and deleted later.
+ * Maintain() does this file work outside of the critical section;
+ * LoggingManagement invokes it after logging an event.  An event that
+ * needs a new segment while no spare is available is dropped.
+ */
+class NL_DLL_EXPORT EventLogArchive
+{
+public:
+    EventLogArchive(void);
+
+    WEAVE_ERROR Init(const char * inDirectory);
+    void Shutdown(void);
+
+    WEAVE_ERROR BeginAppend(ImportanceType inImportance, size_t inMaxLength, nl::Weave::TLV::TLVWriter & outWriter);
+    WEAVE_ERROR CommitAppend(ImportanceType inImportance, event_id_t inEventID, nl::Weave::TLV::TLVWriter & inWriter);
+
+    WEAVE_ERROR FetchEventsSince(nl::Weave::TLV::TLVWriter & ioWriter, ImportanceType inImportance, event_id_t & ioEventID);
+
+    WEAVE_ERROR Sync(void);
+
+    void Maintain(void);
+
+    size_t GetNumEvents(ImportanceType inImportance) const;
+
+private:
+    struct Segment
+    {
+        uint8_t * mBase;
+        uint32_t mSequence;
+        uint32_t mLength;
+        uint32_t mNumEvents;
+        event_id_t mFirstEventID;
+        event_id_t mLastEventID;
+    };
+
+    struct SegmentList
+    {
+        Segment mSegments[WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS];
+        size_t mNumSegments;
+        Segment mSpares[WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS]; ///< The next segments to append to, oldest first.
+        size_t mNumSpares;
+        Segment mRemoved[WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS]; ///< Segments still to be unmapped and deleted.
+        size_t mNumRemoved;
+    };
+
+    enum
+    {
+        kSegmentHeaderSize = 16,
+        kRecordHeaderSize  = 12,
+        kMaxPathLength     = 256,
+    };
+
+    WEAVE_ERROR GetSegmentPath(ImportanceType inImportance, uint32_t inSequence, char * outPath, size_t inPathSize) const;
+    WEAVE_ERROR MapSegment(const char * inPath, bool inCreate, uint8_t *& outBase) const;
+    WEAVE_ERROR LoadSegment(const char * inFileName);
+    WEAVE_ERROR CreateSegment(ImportanceType inImportance, uint32_t inSequence, Segment & outSegment) const;
+    void DestroySegment(ImportanceType inImportance, const Segment & inSegment) const;
+    WEAVE_ERROR AddSegment(ImportanceType inImportance);
+    void RemoveSegment(ImportanceType inImportance, size_t inIndex);
+    void SetNeedsMaintenance(void);
+    SegmentList & GetSegmentList(ImportanceType inImportance);
+
+    static void ScanSegment(Segment & ioSegment);
+    static uint32_t ComputeChecksum(const uint8_t * inRecord, uint32_t inLength, event_id_t inEventID);
+
+    SegmentList mSegmentLists[kImportanceType_Last - kImportanceType_First + 1];
+    uint32_t mNextSequence;
+    bool mNeedsMaintenance; ///< Only accessed atomically, as it is polled outside of the critical section.
+    char mDirectory[kMaxPathLength];
+};
+
+} // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
+#endif //_WEAVE_DATA_MANAGEMENT_EVENT_LOG_ARCHIVE_CURRENT_H
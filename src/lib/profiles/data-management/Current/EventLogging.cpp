@@ -45,15 +45,19 @@ namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNames
  */
 static WEAVE_ERROR EventWriterTLVCopy(TLVWriter & ioWriter, uint8_t inDataTag, void * appData)
 {
-    WEAVE_ERROR err    = WEAVE_NO_ERROR;
-    TLVReader * reader = static_cast<TLVReader *>(appData);
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVReader reader;
 
-    VerifyOrExit(reader != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(appData != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-    err = reader->Next();
+    // Work on a copy of the reader: the logging subsystem may invoke
+    // the writer more than once for the same event.
+    reader = *static_cast<TLVReader *>(appData);
+
+    err = reader.Next();
     SuccessOrExit(err);
 
-    err = ioWriter.CopyElement(nl::Weave::TLV::ContextTag(kTag_EventData), *reader);
+    err = ioWriter.CopyElement(nl::Weave::TLV::ContextTag(kTag_EventData), reader);
 
 exit:
     return err;
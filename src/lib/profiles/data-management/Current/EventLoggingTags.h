@@ -146,6 +146,8 @@ enum
 
     kTag_EventDeltaSystemTime    = 31, ///< WDM internal tag, time difference from the previous event in the encoding
 
+    kTag_EventCompactEnvelope    = 32, ///< WDM internal tag, event metadata in the compact in-memory encoding
+
     kTag_EventData               = 50, ///< Optional.  Event data itself.  If empty, it defaults to an empty structure.
 
     kTag_ExternalEventStructure  = 99, ///< Internal tag for external events.  Never transmitted across the wire, should never be used outside of Weave library
@@ -60,6 +60,17 @@ namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNames
 // Overhead of embedding something in a (short) byte string: 1 byte control, 1 byte tag, 1 byte length
 #define EXTERNAL_EVENT_BYTE_STRING_TLV_SIZE 3
 
+// Upper bound on the growth of an event when it is archived: the
+// event ID (1 byte control, 1 byte tag, 4 bytes value) and the
+// absolute timestamps replacing their deltas (up to 4 and 8 bytes)
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+// Events in the compact encoding additionally grow by their expanded
+// metadata
+#define EVENT_ARCHIVE_ENVELOPE_OVERHEAD (18 + CompactEventEnvelope::kMaxEncodedLength)
+#else
+#define EVENT_ARCHIVE_ENVELOPE_OVERHEAD 18
+#endif
+
 // Static instance: embedded platforms not always implement a proper
 // C++ runtime; instead, the instance is initialized via placement new
 // in CreateLoggingManagement.
@@ -75,6 +86,9 @@ struct ReclaimEventCtx
 {
     CircularEventBuffer * mEventBuffer;
     size_t mSpaceNeededForEvent;
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    EventLogArchive * mArchive;
+#endif
 };
 
 WEAVE_ERROR LoggingManagement::AlwaysFail(nl::Weave::TLV::WeaveCircularTLVBuffer & inBuffer, void * inAppData,
@@ -137,10 +151,13 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
         {
             ctx.mEventBuffer         = eventBuffer;
             ctx.mSpaceNeededForEvent = 0;
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+            ctx.mArchive = mArchive;
+#endif
 
             circularBuffer->mProcessEvictedElement = EvictEvent;
             circularBuffer->mAppData               = &ctx;
-            err                                    = circularBuffer->EvictHead();
+            err                                    = eventBuffer->EvictHead();
 
             // one of two things happened: either the element was evicted,
             // or we figured out how much space we need to evict it into
@@ -162,7 +179,7 @@ WEAVE_ERROR LoggingManagement::EnsureSpace(size_t inRequiredSpace)
 
                     // success; evict head unconditionally
                     circularBuffer->mProcessEvictedElement = NULL;
-                    err                                    = circularBuffer->EvictHead();
+                    err                                    = eventBuffer->EvictHead();
                     // if unconditional eviction failed, this
                     // means that we have no way of further
                     // clearing the buffer.  fail out and let the
@@ -394,6 +411,251 @@ exit:
  *                          and preserved by BlitEvent using this context.
  *
  */
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+/**
+ * @brief
+ *   Write an event into the in-memory log in the compact encoding.
+ *
+ * The counterpart of BlitEvent() for the event buffers: the event
+ * metadata is packed into a single kTag_EventCompactEnvelope element,
+ * followed by the event data.  CopyAndAdjustDeltaTime() expands the
+ * envelope back into the regular metadata elements.
+ */
+WEAVE_ERROR LoggingManagement::BlitCompactEvent(EventLoadOutContext * aContext, const EventSchema & inSchema,
+                                                EventWriterFunct inEventWriter, void * inAppData, const EventOptions * inOptions)
+{
+    WEAVE_ERROR err      = WEAVE_NO_ERROR;
+    TLVWriter checkpoint = aContext->mWriter;
+    TLVType containerType;
+    CompactEventEnvelope envelope;
+    uint8_t encoding[CompactEventEnvelope::kMaxEncodedLength];
+    size_t length;
+
+    VerifyOrExit(inOptions != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(inOptions->timestampType != kTimestampType_Invalid, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    envelope.mImportance = inSchema.mImportance;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    envelope.mUTCDelta = (inOptions->timestampType == kTimestampType_UTC);
+    if (envelope.mUTCDelta)
+    {
+        envelope.mDeltaTime = static_cast<int64_t>(inOptions->timestamp.utcTimestamp - aContext->mCurrentUTCTime);
+    }
+    else
+#else
+    envelope.mUTCDelta = false;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    {
+        envelope.mDeltaTime = static_cast<int32_t>(inOptions->timestamp.systemTimestamp - aContext->mCurrentTime);
+    }
+
+    envelope.mSource.mProfileId   = inSchema.mProfileId;
+    envelope.mSource.mHasResource = (inOptions->eventSource != NULL);
+    if (envelope.mSource.mHasResource)
+    {
+        envelope.mSource.mResourceType    = inOptions->eventSource->ResourceID.GetResourceType();
+        envelope.mSource.mResourceId      = inOptions->eventSource->ResourceID.GetResourceId();
+        envelope.mSource.mTraitInstanceID = inOptions->eventSource->TraitInstanceID;
+    }
+    else
+    {
+        envelope.mSource.mResourceType    = 0;
+        envelope.mSource.mResourceId      = 0;
+        envelope.mSource.mTraitInstanceID = 0;
+    }
+
+    envelope.mDataSchemaVersion              = inSchema.mDataSchemaVersion;
+    envelope.mMinCompatibleDataSchemaVersion = inSchema.mMinCompatibleDataSchemaVersion;
+    envelope.mEventType                      = inSchema.mStructureType;
+    envelope.mHasRelatedEvent                = (inOptions->relatedEventID != 0);
+    envelope.mRelatedImportance              = static_cast<uint16_t>(inOptions->relatedImportance);
+    envelope.mRelatedEventID                 = inOptions->relatedEventID;
+
+    err = envelope.Encode(encoding, sizeof(encoding), length, FindEventSource(envelope.mSource));
+    SuccessOrExit(err);
+
+    err = aContext->mWriter.StartContainer(AnonymousTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aContext->mWriter.PutBytes(ContextTag(kTag_EventCompactEnvelope), encoding, length);
+    SuccessOrExit(err);
+
+    err = inEventWriter(aContext->mWriter, kTag_EventData, inAppData);
+    SuccessOrExit(err);
+
+    err = aContext->mWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+    err = aContext->mWriter.Finalize();
+    SuccessOrExit(err);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        aContext->mWriter = checkpoint;
+    }
+    return err;
+}
+
+/**
+ * @brief
+ *   Look up the index of an event source, adding it to the table if
+ *   there is room.
+ *
+ * @return The index of the event source, or -1 if it is not in the table.
+ */
+int LoggingManagement::FindEventSource(const CompactEventSource & inSource)
+{
+    int retval = -1;
+
+    for (size_t i = 0; i < mNumEventSources; i++)
+    {
+        if (mEventSources[i] == inSource)
+        {
+            ExitNow(retval = static_cast<int>(i));
+        }
+    }
+
+    // Entries are never replaced: events referring to them may be
+    // anywhere in the buffers.
+    if (mNumEventSources < WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES)
+    {
+        mEventSources[mNumEventSources] = inSource;
+        retval                          = static_cast<int>(mNumEventSources++);
+    }
+
+exit:
+    return retval;
+}
+
+WEAVE_ERROR LoggingManagement::ReadCompactEnvelope(const TLVReader & aReader, CompactEventEnvelope & outEnvelope)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVReader reader;
+    uint8_t encoding[CompactEventEnvelope::kMaxEncodedLength];
+    const uint32_t length              = aReader.GetLength();
+    const LoggingManagement & instance = GetInstance();
+
+    VerifyOrExit(length <= sizeof(encoding), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+
+    // The envelope may wrap around the end of a circular buffer;
+    // GetBytes reassembles it.
+    reader.Init(aReader);
+    err = reader.GetBytes(encoding, sizeof(encoding));
+    SuccessOrExit(err);
+
+    err = outEnvelope.Decode(encoding, length, instance.mEventSources, instance.mNumEventSources);
+
+exit:
+    return err;
+}
+
+// Write out the metadata of a compact envelope the same way
+// BlitEvent would have, adjusted like CopyAndAdjustDeltaTime adjusts
+// the regular encoding.
+WEAVE_ERROR LoggingManagement::ExpandCompactEnvelope(const TLVReader & aReader, CopyAndAdjustDeltaTimeContext * aContext)
+{
+    WEAVE_ERROR err               = WEAVE_NO_ERROR;
+    TLVWriter & writer            = *aContext->mWriter;
+    EventLoadOutContext * loadOut = aContext->mContext;
+    CompactEventEnvelope envelope;
+
+    err = ReadCompactEnvelope(aReader, envelope);
+    SuccessOrExit(err);
+
+    err = writer.Put(ContextTag(kTag_EventImportance), static_cast<uint16_t>(envelope.mImportance));
+    SuccessOrExit(err);
+
+    if (loadOut->mFirst)
+    {
+        err = writer.Put(ContextTag(kTag_EventID), loadOut->mCurrentEventID);
+        SuccessOrExit(err);
+    }
+
+    if (envelope.mHasRelatedEvent)
+    {
+        err = writer.Put(ContextTag(kTag_RelatedEventImportance), envelope.mRelatedImportance);
+        SuccessOrExit(err);
+
+        err = writer.Put(ContextTag(kTag_RelatedEventID), envelope.mRelatedEventID);
+        SuccessOrExit(err);
+    }
+
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    if (envelope.mUTCDelta)
+    {
+        if (loadOut->mFirstUtc)
+        {
+            err                = writer.Put(ContextTag(kTag_EventUTCTimestamp), loadOut->mCurrentUTCTime);
+            loadOut->mFirstUtc = false;
+        }
+        else
+        {
+            err = writer.Put(ContextTag(kTag_EventDeltaUTCTime), envelope.mDeltaTime);
+        }
+    }
+    else
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    {
+        if (loadOut->mFirst)
+        {
+            err = writer.Put(ContextTag(kTag_EventSystemTimestamp), loadOut->mCurrentTime);
+        }
+        else
+        {
+            err = writer.Put(ContextTag(kTag_EventDeltaSystemTime), static_cast<int32_t>(envelope.mDeltaTime));
+        }
+    }
+    SuccessOrExit(err);
+
+    if (envelope.mMinCompatibleDataSchemaVersion != 1 || envelope.mDataSchemaVersion != 1)
+    {
+        TLVType type;
+
+        err = writer.StartContainer(ContextTag(kTag_EventTraitProfileID), kTLVType_Array, type);
+        SuccessOrExit(err);
+
+        err = writer.Put(AnonymousTag, envelope.mSource.mProfileId);
+        SuccessOrExit(err);
+
+        if (envelope.mDataSchemaVersion != 1)
+        {
+            err = writer.Put(AnonymousTag, envelope.mDataSchemaVersion);
+            SuccessOrExit(err);
+        }
+
+        if (envelope.mMinCompatibleDataSchemaVersion != 1)
+        {
+            err = writer.Put(AnonymousTag, envelope.mMinCompatibleDataSchemaVersion);
+            SuccessOrExit(err);
+        }
+
+        err = writer.EndContainer(type);
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = writer.Put(ContextTag(kTag_EventTraitProfileID), envelope.mSource.mProfileId);
+        SuccessOrExit(err);
+    }
+
+    if (envelope.mSource.mHasResource)
+    {
+        err = ResourceIdentifier(envelope.mSource.mResourceType, envelope.mSource.mResourceId)
+                  .ToTLV(writer, ContextTag(kTag_EventResourceID));
+        SuccessOrExit(err);
+
+        err = writer.Put(ContextTag(kTag_EventTraitInstanceID), envelope.mSource.mTraitInstanceID);
+        SuccessOrExit(err);
+    }
+
+    err = writer.Put(ContextTag(kTag_EventType), envelope.mEventType);
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
 void LoggingManagement::SkipEvent(EventLoadOutContext * aContext)
 {
     aContext->mCurrentEventID++; // Advance the event id without writing anything
@@ -528,6 +790,26 @@ LoggingManagement::LoggingManagement(nl::Weave::WeaveExchangeManager * inMgr,
     mBytesWritten        = 0;
     mUploadRequested     = false;
     mMaxImportanceBuffer = kImportanceType_Last;
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    memset(mStagingBuffers, 0, sizeof(mStagingBuffers));
+    mNumStagedEvents = 0;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    for (size_t k = 0; k < kImportanceType_Last - kImportanceType_First + 1; k++)
+    {
+        mEventIndex[k].Reset();
+    }
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    mArchive = NULL;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    mNumEventSources = 0;
+#endif
 }
 
 /**
@@ -540,7 +822,27 @@ LoggingManagement::LoggingManagement(nl::Weave::WeaveExchangeManager * inMgr,
 LoggingManagement::LoggingManagement(void) :
     mEventBuffer(NULL), mExchangeMgr(NULL), mState(kLoggingManagementState_Idle), mBDXUploader(NULL), mBytesWritten(0),
     mThrottled(0), mMaxImportanceBuffer(kImportanceType_Invalid), mUploadRequested(false)
-{ }
+{
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    memset(mStagingBuffers, 0, sizeof(mStagingBuffers));
+    mNumStagedEvents = 0;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    for (size_t k = 0; k < kImportanceType_Last - kImportanceType_First + 1; k++)
+    {
+        mEventIndex[k].Reset();
+    }
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    mArchive = NULL;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    mNumEventSources = 0;
+#endif
+}
 
 /**
  * @brief
@@ -992,6 +1294,13 @@ WEAVE_ERROR LoggingManagement::CopyAndAdjustDeltaTime(const TLVReader & aReader,
     CopyAndAdjustDeltaTimeContext * ctx = static_cast<CopyAndAdjustDeltaTimeContext *>(aContext);
     TLVReader reader(aReader);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    if (aReader.GetTag() == nl::Weave::TLV::ContextTag(kTag_EventCompactEnvelope))
+    {
+        return ExpandCompactEnvelope(aReader, ctx);
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
     if (aReader.GetTag() == nl::Weave::TLV::ContextTag(kTag_EventDeltaSystemTime))
     {
         if (ctx->mContext->mFirst) // First event gets a timestamp, subsequent ones get a delta T
@@ -1084,6 +1393,38 @@ event_id_t LoggingManagement::LogEvent(const EventSchema & inSchema, EventWriter
                                        const EventOptions * inOptions)
 {
     event_id_t event_id = 0;
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    EventLogArchive * archive = NULL;
+#endif
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    StagingBuffer * stagingBuffer = NULL;
+    TLVReader stagedReader;
+
+    // Run the event writer before entering the critical section, so
+    // that concurrent producers only serialize on assigning the event
+    // ID and timestamps and on copying the pre-encoded data.  Events
+    // that are going to be discarded anyway are not staged.
+    if (inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId))
+    {
+        stagingBuffer = AcquireStagingBuffer();
+    }
+
+    if (stagingBuffer != NULL)
+    {
+        if (StageEventData(stagingBuffer, inEventWriter, inAppData, stagedReader) == WEAVE_NO_ERROR)
+        {
+            inEventWriter = CopyStagedEventData;
+            inAppData     = &stagedReader;
+            __sync_fetch_and_add(&mNumStagedEvents, 1);
+        }
+        else
+        {
+            // Fall back to writing the event under the critical section.
+            ReleaseStagingBuffer(stagingBuffer);
+            stagingBuffer = NULL;
+        }
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
 
     Platform::CriticalSectionEnter();
 
@@ -1092,74 +1433,204 @@ event_id_t LoggingManagement::LogEvent(const EventSchema & inSchema, EventWriter
 
     event_id = LogEventPrivate(inSchema, inEventWriter, inAppData, inOptions);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    archive = mArchive;
+#endif
+
 exit:
     Platform::CriticalSectionExit();
-    return event_id;
-}
-
-// Note: the function below must be called with the critical section
-// locked, and only when the logger is not shutting down
-
-inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
-                                                     const EventOptions * inOptions)
-{
-    event_id_t event_id = 0;
-    CircularTLVWriter writer;
-    WEAVE_ERROR err    = WEAVE_NO_ERROR;
-    size_t requestSize = WEAVE_CONFIG_EVENT_SIZE_RESERVE;
-    bool didWriteEvent = false;
-#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-    int32_t ev_opts_deltatime = 0;
-#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-    WeaveCircularTLVBuffer checkpoint = mEventBuffer->mBuffer;
-    EventLoadOutContext ctxt =
-        EventLoadOutContext(writer, inSchema.mImportance, GetImportanceBuffer(inSchema.mImportance)->mLastEventID, NULL);
-    EventOptions opts = EventOptions(static_cast<timestamp_t>(System::Timer::GetCurrentEpoch()));
-
-    // check whether the entry is to be logged or discarded silently
-    VerifyOrExit(inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId), /* no-op */);
 
-    // Create all event specific data
-    // Timestamp; encoded as a delta time
-    if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_System))
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    if (stagingBuffer != NULL)
     {
-#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-        ev_opts_deltatime = inOptions->timestamp.systemTimestamp - opts.timestamp.systemTimestamp;
-#endif
-        opts.timestamp.systemTimestamp = inOptions->timestamp.systemTimestamp;
+        ReleaseStagingBuffer(stagingBuffer);
     }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
 
-    if (GetImportanceBuffer(inSchema.mImportance)->mFirstEventTimestamp == 0)
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    // Evictions may have used up a spare archive segment or removed an
+    // old one; create and delete their files outside the lock.
+    if (archive != NULL)
     {
-        GetImportanceBuffer(inSchema.mImportance)->AddEvent(opts.timestamp.systemTimestamp);
+        archive->Maintain();
     }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
 
-#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
-    // UTC timestamp; encoded as a delta time
-    if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_UTC))
-    {
-        opts.timestamp.utcTimestamp = inOptions->timestamp.utcTimestamp;
-        opts.timestampType          = kTimestampType_UTC;
-    }
-    else
+    return event_id;
+}
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+/**
+ * @brief
+ *   Claim a free staging buffer without taking the critical section.
+ *
+ * @return A staging buffer, or NULL if all of them are in use.
+ */
+LoggingManagement::StagingBuffer * LoggingManagement::AcquireStagingBuffer(void)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS; i++)
     {
-        uint64_t utc_tmp;
-        err = System::Layer::GetClock_RealTimeMS(utc_tmp);
-        if ((err == WEAVE_NO_ERROR) && (utc_tmp != 0))
+        if (__sync_bool_compare_and_swap(&mStagingBuffers[i].mInUse, 0, 1))
         {
-            opts.timestamp.utcTimestamp = static_cast<utc_timestamp_t>(utc_tmp + ev_opts_deltatime);
-            opts.timestampType          = kTimestampType_UTC;
+            return &mStagingBuffers[i];
         }
     }
 
-    if ((opts.timestampType == kTimestampType_UTC) && (GetImportanceBuffer(inSchema.mImportance)->mFirstEventUTCTimestamp == 0))
-    {
-        GetImportanceBuffer(inSchema.mImportance)->AddEventUTC(opts.timestamp.utcTimestamp);
-    }
-#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    return NULL;
+}
 
-    if (inOptions != NULL)
-    {
+void LoggingManagement::ReleaseStagingBuffer(StagingBuffer * inBuffer)
+{
+    __sync_lock_release(&inBuffer->mInUse);
+}
+
+/**
+ * @brief
+ *   Get the number of events whose data was encoded in a staging
+ *   buffer, outside of the critical section.
+ *
+ * @return The count of staged events since initialization.
+ */
+uint32_t LoggingManagement::GetNumStagedEvents(void) const
+{
+    return mNumStagedEvents;
+}
+
+/**
+ * @brief
+ *   Run an event writer into a staging buffer and position a reader
+ *   over the result.
+ *
+ * @retval #WEAVE_NO_ERROR        On success.
+ * @retval other                  If the writer failed, including when
+ *                                the event data does not fit.
+ */
+WEAVE_ERROR LoggingManagement::StageEventData(StagingBuffer * inBuffer, EventWriterFunct inEventWriter, void * inAppData,
+                                              TLVReader & outReader)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVWriter writer;
+    TLVType container;
+
+    writer.Init(inBuffer->mData, sizeof(inBuffer->mData));
+
+    // Event writers emit context-tagged elements, which are only valid
+    // inside a container.
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, container);
+    SuccessOrExit(err);
+
+    err = inEventWriter(writer, kTag_EventData, inAppData);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(container);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    outReader.Init(inBuffer->mData, writer.GetLengthWritten());
+
+    err = outReader.Next();
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   An EventWriterFunct that copies the elements of a staged event
+ *   into the event being logged.
+ */
+WEAVE_ERROR LoggingManagement::CopyStagedEventData(TLVWriter & ioWriter, uint8_t inDataTag, void * inAppData)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    // Work on a copy, since a retry with a larger reservation copies the data again.
+    TLVReader reader = *static_cast<TLVReader *>(inAppData);
+    TLVType container;
+
+    err = reader.EnterContainer(container);
+    SuccessOrExit(err);
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        err = ioWriter.CopyElement(reader);
+        SuccessOrExit(err);
+    }
+
+    if (err == WEAVE_END_OF_TLV)
+    {
+        err = WEAVE_NO_ERROR;
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
+
+// Note: the function below must be called with the critical section
+// locked, and only when the logger is not shutting down
+
+inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
+                                                     const EventOptions * inOptions)
+{
+    event_id_t event_id = 0;
+    CircularTLVWriter writer;
+    WEAVE_ERROR err    = WEAVE_NO_ERROR;
+    size_t requestSize = WEAVE_CONFIG_EVENT_SIZE_RESERVE;
+    bool didWriteEvent = false;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    int32_t ev_opts_deltatime = 0;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    WeaveCircularTLVBuffer checkpoint = mEventBuffer->mBuffer;
+    EventLoadOutContext ctxt =
+        EventLoadOutContext(writer, inSchema.mImportance, GetImportanceBuffer(inSchema.mImportance)->mLastEventID, NULL);
+    EventOptions opts = EventOptions(static_cast<timestamp_t>(System::Timer::GetCurrentEpoch()));
+
+    // check whether the entry is to be logged or discarded silently
+    VerifyOrExit(inSchema.mImportance <= GetCurrentImportance(inSchema.mProfileId), /* no-op */);
+
+    // Create all event specific data
+    // Timestamp; encoded as a delta time
+    if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_System))
+    {
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        ev_opts_deltatime = inOptions->timestamp.systemTimestamp - opts.timestamp.systemTimestamp;
+#endif
+        opts.timestamp.systemTimestamp = inOptions->timestamp.systemTimestamp;
+    }
+
+    if (GetImportanceBuffer(inSchema.mImportance)->mFirstEventTimestamp == 0)
+    {
+        GetImportanceBuffer(inSchema.mImportance)->AddEvent(opts.timestamp.systemTimestamp);
+    }
+
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    // UTC timestamp; encoded as a delta time
+    if ((inOptions != NULL) && (inOptions->timestampType == kTimestampType_UTC))
+    {
+        opts.timestamp.utcTimestamp = inOptions->timestamp.utcTimestamp;
+        opts.timestampType          = kTimestampType_UTC;
+    }
+    else
+    {
+        uint64_t utc_tmp;
+        err = System::Layer::GetClock_RealTimeMS(utc_tmp);
+        if ((err == WEAVE_NO_ERROR) && (utc_tmp != 0))
+        {
+            opts.timestamp.utcTimestamp = static_cast<utc_timestamp_t>(utc_tmp + ev_opts_deltatime);
+            opts.timestampType          = kTimestampType_UTC;
+        }
+    }
+
+    if ((opts.timestampType == kTimestampType_UTC) && (GetImportanceBuffer(inSchema.mImportance)->mFirstEventUTCTimestamp == 0))
+    {
+        GetImportanceBuffer(inSchema.mImportance)->AddEventUTC(opts.timestamp.utcTimestamp);
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+    if (inOptions != NULL)
+    {
         opts.eventSource       = inOptions->eventSource;
         opts.relatedEventID    = inOptions->relatedEventID;
         opts.relatedImportance = inOptions->relatedImportance;
@@ -1193,7 +1664,11 @@ inline event_id_t LoggingManagement::LogEventPrivate(const EventSchema & inSchem
         // Start the event container (anonymous structure) in the circular buffer
         writer.Init(&(mEventBuffer->mBuffer));
 
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+        err = BlitCompactEvent(&ctxt, inSchema, inEventWriter, inAppData, &opts);
+#else
         err = BlitEvent(&ctxt, inSchema, inEventWriter, inAppData, &opts);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
 
         if (err == WEAVE_ERROR_NO_MEMORY)
         {
@@ -1256,6 +1731,17 @@ exit:
 #endif // WEAVE_CONFIG_EVENT_LOGGING_VERBOSE_DEBUG_LOGS
         }
 
+#if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
+        {
+            SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
+
+            if (subEngine != NULL)
+            {
+                subEngine->GetNotificationEngine()->OnEventLogged();
+            }
+        }
+#endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
+
         ScheduleFlushIfNeeded(inOptions == NULL ? false : inOptions->urgent);
     }
 
@@ -1429,6 +1915,15 @@ WEAVE_ERROR LoggingManagement::CopyEventsSince(const TLVReader & aReader, size_t
     nl::Weave::TLV::TLVWriter checkpoint;
     EventLoadOutContext * loadOutContext = static_cast<EventLoadOutContext *>(aContext);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    // Until the first event is copied out, the context holds the
+    // state of a plain scan and can be recorded as a checkpoint
+    if (loadOutContext->mFirst)
+    {
+        static_cast<IndexedLoadOutContext *>(loadOutContext)->mIndex->Add(aReader, *loadOutContext);
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+
     err = EventIterator(aReader, aDepth, aContext);
     if (err == WEAVE_EVENT_ID_FOUND)
     {
@@ -1492,11 +1987,18 @@ WEAVE_ERROR LoggingManagement::FetchEventsSince(TLVWriter & ioWriter, Importance
 
 #if WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
     ExternalEvents ev;
-    EventLoadOutContext aContext(ioWriter, inImportance, ioEventID, &ev);
+    ExternalEvents * externalEvents = &ev;
 #else
-    EventLoadOutContext aContext(ioWriter, inImportance, ioEventID, NULL);
+    ExternalEvents * externalEvents = NULL;
 #endif // WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    IndexedLoadOutContext aContext(ioWriter, inImportance, ioEventID, externalEvents,
+                                   &mEventIndex[inImportance - kImportanceType_First]);
+#else
+    EventLoadOutContext aContext(ioWriter, inImportance, ioEventID, externalEvents);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+
     CircularEventBuffer * buf = mEventBuffer;
     Platform::CriticalSectionEnter();
 
@@ -1510,10 +2012,26 @@ WEAVE_ERROR LoggingManagement::FetchEventsSince(TLVWriter & ioWriter, Importance
     aContext.mCurrentUTCTime = buf->mFirstEventUTCTimestamp;
 #endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
     aContext.mCurrentEventID = buf->mFirstEventID;
-    err                      = GetEventReader(reader, inImportance);
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    // Events older than the in-memory log may still be in the archive
+    if ((mArchive != NULL) && (ioEventID < buf->mFirstEventID))
+    {
+        err = mArchive->FetchEventsSince(ioWriter, inImportance, ioEventID);
+        VerifyOrExit(err == WEAVE_END_OF_TLV, aContext.mCurrentEventID = ioEventID);
+
+        aContext.mStartingEventID = ioEventID;
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
+    err = GetEventReader(reader, inImportance);
     SuccessOrExit(err);
 
-    err = nl::Weave::TLV::Utilities::Iterate(reader, CopyEventsSince, &aContext, recurse);
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    SeekEventReader(reader, aContext);
+#endif
+
+    err = nl::Weave::TLV::Utilities::Iterate(reader, CopyEventsSince, static_cast<EventLoadOutContext *>(&aContext), recurse);
 
 #if WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
     if ((err == WEAVE_END_OF_TLV) && (ev.IsValid()))
@@ -1572,6 +2090,146 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+
+/**
+ * @brief
+ *   Move a reader obtained from #GetEventReader forward to the
+ *   closest indexed checkpoint preceding the starting event ID of the
+ *   scan.
+ *
+ * @param[inout] ioReader  The reader positioned at the oldest event of
+ *                         the importance being scanned.
+ *
+ * @param[inout] ioContext The context of the scan, initialized with the
+ *                         state of the oldest event.  When a usable
+ *                         checkpoint exists, the context is updated
+ *                         with the state recorded at the checkpoint.
+ */
+void LoggingManagement::SeekEventReader(TLVReader & ioReader, EventLoadOutContext & ioContext) const
+{
+    const EventIndexEntry * entry = mEventIndex[ioContext.mImportance - kImportanceType_First].Find(ioContext.mStartingEventID);
+    CircularEventReader reader;
+
+    VerifyOrExit(entry != NULL && entry->mEventID > ioContext.mCurrentEventID, );
+
+    reader.Init(entry->mBuffer, entry->mReadPoint);
+    ioReader.Init(reader);
+
+    ioContext.mCurrentEventID = entry->mEventID;
+    ioContext.mCurrentTime    = entry->mTime;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    ioContext.mCurrentUTCTime = entry->mUTCTime;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+exit:
+    return;
+}
+
+bool EventIndexEntry::IsValid(void) const
+{
+    // The element is gone once the buffer has evicted past it,
+    // whether it was dropped or moved on to the next buffer.
+    return static_cast<int32_t>(mStreamOffset - mBuffer->mBytesEvicted) >= 0;
+}
+
+void EventIndex::Reset(void)
+{
+    mNumEntries = 0;
+}
+
+/**
+ * @brief
+ *   Find the checkpoint to resume a scan for the specified event from.
+ *
+ * @param[in] inEventID The ID of the event the scan looks for.
+ *
+ * @return The valid checkpoint with the largest event ID not exceeding
+ *         \c inEventID, or NULL if there is none.
+ */
+const EventIndexEntry * EventIndex::Find(event_id_t inEventID) const
+{
+    const EventIndexEntry * retval = NULL;
+    size_t i;
+
+    for (i = mNumEntries; i > 0; i--)
+    {
+        if (mEntries[i - 1].mEventID <= inEventID && mEntries[i - 1].IsValid())
+        {
+            retval = &mEntries[i - 1];
+            break;
+        }
+    }
+
+    return retval;
+}
+
+/**
+ * @brief
+ *   Record the state of a scan positioned on a top-level element.
+ *
+ * A checkpoint is only recorded when at least
+ * #WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL events separate it from
+ * the previous one.  When the index is full, the oldest checkpoint is
+ * dropped.
+ *
+ * @param[in] inReader  A reader positioned on a top-level element of
+ *                      the event log, as obtained from
+ *                      #LoggingManagement::GetEventReader.
+ *
+ * @param[in] inContext The state of the scan before the element is
+ *                      processed.
+ */
+void EventIndex::Add(const TLVReader & inReader, const EventLoadOutContext & inContext)
+{
+    CircularEventBuffer * buffer = reinterpret_cast<CircularEventBuffer *>(inReader.GetBufHandle());
+    EventIndexEntry * entry;
+    size_t i, j;
+
+    // Events are anonymous structures, so the read point is just
+    // past the single control byte of the element.
+    VerifyOrExit(buffer != NULL && inReader.GetType() == kTLVType_Structure && inReader.GetTag() == AnonymousTag, );
+
+    for (i = 0, j = 0; i < mNumEntries; i++)
+    {
+        if (mEntries[i].IsValid())
+        {
+            mEntries[j++] = mEntries[i];
+        }
+    }
+    mNumEntries = j;
+
+    VerifyOrExit(mNumEntries == 0 ||
+                     inContext.mCurrentEventID >= mEntries[mNumEntries - 1].mEventID + WEAVE_CONFIG_EVENT_LOGGING_INDEX_INTERVAL, );
+
+    if (mNumEntries == WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE)
+    {
+        memmove(&mEntries[0], &mEntries[1], (mNumEntries - 1) * sizeof(EventIndexEntry));
+        mNumEntries--;
+    }
+
+    entry                = &mEntries[mNumEntries++];
+    entry->mBuffer       = buffer;
+    entry->mReadPoint    = inReader.GetReadPoint() - 1;
+    entry->mStreamOffset = buffer->GetStreamOffset(entry->mReadPoint);
+    entry->mEventID      = inContext.mCurrentEventID;
+    entry->mTime         = inContext.mCurrentTime;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    entry->mUTCTime = inContext.mCurrentUTCTime;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+exit:
+    return;
+}
+
+IndexedLoadOutContext::IndexedLoadOutContext(TLVWriter & inWriter, ImportanceType inImportance, uint32_t inStartingEventID,
+                                             ExternalEvents * ioExternalEvents, EventIndex * inIndex) :
+    EventLoadOutContext(inWriter, inImportance, inStartingEventID, ioExternalEvents),
+    mIndex(inIndex)
+{ }
+
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+
 // internal API
 WEAVE_ERROR LoggingManagement::FetchEventParameters(const TLVReader & aReader, size_t aDepth, void * aContext)
 {
@@ -1590,6 +2248,31 @@ WEAVE_ERROR LoggingManagement::FetchEventParameters(const TLVReader & aReader, s
         envelope->mNumFieldsToRead--;
     }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    if (reader.GetTag() == nl::Weave::TLV::ContextTag(kTag_EventCompactEnvelope))
+    {
+        CompactEventEnvelope compact;
+
+        err = ReadCompactEnvelope(reader, compact);
+        SuccessOrExit(err);
+
+        envelope->mImportance = compact.mImportance;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        if (compact.mUTCDelta)
+        {
+            envelope->mDeltaUtc = compact.mDeltaTime;
+        }
+        else
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+        {
+            envelope->mDeltaTime = static_cast<int32_t>(compact.mDeltaTime);
+        }
+
+        // The envelope holds both the importance and the delta time
+        envelope->mNumFieldsToRead = 0;
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
     if (reader.GetTag() == nl::Weave::TLV::ContextTag(kTag_EventImportance))
     {
         err = reader.Get(extImportance);
@@ -1632,6 +2315,9 @@ WEAVE_ERROR LoggingManagement::EvictEvent(WeaveCircularTLVBuffer & inBuffer, voi
     const bool recurse = false;
     WEAVE_ERROR err;
     ImportanceType imp = kImportanceType_Invalid;
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    TLVReader eventReader;
+#endif
 
 #if WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
     ExternalEvents ev;
@@ -1646,6 +2332,10 @@ WEAVE_ERROR LoggingManagement::EvictEvent(WeaveCircularTLVBuffer & inBuffer, voi
     err = inReader.Next();
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    eventReader.Init(inReader);
+#endif
+
     err = inReader.EnterContainer(containerType);
     SuccessOrExit(err);
 
@@ -1674,6 +2364,19 @@ WEAVE_ERROR LoggingManagement::EvictEvent(WeaveCircularTLVBuffer & inBuffer, voi
         }
 #endif // WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
 
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+#if WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
+        if ((ctx->mArchive != NULL) && !ev.IsValid())
+#else
+        if (ctx->mArchive != NULL)
+#endif // WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
+        {
+            // A failure to archive must not stall logging; the event
+            // is dropped as it would be without an archive.
+            ArchiveEvent(ctx->mArchive, eventReader, imp, eventBuffer, context);
+        }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
         eventBuffer->RemoveEvent(numEventsToDrop);
         eventBuffer->mFirstEventTimestamp += context.mDeltaTime;
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
@@ -1692,6 +2395,65 @@ exit:
     return err;
 }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+/**
+ * @brief
+ *   Append an event about to be dropped from its final buffer to the archive.
+ *
+ * The event is stored self-contained, with its event ID and absolute
+ * timestamps, reconstructed from the state of the buffer it is being
+ * dropped from.
+ */
+WEAVE_ERROR LoggingManagement::ArchiveEvent(EventLogArchive * inArchive, const TLVReader & inReader, ImportanceType inImportance,
+                                            const CircularEventBuffer * inEventBuffer, const EventEnvelopeContext & inContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVWriter writer;
+    EventLoadOutContext context(writer, inImportance, inEventBuffer->mFirstEventID, NULL);
+
+    context.mCurrentEventID = inEventBuffer->mFirstEventID;
+    context.mCurrentTime    = inEventBuffer->mFirstEventTimestamp + inContext.mDeltaTime;
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    context.mCurrentUTCTime = inEventBuffer->mFirstEventUTCTimestamp + inContext.mDeltaUtc;
+#endif // WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+
+    // Leave room for the absolute timestamps and the event ID, which
+    // replace the shorter deltas of the buffered event.
+    err = inArchive->BeginAppend(inImportance, inReader.GetLengthRead() + EVENT_ARCHIVE_ENVELOPE_OVERHEAD, writer);
+    SuccessOrExit(err);
+
+    err = CopyEvent(inReader, writer, &context);
+    SuccessOrExit(err);
+
+    err = inArchive->CommitAppend(inImportance, inEventBuffer->mFirstEventID, writer);
+    SuccessOrExit(err);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        WeaveLogError(EventLogging, "Failed to archive event 0x%" PRIx32 ": %s", inEventBuffer->mFirstEventID, ErrorStr(err));
+    }
+    return err;
+}
+
+/**
+ * @brief
+ *   Attach an archive for events evicted from the in-memory log.
+ *
+ * Once attached, events dropped from their final buffer are appended
+ * to the archive, and FetchEventsSince() serves events older than the
+ * in-memory log from it.  Pass NULL to detach the archive.
+ *
+ * @param[in] inArchive An initialized archive, or NULL.
+ */
+void LoggingManagement::SetArchive(EventLogArchive * inArchive)
+{
+    Platform::CriticalSectionEnter();
+    mArchive = inArchive;
+    Platform::CriticalSectionExit();
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
 // Notes: called as a result of the timer expiration.  Main job:
 // figure out whether trigger still applies, if it does, then kick off
 // the upload.  If it does not, perform the appropriate backoff.
@@ -2010,6 +2772,10 @@ WEAVE_ERROR LoggingManagement::GetExternalEventsFromEventId(ImportanceType inImp
     err                      = GetEventReader(outReader, inImportance);
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    SeekEventReader(outReader, aContext);
+#endif
+
     err = nl::Weave::TLV::Utilities::Find(outReader, FindExternalEvents, &aContext, resultReader, recurse);
     if (err == WEAVE_NO_ERROR)
         outReader.Init(resultReader);
@@ -2050,7 +2816,7 @@ void LoggingManagement::SetBDXUploader(LogBDXUpload * inUploader)
  */
 CircularEventBuffer::CircularEventBuffer(uint8_t * inBuffer, size_t inBufferLength, CircularEventBuffer * inPrev,
                                          CircularEventBuffer * inNext) :
-    mBuffer(inBuffer, inBufferLength),
+    mBuffer(inBuffer, inBufferLength), mBytesEvicted(0),
     mPrev(inPrev), mNext(inNext), mImportance(kImportanceType_First), mFirstEventID(1), mLastEventID(0), mFirstEventTimestamp(0),
     mLastEventTimestamp(0),
 #if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
@@ -2120,6 +2886,56 @@ void CircularEventBuffer::RemoveEvent(size_t aNumEvents)
     mFirstEventID += aNumEvents;
 }
 
+/**
+ * @brief
+ *   Evict the oldest element from the underlying buffer, keeping
+ *   track of the number of bytes evicted.
+ *
+ * @retval #WEAVE_NO_ERROR On success.
+ * @retval other           The error returned by
+ *                         WeaveCircularTLVBuffer::EvictHead; the
+ *                         buffer is unchanged.
+ */
+WEAVE_ERROR CircularEventBuffer::EvictHead(void)
+{
+    size_t dataLength = mBuffer.DataLength();
+    WEAVE_ERROR err;
+
+    err = mBuffer.EvictHead();
+    SuccessOrExit(err);
+
+    mBytesEvicted += dataLength - mBuffer.DataLength();
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Compute the position of an element among all the bytes ever
+ *   written to this buffer.
+ *
+ * The element stays in the buffer for as long as the returned offset
+ * is not less than #mBytesEvicted.
+ *
+ * @param[in] inReadPoint A pointer to the start of an element
+ *                        currently stored in the buffer.
+ *
+ * @return The offset of the element.
+ */
+uint32_t CircularEventBuffer::GetStreamOffset(const uint8_t * inReadPoint) const
+{
+    const uint8_t * head = mBuffer.QueueHead();
+    size_t size          = mBuffer.GetQueueSize();
+
+    if (head == mBuffer.GetQueue() + size)
+    {
+        head = mBuffer.GetQueue();
+    }
+
+    return mBytesEvicted + static_cast<uint32_t>((static_cast<size_t>(inReadPoint - head) + size) % size);
+}
+
 /**
  * @brief
  *   Initializes a TLVReader object backed by CircularEventBuffer
@@ -2146,6 +2962,31 @@ void CircularEventReader::Init(CircularEventBuffer * inBuf)
     }
 }
 
+/**
+ * @brief
+ *   Initializes a TLVReader object backed by CircularEventBuffer,
+ *   positioned on an element in the middle of the buffer.
+ *
+ * @param[in] inBuf       A pointer to a fully initialized CircularEventBuffer
+ *
+ * @param[in] inReadPoint A pointer to the start of a top-level element
+ *                        currently stored in \c inBuf.
+ *
+ */
+void CircularEventReader::Init(CircularEventBuffer * inBuf, const uint8_t * inReadPoint)
+{
+    const uint8_t * tail = inBuf->mBuffer.QueueTail();
+
+    Init(inBuf);
+
+    // Skip the data ahead of the element; when the element sits in
+    // the wrapped-around part of the queue, the first segment extends
+    // to the end of the storage.
+    mMaxLen -= inBuf->GetStreamOffset(inReadPoint) - inBuf->mBytesEvicted;
+    mReadPoint = inReadPoint;
+    mBufEnd    = (tail <= inReadPoint) ? inBuf->mBuffer.GetQueue() + inBuf->mBuffer.GetQueueSize() : tail;
+}
+
 WEAVE_ERROR CircularEventBuffer::GetNextBufferFunct(TLVReader & ioReader, uintptr_t & inBufHandle, const uint8_t *& outBufStart,
                                                     uint32_t & outBufLen)
 {
@@ -2174,6 +3015,215 @@ CopyAndAdjustDeltaTimeContext::CopyAndAdjustDeltaTimeContext(TLVWriter * inWrite
     mWriter(inWriter), mContext(inContext)
 { }
 
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
+// Layout of the compact envelope: a flags byte, the zigzag-encoded
+// delta time, the event source (as an index into the event source
+// table, or in full), the schema versions if not 1, the event type
+// and the related event.  Integers other than the resource ID are
+// unsigned LEB128 varints.
+
+enum
+{
+    kCompactFlag_ImportanceMask = 0x07,
+    kCompactFlag_UTCDelta       = 0x08,
+    kCompactFlag_SourceIndex    = 0x10,
+    kCompactFlag_Resource       = 0x20,
+    kCompactFlag_SchemaVersions = 0x40,
+    kCompactFlag_RelatedEvent   = 0x80,
+};
+
+static uint8_t * PutVarint(uint8_t * p, uint64_t inValue)
+{
+    while (inValue >= 0x80)
+    {
+        *p++ = static_cast<uint8_t>(inValue | 0x80);
+        inValue >>= 7;
+    }
+    *p++ = static_cast<uint8_t>(inValue);
+    return p;
+}
+
+static bool GetVarint(const uint8_t *& p, const uint8_t * inEnd, uint64_t & outValue)
+{
+    outValue = 0;
+
+    for (unsigned shift = 0; (p < inEnd) && (shift < 64); shift += 7)
+    {
+        uint8_t byte = *p++;
+
+        outValue |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CompactEventSource::operator==(const CompactEventSource & inOther) const
+{
+    return (mProfileId == inOther.mProfileId) && (mHasResource == inOther.mHasResource) &&
+        (!mHasResource ||
+         ((mResourceType == inOther.mResourceType) && (mResourceId == inOther.mResourceId) &&
+          (mTraitInstanceID == inOther.mTraitInstanceID)));
+}
+
+/**
+ * @brief
+ *   Encode the envelope.
+ *
+ * @param[out] outBuf        The buffer to encode into.
+ * @param[in]  inBufSize     The size of outBuf; kMaxEncodedLength always suffices.
+ * @param[out] outLength     The length of the encoding.
+ * @param[in]  inSourceIndex The index of mSource in the event source table, or -1.
+ */
+WEAVE_ERROR CompactEventEnvelope::Encode(uint8_t * outBuf, size_t inBufSize, size_t & outLength, int inSourceIndex) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t buf[kMaxEncodedLength];
+    uint8_t * p            = buf;
+    uint8_t flags          = static_cast<uint8_t>(mImportance) & kCompactFlag_ImportanceMask;
+    const bool hasVersions = (mDataSchemaVersion != 1) || (mMinCompatibleDataSchemaVersion != 1);
+
+    flags |= mUTCDelta ? kCompactFlag_UTCDelta : 0;
+    flags |= (inSourceIndex >= 0) ? kCompactFlag_SourceIndex : 0;
+    flags |= mSource.mHasResource ? kCompactFlag_Resource : 0;
+    flags |= hasVersions ? kCompactFlag_SchemaVersions : 0;
+    flags |= mHasRelatedEvent ? kCompactFlag_RelatedEvent : 0;
+
+    *p++ = flags;
+    p    = PutVarint(p, (static_cast<uint64_t>(mDeltaTime) << 1) ^ static_cast<uint64_t>(mDeltaTime >> 63));
+
+    if (inSourceIndex >= 0)
+    {
+        p = PutVarint(p, static_cast<uint64_t>(inSourceIndex));
+    }
+    else
+    {
+        p = PutVarint(p, mSource.mProfileId);
+        if (mSource.mHasResource)
+        {
+            // Resource IDs are mostly random 64-bit values, which a
+            // varint would only make longer
+            p = PutVarint(p, mSource.mResourceType);
+            nl::Weave::Encoding::LittleEndian::Put64(p, mSource.mResourceId);
+            p += sizeof(uint64_t);
+            p = PutVarint(p, mSource.mTraitInstanceID);
+        }
+    }
+
+    if (hasVersions)
+    {
+        p = PutVarint(p, mDataSchemaVersion);
+        p = PutVarint(p, mMinCompatibleDataSchemaVersion);
+    }
+
+    p = PutVarint(p, mEventType);
+
+    if (mHasRelatedEvent)
+    {
+        p = PutVarint(p, mRelatedImportance);
+        p = PutVarint(p, mRelatedEventID);
+    }
+
+    outLength = static_cast<size_t>(p - buf);
+    VerifyOrExit(outLength <= inBufSize, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(outBuf, buf, outLength);
+
+exit:
+    return err;
+}
+
+/**
+ * @brief
+ *   Decode an envelope produced by Encode().
+ *
+ * @param[in] inBuf        The encoded envelope.
+ * @param[in] inLength     The length of the encoded envelope.
+ * @param[in] inSources    The event source table.
+ * @param[in] inNumSources The number of entries in inSources.
+ *
+ * @retval #WEAVE_NO_ERROR                  On success.
+ * @retval #WEAVE_ERROR_INVALID_TLV_ELEMENT The envelope is malformed.
+ */
+WEAVE_ERROR CompactEventEnvelope::Decode(const uint8_t * inBuf, size_t inLength, const CompactEventSource * inSources,
+                                         size_t inNumSources)
+{
+    WEAVE_ERROR err     = WEAVE_NO_ERROR;
+    const uint8_t * p   = inBuf;
+    const uint8_t * end = inBuf + inLength;
+    uint64_t value;
+    uint8_t flags;
+
+    VerifyOrExit(p < end, err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+    flags = *p++;
+
+    mImportance = static_cast<ImportanceType>(flags & kCompactFlag_ImportanceMask);
+    mUTCDelta   = (flags & kCompactFlag_UTCDelta) != 0;
+
+    VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+    mDeltaTime = static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+
+    if (flags & kCompactFlag_SourceIndex)
+    {
+        VerifyOrExit(GetVarint(p, end, value) && value < inNumSources, err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mSource = inSources[value];
+    }
+    else
+    {
+        VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mSource.mProfileId       = static_cast<uint32_t>(value);
+        mSource.mHasResource     = (flags & kCompactFlag_Resource) != 0;
+        mSource.mResourceType    = 0;
+        mSource.mResourceId      = 0;
+        mSource.mTraitInstanceID = 0;
+
+        if (mSource.mHasResource)
+        {
+            VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+            mSource.mResourceType = static_cast<uint16_t>(value);
+
+            VerifyOrExit(end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t)), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+            mSource.mResourceId = nl::Weave::Encoding::LittleEndian::Get64(p);
+            p += sizeof(uint64_t);
+
+            VerifyOrExit(GetVarint(p, end, mSource.mTraitInstanceID), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        }
+    }
+
+    mDataSchemaVersion              = 1;
+    mMinCompatibleDataSchemaVersion = 1;
+    if (flags & kCompactFlag_SchemaVersions)
+    {
+        VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mDataSchemaVersion = static_cast<SchemaVersion>(value);
+        VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mMinCompatibleDataSchemaVersion = static_cast<SchemaVersion>(value);
+    }
+
+    VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+    mEventType = static_cast<uint32_t>(value);
+
+    mHasRelatedEvent   = (flags & kCompactFlag_RelatedEvent) != 0;
+    mRelatedImportance = 0;
+    mRelatedEventID    = 0;
+    if (mHasRelatedEvent)
+    {
+        VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mRelatedImportance = static_cast<uint16_t>(value);
+        VerifyOrExit(GetVarint(p, end, value), err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        mRelatedEventID = static_cast<event_id_t>(value);
+    }
+
+exit:
+    return err;
+}
+
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
 EventEnvelopeContext::EventEnvelopeContext(void) :
     mNumFieldsToRead(2), // read out importance and either system or utc delta time. events do not store both deltas.
     mDeltaTime(0),
@@ -55,6 +55,12 @@ struct CircularEventBuffer
     event_id_t VendEventID(void);
     void RemoveEvent(size_t aNumEvents);
 
+    // for doxygen, see the CPP file
+    WEAVE_ERROR EvictHead(void);
+
+    // for doxygen, see the CPP file
+    uint32_t GetStreamOffset(const uint8_t * inReadPoint) const;
+
     // for doxygen, see the CPP file
     void AddEvent(timestamp_t inEventTimestamp);
 
@@ -65,6 +71,8 @@ struct CircularEventBuffer
 
     nl::Weave::TLV::WeaveCircularTLVBuffer mBuffer; ///< The underlying TLV buffer storing the events in a TLV representation
 
+    uint32_t mBytesEvicted; ///< The number of bytes evicted from the head of mBuffer since initialization
+
     CircularEventBuffer * mPrev; ///< A pointer #CircularEventBuffer storing events less important events
     CircularEventBuffer * mNext; ///< A pointer #CircularEventBuffer storing events more important events
 
@@ -104,6 +112,7 @@ class CircularEventReader : public nl::Weave::TLV::TLVReader
 
 public:
     void Init(CircularEventBuffer * inBuf);
+    void Init(CircularEventBuffer * inBuf, const uint8_t * inReadPoint);
 };
 
 /**
@@ -135,6 +144,96 @@ struct EventEnvelopeContext
     ExternalEvents * mExternalEvents;
 };
 
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+/**
+ * @brief
+ *  Internal structure identifying where an event comes from; the
+ *  compact event encoding refers to these by index.
+ */
+struct CompactEventSource
+{
+    bool operator==(const CompactEventSource & inOther) const;
+
+    uint32_t mProfileId;
+    bool mHasResource;
+    uint16_t mResourceType;
+    uint64_t mResourceId;
+    uint64_t mTraitInstanceID;
+};
+
+/**
+ * @brief
+ *  Internal structure holding the metadata of an event stored in the compact encoding.
+ */
+struct CompactEventEnvelope
+{
+    WEAVE_ERROR Encode(uint8_t * outBuf, size_t inBufSize, size_t & outLength, int inSourceIndex) const;
+    WEAVE_ERROR Decode(const uint8_t * inBuf, size_t inLength, const CompactEventSource * inSources, size_t inNumSources);
+
+    enum
+    {
+        kMaxEncodedLength = 64, ///< Upper bound on the size of an encoded envelope
+    };
+
+    ImportanceType mImportance;
+    bool mUTCDelta;             ///< mDeltaTime is the delta of the UTC rather than the system timestamp
+    int64_t mDeltaTime;
+    CompactEventSource mSource;
+    SchemaVersion mDataSchemaVersion;
+    SchemaVersion mMinCompatibleDataSchemaVersion;
+    uint32_t mEventType;
+    bool mHasRelatedEvent;
+    uint16_t mRelatedImportance;
+    event_id_t mRelatedEventID;
+};
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+/**
+ * @brief
+ *  Internal structure recording a point from which a scan of the event log can resume.
+ */
+struct EventIndexEntry
+{
+    bool IsValid(void) const;
+
+    CircularEventBuffer * mBuffer; ///< The buffer holding the top-level element
+    const uint8_t * mReadPoint;    ///< The start of the element within mBuffer
+    uint32_t mStreamOffset;        ///< The offset of the element among all bytes ever written to mBuffer
+    event_id_t mEventID;           ///< The ID the scan assigns to the next event of the indexed importance
+    timestamp_t mTime;             ///< The system time accumulated by the scan up to the element
+#if WEAVE_CONFIG_EVENT_LOGGING_UTC_TIMESTAMPS
+    utc_timestamp_t mUTCTime; ///< The UTC time accumulated by the scan up to the element
+#endif
+};
+
+/**
+ * @brief
+ *  Internal structure holding the checkpoints of a single importance, in increasing event ID order.
+ */
+struct EventIndex
+{
+    void Reset(void);
+    const EventIndexEntry * Find(event_id_t inEventID) const;
+    void Add(const nl::Weave::TLV::TLVReader & inReader, const EventLoadOutContext & inContext);
+
+    EventIndexEntry mEntries[WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE];
+    size_t mNumEntries;
+};
+
+/**
+ * @brief
+ *  Internal structure for event log scans that populate an #EventIndex.
+ */
+struct IndexedLoadOutContext : public EventLoadOutContext
+{
+    IndexedLoadOutContext(nl::Weave::TLV::TLVWriter & inWriter, ImportanceType inImportance, uint32_t inStartingEventID,
+                          ExternalEvents * ioExternalEvents, EventIndex * inIndex);
+
+    EventIndex * mIndex;
+};
+#endif // WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE
+
 enum LoggingManagementStates
 {
     kLoggingManagementState_Idle       = 1, ///< No log offload in progress, log offload can begin without any constraints
@@ -145,6 +244,7 @@ enum LoggingManagementStates
 
 // forward class declaration
 class LogBDXUpload;
+class EventLogArchive;
 
 /**
  * @brief
@@ -226,6 +326,14 @@ public:
 
     void SetBDXUploader(LogBDXUpload * inUploader);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    void SetArchive(EventLogArchive * inArchive);
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    uint32_t GetNumStagedEvents(void) const;
+#endif
+
 #if WEAVE_CONFIG_EVENT_LOGGING_EXTERNAL_EVENT_SUPPORT
     WEAVE_ERROR RegisterEventCallbackForImportance(ImportanceType inImportance, FetchExternalEventsFunct inFetchCallback,
                                                    NotifyExternalEventsDeliveredFunct inNotifyCallback,
@@ -249,6 +357,32 @@ private:
     event_id_t LogEventPrivate(const EventSchema & inSchema, EventWriterFunct inEventWriter, void * inAppData,
                                const EventOptions * inOptions);
 
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    struct StagingBuffer
+    {
+        uint32_t mInUse;
+        uint8_t mData[WEAVE_CONFIG_EVENT_LOGGING_STAGING_BUFFER_SIZE];
+    };
+
+    StagingBuffer * AcquireStagingBuffer(void);
+    void ReleaseStagingBuffer(StagingBuffer * inBuffer);
+    static WEAVE_ERROR StageEventData(StagingBuffer * inBuffer, EventWriterFunct inEventWriter, void * inAppData,
+                                      nl::Weave::TLV::TLVReader & outReader);
+    static WEAVE_ERROR CopyStagedEventData(nl::Weave::TLV::TLVWriter & ioWriter, uint8_t inDataTag, void * inAppData);
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
+
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    void SeekEventReader(nl::Weave::TLV::TLVReader & ioReader, EventLoadOutContext & ioContext) const;
+#endif
+
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    WEAVE_ERROR BlitCompactEvent(EventLoadOutContext * aContext, const EventSchema & inSchema, EventWriterFunct inEventWriter,
+                                 void * inAppData, const EventOptions * inOptions);
+    int FindEventSource(const CompactEventSource & inSource);
+    static WEAVE_ERROR ReadCompactEnvelope(const nl::Weave::TLV::TLVReader & aReader, CompactEventEnvelope & outEnvelope);
+    static WEAVE_ERROR ExpandCompactEnvelope(const nl::Weave::TLV::TLVReader & aReader, CopyAndAdjustDeltaTimeContext * aContext);
+#endif
+
     void FlushHandler(System::Layer * inSystemLayer, INET_ERROR inErr);
     void SignalUploadDone(void);
     WEAVE_ERROR CopyToNextBuffer(CircularEventBuffer * inEventBuffer);
@@ -264,6 +398,11 @@ private:
                                   nl::Weave::TLV::TLVReader & inReader);
     static WEAVE_ERROR CopyEvent(const nl::Weave::TLV::TLVReader & aReader, nl::Weave::TLV::TLVWriter & aWriter,
                                  EventLoadOutContext * aContext);
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    static WEAVE_ERROR ArchiveEvent(EventLogArchive * inArchive, const nl::Weave::TLV::TLVReader & inReader,
+                                    ImportanceType inImportance, const CircularEventBuffer * inEventBuffer,
+                                    const EventEnvelopeContext & inContext);
+#endif
 
     static void LoggingFlushHandler(System::Layer * systemLayer, void * appState, INET_ERROR err);
 
@@ -292,6 +431,20 @@ private:
     uint32_t mThrottled;
     ImportanceType mMaxImportanceBuffer;
     bool mUploadRequested;
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    StagingBuffer mStagingBuffers[WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS];
+    uint32_t mNumStagedEvents;
+#endif
+#if WEAVE_CONFIG_EVENT_LOGGING_INDEX_SIZE > 0
+    EventIndex mEventIndex[kImportanceType_Last - kImportanceType_First + 1];
+#endif
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    EventLogArchive * mArchive;
+#endif
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    CompactEventSource mEventSources[WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES];
+    size_t mNumEventSources;
+#endif
 };
 
 namespace Platform {
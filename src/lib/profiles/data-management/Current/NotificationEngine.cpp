@@ -62,12 +62,13 @@ bool NotificationEngine::BasicGraphSolver::IsPropertyPathSupported(PropertyPathH
 }
 
 WEAVE_ERROR NotificationEngine::BasicGraphSolver::RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder,
-                                                                            TraitDataHandle aTraitDataHandle,
-                                                                            SchemaVersion aSchemaVersion, bool aRetrieveAll)
+                                                                            SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                                                            bool aRetrieveAll)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
-    err = aBuilder->WriteDataElement(aTraitDataHandle, kRootPropertyPathHandle, aSchemaVersion, NULL, 0, NULL, 0);
+    err = aBuilder->WriteDataElement(aTraitInfo->mTraitDataHandle, kRootPropertyPathHandle, aTraitInfo->mRequestedVersion, NULL, 0,
+                                     NULL, 0);
     SuccessOrExit(err);
 
 exit:
@@ -93,6 +94,7 @@ WEAVE_ERROR NotificationEngine::BasicGraphSolver::SetDirty(TraitDataHandle aData
                 {
                     WeaveLogDetail(DataManagement, "<BSolver:SetD> Set S%u:T%u dirty", i, j);
                     traitInstance[j].SetDirty();
+                    subEngine->GetNotificationEngine()->EnqueueSubscription(subHandler, true);
                 }
             }
         }
@@ -381,11 +383,277 @@ PropertyPathHandle NotificationEngine::IntermediateGraphSolver::GetNextCandidate
     return candidateHandle;
 }
 
+PropertyPathHandle NotificationEngine::IntermediateGraphSolver::GetNextCandidateHandle(void * aContext,
+                                                                                       uint32_t & aChangeStoreCursor,
+                                                                                       bool & aCandidateHandleIsDelete)
+{
+    CandidateContext * context = static_cast<CandidateContext *>(aContext);
+
+    return context->mSolver->GetNextCandidateHandle(aChangeStoreCursor, context->mDataHandle, aCandidateHandleIsDelete);
+}
+
+WEAVE_ERROR NotificationEngine::ComputeDataElementPaths(const TraitSchemaEngine * aSchemaEngine,
+                                                        GetNextCandidateHandleFunct aGetNextCandidateHandle, void * aContext,
+                                                        PropertyPathHandle & aCommonHandle, PropertyPathHandle * aMergeHandleSet,
+                                                        int32_t & aNumMergeHandles, PropertyPathHandle * aDeleteHandleSet,
+                                                        int32_t & aNumDeleteHandles)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PropertyPathHandle nextCommonHandle, candidateHandle;
+    PropertyPathHandle laggingHandles[2] = { kNullPropertyPathHandle, kNullPropertyPathHandle };
+    bool oldCandidateHandleIsDelete = false, candidateHandleIsDelete = false;
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+    bool modifyDeleteToModify = false;
+#endif
+
+    uint32_t changeStoreCursor = 0;
+
+    //
+    // This loop forms the crux of the TDM part of the NotificationEngine. It is responsible for gathering up the dirty bits
+    // within a data source instance and generating a *single* data element that maximally encompasses all that dirtiness. To do
+    // so, it iteratively computes a 'nextCommonHandle' that is the parent to all dirty path handles accumulated up to each
+    // iteration. This parent handle is termed as the Lowest Common Ancestor, or LCA.
+    //
+    // The WDM protocol rules state that all handles in the data at the first level(i.e immediate children of the handle
+    // referenced by the path) are to be merged into the eventual data, while data at the 2nd level and beyond are to be
+    // replaced. The algorithm below tries to exploit the merge semantics to just send the handles that are dirty relative to
+    // the common handle. Given the handle set is finitely sized, an overflow of that set results in all child handles being
+    // merged in.
+    //
+    // It also deals with deletions as well. Deletions are treated somewhat similarly to modifications/additions from the algo
+    // perspective with some minor adjustments:
+    //
+    //      1. Deletions are only applicable so long as all deletions apply to the same dictionary. Once we have deletions that
+    //         span multiple dictionaries, we cannot express a deletion anymore and the deletion is treated like a modify/add
+    //         from the algorithm perspective for the purposes of computing the LCA and adding entries to the merge handle set.
+    //
+    //      2. Deletions can co-exist with modifications/additions to the same dictionary. If there are mods/adds present in
+    //      other parts of the tree/other dictionaries, the deletion reverts to the same treatment as mentioned in 1)
+    //
+    // Key Variables:
+    //
+    //      aCommonHandle = The current LCA of all handles evaluated thus far.
+    //
+    //      candidateHandle = The next handle picked out from either the dirty or delete stores that will be evaluated against
+    //                   the current common handle to compute the next common handle
+    //
+    //      nextCommonHandle = The next computed LCA of the current handle and the candidate handle
+    //
+    //      laggingHandles = immediate children of the newly computed LCA that encompass the two
+    //                   candidates passed into the LCA computation function respectively. If either of the two input handles
+    //                   passed in match the newly computed LCA, the lagging handle will be set to kNullPropertyPathHandle
+    //
+    //      aMergeHandleSet = set of handles that will be merged in relative to the aCommonHandle. If empty, all children
+    //                   under the commonHandle will be included.
+    //
+    while ((candidateHandle = aGetNextCandidateHandle(aContext, changeStoreCursor, candidateHandleIsDelete)) !=
+           kNullPropertyPathHandle)
+    {
+        oldCandidateHandleIsDelete = candidateHandleIsDelete;
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+        // This flag tracks whether we have stopped trying to express deletions (setup in previous iterations) and now have
+        // reverted to converting them over to look like adds/modifies. This variable will remain set in this value for
+        // remaining iterations.
+        if (modifyDeleteToModify)
+        {
+            candidateHandleIsDelete = false;
+        }
+#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+
+        WeaveLogDetail(DataManagement, "Candidate Handle = %u:%u (%c -> %c)", GetPropertyDictionaryKey(candidateHandle),
+                       GetPropertySchemaHandle(candidateHandle), oldCandidateHandleIsDelete ? 'D' : 'M',
+                       candidateHandleIsDelete ? 'D' : 'M');
+
+        //
+        // Evaluate the next LCA
+        //
+        // Given our current common ancestor handle and our candidate handle, we compute the next LCA.  The next common handle
+        // will be stored in 'nextCommonHandle' while the two lagging branches will be represented through laggingHandles[0] and
+        // laggingHandles[1]. [0] will correspond to the lagging branch for the current common handle while [1] will correspond
+        // to that for the candidate handle.
+        //
+        if (aCommonHandle == kNullPropertyPathHandle)
+        {
+            // If we're first starting out, we need to pick a sensible common handle. Unlike modifications where the LCA is the
+            // first modified/added handle we encounter, deletions need to be expressed relative to the parent dictionary
+            // handle. Hence, we setup it up to look like a 'merge' by having the common handle point to the dictionary and the
+            // lagging handle point to the deleted element.
+            if (candidateHandleIsDelete)
+            {
+                nextCommonHandle  = aSchemaEngine->GetParent(candidateHandle);
+                laggingHandles[0] = kNullPropertyPathHandle;
+                laggingHandles[1] = candidateHandle;
+            }
+            else
+            {
+                nextCommonHandle = candidateHandle;
+            }
+
+            WeaveLogDetail(DataManagement, "<Solver::Retr> (%c) nextCommonHandle = %u:%u", candidateHandleIsDelete ? 'D' : 'M',
+                           GetPropertyDictionaryKey(nextCommonHandle), GetPropertySchemaHandle(nextCommonHandle));
+        }
+        else
+        {
+            // Find the lowest common parent of the currently tracked common handle and the next item in the dirty set. Also,
+            // return the two child handles that lag the ancestor that are parents of the two input handles to the LCA.
+            nextCommonHandle = aSchemaEngine->FindLowestCommonAncestor(aCommonHandle, candidateHandle, &laggingHandles[0],
+                                                                       &laggingHandles[1]);
+            VerifyOrExit(nextCommonHandle != kNullPropertyPathHandle, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+            WeaveLogDetail(DataManagement,
+                           "<Solver::Retr> (%c) nextCommonHandle += (%u:%u) = (%u:%u) (Lag-set = (%u:%u), (%u:%u))",
+                           candidateHandleIsDelete ? 'D' : 'M', GetPropertyDictionaryKey(candidateHandle),
+                           GetPropertySchemaHandle(candidateHandle), GetPropertyDictionaryKey(nextCommonHandle),
+                           GetPropertySchemaHandle(nextCommonHandle), GetPropertyDictionaryKey(laggingHandles[0]),
+                           GetPropertySchemaHandle(laggingHandles[0]), GetPropertyDictionaryKey(laggingHandles[1]),
+                           GetPropertySchemaHandle(laggingHandles[1]));
+        }
+
+        // If we compute a new next handle, we'll need to wipe our merge handle set since the old set of merge/delete handles
+        // were referenced against a now-stale handle
+        if (aCommonHandle != nextCommonHandle)
+        {
+            WeaveLogDetail(DataManagement, "<Solver::Retr> (%c) nextHandle != currentHandle, wiping merge/delete sets",
+                           candidateHandleIsDelete ? 'D' : 'M');
+            aNumMergeHandles  = 0;
+            aNumDeleteHandles = 0;
+        }
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+        if (candidateHandleIsDelete)
+        {
+            // The aDeleteHandleSet only makes sense as long as the next common handle is the parent of the delete set.
+            // If not, we start treating it as a add/modify.
+            if (nextCommonHandle == aSchemaEngine->GetParent(candidateHandle))
+            {
+                int32_t i;
+
+                for (i = 0; i < aNumDeleteHandles; i++)
+                {
+                    if (aDeleteHandleSet[i] == laggingHandles[1])
+                    {
+                        WeaveLogDetail(DataManagement, "<Solver::Retr> (D) Handle (%u:%u) already present",
+                                       GetPropertyDictionaryKey(laggingHandles[1]), GetPropertySchemaHandle(laggingHandles[1]));
+                        break;
+                    }
+                }
+
+                if (i == aNumDeleteHandles)
+                {
+                    // If our delete handle set overflows, we degenerate to expressing the deletes as a replacement of the
+                    // dictionary itself.
+                    if (aNumDeleteHandles >= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET)
+                    {
+                        WeaveLogDetail(DataManagement, "<Solver::Retr> (D) delete set overflowed, converting to replace");
+
+                        laggingHandles[0] = kNullPropertyPathHandle;
+                        laggingHandles[1] = nextCommonHandle;
+                        nextCommonHandle  = aSchemaEngine->GetParent(nextCommonHandle);
+
+                        aNumMergeHandles  = 0;
+                        aNumDeleteHandles = 0;
+
+                        candidateHandleIsDelete = false;
+                        modifyDeleteToModify    = true;
+                    }
+                    else
+                    {
+                        WeaveLogDetail(DataManagement,
+                                       "<Solver::Retr> (D) Adding delete handle = (%u:%u) (numCurHandles = %u)",
+                                       GetPropertyDictionaryKey(laggingHandles[1]), GetPropertySchemaHandle(laggingHandles[1]),
+                                       aNumDeleteHandles + 1);
+                        aDeleteHandleSet[aNumDeleteHandles++] = laggingHandles[1];
+
+                        // There's always a possibility that the other lagging handle was pointing to a modified/added handle.
+                        // We set the laggingHandle[1] as null to prevent it from getting added but set candidateHandleIsDelete
+                        // to false to force it get evaluated in the section below for addition to the aMergeHandleSet.
+                        laggingHandles[1]       = kNullPropertyPathHandle;
+                        candidateHandleIsDelete = false;
+                    }
+                }
+            }
+            else
+            {
+                WeaveLogDetail(DataManagement, "<Solver::Retr> (D) Making delete a merge instead");
+                candidateHandleIsDelete = false;
+            }
+        }
+#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+
+        if (!candidateHandleIsDelete)
+        {
+            // If our next handle matches the current dirty handle, we know we cannot do a merge so wipe the merge set.
+            if (nextCommonHandle == candidateHandle)
+            {
+                aNumMergeHandles = 0;
+
+                WeaveLogDetail(DataManagement, "<Solver::Retr> (M) next is dirty handle - wiping merge set");
+
+                // We make a small exception if the dirty handle is a dictionary - it doesn't make a lot of sense to mark a
+                // dictionary as dirty if you were just intending to convey modifications/additions only. Instead, let's do a
+                // replace given that makes more sense for a dynamic data type like this.
+                if (aSchemaEngine->IsDictionary(candidateHandle))
+                {
+                    WeaveLogDetail(DataManagement, "<Solver::Retr> (M) next is dictionary - setting up replace");
+                    aMergeHandleSet[0] = candidateHandle;
+                    nextCommonHandle  = aSchemaEngine->GetParent(candidateHandle);
+                    aNumMergeHandles   = 1;
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < 2; i++)
+                {
+                    if (laggingHandles[i] != kNullPropertyPathHandle)
+                    {
+                        int j;
+
+                        for (j = 0; j < aNumMergeHandles; j++)
+                        {
+                            if (aMergeHandleSet[j] == laggingHandles[i])
+                            {
+                                WeaveLogDetail(DataManagement, "<Solver::Retr> (M) Handle (%u:%u) already present",
+                                               GetPropertyDictionaryKey(laggingHandles[i]),
+                                               GetPropertySchemaHandle(laggingHandles[i]));
+                                break;
+                            }
+                        }
+
+                        if (aNumMergeHandles >= 0 && j == aNumMergeHandles)
+                        {
+                            if (aNumMergeHandles >= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET)
+                            {
+                                WeaveLogDetail(DataManagement, "<Solver::Retr> (M) merge set overflowed");
+                                aNumMergeHandles = -1;
+                            }
+                            else
+                            {
+                                WeaveLogDetail(DataManagement, "<Solver::Retr> (M) Merge handle = (%u:%u) (numhandles = %u)",
+                                               GetPropertyDictionaryKey(laggingHandles[i]),
+                                               GetPropertySchemaHandle(laggingHandles[i]), aNumMergeHandles + 1);
+                                aMergeHandleSet[aNumMergeHandles++] = laggingHandles[i];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        aCommonHandle = nextCommonHandle;
+    }
+
+exit:
+    return err;
+}
+
 WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder,
-                                                                                   TraitDataHandle aTraitDataHandle,
-                                                                                   SchemaVersion aSchemaVersion, bool aRetrieveAll)
+                                                                                   SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                                                                   bool aRetrieveAll)
 {
     WEAVE_ERROR err;
+    TraitDataHandle traitDataHandle = aTraitInfo->mTraitDataHandle;
     PropertyPathHandle mergeHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET]  = { kNullPropertyPathHandle };
     PropertyPathHandle deleteHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET] = { kNullPropertyPathHandle };
     int32_t numMergeHandles                                                                    = 0;
@@ -394,7 +662,7 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::RetrieveTraitInstanceDa
     TraitDataSource * dataSource;
     const TraitSchemaEngine * schemaEngine;
 
-    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(aTraitDataHandle, &dataSource);
+    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(traitDataHandle, &dataSource);
     SuccessOrExit(err);
 
     schemaEngine = dataSource->GetSchemaEngine();
@@ -420,311 +688,402 @@ WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::RetrieveTraitInstanceDa
     }
     else
     {
-        PropertyPathHandle nextCommonHandle, candidateHandle;
-        PropertyPathHandle laggingHandles[2] = { kNullPropertyPathHandle, kNullPropertyPathHandle };
-        bool oldCandidateHandleIsDelete = false, candidateHandleIsDelete = false;
+        CandidateContext context = { this, traitDataHandle };
+
+        err = ComputeDataElementPaths(schemaEngine, GetNextCandidateHandle, &context, currentCommonHandle, mergeHandleSet,
+                                      numMergeHandles, deleteHandleSet, numDeleteHandles);
+        SuccessOrExit(err);
+    }
+
+    // If our algo is working correctly, currentCommonHandle should always be pointing to a valid handle. This is always the case
+    // since a) this function only gets called if we know there is dirtiness in this trait and b) the current common handle is
+    // always a function of the dirty handle set, which by definition, cannot be null.
+    VerifyOrDie(currentCommonHandle != kNullPropertyPathHandle);
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+    // If we're expressing a deletion (i.e numDeleteHandles > 0), then it has to be done against a path that points to a dictionary.
+    // If that isn't the case, something really wrong has happened in the algorithm above.
+    if (numDeleteHandles > 0)
+    {
+        VerifyOrDie(schemaEngine->IsDictionary(currentCommonHandle));
+    }
+#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+
+    WeaveLogDetail(DataManagement, "<ISolver::Retr> Final handle = (%u:%u), numMergeHandles = %d, numDeleteHandles = %d",
+                   GetPropertyDictionaryKey(currentCommonHandle), GetPropertySchemaHandle(currentCommonHandle), numMergeHandles,
+                   numDeleteHandles);
+
+    // if we overflow, let's clear them back to 0.
+    if (numMergeHandles < 0)
+    {
+        numMergeHandles = 0;
+    }
+
+    // Generate data elements
+    err = aBuilder->WriteDataElement(traitDataHandle, currentCommonHandle, aTraitInfo->mRequestedVersion, mergeHandleSet,
+                                     numMergeHandles, deleteHandleSet, numDeleteHandles);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+void NotificationEngine::IntermediateGraphSolver::ClearTraitInstanceDirty(void * aDataSource, TraitDataHandle aDataHandle,
+                                                                          void * aContext)
+{
+    TraitDataSource * dataSource = static_cast<TraitDataSource *>(aDataSource);
+    dataSource->ClearRootDirty();
+}
+
+WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::ClearDirty()
+{
+    // Iterate over every publisher trait instance and clear their dirty field.
+    SubscriptionEngine::GetInstance()->mPublisherCatalog->Iterate(ClearTraitInstanceDirty, this);
+
+    // Clear out our granular dirty store.
+    mDirtyStore.Clear();
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-        bool modifyDeleteToModify = false;
+    mDeleteStore.Clear();
 #endif
 
-        uint32_t changeStoreCursor = 0;
+    return WEAVE_NO_ERROR;
+}
 
-        //
-        // This loop forms the crux of the TDM part of the NotificationEngine. It is responsible for gathering up the dirty bits
-        // within a data source instance and generating a *single* data element that maximally encompasses all that dirtiness. To do
-        // so, it iteratively computes a 'nextCommonHandle' that is the parent to all dirty path handles accumulated up to each
-        // iteration. This parent handle is termed as the Lowest Common Ancestor, or LCA.
-        //
-        // The WDM protocol rules state that all handles in the data at the first level(i.e immediate children of the handle
-        // referenced by the path) are to be merged into the eventual data, while data at the 2nd level and beyond are to be
-        // replaced. The algorithm below tries to exploit the merge semantics to just send the handles that are dirty relative to
-        // the common handle. Given the handle set is finitely sized, an overflow of that set results in all child handles being
-        // merged in.
-        //
-        // It also deals with deletions as well. Deletions are treated somewhat similarly to modifications/additions from the algo
-        // perspective with some minor adjustments:
-        //
-        //      1. Deletions are only applicable so long as all deletions apply to the same dictionary. Once we have deletions that
-        //         span multiple dictionaries, we cannot express a deletion anymore and the deletion is treated like a modify/add
-        //         from the algorithm perspective for the purposes of computing the LCA and adding entries to the merge handle set.
-        //
-        //      2. Deletions can co-exist with modifications/additions to the same dictionary. If there are mods/adds present in
-        //      other parts of the tree/other dictionaries, the deletion reverts to the same treatment as mentioned in 1)
-        //
-        // Key Variables:
-        //
-        //      currentCommonHandle = The current LCA of all handles evaluated thus far.
-        //
-        //      candidateHandle = The next handle picked out from either the dirty or delete stores that will be evaluated against
-        //                   the current common handle to compute the next common handle
-        //
-        //      nextCommonHandle = The next computed LCA of the current handle and the candidate handle
-        //
-        //      laggingHandles = immediate children of the newly computed LCA that encompass the two
-        //                   candidates passed into the LCA computation function respectively. If either of the two input handles
-        //                   passed in match the newly computed LCA, the lagging handle will be set to kNullPropertyPathHandle
-        //
-        //      mergeHandleSet = set of handles that will be merged in relative to the currentCommonHandle. If empty, all children
-        //                   under the commonHandle will be included.
-        //
-        while ((candidateHandle = GetNextCandidateHandle(changeStoreCursor, aTraitDataHandle, candidateHandleIsDelete)) !=
-               kNullPropertyPathHandle)
-        {
-            oldCandidateHandleIsDelete = candidateHandleIsDelete;
+void NotificationEngine::IntermediateGraphSolver::Store::Clear()
+{
+    mNumItems = 0;
+    memset(mValidFlags, 0, sizeof(mValidFlags));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BitmapGraphSolver
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+NotificationEngine::BitmapGraphSolver::BitmapGraphSolver()
+{
+    memset(mTraitInstances, 0, sizeof(mTraitInstances));
+}
+
+bool NotificationEngine::BitmapGraphSolver::IsPropertyPathSupported(PropertyPathHandle aHandle)
+{
+    // The bitmap solver also only supports subscribing to root.
+    return BasicGraphSolver::IsPropertyPathSupported(aHandle);
+}
+
+void NotificationEngine::BitmapGraphSolver::TraitInstanceState::Clear()
+{
+    memset(this, 0, sizeof(*this));
+}
+
+bool NotificationEngine::BitmapGraphSolver::TraitInstanceState::IsHandleDirty(PropertySchemaHandle aSchemaHandle) const
+{
+    return (aSchemaHandle < WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES) &&
+        ((mDirtyBitmap[aSchemaHandle / kBitsPerWord] & (1UL << (aSchemaHandle % kBitsPerWord))) != 0);
+}
+
+void NotificationEngine::BitmapGraphSolver::TraitInstanceState::AddChange(const TraitSchemaEngine * aSchemaEngine,
+                                                                         PropertyPathHandle aPropertyHandle, bool aIsDelete)
+{
+    PropertySchemaHandle schemaHandle;
+
+    // Once the root is dirty, the whole trait instance is sent regardless.
+    VerifyOrExit(!IsHandleDirty(kRootPropertyPathHandle), );
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-            // This flag tracks whether we have stopped trying to express deletions (setup in previous iterations) and now have
-            // reverted to converting them over to look like adds/modifies. This variable will remain set in this value for
-            // remaining iterations.
-            if (modifyDeleteToModify)
-            {
-                candidateHandleIsDelete = false;
-            }
+    {
+        PropertyPathHandle dictionaryItemHandle;
+
+        if (aSchemaEngine->IsInDictionary(aPropertyHandle, dictionaryItemHandle))
+        {
+            AddDictionaryChange(aSchemaEngine, aPropertyHandle, dictionaryItemHandle, aIsDelete);
+            ExitNow();
+        }
+    }
 #endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 
-            WeaveLogDetail(DataManagement, "Candidate Handle = %u:%u (%c -> %c)", GetPropertyDictionaryKey(candidateHandle),
-                           GetPropertySchemaHandle(candidateHandle), oldCandidateHandleIsDelete ? 'D' : 'M',
-                           candidateHandleIsDelete ? 'D' : 'M');
+    schemaHandle = GetPropertySchemaHandle(aPropertyHandle);
 
-            //
-            // Evaluate the next LCA
-            //
-            // Given our current common ancestor handle and our candidate handle, we compute the next LCA.  The next common handle
-            // will be stored in 'nextCommonHandle' while the two lagging branches will be represented through laggingHandles[0] and
-            // laggingHandles[1]. [0] will correspond to the lagging branch for the current common handle while [1] will correspond
-            // to that for the candidate handle.
-            //
-            if (currentCommonHandle == kNullPropertyPathHandle)
-            {
-                // If we're first starting out, we need to pick a sensible common handle. Unlike modifications where the LCA is the
-                // first modified/added handle we encounter, deletions need to be expressed relative to the parent dictionary
-                // handle. Hence, we setup it up to look like a 'merge' by having the common handle point to the dictionary and the
-                // lagging handle point to the deleted element.
-                if (candidateHandleIsDelete)
-                {
-                    nextCommonHandle  = schemaEngine->GetParent(candidateHandle);
-                    laggingHandles[0] = kNullPropertyPathHandle;
-                    laggingHandles[1] = candidateHandle;
-                }
-                else
-                {
-                    nextCommonHandle = candidateHandle;
-                }
+    if (schemaHandle >= WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES)
+    {
+        WeaveLogDetail(DataManagement, "<BmSolver:AddChange> %u beyond bitmap, marking root dirty", schemaHandle);
+        schemaHandle = kRootPropertyPathHandle;
+    }
+
+    mDirtyBitmap[schemaHandle / kBitsPerWord] |= (1UL << (schemaHandle % kBitsPerWord));
+
+exit:
+    return;
+}
 
-                WeaveLogDetail(DataManagement, "<ISolver::Retr> (%c) nextCommonHandle = %u:%u", candidateHandleIsDelete ? 'D' : 'M',
-                               GetPropertyDictionaryKey(nextCommonHandle), GetPropertySchemaHandle(nextCommonHandle));
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+void NotificationEngine::BitmapGraphSolver::TraitInstanceState::AddDictionaryChange(const TraitSchemaEngine * aSchemaEngine,
+                                                                                   PropertyPathHandle aPropertyHandle,
+                                                                                   PropertyPathHandle aDictionaryItemHandle,
+                                                                                   bool aIsDelete)
+{
+    PropertyPathHandle dictionaryHandle = aSchemaEngine->GetParent(aDictionaryItemHandle);
+    PropertyPathHandle handleToAdd      = aPropertyHandle;
+    PropertyPathHandle * items          = aIsDelete ? mDeletedItems : mDirtyItems;
+    uint8_t & numItems                  = aIsDelete ? mNumDeletedItems : mNumDirtyItems;
+    uint8_t i;
+
+    // A dictionary that is already dirty gets replaced as a whole.
+    VerifyOrExit(!IsHandleDirty(GetPropertySchemaHandle(dictionaryHandle)), );
+
+    // As with the IntermediateGraphSolver, a modification cancels a prior deletion of the same element, which then has to be sent
+    // in its entirety, and a deletion cancels any prior modifications within the element.
+    if (aIsDelete)
+    {
+        for (i = 0; i < mNumDirtyItems;)
+        {
+            if (mDirtyItems[i] == aDictionaryItemHandle || aSchemaEngine->IsParent(mDirtyItems[i], aDictionaryItemHandle))
+            {
+                memmove(&mDirtyItems[i], &mDirtyItems[i + 1], (mNumDirtyItems - i - 1) * sizeof(mDirtyItems[0]));
+                mNumDirtyItems--;
             }
             else
             {
-                // Find the lowest common parent of the currently tracked common handle and the next item in the dirty set. Also,
-                // return the two child handles that lag the ancestor that are parents of the two input handles to the LCA.
-                nextCommonHandle = schemaEngine->FindLowestCommonAncestor(currentCommonHandle, candidateHandle, &laggingHandles[0],
-                                                                          &laggingHandles[1]);
-                VerifyOrExit(nextCommonHandle != kNullPropertyPathHandle, err = WEAVE_ERROR_INVALID_ARGUMENT);
-
-                WeaveLogDetail(DataManagement,
-                               "<ISolver::Retr> (%c) nextCommonHandle += (%u:%u) = (%u:%u) (Lag-set = (%u:%u), (%u:%u))",
-                               candidateHandleIsDelete ? 'D' : 'M', GetPropertyDictionaryKey(candidateHandle),
-                               GetPropertySchemaHandle(candidateHandle), GetPropertyDictionaryKey(nextCommonHandle),
-                               GetPropertySchemaHandle(nextCommonHandle), GetPropertyDictionaryKey(laggingHandles[0]),
-                               GetPropertySchemaHandle(laggingHandles[0]), GetPropertyDictionaryKey(laggingHandles[1]),
-                               GetPropertySchemaHandle(laggingHandles[1]));
+                i++;
             }
-
-            // If we compute a new next handle, we'll need to wipe our merge handle set since the old set of merge/delete handles
-            // were referenced against a now-stale handle
-            if (currentCommonHandle != nextCommonHandle)
+        }
+    }
+    else
+    {
+        for (i = 0; i < mNumDeletedItems; i++)
+        {
+            if (mDeletedItems[i] == aDictionaryItemHandle)
             {
-                WeaveLogDetail(DataManagement, "<ISolver::Retr> (%c) nextHandle != currentHandle, wiping merge/delete sets",
-                               candidateHandleIsDelete ? 'D' : 'M');
-                numMergeHandles  = 0;
-                numDeleteHandles = 0;
+                memmove(&mDeletedItems[i], &mDeletedItems[i + 1], (mNumDeletedItems - i - 1) * sizeof(mDeletedItems[0]));
+                mNumDeletedItems--;
+                handleToAdd = aDictionaryItemHandle;
+                break;
             }
+        }
+    }
 
-#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-            if (candidateHandleIsDelete)
-            {
-                // The deleteHandleSet only makes sense as long as the next common handle is the parent of the delete set.
-                // If not, we start treating it as a add/modify.
-                if (nextCommonHandle == schemaEngine->GetParent(candidateHandle))
-                {
-                    int32_t i;
+    for (i = 0; i < numItems; i++)
+    {
+        VerifyOrExit(items[i] != handleToAdd, );
+    }
 
-                    for (i = 0; i < numDeleteHandles; i++)
-                    {
-                        if (deleteHandleSet[i] == laggingHandles[1])
-                        {
-                            WeaveLogDetail(DataManagement, "<ISolver::Retr> (D) Handle (%u:%u) already present",
-                                           GetPropertyDictionaryKey(laggingHandles[1]), GetPropertySchemaHandle(laggingHandles[1]));
-                            break;
-                        }
-                    }
+    if (numItems < WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS)
+    {
+        items[numItems++] = handleToAdd;
+    }
+    else
+    {
+        WeaveLogDetail(DataManagement, "<BmSolver:AddChange> No more space for dictionary items, replacing dictionary %u",
+                       GetPropertySchemaHandle(dictionaryHandle));
 
-                    if (i == numDeleteHandles)
-                    {
-                        // If our delete handle set overflows, we degenerate to expressing the deletes as a replacement of the
-                        // dictionary itself.
-                        if (numDeleteHandles >= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET)
-                        {
-                            WeaveLogDetail(DataManagement, "<ISolver::Retr> (D) delete set overflowed, converting to replace");
+        RemoveDictionaryItems(aSchemaEngine, dictionaryHandle);
+
+        // The dictionary may itself be an element of another dictionary.
+        AddChange(aSchemaEngine, dictionaryHandle, false);
+    }
+
+exit:
+    return;
+}
 
-                            laggingHandles[0] = kNullPropertyPathHandle;
-                            laggingHandles[1] = nextCommonHandle;
-                            nextCommonHandle  = schemaEngine->GetParent(nextCommonHandle);
+void NotificationEngine::BitmapGraphSolver::TraitInstanceState::RemoveDictionaryItems(const TraitSchemaEngine * aSchemaEngine,
+                                                                                     PropertyPathHandle aDictionaryHandle)
+{
+    uint8_t numDirtyItems   = 0;
+    uint8_t numDeletedItems = 0;
 
-                            numMergeHandles  = 0;
-                            numDeleteHandles = 0;
+    for (uint8_t i = 0; i < mNumDirtyItems; i++)
+    {
+        if (!aSchemaEngine->IsParent(mDirtyItems[i], aDictionaryHandle))
+        {
+            mDirtyItems[numDirtyItems++] = mDirtyItems[i];
+        }
+    }
 
-                            candidateHandleIsDelete = false;
-                            modifyDeleteToModify    = true;
-                        }
-                        else
-                        {
-                            WeaveLogDetail(DataManagement,
-                                           "<ISolver::Retr> (D) Adding delete handle = (%u:%u) (numCurHandles = %u)",
-                                           GetPropertyDictionaryKey(laggingHandles[1]), GetPropertySchemaHandle(laggingHandles[1]),
-                                           numDeleteHandles + 1);
-                            deleteHandleSet[numDeleteHandles++] = laggingHandles[1];
-
-                            // There's always a possibility that the other lagging handle was pointing to a modified/added handle.
-                            // We set the laggingHandle[1] as null to prevent it from getting added but set candidateHandleIsDelete
-                            // to false to force it get evaluated in the section below for addition to the mergeHandleSet.
-                            laggingHandles[1]       = kNullPropertyPathHandle;
-                            candidateHandleIsDelete = false;
-                        }
-                    }
-                }
-                else
-                {
-                    WeaveLogDetail(DataManagement, "<ISolver::Retr> (D) Making delete a merge instead");
-                    candidateHandleIsDelete = false;
-                }
-            }
+    for (uint8_t i = 0; i < mNumDeletedItems; i++)
+    {
+        if (!aSchemaEngine->IsParent(mDeletedItems[i], aDictionaryHandle))
+        {
+            mDeletedItems[numDeletedItems++] = mDeletedItems[i];
+        }
+    }
+
+    mNumDirtyItems   = numDirtyItems;
+    mNumDeletedItems = numDeletedItems;
+}
 #endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 
-            if (!candidateHandleIsDelete)
+NotificationEngine::BitmapGraphSolver::TraitInstanceState *
+NotificationEngine::BitmapGraphSolver::GetState(SubscriptionHandler::TraitInstanceInfo * aTraitInfo)
+{
+    // Trait instance infos are always allocated out of the subscription engine's pool, and ReclaimTraitInstances() keeps the
+    // state in step with the pool as it is compacted.
+    return &mTraitInstances[aTraitInfo - SubscriptionEngine::GetInstance()->mTraitInfoPool];
+}
+
+WEAVE_ERROR NotificationEngine::BitmapGraphSolver::AddChange(TraitDataHandle aDataHandle, PropertyPathHandle aPropertyHandle,
+                                                             bool aIsDelete)
+{
+    WEAVE_ERROR err                = WEAVE_NO_ERROR;
+    SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
+    TraitDataSource * dataSource;
+
+    err = subEngine->mPublisherCatalog->Locate(aDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; ++i)
+    {
+        SubscriptionHandler * subHandler = &subEngine->mHandlers[i];
+
+        if (subHandler->IsActive())
+        {
+            SubscriptionHandler::TraitInstanceInfo * traitInstance = subHandler->GetTraitInstanceInfoList();
+
+            for (size_t j = 0; j < subHandler->GetNumTraitInstances(); j++)
             {
-                // If our next handle matches the current dirty handle, we know we cannot do a merge so wipe the merge set.
-                if (nextCommonHandle == candidateHandle)
+                if (traitInstance[j].mTraitDataHandle == aDataHandle)
                 {
-                    numMergeHandles = 0;
+                    TraitInstanceState * state = GetState(&traitInstance[j]);
 
-                    WeaveLogDetail(DataManagement, "<ISolver::Retr> (M) next is dirty handle - wiping merge set");
+                    WeaveLogDetail(DataManagement, "<BmSolver:AddChange> S%u:T%u::(%u:%u) %s", i, j,
+                                   GetPropertyDictionaryKey(aPropertyHandle), GetPropertySchemaHandle(aPropertyHandle),
+                                   aIsDelete ? "deleted" : "dirty");
 
-                    // We make a small exception if the dirty handle is a dictionary - it doesn't make a lot of sense to mark a
-                    // dictionary as dirty if you were just intending to convey modifications/additions only. Instead, let's do a
-                    // replace given that makes more sense for a dynamic data type like this.
-                    if (schemaEngine->IsDictionary(candidateHandle))
+                    // What is left over from the last notify generated for this trait instance has been sent already.
+                    if (!traitInstance[j].IsDirty())
                     {
-                        WeaveLogDetail(DataManagement, "<ISolver::Retr> (M) next is dictionary - setting up replace");
-                        mergeHandleSet[0] = candidateHandle;
-                        nextCommonHandle  = schemaEngine->GetParent(candidateHandle);
-                        numMergeHandles   = 1;
+                        state->Clear();
                     }
-                }
-                else
-                {
-                    for (size_t i = 0; i < 2; i++)
-                    {
-                        if (laggingHandles[i] != kNullPropertyPathHandle)
-                        {
-                            int j;
 
-                            for (j = 0; j < numMergeHandles; j++)
-                            {
-                                if (mergeHandleSet[j] == laggingHandles[i])
-                                {
-                                    WeaveLogDetail(DataManagement, "<ISolver::Retr> (M) Handle (%u:%u) already present",
-                                                   GetPropertyDictionaryKey(laggingHandles[i]),
-                                                   GetPropertySchemaHandle(laggingHandles[i]));
-                                    break;
-                                }
-                            }
-
-                            if (numMergeHandles >= 0 && j == numMergeHandles)
-                            {
-                                if (numMergeHandles >= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET)
-                                {
-                                    WeaveLogDetail(DataManagement, "<ISolver::Retr> (M) merge set overflowed");
-                                    numMergeHandles = -1;
-                                }
-                                else
-                                {
-                                    WeaveLogDetail(DataManagement, "<ISolver::Retr> (M) Merge handle = (%u:%u) (numhandles = %u)",
-                                                   GetPropertyDictionaryKey(laggingHandles[i]),
-                                                   GetPropertySchemaHandle(laggingHandles[i]), numMergeHandles + 1);
-                                    mergeHandleSet[numMergeHandles++] = laggingHandles[i];
-                                }
-                            }
-                        }
-                    }
+                    state->AddChange(dataSource->GetSchemaEngine(), aPropertyHandle, aIsDelete);
+                    traitInstance[j].SetDirty();
+                    subEngine->GetNotificationEngine()->EnqueueSubscription(subHandler, true);
                 }
             }
+        }
+    }
+
+exit:
+    return err;
+}
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+WEAVE_ERROR NotificationEngine::BitmapGraphSolver::DeleteKey(TraitDataHandle aDataHandle, PropertyPathHandle aPropertyHandle)
+{
+    return AddChange(aDataHandle, aPropertyHandle, true);
+}
+#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+
+WEAVE_ERROR NotificationEngine::BitmapGraphSolver::SetDirty(TraitDataHandle aDataHandle, PropertyPathHandle aPropertyHandle)
+{
+    return AddChange(aDataHandle, aPropertyHandle, false);
+}
 
-            currentCommonHandle = nextCommonHandle;
+PropertyPathHandle NotificationEngine::BitmapGraphSolver::GetNextCandidateHandle(void * aContext, uint32_t & aCursor,
+                                                                                 bool & aCandidateHandleIsDelete)
+{
+    TraitInstanceState * state = static_cast<TraitInstanceState *>(aContext);
+
+    aCandidateHandleIsDelete = false;
+
+    // The bitmap comes first, followed by the modified and then the deleted dictionary elements.
+    for (; aCursor < WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES; aCursor++)
+    {
+        if (state->IsHandleDirty(static_cast<PropertySchemaHandle>(aCursor)))
+        {
+            return static_cast<PropertyPathHandle>(aCursor++);
         }
     }
 
-    // If our algo is working correctly, currentCommonHandle should always be pointing to a valid handle. This is always the case
-    // since a) this function only gets called if we know there is dirtiness in this trait and b) the current common handle is
-    // always a function of the dirty handle set, which by definition, cannot be null.
-    VerifyOrDie(currentCommonHandle != kNullPropertyPathHandle);
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+    if (aCursor - WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES < state->mNumDirtyItems)
+    {
+        return state->mDirtyItems[aCursor++ - WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES];
+    }
+
+    if (aCursor - WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES - state->mNumDirtyItems < state->mNumDeletedItems)
+    {
+        aCandidateHandleIsDelete = true;
+        return state->mDeletedItems[aCursor++ - WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES - state->mNumDirtyItems];
+    }
+#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+
+    return kNullPropertyPathHandle;
+}
+
+WEAVE_ERROR NotificationEngine::BitmapGraphSolver::RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder,
+                                                                             SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                                                             bool aRetrieveAll)
+{
+    WEAVE_ERROR err;
+    PropertyPathHandle mergeHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET]  = { kNullPropertyPathHandle };
+    PropertyPathHandle deleteHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET] = { kNullPropertyPathHandle };
+    int32_t numMergeHandles                                                                    = 0;
+    int32_t numDeleteHandles                                                                   = 0;
+    PropertyPathHandle currentCommonHandle                                                     = kNullPropertyPathHandle;
+    TraitInstanceState * state                                                                 = GetState(aTraitInfo);
+    TraitDataSource * dataSource;
+    const TraitSchemaEngine * schemaEngine;
+
+    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(aTraitInfo->mTraitDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    schemaEngine = dataSource->GetSchemaEngine();
+
+    if (aRetrieveAll || state->IsHandleDirty(kRootPropertyPathHandle))
+    {
+        WeaveLogDetail(DataManagement, "<BmSolver::Retr> Retrieving root");
+        currentCommonHandle = kRootPropertyPathHandle;
+    }
+    else
+    {
+        err = ComputeDataElementPaths(schemaEngine, GetNextCandidateHandle, state, currentCommonHandle, mergeHandleSet,
+                                      numMergeHandles, deleteHandleSet, numDeleteHandles);
+        SuccessOrExit(err);
+    }
 
-#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-    // If we're expressing a deletion (i.e numDeleteHandles > 0), then it has to be done against a path that points to a dictionary.
-    // If that isn't the case, something really wrong has happened in the algorithm above.
-    if (numDeleteHandles > 0)
+    // The trait instance may have been marked dirty without going through the solver (e.g. while establishing the subscription);
+    // err on the side of sending everything in that case.
+    if (currentCommonHandle == kNullPropertyPathHandle)
     {
-        VerifyOrDie(schemaEngine->IsDictionary(currentCommonHandle));
+        currentCommonHandle = kRootPropertyPathHandle;
     }
-#endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 
-    WeaveLogDetail(DataManagement, "<ISolver::Retr> Final handle = (%u:%u), numMergeHandles = %d, numDeleteHandles = %d",
+    WeaveLogDetail(DataManagement, "<BmSolver::Retr> Final handle = (%u:%u), numMergeHandles = %d, numDeleteHandles = %d",
                    GetPropertyDictionaryKey(currentCommonHandle), GetPropertySchemaHandle(currentCommonHandle), numMergeHandles,
                    numDeleteHandles);
 
-    // if we overflow, let's clear them back to 0.
     if (numMergeHandles < 0)
     {
         numMergeHandles = 0;
     }
 
-    // Generate data elements
-    err = aBuilder->WriteDataElement(aTraitDataHandle, currentCommonHandle, aSchemaVersion, mergeHandleSet, numMergeHandles,
-                                     deleteHandleSet, numDeleteHandles);
+    // The state is left in place until the trait instance is next marked dirty, so that the same data element can be generated
+    // again should the trait instance be re-armed without any further changes.
+    err = aBuilder->WriteDataElement(aTraitInfo->mTraitDataHandle, currentCommonHandle, aTraitInfo->mRequestedVersion,
+                                     mergeHandleSet, numMergeHandles, deleteHandleSet, numDeleteHandles);
     SuccessOrExit(err);
 
 exit:
     return err;
 }
 
-void NotificationEngine::IntermediateGraphSolver::ClearTraitInstanceDirty(void * aDataSource, TraitDataHandle aDataHandle,
-                                                                          void * aContext)
-{
-    TraitDataSource * dataSource = static_cast<TraitDataSource *>(aDataSource);
-    dataSource->ClearRootDirty();
-}
-
-WEAVE_ERROR NotificationEngine::IntermediateGraphSolver::ClearDirty()
+WEAVE_ERROR NotificationEngine::BitmapGraphSolver::ClearDirty()
 {
-    // Iterate over every publisher trait instance and clear their dirty field.
-    SubscriptionEngine::GetInstance()->mPublisherCatalog->Iterate(ClearTraitInstanceDirty, this);
-
-    // Clear out our granular dirty store.
-    mDirtyStore.Clear();
-
-#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
-    mDeleteStore.Clear();
-#endif
+    // Only called once every subscription is clean, at which point none of the state is needed anymore.
+    memset(mTraitInstances, 0, sizeof(mTraitInstances));
 
     return WEAVE_NO_ERROR;
 }
 
-void NotificationEngine::IntermediateGraphSolver::Store::Clear()
+void NotificationEngine::BitmapGraphSolver::ReclaimTraitInstances(size_t aFirstIndex, size_t aNumReclaimed, size_t aNumInPool)
 {
-    mNumItems = 0;
-    memset(mValidFlags, 0, sizeof(mValidFlags));
+    memmove(&mTraitInstances[aFirstIndex], &mTraitInstances[aFirstIndex + aNumReclaimed],
+            (aNumInPool - aFirstIndex - aNumReclaimed) * sizeof(mTraitInstances[0]));
+
+    for (size_t i = aNumInPool - aNumReclaimed; i < aNumInPool; i++)
+    {
+        mTraitInstances[i].Clear();
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -744,12 +1103,22 @@ WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::Init(PacketBuffer * aBuf,
     mBuf            = aBuf;
     mSub            = aSubHandler;
     mMaxPayloadSize = aMaxPayloadSize;
+    mChainBuffers   = false;
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    mDataElementCache = NULL;
+#endif
 
 exit:
 
     return err;
 }
 
+void NotificationEngine::NotifyRequestBuilder::AllowChainedBuffers(uint32_t aMaxPayloadSize)
+{
+    mMaxPayloadSize = aMaxPayloadSize;
+    mChainBuffers   = true;
+}
+
 WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::StartNotifyRequest()
 {
     TLVType dummyType;
@@ -757,8 +1126,19 @@ WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::StartNotifyRequest()
 
     VerifyOrExit((mState == kNotifyRequestBuilder_Idle) && (mBuf != NULL), err = WEAVE_ERROR_INCORRECT_STATE);
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    mWriterStart = mBuf->DataLength();
+#endif
+
     mWriter->Init(mBuf, mMaxPayloadSize);
 
+    if (mChainBuffers)
+    {
+        mWriter->GetNewBuffer   = GetNewChainedBuffer;
+        mWriter->FinalizeBuffer = FinalizeChainedBuffer;
+        mWriter->AppData        = mBuf;
+    }
+
     err = mWriter->StartContainer(AnonymousTag, kTLVType_Structure, dummyType);
     SuccessOrExit(err);
 
@@ -857,16 +1237,42 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
                                                            SchemaVersion aSchemaVersion, PropertyPathHandle * aMergeDataHandleSet,
                                                            uint32_t aNumMergeDataHandles, PropertyPathHandle * aDeleteHandleSet,
                                                            uint32_t aNumDeleteHandles)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(mState == kNotifyRequestBuilder_BuildDataList, err = WEAVE_ERROR_INCORRECT_STATE);
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    if (mDataElementCache != NULL)
+    {
+        err = mDataElementCache->WriteDataElement(*this, aTraitDataHandle, aPropertyPathHandle, aSchemaVersion,
+                                                  aMergeDataHandleSet, aNumMergeDataHandles, aDeleteHandleSet, aNumDeleteHandles);
+        ExitNow();
+    }
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+
+    err = EncodeDataElement(*mWriter, aTraitDataHandle, aPropertyPathHandle, aSchemaVersion, aMergeDataHandleSet,
+                            aNumMergeDataHandles, aDeleteHandleSet, aNumDeleteHandles);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR
+NotificationEngine::NotifyRequestBuilder::EncodeDataElement(TLVWriter & aWriter, TraitDataHandle aTraitDataHandle,
+                                                            PropertyPathHandle aPropertyPathHandle, SchemaVersion aSchemaVersion,
+                                                            PropertyPathHandle * aMergeDataHandleSet, uint32_t aNumMergeDataHandles,
+                                                            PropertyPathHandle * aDeleteHandleSet, uint32_t aNumDeleteHandles)
 {
     WEAVE_ERROR err;
+    TLVType outerContainerType;
     TLVType dummyContainerType;
     TraitDataSource * dataSource;
     bool retrievingData = false;
     SchemaVersionRange versionRange;
 
-    VerifyOrExit(mState == kNotifyRequestBuilder_BuildDataList, err = WEAVE_ERROR_INCORRECT_STATE);
-
-    err = mWriter->StartContainer(AnonymousTag, kTLVType_Structure, dummyContainerType);
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, outerContainerType);
     SuccessOrExit(err);
 
     err = SubscriptionEngine::GetInstance()->mPublisherCatalog->Locate(aTraitDataHandle, &dataSource);
@@ -875,19 +1281,19 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
     versionRange.mMaxVersion = aSchemaVersion;
     versionRange.mMinVersion = dataSource->GetSchemaEngine()->GetLowestCompatibleVersion(versionRange.mMaxVersion);
 
-    err = mWriter->StartContainer(ContextTag(DataElement::kCsTag_Path), kTLVType_Path, dummyContainerType);
+    err = aWriter.StartContainer(ContextTag(DataElement::kCsTag_Path), kTLVType_Path, dummyContainerType);
     SuccessOrExit(err);
 
-    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->HandleToAddress(aTraitDataHandle, *mWriter, versionRange);
+    err = SubscriptionEngine::GetInstance()->mPublisherCatalog->HandleToAddress(aTraitDataHandle, aWriter, versionRange);
     SuccessOrExit(err);
 
-    err = dataSource->GetSchemaEngine()->MapHandleToPath(aPropertyPathHandle, *mWriter);
+    err = dataSource->GetSchemaEngine()->MapHandleToPath(aPropertyPathHandle, aWriter);
     SuccessOrExit(err);
 
-    err = mWriter->EndContainer(dummyContainerType);
+    err = aWriter.EndContainer(dummyContainerType);
     SuccessOrExit(err);
 
-    err = mWriter->Put(ContextTag(DataElement::kCsTag_Version), dataSource->GetVersion());
+    err = aWriter.Put(ContextTag(DataElement::kCsTag_Version), dataSource->GetVersion());
     SuccessOrExit(err);
 
     if (aNumMergeDataHandles > 0 || aNumDeleteHandles > 0)
@@ -897,24 +1303,23 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
         if (aNumDeleteHandles > 0)
         {
-            err =
-                mWriter->StartContainer(ContextTag(DataElement::kCsTag_DeletedDictionaryKeys), kTLVType_Array, dummyContainerType);
+            err = aWriter.StartContainer(ContextTag(DataElement::kCsTag_DeletedDictionaryKeys), kTLVType_Array, dummyContainerType);
             SuccessOrExit(err);
 
             for (size_t i = 0; i < aNumDeleteHandles; i++)
             {
-                err = mWriter->Put(AnonymousTag, GetPropertyDictionaryKey(aDeleteHandleSet[i]));
+                err = aWriter.Put(AnonymousTag, GetPropertyDictionaryKey(aDeleteHandleSet[i]));
                 SuccessOrExit(err);
             }
 
-            err = mWriter->EndContainer(dummyContainerType);
+            err = aWriter.EndContainer(dummyContainerType);
             SuccessOrExit(err);
         }
 #endif // TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 
         if (aNumMergeDataHandles > 0)
         {
-            err = mWriter->StartContainer(ContextTag(DataElement::kCsTag_Data), kTLVType_Structure, dummyContainerType);
+            err = aWriter.StartContainer(ContextTag(DataElement::kCsTag_Data), kTLVType_Structure, dummyContainerType);
             SuccessOrExit(err);
 
             retrievingData = true;
@@ -923,13 +1328,13 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
             {
                 WeaveLogDetail(DataManagement, "<NE::WriteDE> Merging in 0x%08x", aMergeDataHandleSet[i]);
 
-                err = dataSource->ReadData(aMergeDataHandleSet[i], schemaEngine->GetTag(aMergeDataHandleSet[i]), *mWriter);
+                err = dataSource->ReadData(aMergeDataHandleSet[i], schemaEngine->GetTag(aMergeDataHandleSet[i]), aWriter);
                 SuccessOrExit(err);
             }
 
             retrievingData = false;
 
-            err = mWriter->EndContainer(dummyContainerType);
+            err = aWriter.EndContainer(dummyContainerType);
             SuccessOrExit(err);
         }
     }
@@ -937,13 +1342,13 @@ NotificationEngine::NotifyRequestBuilder::WriteDataElement(TraitDataHandle aTrai
     {
         retrievingData = true;
 
-        err = dataSource->ReadData(aPropertyPathHandle, ContextTag(DataElement::kCsTag_Data), *mWriter);
+        err = dataSource->ReadData(aPropertyPathHandle, ContextTag(DataElement::kCsTag_Data), aWriter);
         SuccessOrExit(err);
 
         retrievingData = false;
     }
 
-    err = mWriter->EndContainer(kTLVType_Array);
+    err = aWriter.EndContainer(outerContainerType);
     SuccessOrExit(err);
 
 exit:
@@ -1024,19 +1429,271 @@ WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::Rollback(TLVWriter & aPoin
     *mWriter        = aPoint;
     return err;
 }
+
+/**
+ * Supply the next buffer of a chained notify request to the TLVWriter.  The buffer chain head is carried in the writer's
+ * AppData, so that the total length of the chain is kept up to date as buffers are filled.
+ */
+WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::GetNewChainedBuffer(TLVWriter & aWriter, uintptr_t & aBufHandle,
+                                                                          uint8_t *& aBufStart, uint32_t & aBufLen)
+{
+    WEAVE_ERROR err      = WEAVE_NO_ERROR;
+    PacketBuffer * head  = static_cast<PacketBuffer *>(aWriter.AppData);
+    PacketBuffer * buf   = reinterpret_cast<PacketBuffer *>(aBufHandle);
+    PacketBuffer * newBuf;
+
+    TrimBufferChain(head, buf);
+
+    newBuf = PacketBuffer::New(0);
+    VerifyOrExit(newBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    buf->AddToEnd(newBuf);
+
+    aBufHandle = reinterpret_cast<uintptr_t>(newBuf);
+    aBufStart  = newBuf->Start();
+    aBufLen    = newBuf->MaxDataLength();
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR NotificationEngine::NotifyRequestBuilder::FinalizeChainedBuffer(TLVWriter & aWriter, uintptr_t aBufHandle,
+                                                                            uint8_t * aBufStart, uint32_t aDataLen)
+{
+    PacketBuffer * head = static_cast<PacketBuffer *>(aWriter.AppData);
+    PacketBuffer * buf  = reinterpret_cast<PacketBuffer *>(aBufHandle);
+
+    TrimBufferChain(head, buf);
+
+    buf->SetDataLength(static_cast<uint16_t>(aBufStart + aDataLen - buf->Start()), head);
+
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ * Release the buffers following aBuf in the chain.  When the writer is rolled back to a checkpoint taken in an earlier
+ * buffer, the buffers it had moved on to hold abandoned data; they are dropped, and their lengths removed from the chain.
+ */
+void NotificationEngine::NotifyRequestBuilder::TrimBufferChain(PacketBuffer * aHead, PacketBuffer * aBuf)
+{
+    PacketBuffer * tail = aBuf->Next();
+
+    if (tail != NULL)
+    {
+        for (PacketBuffer * cur = tail; cur != NULL; cur = cur->Next())
+        {
+            cur->SetDataLength(0, aHead);
+        }
+
+        aBuf->DetachTail();
+        PacketBuffer::Free(tail);
+    }
+}
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+/**
+ * Copy out bytes the writer has produced so far, given their offset from where the writer began. Buffers that the writer has moved
+ * past were finalized and hold their final length; the last buffer in the chain holds whatever follows.
+ */
+void NotificationEngine::NotifyRequestBuilder::CopyWrittenData(uint32_t aOffset, uint32_t aLength, uint8_t * aDest) const
+{
+    const PacketBuffer * buf = mBuf;
+    const uint8_t * start    = mBuf->Start() + mWriterStart;
+
+    while (aLength > 0)
+    {
+        uint32_t avail = (buf->Next() != NULL) ? static_cast<uint32_t>(buf->Start() + buf->DataLength() - start) : UINT32_MAX;
+
+        if (aOffset >= avail)
+        {
+            aOffset -= avail;
+        }
+        else
+        {
+            uint32_t len = nl::Weave::min(avail - aOffset, aLength);
+
+            memcpy(aDest, start + aOffset, len);
+            aDest += len;
+            aLength -= len;
+            aOffset = 0;
+        }
+
+        buf   = buf->Next();
+        start = (buf != NULL) ? buf->Start() : NULL;
+    }
+}
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// DataElementCache
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void NotificationEngine::DataElementCache::Init()
+{
+    mNumHits   = 0;
+    mNumMisses = 0;
+
+    Reset();
+}
+
+void NotificationEngine::DataElementCache::Reset()
+{
+    mNumEntries = 0;
+    mArenaUsed  = 0;
+}
+
+NotificationEngine::DataElementCache::Entry *
+NotificationEngine::DataElementCache::Find(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle,
+                                           SchemaVersion aSchemaVersion, PropertyPathHandle * aMergeDataHandleSet,
+                                           uint32_t aNumMergeDataHandles, PropertyPathHandle * aDeleteHandleSet,
+                                           uint32_t aNumDeleteHandles)
+{
+    for (uint32_t i = 0; i < mNumEntries; i++)
+    {
+        Entry * entry = &mEntries[i];
+
+        if (entry->mTraitDataHandle != aTraitDataHandle || entry->mPropertyPathHandle != aPropertyPathHandle ||
+            entry->mSchemaVersion != aSchemaVersion || entry->mNumMergeDataHandles != aNumMergeDataHandles ||
+            entry->mNumDeleteHandles != aNumDeleteHandles)
+        {
+            continue;
+        }
+
+        // The handle sets are compared in order; the solver emits them in a deterministic order for a given dirty state.
+        if ((aNumMergeDataHandles > 0 &&
+             memcmp(entry->mMergeDataHandleSet, aMergeDataHandleSet, aNumMergeDataHandles * sizeof(PropertyPathHandle)) != 0) ||
+            (aNumDeleteHandles > 0 &&
+             memcmp(entry->mDeleteHandleSet, aDeleteHandleSet, aNumDeleteHandles * sizeof(PropertyPathHandle)) != 0))
+        {
+            continue;
+        }
+
+        return entry;
+    }
+
+    return NULL;
+}
+
+/**
+ * Copy a data element that was just encoded into a notify into the arena, if there is room for it. Elements that do not fit are
+ * simply not cached; they are encoded again for the next notify that needs them.
+ */
+void NotificationEngine::DataElementCache::Add(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle,
+                                               SchemaVersion aSchemaVersion, PropertyPathHandle * aMergeDataHandleSet,
+                                               uint32_t aNumMergeDataHandles, PropertyPathHandle * aDeleteHandleSet,
+                                               uint32_t aNumDeleteHandles, const NotifyRequestBuilder & aBuilder, uint32_t aOffset,
+                                               uint32_t aLength)
+{
+    Entry * entry;
+
+    VerifyOrExit(mNumEntries < WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE, /* no-op */);
+    VerifyOrExit(aNumMergeDataHandles <= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET &&
+                     aNumDeleteHandles <= WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET,
+                 /* no-op */);
+    VerifyOrExit(aLength >= 2 && aLength <= sizeof(mArena) - mArenaUsed, /* no-op */);
+
+    aBuilder.CopyWrittenData(aOffset, aLength, mArena + mArenaUsed);
+
+    // The element is encoded with an anonymous tag, so a single control byte opens the structure. Everything after it, up to and
+    // including the end-of-container byte, is what PutPreEncodedContainer() expects.
+    entry                       = &mEntries[mNumEntries++];
+    entry->mTraitDataHandle     = aTraitDataHandle;
+    entry->mPropertyPathHandle  = aPropertyPathHandle;
+    entry->mSchemaVersion       = aSchemaVersion;
+    entry->mOffset              = static_cast<uint16_t>(mArenaUsed + 1);
+    entry->mLength              = static_cast<uint16_t>(aLength - 1);
+    entry->mNumMergeDataHandles = static_cast<uint8_t>(aNumMergeDataHandles);
+    entry->mNumDeleteHandles    = static_cast<uint8_t>(aNumDeleteHandles);
+    memcpy(entry->mMergeDataHandleSet, aMergeDataHandleSet, aNumMergeDataHandles * sizeof(PropertyPathHandle));
+    memcpy(entry->mDeleteHandleSet, aDeleteHandleSet, aNumDeleteHandles * sizeof(PropertyPathHandle));
+
+    mArenaUsed += aLength;
+
+exit:
+    return;
+}
+
+WEAVE_ERROR NotificationEngine::DataElementCache::WriteDataElement(NotifyRequestBuilder & aBuilder, TraitDataHandle aTraitDataHandle,
+                                                                   PropertyPathHandle aPropertyPathHandle,
+                                                                   SchemaVersion aSchemaVersion,
+                                                                   PropertyPathHandle * aMergeDataHandleSet,
+                                                                   uint32_t aNumMergeDataHandles,
+                                                                   PropertyPathHandle * aDeleteHandleSet, uint32_t aNumDeleteHandles)
+{
+    WEAVE_ERROR err     = WEAVE_NO_ERROR;
+    TLVWriter & writer  = *aBuilder.mWriter;
+    Entry * entry       = Find(aTraitDataHandle, aPropertyPathHandle, aSchemaVersion, aMergeDataHandleSet, aNumMergeDataHandles,
+                         aDeleteHandleSet, aNumDeleteHandles);
+    uint32_t startOffset;
+
+    if (entry != NULL)
+    {
+        mNumHits++;
+
+        err = writer.PutPreEncodedContainer(AnonymousTag, kTLVType_Structure, mArena + entry->mOffset, entry->mLength);
+        SuccessOrExit(err);
+    }
+    else
+    {
+        mNumMisses++;
+
+        startOffset = writer.GetLengthWritten();
+
+        err = NotifyRequestBuilder::EncodeDataElement(writer, aTraitDataHandle, aPropertyPathHandle, aSchemaVersion,
+                                                      aMergeDataHandleSet, aNumMergeDataHandles, aDeleteHandleSet,
+                                                      aNumDeleteHandles);
+        SuccessOrExit(err);
+
+        Add(aTraitDataHandle, aPropertyPathHandle, aSchemaVersion, aMergeDataHandleSet, aNumMergeDataHandles, aDeleteHandleSet,
+            aNumDeleteHandles, aBuilder, startOffset, writer.GetLengthWritten() - startOffset);
+    }
+
+exit:
+    return err;
+}
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // NotificationEngine
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 WEAVE_ERROR NotificationEngine::Init()
 {
-    mCurSubscriptionHandlerIdx = 0;
-    mCurTraitInstanceIdx       = 0;
-    mNumNotifiesInFlight       = 0;
+    // Drop any coalescing timer left over from a previous incarnation of the engine.
+    Shutdown();
+
+    mReadyQueueHead      = 0;
+    mReadyQueueCount     = 0;
+    mCurTraitInstanceIdx = 0;
+    mNumNotifiesInFlight = 0;
+
+    // Pick up whatever was logged before the engine came up.
+    mEventsLogged = true;
+
+    memset(mIsReady, 0, sizeof(mIsReady));
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    mDataElementCache.Init();
+#endif
 
     return WEAVE_NO_ERROR;
 }
 
+void NotificationEngine::Shutdown()
+{
+    WeaveExchangeManager * exchangeMgr = SubscriptionEngine::GetInstance()->GetExchangeManager();
+
+    if ((exchangeMgr != NULL) && (exchangeMgr->MessageLayer != NULL) && (exchangeMgr->MessageLayer->SystemLayer != NULL))
+    {
+        exchangeMgr->MessageLayer->SystemLayer->CancelTimer(Run, this);
+    }
+
+    mReadyQueueHead  = 0;
+    mReadyQueueCount = 0;
+
+    memset(mIsReady, 0, sizeof(mIsReady));
+}
+
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
 WEAVE_ERROR NotificationEngine::DeleteKey(TraitDataSource * aDataSource, PropertyPathHandle aPropertyHandle)
 {
@@ -1056,6 +1713,11 @@ WEAVE_ERROR NotificationEngine::DeleteKey(TraitDataSource * aDataSource, Propert
     err = mGraphSolver.DeleteKey(dataHandle, aPropertyHandle);
     SuccessOrExit(err);
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    // Any data elements encoded for this pass may now be stale.
+    mDataElementCache.Reset();
+#endif
+
 exit:
     if (isLocked)
     {
@@ -1084,6 +1746,11 @@ WEAVE_ERROR NotificationEngine::SetDirty(TraitDataSource * aDataSource, Property
     err = mGraphSolver.SetDirty(dataHandle, aPropertyHandle);
     SuccessOrExit(err);
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    // Any data elements encoded for this pass may now be stale.
+    mDataElementCache.Reset();
+#endif
+
 exit:
     if (isLocked)
     {
@@ -1101,8 +1768,7 @@ WEAVE_ERROR NotificationEngine::RetrieveTraitInstanceData(SubscriptionHandler *
 
     *aPacketFull = false;
 
-    err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitInfo->mTraitDataHandle, aTraitInfo->mRequestedVersion,
-                                                 aSubHandler->IsSubscribing());
+    err = mGraphSolver.RetrieveTraitInstanceData(aBuilder, aTraitInfo, aSubHandler->IsSubscribing());
     SuccessOrExit(err);
 
     // Clear out the dirty bit since we're done processing this trait instance.
@@ -1155,10 +1821,77 @@ void NotificationEngine::OnNotifyConfirm(SubscriptionHandler * aSubHandler, bool
         }
     }
 
+    // The subscription may have more work to do now that its notify is out of the way.
+    EnqueueSubscription(aSubHandler, false);
+
     // Run NE again now that a notify has come back/error'ed out and that we might be able to do more work.
     Run();
 }
 
+void NotificationEngine::EnqueueSubscription(SubscriptionHandler * aSubHandler, bool aIsDataChange)
+{
+    uint16_t handlerIdx = SubscriptionEngine::GetInstance()->GetHandlerId(aSubHandler);
+
+    if (aIsDataChange)
+    {
+        uint64_t now = System::Layer::GetClock_MonotonicMS();
+
+        if (aSubHandler->mFirstDirtyTimeMsec == 0)
+        {
+            aSubHandler->mFirstDirtyTimeMsec = now;
+        }
+
+        aSubHandler->mLastDirtyTimeMsec = now;
+    }
+
+    if (!mIsReady[handlerIdx])
+    {
+        mIsReady[handlerIdx] = true;
+        mReadyQueue[(mReadyQueueHead + mReadyQueueCount) % WDM_MAX_NUM_SUBSCRIPTION_HANDLERS] = handlerIdx;
+        mReadyQueueCount++;
+    }
+}
+
+void NotificationEngine::OnEventLogged()
+{
+    // May be called from any thread, so only flag the engine here and leave the queue to the next run.
+    mEventsLogged = true;
+}
+
+void NotificationEngine::EnqueueEventSubscriptions()
+{
+    SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
+    LoggingManagement & logger     = LoggingManagement::GetInstance();
+
+    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; ++i)
+    {
+        SubscriptionHandler * subHandler = &subEngine->mHandlers[i];
+
+        if (!mIsReady[i] && subHandler->IsActive() && subHandler->mSubscribeToAllEvents && !subHandler->CheckEventUpToDate(logger))
+        {
+            EnqueueSubscription(subHandler, false);
+        }
+    }
+}
+
+uint64_t NotificationEngine::GetNotifyDueTime(SubscriptionHandler * aSubHandler)
+{
+    uint64_t dueTime;
+    uint64_t deadline;
+
+    // Subscriptions being primed and those without pending data changes are never held back.
+    if (aSubHandler->IsSubscribing() || aSubHandler->mMinNotifyIntervalMsec == 0 || aSubHandler->mFirstDirtyTimeMsec == 0)
+    {
+        return 0;
+    }
+
+    dueTime  = aSubHandler->mLastDirtyTimeMsec + aSubHandler->mMinNotifyIntervalMsec;
+    deadline = aSubHandler->mFirstDirtyTimeMsec +
+        ((aSubHandler->mMaxNotifyIntervalMsec != 0) ? aSubHandler->mMaxNotifyIntervalMsec : aSubHandler->mMinNotifyIntervalMsec);
+
+    return (dueTime < deadline) ? dueTime : deadline;
+}
+
 /**
  *  @brief
  *    Given the `SubscriptionHandler`, fill in the `EventList` element
@@ -1483,9 +2216,12 @@ exit:
  *  properties are serialized first and events are serialized into
  *  space leftover after the properties have been serialized.
  *
- *  The function allocates at most one `PacketBuffer`.  At the end of
- *  the function, either the ownership of this buffer is passed to the
- *  `WeaveMessageLayer` or the buffer is de-allocated.
+ *  The function allocates at most one `PacketBuffer`, unless the
+ *  subscription's binding allows chained messages, in which case the
+ *  request may grow into a chain of buffers up to the binding's
+ *  limit.  At the end of the function, either the ownership of the
+ *  buffers is passed to the `WeaveMessageLayer` or they are
+ *  de-allocated.
  *
  *  If the function encounters any error that's not a WEAVE_ERR_MEM,
  *  the function will abort the subscription.
@@ -1523,6 +2259,7 @@ WEAVE_ERROR NotificationEngine::BuildSingleNotifyRequest(SubscriptionHandler * a
     bool neWriteInProgress = false;
     uint32_t maxNotificationSize = 0;
     uint32_t maxPayloadSize = 0;
+    uint32_t maxChainedPayloadSize = 0;
 
     aIsSubscriptionClean = true; // assume no work it to be done
 
@@ -1543,6 +2280,18 @@ WEAVE_ERROR NotificationEngine::BuildSingleNotifyRequest(SubscriptionHandler * a
     err = notifyRequest.Init(buf, &writer, aSubHandler, maxPayloadSize);
     SuccessOrExit(err);
 
+    // Over transports that carry messages larger than a single buffer, let the request span a buffer chain so that large
+    // trait snapshots can be sent in one notify.
+    maxChainedPayloadSize = nl::Weave::min(aSubHandler->mBinding->GetMaxChainedPayloadSize(), maxNotificationSize);
+    if (maxChainedPayloadSize > maxPayloadSize)
+    {
+        notifyRequest.AllowChainedBuffers(maxChainedPayloadSize);
+    }
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    notifyRequest.SetDataElementCache(&mDataElementCache);
+#endif
+
     // Fill in the DataList.  Allocation may take place
     subClean = true;
 
@@ -1719,12 +2468,12 @@ void NotificationEngine::ScheduleRun()
 
 void NotificationEngine::Run()
 {
-    WEAVE_ERROR err                  = WEAVE_NO_ERROR;
-    uint32_t numSubscriptionsHandled = 0;
-    SubscriptionEngine * subEngine   = SubscriptionEngine::GetInstance();
-    SubscriptionHandler * subHandler = subEngine->mHandlers + mCurSubscriptionHandlerIdx;
+    WEAVE_ERROR err                = WEAVE_NO_ERROR;
+    SubscriptionEngine * subEngine = SubscriptionEngine::GetInstance();
+    uint32_t numToEvaluate;
+    uint64_t now;
+    uint64_t nextDueTime = UINT64_MAX;
     bool subscriptionHandled, isSubscriptionClean;
-    bool isClean  = true;
     bool isLocked = false;
 
     // Lock before attempting to modify any of the shared data structures.
@@ -1733,82 +2482,105 @@ void NotificationEngine::Run()
 
     isLocked = true;
 
-    WeaveLogDetail(DataManagement, "<NE:Run> NotifiesInFlight = %u", mNumNotifiesInFlight);
+    WeaveLogDetail(DataManagement, "<NE:Run> NotifiesInFlight = %u, Queued = %u", mNumNotifiesInFlight, mReadyQueueCount);
+
+    now = System::Layer::GetClock_MonotonicMS();
+
+    // Events are logged without going through the engine, so pick up the event subscriptions that have fallen behind the log.
+    if (__sync_bool_compare_and_swap(&mEventsLogged, true, false))
+    {
+        EnqueueEventSubscriptions();
+    }
+
+    // Every queued subscription is evaluated at most once per run. Those that still have work left afterwards go to the back of
+    // the queue.
+    numToEvaluate = mReadyQueueCount;
 
-    while ((mNumNotifiesInFlight < WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT) &&
-           (numSubscriptionsHandled < SubscriptionEngine::kMaxNumSubscriptionHandlers))
+    while ((mNumNotifiesInFlight < WDM_PUBLISHER_MAX_NOTIFIES_IN_FLIGHT) && (numToEvaluate > 0))
     {
-        subscriptionHandled = true;
+        uint16_t handlerIdx              = mReadyQueue[mReadyQueueHead];
+        SubscriptionHandler * subHandler = subEngine->mHandlers + handlerIdx;
+        bool keepQueued                  = subHandler->IsActive();
+
+        mReadyQueueHead = (mReadyQueueHead + 1) % WDM_MAX_NUM_SUBSCRIPTION_HANDLERS;
+        mReadyQueueCount--;
+        numToEvaluate--;
 
         // limit the prints to handlers that are in meaingful subscribing/notifying states.
         if (subHandler->IsNotifying() || subHandler->IsSubscribing())
         {
-            WeaveLogDetail(DataManagement, "<NE:Run> Eval Subscription: %u (state = %s, num-traits = %u)!",
-                           mCurSubscriptionHandlerIdx, subHandler->GetStateStr(), subHandler->GetNumTraitInstances());
+            WeaveLogDetail(DataManagement, "<NE:Run> Eval Subscription: %u (state = %s, num-traits = %u)!", handlerIdx,
+                           subHandler->GetStateStr(), subHandler->GetNumTraitInstances());
         }
 
         if (subHandler->IsNotifiable())
         {
-            // This is needed because some error could trigger abort on subscription, which leads to destroy of the handler
-            subHandler->_AddRef();
-            err = BuildSingleNotifyRequest(subHandler, subscriptionHandled, isSubscriptionClean);
-            SuccessOrExit(err);
+            uint64_t dueTime = GetNotifyDueTime(subHandler);
+
+            if (dueTime > now)
+            {
+                WeaveLogDetail(DataManagement, "<NE:Run> Subscription %u coalescing for %u ms", handlerIdx,
+                               static_cast<uint32_t>(dueTime - now));
 
-            if (isSubscriptionClean)
+                if (dueTime < nextDueTime)
+                {
+                    nextDueTime = dueTime;
+                }
+            }
+            else
             {
-                // TODO: notification based on the event list state.
-                subHandler->OnNotifyProcessingComplete(false, NULL, 0);
+                // This is needed because some error could trigger abort on subscription, which leads to destroy of the handler
+                subHandler->_AddRef();
+                err = BuildSingleNotifyRequest(subHandler, subscriptionHandled, isSubscriptionClean);
+
+                if (err == WEAVE_NO_ERROR && isSubscriptionClean)
+                {
+                    subHandler->mFirstDirtyTimeMsec = 0;
+                    keepQueued                      = false;
+
+                    // TODO: notification based on the event list state.
+                    subHandler->OnNotifyProcessingComplete(false, NULL, 0);
+                }
+                subHandler->_Release();
             }
-            subHandler->_Release();
         }
 
-        if (subscriptionHandled)
+        if (keepQueued)
         {
-            numSubscriptionsHandled++;
+            mReadyQueue[(mReadyQueueHead + mReadyQueueCount) % WDM_MAX_NUM_SUBSCRIPTION_HANDLERS] = handlerIdx;
+            mReadyQueueCount++;
         }
         else
         {
-            WeaveLogDetail(DataManagement, "<NE:Run> Subscription %u not handled", mCurSubscriptionHandlerIdx);
-            numSubscriptionsHandled = 0;
+            mIsReady[handlerIdx] = false;
         }
 
-        mCurSubscriptionHandlerIdx = (mCurSubscriptionHandlerIdx + 1) % SubscriptionEngine::kMaxNumSubscriptionHandlers;
-        subHandler                 = subEngine->mHandlers + mCurSubscriptionHandlerIdx;
+        SuccessOrExit(err);
     }
 
-    subHandler = subEngine->mHandlers;
-    isClean    = true;
-
-    // We only wipe our granular dirty stores if all the subscriptions are clean. To do so, we iterate over
-    // all of them and check each of their dirty flags.
-    for (int i = 0; i < SubscriptionEngine::kMaxNumSubscriptionHandlers; i++)
+    // We only wipe our granular dirty stores if all the subscriptions are clean.
+    if (subEngine->mNumDirtyTraitInfos != 0)
     {
-        if (subHandler->IsActive())
-        {
-            SubscriptionHandler::TraitInstanceInfo * traitInfo = subHandler->GetTraitInstanceInfoList();
-            for (size_t j = 0; j < subHandler->GetNumTraitInstances(); j++)
-            {
-                if (traitInfo->IsDirty())
-                {
-                    WeaveLogDetail(DataManagement, "<NE:Run> S%u:T%u still dirty", i, j);
-                    isClean = false;
-                    break;
-                }
-
-                traitInfo++;
-            }
-        }
-
-        subHandler++;
+        WeaveLogDetail(DataManagement, "<NE:Run> %u trait instances still dirty", subEngine->mNumDirtyTraitInfos);
     }
-
-    if (isClean)
+    else
     {
         WeaveLogDetail(DataManagement, "<NE> Done processing!");
         mGraphSolver.ClearDirty();
     }
 
+    // Come back once the earliest of the coalesced subscriptions is due.
+    if (nextDueTime != UINT64_MAX)
+    {
+        subEngine->GetExchangeManager()->MessageLayer->SystemLayer->StartTimer(static_cast<uint32_t>(nextDueTime - now), Run, this);
+    }
+
 exit:
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    // Cached data elements are only valid for the duration of a single pass; the data sources are free to change once we unlock.
+    mDataElementCache.Reset();
+#endif
+
     if (isLocked)
     {
         subEngine->Unlock();
@@ -67,14 +67,17 @@ public:
  *           engine will mark dirtiness down to the property handle. This allows it to generate compact notifies that convey as
  *           succinctly as possible the data that has changed. This will be described in more detail in the solvers section.
  *
- *         At its core, it iterates over every subscription, then every dirty instance within that subscription and tries to gather
- *         and pack as much relevant data as possible into a notify message before sending that to the subscriber. It continues to
- *         do so until it has no more work to do. This could be due to a couple of reasons:
+ *         At its core, it iterates over every subscription that has been queued up as having work to do (dirty data, pending
+ *         events or a state change), then every dirty instance within that subscription and tries to gather and pack as much
+ *         relevant data as possible into a notify message before sending that to the subscriber. It continues to do so until it has
+ *         no more work to do. This could be due to a couple of reasons:
  *
  *         - Notifies are in flight to the subscriber(s)
  *         - We have exceeded the maximum number of notifies that can be flight across all subscribers.
  *         - We have no more space in the packet to stuff in more data.
  *         - We have no more dirty data to process for a particular set of subscriptions.
+ *         - The data changes of a subscription are being held back to be coalesced with further changes (see
+ *           SubscriptionHandler::SetNotifyIntervals). A timer brings the engine back once they are due.
  *
  *         Once it surmises there is no more work to be done, it returns. If all work for a subscription has been completed, it will
  *         invoke a method in the SubscriptionHandler to finish processing that subscription (which might involve sending out
@@ -85,8 +88,8 @@ public:
  *
  *         Some notable features:
  *
- *         - Subscription fairness: The engine round-robins over all subscriptions and will always resume its work loop at the last
- *           subscription it was trying to process to ensure all subscriptions are handled with equal priority.
+ *         - Subscription fairness: The engine evaluates queued subscriptions in FIFO order. A subscription that still has work left
+ *           after being evaluated goes to the back of the queue to ensure all subscriptions are handled with equal priority.
  *
  *         - Trait instance fairness: Within a subscription, the engine also rounds robins over all trait instances and will resume
  *           its work loop at the last trait instance that was being processed *for that subscription*. This ensures trait instances
@@ -110,6 +113,12 @@ public:
      */
     WEAVE_ERROR Init(void);
 
+    /**
+     * Cancels any pending coalescing timer and empties the ready queue. Invoked when the publisher is disabled and on
+     * re-initialization.
+     */
+    void Shutdown(void);
+
     /**
      * Main work-horse function that executes the run-loop.
      */
@@ -120,6 +129,12 @@ public:
      */
     void ScheduleRun(void);
 
+    /**
+     * Invoked by the logger whenever an event has been logged. Safe to call from any thread; the event subscriptions are picked
+     * up on the next run.
+     */
+    void OnEventLogged(void);
+
     /**
      * Marks a handle associated with a data source as being dirty.
      *
@@ -142,6 +157,80 @@ public:
         kNotifyRequestBuilder_BuildEventList ///< The request is building the EventList portion of the structure
     };
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    class NotifyRequestBuilder;
+
+    /**
+     *  @class DataElementCache
+     *
+     *  @brief Retains the encoded form of the data elements generated during a single pass of the run-loop. Subscriptions that are
+     *         interested in the same dirty trait instance usually end up with identical data elements in their notifies; the cache
+     *         lets the engine serialize such a data element once and copy the encoded bytes into every subsequent notify.
+     *
+     *         Entries are keyed on the trait data handle, the property path handle, the requested schema version and the
+     *         merge/delete handle sets computed by the solver. On a miss, the data element is encoded directly into the notify and
+     *         its bytes are then copied into a fixed arena, packed back-to-back, if there is room left for them; each data element
+     *         is therefore encoded at most once per notify. The engine resets the cache at the end of every pass and whenever a data
+     *         source is marked dirty.
+     */
+    class DataElementCache
+    {
+    public:
+        /**
+         * Initializes the cache and its hit/miss counters.
+         */
+        void Init(void);
+
+        /**
+         * Drops all cached data elements. The hit/miss counters are left untouched.
+         */
+        void Reset(void);
+
+        /**
+         * Write out the data element for the given path into the builder's notify, re-using a previously encoded copy of it if
+         * one is present in the cache. The remaining arguments match those of NotifyRequestBuilder::WriteDataElement.
+         *
+         * @retval #WEAVE_NO_ERROR On success.
+         * @retval other           Unable to retrieve and write the data element.
+         */
+        WEAVE_ERROR WriteDataElement(NotifyRequestBuilder & aBuilder, TraitDataHandle aTraitDataHandle,
+                                     PropertyPathHandle aPropertyPathHandle, SchemaVersion aSchemaVersion,
+                                     PropertyPathHandle * aMergeDataHandleSet, uint32_t aNumMergeDataHandles,
+                                     PropertyPathHandle * aDeleteHandleSet, uint32_t aNumDeleteHandles);
+
+        uint32_t GetNumHits(void) const { return mNumHits; }
+        uint32_t GetNumMisses(void) const { return mNumMisses; }
+
+    private:
+        struct Entry
+        {
+            TraitDataHandle mTraitDataHandle;
+            PropertyPathHandle mPropertyPathHandle;
+            SchemaVersion mSchemaVersion;
+            uint16_t mOffset;
+            uint16_t mLength;
+            uint8_t mNumMergeDataHandles;
+            uint8_t mNumDeleteHandles;
+            PropertyPathHandle mMergeDataHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET];
+            PropertyPathHandle mDeleteHandleSet[WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET];
+        };
+
+        Entry * Find(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle, SchemaVersion aSchemaVersion,
+                     PropertyPathHandle * aMergeDataHandleSet, uint32_t aNumMergeDataHandles,
+                     PropertyPathHandle * aDeleteHandleSet, uint32_t aNumDeleteHandles);
+        void Add(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle, SchemaVersion aSchemaVersion,
+                 PropertyPathHandle * aMergeDataHandleSet, uint32_t aNumMergeDataHandles, PropertyPathHandle * aDeleteHandleSet,
+                 uint32_t aNumDeleteHandles, const NotifyRequestBuilder & aBuilder, uint32_t aOffset, uint32_t aLength);
+
+        Entry mEntries[WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE];
+        uint8_t mArena[WDM_PUBLISHER_DATA_ELEMENT_CACHE_ARENA_SIZE];
+        uint32_t mNumEntries;
+        uint32_t mArenaUsed;
+        uint32_t mNumHits;
+        uint32_t mNumMisses;
+    };
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+
     /**
      *  @class NotifyRequestBuilder
      *
@@ -249,6 +338,14 @@ public:
 
         TLV::TLVWriter * GetWriter(void) { return mWriter; }
 
+        /**
+         * Allow the request to grow beyond the buffer passed to Init() by chaining further PacketBuffers to it, up to the given
+         * total payload size. Must be called before the request is started.
+         *
+         * @param[in] aMaxPayloadSize The maximum size of the request payload across the buffer chain.
+         */
+        void AllowChainedBuffers(uint32_t aMaxPayloadSize);
+
         /**
          * The main state transition function. The function takes the desired state (i.e., the phase of the notify request builder
          * that we would like to reach), and transitions the request into that state. If the desired state is the same as the
@@ -267,12 +364,41 @@ public:
          */
         WEAVE_ERROR MoveToState(NotifyRequestBuilderState aDesiredState);
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+        /**
+         * Route data elements written by this builder through a cache of encoded data elements. Pass NULL to have every data
+         * element encoded afresh.
+         */
+        void SetDataElementCache(DataElementCache * aCache) { mDataElementCache = aCache; }
+#endif
+
     private:
+        friend class DataElementCache;
+
+        static WEAVE_ERROR EncodeDataElement(TLV::TLVWriter & aWriter, TraitDataHandle aTraitDataHandle,
+                                             PropertyPathHandle aPropertyPathHandle, SchemaVersion aSchemaVersion,
+                                             PropertyPathHandle * aMergeDataHandleSet, uint32_t aNumMergeDataHandles,
+                                             PropertyPathHandle * aDeleteHandleSet, uint32_t aNumDeleteHandles);
+
+        static WEAVE_ERROR GetNewChainedBuffer(TLV::TLVWriter & aWriter, uintptr_t & aBufHandle, uint8_t *& aBufStart,
+                                               uint32_t & aBufLen);
+        static WEAVE_ERROR FinalizeChainedBuffer(TLV::TLVWriter & aWriter, uintptr_t aBufHandle, uint8_t * aBufStart,
+                                                 uint32_t aDataLen);
+        static void TrimBufferChain(PacketBuffer * aHead, PacketBuffer * aBuf);
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+        void CopyWrittenData(uint32_t aOffset, uint32_t aLength, uint8_t * aDest) const;
+#endif
+
         TLV::TLVWriter * mWriter;
         NotifyRequestBuilderState mState;
         PacketBuffer * mBuf;
         SubscriptionHandler * mSub;
         uint32_t mMaxPayloadSize;
+        bool mChainBuffers;
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+        DataElementCache * mDataElementCache;
+        uint16_t mWriterStart; ///< Where in mBuf the writer began writing
+#endif
     };
 
     /*
@@ -307,10 +433,11 @@ public:
     {
     public:
         static bool IsPropertyPathSupported(PropertyPathHandle aHandle);
-        WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, TraitDataHandle aTraitDataHandle,
-                                              SchemaVersion aSchemaVersion, bool aRetrieveAll);
+        WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                              bool aRetrieveAll);
         static WEAVE_ERROR SetDirty(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyHandle);
         WEAVE_ERROR ClearDirty(void);
+        void ReclaimTraitInstances(size_t aFirstIndex, size_t aNumReclaimed, size_t aNumInPool) { }
     };
 
     /*
@@ -332,8 +459,8 @@ public:
     {
     public:
         static bool IsPropertyPathSupported(PropertyPathHandle aHandle);
-        WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, TraitDataHandle aTraitDataHandle,
-                                              SchemaVersion aSchemaVersion, bool aRetrieveAll);
+        WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                              bool aRetrieveAll);
         WEAVE_ERROR SetDirty(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyHandle);
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
@@ -341,6 +468,7 @@ public:
 #endif
 
         WEAVE_ERROR ClearDirty(void);
+        void ReclaimTraitInstances(size_t aFirstIndex, size_t aNumReclaimed, size_t aNumInPool) { }
 
         struct Store
         {
@@ -361,7 +489,15 @@ public:
         };
 
     private:
+        struct CandidateContext
+        {
+            IntermediateGraphSolver * mSolver;
+            TraitDataHandle mDataHandle;
+        };
+
         static void ClearTraitInstanceDirty(void * aDataSource, TraitDataHandle aDataHandle, void * aContext);
+        static PropertyPathHandle GetNextCandidateHandle(void * aContext, uint32_t & aChangeStoreCursor,
+                                                         bool & aCandidateHandleIsDelete);
         PropertyPathHandle GetNextCandidateHandle(uint32_t & aChangeStoreCursor, TraitDataHandle aTargetDataHandle,
                                                   bool & aCandidateHandleIsDelete);
 
@@ -372,8 +508,92 @@ public:
 #endif
     };
 
+    /*
+     *  @class BitmapGraphSolver
+     *
+     *  @brief This solver tracks dirtiness as a bitmap of property schema handles, kept separately for every subscribed trait
+     *         instance of every subscription. Marking a handle dirty is a matter of setting a bit for each interested subscription
+     *         and the bitmaps cannot overflow. Since each subscription's dirtiness is reset once its own notify has been generated,
+     *         a slow subscriber never forces the whole trait instance to be re-sent to the others.
+     *
+     *         Changes to and deletions of dictionary elements carry their keys and are kept alongside the bitmap in small
+     *         per-subscription lists. If those lists overflow, the dictionary is marked dirty and replaced as a whole.
+     *
+     *         Notifies are generated with the same LCA/merge/delete computation as the IntermediateGraphSolver. Schema handles
+     *         beyond WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES mark the trait instance dirty at the root.
+     *
+     */
+    class BitmapGraphSolver
+    {
+    public:
+        BitmapGraphSolver();
+
+        static bool IsPropertyPathSupported(PropertyPathHandle aHandle);
+        WEAVE_ERROR RetrieveTraitInstanceData(NotifyRequestBuilder * aBuilder, SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
+                                              bool aRetrieveAll);
+        WEAVE_ERROR SetDirty(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyHandle);
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+        WEAVE_ERROR DeleteKey(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyHandle);
+#endif
+
+        WEAVE_ERROR ClearDirty(void);
+
+        /**
+         * Should be invoked when the subscription engine releases the trait instances at [aFirstIndex, aFirstIndex + aNumReclaimed)
+         * of its pool of aNumInPool trait instances and moves the ones after them forward, so that the dirtiness of the moved
+         * trait instances follows them and a trait instance handed out again starts clean.
+         */
+        void ReclaimTraitInstances(size_t aFirstIndex, size_t aNumReclaimed, size_t aNumInPool);
+
+    private:
+        enum
+        {
+            kBitsPerWord      = 32,
+            kNumWordsInBitmap = (WDM_PUBLISHER_BITMAP_SOLVER_MAX_PROPERTY_HANDLES + kBitsPerWord - 1) / kBitsPerWord,
+        };
+
+        /*
+         * The dirtiness of one trait instance of one subscription.
+         */
+        struct TraitInstanceState
+        {
+            void Clear(void);
+            bool IsHandleDirty(PropertySchemaHandle aSchemaHandle) const;
+            void AddChange(const TraitSchemaEngine * aSchemaEngine, PropertyPathHandle aPropertyHandle, bool aIsDelete);
+
+            uint32_t mDirtyBitmap[kNumWordsInBitmap];
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+            PropertyPathHandle mDirtyItems[WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS];
+            PropertyPathHandle mDeletedItems[WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS];
+            uint8_t mNumDirtyItems;
+            uint8_t mNumDeletedItems;
+
+        private:
+            void AddDictionaryChange(const TraitSchemaEngine * aSchemaEngine, PropertyPathHandle aPropertyHandle,
+                                     PropertyPathHandle aDictionaryItemHandle, bool aIsDelete);
+            void RemoveDictionaryItems(const TraitSchemaEngine * aSchemaEngine, PropertyPathHandle aDictionaryHandle);
+#endif
+        };
+
+        TraitInstanceState * GetState(SubscriptionHandler::TraitInstanceInfo * aTraitInfo);
+        WEAVE_ERROR AddChange(TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyHandle, bool aIsDelete);
+        static PropertyPathHandle GetNextCandidateHandle(void * aContext, uint32_t & aCursor, bool & aCandidateHandleIsDelete);
+
+        TraitInstanceState mTraitInstances[WDM_PUBLISHER_MAX_NUM_PATH_GROUPS];
+    };
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    /**
+     * Returns the cache of encoded data elements, mostly for the purposes of inspecting its hit/miss counters.
+     */
+    const DataElementCache & GetDataElementCache(void) const { return mDataElementCache; }
+#endif
+
 private:
     friend class SubscriptionHandler;
+    friend class SubscriptionEngine;
     friend class UpdateClient;
     friend class TestTdm;
     friend class TestWdm;
@@ -387,6 +607,22 @@ private:
      */
     void OnNotifyConfirm(SubscriptionHandler * aSubHandler, bool aNotifyDelivered);
 
+    /**
+     * Queues a subscription up for evaluation on the next run. Only queued subscriptions are looked at by the run-loop; a
+     * subscription stays queued until it has been evaluated and found to have no work left.
+     *
+     * @param[in] aSubHandler    The subscription to queue up.
+     * @param[in] aIsDataChange  True if the subscription is being queued because some of its data changed, which starts or extends
+     *                           the coalescing window of the subscription.
+     */
+    void EnqueueSubscription(SubscriptionHandler * aSubHandler, bool aIsDataChange);
+
+    /**
+     * Returns the time at which a queued subscription is due to be sent its pending data changes, taking its notify intervals
+     * into account. A return value of 0 means right away.
+     */
+    static uint64_t GetNotifyDueTime(SubscriptionHandler * aSubHandler);
+
     WEAVE_ERROR BuildSingleNotifyRequestDataList(SubscriptionHandler * aSubHandler, NotifyRequestBuilder & aNotifyRequest,
                                                  bool & isSubscriptionClean, bool & aNeWriteInProgress);
     WEAVE_ERROR BuildSingleNotifyRequestEventList(SubscriptionHandler * aSubHandler, NotifyRequestBuilder & aNotifyRequest,
@@ -396,21 +632,54 @@ private:
 
     WEAVE_ERROR RetrieveTraitInstanceData(SubscriptionHandler * aSubHandler, SubscriptionHandler::TraitInstanceInfo * aTraitInfo,
                                           NotifyRequestBuilder * aBuilder, bool * aPacketFull);
+
+    /**
+     * Hands out the dirty and deleted handles of a trait instance one at a time, advancing aCursor (which starts at 0). Returns
+     * kNullPropertyPathHandle once there are no handles left.
+     */
+    typedef PropertyPathHandle (*GetNextCandidateHandleFunct)(void * aContext, uint32_t & aCursor, bool & aCandidateHandleIsDelete);
+
+    /**
+     * Computes the path of the single data element that covers all the changes handed out by aGetNextCandidateHandle, along with
+     * the handles to merge in and the dictionary elements to delete relative to it. Shared by the graph solvers.
+     *
+     * aCommonHandle is left as kNullPropertyPathHandle if there were no candidates. aNumMergeHandles is set to -1 if the merge
+     * handle set overflowed, in which case all children of aCommonHandle are to be included. Both handle sets need room for
+     * WDM_PUBLISHER_INTERMEDIATE_SOLVER_MAX_MERGE_HANDLE_SET handles.
+     */
+    static WEAVE_ERROR ComputeDataElementPaths(const TraitSchemaEngine * aSchemaEngine,
+                                               GetNextCandidateHandleFunct aGetNextCandidateHandle, void * aContext,
+                                               PropertyPathHandle & aCommonHandle, PropertyPathHandle * aMergeHandleSet,
+                                               int32_t & aNumMergeHandles, PropertyPathHandle * aDeleteHandleSet,
+                                               int32_t & aNumDeleteHandles);
     WEAVE_ERROR SendNotify(PacketBuffer * aBuf, SubscriptionHandler * aSubHandler);
 
     WEAVE_ERROR SendNotifyRequest();
 
     static void Run(System::Layer * aSystemLayer, void * aAppState, System::Error);
 
+    /**
+     * Queues every subscription that has subscribed to events and has not yet been sent the latest logged events up for
+     * evaluation. Invoked at the start of a run if events were logged since the previous one.
+     */
+    void EnqueueEventSubscriptions(void);
+
 #if WDM_ENABLE_SUBSCRIPTIONLESS_NOTIFICATION
     WEAVE_ERROR BuildSubscriptionlessNotification(PacketBuffer *msgBuf, uint32_t maxPayloadSize, TraitPath *aPathList,
                                                   uint16_t aPathListSize);
 #endif // WDM_ENABLE_SUBSCRIPTIONLESS_NOTIFICATION
-    uint32_t mCurSubscriptionHandlerIdx;
+    uint16_t mReadyQueue[WDM_MAX_NUM_SUBSCRIPTION_HANDLERS];
+    bool mIsReady[WDM_MAX_NUM_SUBSCRIPTION_HANDLERS];
+    uint32_t mReadyQueueHead;
+    uint32_t mReadyQueueCount;
     uint32_t mCurTraitInstanceIdx;
     uint32_t mNumNotifiesInFlight;
+    bool mEventsLogged;
     nl::Weave::TLV::TLVType mOuterContainerType;
     WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER mGraphSolver;
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    DataElementCache mDataElementCache;
+#endif
 };
 
 }; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
@@ -146,6 +146,10 @@ WEAVE_ERROR SubscriptionClient::Init(Binding * const apBinding, void * const apA
     mUpdateInFlight                         = false;
     mMaxUpdateSize                          = 0;
 
+#if WDM_UPDATE_PATH_STORE_INDEX_SIZE > 0
+    mPendingUpdateSet.InitIndex(mPendingIndex, ArraySize(mPendingIndex), mDataSinkCatalog);
+    mInProgressUpdateList.InitIndex(mInProgressIndex, ArraySize(mInProgressIndex), mDataSinkCatalog);
+#endif
 #endif // WEAVE_CONFIG_ENABLE_WDM_UPDATE
     MoveToState(kState_Initialized);
 
@@ -1563,7 +1567,8 @@ void SubscriptionClient::NotificationRequestHandler(nl::Weave::ExchangeContext *
     // jump to Exit if the state has been changed in the callback to app layer
     VerifyOrExit(StateWhenEntered == mCurrentState, /* no-op */);
 
-    reader.Init(aPayload);
+    // A notify larger than a buffer arrives in a chain of buffers.
+    reader.Init(aPayload, UINT32_MAX, true);
     reader.Next();
 
     err = notify.Init(reader);
@@ -658,6 +658,11 @@ private:
     TraitPathStore mInProgressUpdateList;
     TraitPathStore::Record mInProgressStore[WDM_UPDATE_MAX_ITEMS_IN_TRAIT_DIRTY_PATH_STORE];
 
+#if WDM_UPDATE_PATH_STORE_INDEX_SIZE > 0
+    TraitPathStore::IndexEntry mPendingIndex[WDM_UPDATE_PATH_STORE_INDEX_SIZE];
+    TraitPathStore::IndexEntry mInProgressIndex[WDM_UPDATE_PATH_STORE_INDEX_SIZE];
+#endif
+
     UpdateClient mUpdateClient;
     UpdateEncoder mUpdateEncoder;
 #endif // WEAVE_CONFIG_ENABLE_WDM_UPDATE
@@ -104,6 +104,7 @@ WEAVE_ERROR SubscriptionEngine::Init(nl::Weave::WeaveExchangeManager * const apE
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
     mNumTraitInfosInPool = 0;
+    mNumDirtyTraitInfos  = 0;
 
 exit:
     WeaveLogFunctError(err);
@@ -959,11 +960,21 @@ void SubscriptionEngine::ReclaimTraitInfo(SubscriptionHandler * const aHandlerTo
     WeaveLogIfFalse(traitInfoList >= mTraitInfoPool);
     WeaveLogIfFalse(numTraitInstances <= mNumTraitInfosInPool);
 
+    // The released trait instances no longer count towards the dirty ones.
+    for (size_t i = 0; i < numTraitInstances; ++i)
+    {
+        traitInfoList[i].ClearDirty();
+    }
+
     // mPathGroupPool + kMaxNumPathGroups is a pointer which points to the last+1byte of this array
     // traitInfoList is a pointer to the first trait instance to be released
     // the result of subtraction is the number of trait instances from traitInfoList to the end of this array
     numTraitInstancesToBeAffected = (mTraitInfoPool + mNumTraitInfosInPool) - traitInfoList;
 
+    // The graph solver may keep state alongside the pool; have it follow the trait instances moved below.
+    mNotificationEngine.mGraphSolver.ReclaimTraitInstances(static_cast<size_t>(traitInfoList - mTraitInfoPool), numTraitInstances,
+                                                           mNumTraitInfosInPool);
+
     // Shrink the traitInfosInPool by the number of trait instances in this subscription.
     mNumTraitInfosInPool -= numTraitInstances;
     SYSTEM_STATS_DECREMENT_BY_N(nl::Weave::System::Stats::kWDM_NumTraits, numTraitInstances);
@@ -1037,6 +1048,8 @@ void SubscriptionEngine::DisablePublisher()
     mIsPublisherEnabled = false;
     mPublisherCatalog   = NULL;
 
+    mNotificationEngine.Shutdown();
+
     for (size_t i = 0; i < kMaxNumSubscriptionHandlers; ++i)
     {
         switch (mHandlers[i].mCurrentState)
@@ -1180,7 +1193,8 @@ void SubscriptionEngine::OnSubscribeRequest(nl::Weave::ExchangeContext * aEC, co
         {
             handler->mAppState      = outParam.mIncomingSubscribeRequest.mHandlerAppState;
             handler->mEventCallback = outParam.mIncomingSubscribeRequest.mHandlerEventCallback;
-            uint32_t maxSize        = WDM_MAX_NOTIFICATION_SIZE;
+            uint32_t maxSize        = nl::Weave::max(static_cast<uint32_t>(WDM_MAX_NOTIFICATION_SIZE),
+                                              binding->GetMaxChainedPayloadSize());
 
             WEAVE_FAULT_INJECT_WITH_ARGS(
                 FaultInjection::kFault_WDM_NotificationSize,
@@ -514,6 +514,10 @@ private:
     uint16_t mNumTraitInfosInPool;
     SubscriptionHandler::TraitInstanceInfo mTraitInfoPool[kMaxNumPathGroups];
 
+    // Number of trait instances in the pool that are dirty, so the notification engine can tell when all of them are clean
+    // without walking every subscription.
+    uint16_t mNumDirtyTraitInfos;
+
     uint16_t mNumOfPropertyPathHandlesAllocated;
     // PropertyPathHandle mPropertyPathHandlePool[kMaxNumPropertyPathHandles];
     // ******************* end protected by lock   **************************
@@ -51,6 +51,24 @@ namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNames
 
 SubscriptionHandler::SubscriptionHandler() { }
 
+void SubscriptionHandler::TraitInstanceInfo::SetDirty(void)
+{
+    if (!mDirty)
+    {
+        mDirty = true;
+        ++(SubscriptionEngine::GetInstance()->mNumDirtyTraitInfos);
+    }
+}
+
+void SubscriptionHandler::TraitInstanceInfo::ClearDirty(void)
+{
+    if (mDirty)
+    {
+        mDirty = false;
+        --(SubscriptionEngine::GetInstance()->mNumDirtyTraitInfos);
+    }
+}
+
 void SubscriptionHandler::InitAsFree()
 {
     // These variables are going to be changed and reset along with subscription state machine
@@ -70,6 +88,10 @@ void SubscriptionHandler::InitAsFree()
     mMaxNotificationSize           = 0;
     mSubscribeToAllEvents          = false;
     mCurProcessingTraitInstanceIdx = 0;
+    mMinNotifyIntervalMsec         = WDM_PUBLISHER_DEFAULT_MIN_NOTIFY_INTERVAL_MSEC;
+    mMaxNotifyIntervalMsec         = WDM_PUBLISHER_DEFAULT_MAX_NOTIFY_INTERVAL_MSEC;
+    mFirstDirtyTimeMsec            = 0;
+    mLastDirtyTimeMsec             = 0;
     mCurrentImportance             = kImportanceType_Invalid;
     mBytesOffloaded                = 0;
 
@@ -113,6 +135,8 @@ WEAVE_ERROR SubscriptionHandler::AcceptSubscribeRequest(const uint32_t aLiveness
     // walk through the path list, prime the client
     MoveToState(kState_Subscribing);
 
+    SubscriptionEngine::GetInstance()->GetNotificationEngine()->EnqueueSubscription(this, false);
+
     // Note that the call to NotificationEngine::Run could actually cause this particular handler to be aborted
     SubscriptionEngine::GetInstance()->GetNotificationEngine()->Run();
 
@@ -531,6 +555,22 @@ WEAVE_ERROR SubscriptionHandler::ParsePathVersionEventLists(SubscribeRequest::Pa
         {
             ExitNow();
         }
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+        // Without a last observed event, a subscription starts at the in-memory log rather than at the oldest archived
+        // event; the archive only serves subscribers that fell behind.
+        {
+            LoggingManagement & logger = LoggingManagement::GetInstance();
+
+            for (size_t i = 0; logger.IsValid() && i < sizeof(mSelfVendedEvents) / sizeof(event_id_t); i++)
+            {
+                if (mSelfVendedEvents[i] == 0)
+                {
+                    mSelfVendedEvents[i] = logger.GetFirstEventID(static_cast<ImportanceType>(i + kImportanceType_First));
+                }
+            }
+        }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
     }
 
     // Great! We've successfully processed path, version, and event lists
@@ -1526,6 +1566,7 @@ void SubscriptionHandler::OnAckReceived(ExchangeContext * aEC, void * aMsgSpecif
         }
 
         // Run NE since things may have changed.
+        SubscriptionEngine::GetInstance()->GetNotificationEngine()->EnqueueSubscription(pHandler, false);
         SubscriptionEngine::GetInstance()->GetNotificationEngine()->Run();
         break;
 
@@ -1753,6 +1794,12 @@ void SubscriptionHandler::SetMaxNotificationSize(const uint32_t aMaxSize)
         mMaxNotificationSize = aMaxSize;
 }
 
+void SubscriptionHandler::SetNotifyIntervals(const uint32_t aMinIntervalMsec, const uint32_t aMaxIntervalMsec)
+{
+    mMinNotifyIntervalMsec = aMinIntervalMsec;
+    mMaxNotifyIntervalMsec = aMaxIntervalMsec;
+}
+
 }; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
 }; // namespace Profiles
 }; // namespace Weave
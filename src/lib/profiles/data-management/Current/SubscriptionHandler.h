@@ -55,10 +55,10 @@ public:
 
     struct TraitInstanceInfo
     {
-        void Init(void) { this->ClearDirty(); }
+        void Init(void) { mDirty = false; }
         bool IsDirty(void) { return mDirty; }
-        void SetDirty(void) { mDirty = true; }
-        void ClearDirty(void) { mDirty = false; }
+        void SetDirty(void);
+        void ClearDirty(void);
 
         TraitDataHandle mTraitDataHandle;
         uint16_t mRequestedVersion;
@@ -187,6 +187,14 @@ public:
 
     void SetMaxNotificationSize(const uint32_t aMaxPayload);
 
+    /**
+     * Sets up coalescing of data changes for this subscription. Once established, the subscription waits for
+     * aMinIntervalMsec to pass without further changes before it is sent a notify, but changes are never held back for
+     * longer than aMaxIntervalMsec after the first of them (0 meaning aMinIntervalMsec). Event delivery and the priming of
+     * the subscription are not affected.
+     */
+    void SetNotifyIntervals(const uint32_t aMinIntervalMsec, const uint32_t aMaxIntervalMsec);
+
 private:
     friend class SubscriptionEngine;
     friend class NotificationEngine;
@@ -250,6 +258,11 @@ private:
     uint16_t mMaxNotificationSize;
     uint32_t mCurProcessingTraitInstanceIdx;
 
+    uint32_t mMinNotifyIntervalMsec;
+    uint32_t mMaxNotifyIntervalMsec;
+    uint64_t mFirstDirtyTimeMsec; // 0 if no data change is pending
+    uint64_t mLastDirtyTimeMsec;
+
     TraitInstanceInfo * GetTraitInstanceInfoList(void) { return mTraitInstanceList; }
     uint32_t GetNumTraitInstances(void) { return mNumTraitInstances; }
 
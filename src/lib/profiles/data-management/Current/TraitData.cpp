@@ -37,6 +37,7 @@
 #include <Weave/Profiles/data-management/DataManagement.h>
 #include <Weave/Support/WeaveFaultInjection.h>
 #include <Weave/Support/RandUtils.h>
+#include <Weave/Support/SerializationUtils.h>
 
 using namespace ::nl::Weave;
 using namespace ::nl::Weave::TLV;
@@ -360,6 +361,124 @@ exit:
     return err;
 }
 
+WEAVE_ERROR TraitSchemaEngine::RetrieveStructureData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLVWriter & aWriter,
+                                                     const StructureSchemaPointerPair & aStructure) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t pathTags[mSchema.mTreeDepth];
+    uint32_t pathDepth                = 0;
+    PropertySchemaHandle schemaHandle = GetPropertySchemaHandle(aHandle);
+
+    VerifyOrExit(IsContextTag(aTagToWrite), err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(schemaHandle <= (mSchema.mNumSchemaHandleEntries + 1), err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+    if (aHandle == kRootPropertyPathHandle)
+    {
+        StructureSchemaPointerPair structure = aStructure;
+
+        err = SerializedDataToTLVWriterHelper(aWriter, TagNumFromTag(aTagToWrite), &structure);
+        ExitNow();
+    }
+
+    // Collect the context tags leading from the root down to the handle, filling the path from its far end.
+    pathDepth = GetDepth(aHandle);
+    VerifyOrExit(pathDepth > 0 && pathDepth <= mSchema.mTreeDepth, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+    for (uint32_t i = pathDepth; i > 0; i--)
+    {
+        const PropertyInfo * info = &mSchema.mSchemaHandleTbl[schemaHandle - kHandleTableOffset];
+
+        pathTags[i - 1] = info->mContextTag;
+        schemaHandle    = info->mParentHandle;
+    }
+
+    VerifyOrExit(TagNumFromTag(aTagToWrite) == pathTags[pathDepth - 1], err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = SerializedFieldToTLVWriter(aWriter, aStructure.mStructureData, aStructure.mFieldSchema, pathTags, pathDepth);
+    if (err == WEAVE_ERROR_INVALID_ARGUMENT)
+    {
+        err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH;
+    }
+
+exit:
+    return err;
+}
+
+bool TraitSchemaEngine::CanRetrieveStructureData(void) const
+{
+    for (PropertySchemaHandle i = kHandleTableOffset; i < (mSchema.mNumSchemaHandleEntries + kHandleTableOffset); i++)
+    {
+        if (IsDictionary(i) || IsOptional(i) || IsEphemeral(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+WEAVE_ERROR TraitSchemaEngine::ValidateStructureSchema(const SchemaFieldDescriptor * aFieldSchema) const
+{
+    return ValidateStructureSchema(kRootPropertyPathHandle, aFieldSchema);
+}
+
+WEAVE_ERROR TraitSchemaEngine::ValidateStructureSchema(PropertyPathHandle aParentHandle,
+                                                       const SchemaFieldDescriptor * aFieldSchema) const
+{
+    WEAVE_ERROR err        = WEAVE_NO_ERROR;
+    uint16_t numProperties = 0;
+    uint16_t numFields     = 0;
+
+    VerifyOrExit(aFieldSchema != NULL, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+    for (PropertyPathHandle child = GetFirstChild(aParentHandle); !IsNullPropertyPathHandle(child);
+         child = GetNextChild(aParentHandle, child))
+    {
+        const uint8_t contextTag      = GetMap(child)->mContextTag;
+        const FieldDescriptor * field = NULL;
+
+        // Array fields are followed by the descriptor of their elements, which is not a field of its own.
+        for (uint16_t i = 0; i < aFieldSchema->mNumFieldDescriptorElements && field == NULL;
+             i += (aFieldSchema->mFields[i].GetType() == SerializedFieldTypeArray) ? 2 : 1)
+        {
+            if (aFieldSchema->mFields[i].mTVDContextTag == contextTag)
+            {
+                field = &aFieldSchema->mFields[i];
+            }
+        }
+
+        VerifyOrExit(field != NULL, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+        VerifyOrExit(field->IsNullable() == IsNullable(child), err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+        if (field->GetType() == SerializedFieldTypeStructure)
+        {
+            VerifyOrExit(field->mNestedFieldDescriptors != NULL, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+        }
+
+        if (!IsLeaf(child))
+        {
+            VerifyOrExit(field->GetType() == SerializedFieldTypeStructure, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+            err = ValidateStructureSchema(child, field->mNestedFieldDescriptors);
+            SuccessOrExit(err);
+        }
+
+        numProperties++;
+    }
+
+    for (uint16_t i = 0; i < aFieldSchema->mNumFieldDescriptorElements;
+         i += (aFieldSchema->mFields[i].GetType() == SerializedFieldTypeArray) ? 2 : 1)
+    {
+        numFields++;
+    }
+
+    // With every property matched to a field, equal counts leave no field without a property.
+    VerifyOrExit(numProperties == numFields, err = WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+exit:
+    return err;
+}
+
 #if WEAVE_CONFIG_ENABLE_WDM_UPDATE
 WEAVE_ERROR TraitSchemaEngine::RetrieveUpdatableDictionaryData(PropertyPathHandle aHandle, uint64_t aTagToWrite,
                                                                TLVWriter & aWriter, IGetDataDelegate * aDelegate,
@@ -651,18 +770,23 @@ PropertyPathHandle TraitSchemaEngine::GetFirstChild(PropertyPathHandle aParentHa
 bool TraitSchemaEngine::IsParent(PropertyPathHandle aChildHandle, PropertyPathHandle aParentHandle) const
 {
     bool retval = false;
+    int32_t childDepth, parentDepth;
 
     VerifyOrExit(aChildHandle != kNullPropertyPathHandle && aParentHandle != kNullPropertyPathHandle, );
 
-    do
+    childDepth  = GetDepth(aChildHandle);
+    parentDepth = GetDepth(aParentHandle);
+
+    // A parent can only sit higher up in the tree, so walk straight up to its level and compare there.
+    VerifyOrExit(parentDepth >= 0 && childDepth > parentDepth, );
+
+    while (childDepth > parentDepth)
     {
         aChildHandle = GetParent(aChildHandle);
+        childDepth--;
+    }
 
-        if (aChildHandle == aParentHandle)
-        {
-            ExitNow(retval = true);
-        }
-    } while (aChildHandle != kNullPropertyPathHandle);
+    retval = (aChildHandle == aParentHandle);
 
 exit:
     return retval;
@@ -703,6 +827,31 @@ PropertyPathHandle TraitSchemaEngine::GetNextChild(PropertyPathHandle aParentHan
     PropertySchemaHandle parentSchemaHandle   = GetPropertySchemaHandle(aParentHandle);
     PropertySchemaHandle childSchemaHandle    = GetPropertySchemaHandle(aChildHandle);
     PropertyDictionaryKey parentDictionaryKey = GetPropertyDictionaryKey(aParentHandle);
+    const PropertyTreeInfo * treeInfo         = NULL;
+    PropertySchemaHandle nextSchemaHandle     = kNullPropertyPathHandle;
+
+    if (childSchemaHandle == kRootPropertyPathHandle)
+    {
+        treeInfo = GetTreeInfo(parentSchemaHandle);
+        if (treeInfo)
+        {
+            nextSchemaHandle = treeInfo->mFirstChildHandle;
+        }
+    }
+    else if (GetMap(childSchemaHandle) && GetMap(childSchemaHandle)->mParentHandle == parentSchemaHandle)
+    {
+        treeInfo = GetTreeInfo(childSchemaHandle);
+        if (treeInfo)
+        {
+            nextSchemaHandle = treeInfo->mNextSiblingHandle;
+        }
+    }
+
+    if (treeInfo)
+    {
+        return IsNullPropertyPathHandle(nextSchemaHandle) ? kNullPropertyPathHandle
+                                                          : CreatePropertyPathHandle(nextSchemaHandle, parentDictionaryKey);
+    }
 
     // Starting from 1 node after the child node that's been passed in, iterate till we find the next child belonging to aParentId.
     for (i = (childSchemaHandle - 1); i < mSchema.mNumSchemaHandleEntries; i++)
@@ -723,6 +872,19 @@ PropertyPathHandle TraitSchemaEngine::GetNextChild(PropertyPathHandle aParentHan
     }
 }
 
+#if WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+// Generated schemas are constant and have no room for a tree table of their own. Their tables are built in a shared pool
+// instead. The children of every handle, sorted by context tag, are listed in a second pool, at the same offset as the table.
+static TraitSchemaEngine::PropertyTreeInfo sTreeInfoPool[WDM_SCHEMA_TREE_INFO_POOL_SIZE];
+static PropertySchemaHandle sChildHandlePool[WDM_SCHEMA_TREE_INFO_POOL_SIZE];
+static uint32_t sNumTreeInfoPoolEntriesUsed;
+
+static const PropertySchemaHandle * GetChildHandleTbl(const TraitSchemaEngine::PropertyTreeInfo * aTreeInfoTbl)
+{
+    return &sChildHandlePool[aTreeInfoTbl - sTreeInfoPool];
+}
+#endif // WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+
 PropertyPathHandle TraitSchemaEngine::GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const
 {
     if (IsDictionary(aParentHandle))
@@ -735,6 +897,39 @@ PropertyPathHandle TraitSchemaEngine::GetChildHandle(PropertyPathHandle aParentH
 
 PropertyPathHandle TraitSchemaEngine::_GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const
 {
+#if WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+    const PropertyTreeInfo * treeInfo = GetTreeInfo(GetPropertySchemaHandle(aParentHandle));
+
+    if (treeInfo != NULL)
+    {
+        const PropertySchemaHandle * children = GetChildHandleTbl(mTreeInfoTbl) + treeInfo->mFirstChildIndex;
+        uint16_t low                          = 0;
+        uint16_t high                         = treeInfo->mNumChildHandles;
+
+        // The children are sorted by context tag.
+        while (low < high)
+        {
+            uint16_t mid     = static_cast<uint16_t>((low + high) / 2);
+            uint8_t childTag = mSchema.mSchemaHandleTbl[children[mid] - kHandleTableOffset].mContextTag;
+
+            if (childTag < aContextTag)
+            {
+                low = static_cast<uint16_t>(mid + 1);
+            }
+            else if (childTag > aContextTag)
+            {
+                high = mid;
+            }
+            else
+            {
+                return CreatePropertyPathHandle(children[mid], GetPropertyDictionaryKey(aParentHandle));
+            }
+        }
+
+        return kNullPropertyPathHandle;
+    }
+#endif // WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+
     for (PropertyPathHandle childProperty = GetFirstChild(aParentHandle); !IsNullPropertyPathHandle(childProperty);
          childProperty                    = GetNextChild(aParentHandle, childProperty))
     {
@@ -760,6 +955,7 @@ PropertyPathHandle TraitSchemaEngine::GetDictionaryItemHandle(PropertyPathHandle
 bool TraitSchemaEngine::IsLeaf(PropertyPathHandle aHandle) const
 {
     PropertySchemaHandle schemaHandle = GetPropertySchemaHandle(aHandle);
+    const PropertyTreeInfo * treeInfo;
 
     // Root is by definition not a leaf. This also conveniently handles the cases where we have traits that
     // don't have any properties in them.
@@ -767,6 +963,10 @@ bool TraitSchemaEngine::IsLeaf(PropertyPathHandle aHandle) const
     {
         return false;
     }
+    else if ((treeInfo = GetTreeInfo(schemaHandle)) != NULL)
+    {
+        return IsNullPropertyPathHandle(treeInfo->mFirstChildHandle);
+    }
     else
     {
         for (unsigned int i = 0; i < mSchema.mNumSchemaHandleEntries; i++)
@@ -785,12 +985,19 @@ int32_t TraitSchemaEngine::GetDepth(PropertyPathHandle aHandle) const
 {
     int depth                         = 0;
     PropertySchemaHandle schemaHandle = GetPropertySchemaHandle(aHandle);
+    const PropertyTreeInfo * treeInfo;
 
     if (schemaHandle > (mSchema.mNumSchemaHandleEntries + 1))
     {
         return -1;
     }
 
+    treeInfo = GetTreeInfo(schemaHandle);
+    if (treeInfo)
+    {
+        return treeInfo->mDepth;
+    }
+
     while (schemaHandle != kRootPropertyPathHandle)
     {
         depth++;
@@ -854,6 +1061,113 @@ PropertyPathHandle TraitSchemaEngine::FindLowestCommonAncestor(PropertyPathHandl
     return aHandle1;
 }
 
+void TraitSchemaEngine::InitTreeInfo(void) const
+{
+#if WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+    const uint32_t numEntries      = mSchema.mNumSchemaHandleEntries + 1;
+    const PropertyInfo * handleTbl = mSchema.mSchemaHandleTbl;
+    PropertyTreeInfo * treeInfo;
+    PropertySchemaHandle * childTbl;
+    PropertySchemaHandle lastHandle;
+    uint32_t poolOffset;
+    uint16_t numChildHandles = 0;
+
+    VerifyOrExit(mSchema.mNumSchemaHandleEntries > 0 && mTreeInfoTbl == NULL, );
+
+    // Reserve room for the table, or leave the schema to be scanned if it does not fit.
+    do
+    {
+        poolOffset = sNumTreeInfoPoolEntriesUsed;
+        VerifyOrExit(numEntries <= WDM_SCHEMA_TREE_INFO_POOL_SIZE - poolOffset, );
+    } while (!__sync_bool_compare_and_swap(&sNumTreeInfoPoolEntriesUsed, poolOffset, poolOffset + numEntries));
+
+    treeInfo   = &sTreeInfoPool[poolOffset];
+    childTbl   = &sChildHandlePool[poolOffset];
+    lastHandle = static_cast<PropertySchemaHandle>(mSchema.mNumSchemaHandleEntries + kHandleTableOffset - 1);
+
+    for (PropertySchemaHandle handle = kRootPropertyPathHandle; handle <= lastHandle; handle++)
+    {
+        treeInfo[handle - kRootPropertyPathHandle].mFirstChildHandle  = kNullPropertyPathHandle;
+        treeInfo[handle - kRootPropertyPathHandle].mNextSiblingHandle = kNullPropertyPathHandle;
+    }
+
+    // Prepend every handle to its parent's child list, highest first, so that each list ends up in ascending handle order. That
+    // is the same order in which GetNextChild scans the handle table.
+    for (PropertySchemaHandle handle = lastHandle; handle >= kHandleTableOffset; handle--)
+    {
+        PropertySchemaHandle parentHandle = handleTbl[handle - kHandleTableOffset].mParentHandle;
+
+        treeInfo[handle - kRootPropertyPathHandle].mNextSiblingHandle      = treeInfo[parentHandle - kRootPropertyPathHandle].mFirstChildHandle;
+        treeInfo[parentHandle - kRootPropertyPathHandle].mFirstChildHandle = handle;
+    }
+
+    treeInfo[0].mDepth = 0;
+
+    for (PropertySchemaHandle handle = lastHandle; handle >= kHandleTableOffset; handle--)
+    {
+        uint16_t depth = 0;
+
+        for (PropertySchemaHandle curHandle = handle; curHandle != kRootPropertyPathHandle;
+             curHandle                      = handleTbl[curHandle - kHandleTableOffset].mParentHandle)
+        {
+            depth++;
+        }
+
+        treeInfo[handle - kRootPropertyPathHandle].mDepth = depth;
+    }
+
+    // List the children of each handle in turn, insertion sorted by context tag, for _GetChildHandle to search.
+    for (PropertySchemaHandle handle = kRootPropertyPathHandle; handle <= lastHandle; handle++)
+    {
+        PropertyTreeInfo & parentInfo = treeInfo[handle - kRootPropertyPathHandle];
+
+        parentInfo.mFirstChildIndex = numChildHandles;
+        parentInfo.mNumChildHandles = 0;
+
+        for (PropertySchemaHandle child = parentInfo.mFirstChildHandle; !IsNullPropertyPathHandle(child);
+             child                      = treeInfo[child - kRootPropertyPathHandle].mNextSiblingHandle)
+        {
+            const uint8_t contextTag = handleTbl[child - kHandleTableOffset].mContextTag;
+            uint16_t i;
+
+            for (i = numChildHandles; i > parentInfo.mFirstChildIndex &&
+                 handleTbl[childTbl[i - 1] - kHandleTableOffset].mContextTag > contextTag;
+                 i--)
+            {
+                childTbl[i] = childTbl[i - 1];
+            }
+
+            childTbl[i] = child;
+            numChildHandles++;
+            parentInfo.mNumChildHandles++;
+        }
+    }
+
+    // Only publish the table once it is complete, so a partially built table is never consulted. Should another thread have
+    // published a table for this engine first, the one built here is left unused.
+    __sync_bool_compare_and_swap(&mTreeInfoTbl, static_cast<const PropertyTreeInfo *>(NULL), treeInfo);
+
+exit:
+    return;
+#endif // WDM_SCHEMA_TREE_INFO_POOL_SIZE > 0
+}
+
+bool TraitSchemaEngine::HasTreeInfo(void) const
+{
+    return mTreeInfoTbl != NULL;
+}
+
+const TraitSchemaEngine::PropertyTreeInfo * TraitSchemaEngine::GetTreeInfo(PropertySchemaHandle aSchemaHandle) const
+{
+    if (mTreeInfoTbl == NULL || aSchemaHandle < kRootPropertyPathHandle ||
+        aSchemaHandle >= (mSchema.mNumSchemaHandleEntries + kHandleTableOffset))
+    {
+        return NULL;
+    }
+
+    return &mTreeInfoTbl[aSchemaHandle - kRootPropertyPathHandle];
+}
+
 const TraitSchemaEngine::PropertyInfo * TraitSchemaEngine::GetMap(PropertyPathHandle aHandle) const
 {
     PropertySchemaHandle schemaHandle = GetPropertySchemaHandle(aHandle);
@@ -1049,6 +1363,8 @@ TraitDataSink::TraitDataSink(const TraitSchemaEngine * aEngine)
     mVersion           = 0;
     mLastNotifyVersion = 0;
     mHasValidVersion   = 0;
+
+    mSchemaEngine->InitTreeInfo();
 }
 
 WEAVE_ERROR TraitDataSink::StoreDataElement(PropertyPathHandle aHandle, TLVReader & aReader, uint8_t aFlags,
@@ -1222,9 +1538,13 @@ TraitDataSource::TraitDataSource(const TraitSchemaEngine * aEngine)
     // Set the version to 0, indicating the lack of a valid version.
     SetVersion(0);
 
-    mManagedVersion = true;
-    mSetDirtyCalled = false;
-    mSchemaEngine   = aEngine;
+    mManagedVersion       = true;
+    mSetDirtyCalled       = false;
+    mSchemaEngine         = aEngine;
+    mStructureData        = NULL;
+    mStructureFieldSchema = NULL;
+
+    mSchemaEngine->InitTreeInfo();
 
 #if (WEAVE_CONFIG_WDM_PUBLISHER_GRAPH_SOLVER == IntermediateGraphSolver)
     ClearRootDirty();
@@ -1317,12 +1637,38 @@ WEAVE_ERROR TraitDataSource::ReadData(PropertyPathHandle aHandle, uint64_t aTagT
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     Lock();
-    err = mSchemaEngine->RetrieveData(aHandle, aTagToWrite, aWriter, this);
+    if (mStructureFieldSchema != NULL)
+    {
+        StructureSchemaPointerPair structure = { mStructureData, mStructureFieldSchema };
+
+        err = mSchemaEngine->RetrieveStructureData(aHandle, aTagToWrite, aWriter, structure);
+    }
+    else
+    {
+        err = mSchemaEngine->RetrieveData(aHandle, aTagToWrite, aWriter, this);
+    }
     Unlock();
 
     return err;
 }
 
+WEAVE_ERROR TraitDataSource::BindStructure(void * aStructureData, const nl::SchemaFieldDescriptor * aFieldSchema)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(aStructureData != NULL && aFieldSchema != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(mSchemaEngine->CanRetrieveStructureData(), err = WEAVE_ERROR_NOT_IMPLEMENTED);
+
+    err = mSchemaEngine->ValidateStructureSchema(aFieldSchema);
+    SuccessOrExit(err);
+
+    mStructureData        = aStructureData;
+    mStructureFieldSchema = aFieldSchema;
+
+exit:
+    return err;
+}
+
 void TraitDataSource::SetDirty(PropertyPathHandle aPropertyHandle)
 {
     if (aPropertyHandle != kNullPropertyPathHandle)
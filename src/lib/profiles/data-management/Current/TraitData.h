@@ -36,6 +36,11 @@
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Profiles/data-management/MessageDef.h>
 
+namespace nl {
+struct SchemaFieldDescriptor;
+struct StructureSchemaPointerPair;
+} // namespace nl
+
 namespace nl {
 namespace Weave {
 namespace Profiles {
@@ -174,6 +179,18 @@ public:
         uint8_t mContextTag;
     };
 
+    /* Precomputed tree linkage for a schema handle, derived from the parent links in the schema handle table. It lets the
+     * tree queries (child/sibling iteration, depth, leaf checks) avoid scanning the whole handle table.
+     */
+    struct PropertyTreeInfo
+    {
+        PropertySchemaHandle mFirstChildHandle;  ///< Lowest-numbered child handle, or kNullPropertyPathHandle for a leaf.
+        PropertySchemaHandle mNextSiblingHandle; ///< Next child of the same parent, or kNullPropertyPathHandle.
+        uint16_t mDepth;                         ///< Distance from the root handle.
+        uint16_t mFirstChildIndex;               ///< Position of the first child in the schema's tag-sorted child list.
+        uint16_t mNumChildHandles;               ///< Number of children, listed from mFirstChildIndex.
+    };
+
     /**
      *  @brief
      *    The main schema structure that houses the schema information.
@@ -377,6 +394,39 @@ public:
     WEAVE_ERROR RetrieveData(PropertyPathHandle aHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter & aWriter,
                              IGetDataDelegate * aDelegate, IDirtyPathCut * apDirtyPathCut = NULL) const;
 
+    /**
+     * Given a path handle and a writer positioned on the corresponding data element, write the data for that handle directly out
+     * of a C structure holding the state of the entire trait, as described by its code-generated SchemaFieldDescriptor. Unlike
+     * RetrieveData, this walks the field descriptors rather than the schema and makes no per-property delegate calls.
+     *
+     * Only traits without dictionaries, optional or ephemeral properties can be described by a structure (see
+     * CanRetrieveStructureData), and the tag to write must be a context tag.
+     *
+     * @retval #WEAVE_NO_ERROR                   On success.
+     * @retval #WEAVE_ERROR_WDM_SCHEMA_MISMATCH  If the handle does not map onto a field of the structure.
+     * @retval other                             Encountered errors writing out the data.
+     */
+    WEAVE_ERROR RetrieveStructureData(PropertyPathHandle aHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter & aWriter,
+                                      const nl::StructureSchemaPointerPair & aStructure) const;
+
+    /**
+     * Returns true if the data of this trait can be held in a C structure and retrieved with RetrieveStructureData, i.e. the
+     * schema has no dictionaries, optional or ephemeral properties.
+     *
+     * @retval bool
+     */
+    bool CanRetrieveStructureData(void) const;
+
+    /**
+     * Checks that a code-generated structure description matches this schema: every property has exactly one field with the
+     * same context tag and nullability, and the fields of properties with children are structures whose own fields match those
+     * children.
+     *
+     * @retval #WEAVE_NO_ERROR                   If the structure matches the schema.
+     * @retval #WEAVE_ERROR_WDM_SCHEMA_MISMATCH  Otherwise.
+     */
+    WEAVE_ERROR ValidateStructureSchema(const nl::SchemaFieldDescriptor * aFieldSchema) const;
+
     WEAVE_ERROR RetrieveUpdatableDictionaryData(PropertyPathHandle aHandle, uint64_t aTagToWrite,
                                                 nl::Weave::TLV::TLVWriter & aWriter, IGetDataDelegate * aDelegate,
                                                 PropertyPathHandle & aPropertyPathHandleOfDictItemToStartFrom) const;
@@ -535,8 +585,24 @@ public:
     SchemaVersion GetMinVersion() const;
     SchemaVersion GetMaxVersion() const;
 
+    /**
+     * Builds the tree table of the schema from its schema handle table, in storage set aside for the purpose, unless the engine
+     * already has one. The table also lists the children of every handle by context tag, for GetChildHandle(). This is invoked
+     * by the trait data sink and source constructors. Should the storage run out (see #WDM_SCHEMA_TREE_INFO_POOL_SIZE), the
+     * engine answers tree queries by scanning the handle table instead.
+     */
+    void InitTreeInfo(void) const;
+
+    /**
+     * Returns true if tree queries on this engine are answered from a tree table built by InitTreeInfo(), rather than by
+     * scanning the schema handle table.
+     */
+    bool HasTreeInfo(void) const;
+
 private:
     PropertyPathHandle _GetChildHandle(PropertyPathHandle aParentHandle, uint8_t aContextTag) const;
+    WEAVE_ERROR ValidateStructureSchema(PropertyPathHandle aParentHandle, const nl::SchemaFieldDescriptor * aFieldSchema) const;
+    const PropertyTreeInfo * GetTreeInfo(PropertySchemaHandle aSchemaHandle) const;
     bool GetBitFromPathHandleBitfield(uint8_t * aBitfield, PropertyPathHandle aPathHandle) const;
 
     /*
@@ -549,6 +615,9 @@ private:
 
 public:
     const Schema mSchema;
+
+    // The tree table built by InitTreeInfo(), or NULL. Left out of the initializer of a schema engine, it starts as NULL.
+    mutable const PropertyTreeInfo * mTreeInfoTbl;
 };
 
 /*
@@ -862,6 +931,17 @@ public:
 
     WEAVE_ERROR ReadData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLV::TLVWriter & aWriter);
 
+    /**
+     * Binds the data of this source to a C structure described by a code-generated SchemaFieldDescriptor. Once bound, ReadData
+     * encodes properties straight out of the structure instead of calling GetData/GetLeafData for every property.
+     *
+     * @retval #WEAVE_NO_ERROR                   On success.
+     * @retval #WEAVE_ERROR_INVALID_ARGUMENT     If the structure or its description is NULL.
+     * @retval #WEAVE_ERROR_NOT_IMPLEMENTED      If the schema of the trait cannot be held in a structure.
+     * @retval #WEAVE_ERROR_WDM_SCHEMA_MISMATCH  If the description of the structure does not match the schema of the trait.
+     */
+    WEAVE_ERROR BindStructure(void * aStructureData, const nl::SchemaFieldDescriptor * aFieldSchema);
+
     /* Interactions with the underlying data has to always be done within a locked context. This applies to both the app logic
      * (e.g., a publisher when modifying its source data) as well as to the core WDM logic (when trying to access that published
      * data).  This is required of both publishers and clients.
@@ -926,8 +1006,14 @@ protected: // IGetDataDelegate
     virtual WEAVE_ERROR GetData(PropertyPathHandle aHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter & aWriter,
                                 bool & aIsNull, bool & aIsPresent) __OVERRIDE;
 
+    /*
+     * Sources that bind their data to a structure (see BindStructure) need not implement this.
+     */
     virtual WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite,
-                                    nl::Weave::TLV::TLVWriter & aWriter) __OVERRIDE = 0;
+                                    nl::Weave::TLV::TLVWriter & aWriter) __OVERRIDE
+    {
+        return WEAVE_ERROR_TLV_TAG_NOT_FOUND;
+    }
 
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
     virtual WEAVE_ERROR GetNextDictionaryItemKey(PropertyPathHandle aDictionaryHandle, uintptr_t & aContext,
@@ -952,6 +1038,9 @@ private:
     uint64_t mVersion;
     // Tracks whether SetDirty was called within a Lock/Unlock 'session'
     bool mSetDirtyCalled;
+    // The structure holding the data of this source, if bound with BindStructure.
+    void * mStructureData;
+    const nl::SchemaFieldDescriptor * mStructureFieldSchema;
 };
 
 #if WDM_ENABLE_PUBLISHER_UPDATE_SERVER_SUPPORT
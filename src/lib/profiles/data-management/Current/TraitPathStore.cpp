@@ -45,7 +45,7 @@ using namespace ::nl::Weave::Profiles::DataManagement_Current;
  * Empty constructor
  */
 TraitPathStore::TraitPathStore()
-    : mStore(NULL), mStoreSize(0), mNumItems(0)
+    : mStore(NULL), mStoreSize(0), mNumItems(0), mIndex(NULL), mIndexSize(0), mCatalog(NULL), mIsIndexValid(false)
 {
 }
 
@@ -60,10 +60,38 @@ void TraitPathStore::Init(TraitPathStore::Record *aRecordArray, size_t aArrayLen
 {
     mStore = aRecordArray;
     mStoreSize = aArrayLength;
+    mIndex = NULL;
+    mIndexSize = 0;
+    mCatalog = NULL;
 
     Clear();
 }
 
+/**
+ * Attaches a hash index to the store. The index is keyed by TraitPath and
+ * counts, for every stored path and each of its ancestors, the valid items
+ * at and below that path. This makes IsPresent, Includes, Intersects,
+ * IsTraitPresent and AddItemDedup cost a lookup per level of the schema
+ * instead of a scan of the whole store.
+ *
+ * If the index runs out of entries, or the schema of a stored trait cannot be
+ * found in the catalog, the store falls back to scanning until it is cleared.
+ *
+ * @param[in]   aIndexArray     Pointer to an array of IndexEntries; NULL
+ *                              detaches the index.
+ * @param[in]   aIndexSize      Length of the index array in number of entries.
+ * @param[in]   aCatalog        The catalog used to find the TraitSchemaEngine
+ *                              of the trait instances referred to by the paths.
+ */
+void TraitPathStore::InitIndex(IndexEntry *aIndexArray, size_t aIndexSize, const TraitCatalogBase<TraitDataSink> *aCatalog)
+{
+    mIndex = (aIndexSize > 0 && aCatalog != NULL) ? aIndexArray : NULL;
+    mIndexSize = aIndexSize;
+    mCatalog = aCatalog;
+
+    RebuildIndex();
+}
+
 /**
  * @fn bool TraitPathStore::IsEmpty()
  * @return  Returns true if the store is empty; false otherwise.
@@ -110,6 +138,8 @@ WEAVE_ERROR TraitPathStore::AddItem(const TraitPath &aItem, Flags aFlags)
     SetItem(i, aItem, aFlags);
     mNumItems++;
 
+    UpdateIndex(aItem, true);
+
 exit:
     return err;
 }
@@ -137,7 +167,12 @@ WEAVE_ERROR TraitPathStore::AddItemDedup(const TraitPath &aItem, const TraitSche
         ExitNow();
     }
 
-    // Remove any paths of which aItem is an ancestor
+    // Remove any paths of which aItem is an ancestor; the index can tell us when there are none.
+    if (IsIndexUsable() && (FindIndexEntry(aItem) == NULL || FindIndexEntry(aItem)->mNumDescendants == 0))
+    {
+        ExitNow(err = AddItem(aItem, kFlag_None));
+    }
+
     for (size_t i = GetFirstValidItem(aItem.mTraitDataHandle);
             i < GetPathStoreSize();
             i = GetNextValidItem(i, aItem.mTraitDataHandle))
@@ -195,6 +230,8 @@ WEAVE_ERROR TraitPathStore::InsertItemAt(size_t aIndex, const TraitPath &aItem,
     SetItem(aIndex, aItem, aFlags);
     mNumItems++;
 
+    UpdateIndex(aItem, true);
+
 exit:
     return err;
 }
@@ -221,7 +258,17 @@ void TraitPathStore::RemoveTrait(TraitDataHandle aDataHandle)
  */
 bool TraitPathStore::IsTraitPresent(TraitDataHandle aDataHandle) const
 {
-    size_t i = GetFirstValidItem(aDataHandle);
+    size_t i;
+
+    if (IsIndexUsable())
+    {
+        // Every path of a trait instance is either its root or below it.
+        const IndexEntry *entry = FindIndexEntry(TraitPath(aDataHandle, kRootPropertyPathHandle));
+
+        return (entry != NULL && (entry->mNumItems + entry->mNumDescendants) > 0);
+    }
+
+    i = GetFirstValidItem(aDataHandle);
 
     return i < mStoreSize;
 }
@@ -254,6 +301,23 @@ void TraitPathStore::SetFailedTrait(TraitDataHandle aDataHandle)
     }
 }
 
+/**
+ * Mark the TraitPath at the given index as failed.
+ *
+ * @param aIndex    The index of the item.
+ */
+void TraitPathStore::SetFailed(size_t aIndex)
+{
+    bool wasValid = IsItemValid(aIndex);
+
+    SetFlags(aIndex, kFlag_Failed, true);
+
+    if (wasValid)
+    {
+        UpdateIndex(mStore[aIndex].mTraitPath, false);
+    }
+}
+
 void TraitPathStore::RemoveItemAt(size_t aIndex)
 {
     VerifyOrDie(mNumItems > 0);
@@ -261,8 +325,16 @@ void TraitPathStore::RemoveItemAt(size_t aIndex)
 
     if (IsItemInUse(aIndex))
     {
+        TraitPath item = mStore[aIndex].mTraitPath;
+        bool wasValid = IsItemValid(aIndex);
+
         ClearItem(aIndex);
         mNumItems--;
+
+        if (wasValid)
+        {
+            UpdateIndex(item, false);
+        }
     }
 }
 
@@ -305,6 +377,13 @@ void TraitPathStore::Compact()
  */
 bool TraitPathStore::IsPresent(const TraitPath &aItem) const
 {
+    if (IsIndexUsable())
+    {
+        const IndexEntry *entry = FindIndexEntry(aItem);
+
+        return (entry != NULL && entry->mNumItems > 0);
+    }
+
     for (size_t i = GetFirstValidItem(); i < mStoreSize; i = GetNextValidItem(i))
     {
         if (mStore[i].mTraitPath == aItem)
@@ -334,6 +413,13 @@ bool TraitPathStore::Intersects(const TraitPath &aTraitPath, const TraitSchemaEn
     TraitDataHandle dataHandle = aTraitPath.mTraitDataHandle;
     PropertyPathHandle pathHandle = aTraitPath.mPropertyPathHandle;
 
+    if (IsIndexUsable())
+    {
+        const IndexEntry *entry = FindIndexEntry(aTraitPath);
+
+        return ((entry != NULL && entry->mNumDescendants > 0) || Includes(aTraitPath, aSchemaEngine));
+    }
+
     for (size_t i = GetFirstValidItem(dataHandle); i < mStoreSize; i = GetNextValidItem(i, dataHandle))
     {
         if (pathHandle == mStore[i].mTraitPath.mPropertyPathHandle ||
@@ -366,6 +452,22 @@ bool TraitPathStore::Includes(const TraitPath &aItem, const TraitSchemaEngine *
     TraitDataHandle dataHandle = aItem.mTraitDataHandle;
     PropertyPathHandle pathHandle = aItem.mPropertyPathHandle;
 
+    if (IsIndexUsable())
+    {
+        // Look the path and each of its ancestors up in turn.
+        for ( ; pathHandle != kNullPropertyPathHandle; pathHandle = aSchemaEngine->GetParent(pathHandle))
+        {
+            const IndexEntry *entry = FindIndexEntry(TraitPath(dataHandle, pathHandle));
+
+            if (entry != NULL && entry->mNumItems > 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     for (size_t i = GetFirstValidItem(dataHandle); i < mStoreSize; i = GetNextValidItem(i, dataHandle))
     {
         if (pathHandle == mStore[i].mTraitPath.mPropertyPathHandle ||
@@ -390,6 +492,8 @@ void TraitPathStore::Clear()
     {
         ClearItem(i);
     }
+
+    RebuildIndex();
 }
 
 /**
@@ -515,3 +619,193 @@ void TraitPathStore::SetFlags(size_t aIndex, Flags aFlags, bool aValue)
         mStore[aIndex].mFlags |= aFlags;
     }
 }
+
+/**
+ * @return  The slot where the search for aItem in the index starts.
+ */
+size_t TraitPathStore::GetIndexHomeSlot(const TraitPath &aItem) const
+{
+    uint32_t hash = (aItem.mPropertyPathHandle * 2654435761U) ^ (aItem.mTraitDataHandle * 40503U);
+
+    return hash % mIndexSize;
+}
+
+/**
+ * @return  The index of the slot holding aItem, or of the empty slot where it
+ *          would be added; mIndexSize if neither exists.
+ */
+size_t TraitPathStore::ProbeIndex(const TraitPath &aItem) const
+{
+    size_t slot = GetIndexHomeSlot(aItem);
+
+    // Linear probing; removal keeps every probe run free of holes, so the first empty slot ends the search.
+    for (size_t i = 0; i < mIndexSize; i++)
+    {
+        if (mIndex[slot].mTraitPath.mPropertyPathHandle == kNullPropertyPathHandle || mIndex[slot].mTraitPath == aItem)
+        {
+            return slot;
+        }
+
+        slot = (slot + 1) % mIndexSize;
+    }
+
+    return mIndexSize;
+}
+
+const TraitPathStore::IndexEntry *TraitPathStore::FindIndexEntry(const TraitPath &aItem) const
+{
+    size_t slot = ProbeIndex(aItem);
+
+    if (slot < mIndexSize && mIndex[slot].mTraitPath == aItem)
+    {
+        return &mIndex[slot];
+    }
+
+    return NULL;
+}
+
+/**
+ * Adds or removes one valid item to or from the counts of its path and of all
+ * its ancestors.
+ *
+ * @return  false if the index could not be updated.
+ */
+bool TraitPathStore::AdjustIndex(const TraitPath &aItem, bool aAdd)
+{
+    TraitDataSink *dataSink = NULL;
+    const TraitSchemaEngine *schemaEngine;
+    PropertyPathHandle pathHandle = aItem.mPropertyPathHandle;
+
+    if (mCatalog->Locate(aItem.mTraitDataHandle, &dataSink) != WEAVE_NO_ERROR)
+    {
+        return false;
+    }
+
+    schemaEngine = dataSink->GetSchemaEngine();
+
+    for ( ; pathHandle != kNullPropertyPathHandle; pathHandle = schemaEngine->GetParent(pathHandle))
+    {
+        TraitPath path(aItem.mTraitDataHandle, pathHandle);
+        size_t slot = ProbeIndex(path);
+        uint16_t *count;
+
+        if (slot == mIndexSize)
+        {
+            return false;
+        }
+
+        if (mIndex[slot].mTraitPath.mPropertyPathHandle == kNullPropertyPathHandle)
+        {
+            if (!aAdd)
+            {
+                return false;
+            }
+
+            mIndex[slot].mTraitPath = path;
+        }
+
+        count = (pathHandle == aItem.mPropertyPathHandle) ? &mIndex[slot].mNumItems : &mIndex[slot].mNumDescendants;
+
+        if (aAdd)
+        {
+            (*count)++;
+        }
+        else
+        {
+            if (*count == 0)
+            {
+                return false;
+            }
+
+            (*count)--;
+
+            if (mIndex[slot].mNumItems == 0 && mIndex[slot].mNumDescendants == 0)
+            {
+                RemoveIndexEntry(slot);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Empties a slot of the index, moving later entries of the same probe run
+ * back so that the run stays free of holes.
+ */
+void TraitPathStore::RemoveIndexEntry(size_t aSlot)
+{
+    size_t hole = aSlot;
+    size_t next = aSlot;
+
+    for (size_t i = 1; i < mIndexSize; i++)
+    {
+        size_t home;
+
+        next = (next + 1) % mIndexSize;
+
+        if (mIndex[next].mTraitPath.mPropertyPathHandle == kNullPropertyPathHandle)
+        {
+            break;
+        }
+
+        // An entry whose home slot lies cyclically within (hole, next] would no longer be reachable from its home slot once
+        // moved into the hole; every other entry must move back.
+        home = GetIndexHomeSlot(mIndex[next].mTraitPath);
+
+        if ((hole < next) ? (hole < home && home <= next) : (hole < home || home <= next))
+        {
+            continue;
+        }
+
+        mIndex[hole] = mIndex[next];
+        hole         = next;
+    }
+
+    mIndex[hole].mTraitPath.mTraitDataHandle    = 0;
+    mIndex[hole].mTraitPath.mPropertyPathHandle = kNullPropertyPathHandle;
+    mIndex[hole].mNumItems                      = 0;
+    mIndex[hole].mNumDescendants                = 0;
+}
+
+/**
+ * Reflects the addition or removal of a valid item in the index; on failure
+ * the index is rebuilt from the store.
+ */
+void TraitPathStore::UpdateIndex(const TraitPath &aItem, bool aAdd)
+{
+    if (IsIndexUsable() && !AdjustIndex(aItem, aAdd))
+    {
+        WeaveLogDetail(DataManagement, "Rebuilding path store index");
+        RebuildIndex();
+    }
+}
+
+void TraitPathStore::RebuildIndex()
+{
+    mIsIndexValid = false;
+
+    VerifyOrExit(mIndex != NULL, );
+
+    for (size_t i = 0; i < mIndexSize; i++)
+    {
+        mIndex[i].mTraitPath.mTraitDataHandle = 0;
+        mIndex[i].mTraitPath.mPropertyPathHandle = kNullPropertyPathHandle;
+        mIndex[i].mNumItems = 0;
+        mIndex[i].mNumDescendants = 0;
+    }
+
+    for (size_t i = GetFirstValidItem(); i < mStoreSize; i = GetNextValidItem(i))
+    {
+        if (!AdjustIndex(mStore[i].mTraitPath, true))
+        {
+            WeaveLogDetail(DataManagement, "Path store index overflow; falling back to scanning");
+            ExitNow();
+        }
+    }
+
+    mIsIndexValid = true;
+
+exit:
+    return;
+}
@@ -54,9 +54,20 @@ struct TraitPathStore
             TraitPath mTraitPath;
         };
 
+        /**
+         * An entry of the optional hash index; it counts the valid items
+         * stored for a path and below it.
+         */
+        struct IndexEntry {
+            TraitPath mTraitPath;
+            uint16_t mNumItems;       /**< Valid items equal to mTraitPath. */
+            uint16_t mNumDescendants; /**< Valid items mTraitPath is an ancestor of. */
+        };
+
         TraitPathStore();
 
         void Init(Record *aRecordArray, size_t aNumItems);
+        void InitIndex(IndexEntry *aIndexArray, size_t aIndexSize, const TraitCatalogBase<TraitDataSink> *aCatalog);
 
         bool IsEmpty() { return mNumItems == 0; }
         bool IsFull() { return mNumItems >= mStoreSize; }
@@ -69,7 +80,7 @@ struct TraitPathStore
         WEAVE_ERROR InsertItemAt(size_t aIndex, const TraitPath &aItem, Flags aFlags);
         WEAVE_ERROR InsertItemAfter(size_t aIndex, const TraitPath &aItem, Flags aFlags) { return InsertItemAt(aIndex+1, aItem, aFlags); }
 
-        void SetFailed(size_t aIndex) { SetFlags(aIndex, kFlag_Failed, true); }
+        void SetFailed(size_t aIndex);
         void SetFailed();
         void SetFailedTrait(TraitDataHandle aDataHandle);
 
@@ -106,8 +117,22 @@ struct TraitPathStore
         void SetFlags(size_t aIndex, Flags aFlags, bool aValue);
         bool AreFlagsSet_private(size_t aIndex, Flags aFlags) const { return ((mStore[aIndex].mFlags & aFlags) == aFlags); }
 
+        bool IsIndexUsable() const { return (mIndex != NULL && mIsIndexValid); }
+        size_t GetIndexHomeSlot(const TraitPath &aItem) const;
+        size_t ProbeIndex(const TraitPath &aItem) const;
+        const IndexEntry *FindIndexEntry(const TraitPath &aItem) const;
+        bool AdjustIndex(const TraitPath &aItem, bool aAdd);
+        void RemoveIndexEntry(size_t aSlot);
+        void UpdateIndex(const TraitPath &aItem, bool aAdd);
+        void RebuildIndex();
+
         size_t mStoreSize;
         size_t mNumItems;
+
+        IndexEntry *mIndex;
+        size_t mIndexSize;
+        const TraitCatalogBase<TraitDataSink> *mCatalog;
+        bool mIsIndexValid;
 };
 
 }; // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
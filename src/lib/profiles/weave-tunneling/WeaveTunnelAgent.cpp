@@ -63,15 +63,18 @@ WeaveTunnelAgent::WeaveTunnelAgent()
 {
     mInet                     = NULL;
     mExchangeMgr              = NULL;
+    mTunEP                    = NULL;
 
 #if WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
     mServiceMgr               = NULL;
 #endif
 
     mPeerNodeId               = 0;
-    qFront                    = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-    qRear                     = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
+    mNumQueuedMsgs            = 0;
+    mNumQueuedBytes           = 0;
+    mTunReceivePaused         = false;
     mTunAgentState            = kState_NotInitialized;
+    mTunReceiveInProgress     = false;
     mPeerNodeId               = kNodeIdNotSpecified;
     mServiceAddress           = IPAddress::Any;
     mServicePort              = WEAVE_PORT;
@@ -173,9 +176,10 @@ WEAVE_ERROR WeaveTunnelAgent::ConfigureAndInit (InetLayer *inet, WeaveExchangeMa
     mRole                    = role;
     mAuthMode                = authMode;
     mAppContext              = appContext;
-    memset(queuedMsgs, 0, sizeof(queuedMsgs));
-    qFront                   = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-    qRear                    = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
+    memset(mQueuedMsgs, 0, sizeof(mQueuedMsgs));
+    mNumQueuedMsgs           = 0;
+    mNumQueuedBytes          = 0;
+    mTunReceivePaused        = false;
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
     memset(&mWeaveTunnelStats, 0, sizeof(mWeaveTunnelStats));
 #endif
@@ -233,6 +237,8 @@ WEAVE_ERROR WeaveTunnelAgent::ConfigureAndInit (InetLayer *inet, WeaveExchangeMa
 
     mTunEP->OnPacketReceived = RecvdFromTunnelEndPoint;
 
+    mTunEP->OnReceiveComplete = TunnelEndPointReceiveComplete;
+
     // Set the TunEndPoint appState to the WeaveTunnelAgent.
 
     mTunEP->AppState = this;
@@ -846,6 +852,9 @@ WEAVE_ERROR WeaveTunnelAgent::GetWeaveTunnelStatistics(WeaveTunnelStatistics &tu
 {
     memcpy(&tunnelStats, &mWeaveTunnelStats, sizeof(WeaveTunnelStatistics));
 
+    tunnelStats.mQueueStats.mQueuedMessages = mNumQueuedMsgs;
+    tunnelStats.mQueueStats.mQueuedBytes = mNumQueuedBytes;
+
     return WEAVE_NO_ERROR;
 }
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
@@ -905,6 +914,11 @@ void WeaveTunnelAgent::RecvdFromTunnelEndPoint(TunEndPoint *tunEP, PacketBuffer
     IPAddress destIP6Addr;
     WeaveTunnelAgent *tAgent    = static_cast<WeaveTunnelAgent *>(tunEP->AppState);
 
+    // Hold back the encapsulated packet on the Service connection until the whole batch of
+    // packets from the Tunnel EndPoint has been forwarded.
+
+    tAgent->mTunReceiveInProgress = true;
+
     tAgent->ParseDestinationIPAddress(*msg, destIP6Addr);
 
     err = tAgent->AddTunnelHdrToMsg(msg);
@@ -948,6 +962,8 @@ void WeaveTunnelAgent::RecvdFromTunnelEndPoint(TunEndPoint *tunEP, PacketBuffer
     }
 
 exit:
+    tAgent->mTunReceiveInProgress = false;
+
     if (msg != NULL)
     {
         PacketBuffer::Free(msg);
@@ -961,6 +977,30 @@ exit:
     return;
 }
 
+/**
+ * Handler invoked after each batch of IPv6 packets received from the Tunnel EndPoint interface. It sends
+ * the encapsulated packets of the batch, held back on the Service TCP connections, so that they share
+ * TCP segments and system calls.
+ *
+ * @param[in] tunEP                        A pointer to the TunEndPoint object.
+ */
+void WeaveTunnelAgent::TunnelEndPointReceiveComplete(TunEndPoint *tunEP)
+{
+    WeaveTunnelAgent *tAgent    = static_cast<WeaveTunnelAgent *>(tunEP->AppState);
+
+    if (tAgent->mPrimaryTunConnMgr.mServiceCon)
+    {
+        tAgent->mPrimaryTunConnMgr.mServiceCon->FlushSending();
+    }
+
+#if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+    if (tAgent->mBackupTunConnMgr.mServiceCon)
+    {
+        tAgent->mBackupTunConnMgr.mServiceCon->FlushSending();
+    }
+#endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+}
+
 /**
  * Handler to receive tunneled IPv6 packets from the Service TCP connection and forward to the Tunnel
  * EndPoint interface after decapsulating the raw IPv6 packet from inside the tunnel header.
@@ -1181,6 +1221,12 @@ WEAVE_ERROR WeaveTunnelAgent::SendMessageUponPktTransitAnalysis(const WeaveTunne
     if (!dropPacket)
     {
         msgLen = msg->DataLength();
+
+        if (mTunReceiveInProgress)
+        {
+            connMgr->mServiceCon->DeferSending();
+        }
+
         err = connMgr->mServiceCon->SendTunneledMessage(msgInfo, msg);
         SuccessOrExit(err);
 
@@ -1461,58 +1507,185 @@ void WeaveTunnelAgent::UpdateTunnelDownStatistics(const TunnelType tunType, cons
 }
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
+/**
+ * Classify a queued packet by what dropping it would cost.
+ *
+ * ICMPv6 packets, and UDP or TCP packets to or from a Weave port, carry
+ * neighbor discovery, routing and Weave control traffic and are classed as
+ * control; all other IP traffic is classed as bulk.
+ */
+uint8_t WeaveTunnelAgent::ClassifyQueuedPacket(const PacketBuffer &pkt)
+{
+    enum
+    {
+        kIPv6HeaderSize       = 40,
+        kIPv6NextHeaderOffset = 6,
+        kIPProto_TCP          = 6,
+        kIPProto_UDP          = 17,
+        kIPProto_ICMPv6       = 58,
+    };
+
+    const uint8_t *p = pkt.Start() + TUN_HDR_SIZE_IN_BYTES;
+    uint16_t len = pkt.DataLength();
+    uint8_t pktClass = kQueuedMsgClass_Bulk;
+    uint8_t nextHdr;
+    uint16_t srcPort;
+    uint16_t dstPort;
+
+    VerifyOrExit(len >= TUN_HDR_SIZE_IN_BYTES + kIPv6HeaderSize, /* unparsable */);
+
+    nextHdr = p[kIPv6NextHeaderOffset];
+    VerifyOrExit(nextHdr != kIPProto_ICMPv6, pktClass = kQueuedMsgClass_Control);
+    VerifyOrExit(nextHdr == kIPProto_UDP || nextHdr == kIPProto_TCP, /* not Weave traffic */);
+
+    // The source and destination ports lead both the UDP and the TCP header.
+
+    VerifyOrExit(len >= TUN_HDR_SIZE_IN_BYTES + kIPv6HeaderSize + 4, /* truncated */);
+
+    srcPort = nl::Weave::Encoding::BigEndian::Get16(p + kIPv6HeaderSize);
+    dstPort = nl::Weave::Encoding::BigEndian::Get16(p + kIPv6HeaderSize + 2);
+    if (srcPort == WEAVE_PORT || dstPort == WEAVE_PORT ||
+        srcPort == WEAVE_UNSECURED_PORT || dstPort == WEAVE_UNSECURED_PORT)
+    {
+        pktClass = kQueuedMsgClass_Control;
+    }
+
+exit:
+    return pktClass;
+}
+
 /**
  * Queue packet for Remote tunnel connection to get established.
+ *
+ * The queue holds at most #WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
+ * packets and #WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED bytes. When the
+ * packet does not fit, the oldest bulk packets are dropped to make room
+ * for it; if that would not be enough, the packet is refused instead.
  */
 WEAVE_ERROR WeaveTunnelAgent::EnQueuePacket(PacketBuffer *pkt)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t pktClass = ClassifyQueuedPacket(*pkt);
+    uint32_t pktLen = pkt->TotalLength();
+    uint32_t bulkMsgs = 0;
+    uint32_t bulkBytes = 0;
+    uint8_t i;
 
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_TunnelQueueFull,
                        ExitNow(err = WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL);
                       );
 
-    if ((qFront == qRear + 1) || (qFront == 0 && qRear == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED - 1))
+    for (i = 0; i < mNumQueuedMsgs; i++)
     {
-        // Queue full;
-
-        err = WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL;
-        ExitNow();
+        if (mQueuedMsgClasses[i] == kQueuedMsgClass_Bulk)
+        {
+            bulkMsgs++;
+            bulkBytes += mQueuedMsgs[i]->TotalLength();
+        }
     }
-    else
+
+    // Refuse the packet if dropping every queued bulk packet would still not make room for it.
+
+    VerifyOrExit(mNumQueuedMsgs - bulkMsgs < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED &&
+                 mNumQueuedBytes - bulkBytes + pktLen <= WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED,
+                 err = WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL);
+
+    // Drop the oldest bulk packets until the packet fits.
+
+    i = 0;
+    while (mNumQueuedMsgs == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED ||
+           mNumQueuedBytes + pktLen > WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED)
     {
-        if (qFront == TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+        if (mQueuedMsgClasses[i] == kQueuedMsgClass_Bulk)
+        {
+            DropQueuedPacket(i);
+        }
+        else
         {
-            qFront = 0;
+            i++;
         }
-        qRear = (qRear + 1) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED;
-        queuedMsgs[qRear] = pkt;
     }
 
+    mQueuedMsgs[mNumQueuedMsgs] = pkt;
+    mQueuedMsgClasses[mNumQueuedMsgs] = pktClass;
+    mNumQueuedMsgs++;
+    mNumQueuedBytes += pktLen;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    if (mNumQueuedBytes > mWeaveTunnelStats.mQueueStats.mPeakQueuedBytes)
+    {
+        mWeaveTunnelStats.mQueueStats.mPeakQueuedBytes = mNumQueuedBytes;
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    UpdateTunReceiveBackpressure();
+
 exit:
 
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    if (err == WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL)
+    {
+        // The caller frees the packet and counts it in mDroppedMessagesCount.
+
+        if (pktClass == kQueuedMsgClass_Control)
+        {
+            mWeaveTunnelStats.mQueueStats.mDroppedControlMessages++;
+        }
+        else
+        {
+            mWeaveTunnelStats.mQueueStats.mDroppedBulkMessages++;
+        }
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
     return err;
 }
 
+/**
+ * Drop a queued packet to make room for a newer one.
+ */
+void WeaveTunnelAgent::DropQueuedPacket(uint8_t index)
+{
+    PacketBuffer *pkt = mQueuedMsgs[index];
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    // Update tunnel statistics
+    mWeaveTunnelStats.mDroppedMessagesCount++;
+
+    if (mQueuedMsgClasses[index] == kQueuedMsgClass_Control)
+    {
+        mWeaveTunnelStats.mQueueStats.mDroppedControlMessages++;
+    }
+    else
+    {
+        mWeaveTunnelStats.mQueueStats.mDroppedBulkMessages++;
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    mNumQueuedBytes -= pkt->TotalLength();
+    mNumQueuedMsgs--;
+
+    memmove(&mQueuedMsgs[index], &mQueuedMsgs[index + 1], (mNumQueuedMsgs - index) * sizeof(mQueuedMsgs[0]));
+    memmove(&mQueuedMsgClasses[index], &mQueuedMsgClasses[index + 1], (mNumQueuedMsgs - index) * sizeof(mQueuedMsgClasses[0]));
+
+    PacketBuffer::Free(pkt);
+}
+
 void WeaveTunnelAgent::DumpQueuedMessages(void)
 {
     PacketBuffer *queuedPkt = NULL;
 
-    while (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+    while ((queuedPkt = DeQueuePacket()) != NULL)
     {
-        queuedPkt = DeQueuePacket();
-        if (queuedPkt)
-        {
-            PacketBuffer::Free(queuedPkt);
+        PacketBuffer::Free(queuedPkt);
 
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-            // Update tunnel statistics
-            mWeaveTunnelStats.mDroppedMessagesCount++;
+        // Update tunnel statistics
+        mWeaveTunnelStats.mDroppedMessagesCount++;
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-
-            queuedPkt = NULL;
-        }
     }
+
+    UpdateTunReceiveBackpressure();
 }
 
 /**
@@ -1521,21 +1694,70 @@ void WeaveTunnelAgent::DumpQueuedMessages(void)
 PacketBuffer *WeaveTunnelAgent::DeQueuePacket(void)
 {
     PacketBuffer *retPkt = NULL;
-    if (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+
+    if (mNumQueuedMsgs > 0)
     {
-        retPkt = queuedMsgs[qFront];
-        if (qFront == qRear) // Only one packet in queue
-        {
-            qFront = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-            qRear  = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-        }
-        else
+        retPkt = mQueuedMsgs[0];
+
+        mNumQueuedBytes -= retPkt->TotalLength();
+        mNumQueuedMsgs--;
+
+        memmove(&mQueuedMsgs[0], &mQueuedMsgs[1], mNumQueuedMsgs * sizeof(mQueuedMsgs[0]));
+        memmove(&mQueuedMsgClasses[0], &mQueuedMsgClasses[1], mNumQueuedMsgs * sizeof(mQueuedMsgClasses[0]));
+    }
+
+    return retPkt;
+}
+
+/**
+ * Pause reading from the Tunnel EndPoint while the queue holds only control
+ * packets and has no room for another full-sized packet, as any packet read
+ * could then only be refused; resume once there is room again.
+ *
+ * The pause applies to every packet on the Tunnel EndPoint, not only to
+ * those bound for the Service: a packet's destination is only known once it
+ * has been read, so shortcut tunnel and local traffic is held back as well
+ * until the queue is sent or dumped.
+ */
+void WeaveTunnelAgent::UpdateTunReceiveBackpressure(void)
+{
+    bool queueFull = false;
+
+    if (mNumQueuedMsgs == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED ||
+        mNumQueuedBytes + TUN_HDR_SIZE_IN_BYTES + WEAVE_CONFIG_TUNNEL_INTERFACE_MTU > WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED)
+    {
+        queueFull = true;
+
+        for (uint8_t i = 0; i < mNumQueuedMsgs; i++)
         {
-            qFront = (qFront + 1) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED;
+            if (mQueuedMsgClasses[i] == kQueuedMsgClass_Bulk)
+            {
+                queueFull = false;
+                break;
+            }
         }
     }
 
-    return retPkt;
+    VerifyOrExit(queueFull != mTunReceivePaused && mTunEP != NULL, /* no change */);
+
+    mTunReceivePaused = queueFull;
+    if (queueFull)
+    {
+        WeaveLogDetail(WeaveTunnel, "Tunnel queue full: Pausing Tunnel EndPoint receive\n");
+
+        mTunEP->DisableReceive();
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+        mWeaveTunnelStats.mQueueStats.mReceivePausedCount++;
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    }
+    else
+    {
+        mTunEP->EnableReceive();
+    }
+
+exit:
+    return;
 }
 
 /**
@@ -1582,6 +1804,8 @@ void WeaveTunnelAgent::SendQueuedMessages(const WeaveTunnelConnectionMgr *connMg
         queuedPkt = NULL;
     }
 
+    UpdateTunReceiveBackpressure();
+
     return;
 }
 
@@ -1936,7 +2160,7 @@ void WeaveTunnelAgent::WeaveTunnelUpNotifyAndSetState(AgentState state,
     // on behalf of a Thread device or its own packets. So, it is better to send these
     // across and have the Service decide to throw or accept.
 
-    if (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+    if (mNumQueuedMsgs > 0)
     {
         SendQueuedMessages(connMgr);
     }
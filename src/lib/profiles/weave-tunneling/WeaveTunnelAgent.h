@@ -39,8 +39,6 @@
 #define TUN_INTF_NAME_MAX_LEN                 (64)
 #define WEAVE_ULA_FABRIC_DEFAULT_PREFIX_LEN   (48)
 
-#define TUNNEL_PACKET_QUEUE_INVALID_INDEX     (-1)
-
 namespace nl {
 namespace Weave {
 namespace Profiles {
@@ -116,6 +114,20 @@ typedef struct WeaveTunnelCommonStatistics
     uint64_t     mLastTimeTunnelEstablished;                               /**< Last time Weave Tunnel was Established. */
 } WeaveTunnelCommonStatistics;
 
+/**
+ *  This structure contains the statistics counters of the queue holding packets
+ *  for the Service while no tunnel is established.
+ */
+typedef struct WeaveTunnelQueueStatistics
+{
+    uint32_t     mQueuedMessages;                                          /**< Number of messages in the queue. */
+    uint32_t     mQueuedBytes;                                             /**< Number of bytes in the queue. */
+    uint32_t     mPeakQueuedBytes;                                         /**< Largest number of bytes held in the queue. */
+    uint32_t     mDroppedControlMessages;                                  /**< Number of ICMPv6 and Weave messages dropped from, or refused by, the full queue. */
+    uint32_t     mDroppedBulkMessages;                                     /**< Number of other messages dropped from, or refused by, the full queue. */
+    uint32_t     mReceivePausedCount;                                      /**< Number of times reading from the Tunnel EndPoint was paused as the queue was full. */
+} WeaveTunnelQueueStatistics;
+
 /**
  *  This structure contains the relevant statistics counters for the WeaveTunnel.
  */
@@ -131,6 +143,7 @@ typedef struct WeaveTunnelStatistics
     uint64_t     mLastTimeForTunnelFailover;                               /**< Last time Weave Tunnel failed over to Backup. */
     uint64_t     mLastTimeWhenPrimaryAndBackupWentDown;                    /**< Last time when both Primary and Backup Weave Tunnel went down. */
 #endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+    WeaveTunnelQueueStatistics mQueueStats;                                /**< Statistics counters of the queue for the Service. */
 } WeaveTunnelStatistics;
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
@@ -138,6 +151,7 @@ class WeaveTunnelAgent
 {
   friend class WeaveTunnelControl;
   friend class WeaveTunnelConnectionMgr;
+  friend class WeaveTunnelAgentTestObject;
 
 public:
 
@@ -510,6 +524,12 @@ public:
  */
     static void RecvdFromTunnelEndPoint(TunEndPoint *tunEP, PacketBuffer *message);
 
+/**
+ * Handler invoked after each batch of IPv6 packets received from the Tunnel EndPoint interface, which sends
+ * the encapsulated packets of the batch held back on the Service TCP connections.
+ */
+    static void TunnelEndPointReceiveComplete(TunEndPoint *tunEP);
+
 /**
  * Handler to receive tunneled IPv6 packets over the shortcut UDP tunnel between the border gateway and the mobile
  * device and forward to the Tunnel EndPoint interface after decapsulating the raw IPv6 packet from inside the
@@ -554,10 +574,21 @@ private:
 
     WeaveAuthMode mAuthMode;
 
-    // Queued messages for Service; pending until connection established.
+    // Queued messages for Service, in arrival order; pending until connection established. The queue holds
+    // up to WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED packets, and up to WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED
+    // bytes across them.
+
+    enum
+    {
+        kQueuedMsgClass_Control = 0,       ///< ICMPv6 and Weave traffic; kept in preference to bulk traffic.
+        kQueuedMsgClass_Bulk    = 1,       ///< Other IP traffic; dropped first, oldest first, when the queue is full.
+    };
 
-    PacketBuffer *queuedMsgs[WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED];
-    int qFront, qRear;
+    PacketBuffer *mQueuedMsgs[WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED];
+    uint8_t mQueuedMsgClasses[WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED];
+    uint8_t mNumQueuedMsgs;
+    uint32_t mNumQueuedBytes;
+    bool mTunReceivePaused;
 
     // Role; Border gateway or Mobile device
 
@@ -601,6 +632,10 @@ private:
 
     AgentState  mTunAgentState;
 
+    // Set while a packet received from the Tunnel EndPoint is being forwarded.
+
+    bool mTunReceiveInProgress;
+
     // Application context
     void *mAppContext;
 
@@ -657,7 +692,10 @@ private:
     void SendQueuedMessages(const WeaveTunnelConnectionMgr *connMgr);
     WEAVE_ERROR EnQueuePacket(PacketBuffer *pkt);
     PacketBuffer *DeQueuePacket(void);
+    void DropQueuedPacket(uint8_t index);
     void DumpQueuedMessages(void);
+    void UpdateTunReceiveBackpressure(void);
+    static uint8_t ClassifyQueuedPacket(const PacketBuffer &pkt);
 
     // Tunnel Control post-processing functions
 
@@ -517,6 +517,11 @@ WEAVE_ERROR WeaveTunnelConnectionMgr::StartServiceTunnelConn(uint64_t destNodeId
 
     mServiceCon->SetConnectTimeout(WEAVE_CONFIG_TUNNEL_CONNECT_TIMEOUT_SECS * nl::Weave::System::kTimerFactor_milli_per_unit);
 
+    // Receive each tunneled message whole, in a buffer of its own, once the connection is up.
+
+    err = mServiceCon->SetFramedReceive(true);
+    SuccessOrExit(err);
+
     err = mServiceCon->Connect(destNodeId, authMode, destIPAddr, destPort, connIntfId);
 
 exit:
@@ -1093,6 +1093,98 @@ WEAVE_ERROR SerializedDataToTLVWriterHelper(TLVWriter &aWriter, uint8_t aDataTag
     return WriteDataForType(aWriter, structureSchemaPair->mStructureData, pDescriptor, SerializedFieldTypeStructure, inArray);
 }
 
+/**
+ * @brief
+ *   A writer function to convert a single field of a data structure into a TLV
+ *   element. The field is located by following a path of context tags from the
+ *   top-level structure through any nested structures, and is written with its
+ *   own context tag.
+ *
+ * @param[in] aWriter           The writer to use for writing out the field
+ *
+ * @param[in] aStructureData    A pointer to the top-level c-structure data
+ *
+ * @param[in] aFieldDescriptors SchemaFieldDescriptors to describe the top-level c struct + TLV
+ *
+ * @param[in] aContextTags      The context tags of the fields leading to the field to write,
+ *                              starting from the top-level structure
+ *
+ * @param[in] aNumContextTags   The number of tags in aContextTags
+ *
+ * @retval #WEAVE_NO_ERROR               On success.
+ *
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT If the path does not lead to a field of the structure.
+ *
+ * @retval other          Other errors that mey be returned from the aWriter.
+ *
+ */
+WEAVE_ERROR SerializedFieldToTLVWriter(TLVWriter &aWriter,
+                                       void *aStructureData,
+                                       const SchemaFieldDescriptor *aFieldDescriptors,
+                                       const uint8_t *aContextTags,
+                                       uint32_t aNumContextTags)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    const FieldDescriptor *fieldPtr = NULL;
+    int nullifiedBitIdx = 0;
+    uint8_t *nullifiedFields = NULL;
+    bool isNullified = false;
+
+    VerifyOrExit(aNumContextTags > 0, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    for (uint32_t i = 0; i < aNumContextTags; i++)
+    {
+        const FieldDescriptor *endFieldPtr;
+
+        // Descend into the structure holding the next field of the path.
+        if (fieldPtr != NULL)
+        {
+            VerifyOrExit(fieldPtr->GetType() == SerializedFieldTypeStructure, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+            aStructureData = static_cast<char *>(aStructureData) + fieldPtr->mOffset;
+            aFieldDescriptors = fieldPtr->mNestedFieldDescriptors;
+        }
+
+        fieldPtr = aFieldDescriptors->mFields;
+        endFieldPtr = &(aFieldDescriptors->mFields[aFieldDescriptors->mNumFieldDescriptorElements]);
+        nullifiedBitIdx = 0;
+
+        while (fieldPtr < endFieldPtr && fieldPtr->mTVDContextTag != aContextTags[i])
+        {
+            if (fieldPtr->IsNullable())
+            {
+                nullifiedBitIdx++;
+            }
+
+            // Array fields are followed by the descriptor of their elements.
+            fieldPtr += (fieldPtr->GetType() == SerializedFieldTypeArray) ? 2 : 1;
+        }
+
+        VerifyOrExit(fieldPtr < endFieldPtr, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (fieldPtr->IsNullable())
+    {
+        err = FindNullifiedFieldsArray(aStructureData, aFieldDescriptors, nullifiedFields);
+        SuccessOrExit(err);
+
+        isNullified = GET_FIELD_NULLIFIED_BIT(nullifiedFields, nullifiedBitIdx);
+    }
+
+#if WEAVE_CONFIG_SERIALIZATION_DEBUG_LOGGING
+    sIndentationLevel = 0;
+#endif
+
+    err = WriteNullableDataForType(aWriter,
+                                   static_cast<char *>(aStructureData) + fieldPtr->mOffset,
+                                   fieldPtr,
+                                   fieldPtr->GetType(),
+                                   isNullified);
+
+exit:
+    return err;
+}
+
 /**
  * @brief
  *   A reader function to convert TLV into a C-struct. Uses
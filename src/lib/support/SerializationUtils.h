@@ -264,6 +264,12 @@ WEAVE_ERROR SerializedDataToTLVWriterHelper(nl::Weave::TLV::TLVWriter &aWriter,
                                             uint8_t aDataTag,
                                             void *aAppData);
 
+WEAVE_ERROR SerializedFieldToTLVWriter(nl::Weave::TLV::TLVWriter &aWriter,
+                                       void *aStructureData,
+                                       const SchemaFieldDescriptor *aFieldDescriptors,
+                                       const uint8_t *aContextTags,
+                                       uint32_t aNumContextTags);
+
 WEAVE_ERROR TLVReaderToDeserializedData(nl::Weave::TLV::TLVReader &aReader,
                                         void *aStructureData,
                                         const SchemaFieldDescriptor *aFieldDescriptors,
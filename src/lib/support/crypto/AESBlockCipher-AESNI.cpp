@@ -40,6 +40,38 @@ namespace Security {
 
 using namespace nl::Weave::Crypto;
 
+enum
+{
+    kParallelBlocks = 8
+};
+
+// Encrypt a run of blocks with the rounds of up to kParallelBlocks blocks interleaved, so that
+// the latency of each AESENC is hidden behind the independent rounds of the other blocks.
+static void EncryptBlocksParallel(const __m128i *keys, int roundCount, const uint8_t *inBlocks, uint8_t *outBlocks,
+                                  size_t numBlocks)
+{
+    __m128i blocks[kParallelBlocks];
+
+    while (numBlocks > 0)
+    {
+        const size_t count = (numBlocks < kParallelBlocks) ? numBlocks : kParallelBlocks;
+
+        for (size_t i = 0; i < count; i++)
+            blocks[i] = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(inBlocks + i * 16)), keys[0]);
+        for (int round = 1; round < roundCount; round++)
+            for (size_t i = 0; i < count; i++)
+                blocks[i] = _mm_aesenc_si128(blocks[i], keys[round]);
+        for (size_t i = 0; i < count; i++)
+            _mm_storeu_si128((__m128i *)(outBlocks + i * 16), _mm_aesenclast_si128(blocks[i], keys[roundCount]));
+
+        inBlocks += count * 16;
+        outBlocks += count * 16;
+        numBlocks -= count;
+    }
+
+    ClearSecretData((uint8_t *)blocks, sizeof(blocks));
+}
+
 AES128BlockCipher::AES128BlockCipher()
 {
     memset(&mKey, 0, sizeof(mKey));
@@ -108,6 +140,11 @@ void AES128BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    EncryptBlocksParallel(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES128BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
@@ -234,6 +271,11 @@ void AES256BlockCipherEnc::EncryptBlock(const uint8_t *inBlock, uint8_t *outBloc
     ClearSecretData((uint8_t *)&block, sizeof(block));
 }
 
+void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    EncryptBlocksParallel(mKey, kRoundCount, inBlocks, outBlocks, numBlocks);
+}
+
 void AES256BlockCipherDec::SetKey(const uint8_t *key)
 {
     __m128i tmp;
@@ -38,6 +38,7 @@
 #define AES_H_
 
 #include <limits.h>
+#include <stddef.h>
 
 #include "WeaveCrypto.h"
 
@@ -105,6 +106,7 @@ class NL_DLL_EXPORT AES128BlockCipherEnc : public AES128BlockCipher
 public:
     void SetKey(const uint8_t *key);
     void EncryptBlock(const uint8_t *inBlock, uint8_t *outBlock);
+    void EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks);
 };
 
 class NL_DLL_EXPORT AES128BlockCipherDec : public AES128BlockCipher
@@ -151,6 +153,7 @@ class NL_DLL_EXPORT AES256BlockCipherEnc : public AES256BlockCipher
 public:
     void SetKey(const uint8_t *key);
     void EncryptBlock(const uint8_t *inBlock, uint8_t *outBlock);
+    void EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks);
 };
 
 class NL_DLL_EXPORT AES256BlockCipherDec : public AES256BlockCipher
@@ -160,6 +163,24 @@ public:
     void DecryptBlock(const uint8_t *inBlock, uint8_t *outBlock);
 };
 
+#if !WEAVE_CONFIG_AES_IMPLEMENTATION_AESNI
+
+// Implementations without a multi-block primitive encrypt one block at a time.
+
+inline void AES128BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    for (size_t i = 0; i < numBlocks; i++)
+        EncryptBlock(inBlocks + i * kBlockLength, outBlocks + i * kBlockLength);
+}
+
+inline void AES256BlockCipherEnc::EncryptBlocks(const uint8_t *inBlocks, uint8_t *outBlocks, size_t numBlocks)
+{
+    for (size_t i = 0; i < numBlocks; i++)
+        EncryptBlock(inBlocks + i * kBlockLength, outBlocks + i * kBlockLength);
+}
+
+#endif // !WEAVE_CONFIG_AES_IMPLEMENTATION_AESNI
+
 } // namespace Security
 } // namespace Platform
 } // namespace Weave
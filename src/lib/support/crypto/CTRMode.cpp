@@ -93,31 +93,49 @@ void CTRMode<BlockCipher>::EncryptData(const uint8_t *inData, uint16_t dataLen,
 {
     // Index to next byte of encrypted counter to be used.
     uint32_t encryptedCounterIndex = mMsgIndex % kCounterLength;
+    uint16_t dataIndex = 0;
 
-    // For each byte of input data...
-    for (uint16_t dataIndex = 0; dataIndex < dataLen && mMsgIndex < UINT32_MAX; dataIndex++, mMsgIndex++)
+    while (dataIndex < dataLen && mMsgIndex < UINT32_MAX)
     {
+        // If we are at a block boundary and there is at least one whole block of data left, encrypt a batch
+        // of consecutive counter values with a single call to the block cipher and XOR whole blocks of data.
+        if (encryptedCounterIndex == 0 && dataLen - dataIndex >= kCounterLength &&
+            UINT32_MAX - mMsgIndex > kCounterLength)
+        {
+            uint8_t keyStream[kMaxBlocksPerBatch * kCounterLength];
+            uint32_t numBlocks = (dataLen - dataIndex) / kCounterLength;
+            uint32_t batchLen;
+
+            if (numBlocks > kMaxBlocksPerBatch)
+                numBlocks = kMaxBlocksPerBatch;
+            if (numBlocks > (UINT32_MAX - mMsgIndex) / kCounterLength)
+                numBlocks = (UINT32_MAX - mMsgIndex) / kCounterLength;
+            batchLen = numBlocks * kCounterLength;
+
+            for (uint32_t i = 0; i < batchLen; i += kCounterLength)
+            {
+                memcpy(keyStream + i, Counter, kCounterLength);
+                IncrementCounter();
+            }
+
+            mBlockCipher.EncryptBlocks(keyStream, keyStream, numBlocks);
+
+            for (uint32_t i = 0; i < batchLen; i++)
+                outData[dataIndex + i] = inData[dataIndex + i] ^ keyStream[i];
+
+            ClearSecretData(keyStream, batchLen);
+
+            dataIndex += batchLen;
+            mMsgIndex += batchLen;
+            continue;
+        }
+
         // If we need more encrypted counter bytes...
         if (encryptedCounterIndex == 0)
         {
             // Encrypt the next counter value.
             mBlockCipher.EncryptBlock(Counter, mEncryptedCounter);
-
-            // Bump the counter. Since the message size is at most UINT32_MAX (and the counter counts blocks)
-            // we will never need to update more than the four least-significant bytes.
-            Counter[kCounterLength-1]++;
-            if (Counter[kCounterLength-1] == 0)
-            {
-                Counter[kCounterLength-2]++;
-                if (Counter[kCounterLength-2] == 0)
-                {
-                    Counter[kCounterLength-3]++;
-                    if (Counter[kCounterLength-3] == 0)
-                    {
-                        Counter[kCounterLength-4]++;
-                    }
-                }
-            }
+            IncrementCounter();
         }
 
         // XOR the data with the corresponding byte of the encrypted counter.
@@ -127,6 +145,29 @@ void CTRMode<BlockCipher>::EncryptData(const uint8_t *inData, uint16_t dataLen,
         encryptedCounterIndex++;
         if (encryptedCounterIndex == kCounterLength)
             encryptedCounterIndex = 0;
+
+        dataIndex++;
+        mMsgIndex++;
+    }
+}
+
+template <class BlockCipher>
+void CTRMode<BlockCipher>::IncrementCounter()
+{
+    // Bump the counter. Since the message size is at most UINT32_MAX (and the counter counts blocks)
+    // we will never need to update more than the four least-significant bytes.
+    Counter[kCounterLength-1]++;
+    if (Counter[kCounterLength-1] == 0)
+    {
+        Counter[kCounterLength-2]++;
+        if (Counter[kCounterLength-2] == 0)
+        {
+            Counter[kCounterLength-3]++;
+            if (Counter[kCounterLength-3] == 0)
+            {
+                Counter[kCounterLength-4]++;
+            }
+        }
     }
 }
 
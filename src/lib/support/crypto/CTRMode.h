@@ -60,9 +60,16 @@ public:
     void Reset(void);
 
 private:
+    enum
+    {
+        kMaxBlocksPerBatch = 8      // Number of counter blocks handed to the block cipher at once.
+    };
+
     BlockCipher mBlockCipher;
     uint32_t mMsgIndex;
     uint8_t mEncryptedCounter[kCounterLength];
+
+    void IncrementCounter(void);
 };
 
 typedef CTRMode<Platform::Security::AES128BlockCipherEnc> AES128CTRMode;
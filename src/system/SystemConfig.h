@@ -100,6 +100,10 @@
 #error "FORBIDDEN: WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#error "FORBIDDEN: WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS"
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL && !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 // clang-format off
 
 /**
@@ -375,6 +379,70 @@
 #endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX */
 #endif /* !WEAVE_SYSTEM_CONFIG_USE_LWIP */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+ *
+ *  @brief
+ *      This is the number of small packet buffers, of capacity #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL, that are
+ *      pooled in addition to the #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC full-size buffers of the BSD sockets
+ *      configuration.
+ *
+ *      A request for a buffer is served from the pool of the smallest buffers that can hold it, falling back to larger buffers
+ *      when that pool is exhausted, so that short messages such as acknowledgments do not tie up full-size buffers. This has no
+ *      effect when #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC is zero (0), as buffers are then allocated to size.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL 0
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL
+ *
+ *  @brief
+ *      The capacity, including the space reserved for headers, of the buffers counted by
+ *      #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL 128
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+ *
+ *  @brief
+ *      This is the number of medium packet buffers, of capacity #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM, that are
+ *      pooled in addition to the full-size buffers. See #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM 0
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM
+ *
+ *  @brief
+ *      The capacity, including the space reserved for headers, of the buffers counted by
+ *      #WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM 512
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+ *
+ *  @brief
+ *      This is the number of freed packet buffers of each size that a thread keeps for its own subsequent allocations before
+ *      returning them to the shared pool, in the BSD sockets configuration with POSIX locking.
+ *
+ *      Buffers kept by a thread are not available to other threads, but are not counted as in use by the system statistics.
+ *      Zero (0) disables the caches, so that every allocation and release takes the pool lock. The caches avoid the lock only
+ *      while #WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS is disabled.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#define WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE 0
+#endif /* WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE */
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 /**
@@ -498,6 +566,61 @@ struct LwIPEvent;
 #define WEAVE_SYSTEM_CONFIG_NUM_TIMERS 32
 #endif /* WEAVE_SYSTEM_CONFIG_NUM_TIMERS */
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS
+ *
+ *  @brief
+ *      This is the base-2 logarithm of the number of slots in each level of the hierarchical timing wheel that holds the armed
+ *      timers of a Layer object. It must be between 1 and 6, inclusive.
+ *
+ *      Each level holds (1 << WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS) slots and enough levels are provided to cover any 32-bit
+ *      millisecond delay. Smaller values use less memory at the cost of moving long-running timers between levels more often.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS 4
+#else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#define WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS 6
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
+#endif /* WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_TIMER_HASH_SIZE
+ *
+ *  @brief
+ *      This is the number of buckets in the hash table that indexes armed timers by callback function and application state, used
+ *      to find the timer cancelled by Layer::CancelTimer and Layer::StartTimer.
+ *
+ *      By default, this parameter is a copy of WEAVE_SYSTEM_CONFIG_NUM_TIMERS.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_TIMER_HASH_SIZE
+#define WEAVE_SYSTEM_CONFIG_TIMER_HASH_SIZE WEAVE_SYSTEM_CONFIG_NUM_TIMERS
+#endif /* WEAVE_SYSTEM_CONFIG_TIMER_HASH_SIZE */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_USE_EPOLL
+ *
+ *  @brief
+ *      This defines whether (1) or not (0) the Weave System Layer provides an epoll(7)-based readiness backend for sockets.
+ *
+ *      When enabled, endpoints register their descriptors persistently with the layer and applications may drive the event
+ *      loop with nl::Weave::System::Layer::ServiceEvents instead of select(). The select() interfaces remain available either way.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#define WEAVE_SYSTEM_CONFIG_USE_EPOLL 0
+#endif /* WEAVE_SYSTEM_CONFIG_USE_EPOLL */
+
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+ *
+ *  @brief
+ *      This is the maximum number of readiness events retrieved from the kernel by a single call to
+ *      nl::Weave::System::Layer::ServiceEvents.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS
+#define WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS 64
+#endif /* WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS */
+
 /**
  *  @def WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
  *
@@ -47,6 +47,12 @@
 #include <errno.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <limits.h>
+#include <string.h>
+#include <sys/epoll.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if !WEAVE_SYSTEM_CONFIG_PLATFORM_PROVIDES_EVENT_FUNCTIONS
 #include <lwip/err.h>
@@ -95,17 +101,27 @@ Layer::Layer()
         sSystemEventHandlerDelegate.Init(HandleSystemLayerEvent);
 
     this->mEventDelegateList = NULL;
-    this->mTimerList = NULL;
     this->mTimerComplete = false;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+    this->mTimerWheel.Init(0);
+    this->mNumScheduledWork = 0;
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     this->mWakePipeIn = 0;
     this->mWakePipeOut = 0;
+    this->mScheduledWorkPending = false;
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    this->mEpollFD = -1;
+    this->mIOUpdateList = NULL;
+    this->mIOEvents = NULL;
+    this->mIONumEvents = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 }
 
@@ -116,8 +132,13 @@ Error Layer::Init(void* aContext)
     int lPipeFDs[2];
     int lOSReturn, lFlags;
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    struct epoll_event lWakeEvent;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
     RegisterSystemLayerErrorFormatter();
+    this->mTimerWheel.Init(Timer::GetCurrentEpoch());
+    this->mNumScheduledWork = 0;
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     RegisterPOSIXErrorFormatter();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
@@ -153,6 +174,19 @@ Error Layer::Init(void* aContext)
     VerifyOrExit(lOSReturn == 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    // Create the readiness backend and register the wake pipe with it. The wake pipe is identified by a NULL watch.
+    this->mEpollFD = ::epoll_create1(EPOLL_CLOEXEC);
+    VerifyOrExit(this->mEpollFD >= 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+
+    memset(&lWakeEvent, 0, sizeof(lWakeEvent));
+    lWakeEvent.events = EPOLLIN;
+    lWakeEvent.data.ptr = NULL;
+
+    lOSReturn = ::epoll_ctl(this->mEpollFD, EPOLL_CTL_ADD, this->mWakePipeIn, &lWakeEvent);
+    VerifyOrExit(lOSReturn == 0, lReturn = nl::Weave::System::MapErrorPOSIX(errno));
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     this->mLayerState = kLayerState_Initialized;
     this->mContext = aContext;
 
@@ -182,6 +216,18 @@ Error Layer::Shutdown()
     }
 #endif
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    if (this->mEpollFD != -1)
+    {
+        ::close(this->mEpollFD);
+        this->mEpollFD = -1;
+    }
+
+    this->mIOUpdateList = NULL;
+    this->mIOEvents = NULL;
+    this->mIONumEvents = 0;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
     for (size_t i = 0; i < Timer::sPool.Size(); ++i)
     {
         Timer* lTimer = Timer::sPool.Get(*this, i);
@@ -280,15 +326,15 @@ exit:
 
 /**
 * @brief
-*   This method cancels a one-shot timer, started earlier through @p StartTimer().
+*   This method cancels a one-shot timer, started earlier through @p StartTimer(), or work scheduled through @p ScheduleWork().
 *
 *   @note
 *       The cancellation could fail silently in two different ways. If the timer specified by the combination of the callback
 *       function and application state object couldn't be found, cancellation could fail. If the timer has fired, but not yet
 *       removed from memory, cancellation could also fail.
 *
-*   @param[in]  aOnComplete   A pointer to the callback function used in calling @p StartTimer().
-*   @param[in]  aAppState     A pointer to the application state object used in calling @p StartTimer().
+*   @param[in]  aOnComplete   A pointer to the callback function used in calling @p StartTimer() or @p ScheduleWork().
+*   @param[in]  aAppState     A pointer to the application state object used in calling @p StartTimer() or @p ScheduleWork().
 *
 */
 void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void* aAppState)
@@ -296,14 +342,26 @@ void Layer::CancelTimer(Layer::TimerCompleteFunct aOnComplete, void* aAppState)
     if (this->State() != kLayerState_Initialized)
         return;
 
-    for (size_t i = 0; i < Timer::sPool.Size(); ++i)
-    {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
+    Timer* lTimer = this->mTimerWheel.Find(aOnComplete, aAppState);
 
-        if (lTimer != NULL && lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState)
+    if (lTimer != NULL)
+    {
+        lTimer->Cancel();
+    }
+    else if (this->mNumScheduledWork != 0)
+    {
+        // Scheduled work is not in the timer wheel; search the pool for it only when some is outstanding.
+        for (size_t i = 0; i < Timer::sPool.Size(); i++)
         {
-            lTimer->Cancel();
-            break;
+            lTimer = Timer::sPool.Get(*this, i);
+
+            if (lTimer != NULL && lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState &&
+                !TimerWheel::Contains(*lTimer))
+            {
+                __sync_fetch_and_sub(&this->mNumScheduledWork, 1);
+                lTimer->Cancel();
+                break;
+            }
         }
     }
 }
@@ -365,9 +423,13 @@ Error Layer::ScheduleWork(TimerCompleteFunct aComplete, void* aAppState)
     lReturn = this->NewTimer(lTimer);
     SuccessOrExit(lReturn);
 
+    // Count the work before the servicing thread can be woken to complete it.
+    __sync_fetch_and_add(&this->mNumScheduledWork, 1);
+
     lReturn = lTimer->ScheduleWork(aComplete, aAppState);
     if (lReturn != WEAVE_SYSTEM_NO_ERROR)
     {
+        __sync_fetch_and_sub(&this->mNumScheduledWork, 1);
         lTimer->Release();
     }
 
@@ -571,27 +633,9 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
 
     FD_SET(this->mWakePipeIn, aReadSet);
 
-    const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
-    Timer::Epoch lAwakenEpoch = kCurrentEpoch + static_cast<Timer::Epoch>(aSleepTime.tv_sec) * 1000 + aSleepTime.tv_usec / 1000;
+    const uint64_t kMaxSleepTime = static_cast<uint64_t>(aSleepTime.tv_sec) * 1000 + aSleepTime.tv_usec / 1000;
+    const uint64_t kSleepTime = this->GetTimerSleepMilliseconds(kMaxSleepTime);
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
-    {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
-
-        if (lTimer != NULL)
-        {
-            if (!Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
-            {
-                lAwakenEpoch = kCurrentEpoch;
-                break;
-            }
-
-            if (Timer::IsEarlierEpoch(lTimer->mAwakenEpoch, lAwakenEpoch))
-                lAwakenEpoch = lTimer->mAwakenEpoch;
-        }
-    }
-
-    const Timer::Epoch kSleepTime = lAwakenEpoch - kCurrentEpoch;
     aSleepTime.tv_sec = kSleepTime / 1000;
     aSleepTime.tv_usec = (kSleepTime % 1000) * 1000;
 }
@@ -632,31 +676,15 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
         // If we woke because of someone writing to the wake pipe, clear the contents of the pipe before returning.
         if (FD_ISSET(this->mWakePipeIn, aReadSet))
         {
-            while (true)
-            {
-                uint8_t lBytes[128];
-                int lTmp = ::read(this->mWakePipeIn, static_cast<void*>(lBytes), sizeof(lBytes));
-                if (lTmp < static_cast<int>(sizeof(lBytes)))
-                    break;
-            }
+            this->DrainWakePipe();
         }
     }
 
-    const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
-
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = lThreadSelf;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
-    for (size_t i = 0; i < Timer::sPool.Size(); i++)
-    {
-        Timer* lTimer = Timer::sPool.Get(*this, i);
-
-        if (lTimer != NULL && !Timer::IsEarlierEpoch(kCurrentEpoch, lTimer->mAwakenEpoch))
-        {
-            lTimer->HandleComplete();
-        }
-    }
+    this->DispatchExpiredTimers();
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
@@ -691,6 +719,375 @@ void Layer::WakeSelect()
     static_cast<void>(kIOResult);
 }
 
+/**
+ *  Returns the number of milliseconds the event loop may sleep before the earliest pending timer expires.
+ *
+ *  @param[in]  aMaxSleepMilliseconds   The longest sleep, in milliseconds, requested by the caller.
+ *
+ *  @return The lesser of \c aMaxSleepMilliseconds and the time remaining until the earliest timer expires, or zero if a timer has
+ *      already expired.
+ */
+uint64_t Layer::GetTimerSleepMilliseconds(uint64_t aMaxSleepMilliseconds)
+{
+    uint64_t lSleepTime = aMaxSleepMilliseconds;
+    Timer::Epoch lNextEpoch;
+
+    if (this->mScheduledWorkPending)
+    {
+        lSleepTime = 0;
+    }
+    else if (this->mTimerWheel.GetNextEpoch(lNextEpoch))
+    {
+        const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+
+        if (!Timer::IsEarlierEpoch(kCurrentEpoch, lNextEpoch))
+            lSleepTime = 0;
+        else if (lNextEpoch - kCurrentEpoch < lSleepTime)
+            lSleepTime = lNextEpoch - kCurrentEpoch;
+    }
+
+    return lSleepTime;
+}
+
+/**
+ *  Completes any work scheduled with ScheduleWork() and any timers that have expired.
+ */
+void Layer::DispatchExpiredTimers(void)
+{
+    const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
+    Timer* lTimer;
+
+    // Work scheduled from other threads is not in the timer wheel; look for it in the pool only when some has been scheduled.
+    if (__sync_lock_test_and_set(&this->mScheduledWorkPending, false))
+    {
+        for (size_t i = 0; i < Timer::sPool.Size(); i++)
+        {
+            lTimer = Timer::sPool.Get(*this, i);
+
+            if (lTimer != NULL && lTimer->OnComplete != NULL && !TimerWheel::Contains(*lTimer))
+            {
+                __sync_fetch_and_sub(&this->mNumScheduledWork, 1);
+                lTimer->HandleComplete();
+            }
+        }
+    }
+
+    while ((lTimer = this->mTimerWheel.PopExpired(kCurrentEpoch)) != NULL)
+    {
+        lTimer->HandleComplete();
+    }
+}
+
+/**
+ *  Discards the contents of the wake pipe.
+ */
+void Layer::DrainWakePipe(void)
+{
+    while (true)
+    {
+        uint8_t lBytes[128];
+        int lTmp = ::read(this->mWakePipeIn, static_cast<void*>(lBytes), sizeof(lBytes));
+        if (lTmp < static_cast<int>(sizeof(lBytes)))
+            break;
+    }
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+static uint8_t IOEventsFromEpoll(uint32_t aEpollEvents)
+{
+    uint8_t lEvents = 0;
+
+    if (aEpollEvents & (EPOLLIN | EPOLLPRI))
+        lEvents |= IOWatch::kEvent_Read;
+    if (aEpollEvents & EPOLLOUT)
+        lEvents |= IOWatch::kEvent_Write;
+
+    // Error and hang-up conditions are surfaced to the owner through its normal read and write paths.
+    if (aEpollEvents & (EPOLLERR | EPOLLHUP | EPOLLRDHUP))
+        lEvents |= IOWatch::kEvent_Read | IOWatch::kEvent_Write | IOWatch::kEvent_Error;
+
+    return lEvents;
+}
+
+/**
+ *  Register a file descriptor with the readiness backend.
+ *
+ *  The registration persists until UnregisterIO() is called; it must be removed before the descriptor is closed. The interest
+ *  of the owner is first evaluated before the layer next waits for events.
+ *
+ *  @param[in]  aWatch  A watch, initialized with IOWatch::Init, that is not currently registered.
+ *  @param[in]  aFD     The file descriptor to watch.
+ *
+ *  @retval #WEAVE_SYSTEM_NO_ERROR                  On success.
+ *  @retval #WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE    If the layer is not initialized or the watch is already registered.
+ *  @retval other                                   The mapped POSIX error from epoll_ctl().
+ */
+Error Layer::RegisterIO(IOWatch& aWatch, int aFD)
+{
+    Error lReturn = WEAVE_SYSTEM_NO_ERROR;
+    struct epoll_event lEvent;
+
+    VerifyOrExit(this->State() == kLayerState_Initialized, lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+    VerifyOrExit(!aWatch.IsRegistered(), lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+
+    // Add the descriptor disarmed; ArmIO() enables the events the owner is interested in.
+    memset(&lEvent, 0, sizeof(lEvent));
+    lEvent.events = EPOLLONESHOT;
+    lEvent.data.ptr = &aWatch;
+
+    VerifyOrExit(::epoll_ctl(this->mEpollFD, EPOLL_CTL_ADD, aFD, &lEvent) == 0, lReturn = MapErrorPOSIX(errno));
+
+    aWatch.mFD = aFD;
+    aWatch.mArmedEvents = 0;
+    aWatch.mUpdatePending = false;
+    aWatch.mNextUpdate = NULL;
+
+    this->UpdateIO(aWatch);
+
+exit:
+    return lReturn;
+}
+
+/**
+ *  Remove the registration of a file descriptor from the readiness backend and discard any readiness pending for it.
+ *
+ *  This may be called from within an event handler, including the handler of the watch itself.
+ *
+ *  @param[in]  aWatch  The watch to unregister. Calling this for a watch that is not registered has no effect.
+ */
+void Layer::UnregisterIO(IOWatch& aWatch)
+{
+    VerifyOrExit(aWatch.IsRegistered(), );
+
+    if (this->mEpollFD != -1)
+    {
+        ::epoll_ctl(this->mEpollFD, EPOLL_CTL_DEL, aWatch.mFD, NULL);
+    }
+
+    if (aWatch.mUpdatePending)
+    {
+        for (IOWatch** lLink = &this->mIOUpdateList; *lLink != NULL; lLink = &(*lLink)->mNextUpdate)
+        {
+            if (*lLink == &aWatch)
+            {
+                *lLink = aWatch.mNextUpdate;
+                break;
+            }
+        }
+    }
+
+    // The watch may be reused before the events retrieved along with its own have all been dispatched.
+    for (int i = 0; i < this->mIONumEvents; i++)
+    {
+        if (this->mIOEvents[i].data.ptr == &aWatch)
+        {
+            this->mIOEvents[i].events = 0;
+        }
+    }
+
+    aWatch.mFD = -1;
+    aWatch.mArmedEvents = 0;
+    aWatch.mUpdatePending = false;
+    aWatch.mNextUpdate = NULL;
+
+exit:
+    return;
+}
+
+/**
+ *  Notify the readiness backend that the events the owner of a watch is interested in may have changed.
+ *
+ *  The owner's prepare function is called again before the layer next waits for events, and the descriptor is re-armed for
+ *  the events it returns. Owners need not call this from within their own handle function, after which the interest is always
+ *  re-evaluated. Calling this for a watch that is not registered has no effect.
+ *
+ *  @param[in]  aWatch  The watch whose interest may have changed.
+ */
+void Layer::UpdateIO(IOWatch& aWatch)
+{
+    if (aWatch.IsRegistered() && !aWatch.mUpdatePending)
+    {
+        aWatch.mNextUpdate = this->mIOUpdateList;
+        this->mIOUpdateList = &aWatch;
+        aWatch.mUpdatePending = true;
+    }
+}
+
+void Layer::ArmIO(IOWatch& aWatch)
+{
+    const uint8_t lWanted = aWatch.mPrepare(aWatch) & (IOWatch::kEvent_Read | IOWatch::kEvent_Write);
+    struct epoll_event lEvent;
+
+    VerifyOrExit(lWanted != aWatch.mArmedEvents, );
+
+    memset(&lEvent, 0, sizeof(lEvent));
+    lEvent.data.ptr = &aWatch;
+
+    if (lWanted & IOWatch::kEvent_Read)
+        lEvent.events |= EPOLLIN;
+    if (lWanted & IOWatch::kEvent_Write)
+        lEvent.events |= EPOLLOUT;
+
+    // Error and hang-up conditions are reported whatever the interest, so a descriptor nobody is interested in reports them
+    // at most once, until it is re-armed.
+    if (lEvent.events == 0)
+        lEvent.events = EPOLLONESHOT;
+
+    if (::epoll_ctl(this->mEpollFD, EPOLL_CTL_MOD, aWatch.mFD, &lEvent) == 0)
+    {
+        aWatch.mArmedEvents = lWanted;
+    }
+
+exit:
+    return;
+}
+
+void Layer::ArmPendingIO(void)
+{
+    while (this->mIOUpdateList != NULL)
+    {
+        IOWatch& lWatch = *this->mIOUpdateList;
+
+        this->mIOUpdateList = lWatch.mNextUpdate;
+        lWatch.mNextUpdate = NULL;
+        lWatch.mUpdatePending = false;
+
+        this->ArmIO(lWatch);
+    }
+}
+
+uint8_t Layer::GetPendingIOEvents(const struct epoll_event& aEvent)
+{
+    IOWatch& lWatch = *static_cast<IOWatch*>(aEvent.data.ptr);
+
+    return IOEventsFromEpoll(aEvent.events) & lWatch.mPrepare(lWatch);
+}
+
+void Layer::DispatchIO(void)
+{
+    for (int i = 0; i < this->mIONumEvents; i++)
+    {
+        IOWatch* lWatch = static_cast<IOWatch*>(this->mIOEvents[i].data.ptr);
+        uint8_t lEvents;
+
+        // Skip the wake pipe and the events of watches unregistered since they were retrieved.
+        if (lWatch == NULL || this->mIOEvents[i].events == 0)
+            continue;
+
+        // An earlier handler may have changed the interest of the owner.
+        lEvents = this->GetPendingIOEvents(this->mIOEvents[i]);
+        this->mIOEvents[i].events = 0;
+
+        // Hand the events to the owner, which may close, and thereby unregister, any watch. A level-triggered descriptor that
+        // the owner does not drain is reported again by the next wait.
+        if (lEvents != 0)
+        {
+            lWatch->mHandle(*lWatch, lEvents);
+        }
+
+        this->UpdateIO(*lWatch);
+    }
+}
+
+/**
+ *  Wait for, and then dispatch, readiness events on the registered file descriptors and expired timers.
+ *
+ *  This is the epoll-based alternative to PrepareSelect() and HandleSelectResult(). The call sleeps for at most \c
+ *  aMaxSleepMilliseconds, less if a timer is due sooner. Only the owners of descriptors that became ready for events they are
+ *  interested in are visited, independent of how many descriptors are registered.
+ *
+ *  @param[in]  aMaxSleepMilliseconds   The longest time, in milliseconds, to wait for an event.
+ *
+ *  @retval #WEAVE_SYSTEM_NO_ERROR                  On success.
+ *  @retval #WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE    If the layer is not initialized.
+ *  @retval other                                   The mapped POSIX error from epoll_wait().
+ */
+Error Layer::ServiceEvents(uint32_t aMaxSleepMilliseconds)
+{
+    Error lReturn = WEAVE_SYSTEM_NO_ERROR;
+    struct epoll_event lEvents[WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS];
+    uint64_t lSleepTime;
+    uint64_t lDeadline;
+    int lNumEvents;
+
+    VerifyOrExit(this->State() == kLayerState_Initialized, lReturn = WEAVE_SYSTEM_ERROR_UNEXPECTED_STATE);
+
+    lSleepTime = this->GetTimerSleepMilliseconds(aMaxSleepMilliseconds);
+    lDeadline = Layer::GetClock_MonotonicMS() + lSleepTime;
+
+    while (true)
+    {
+        bool lWoken = false;
+        bool lPending = false;
+
+        this->ArmPendingIO();
+
+        lNumEvents = ::epoll_wait(this->mEpollFD, lEvents, WEAVE_SYSTEM_CONFIG_EPOLL_MAX_EVENTS,
+            (lSleepTime > INT_MAX) ? INT_MAX : static_cast<int>(lSleepTime));
+        if (lNumEvents < 0)
+        {
+            VerifyOrExit(errno == EINTR, lReturn = MapErrorPOSIX(errno));
+            lNumEvents = 0;
+            break;
+        }
+
+        for (int i = 0; i < lNumEvents; i++)
+        {
+            IOWatch* lWatch = static_cast<IOWatch*>(lEvents[i].data.ptr);
+
+            if (lWatch == NULL)
+            {
+                this->DrainWakePipe();
+                lWoken = true;
+            }
+            else if (this->GetPendingIOEvents(lEvents[i]) != 0)
+            {
+                lPending = true;
+            }
+            else
+            {
+                // The owner lost interest since the descriptor was armed; drop the events and re-arm it.
+                lEvents[i].events = 0;
+                this->UpdateIO(*lWatch);
+            }
+        }
+
+        // Keep sleeping through events no owner is interested in, as select() would have, rather than returning early.
+        if (lNumEvents == 0 || lWoken || lPending)
+            break;
+
+        const uint64_t lNow = Layer::GetClock_MonotonicMS();
+        if (lNow >= lDeadline)
+            break;
+
+        lSleepTime = lDeadline - lNow;
+    }
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    this->mHandleSelectThread = pthread_self();
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+    this->mIOEvents = lEvents;
+    this->mIONumEvents = lNumEvents;
+
+    this->DispatchIO();
+
+    this->mIOEvents = NULL;
+    this->mIONumEvents = 0;
+
+    this->DispatchExpiredTimers();
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    this->mHandleSelectThread = PTHREAD_NULL;
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+exit:
+    return lReturn;
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
@@ -716,6 +1113,9 @@ Error Layer::HandleSystemLayerEvent(Object& aTarget, EventType aEventType, uintp
         break;
 
     case kEvent_ScheduleWork:
+        // Work cancelled after it was posted has already been uncounted.
+        if (static_cast<Timer&>(aTarget).OnComplete != NULL)
+            __sync_fetch_and_sub(&aTarget.SystemLayer().mNumScheduledWork, 1);
         static_cast<Timer&>(aTarget).HandleComplete();
         break;
 
@@ -34,6 +34,10 @@
 #include <sys/select.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+#include <sys/epoll.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 #include <pthread.h>
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
@@ -43,6 +47,7 @@
 #include <SystemLayer/SystemError.h>
 #include <SystemLayer/SystemObject.h>
 #include <SystemLayer/SystemEvent.h>
+#include <SystemLayer/SystemTimer.h>
 
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
 
@@ -104,6 +109,76 @@ enum LayerState
     kLayerState_Initialized = 1      /**< Initialized state. */
 };
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+/**
+ *  @class IOWatch
+ *
+ *  @brief
+ *      This represents the persistent registration of a file descriptor with the epoll-based readiness backend of a Layer object.
+ *
+ *      The descriptor is watched level-triggered, and only for the events its owner is interested in, as reported by the
+ *      prepare function. The layer re-evaluates that interest before it next waits for events whenever the watch has been
+ *      dispatched, or its owner has called Layer::UpdateIO because the interest may have changed, so a descriptor that is
+ *      always writable does not wake the layer unless its owner has something to write.
+ *
+ *      Instances are embedded in the objects that own the descriptor and must be initialized with Init before registration.
+ */
+class NL_DLL_EXPORT IOWatch
+{
+    friend class Layer;
+
+public:
+    enum
+    {
+        kEvent_Read     = 0x01,     /**< The descriptor is readable. */
+        kEvent_Write    = 0x02,     /**< The descriptor is writable. */
+        kEvent_Error    = 0x04      /**< The descriptor has an error or hang-up condition. */
+    };
+
+    typedef uint8_t (*PrepareFunct)(IOWatch& aWatch);
+    typedef void (*HandleFunct)(IOWatch& aWatch, uint8_t aEvents);
+
+    void Init(PrepareFunct aPrepare, HandleFunct aHandle, void* aAppState);
+    bool IsRegistered(void) const;
+
+    void* AppState;                 /**< Generic pointer to the object that owns the watch. */
+
+private:
+    int mFD;
+    uint8_t mArmedEvents;
+    bool mUpdatePending;
+    IOWatch* mNextUpdate;
+    PrepareFunct mPrepare;
+    HandleFunct mHandle;
+};
+
+/**
+ *  Initialize the watch with the functions used to query the interest of, and dispatch events to, its owner.
+ *
+ *  @param[in]  aPrepare    A function returning the set of events the owner is currently interested in.
+ *  @param[in]  aHandle     A function called with the set of pending events the owner is interested in.
+ *  @param[in]  aAppState   A pointer to the object that owns the watch.
+ */
+inline void IOWatch::Init(PrepareFunct aPrepare, HandleFunct aHandle, void* aAppState)
+{
+    this->AppState = aAppState;
+    this->mFD = -1;
+    this->mArmedEvents = 0;
+    this->mUpdatePending = false;
+    this->mNextUpdate = NULL;
+    this->mPrepare = aPrepare;
+    this->mHandle = aHandle;
+}
+
+/**
+ *  Returns \c true if the watch is currently registered with a layer.
+ */
+inline bool IOWatch::IsRegistered(void) const
+{
+    return this->mFD >= 0;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 typedef Error (*LwIPEventHandlerFunction)(Object& aTarget, EventType aEventType, uintptr_t aArgument);
 
@@ -161,6 +236,13 @@ public:
     void WakeSelect(void);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    Error RegisterIO(IOWatch& aWatch, int aFD);
+    void UnregisterIO(IOWatch& aWatch);
+    void UpdateIO(IOWatch& aWatch);
+    Error ServiceEvents(uint32_t aMaxSleepMilliseconds);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     typedef Error (*EventHandler)(Object& aTarget, EventType aEventType, uintptr_t aArgument);
     Error AddEventHandlerDelegate(LwIPEventHandlerDelegate& aDelegate);
@@ -191,17 +273,38 @@ private:
     static LwIPEventHandlerDelegate sSystemEventHandlerDelegate;
 
     const LwIPEventHandlerDelegate* mEventDelegateList;
-    Timer* mTimerList;
     bool mTimerComplete;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+    TimerWheel mTimerWheel;
+    volatile uint32_t mNumScheduledWork;    /**< Upper bound on the number of ScheduleWork timers not yet completed. */
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     int mWakePipeIn;
     int mWakePipeOut;
+    volatile bool mScheduledWorkPending;
 
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     pthread_t mHandleSelectThread;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    int mEpollFD;
+    IOWatch* mIOUpdateList;
+    struct epoll_event* mIOEvents;
+    int mIONumEvents;
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
+    uint64_t GetTimerSleepMilliseconds(uint64_t aMaxSleepMilliseconds);
+    void DispatchExpiredTimers(void);
+    void DrainWakePipe(void);
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    void ArmIO(IOWatch& aWatch);
+    void ArmPendingIO(void);
+    uint8_t GetPendingIOEvents(const struct epoll_event& aEvent);
+    void DispatchIO(void);
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
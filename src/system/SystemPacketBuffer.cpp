@@ -67,7 +67,84 @@ namespace System {
 
 static BufferPoolElement sBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC];
 
-PacketBuffer* PacketBuffer::sFreeList = PacketBuffer::BuildFreeList();
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+typedef union
+{
+    PacketBuffer Header;
+    uint8_t Block[WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL];
+} SmallBufferPoolElement;
+
+static SmallBufferPoolElement sSmallBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL];
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+typedef union
+{
+    PacketBuffer Header;
+    uint8_t Block[WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE + WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM];
+} MediumBufferPoolElement;
+
+static MediumBufferPoolElement sMediumBufferPool[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM];
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM && \
+    WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL must be less than WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM"
+#endif
+
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM && \
+    WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM >= WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX
+#error "WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM must be less than WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX"
+#endif
+
+/*
+ * A pool of packet buffers of one size. The pools are listed in order of increasing capacity, the full-size buffers last.
+ */
+struct BufferPool
+{
+    uint8_t* mBlocks;
+    size_t mBlockSize;
+    size_t mNumBlocks;
+    size_t mCapacity;
+    PacketBuffer* mFreeList;
+    int mStatsEntry;
+};
+
+static BufferPool sBufferPools[WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS] =
+{
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+    { sSmallBufferPool[0].Block, sizeof(SmallBufferPoolElement), WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL,
+      sizeof(sSmallBufferPool[0].Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE, NULL,
+      nl::Weave::System::Stats::kSystemLayer_NumSmallPacketBufs },
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+    { sMediumBufferPool[0].Block, sizeof(MediumBufferPoolElement), WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM,
+      sizeof(sMediumBufferPool[0].Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE, NULL,
+      nl::Weave::System::Stats::kSystemLayer_NumMediumPacketBufs },
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+    { sBufferPool[0].Block, sizeof(BufferPoolElement), WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC,
+      sizeof(sBufferPool[0].Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE, NULL,
+      nl::Weave::System::Stats::kSystemLayer_NumPacketBufs }
+};
+
+// Returns the index of the pool that a pooled buffer was allocated from.
+static size_t BufferPoolIndex(const PacketBuffer* aPacket)
+{
+    const uint8_t* lBlock = reinterpret_cast<const uint8_t*>(aPacket);
+    size_t i;
+
+    for (i = 0; i < WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS - 1; i++)
+    {
+        const BufferPool& lPool = sBufferPools[i];
+
+        if (lBlock >= lPool.mBlocks && lBlock < lPool.mBlocks + (lPool.mBlockSize * lPool.mNumBlocks))
+            break;
+    }
+
+    return i;
+}
+
+bool PacketBuffer::sFreeListBuilt = PacketBuffer::BuildFreeList();
 
 #if !WEAVE_SYSTEM_CONFIG_NO_LOCKING
 static Mutex sBufferPoolMutex;
@@ -76,6 +153,65 @@ static Mutex sBufferPoolMutex;
 #define UNLOCK_BUF_POOL()   do { sBufferPoolMutex.Unlock(); } while (0)
 #endif // !WEAVE_SYSTEM_CONFIG_NO_LOCKING
 
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#define WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE 1
+
+/*
+ * The buffers released by a thread and kept for its own subsequent allocations, one list for each pool.
+ *
+ * While the caches are in use, reference counts are updated atomically and the pool lock only guards the shared free lists,
+ * so that a thread which allocates and releases buffers at a steady rate does not take the lock at all.
+ */
+struct BufferThreadCache
+{
+    PacketBuffer* mFreeList[WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS];
+    size_t mCount[WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS];
+};
+
+static pthread_key_t sBufferThreadCacheKey;
+static bool sBufferThreadCacheKeyValid;
+
+// Returns the cache of the calling thread, creating it on first use, or NULL if none can be created.
+static BufferThreadCache* GetBufferThreadCache(void)
+{
+    BufferThreadCache* lCache = NULL;
+
+    VerifyOrExit(sBufferThreadCacheKeyValid, );
+
+    lCache = static_cast<BufferThreadCache*>(pthread_getspecific(sBufferThreadCacheKey));
+    if (lCache == NULL)
+    {
+        lCache = static_cast<BufferThreadCache*>(calloc(1, sizeof(BufferThreadCache)));
+        if (lCache != NULL && pthread_setspecific(sBufferThreadCacheKey, lCache) != 0)
+        {
+            free(lCache);
+            lCache = NULL;
+        }
+    }
+
+exit:
+    return lCache;
+}
+
+#define LOCK_BUF_REF()          do { } while (0)
+#define UNLOCK_BUF_REF()        do { } while (0)
+#define INCREMENT_BUF_REF(buf)  __sync_add_and_fetch(&(buf)->ref, 1)
+#define DECREMENT_BUF_REF(buf)  __sync_sub_and_fetch(&(buf)->ref, 1)
+
+// Buffers in a thread cache are not in use. The statistics are shared by all threads, so they are updated under the pool lock;
+// the lock is therefore only avoided when statistics are not provided.
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#define CACHE_STATS_INCREMENT(entry)    do { LOCK_BUF_POOL(); SYSTEM_STATS_INCREMENT(entry); UNLOCK_BUF_POOL(); } while (0)
+#define CACHE_STATS_DECREMENT(entry)    do { LOCK_BUF_POOL(); SYSTEM_STATS_DECREMENT(entry); UNLOCK_BUF_POOL(); } while (0)
+#else // !WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+#define CACHE_STATS_INCREMENT(entry)    do { } while (0)
+#define CACHE_STATS_DECREMENT(entry)    do { } while (0)
+#endif // !WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+#else // !(WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE)
+#define WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE 0
+#endif // !(WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE)
+
 #endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
 #ifndef LOCK_BUF_POOL
@@ -86,6 +222,14 @@ static Mutex sBufferPoolMutex;
 #define UNLOCK_BUF_POOL()   do { } while (0)
 #endif // !defined(UNLOCK_BUF_POOL)
 
+// Unless the thread caches are in use, reference counts are guarded by the pool lock.
+#ifndef LOCK_BUF_REF
+#define LOCK_BUF_REF()          LOCK_BUF_POOL()
+#define UNLOCK_BUF_REF()        UNLOCK_BUF_POOL()
+#define INCREMENT_BUF_REF(buf)  (++(buf)->ref)
+#define DECREMENT_BUF_REF(buf)  (--(buf)->ref)
+#endif // !defined(LOCK_BUF_REF)
+
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 /**
@@ -420,9 +564,9 @@ void PacketBuffer::AddRef()
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
     pbuf_ref(this);
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
-    LOCK_BUF_POOL();
-    ++this->ref;
-    UNLOCK_BUF_POOL();
+    LOCK_BUF_REF();
+    INCREMENT_BUF_REF(this);
+    UNLOCK_BUF_REF();
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 }
 
@@ -461,16 +605,7 @@ PacketBuffer* PacketBuffer::NewWithAvailableSize(uint16_t aReservedSize, size_t
 
     static_cast<void>(lBlockSize);
 
-    LOCK_BUF_POOL();
-
-    lPacket = sFreeList;
-    if (lPacket != NULL)
-    {
-        sFreeList = static_cast<PacketBuffer*>(lPacket->next);
-        SYSTEM_STATS_INCREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
-    }
-
-    UNLOCK_BUF_POOL();
+    lPacket = PacketBuffer::AllocFromPool(lAllocSize);
 
 #else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
@@ -572,7 +707,7 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
 
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-    LOCK_BUF_POOL();
+    LOCK_BUF_REF();
 
     while (aPacket != NULL)
     {
@@ -580,15 +715,13 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
 
         VerifyOrDieWithMsg(aPacket->ref > 0, WeaveSystemLayer, "SystemPacketBuffer::Free: aPacket->ref = 0");
 
-        aPacket->ref--;
-        if (aPacket->ref == 0)
+        if (DECREMENT_BUF_REF(aPacket) == 0)
         {
-            SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
             aPacket->Clear();
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
-            aPacket->next = sFreeList;
-            sFreeList = aPacket;
+            PacketBuffer::ReturnToPool(aPacket);
 #else // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+            SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kSystemLayer_NumPacketBufs);
             free(aPacket);
 #endif // !WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
             aPacket = lNextPacket;
@@ -599,7 +732,7 @@ void PacketBuffer::Free(PacketBuffer* aPacket)
         }
     }
 
-    UNLOCK_BUF_POOL();
+    UNLOCK_BUF_REF();
 
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 }
@@ -662,21 +795,147 @@ PacketBuffer* PacketBuffer::RightSize(PacketBuffer *aPacket)
 
 #if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
-PacketBuffer* PacketBuffer::BuildFreeList()
+bool PacketBuffer::BuildFreeList()
 {
-    PacketBuffer* lHead = NULL;
-
-    for (int i = 0; i < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC; i++)
+    for (size_t i = 0; i < WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS; i++)
     {
-        PacketBuffer* lCursor = &sBufferPool[i].Header;
-        lCursor->next = lHead;
-        lCursor->ref = 0;
-        lHead = lCursor;
+        BufferPool& lPool = sBufferPools[i];
+        PacketBuffer* lHead = NULL;
+
+        for (size_t j = 0; j < lPool.mNumBlocks; j++)
+        {
+            PacketBuffer* lCursor = reinterpret_cast<PacketBuffer*>(lPool.mBlocks + (j * lPool.mBlockSize));
+            lCursor->next = lHead;
+            lCursor->ref = 0;
+            lHead = lCursor;
+        }
+
+        lPool.mFreeList = lHead;
     }
 
     Mutex::Init(sBufferPoolMutex);
 
-    return lHead;
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    sBufferThreadCacheKeyValid = (pthread_key_create(&sBufferThreadCacheKey, PacketBuffer::FlushThreadCache) == 0);
+#endif // WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+
+    return true;
+}
+
+/**
+ * Take a buffer of at least \c aAllocSize bytes from the smallest pool that has one, preferring the buffers kept by the calling
+ * thread.
+ */
+PacketBuffer* PacketBuffer::AllocFromPool(size_t aAllocSize)
+{
+    PacketBuffer* lPacket = NULL;
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    BufferThreadCache* lCache = GetBufferThreadCache();
+#endif // WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+
+    for (size_t i = 0; i < WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS && lPacket == NULL; i++)
+    {
+        BufferPool& lPool = sBufferPools[i];
+
+        if (lPool.mCapacity < aAllocSize)
+            continue;
+
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+        if (lCache != NULL && lCache->mFreeList[i] != NULL)
+        {
+            lPacket = lCache->mFreeList[i];
+            lCache->mFreeList[i] = static_cast<PacketBuffer*>(lPacket->next);
+            lCache->mCount[i]--;
+            CACHE_STATS_INCREMENT(lPool.mStatsEntry);
+            break;
+        }
+#endif // WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+
+        LOCK_BUF_POOL();
+
+        lPacket = lPool.mFreeList;
+        if (lPacket != NULL)
+        {
+            lPool.mFreeList = static_cast<PacketBuffer*>(lPacket->next);
+            SYSTEM_STATS_INCREMENT(lPool.mStatsEntry);
+        }
+
+        UNLOCK_BUF_POOL();
+    }
+
+    return lPacket;
+}
+
+/**
+ * Return a released buffer to the pool it was allocated from, or to the calling thread's cache if that has room.
+ *
+ * Unless the thread caches are in use, this is called with the pool lock held.
+ */
+void PacketBuffer::ReturnToPool(PacketBuffer* aPacket)
+{
+    BufferPool& lPool = sBufferPools[BufferPoolIndex(aPacket)];
+
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    const size_t lIndex = static_cast<size_t>(&lPool - sBufferPools);
+    BufferThreadCache* lCache = GetBufferThreadCache();
+
+    if (lCache != NULL && lCache->mCount[lIndex] < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE)
+    {
+        aPacket->next = lCache->mFreeList[lIndex];
+        lCache->mFreeList[lIndex] = aPacket;
+        lCache->mCount[lIndex]++;
+        CACHE_STATS_DECREMENT(lPool.mStatsEntry);
+        return;
+    }
+
+    LOCK_BUF_POOL();
+#endif // WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+
+    aPacket->next = lPool.mFreeList;
+    lPool.mFreeList = aPacket;
+    SYSTEM_STATS_DECREMENT(lPool.mStatsEntry);
+
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    UNLOCK_BUF_POOL();
+#endif // WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+}
+
+/**
+ * Return the buffers kept by an exiting thread to their pools. This is the destructor of the thread cache key.
+ */
+void PacketBuffer::FlushThreadCache(void* aCache)
+{
+#if WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    BufferThreadCache* lCache = static_cast<BufferThreadCache*>(aCache);
+
+    LOCK_BUF_POOL();
+
+    for (size_t i = 0; i < WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS; i++)
+    {
+        while (lCache->mFreeList[i] != NULL)
+        {
+            PacketBuffer* lPacket = lCache->mFreeList[i];
+
+            lCache->mFreeList[i] = static_cast<PacketBuffer*>(lPacket->next);
+            lPacket->next = sBufferPools[i].mFreeList;
+            sBufferPools[i].mFreeList = lPacket;
+        }
+    }
+
+    UNLOCK_BUF_POOL();
+
+    free(lCache);
+#else // !WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+    static_cast<void>(aCache);
+#endif // !WEAVE_SYSTEM_PACKETBUFFER_THREAD_CACHE
+}
+
+/**
+ * Return the capacity of a pooled buffer, which depends on the pool it was allocated from.
+ */
+size_t PacketBuffer::PooledAllocSize(void) const
+{
+    return sBufferPools[BufferPoolIndex(this)].mCapacity;
 }
 
 #endif //  !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
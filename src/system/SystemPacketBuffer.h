@@ -135,9 +135,14 @@ public:
 
 private:
 #if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
-    static PacketBuffer* sFreeList;
+    static bool sFreeListBuilt;
 
-    static PacketBuffer* BuildFreeList(void);
+    static bool BuildFreeList(void);
+    static PacketBuffer* AllocFromPool(size_t aAllocSize);
+    static void ReturnToPool(PacketBuffer* aPacket);
+    static void FlushThreadCache(void* aCache);
+
+    size_t PooledAllocSize(void) const;
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
     void Clear(void);
@@ -202,6 +207,14 @@ typedef union
     uint8_t Block[WEAVE_SYSTEM_PACKETBUFFER_SIZE];
 } BufferPoolElement;
 
+/**
+ * @def WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS
+ *
+ *  The number of sizes of pooled packet buffers, including the full-size buffers.
+ */
+#define WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS \
+    (1 + (WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL > 0) + (WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM > 0))
+
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
 
 /**
@@ -227,10 +240,12 @@ inline size_t PacketBuffer::AllocSize(void) const
 #else // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC == 0
     return static_cast<size_t>(this->alloc_size);
-#else // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
+#elif WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS > 1
+    return this->PooledAllocSize();
+#else // WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS == 1
     extern BufferPoolElement gDummyBufferPoolElement;
     return sizeof(gDummyBufferPoolElement.Block) - WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
-#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC != 0
+#endif // WEAVE_SYSTEM_PACKETBUFFER_NUM_POOLS == 1
 #endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP
 }
 
@@ -125,52 +125,37 @@ bool Timer::IsEarlierEpoch(const Timer::Epoch &inFirst, const Timer::Epoch &inSe
  */
 Error Timer::Start(uint32_t aDelayMilliseconds, OnCompleteFunct aOnComplete, void* aAppState)
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
     Layer& lLayer = this->SystemLayer();
+    Epoch lCurrentEpoch;
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    Epoch lNextEpoch;
+    bool lIsEarliest;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
     WEAVE_SYSTEM_FAULT_INJECT(FaultInjection::kFault_TimeoutImmediate, aDelayMilliseconds = 0);
 
+    lCurrentEpoch = Timer::GetCurrentEpoch();
+
     this->AppState = aAppState;
-    this->mAwakenEpoch = Timer::GetCurrentEpoch() + static_cast<Epoch>(aDelayMilliseconds);
+    this->mAwakenEpoch = lCurrentEpoch + static_cast<Epoch>(aDelayMilliseconds);
     if (!__sync_bool_compare_and_swap(&this->OnComplete, NULL, aOnComplete))
     {
         WeaveDie();
     }
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
-    // add to the sorted list of timers. Earliest timer appears first.
-    if (lLayer.mTimerList == NULL ||
-        this->IsEarlierEpoch(this->mAwakenEpoch, lLayer.mTimerList->mAwakenEpoch))
-    {
-        this->mNextTimer = lLayer.mTimerList;
-        lLayer.mTimerList = this;
-
-        // this is the new eariest timer and so the timer needs (re-)starting provided that
-        // the system is not currently processing expired timers, in which case it is left to
-        // HandleExpiredTimers() to re-start the timer.
-        if (!lLayer.mTimerComplete)
-        {
-            lLayer.StartPlatformTimer(aDelayMilliseconds);
-        }
-    }
-    else
-    {
-        Timer* lTimer = lLayer.mTimerList;
-
-        while (lTimer->mNextTimer)
-        {
-            if (this->IsEarlierEpoch(this->mAwakenEpoch, lTimer->mNextTimer->mAwakenEpoch))
-            {
-                // found the insert location.
-                break;
-            }
+    lIsEarliest = !lLayer.mTimerWheel.GetNextEpoch(lNextEpoch) || this->IsEarlierEpoch(this->mAwakenEpoch, lNextEpoch);
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-            lTimer = lTimer->mNextTimer;
-        }
+    lLayer.mTimerWheel.Insert(*this, lCurrentEpoch);
 
-        this->mNextTimer = lTimer->mNextTimer;
-        lTimer->mNextTimer = this;
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    // this is the new eariest timer and so the timer needs (re-)starting provided that
+    // the system is not currently processing expired timers, in which case it is left to
+    // HandleExpiredTimers() to re-start the timer.
+    if (lIsEarliest && !lLayer.mTimerComplete)
+    {
+        lLayer.StartPlatformTimer(aDelayMilliseconds);
     }
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
@@ -193,6 +178,9 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
     err = lLayer.PostEvent(*this, Weave::System::kEvent_ScheduleWork, 0);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    // This may be called from any thread, so the timer is not placed in the timer wheel. Instead, the thread servicing the layer
+    // is told to look for it in the pool.
+    lLayer.mScheduledWorkPending = true;
     lLayer.WakeSelect();
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
@@ -206,9 +194,7 @@ Error Timer::ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState)
  */
 Error Timer::Cancel()
 {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
     Layer& lLayer = this->SystemLayer();
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
     OnCompleteFunct lOnComplete = this->OnComplete;
 
     // Check if the timer is armed
@@ -217,35 +203,8 @@ Error Timer::Cancel()
     VerifyOrExit(__sync_bool_compare_and_swap(&this->OnComplete, lOnComplete, NULL), );
 
     // Since this thread changed the state of OnComplete, release the timer.
+    lLayer.mTimerWheel.Remove(*this);
     this->AppState = NULL;
-
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
-    if (lLayer.mTimerList)
-    {
-        if (this == lLayer.mTimerList)
-        {
-            lLayer.mTimerList = this->mNextTimer;
-        }
-        else
-        {
-            Timer* lTimer = lLayer.mTimerList;
-
-            while (lTimer->mNextTimer)
-            {
-                if (this == lTimer->mNextTimer)
-                {
-                    lTimer->mNextTimer = this->mNextTimer;
-                    break;
-                }
-
-                lTimer = lTimer->mNextTimer;
-            }
-        }
-
-        this->mNextTimer = NULL;
-    }
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
-
     this->Release();
 exit:
     return WEAVE_SYSTEM_NO_ERROR;
@@ -267,6 +226,7 @@ void Timer::HandleComplete()
     VerifyOrExit(__sync_bool_compare_and_swap(&this->OnComplete, lOnComplete, NULL), );
 
     // Since this thread changed the state of OnComplete, release the timer.
+    lLayer.mTimerWheel.Remove(*this);
     AppState = NULL;
     this->Release();
 
@@ -296,59 +256,387 @@ exit:
 Error Timer::HandleExpiredTimers(Layer& aLayer)
 {
     size_t timersHandled = 0;
+    Timer* lTimer;
+    Epoch nextEpoch;
 
-    // Expire each timer in turn until an unexpired timer is reached or the timerlist is emptied.  We set the current expiration
-    // time outside the loop; that way timers set after the current tick will not be executed within this expiration window
-    // regardless how long the processing of the currently expired timers took
+    // Expire each timer in turn until no expired timer remains.  We set the current expiration time outside the loop; that way
+    // timers set after the current tick will not be executed within this expiration window regardless how long the processing of
+    // the currently expired timers took
     Epoch currentEpoch = Timer::GetCurrentEpoch();
 
-    while (aLayer.mTimerList)
+    // limit the number of timers handled before the control is returned to the event queue.  The bound is similar to
+    // (though not exactly same) as that on the sockets-based systems.
+    while ((timersHandled < Timer::sPool.Size()) && ((lTimer = aLayer.mTimerWheel.PopExpired(currentEpoch)) != NULL))
     {
-        // limit the number of timers handled before the control is returned to the event queue.  The bound is similar to
-        // (though not exactly same) as that on the sockets-based systems.
+        aLayer.mTimerComplete = true;
+        lTimer->HandleComplete();
+        aLayer.mTimerComplete = false;
 
-        // The platform timer API has MSEC resolution so expire any timer with less than 1 msec remaining.
-        if ((timersHandled < Timer::sPool.Size()) && Timer::IsEarlierEpoch(aLayer.mTimerList->mAwakenEpoch, currentEpoch + 1))
-        {
-            Timer& lTimer = *aLayer.mTimerList;
-            aLayer.mTimerList = lTimer.mNextTimer;
-            lTimer.mNextTimer = NULL;
+        timersHandled++;
+    }
+
+    if (aLayer.mTimerWheel.GetNextEpoch(nextEpoch))
+    {
+        // timers still exist so restart the platform timer.
+        uint64_t delayMilliseconds = 0ULL;
 
-            aLayer.mTimerComplete = true;
-            lTimer.HandleComplete();
-            aLayer.mTimerComplete = false;
+        currentEpoch = Timer::GetCurrentEpoch();
 
-            timersHandled++;
-        }
-        else
+        // the next timer expires in the future, so set the delayMilliseconds to a non-zero value
+        if (currentEpoch < nextEpoch)
         {
-            // timers still exist so restart the platform timer.
-            uint64_t delayMilliseconds = 0ULL;
-
-            currentEpoch = Timer::GetCurrentEpoch();
-
-            // the next timer expires in the future, so set the delayMilliseconds to a non-zero value
-            if (currentEpoch < aLayer.mTimerList->mAwakenEpoch)
-            {
-                delayMilliseconds = aLayer.mTimerList->mAwakenEpoch - currentEpoch;
-            }
-            /*
-             * StartPlatformTimer() accepts a 32bit value in milliseconds.  Epochs are 64bit numbers.  The only way in which this could
-             * overflow is if time went backwards (e.g. as a result of a time adjustment from time synchronization).  Verify that the
-             * timer can still be executed (even if it is very late) and exit if that is the case.  Note: if the time sync ever ends up
-             * adjusting the clock, we should implement a method that deals with all the timers in the system.
-             */
-            VerifyOrDie(delayMilliseconds <= UINT32_MAX);
-
-            aLayer.StartPlatformTimer(static_cast<uint32_t>(delayMilliseconds));
-            break; // all remaining timers are still ticking.
+            delayMilliseconds = nextEpoch - currentEpoch;
         }
+        /*
+         * StartPlatformTimer() accepts a 32bit value in milliseconds.  Epochs are 64bit numbers.  The only way in which this could
+         * overflow is if time went backwards (e.g. as a result of a time adjustment from time synchronization).  Verify that the
+         * timer can still be executed (even if it is very late) and exit if that is the case.  Note: if the time sync ever ends up
+         * adjusting the clock, we should implement a method that deals with all the timers in the system.
+         */
+        VerifyOrDie(delayMilliseconds <= UINT32_MAX);
+
+        aLayer.StartPlatformTimer(static_cast<uint32_t>(delayMilliseconds));
     }
 
     return WEAVE_SYSTEM_NO_ERROR;
 }
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+/**
+ *  Empties the timer wheel and sets its current epoch.
+ *
+ *  @param[in]  aCurrentEpoch   The current epoch, as returned by Timer::GetCurrentEpoch.
+ */
+void TimerWheel::Init(Timer::Epoch aCurrentEpoch)
+{
+    memset(this->mSlots, 0, sizeof(this->mSlots));
+    memset(this->mOccupied, 0, sizeof(this->mOccupied));
+    memset(this->mIndex, 0, sizeof(this->mIndex));
+    this->mExpired = NULL;
+    this->mDeferred = NULL;
+    this->mWheelEpoch = aCurrentEpoch;
+    this->mCount = 0;
+    this->mPopping = false;
+}
+
+/**
+ *  Adds an armed timer to the wheel.
+ *
+ *  @param[in]  aTimer          A timer, not in the wheel, whose awaken epoch, callback function and application state are set.
+ *  @param[in]  aCurrentEpoch   The current epoch, as returned by Timer::GetCurrentEpoch.
+ */
+void TimerWheel::Insert(Timer& aTimer, Timer::Epoch aCurrentEpoch)
+{
+    Timer*& lHead = this->mIndex[Hash(aTimer.OnComplete, aTimer.AppState)];
+
+    // An empty wheel has nothing to catch up on, so bring it forward to the present.
+    if (this->mCount == 0 && this->mWheelEpoch < aCurrentEpoch)
+    {
+        this->mWheelEpoch = aCurrentEpoch;
+    }
+
+    // A timer due at an epoch that the wheel has already passed expires at once. If it is (re)started while expired timers are
+    // being handled, it waits for the next round of handling, so that a timer that keeps restarting itself cannot starve I/O.
+    if (aTimer.mAwakenEpoch < this->mWheelEpoch)
+        this->Push(this->mPopping ? this->mDeferred : this->mExpired, aTimer);
+    else
+        this->Place(aTimer);
+
+    aTimer.mIndexNext = lHead;
+    if (lHead != NULL)
+        lHead->mIndexPrevNext = &aTimer.mIndexNext;
+    aTimer.mIndexPrevNext = &lHead;
+    lHead = &aTimer;
+
+    this->mCount++;
+}
+
+/**
+ *  Removes a timer from the wheel. Has no effect if the timer is not in the wheel.
+ */
+void TimerWheel::Remove(Timer& aTimer)
+{
+    VerifyOrExit(aTimer.mWheelSlot != kSlot_None, );
+
+    this->Unlink(aTimer);
+
+    *aTimer.mIndexPrevNext = aTimer.mIndexNext;
+    if (aTimer.mIndexNext != NULL)
+        aTimer.mIndexNext->mIndexPrevNext = aTimer.mIndexPrevNext;
+    aTimer.mIndexNext = NULL;
+    aTimer.mIndexPrevNext = NULL;
+
+    this->mCount--;
+
+exit:
+    return;
+}
+
+/**
+ *  Returns the timer in the wheel with the specified callback function and application state, or NULL if there is none.
+ */
+Timer* TimerWheel::Find(Timer::OnCompleteFunct aOnComplete, void* aAppState) const
+{
+    Timer* lTimer = this->mIndex[Hash(aOnComplete, aAppState)];
+
+    while (lTimer != NULL && !(lTimer->OnComplete == aOnComplete && lTimer->AppState == aAppState))
+        lTimer = lTimer->mIndexNext;
+
+    return lTimer;
+}
+
+/**
+ *  Returns the epoch by which PopExpired must next be called.
+ *
+ *  @note
+ *      The returned epoch may precede the awaken epoch of the earliest timer, when timers must be moved down the wheel before
+ *      they can expire. It never follows it.
+ *
+ *  @param[out] aEpoch  Set to the next epoch of interest when the wheel is not empty.
+ *
+ *  @return \c true if the wheel holds any timer, \c false otherwise.
+ */
+bool TimerWheel::GetNextEpoch(Timer::Epoch& aEpoch) const
+{
+    if (this->mExpired != NULL || this->mDeferred != NULL)
+    {
+        const Timer* lTimer = (this->mExpired != NULL) ? this->mExpired : this->mDeferred;
+
+        // Every expired timer is due before the current epoch of the wheel.
+        aEpoch = (lTimer->mAwakenEpoch < this->mWheelEpoch) ? lTimer->mAwakenEpoch : this->mWheelEpoch - 1;
+        return true;
+    }
+
+    return this->GetNextSlotEpoch(aEpoch);
+}
+
+/**
+ *  Returns the earliest epoch, at or after the current epoch of the wheel, at which an occupied slot is reached.
+ *
+ *  @param[out] aEpoch  Set to that epoch when any slot is occupied.
+ *
+ *  @return \c true if any slot is occupied, \c false otherwise.
+ */
+bool TimerWheel::GetNextSlotEpoch(Timer::Epoch& aEpoch) const
+{
+    bool lReturn = false;
+    Timer::Epoch lEarliest = 0;
+
+    for (unsigned int lLevel = 0; lLevel < kNumLevels; lLevel++)
+    {
+        if (this->mOccupied[lLevel] != 0)
+        {
+            // Find the first slot of this level that begins at or after the current epoch of the wheel.
+            const unsigned int kShift = kSlotBits * lLevel;
+            const Timer::Epoch kFirst = (this->mWheelEpoch + ((static_cast<Timer::Epoch>(1) << kShift) - 1)) >> kShift;
+            const Timer::Epoch kCandidate =
+                (kFirst + NextOccupied(this->mOccupied[lLevel], static_cast<unsigned int>(kFirst) & kSlotMask)) << kShift;
+
+            if (!lReturn || kCandidate < lEarliest)
+                lEarliest = kCandidate;
+
+            lReturn = true;
+        }
+    }
+
+    aEpoch = lEarliest;
+    return lReturn;
+}
+
+/**
+ *  Removes and returns a timer that is due at or before the specified epoch.
+ *
+ *  Timers are returned in order of their awaken epoch, except that timers inserted after their awaken epoch had passed come
+ *  first. Timers inserted while expired timers are being handled are returned by the same sequence of calls (ending with the
+ *  call that returns NULL) only if they are due at an epoch that the wheel has not yet reached; the others are returned by the
+ *  next sequence.
+ *
+ *  @param[in]  aCurrentEpoch   The current epoch, as returned by Timer::GetCurrentEpoch.
+ *
+ *  @return An expired timer, which is no longer in the wheel, or NULL if no timer is due.
+ */
+Timer* TimerWheel::PopExpired(Timer::Epoch aCurrentEpoch)
+{
+    Timer* lTimer = NULL;
+
+    while (this->mExpired == NULL)
+    {
+        const Timer::Epoch kEpoch = this->mWheelEpoch;
+        Timer::Epoch lNextEpoch;
+
+        VerifyOrExit(this->mCount != 0 && kEpoch <= aCurrentEpoch, );
+
+        // Move the timers of every level whose current slot begins at this epoch down the wheel.
+        for (unsigned int lLevel = 1; lLevel < kNumLevels; lLevel++)
+        {
+            const unsigned int kShift = kSlotBits * lLevel;
+
+            if ((kEpoch & ((static_cast<Timer::Epoch>(1) << kShift) - 1)) != 0)
+                break;
+
+            this->Cascade(lLevel, static_cast<unsigned int>(kEpoch >> kShift) & kSlotMask);
+        }
+
+        // Move the timers due at this epoch to the expired list.
+        lTimer = this->mSlots[0][kEpoch & kSlotMask];
+        if (lTimer != NULL)
+        {
+            this->mSlots[0][kEpoch & kSlotMask] = NULL;
+            this->mOccupied[0] &= ~(static_cast<uint64_t>(1) << (kEpoch & kSlotMask));
+
+            this->mExpired = lTimer;
+            lTimer->mWheelPrevNext = &this->mExpired;
+
+            for (; lTimer != NULL; lTimer = lTimer->mWheelNext)
+                lTimer->mWheelSlot = kSlot_Expired;
+        }
+
+        this->mWheelEpoch = kEpoch + 1;
+
+        // Skip the epochs at which there is nothing to do.
+        if (this->mExpired == NULL)
+        {
+            if (!this->GetNextSlotEpoch(lNextEpoch) || lNextEpoch > aCurrentEpoch)
+                lNextEpoch = aCurrentEpoch + 1;
+
+            if (lNextEpoch > this->mWheelEpoch)
+                this->mWheelEpoch = lNextEpoch;
+        }
+    }
+
+    lTimer = this->mExpired;
+    this->Remove(*lTimer);
+    this->mPopping = true;
+
+exit:
+    if (lTimer == NULL)
+    {
+        this->mPopping = false;
+
+        while (this->mDeferred != NULL)
+        {
+            Timer& lDeferred = *this->mDeferred;
+
+            this->Unlink(lDeferred);
+            this->Push(this->mExpired, lDeferred);
+        }
+    }
+
+    return lTimer;
+}
+
+size_t TimerWheel::Hash(Timer::OnCompleteFunct aOnComplete, void* aAppState)
+{
+    uintptr_t lKey = reinterpret_cast<uintptr_t>(aOnComplete) ^ (reinterpret_cast<uintptr_t>(aAppState) * 31);
+
+    lKey ^= lKey >> 11;
+
+    return static_cast<size_t>(lKey % kNumHashes);
+}
+
+/**
+ *  Returns the distance from \c aSlot to the first occupied slot at or after it, wrapping around the level.
+ *
+ *  @param[in]  aOccupied   The non-zero occupancy bitmap of a level.
+ *  @param[in]  aSlot       The slot at which to start.
+ */
+unsigned int TimerWheel::NextOccupied(uint64_t aOccupied, unsigned int aSlot)
+{
+    const uint64_t kAllSlots = (static_cast<uint64_t>(2) << (kNumSlots - 1)) - 1;
+    uint64_t lRotated = aOccupied >> aSlot;
+
+    if (aSlot != 0)
+        lRotated |= aOccupied << (kNumSlots - aSlot);
+
+    return static_cast<unsigned int>(__builtin_ctzll(lRotated & kAllSlots));
+}
+
+/**
+ *  Links a timer into the slot for its awaken epoch, relative to the current epoch of the wheel.
+ */
+void TimerWheel::Place(Timer& aTimer)
+{
+    Timer::Epoch lEpoch = aTimer.mAwakenEpoch;
+    unsigned int lLevel = 0;
+    unsigned int lSlot;
+
+    // A timer that is already due is placed in the slot for the current epoch of the wheel.
+    if (lEpoch < this->mWheelEpoch)
+        lEpoch = this->mWheelEpoch;
+
+    while ((lLevel + 1 < kNumLevels) && (((lEpoch - this->mWheelEpoch) >> (kSlotBits * (lLevel + 1))) != 0))
+        lLevel++;
+
+    lSlot = static_cast<unsigned int>(lEpoch >> (kSlotBits * lLevel)) & kSlotMask;
+
+    Timer*& lHead = this->mSlots[lLevel][lSlot];
+
+    aTimer.mWheelNext = lHead;
+    if (lHead != NULL)
+        lHead->mWheelPrevNext = &aTimer.mWheelNext;
+    aTimer.mWheelPrevNext = &lHead;
+    lHead = &aTimer;
+
+    this->mOccupied[lLevel] |= static_cast<uint64_t>(1) << lSlot;
+    aTimer.mWheelSlot = static_cast<uint16_t>(1 + lLevel * kNumSlots + lSlot);
+}
+
+/**
+ *  Links a timer into the expired or deferred list.
+ */
+void TimerWheel::Push(Timer*& aList, Timer& aTimer)
+{
+    aTimer.mWheelNext = aList;
+    if (aList != NULL)
+        aList->mWheelPrevNext = &aTimer.mWheelNext;
+    aTimer.mWheelPrevNext = &aList;
+    aList = &aTimer;
+
+    aTimer.mWheelSlot = kSlot_Expired;
+}
+
+/**
+ *  Unlinks a timer from its slot or from the expired or deferred list.
+ */
+void TimerWheel::Unlink(Timer& aTimer)
+{
+    *aTimer.mWheelPrevNext = aTimer.mWheelNext;
+    if (aTimer.mWheelNext != NULL)
+        aTimer.mWheelNext->mWheelPrevNext = aTimer.mWheelPrevNext;
+
+    if (aTimer.mWheelSlot != kSlot_Expired)
+    {
+        const unsigned int kLevel = (aTimer.mWheelSlot - 1) / kNumSlots;
+        const unsigned int kSlot = (aTimer.mWheelSlot - 1) & kSlotMask;
+
+        if (this->mSlots[kLevel][kSlot] == NULL)
+            this->mOccupied[kLevel] &= ~(static_cast<uint64_t>(1) << kSlot);
+    }
+
+    aTimer.mWheelNext = NULL;
+    aTimer.mWheelPrevNext = NULL;
+    aTimer.mWheelSlot = kSlot_None;
+}
+
+/**
+ *  Moves the timers of a slot that the wheel has reached to the lower levels.
+ */
+void TimerWheel::Cascade(unsigned int aLevel, unsigned int aSlot)
+{
+    Timer* lTimer = this->mSlots[aLevel][aSlot];
+
+    this->mSlots[aLevel][aSlot] = NULL;
+    this->mOccupied[aLevel] &= ~(static_cast<uint64_t>(1) << aSlot);
+
+    while (lTimer != NULL)
+    {
+        Timer* const lNext = lTimer->mWheelNext;
+
+        this->Place(*lTimer);
+        lTimer = lNext;
+    }
+}
+
 } // namespace System
 } // namespace Weave
 } // namespace nl
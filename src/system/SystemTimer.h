@@ -67,6 +67,7 @@ class Layer;
 class NL_DLL_EXPORT Timer : public Object
 {
     friend class Layer;
+    friend class TimerWheel;
 
 public:
     /**
@@ -99,6 +100,12 @@ private:
 
     Epoch mAwakenEpoch;
 
+    Timer* mWheelNext;
+    Timer** mWheelPrevNext;
+    Timer* mIndexNext;
+    Timer** mIndexPrevNext;
+    uint16_t mWheelSlot;
+
 #if WEAVE_SYSTEM_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
     Inet::InetLayer* mInetLayer;
     void* mOnCompleteInetLayer;
@@ -110,8 +117,6 @@ private:
     Error ScheduleWork(OnCompleteFunct aOnComplete, void* aAppState);
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
-    Timer *mNextTimer;
-
     static Error HandleExpiredTimers(Layer& aLayer);
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
@@ -120,6 +125,82 @@ private:
     Timer& operator =(const Timer&);
 };
 
+#if WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS < 1 || WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS > 6
+#error "WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS must be between 1 and 6, inclusive."
+#endif // WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS < 1 || WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS > 6
+
+/**
+ * @class TimerWheel
+ *
+ * @brief
+ *  This is an internal class to Weave System Layer, used to hold the armed timers of a Layer object in a hierarchical timing
+ *  wheel.
+ *
+ *  Level zero of the wheel has one slot per millisecond; each further level has slots that span all of the slots of the level
+ *  below. A timer is placed on the lowest level whose span covers its remaining delay and is moved down a level each time the
+ *  wheel reaches the start of its slot, so that starting, cancelling and expiring a timer take constant time. Armed timers are
+ *  also indexed by callback function and application state, so that Layer::CancelTimer does not need to search the timer pool.
+ *
+ *  The wheel must only be used from the thread that owns its Layer object.
+ */
+class NL_DLL_EXPORT TimerWheel
+{
+public:
+    void Init(Timer::Epoch aCurrentEpoch);
+
+    void Insert(Timer& aTimer, Timer::Epoch aCurrentEpoch);
+    void Remove(Timer& aTimer);
+    Timer* Find(Timer::OnCompleteFunct aOnComplete, void* aAppState) const;
+
+    bool IsEmpty(void) const;
+    static bool Contains(const Timer& aTimer);
+    bool GetNextEpoch(Timer::Epoch& aEpoch) const;
+    Timer* PopExpired(Timer::Epoch aCurrentEpoch);
+
+private:
+    enum
+    {
+        kSlotBits   = WEAVE_SYSTEM_CONFIG_TIMER_WHEEL_BITS,
+        kNumSlots   = 1 << kSlotBits,
+        kSlotMask   = kNumSlots - 1,
+        kNumLevels  = (32 + kSlotBits) / kSlotBits,     /**< Enough levels to span any 32-bit millisecond delay. */
+        kNumHashes  = WEAVE_SYSTEM_CONFIG_TIMER_HASH_SIZE,
+
+        kSlot_None      = 0,                            /**< Timer::mWheelSlot of a timer that is not in the wheel. */
+        kSlot_Expired   = kNumLevels * kNumSlots + 1    /**< Timer::mWheelSlot of a timer on the expired or deferred list. */
+    };
+
+    Timer* mSlots[kNumLevels][kNumSlots];
+    uint64_t mOccupied[kNumLevels];
+    Timer* mExpired;
+    Timer* mDeferred;                                   /**< Overdue timers inserted while PopExpired is being called. */
+    Timer* mIndex[kNumHashes];
+    Timer::Epoch mWheelEpoch;
+    size_t mCount;
+    bool mPopping;
+
+    static size_t Hash(Timer::OnCompleteFunct aOnComplete, void* aAppState);
+    static unsigned int NextOccupied(uint64_t aOccupied, unsigned int aSlot);
+
+    bool GetNextSlotEpoch(Timer::Epoch& aEpoch) const;
+    void Place(Timer& aTimer);
+    void Push(Timer*& aList, Timer& aTimer);
+    void Unlink(Timer& aTimer);
+    void Cascade(unsigned int aLevel, unsigned int aSlot);
+};
+
+inline bool TimerWheel::IsEmpty(void) const
+{
+    return this->mCount == 0;
+}
+
+/**
+ *  Returns \c true if the timer is in a timer wheel.
+ */
+inline bool TimerWheel::Contains(const Timer& aTimer)
+{
+    return aTimer.mWheelSlot != kSlot_None;
+}
 
 inline void Timer::GetStatistics(nl::Weave::System::Stats::count_t& aNumInUse,
                                  nl::Weave::System::Stats::count_t& aHighWatermark)
@@ -0,0 +1,547 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *     This file implements a unit test suite for the messages of windowed
+ *     Bulk Data Transfer (BDX) transfers, and for how the protocol handles
+ *     the blocks and acknowledgements of such transfers.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveTLV.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BulkDataTransfer.h>
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXProtocol.h>
+
+using namespace nl::Weave;
+using namespace nl::Weave::Profiles;
+using namespace nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development);
+using namespace nl::Weave::System;
+
+#define BDX_TEST_VERSION            1
+#define BDX_TEST_MAX_BLOCK_SIZE     256
+#define BDX_TEST_WINDOW_SIZE        4
+#define BDX_TEST_BLOCK_LEN          8
+#define BDX_TEST_MAX_BLOCKS         16
+
+static char sFileDesignator[] = "test-file";
+
+// Encode a single TLV element, standing in for application metadata.
+static uint16_t EncodeTestMetaData(uint8_t *aBuf, uint16_t aBufSize, uint64_t aTag)
+{
+    TLV::TLVWriter writer;
+
+    writer.Init(aBuf, aBufSize);
+    writer.Put(aTag, static_cast<uint8_t>(7));
+    writer.Finalize();
+
+    return static_cast<uint16_t>(writer.GetLengthWritten());
+}
+
+// Test that the proposed window size survives packing and parsing of the init and accept messages.
+static void TestWindowSizeRoundTrip(nlTestSuite *inSuite, void *inContext)
+{
+    ReferencedString fileDesignator;
+    SendInit sendInit;
+    SendInit parsedSendInit;
+    SendAccept sendAccept;
+    SendAccept parsedSendAccept;
+    ReceiveAccept receiveAccept;
+    ReceiveAccept parsedReceiveAccept;
+    PacketBuffer *buf;
+    WEAVE_ERROR err;
+
+    fileDesignator.init(static_cast<uint16_t>(strlen(sFileDesignator)), sFileDesignator);
+
+    sendInit.init(BDX_TEST_VERSION, true, false, false, BDX_TEST_MAX_BLOCK_SIZE, static_cast<uint64_t>(0),
+                  static_cast<uint64_t>(0), fileDesignator, NULL);
+    sendInit.mWindowSize = BDX_TEST_WINDOW_SIZE;
+
+    // Leave no room after the message, as framed TCP receive does.
+    buf = PacketBuffer::NewWithAvailableSize(0, sendInit.packedLength());
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = sendInit.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == sendInit.packedLength());
+    err = SendInit::parse(buf, parsedSendInit);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mWindowSize == BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mMetaData.theLength == 0);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mMaxBlockSize == BDX_TEST_MAX_BLOCK_SIZE);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mFileDesignator == fileDesignator);
+    PacketBuffer::Free(buf);
+
+    sendAccept.init(BDX_TEST_VERSION, kMode_SenderDrive, BDX_TEST_MAX_BLOCK_SIZE, NULL);
+    sendAccept.mWindowSize = BDX_TEST_WINDOW_SIZE;
+
+    buf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = sendAccept.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == sendAccept.packedLength());
+    err = SendAccept::parse(buf, parsedSendAccept);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept.mWindowSize == BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept.mMetaData.theLength == 0);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept.mTransferMode == kMode_SenderDrive);
+    PacketBuffer::Free(buf);
+
+    receiveAccept.init(BDX_TEST_VERSION, kMode_SenderDrive, BDX_TEST_MAX_BLOCK_SIZE, static_cast<uint64_t>(0), NULL);
+    receiveAccept.mWindowSize = BDX_TEST_WINDOW_SIZE;
+
+    buf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = receiveAccept.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == receiveAccept.packedLength());
+    err = ReceiveAccept::parse(buf, parsedReceiveAccept);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedReceiveAccept.mWindowSize == BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, parsedReceiveAccept.mMetaData.theLength == 0);
+    PacketBuffer::Free(buf);
+}
+
+// Test that the window size extension is split off from metadata that precedes it.
+static void TestWindowSizeAfterMetaData(nlTestSuite *inSuite, void *inContext)
+{
+    uint8_t metaDataBuf[16];
+    ReferencedTLVData metaData;
+    SendAccept sendAccept;
+    SendAccept parsedSendAccept;
+    PacketBuffer *buf;
+    uint16_t metaDataLen;
+    WEAVE_ERROR err;
+
+    metaDataLen = EncodeTestMetaData(metaDataBuf, sizeof(metaDataBuf), TLV::ProfileTag(kWeaveProfile_Common, 1));
+    NL_TEST_ASSERT(inSuite, metaDataLen > 0);
+    metaData.init(metaDataLen, sizeof(metaDataBuf), metaDataBuf);
+
+    sendAccept.init(BDX_TEST_VERSION, kMode_SenderDrive, BDX_TEST_MAX_BLOCK_SIZE, &metaData);
+    sendAccept.mWindowSize = BDX_TEST_WINDOW_SIZE;
+
+    buf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = sendAccept.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == sendAccept.packedLength());
+
+    err = SendAccept::parse(buf, parsedSendAccept);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept.mWindowSize == BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept.mMetaData.theLength == metaDataLen);
+    NL_TEST_ASSERT(inSuite, memcmp(parsedSendAccept.mMetaData.theData, metaDataBuf, metaDataLen) == 0);
+    NL_TEST_ASSERT(inSuite, parsedSendAccept == sendAccept);
+
+    PacketBuffer::Free(buf);
+}
+
+// Test that the selective acknowledgement survives packing and parsing, and that a truncated one is rejected.
+static void TestBlockSelectiveAckRoundTrip(nlTestSuite *inSuite, void *inContext)
+{
+    BlockSelectiveAckV1 ack;
+    BlockSelectiveAckV1 parsedAck;
+    PacketBuffer *buf;
+    WEAVE_ERROR err;
+
+    ack.init(0x01020304, 0x80000005);
+
+    buf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = ack.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == ack.packedLength());
+    NL_TEST_ASSERT(inSuite, buf->DataLength() == BlockSelectiveAckV1::kPayloadLen);
+
+    err = BlockSelectiveAckV1::parse(buf, parsedAck);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedAck == ack);
+
+    buf->SetDataLength(BlockSelectiveAckV1::kPayloadLen - 1);
+    err = BlockSelectiveAckV1::parse(buf, parsedAck);
+    NL_TEST_ASSERT(inSuite, err != WEAVE_NO_ERROR);
+
+    PacketBuffer::Free(buf);
+}
+
+// Test that transfers with peers that do not propose a window fall back to stop-and-wait.
+static void TestLegacyPeerFallback(nlTestSuite *inSuite, void *inContext)
+{
+    uint8_t metaDataBuf[16];
+    ReferencedString fileDesignator;
+    ReferencedTLVData metaData;
+    SendInit sendInit;
+    SendInit parsedSendInit;
+    BDXTransfer xfer;
+    PacketBuffer *buf;
+    uint16_t metaDataLen;
+    uint16_t legacyLen;
+    WEAVE_ERROR err;
+
+    // A stop-and-wait proposal is packed exactly as a legacy node would pack it.
+    fileDesignator.init(static_cast<uint16_t>(strlen(sFileDesignator)), sFileDesignator);
+    sendInit.init(BDX_TEST_VERSION, true, false, false, BDX_TEST_MAX_BLOCK_SIZE, static_cast<uint64_t>(0),
+                  static_cast<uint64_t>(0), fileDesignator, NULL);
+    legacyLen = sendInit.packedLength();
+    sendInit.mWindowSize = BDX_TEST_WINDOW_SIZE;
+    NL_TEST_ASSERT(inSuite, sendInit.packedLength() > legacyLen);
+    sendInit.mWindowSize = 1;
+    NL_TEST_ASSERT(inSuite, sendInit.packedLength() == legacyLen);
+
+    // Metadata of a legacy peer is left alone, and reads as no window proposed.
+    metaDataLen = EncodeTestMetaData(metaDataBuf, sizeof(metaDataBuf), TLV::ProfileTag(kWeaveProfile_Common, 1));
+    metaData.init(metaDataLen, sizeof(metaDataBuf), metaDataBuf);
+    sendInit.mMetaData = metaData;
+
+    buf = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    err = sendInit.pack(buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = SendInit::parse(buf, parsedSendInit);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mWindowSize == 1);
+    NL_TEST_ASSERT(inSuite, parsedSendInit.mMetaData.theLength == metaDataLen);
+    NL_TEST_ASSERT(inSuite, memcmp(parsedSendInit.mMetaData.theData, metaDataBuf, metaDataLen) == 0);
+    PacketBuffer::Free(buf);
+
+    // A peer that did not propose a window gets a stop-and-wait transfer, whatever the local window size.
+    xfer.Reset();
+    xfer.mVersion = BDX_TEST_VERSION;
+    xfer.mTransferMode = kMode_SenderDrive;
+    xfer.mWindowSize = BDX_TEST_WINDOW_SIZE;
+    xfer.NegotiateWindowSize(parsedSendInit.mWindowSize);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowSize == 1);
+    NL_TEST_ASSERT(inSuite, !xfer.IsWindowed());
+
+    // Neither V0 nor receiver drive transfers are windowed.
+    xfer.Reset();
+    xfer.mVersion = 0;
+    xfer.mTransferMode = kMode_SenderDrive;
+    xfer.NegotiateWindowSize(BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, !xfer.IsWindowed());
+
+    xfer.Reset();
+    xfer.mVersion = BDX_TEST_VERSION;
+    xfer.mTransferMode = kMode_ReceiverDrive;
+    xfer.NegotiateWindowSize(BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, !xfer.IsWindowed());
+
+    // A peer proposing a larger window is held to the local maximum.
+    xfer.Reset();
+    xfer.mVersion = BDX_TEST_VERSION;
+    xfer.mTransferMode = kMode_SenderDrive;
+    xfer.NegotiateWindowSize(UINT8_MAX);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowSize == WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE);
+}
+
+#if WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE >= BDX_TEST_WINDOW_SIZE
+
+// The blocks handed to the PutBlockHandler of a windowed receive, in order.
+struct ReceivedBlocks
+{
+    uint8_t mNumBlocks;
+    uint8_t mBlocks[BDX_TEST_MAX_BLOCKS];
+    bool mLastBlock;
+    bool mDataIntact;
+};
+
+// Record a block, whose data is its block counter repeated.
+static void RecordPutBlock(BDXTransfer *aXfer, uint64_t aLength, uint8_t *aDataBlock, bool aLastBlock)
+{
+    ReceivedBlocks *received = static_cast<ReceivedBlocks *>(aXfer->mAppState);
+
+    if (aLength != BDX_TEST_BLOCK_LEN)
+    {
+        received->mDataIntact = false;
+        return;
+    }
+
+    for (uint8_t i = 1; i < BDX_TEST_BLOCK_LEN; i++)
+    {
+        if (aDataBlock[i] != aDataBlock[0])
+            received->mDataIntact = false;
+    }
+
+    if (received->mNumBlocks < BDX_TEST_MAX_BLOCKS)
+        received->mBlocks[received->mNumBlocks++] = aDataBlock[0];
+
+    received->mLastBlock = aLastBlock;
+}
+
+static void InitWindowedTransfer(BDXTransfer &aXfer, bool aAmSender, ReceivedBlocks *aReceived)
+{
+    aXfer.Reset();
+    aXfer.mIsInitiated = true;
+    aXfer.mIsAccepted = true;
+    aXfer.mVersion = BDX_TEST_VERSION;
+    aXfer.mTransferMode = kMode_SenderDrive;
+    aXfer.mAmSender = aAmSender;
+    aXfer.mWindowSize = BDX_TEST_WINDOW_SIZE;
+
+    if (aReceived != NULL)
+    {
+        memset(aReceived, 0, sizeof(*aReceived));
+        aReceived->mDataIntact = true;
+        aXfer.mAppState = aReceived;
+        aXfer.mHandlers.mPutBlockHandler = RecordPutBlock;
+    }
+}
+
+// Hand a BlockSendV1 or BlockEOFV1 to the receiving side, as HandleResponse would.
+static void ReceiveTestBlock(nlTestSuite *inSuite, BDXTransfer &aXfer, uint32_t aCounter, bool aIsEOF)
+{
+    PacketBuffer *buf = PacketBuffer::New();
+    MessageIterator i(buf);
+    uint8_t data[BDX_TEST_BLOCK_LEN];
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    if (buf == NULL)
+        return;
+
+    memset(data, static_cast<uint8_t>(aCounter), sizeof(data));
+
+    i.append();
+    i.write32(aCounter);
+    i.writeBytes(sizeof(data), data);
+
+    aXfer.mNext = NULL;
+    err = BdxProtocol::HandleResponseReceive(aXfer, kWeaveProfile_BDX, aIsEOF ? kMsgType_BlockEOFV1 : kMsgType_BlockSendV1, buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    PacketBuffer::Free(buf);
+}
+
+static void CheckReceivedBlocks(nlTestSuite *inSuite, const ReceivedBlocks &aReceived, uint8_t aNumBlocks)
+{
+    NL_TEST_ASSERT(inSuite, aReceived.mNumBlocks == aNumBlocks);
+    NL_TEST_ASSERT(inSuite, aReceived.mDataIntact);
+
+    for (uint8_t i = 0; i < aReceived.mNumBlocks; i++)
+    {
+        NL_TEST_ASSERT(inSuite, aReceived.mBlocks[i] == i);
+    }
+}
+
+// Test that blocks arriving in reverse order are held, then handed over in order.
+static void TestReceiveReorderedBlocks(nlTestSuite *inSuite, void *inContext)
+{
+    BDXTransfer xfer;
+    ReceivedBlocks received;
+
+    InitWindowedTransfer(xfer, false, &received);
+
+    ReceiveTestBlock(inSuite, xfer, 2, false);
+    CheckReceivedBlocks(inSuite, received, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x2);
+    NL_TEST_ASSERT(inSuite, xfer.mNext != NULL);
+
+    ReceiveTestBlock(inSuite, xfer, 1, false);
+    CheckReceivedBlocks(inSuite, received, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x3);
+
+    ReceiveTestBlock(inSuite, xfer, 0, false);
+    CheckReceivedBlocks(inSuite, received, 3);
+    NL_TEST_ASSERT(inSuite, xfer.mBlockCounter == 3);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0);
+    NL_TEST_ASSERT(inSuite, !received.mLastBlock);
+
+    ReceiveTestBlock(inSuite, xfer, 3, true);
+    CheckReceivedBlocks(inSuite, received, 4);
+    NL_TEST_ASSERT(inSuite, received.mLastBlock);
+    NL_TEST_ASSERT(inSuite, xfer.mNext != NULL);
+
+    xfer.ReleaseWindowBlocks();
+}
+
+// Test that a lost block holds back the ones after it until it is retransmitted, and that duplicates
+// and blocks beyond the window are not handed over.
+static void TestReceiveLostBlock(nlTestSuite *inSuite, void *inContext)
+{
+    BDXTransfer xfer;
+    ReceivedBlocks received;
+
+    InitWindowedTransfer(xfer, false, &received);
+
+    ReceiveTestBlock(inSuite, xfer, 0, false);
+    CheckReceivedBlocks(inSuite, received, 1);
+    NL_TEST_ASSERT(inSuite, xfer.mBlockCounter == 1);
+
+    // Block 1 is lost.
+    ReceiveTestBlock(inSuite, xfer, 2, false);
+    ReceiveTestBlock(inSuite, xfer, 3, false);
+    CheckReceivedBlocks(inSuite, received, 1);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x3);
+
+    // A block beyond the window is not held.
+    ReceiveTestBlock(inSuite, xfer, 1 + BDX_TEST_WINDOW_SIZE, false);
+    CheckReceivedBlocks(inSuite, received, 1);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x3);
+
+    // The retransmission releases the blocks held after it.
+    ReceiveTestBlock(inSuite, xfer, 1, false);
+    CheckReceivedBlocks(inSuite, received, 4);
+    NL_TEST_ASSERT(inSuite, xfer.mBlockCounter == 4);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0);
+
+    // A duplicate is acknowledged again but not handed over.
+    ReceiveTestBlock(inSuite, xfer, 2, false);
+    CheckReceivedBlocks(inSuite, received, 4);
+    NL_TEST_ASSERT(inSuite, xfer.mNext != NULL);
+
+    ReceiveTestBlock(inSuite, xfer, 4, true);
+    CheckReceivedBlocks(inSuite, received, 5);
+    NL_TEST_ASSERT(inSuite, received.mLastBlock);
+
+    xfer.ReleaseWindowBlocks();
+}
+
+// Test that an early BlockEOFV1 is held like any other block, and that nothing after it is accepted.
+static void TestReceiveEarlyEOF(nlTestSuite *inSuite, void *inContext)
+{
+    BDXTransfer xfer;
+    ReceivedBlocks received;
+
+    InitWindowedTransfer(xfer, false, &received);
+
+    ReceiveTestBlock(inSuite, xfer, 2, true);
+    CheckReceivedBlocks(inSuite, received, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowEOF && xfer.mWindowEOFCounter == 2);
+
+    ReceiveTestBlock(inSuite, xfer, 3, false);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x2);
+
+    ReceiveTestBlock(inSuite, xfer, 1, false);
+    ReceiveTestBlock(inSuite, xfer, 0, false);
+    CheckReceivedBlocks(inSuite, received, 3);
+    NL_TEST_ASSERT(inSuite, received.mLastBlock);
+
+    xfer.ReleaseWindowBlocks();
+}
+
+// Hand a BlockSelectiveAckV1 to the sending side, as HandleResponse would.
+static void ReceiveTestAck(nlTestSuite *inSuite, BDXTransfer &aXfer, uint32_t aCounter, uint32_t aReceivedMask)
+{
+    BlockSelectiveAckV1 ack;
+    PacketBuffer *buf = PacketBuffer::New();
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    if (buf == NULL)
+        return;
+
+    ack.init(aCounter, aReceivedMask);
+    ack.pack(buf);
+
+    aXfer.mNext = NULL;
+    err = BdxProtocol::HandleResponseTransmit(aXfer, kWeaveProfile_BDX, kMsgType_BlockSelectiveAckV1, buf);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    PacketBuffer::Free(buf);
+}
+
+// Test that selective acknowledgements slide the sender's window and record the blocks received out of order.
+static void TestSendSelectiveAck(nlTestSuite *inSuite, void *inContext)
+{
+    BDXTransfer xfer;
+    uint32_t counter;
+
+    InitWindowedTransfer(xfer, true, NULL);
+
+    // A full window of blocks is in flight.
+    for (counter = 0; counter < BDX_TEST_WINDOW_SIZE; counter++)
+    {
+        xfer.mWindowBlocks[counter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] = PacketBuffer::New();
+        NL_TEST_ASSERT(inSuite, xfer.mWindowBlocks[counter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] != NULL);
+    }
+    xfer.mBlockCounter = BDX_TEST_WINDOW_SIZE;
+
+    // Block 0 arrived, block 1 was lost and block 2 arrived; the mask only covers blocks that were sent.
+    ReceiveTestAck(inSuite, xfer, 1, 0xFFFFFFF1);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBase == 1);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBlocks[0] == NULL);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBlocks[1] != NULL);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x1);
+    NL_TEST_ASSERT(inSuite, xfer.mNext == BdxProtocol::SendWindowV1);
+
+    // An acknowledgement overtaken by a later one is ignored.
+    ReceiveTestAck(inSuite, xfer, 0, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBase == 1);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0x1);
+    NL_TEST_ASSERT(inSuite, xfer.mNext == NULL);
+
+    // An acknowledgement of blocks never sent is refused.
+    ReceiveTestAck(inSuite, xfer, BDX_TEST_WINDOW_SIZE + 1, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBase == 1);
+    NL_TEST_ASSERT(inSuite, xfer.mNext != NULL && xfer.mNext != BdxProtocol::SendWindowV1);
+
+    // Once the retransmission arrives, every block is acknowledged.
+    ReceiveTestAck(inSuite, xfer, BDX_TEST_WINDOW_SIZE, 0);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowBase == BDX_TEST_WINDOW_SIZE);
+    NL_TEST_ASSERT(inSuite, xfer.mWindowReceivedMask == 0);
+
+    for (counter = 0; counter < BDX_TEST_WINDOW_SIZE; counter++)
+    {
+        NL_TEST_ASSERT(inSuite, xfer.mWindowBlocks[counter % WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE] == NULL);
+    }
+
+    xfer.ReleaseWindowBlocks();
+}
+
+#endif // WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE >= BDX_TEST_WINDOW_SIZE
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("BDXMessages::TestWindowSizeRoundTrip", TestWindowSizeRoundTrip),
+    NL_TEST_DEF("BDXMessages::TestWindowSizeAfterMetaData", TestWindowSizeAfterMetaData),
+    NL_TEST_DEF("BDXMessages::TestBlockSelectiveAckRoundTrip", TestBlockSelectiveAckRoundTrip),
+    NL_TEST_DEF("BDXMessages::TestLegacyPeerFallback", TestLegacyPeerFallback),
+#if WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE >= BDX_TEST_WINDOW_SIZE
+    NL_TEST_DEF("BDXProtocol::TestReceiveReorderedBlocks", TestReceiveReorderedBlocks),
+    NL_TEST_DEF("BDXProtocol::TestReceiveLostBlock", TestReceiveLostBlock),
+    NL_TEST_DEF("BDXProtocol::TestReceiveEarlyEOF", TestReceiveEarlyEOF),
+    NL_TEST_DEF("BDXProtocol::TestSendSelectiveAck", TestSendSelectiveAck),
+#endif // WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE >= BDX_TEST_WINDOW_SIZE
+    NL_TEST_SENTINEL()
+};
+
+int main(void)
+{
+    nlTestSuite theSuite = {
+        "weave-bdx-messages",
+        &sTests[0],
+        NULL,
+        NULL
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -16,11 +16,182 @@
  *    limitations under the License.
  */
 
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 #include <WeaveCryptoTests.h>
 //#include "WeaveCryptoTests.h"
 
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Support/crypto/CTRMode.h>
+#include <Weave/Support/crypto/HMAC.h>
+#include <SystemLayer/SystemLayer.h>
+
+using namespace nl::Weave;
+using namespace nl::Weave::Crypto;
+
+namespace nl {
+namespace Weave {
+
+// Gives the benchmark access to the message layer's private encryption helpers.
+class NL_DLL_EXPORT WeaveMessageLayerTestObject
+{
+public:
+    static void EncryptAndComputeIntegrityCheck(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                const uint8_t *integrityKey, uint8_t *payload, uint16_t payloadLen)
+    {
+        WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, integrityKey, payload, payloadLen, payload + payloadLen);
+        WeaveMessageLayer::Encrypt_AES128CTRSHA1(msgInfo, dataKey, payload, payloadLen + HMACSHA1::kDigestLength, payload);
+    }
+
+    static void EncryptAndComputeIntegrityCheck(const WeaveMessageInfo *msgInfo, const uint8_t *dataKey,
+                                                const uint8_t *integrityKey, System::PacketBuffer *msgBuf, uint8_t *payload)
+    {
+        System::PacketBuffer *lastBuf = msgBuf;
+        uint32_t payloadLen = msgBuf->TotalLength() - (payload - msgBuf->Start());
+
+        while (lastBuf->Next() != NULL)
+            lastBuf = lastBuf->Next();
+
+        WeaveMessageLayer::ComputeIntegrityCheck_AES128CTRSHA1(msgInfo, integrityKey, msgBuf, payload, payloadLen,
+                                                               lastBuf->Start() + lastBuf->DataLength());
+        WeaveMessageLayer::Encrypt_AES128CTRSHA1(msgInfo, dataKey, msgBuf, payload, payloadLen + HMACSHA1::kDigestLength);
+    }
+};
+
+} // namespace Weave
+} // namespace nl
+
+#define BENCH_PAYLOAD_LEN       1200
+#define BENCH_ITERATIONS        20000
+
+static void ReportThroughput(const char *name, uint64_t startMicroseconds, uint64_t endMicroseconds)
+{
+    const uint64_t elapsed = endMicroseconds - startMicroseconds;
+    const double megabytes = (double)BENCH_PAYLOAD_LEN * BENCH_ITERATIONS / (1024 * 1024);
+
+    printf("%-32s %10" PRIu64 " us %10.1f MB/s\n", name, elapsed, (elapsed > 0) ? megabytes * 1000000 / elapsed : 0.0);
+}
+
+/*
+ * Throughput benchmark for Weave message encryption: AES-128-CTR one block at a time versus
+ * multiple blocks per block cipher call, and HMAC-SHA1 followed by multi-block CTR over the
+ * payload, as done by the message layer.
+ */
+static int WeaveCryptoMessageEncryptionBenchmark(void)
+{
+    static uint8_t payload[BENCH_PAYLOAD_LEN + HMACSHA1::kDigestLength];
+    static const uint8_t dataKey[WeaveEncryptionKey_AES128CTRSHA1::DataKeySize] = { 0x01, 0x02, 0x03, 0x04 };
+    static const uint8_t integrityKey[WeaveEncryptionKey_AES128CTRSHA1::IntegrityKeySize] = { 0x05, 0x06, 0x07, 0x08 };
+    WeaveMessageInfo msgInfo;
+    uint64_t start;
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = 0x18B4300000000001ULL;
+    msgInfo.DestNodeId = 0x18B4300000000002ULL;
+    msgInfo.MessageId = 1;
+    msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+
+    for (size_t i = 0; i < sizeof(payload); i++)
+        payload[i] = (uint8_t)i;
+
+    printf("%u byte payloads, %u iterations\n", BENCH_PAYLOAD_LEN, BENCH_ITERATIONS);
+
+    start = System::Layer::GetClock_MonotonicHiRes();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        AES128CTRMode aes128CTR;
+        aes128CTR.SetKey(dataKey);
+        aes128CTR.SetWeaveMessageCounter(msgInfo.SourceNodeId, msgInfo.MessageId);
+        for (uint16_t offset = 0; offset < BENCH_PAYLOAD_LEN; offset += AES128CTRMode::kCounterLength)
+            aes128CTR.EncryptData(payload + offset, AES128CTRMode::kCounterLength, payload + offset);
+    }
+    ReportThroughput("ctr: block at a time", start, System::Layer::GetClock_MonotonicHiRes());
+
+    start = System::Layer::GetClock_MonotonicHiRes();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        AES128CTRMode aes128CTR;
+        aes128CTR.SetKey(dataKey);
+        aes128CTR.SetWeaveMessageCounter(msgInfo.SourceNodeId, msgInfo.MessageId);
+        aes128CTR.EncryptData(payload, BENCH_PAYLOAD_LEN, payload);
+    }
+    ReportThroughput("ctr: multi-block", start, System::Layer::GetClock_MonotonicHiRes());
+
+    start = System::Layer::GetClock_MonotonicHiRes();
+    for (int n = 0; n < BENCH_ITERATIONS; n++)
+    {
+        AES128CTRMode aes128CTR;
+        HMACSHA1 hmacSHA1;
+
+        hmacSHA1.Begin(integrityKey, sizeof(integrityKey));
+        hmacSHA1.AddData(payload, BENCH_PAYLOAD_LEN);
+        hmacSHA1.Finish(payload + BENCH_PAYLOAD_LEN);
+
+        aes128CTR.SetKey(dataKey);
+        aes128CTR.SetWeaveMessageCounter(msgInfo.SourceNodeId, msgInfo.MessageId);
+        aes128CTR.EncryptData(payload, sizeof(payload), payload);
+    }
+    ReportThroughput("ctr+hmac", start, System::Layer::GetClock_MonotonicHiRes());
+
+    // Check that a payload split across a buffer chain encrypts exactly as the same payload in one buffer.
+    {
+        static const uint16_t kSegmentLens[] = { 100, 333, BENCH_PAYLOAD_LEN - 433 };
+        System::PacketBuffer *chain = NULL;
+        uint16_t offset = 0;
+        int result = 0;
+
+        for (size_t i = 0; i < sizeof(payload); i++)
+            payload[i] = (uint8_t)i;
+
+        for (size_t i = 0; i < sizeof(kSegmentLens) / sizeof(kSegmentLens[0]); i++)
+        {
+            System::PacketBuffer *buf = System::PacketBuffer::New(0);
+            if (buf == NULL)
+            {
+                printf("chained encryption: out of buffers\n");
+                System::PacketBuffer::Free(chain);
+                return 1;
+            }
+            memcpy(buf->Start(), payload + offset, kSegmentLens[i]);
+            buf->SetDataLength(kSegmentLens[i]);
+            offset += kSegmentLens[i];
+
+            if (chain == NULL)
+                chain = buf;
+            else
+                chain->AddToEnd(buf);
+        }
+
+        WeaveMessageLayerTestObject::EncryptAndComputeIntegrityCheck(&msgInfo, dataKey, integrityKey, payload, BENCH_PAYLOAD_LEN);
+        WeaveMessageLayerTestObject::EncryptAndComputeIntegrityCheck(&msgInfo, dataKey, integrityKey, chain, chain->Start());
+
+        offset = 0;
+        for (System::PacketBuffer *buf = chain; buf != NULL; buf = buf->Next())
+        {
+            uint16_t len = buf->DataLength() + ((buf->Next() == NULL) ? HMACSHA1::kDigestLength : 0);
+
+            if (memcmp(buf->Start(), payload + offset, len) != 0)
+            {
+                printf("chained encryption mismatch in segment at offset %u\n", (unsigned)offset);
+                result = 1;
+                break;
+            }
+            offset += buf->DataLength();
+        }
+
+        System::PacketBuffer::Free(chain);
+        if (result != 0)
+            return result;
+    }
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
     int err = 0;
@@ -43,6 +214,10 @@ int main(int argc, char *argv[])
         {
             WeaveCryptoAESTests();
         }
+        else if (!strcmp(argv[1], "bench"))
+        {
+            err = WeaveCryptoMessageEncryptionBenchmark();
+        }
         else
         {
             printf("%s: unknown parameter %s.\n", argv[0], argv[1]);
@@ -31,8 +31,13 @@
 #define __STDC_LIMIT_MACROS
 #endif
 
+#include <dirent.h>
+#include <limits.h>
 #include <new>
+#include <pthread.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -115,15 +120,38 @@ namespace Weave {
 namespace Profiles {
 namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
 namespace Platform {
-// for unit tests, the dummy critical section is sufficient.
+// A real (recursive) lock, since some of the tests log from several threads.
+static pthread_mutex_t sCriticalSection;
+static pthread_once_t sCriticalSectionOnce = PTHREAD_ONCE_INIT;
+// How often the calling thread has entered the critical section.
+static __thread int sCriticalSectionDepth;
+
+static void InitCriticalSection()
+{
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&sCriticalSection, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
 void CriticalSectionEnter()
 {
-    return;
+    pthread_once(&sCriticalSectionOnce, InitCriticalSection);
+    pthread_mutex_lock(&sCriticalSection);
+    sCriticalSectionDepth++;
 }
 
 void CriticalSectionExit()
 {
-    return;
+    sCriticalSectionDepth--;
+    pthread_mutex_unlock(&sCriticalSection);
+}
+
+static bool IsInCriticalSection()
+{
+    return sCriticalSectionDepth > 0;
 }
 } // namespace Platform
 } // namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
@@ -1215,6 +1243,464 @@ static void CheckFetchTimestamps(nlTestSuite * inSuite, void * inContext)
     }
 }
 
+static void CheckFetchFromEventId(nlTestSuite * inSuite, event_id_t inEventID, timestamp_t inStartTime)
+{
+    WEAVE_ERROR err;
+    TLVReader testReader;
+    TLVWriter testWriter;
+    utc_timestamp_t testUtcTimestamp = 0;
+    timestamp_t testTimestamp        = 0;
+    event_id_t testEventID           = 0;
+    event_id_t eventID               = inEventID;
+
+    testWriter.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+    err = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().FetchEventsSince(
+        testWriter, nl::Weave::Profiles::DataManagement::Production, eventID);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+
+    testReader.Init(gLargeMemoryBackingStore, testWriter.GetLengthWritten());
+
+    err = ReadFirstEventHeader(testReader, testTimestamp, testUtcTimestamp, testEventID);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testEventID == inEventID);
+    NL_TEST_ASSERT(inSuite, testTimestamp == inStartTime + (inEventID - 1) * 10);
+}
+
+static void CheckFetchEventsSinceIndexed(nlTestSuite * inSuite, void * inContext)
+{
+    TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
+    nl::Weave::Profiles::DataManagement::LoggingManagement & logMgmt =
+        nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    const int k_num_events = 200;
+    event_id_t eid, first, last;
+    timestamp_t start, now;
+    int round, counter;
+
+    InitializeEventLogging(context);
+    System::Layer::SetClock_RealTime(0);
+
+    start = now = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+
+    // Fetching from every event ID, in both directions and once more
+    // after the oldest events were evicted, must find the same events
+    // whether the scan starts from the oldest event or from an index
+    // checkpoint.  Interleaving less important events spreads the
+    // production events across all the buffers.
+    for (round = 0; round < 2; round++)
+    {
+        for (counter = 0; counter < k_num_events; counter++)
+        {
+            eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, now, "%u", now);
+            NL_TEST_ASSERT(inSuite, eid > 0);
+            FastLogFreeform(nl::Weave::Profiles::DataManagement::Info, now, "%u", now);
+            FastLogFreeform(nl::Weave::Profiles::DataManagement::Debug, now, "%u", now);
+            now += 10;
+        }
+
+        first = logMgmt.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production);
+        last  = logMgmt.GetLastEventID(nl::Weave::Profiles::DataManagement::Production);
+        NL_TEST_ASSERT(inSuite, first > 1);
+
+        for (eid = first; eid <= last; eid++)
+        {
+            CheckFetchFromEventId(inSuite, eid, start);
+        }
+
+        for (eid = last; eid >= first; eid--)
+        {
+            CheckFetchFromEventId(inSuite, eid, start);
+        }
+    }
+
+    DestroyEventLogging(context);
+}
+
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+static void RemoveArchiveDirectory(const char * inDirectory)
+{
+    char path[PATH_MAX];
+    DIR * dir = opendir(inDirectory);
+    struct dirent * entry;
+
+    if (dir != NULL)
+    {
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] != '.')
+            {
+                int len = snprintf(path, sizeof(path), "%s/%s", inDirectory, entry->d_name);
+
+                // Never unlink a truncated path, which would name some other file.
+                if (len > 0 && static_cast<size_t>(len) < sizeof(path))
+                {
+                    unlink(path);
+                }
+            }
+        }
+        closedir(dir);
+    }
+    rmdir(inDirectory);
+}
+
+static void CheckArchiveHoldsEvictedEvents(nlTestSuite * inSuite, event_id_t inLastEventID, timestamp_t inStartTime)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    TLVWriter writer;
+    event_id_t eid       = 1;
+    event_id_t numEvents = 0;
+
+    // Every event since the first one is still available, from the
+    // archive and then from the in-memory log, without gaps.
+    writer.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+    err = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().FetchEventsSince(
+        writer, nl::Weave::Profiles::DataManagement::Production, eid);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, eid == inLastEventID + 1);
+
+    reader.Init(gLargeMemoryBackingStore, writer.GetLengthWritten());
+    while (reader.Next() == WEAVE_NO_ERROR)
+    {
+        numEvents++;
+    }
+    NL_TEST_ASSERT(inSuite, numEvents == inLastEventID);
+
+    for (eid = 1; eid <= inLastEventID; eid++)
+    {
+        CheckFetchFromEventId(inSuite, eid, inStartTime);
+    }
+}
+
+static void CheckEventLogArchive(nlTestSuite * inSuite, void * inContext)
+{
+    TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
+    nl::Weave::Profiles::DataManagement::LoggingManagement & logMgmt =
+        nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    nl::Weave::Profiles::DataManagement::EventLogArchive archive;
+    const int k_num_events = 300;
+    char directory[]       = "/tmp/TestEventLogArchive.XXXXXX";
+    event_id_t eid, last;
+    timestamp_t start, now;
+    size_t numArchived;
+    TLVWriter writer;
+    WEAVE_ERROR err;
+    int counter;
+
+    NL_TEST_ASSERT(inSuite, mkdtemp(directory) != NULL);
+
+    err = archive.Init(directory);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    InitializeEventLogging(context);
+    System::Layer::SetClock_RealTime(0);
+    logMgmt.SetArchive(&archive);
+
+    start = now = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+
+    for (counter = 0; counter < k_num_events; counter++)
+    {
+        eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, now, "%u", now);
+        NL_TEST_ASSERT(inSuite, eid > 0);
+        now += 10;
+    }
+
+    last        = logMgmt.GetLastEventID(nl::Weave::Profiles::DataManagement::Production);
+    numArchived = archive.GetNumEvents(nl::Weave::Profiles::DataManagement::Production);
+    NL_TEST_ASSERT(inSuite, logMgmt.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production) > 1);
+    NL_TEST_ASSERT(inSuite, numArchived == logMgmt.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production) - 1);
+
+    CheckArchiveHoldsEvictedEvents(inSuite, last, start);
+
+    // Simulate a crash in the middle of an append: the partial record
+    // must not survive reopening the archive.
+    err = archive.BeginAppend(nl::Weave::Profiles::DataManagement::Production, 64, writer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = writer.Put(AnonymousTag, static_cast<uint32_t>(0xdeadbeef));
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    logMgmt.SetArchive(NULL);
+    archive.Shutdown();
+
+    err = archive.Init(directory);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, archive.GetNumEvents(nl::Weave::Profiles::DataManagement::Production) == numArchived);
+
+    logMgmt.SetArchive(&archive);
+    CheckArchiveHoldsEvictedEvents(inSuite, last, start);
+
+    logMgmt.SetArchive(NULL);
+    archive.Shutdown();
+    RemoveArchiveDirectory(directory);
+
+    DestroyEventLogging(context);
+}
+
+static size_t CountArchiveFiles(const char * inDirectory)
+{
+    DIR * dir       = opendir(inDirectory);
+    size_t numFiles = 0;
+    struct dirent * entry;
+
+    if (dir != NULL)
+    {
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] != '.')
+            {
+                numFiles++;
+            }
+        }
+        closedir(dir);
+    }
+    return numFiles;
+}
+
+static void CheckArchivedRange(nlTestSuite * inSuite, nl::Weave::Profiles::DataManagement::EventLogArchive & inArchive,
+                               event_id_t inFirstEventID, event_id_t inLastEventID)
+{
+    // Large enough for one record only, so that every fetch returns
+    // the next record.
+    static uint8_t fetchBuffer[WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE / 4 + 64];
+    event_id_t eid      = 1;
+    event_id_t expected = inFirstEventID;
+    event_id_t fetched;
+    const uint8_t * data;
+    TLVWriter writer;
+    TLVReader reader;
+    WEAVE_ERROR err;
+
+    do
+    {
+        fetched = eid;
+        writer.Init(fetchBuffer, sizeof(fetchBuffer));
+        err = inArchive.FetchEventsSince(writer, nl::Weave::Profiles::DataManagement::Production, eid);
+        if (eid == fetched)
+        {
+            break;
+        }
+
+        NL_TEST_ASSERT(inSuite, eid == expected + 1);
+
+        reader.Init(fetchBuffer, writer.GetLengthWritten());
+        NL_TEST_ASSERT(inSuite, reader.Next() == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, reader.GetDataPtr(data) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, nl::Weave::Encoding::LittleEndian::Get32(data) == expected);
+
+        expected = eid;
+    } while (err != WEAVE_END_OF_TLV);
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, expected == inLastEventID + 1);
+}
+
+static void CheckEventLogArchiveCompaction(nlTestSuite * inSuite, void * inContext)
+{
+    // Records are sized so that three of them fill a segment.
+    enum
+    {
+        kMaxRecordLength   = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE / 4,
+        kPayloadLength     = kMaxRecordLength - 16,
+        kRecordsPerSegment = 3,
+        kNumSegments       = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_MAX_SEGMENTS,
+        kNumSpareSegments  = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS,
+        kNumImportances    = nl::Weave::Profiles::DataManagement::kImportanceType_Last -
+            nl::Weave::Profiles::DataManagement::kImportanceType_First + 1,
+    };
+    static uint8_t payload[kPayloadLength];
+    nl::Weave::Profiles::DataManagement::EventLogArchive archive;
+    char directory[]       = "/tmp/TestEventLogArchive.XXXXXX";
+    const event_id_t last  = kRecordsPerSegment * (kNumSegments + 2);
+    const event_id_t first = last - kRecordsPerSegment * kNumSegments + 1;
+    TLVWriter writer;
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, mkdtemp(directory) != NULL);
+
+    err = archive.Init(directory);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Write two segments more than the archive holds; the oldest two
+    // are dropped.
+    for (event_id_t eid = 1; eid <= last; eid++)
+    {
+        nl::Weave::Encoding::LittleEndian::Put32(payload, eid);
+
+        err = archive.BeginAppend(nl::Weave::Profiles::DataManagement::Production, kMaxRecordLength, writer);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = writer.PutBytes(AnonymousTag, payload, sizeof(payload));
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = writer.Finalize();
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = archive.CommitAppend(nl::Weave::Profiles::DataManagement::Production, eid, writer);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        archive.Maintain();
+    }
+
+    // Only the segments in use and the spares of every importance remain.
+    NL_TEST_ASSERT(inSuite, CountArchiveFiles(directory) == kNumSegments + kNumImportances * kNumSpareSegments);
+    NL_TEST_ASSERT(inSuite,
+                   archive.GetNumEvents(nl::Weave::Profiles::DataManagement::Production) == last - first + 1);
+    CheckArchivedRange(inSuite, archive, first, last);
+
+    archive.Shutdown();
+
+    err = archive.Init(directory);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, CountArchiveFiles(directory) == kNumSegments + kNumImportances * kNumSpareSegments);
+    NL_TEST_ASSERT(inSuite,
+                   archive.GetNumEvents(nl::Weave::Profiles::DataManagement::Production) == last - first + 1);
+    CheckArchivedRange(inSuite, archive, first, last);
+
+    archive.Shutdown();
+    RemoveArchiveDirectory(directory);
+}
+
+static void CheckEventLogArchiveSpareSegments(nlTestSuite * inSuite, void * inContext)
+{
+    // Records are sized so that three of them fill a segment.
+    enum
+    {
+        kMaxRecordLength   = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_SEGMENT_SIZE / 4,
+        kPayloadLength     = kMaxRecordLength - 16,
+        kRecordsPerSegment = 3,
+        kNumSpareSegments  = WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE_NUM_SPARE_SEGMENTS,
+    };
+    static uint8_t payload[kPayloadLength];
+    nl::Weave::Profiles::DataManagement::EventLogArchive archive;
+    char directory[]      = "/tmp/TestEventLogArchive.XXXXXX";
+    const event_id_t last = kRecordsPerSegment * kNumSpareSegments;
+    TLVWriter writer;
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, mkdtemp(directory) != NULL);
+
+    err = archive.Init(directory);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Without maintenance in between, appends switch segments until the
+    // spares run out; the next event that needs a segment is dropped.
+    for (event_id_t eid = 1; eid <= last + 1; eid++)
+    {
+        nl::Weave::Encoding::LittleEndian::Put32(payload, eid);
+
+        err = archive.BeginAppend(nl::Weave::Profiles::DataManagement::Production, kMaxRecordLength, writer);
+        if (eid > last)
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_NO_MEMORY);
+            break;
+        }
+
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = writer.PutBytes(AnonymousTag, payload, sizeof(payload));
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = writer.Finalize();
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        err = archive.CommitAppend(nl::Weave::Profiles::DataManagement::Production, eid, writer);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, archive.GetNumEvents(nl::Weave::Profiles::DataManagement::Production) == last);
+
+    // Maintenance replenishes the spares.
+    archive.Maintain();
+
+    err = archive.BeginAppend(nl::Weave::Profiles::DataManagement::Production, kMaxRecordLength, writer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    CheckArchivedRange(inSuite, archive, 1, last);
+
+    archive.Shutdown();
+    RemoveArchiveDirectory(directory);
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+static WEAVE_ERROR WriteCounterEvent(nl::Weave::TLV::TLVWriter & ioWriter, uint8_t inDataTag, void * anAppState)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVType containerType;
+
+    err = ioWriter.StartContainer(ContextTag(inDataTag), nl::Weave::TLV::kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = ioWriter.Put(ContextTag(1), *static_cast<uint32_t *>(anAppState));
+    SuccessOrExit(err);
+
+    err = ioWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+    err = ioWriter.Finalize();
+
+exit:
+    return err;
+}
+
+static void CheckCompactEncoding(nlTestSuite * inSuite, void * inContext)
+{
+    TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
+    const uint32_t k_num_sources = WEAVE_CONFIG_EVENT_LOGGING_NUM_EVENT_SOURCES + 4;
+    const uint32_t k_num_events  = 40;
+    EventSchema schema = { kWeaveProfile_NestDebug, kNestDebug_StringLogEntryEvent, nl::Weave::Profiles::DataManagement::Production,
+                           1, 1 };
+    static uint8_t expected[256];
+    uint32_t expectedLength;
+    event_id_t eid, fetchedEid;
+    timestamp_t now;
+    uint32_t counter;
+
+    InitializeEventLogging(context);
+    System::Layer::SetClock_RealTime(0);
+
+    now = static_cast<timestamp_t>(System::Layer::GetClock_MonotonicMS());
+
+    // Events fetched from the log must be encoded exactly as if they
+    // had been written out with BlitEvent, whether their source was
+    // stored as an index into the event source table or in full.
+    for (counter = 0; counter < k_num_events; counter++)
+    {
+        DetailedRootSection source;
+        EventOptions options;
+        TLVWriter writer;
+        WEAVE_ERROR err;
+
+        source.ResourceID      = ResourceIdentifier(0x18B4300000000000ULL + (counter % 2));
+        source.TraitInstanceID = counter % k_num_sources;
+        options                = EventOptions(now, (counter % 3) ? &source : NULL, counter / 2,
+                                              nl::Weave::Profiles::DataManagement::Production, false);
+        schema.mDataSchemaVersion = 1 + (counter % 4 == 0);
+
+        eid = LogEvent(schema, WriteCounterEvent, &counter, &options);
+        NL_TEST_ASSERT(inSuite, eid > 0);
+
+        {
+            EventLoadOutContext expectedContext(writer, schema.mImportance, eid, NULL);
+
+            writer.Init(expected, sizeof(expected));
+            expectedContext.mCurrentEventID = eid;
+            err = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().BlitEvent(
+                &expectedContext, schema, WriteCounterEvent, &counter, &options);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            expectedLength = writer.GetLengthWritten();
+        }
+
+        fetchedEid = eid;
+        writer.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+        err = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().FetchEventsSince(
+            writer, schema.mImportance, fetchedEid);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+        NL_TEST_ASSERT(inSuite, fetchedEid == eid + 1);
+        NL_TEST_ASSERT(inSuite, writer.GetLengthWritten() == expectedLength);
+        NL_TEST_ASSERT(inSuite, memcmp(gLargeMemoryBackingStore, expected, expectedLength) == 0);
+
+        now += 10 + counter;
+    }
+
+    DestroyEventLogging(context);
+}
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+
 WEAVE_ERROR WriteLargeEvent(nl::Weave::TLV::TLVWriter & writer, uint8_t inDataTag, void * anAppState)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -3030,7 +3516,7 @@ static void CheckExternalEvents(nlTestSuite * inSuite, void * inContext)
     }
 
     // log many events so no longer trying to fetch external events
-    for (i = 0; i < 100; i++)
+    for (i = 0; i < 200; i++)
     {
         eid_in = nl::Weave::Profiles::DataManagement::LogFreeform(nl::Weave::Profiles::DataManagement::Production,
                                                                   "Freeform entry %d", i);
@@ -3512,7 +3998,7 @@ static void CheckExternalEventNotifyEvicted(nlTestSuite * inSuite, void * inCont
     // Force an eviction
     eid_prev = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, now, "Freeform entry %d", counter++);
     now += 10;
-    for (; counter < 103; counter++)
+    for (; counter < 203; counter++)
     {
         // Sample production events, spaced 10 milliseconds apart
         eid = FastLogFreeform(nl::Weave::Profiles::DataManagement::Production, now, "Freeform entry %d", counter);
@@ -3755,6 +4241,217 @@ static void CheckLastObservedEventId(nlTestSuite * inSuite, void * inContext)
     DestroyEventLogging(context);
 }
 
+enum
+{
+    kNumConcurrentProducers     = 4,
+    kNumEventsPerProducer       = 100,
+    kProducerTag                = 1,
+    kSequenceTag                = 2,
+};
+
+struct ConcurrentProducer
+{
+    uint32_t mProducer;
+    uint32_t mSequence;
+    uint32_t mNumUnstaged;
+    event_id_t mEventIds[kNumEventsPerProducer];
+};
+
+static WEAVE_ERROR WriteConcurrentProducerEvent(nl::Weave::TLV::TLVWriter & writer, uint8_t inDataTag, void * anAppState)
+{
+    ConcurrentProducer * producer = static_cast<ConcurrentProducer *>(anAppState);
+    WEAVE_ERROR err               = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVType container;
+
+    // A payload that could not be staged is written under the critical section.
+    if (nl::Weave::Profiles::DataManagement::Platform::IsInCriticalSection())
+    {
+        producer->mNumUnstaged++;
+    }
+
+    err = writer.StartContainer(ContextTag(nl::Weave::Profiles::DataManagement::kTag_EventData), nl::Weave::TLV::kTLVType_Structure,
+                                container);
+    SuccessOrExit(err);
+
+    err = writer.Put(nl::Weave::TLV::ContextTag(kProducerTag), producer->mProducer);
+    SuccessOrExit(err);
+
+    err = writer.Put(nl::Weave::TLV::ContextTag(kSequenceTag), producer->mSequence);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(container);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+
+exit:
+    return err;
+}
+
+static void * LogEventsConcurrently(void * inArg)
+{
+    ConcurrentProducer * producer = static_cast<ConcurrentProducer *>(inArg);
+    EventSchema schema            = { OpenCloseProfileID,
+                           1, // Event type 1
+                           nl::Weave::Profiles::DataManagement::Production, 1, 1 };
+
+    for (producer->mSequence = 0; producer->mSequence < kNumEventsPerProducer; producer->mSequence++)
+    {
+        producer->mEventIds[producer->mSequence] =
+            nl::Weave::Profiles::DataManagement::LogEvent(schema, WriteConcurrentProducerEvent, static_cast<void *>(producer));
+    }
+
+    return NULL;
+}
+
+static void CheckConcurrentProducers(nlTestSuite * inSuite, void * inContext)
+{
+    TestLoggingContext * context = static_cast<TestLoggingContext *>(inContext);
+    nl::Weave::Profiles::DataManagement::LoggingManagement & logger = nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance();
+    pthread_t threads[kNumConcurrentProducers];
+    ConcurrentProducer producers[kNumConcurrentProducers];
+    bool seen[kNumConcurrentProducers * kNumEventsPerProducer];
+    event_id_t firstEventId, fetchEventId, eventId;
+    uint32_t numChecked = 0;
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    uint32_t numStaged;
+#endif
+    TLVWriter writer;
+    TLVReader reader;
+    WEAVE_ERROR err;
+    EventSchema schema = { OpenCloseProfileID,
+                           1, // Event type 1
+                           nl::Weave::Profiles::DataManagement::Production, 1, 1 };
+
+    InitializeEventLogging(context);
+
+    firstEventId = nl::Weave::Profiles::DataManagement::LogEvent(schema, WriteOpenCloseState, static_cast<void *>(&gTestOpenCloseState));
+
+    memset(producers, 0, sizeof(producers));
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    numStaged = logger.GetNumStagedEvents();
+#endif
+
+    for (int i = 0; i < kNumConcurrentProducers; i++)
+    {
+        producers[i].mProducer = i;
+        NL_TEST_ASSERT(inSuite, pthread_create(&threads[i], NULL, LogEventsConcurrently, &producers[i]) == 0);
+    }
+
+    for (int i = 0; i < kNumConcurrentProducers; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Every event gets its own ID right after the first one, and each
+    // producer sees its IDs increase.
+    memset(seen, 0, sizeof(seen));
+
+    for (int i = 0; i < kNumConcurrentProducers; i++)
+    {
+        for (int j = 0; j < kNumEventsPerProducer; j++)
+        {
+            event_id_t offset = producers[i].mEventIds[j] - firstEventId - 1;
+
+            NL_TEST_ASSERT(inSuite, offset < kNumConcurrentProducers * kNumEventsPerProducer);
+            if (offset < kNumConcurrentProducers * kNumEventsPerProducer)
+            {
+                NL_TEST_ASSERT(inSuite, !seen[offset]);
+                seen[offset] = true;
+            }
+
+            NL_TEST_ASSERT(inSuite, j == 0 || producers[i].mEventIds[j] > producers[i].mEventIds[j - 1]);
+        }
+
+        // With a staging buffer for every producer, no payload is
+        // encoded under the critical section.
+        if (WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS >= kNumConcurrentProducers)
+        {
+            NL_TEST_ASSERT(inSuite, producers[i].mNumUnstaged == 0);
+        }
+        else if (WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS == 0)
+        {
+            NL_TEST_ASSERT(inSuite, producers[i].mNumUnstaged >= kNumEventsPerProducer);
+        }
+    }
+
+#if WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS > 0
+    // Count only the payloads that were actually staged and copied in.
+    numStaged = logger.GetNumStagedEvents() - numStaged;
+    if (WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS >= kNumConcurrentProducers)
+    {
+        NL_TEST_ASSERT(inSuite, numStaged == kNumConcurrentProducers * kNumEventsPerProducer);
+    }
+    else
+    {
+        NL_TEST_ASSERT(inSuite, numStaged > 0);
+    }
+#endif // WEAVE_CONFIG_EVENT_LOGGING_NUM_STAGING_BUFFERS
+
+    // Every event still in the log carries the payload its producer
+    // staged for that event ID.
+    eventId = logger.GetFirstEventID(nl::Weave::Profiles::DataManagement::Production);
+    if (eventId <= firstEventId)
+    {
+        eventId = firstEventId + 1;
+    }
+
+    fetchEventId = eventId;
+    writer.Init(gLargeMemoryBackingStore, sizeof(gLargeMemoryBackingStore));
+    err = logger.FetchEventsSince(writer, nl::Weave::Profiles::DataManagement::Production, fetchEventId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+
+    reader.Init(gLargeMemoryBackingStore, writer.GetLengthWritten());
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        TLVType eventType, dataType;
+        uint32_t producer = kNumConcurrentProducers, sequence = kNumEventsPerProducer;
+
+        err = reader.EnterContainer(eventType);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        while ((err = reader.Next()) == WEAVE_NO_ERROR && reader.GetTag() != ContextTag(kTag_EventData))
+            ;
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        err = reader.EnterContainer(dataType);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        while ((err = reader.Next()) == WEAVE_NO_ERROR)
+        {
+            if (reader.GetTag() == ContextTag(kProducerTag))
+            {
+                err = reader.Get(producer);
+            }
+            else if (reader.GetTag() == ContextTag(kSequenceTag))
+            {
+                err = reader.Get(sequence);
+            }
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        }
+
+        NL_TEST_ASSERT(inSuite, reader.ExitContainer(dataType) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, reader.ExitContainer(eventType) == WEAVE_NO_ERROR);
+
+        NL_TEST_ASSERT(inSuite, producer < kNumConcurrentProducers && sequence < kNumEventsPerProducer);
+        if (producer < kNumConcurrentProducers && sequence < kNumEventsPerProducer)
+        {
+            NL_TEST_ASSERT(inSuite, producers[producer].mEventIds[sequence] == eventId);
+        }
+
+        eventId++;
+        numChecked++;
+    }
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, numChecked > 0);
+    NL_TEST_ASSERT(inSuite, eventId == firstEventId + 1 + kNumConcurrentProducers * kNumEventsPerProducer);
+
+    DestroyEventLogging(context);
+}
+
 // Test Suite
 
 /**
@@ -3771,6 +4468,15 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Check Fetch Events", CheckFetchEvents),
     NL_TEST_DEF("Check Large Events", CheckLargeEvents),
     NL_TEST_DEF("Check Fetch Event Timestamps", CheckFetchTimestamps),
+    NL_TEST_DEF("Check Fetch Events Since with the event index", CheckFetchEventsSinceIndexed),
+#if WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+    NL_TEST_DEF("Check Event Log Archive", CheckEventLogArchive),
+    NL_TEST_DEF("Check Event Log Archive Compaction", CheckEventLogArchiveCompaction),
+    NL_TEST_DEF("Check Event Log Archive Spare Segments", CheckEventLogArchiveSpareSegments),
+#endif // WEAVE_CONFIG_EVENT_LOGGING_ARCHIVE
+#if WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
+    NL_TEST_DEF("Check Compact Event Encoding", CheckCompactEncoding),
+#endif // WEAVE_CONFIG_EVENT_LOGGING_COMPACT_ENCODING
     NL_TEST_DEF("Basic Deserialization Test", CheckBasicEventDeserialization),
     NL_TEST_DEF("Complex Deserialization Test", CheckComplexEventDeserialization),
     NL_TEST_DEF("Empty Array Deserialization Test", CheckEmptyArrayEventDeserialization),
@@ -3822,6 +4528,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Check Drop Overlapping Event Id Ranges", CheckDropOverlap),
     NL_TEST_DEF("Check Last Observed Event Id", CheckLastObservedEventId),
     NL_TEST_DEF("Check External Event eviction notification", CheckExternalEventNotifyEvicted),
+    NL_TEST_DEF("Check Concurrent Producers", CheckConcurrentProducers),
     NL_TEST_SENTINEL()
 };
 
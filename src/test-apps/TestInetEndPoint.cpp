@@ -31,6 +31,13 @@
 #include <stdint.h>
 #include <string.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#include <fcntl.h>
+#include <netinet/ip6.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 #include <InetLayer/InetLayer.h>
 #include <InetLayer/InetError.h>
 
@@ -81,6 +88,171 @@ void HandleTimer(Layer* aLayer, void* aAppState, Error aError)
     printf("    timer handler\n");
 }
 
+#define BATCH_TEST_PORT         3100
+#define BATCH_TEST_NUM_MSGS     40
+
+IPAddress batchLoopback;
+uint8_t batchMsgsReceived = 0;
+bool batchMsgsInOrder = true;
+bool batchPktInfoValid = true;
+
+void HandleBatchMessageReceived(IPEndPointBasis *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    if (msg->DataLength() != 1 || msg->Start()[0] != batchMsgsReceived)
+        batchMsgsInOrder = false;
+
+    if (pktInfo->SrcPort != BATCH_TEST_PORT + 1 || pktInfo->DestPort != BATCH_TEST_PORT ||
+        pktInfo->DestAddress != batchLoopback)
+        batchPktInfoValid = false;
+
+    batchMsgsReceived++;
+    PacketBuffer::Free(msg);
+}
+
+#define GATHER_TEST_PORT        3200
+#define GATHER_TEST_NUM_MSGS    40
+
+TCPEndPoint *gatherServerEP = NULL;
+bool gatherConnected = false;
+uint8_t gatherBytesReceived = 0;
+bool gatherBytesInOrder = true;
+
+void HandleGatherConnectComplete(TCPEndPoint *endPoint, INET_ERROR err)
+{
+    gatherConnected = (err == INET_NO_ERROR);
+}
+
+void HandleGatherDataReceived(TCPEndPoint *endPoint, PacketBuffer *data)
+{
+    const uint16_t len = data->TotalLength();
+
+    for (PacketBuffer *buf = data; buf != NULL; buf = buf->Next())
+    {
+        for (uint16_t i = 0; i < buf->DataLength(); i++)
+        {
+            if (buf->Start()[i] != gatherBytesReceived)
+                gatherBytesInOrder = false;
+            gatherBytesReceived++;
+        }
+    }
+
+    endPoint->AckReceive(len);
+    PacketBuffer::Free(data);
+}
+
+void HandleGatherConnectionReceived(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint, const IPAddress &peerAddr,
+                                    uint16_t peerPort)
+{
+    conEndPoint->OnDataReceived = HandleGatherDataReceived;
+    gatherServerEP = conEndPoint;
+}
+
+#define FRAMED_TEST_PORT        3201
+#define FRAMED_TEST_RESERVE     16
+#define FRAMED_TEST_TRAILER     8
+
+static const uint16_t sFramedTestLengths[] = { 0, 1, 100, 700, 5, 300 };
+#define FRAMED_TEST_NUM_FRAMES  (sizeof(sFramedTestLengths) / sizeof(sFramedTestLengths[0]))
+
+TCPEndPoint *framedServerEP = NULL;
+bool framedConnected = false;
+uint8_t framedFramesReceived = 0;
+bool framedFramesValid = true;
+
+void HandleFramedConnectComplete(TCPEndPoint *endPoint, INET_ERROR err)
+{
+    framedConnected = (err == INET_NO_ERROR);
+}
+
+void HandleFramedDataReceived(TCPEndPoint *endPoint, PacketBuffer *data)
+{
+    const uint16_t len = data->TotalLength();
+
+    // Each buffer must hold exactly one whole frame, with the requested space around it.
+    for (PacketBuffer *buf = data; buf != NULL; buf = buf->Next())
+    {
+        const uint16_t frameLen = buf->Start()[0] | (buf->Start()[1] << 8);
+
+        if (framedFramesReceived >= FRAMED_TEST_NUM_FRAMES || frameLen != sFramedTestLengths[framedFramesReceived] ||
+            buf->DataLength() != frameLen + 2 || buf->ReservedSize() < FRAMED_TEST_RESERVE ||
+            buf->AvailableDataLength() < FRAMED_TEST_TRAILER)
+            framedFramesValid = false;
+
+        for (uint16_t i = 0; framedFramesValid && i < frameLen; i++)
+        {
+            if (buf->Start()[2 + i] != framedFramesReceived)
+                framedFramesValid = false;
+        }
+
+        framedFramesReceived++;
+    }
+
+    endPoint->AckReceive(len);
+    PacketBuffer::Free(data);
+}
+
+void HandleFramedConnectionReceived(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint, const IPAddress &peerAddr,
+                                    uint16_t peerPort)
+{
+    conEndPoint->OnDataReceived = HandleFramedDataReceived;
+    conEndPoint->SetFramedReceive(true, FRAMED_TEST_RESERVE, FRAMED_TEST_TRAILER);
+    framedServerEP = conEndPoint;
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+namespace nl {
+namespace Inet {
+
+class NL_DLL_EXPORT TunEndPointTestObject
+{
+public:
+    // Use the given descriptor in place of a TUN device.
+    static void SetDevice(TunEndPoint *endPoint, int fd)
+    {
+        endPoint->mSocket = fd;
+        endPoint->mState = TunEndPoint::kState_Open;
+    }
+
+    // Handle a readiness event of the device, as the event loop would.
+    static void HandleReadable(TunEndPoint *endPoint)
+    {
+        endPoint->mPendingIO.SetRead();
+        endPoint->HandlePendingIO();
+    }
+};
+
+} // namespace Inet
+} // namespace nl
+
+#define TUN_BATCH_TEST_NUM_PKTS (INET_CONFIG_TUN_RECEIVE_BATCH_SIZE + 2)
+
+uint8_t tunBatchPktsReceived = 0;
+uint8_t tunBatchesCompleted = 0;
+uint8_t tunBatchErrors = 0;
+bool tunBatchPktsInOrder = true;
+
+void HandleTunBatchPacketReceived(TunEndPoint *endPoint, PacketBuffer *msg)
+{
+    if (msg->DataLength() != sizeof(struct ip6_hdr) + 1 || msg->Start()[sizeof(struct ip6_hdr)] != tunBatchPktsReceived)
+        tunBatchPktsInOrder = false;
+
+    tunBatchPktsReceived++;
+    PacketBuffer::Free(msg);
+}
+
+void HandleTunBatchReceiveComplete(TunEndPoint *endPoint)
+{
+    tunBatchesCompleted++;
+}
+
+void HandleTunBatchReceiveError(TunEndPoint *endPoint, INET_ERROR err)
+{
+    tunBatchErrors++;
+}
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 // Test before init network, Inet is not initialized
 static void TestInetPre(nlTestSuite *inSuite, void *inContext)
 {
@@ -511,6 +683,338 @@ static void TestInetEndPoint(nlTestSuite *inSuite, void *inContext)
     testTCPEP1->Shutdown();
 }
 
+// Test UDP batch mode by sending a burst of datagrams over the IPv6 loopback interface
+static void TestUDPBatchMode(nlTestSuite *inSuite, void *inContext)
+{
+    UDPEndPoint *receiverEP = NULL;
+    INET_ERROR err;
+
+    err = Inet.NewUDPEndPoint(&receiverEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = receiverEP->SetBatchMode(true);
+
+#if INET_CONFIG_UDP_BATCH_SIZE
+    UDPEndPoint *senderEP = NULL;
+
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = Inet.NewUDPEndPoint(&senderEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = senderEP->SetBatchMode(true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", batchLoopback));
+
+    err = receiverEP->Bind(kIPAddressType_IPv6, batchLoopback, BATCH_TEST_PORT);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    receiverEP->OnMessageReceived = HandleBatchMessageReceived;
+    err = receiverEP->Listen();
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = senderEP->Bind(kIPAddressType_IPv6, batchLoopback, BATCH_TEST_PORT + 1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    // Queue more messages than fit in a batch, retaining every other buffer so that both ways of queueing are covered.
+    for (uint8_t i = 0; i < BATCH_TEST_NUM_MSGS; i++)
+    {
+        PacketBuffer *buf = PacketBuffer::New();
+        const uint16_t sendFlags = (i & 1) ? IPEndPointBasis::kSendFlag_RetainBuffer : 0;
+
+        buf->Start()[0] = i;
+        buf->SetDataLength(1);
+
+        err = senderEP->SendTo(batchLoopback, BATCH_TEST_PORT, buf, sendFlags);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+        if (sendFlags != 0)
+        {
+            buf->Start()[0] = 0xFF;
+            PacketBuffer::Free(buf);
+        }
+    }
+
+    for (int i = 0; i < 100 && batchMsgsReceived < BATCH_TEST_NUM_MSGS; i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, batchMsgsReceived == BATCH_TEST_NUM_MSGS);
+    NL_TEST_ASSERT(inSuite, batchMsgsInOrder);
+    NL_TEST_ASSERT(inSuite, batchPktInfoValid);
+
+    senderEP->Free();
+#else // !INET_CONFIG_UDP_BATCH_SIZE
+    NL_TEST_ASSERT(inSuite, err == INET_ERROR_NOT_IMPLEMENTED);
+#endif // !INET_CONFIG_UDP_BATCH_SIZE
+
+    receiverEP->Free();
+}
+
+// Test that messages queued on a TCP end point are sent together and arrive intact
+static void TestTCPGatheredSend(nlTestSuite *inSuite, void *inContext)
+{
+    TCPEndPoint *listenEP = NULL;
+    TCPEndPoint *clientEP = NULL;
+    IPAddress loopback;
+    INET_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    err = Inet.NewTCPEndPoint(&listenEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = listenEP->Bind(kIPAddressType_IPv6, loopback, GATHER_TEST_PORT, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    listenEP->OnConnectionReceived = HandleGatherConnectionReceived;
+    err = listenEP->Listen(1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = Inet.NewTCPEndPoint(&clientEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    clientEP->OnConnectComplete = HandleGatherConnectComplete;
+    err = clientEP->Connect(loopback, GATHER_TEST_PORT);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (int i = 0; i < 100 && !(gatherConnected && gatherServerEP != NULL); i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, gatherConnected && gatherServerEP != NULL);
+
+    // Queue one small message per buffer, pushing them out only with the last one.
+    for (uint8_t i = 0; i < GATHER_TEST_NUM_MSGS; i++)
+    {
+        PacketBuffer *buf = PacketBuffer::New();
+
+        buf->Start()[0] = i;
+        buf->SetDataLength(1);
+
+        err = clientEP->Send(buf, i == GATHER_TEST_NUM_MSGS - 1);
+        NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    }
+
+    for (int i = 0; i < 100 && gatherBytesReceived < GATHER_TEST_NUM_MSGS; i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, gatherBytesReceived == GATHER_TEST_NUM_MSGS);
+    NL_TEST_ASSERT(inSuite, gatherBytesInOrder);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    {
+        uint32_t numSendCalls;
+        uint64_t numBytesSent;
+
+        clientEP->GetSendStatistics(numSendCalls, numBytesSent);
+
+        NL_TEST_ASSERT(inSuite, numBytesSent == GATHER_TEST_NUM_MSGS);
+#if INET_CONFIG_TCP_SEND_MAX_IOVECS > 1
+        NL_TEST_ASSERT(inSuite, numSendCalls < GATHER_TEST_NUM_MSGS);
+#else
+        NL_TEST_ASSERT(inSuite, numSendCalls == GATHER_TEST_NUM_MSGS);
+#endif
+    }
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
+    if (gatherServerEP != NULL)
+        gatherServerEP->Free();
+    clientEP->Free();
+    listenEP->Free();
+}
+
+// Test that a TUN end point reads a batch of packets per readiness event and stops once the device is empty
+static void TestTunBatchReceive(nlTestSuite *inSuite, void *inContext)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TUN_RECEIVE_BATCH_SIZE > 1
+    TunEndPoint *tunEP = NULL;
+    int fds[2];
+    INET_ERROR err;
+
+    err = Inet.NewTunEndPoint(&tunEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    if (err != INET_NO_ERROR)
+        return;
+
+    // Stand in for the device with a non-blocking socket that preserves packet boundaries.
+    NL_TEST_ASSERT(inSuite, socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds) == 0);
+    NL_TEST_ASSERT(inSuite, fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL, 0) | O_NONBLOCK) == 0);
+
+    TunEndPointTestObject::SetDevice(tunEP, fds[0]);
+    tunEP->OnPacketReceived = HandleTunBatchPacketReceived;
+    tunEP->OnReceiveComplete = HandleTunBatchReceiveComplete;
+    tunEP->OnReceiveError = HandleTunBatchReceiveError;
+
+    for (uint8_t i = 0; i < TUN_BATCH_TEST_NUM_PKTS; i++)
+    {
+        uint8_t pkt[sizeof(struct ip6_hdr) + 1];
+
+        memset(pkt, 0, sizeof(pkt));
+        pkt[0] = 0x60;
+        pkt[sizeof(struct ip6_hdr)] = i;
+
+        NL_TEST_ASSERT(inSuite, write(fds[1], pkt, sizeof(pkt)) == (ssize_t) sizeof(pkt));
+    }
+
+    // The first event reads a full batch and completes it.
+    TunEndPointTestObject::HandleReadable(tunEP);
+    NL_TEST_ASSERT(inSuite, tunBatchPktsReceived == INET_CONFIG_TUN_RECEIVE_BATCH_SIZE);
+    NL_TEST_ASSERT(inSuite, tunBatchesCompleted == 1);
+
+    // The second reads the rest, then stops without error on finding the device empty.
+    TunEndPointTestObject::HandleReadable(tunEP);
+    NL_TEST_ASSERT(inSuite, tunBatchPktsReceived == TUN_BATCH_TEST_NUM_PKTS);
+    NL_TEST_ASSERT(inSuite, tunBatchesCompleted == 2);
+
+    // An event that finds nothing to read completes no batch.
+    TunEndPointTestObject::HandleReadable(tunEP);
+    NL_TEST_ASSERT(inSuite, tunBatchPktsReceived == TUN_BATCH_TEST_NUM_PKTS);
+    NL_TEST_ASSERT(inSuite, tunBatchesCompleted == 2);
+
+    NL_TEST_ASSERT(inSuite, tunBatchPktsInOrder);
+    NL_TEST_ASSERT(inSuite, tunBatchErrors == 0);
+
+    // Freeing the end point closes the descriptor standing in for the device.
+    tunEP->Free();
+    close(fds[1]);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_TUN_RECEIVE_BATCH_SIZE > 1
+}
+
+// Test that a TCP end point in framed mode delivers each frame whole, in a buffer of its own
+static void TestTCPFramedReceive(nlTestSuite *inSuite, void *inContext)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    TCPEndPoint *listenEP = NULL;
+    TCPEndPoint *clientEP = NULL;
+    PacketBuffer *buf;
+    uint16_t bufLen;
+    IPAddress loopback;
+    INET_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    err = Inet.NewTCPEndPoint(&listenEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = listenEP->Bind(kIPAddressType_IPv6, loopback, FRAMED_TEST_PORT, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    listenEP->OnConnectionReceived = HandleFramedConnectionReceived;
+    err = listenEP->Listen(1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    err = Inet.NewTCPEndPoint(&clientEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    clientEP->OnConnectComplete = HandleFramedConnectComplete;
+    err = clientEP->Connect(loopback, FRAMED_TEST_PORT);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (int i = 0; i < 100 && !(framedConnected && framedServerEP != NULL); i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, framedConnected && framedServerEP != NULL);
+
+    // Send all but the last frame back to back in one buffer, so they arrive together.
+    buf = PacketBuffer::New();
+    bufLen = 0;
+    for (uint8_t i = 0; i < FRAMED_TEST_NUM_FRAMES - 1; i++)
+    {
+        buf->Start()[bufLen++] = sFramedTestLengths[i] & 0xFF;
+        buf->Start()[bufLen++] = sFramedTestLengths[i] >> 8;
+        memset(buf->Start() + bufLen, i, sFramedTestLengths[i]);
+        bufLen += sFramedTestLengths[i];
+    }
+
+    // Follow them with the first byte of the length of the last frame.
+    buf->Start()[bufLen++] = sFramedTestLengths[FRAMED_TEST_NUM_FRAMES - 1] & 0xFF;
+    buf->SetDataLength(bufLen);
+
+    err = clientEP->Send(buf, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (int i = 0; i < 100 && framedFramesReceived == 0; i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    // The frames arrived together, so the readiness event that delivered the first of them delivered them all.
+    NL_TEST_ASSERT(inSuite, framedFramesReceived == FRAMED_TEST_NUM_FRAMES - 1);
+
+    // Send the rest of the last frame in two parts, splitting its contents.
+    buf = PacketBuffer::New();
+    buf->Start()[0] = sFramedTestLengths[FRAMED_TEST_NUM_FRAMES - 1] >> 8;
+    memset(buf->Start() + 1, FRAMED_TEST_NUM_FRAMES - 1, 10);
+    buf->SetDataLength(11);
+
+    err = clientEP->Send(buf, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (int i = 0; i < 10; i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    // The partial frame is held back by the end point until it is complete.
+    NL_TEST_ASSERT(inSuite, framedFramesReceived == FRAMED_TEST_NUM_FRAMES - 1);
+
+    buf = PacketBuffer::New();
+    memset(buf->Start(), FRAMED_TEST_NUM_FRAMES - 1, sFramedTestLengths[FRAMED_TEST_NUM_FRAMES - 1] - 10);
+    buf->SetDataLength(sFramedTestLengths[FRAMED_TEST_NUM_FRAMES - 1] - 10);
+
+    err = clientEP->Send(buf, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    for (int i = 0; i < 100 && framedFramesReceived < FRAMED_TEST_NUM_FRAMES; i++)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+
+        ServiceNetwork(sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, framedFramesReceived == FRAMED_TEST_NUM_FRAMES);
+    NL_TEST_ASSERT(inSuite, framedFramesValid);
+
+    if (framedServerEP != NULL)
+        framedServerEP->Free();
+    clientEP->Free();
+    listenEP->Free();
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+}
+
 // Test the InetLayer resource limitation
 static void TestInetEndPointLimit(nlTestSuite *inSuite, void *inContext)
 {
@@ -571,6 +1075,10 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("InetEndPoint::TestInetError",       TestInetError),
     NL_TEST_DEF("InetEndPoint::TestInetInterface",   TestInetInterface),
     NL_TEST_DEF("InetEndPoint::TestInetEndPoint",    TestInetEndPoint),
+    NL_TEST_DEF("InetEndPoint::TestUDPBatchMode",    TestUDPBatchMode),
+    NL_TEST_DEF("InetEndPoint::TestTCPGatheredSend", TestTCPGatheredSend),
+    NL_TEST_DEF("InetEndPoint::TestTCPFramedReceive", TestTCPFramedReceive),
+    NL_TEST_DEF("InetEndPoint::TestTunBatchReceive", TestTunBatchReceive),
     NL_TEST_DEF("InetEndPoint::TestEndPointLimit",   TestInetEndPointLimit),
     NL_TEST_SENTINEL()
 };
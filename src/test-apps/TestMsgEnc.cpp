@@ -60,6 +60,17 @@ public:
     {
         return msgLayer->DecodeMessage(msgBuf, sourceNodeId, con, msgInfo, rPayload, rPayloadLen);
     }
+
+    WEAVE_ERROR EncodeMessageWithLength(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, WeaveConnection *con, uint16_t maxLen)
+    {
+        return msgLayer->EncodeMessageWithLength(msgInfo, msgBuf, con, maxLen);
+    }
+
+    WEAVE_ERROR DecodeChainedMessageWithLength(PacketBuffer *&msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
+            WeaveMessageInfo *msgInfo, PacketBuffer **rPayload, uint32_t *rFrameLen)
+    {
+        return msgLayer->DecodeChainedMessageWithLength(msgBuf, sourceNodeId, con, msgInfo, rPayload, rFrameLen);
+    }
 };
 
 } // namespace nl
@@ -339,11 +350,207 @@ void WeaveMessageEncryption_Test1(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+// Copy an encoded message into a chain of full buffers, the way a connection receives a message longer than a
+// buffer, followed by a buffer holding the start of the next message.
+static PacketBuffer *CopyToReceivedBuffers(PacketBuffer *aMsg, uint16_t aTruncateLen)
+{
+    PacketBuffer *head = NULL;
+    PacketBuffer *cur = NULL;
+    uint32_t remaining = aMsg->TotalLength() - aTruncateLen;
+
+    for (; aMsg != NULL && remaining > 0; aMsg = aMsg->Next())
+    {
+        for (uint16_t offset = 0; offset < aMsg->DataLength() && remaining > 0; )
+        {
+            uint16_t len;
+
+            if (cur == NULL || cur->AvailableDataLength() == 0)
+            {
+                cur = PacketBuffer::New(0);
+                if (cur == NULL)
+                {
+                    PacketBuffer::Free(head);
+                    return NULL;
+                }
+
+                if (head == NULL)
+                    head = cur;
+                else
+                    head->AddToEnd(cur);
+            }
+
+            len = cur->AvailableDataLength();
+            if (len > aMsg->DataLength() - offset)
+                len = aMsg->DataLength() - offset;
+            if (len > remaining)
+                len = remaining;
+
+            memcpy(cur->Start() + cur->DataLength(), aMsg->Start() + offset, len);
+            cur->SetDataLength(cur->DataLength() + len, head);
+            offset += len;
+            remaining -= len;
+        }
+    }
+
+    if (aTruncateLen == 0)
+    {
+        cur = PacketBuffer::New(0);
+        if (cur == NULL)
+        {
+            PacketBuffer::Free(head);
+            return NULL;
+        }
+
+        memset(cur->Start(), 0xA5, 4);
+        cur->SetDataLength(4);
+        head->AddToEnd(cur);
+    }
+
+    return head;
+}
+
+void WeaveMessageEncryption_TestChained(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveFabricState fabricState;
+    static WeaveMessageLayer messageLayer;
+    static WeaveConnection con;
+    static WeaveMessageInfo msgInfo;
+
+    enum
+    {
+        kChainedPayloadBlockSize = 1000,
+        kEncodedMsgOverhead = 2 + 24 + HMACSHA1::kDigestLength  // Length field, header and integrity check value.
+    };
+
+    // Test the integrity check value ending inside the last buffer, straddling the last two buffers, and filling the
+    // last buffer on its own.  Then test a corrupted message and a message not yet received in full.
+    static const uint16_t sFrameTailLen[] = { 100, HMACSHA1::kDigestLength / 2, HMACSHA1::kDigestLength, 100, 100 };
+    static const size_t kCorruptTest = 3;
+    static const size_t kTruncateTest = 4;
+
+    WeaveMessageLayerTestObject msgLayerTestObject;
+    WeaveEncryptionKey msgEncSessionKey;
+    WeaveSessionKey *sessionKey;
+    PacketBuffer *buf;
+    uint64_t nodeId = 0x18B4300000000002ULL;
+    uint16_t sessionKeyId = sTestDefaultSessionKeyId;
+    uint16_t bufCapacity;
+    WEAVE_ERROR err;
+
+    buf = PacketBuffer::New(0);
+    NL_TEST_ASSERT(inSuite, buf != NULL);
+    if (buf == NULL)
+        return;
+    bufCapacity = buf->AvailableDataLength();
+    PacketBuffer::Free(buf);
+
+    err = fabricState.Init();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    fabricState.LocalNodeId = nodeId;
+
+    memcpy(msgEncSessionKey.AES128CTRSHA1.DataKey, sMsgEncKey_DataKey, sizeof(sMsgEncKey_DataKey));
+    memcpy(msgEncSessionKey.AES128CTRSHA1.IntegrityKey, sMsgEncKey_IntegrityKey, sizeof(sMsgEncKey_IntegrityKey));
+
+    err = fabricState.AllocSessionKey(nodeId, sessionKeyId, NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    fabricState.SetSessionKey(sessionKey, kWeaveEncryptionType_AES128CTRSHA1, kWeaveAuthMode_CASE_Device, &msgEncSessionKey);
+
+    messageLayer.FabricState = &fabricState;
+    msgLayerTestObject.msgLayer = &messageLayer;
+
+    for (size_t ith = 0; ith < sizeof(sFrameTailLen) / sizeof(sFrameTailLen[0]); ith++)
+    {
+        uint32_t payloadLen = 2 * bufCapacity + sFrameTailLen[ith] - kEncodedMsgOverhead;
+        PacketBuffer *received = NULL;
+        PacketBuffer *payload = NULL;
+        uint32_t frameLen = 0;
+        uint32_t offset = 0;
+
+        // Build the payload in a chain of buffers.
+        buf = NULL;
+        while (offset < payloadLen)
+        {
+            PacketBuffer *block = (buf == NULL) ? PacketBuffer::New() : PacketBuffer::New(0);
+            uint16_t blockLen = (payloadLen - offset < kChainedPayloadBlockSize) ? payloadLen - offset : kChainedPayloadBlockSize;
+
+            NL_TEST_ASSERT(inSuite, block != NULL);
+            if (block == NULL)
+                break;
+
+            for (uint16_t i = 0; i < blockLen; i++)
+                block->Start()[i] = static_cast<uint8_t>(offset + i);
+            block->SetDataLength(blockLen);
+            offset += blockLen;
+
+            if (buf == NULL)
+                buf = block;
+            else
+                buf->AddToEnd(block);
+        }
+
+        msgInfo.Clear();
+        msgInfo.SourceNodeId = nodeId;
+        msgInfo.DestNodeId = nodeId;
+        msgInfo.MessageId = ith + 1;
+        msgInfo.KeyId = sessionKeyId;
+        msgInfo.EncryptionType = kWeaveEncryptionType_AES128CTRSHA1;
+        msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+        msgInfo.Flags = kWeaveMessageFlag_DestNodeId | kWeaveMessageFlag_SourceNodeId | kWeaveMessageFlag_ReuseMessageId;
+
+        err = msgLayerTestObject.EncodeMessageWithLength(&msgInfo, buf, &con, UINT16_MAX);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, buf->TotalLength() == payloadLen + kEncodedMsgOverhead);
+
+        if (ith == kCorruptTest)
+            buf->Next()->Start()[0] ^= 0x01;
+
+        received = CopyToReceivedBuffers(buf, (ith == kTruncateTest) ? 1 : 0);
+        NL_TEST_ASSERT(inSuite, received != NULL);
+        PacketBuffer::Free(buf);
+        if (received == NULL)
+            continue;
+
+        msgInfo.Clear();
+        err = msgLayerTestObject.DecodeChainedMessageWithLength(received, nodeId, &con, &msgInfo, &payload, &frameLen);
+        NL_TEST_ASSERT(inSuite, frameLen == payloadLen + kEncodedMsgOverhead);
+
+        if (ith == kCorruptTest)
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+        }
+        else if (ith == kTruncateTest)
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_MESSAGE_INCOMPLETE);
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+            NL_TEST_ASSERT(inSuite, msgInfo.MessageId == ith + 1);
+
+            // The payload comes back in full, without the integrity check value or any empty buffers.
+            NL_TEST_ASSERT(inSuite, payload != NULL && payload->TotalLength() == payloadLen);
+            offset = 0;
+            for (PacketBuffer *p = payload; p != NULL; p = p->Next())
+            {
+                NL_TEST_ASSERT(inSuite, p->DataLength() > 0);
+                for (uint16_t i = 0; i < p->DataLength(); i++, offset++)
+                    NL_TEST_ASSERT(inSuite, p->Start()[i] == static_cast<uint8_t>(offset));
+            }
+
+            // The data following the message is handed back.
+            NL_TEST_ASSERT(inSuite, received != NULL && received->TotalLength() == 4 && received->Start()[0] == 0xA5);
+        }
+
+        PacketBuffer::Free(payload);
+        PacketBuffer::Free(received);
+    }
+}
 
 int main(int argc, char *argv[])
 {
     static const nlTest tests[] = {
         NL_TEST_DEF("WeaveMessageEncryption",           WeaveMessageEncryption_Test1),
+        NL_TEST_DEF("WeaveMessageEncryption Chained",   WeaveMessageEncryption_TestChained),
         NL_TEST_SENTINEL()
     };
 
@@ -32,6 +32,11 @@
 #include <errno.h>
 
 #include <SystemLayer/SystemPacketBuffer.h>
+#include <SystemLayer/SystemStats.h>
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+#include <pthread.h>
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/tcpip.h>
@@ -1108,10 +1113,141 @@ static void CheckBuildFreeList(nlTestSuite *inSuite, void *inContext)
     (void)inContext;
 }
 
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+/**
+ *  Test the allocation of pooled buffers of different sizes.
+ *
+ *  Description: For the capacity of each buffer pool, allocate a buffer of exactly that capacity and one of a byte more. Verify
+ *               that the first comes from that pool and the second from the next larger one, as reported by AllocSize().
+ */
+static void CheckSizeClasses(nlTestSuite *inSuite, void *inContext)
+{
+    static const size_t kCapacities[] = {
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+        WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_SMALL,
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_SMALL
+#if WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+        WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MEDIUM,
+#endif // WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC_MEDIUM
+        WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX
+    };
+    static const size_t kNumCapacities = sizeof(kCapacities) / sizeof(kCapacities[0]);
+
+    for (size_t i = 0; i < kNumCapacities; i++)
+    {
+        PacketBuffer *buffer = PacketBuffer::NewWithAvailableSize(0, kCapacities[i]);
+
+        NL_TEST_ASSERT(inSuite, buffer != NULL);
+        if (buffer != NULL)
+        {
+            NL_TEST_ASSERT(inSuite, buffer->AllocSize() == kCapacities[i]);
+            NL_TEST_ASSERT(inSuite, buffer->MaxDataLength() == kCapacities[i]);
+            PacketBuffer::Free(buffer);
+        }
+
+        buffer = PacketBuffer::NewWithAvailableSize(0, kCapacities[i] + 1);
+
+        if (i + 1 < kNumCapacities)
+        {
+            NL_TEST_ASSERT(inSuite, buffer != NULL);
+            if (buffer != NULL)
+                NL_TEST_ASSERT(inSuite, buffer->AllocSize() == kCapacities[i + 1]);
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, buffer == NULL);
+        }
+
+        PacketBuffer::Free(buffer);
+    }
+}
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+static void *CacheThreadMain(void *aArg)
+{
+    PacketBuffer *buffer = PacketBuffer::New();
+
+    // The released buffer is kept in the cache of this thread until it exits.
+    PacketBuffer::Free(buffer);
+
+    return buffer;
+}
+
+/**
+ *  Test the per-thread caches of released buffers.
+ *
+ *  Description: Release a buffer and verify that the next allocation of the same thread reuses it, and that neither a buffer
+ *               kept in a cache nor one returned from the cache of an exiting thread is counted as in use. Then verify that
+ *               the buffer kept by the exited thread is available to other threads.
+ */
+static void CheckThreadCache(nlTestSuite *inSuite, void *inContext)
+{
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    using namespace ::nl::Weave::System::Stats;
+    const count_t kInUse = GetResourcesInUse()[kSystemLayer_NumPacketBufs];
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    PacketBuffer *buffers[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE + 1];
+    PacketBuffer *first;
+    PacketBuffer *second;
+    void *threadBuffer = NULL;
+    pthread_t thread;
+    bool found = false;
+
+    first = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, first != NULL);
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, GetResourcesInUse()[kSystemLayer_NumPacketBufs] == static_cast<count_t>(kInUse + 1));
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+    PacketBuffer::Free(first);
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, GetResourcesInUse()[kSystemLayer_NumPacketBufs] == kInUse);
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+    second = PacketBuffer::New();
+    NL_TEST_ASSERT(inSuite, second == first);
+    PacketBuffer::Free(second);
+
+    NL_TEST_ASSERT(inSuite, pthread_create(&thread, NULL, CacheThreadMain, NULL) == 0);
+    NL_TEST_ASSERT(inSuite, pthread_join(thread, &threadBuffer) == 0);
+    NL_TEST_ASSERT(inSuite, threadBuffer != NULL);
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, GetResourcesInUse()[kSystemLayer_NumPacketBufs] == kInUse);
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+    // This thread keeps at most a cache-full of buffers, after which it must reach the buffer flushed by the other thread.
+    for (size_t i = 0; i < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE + 1; i++)
+    {
+        buffers[i] = PacketBuffer::New();
+        NL_TEST_ASSERT(inSuite, buffers[i] != NULL);
+        found = found || (buffers[i] == threadBuffer);
+    }
+
+    NL_TEST_ASSERT(inSuite, found);
+
+    for (size_t i = 0; i < WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE + 1; i++)
+    {
+        PacketBuffer::Free(buffers[i]);
+    }
+
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    NL_TEST_ASSERT(inSuite, GetResourcesInUse()[kSystemLayer_NumPacketBufs] == kInUse);
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+}
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+
 /**
  *   Test Suite. It lists all the test functions.
  */
 static const nlTest sTests[] = {
+#if !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
+    // These must run before PacketBuffer::NewWithAvailableSize, which exhausts the pools.
+    NL_TEST_DEF("PacketBuffer::SizeClasses",                    CheckSizeClasses),
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+    NL_TEST_DEF("PacketBuffer::ThreadCache",                    CheckThreadCache),
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_THREAD_CACHE_SIZE
+#endif // !WEAVE_SYSTEM_CONFIG_USE_LWIP && WEAVE_SYSTEM_CONFIG_PACKETBUFFER_MAXALLOC
     NL_TEST_DEF("PacketBuffer::NewWithAvailableSize&PacketBuffer::Free", CheckNewWithAvailableSizeAndFree),
     NL_TEST_DEF("PacketBuffer::Start",                          CheckStart),
     NL_TEST_DEF("PacketBuffer::SetStart",                       CheckSetStart),
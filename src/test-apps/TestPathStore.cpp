@@ -72,6 +72,15 @@ namespace Platform {
     }
 } // Platform
 
+class TestHTraitDataSink : public TraitDataSink
+{
+public:
+    TestHTraitDataSink() : TraitDataSink(&TestHTrait::TraitSchema) { }
+
+private:
+    WEAVE_ERROR SetLeafData(PropertyPathHandle aLeafHandle, TLVReader &aReader) { return WEAVE_NO_ERROR; }
+};
+
 class TraitPathStoreTest {
     public:
         enum {
@@ -79,11 +88,16 @@ class TraitPathStoreTest {
             kFlag_GoodFlag = 0x4,
             kFlag_GoodFlag2 = 0x8,
         };
-        TraitPathStoreTest();
+        TraitPathStoreTest(bool aUseIndex);
         ~TraitPathStoreTest() { }
 
         TraitPathStore mStore;
         TraitPathStore::Record mStorage[10];
+        TraitPathStore::IndexEntry mIndex[64];
+
+        TestHTraitDataSink mSinks[3];
+        SingleResourceTraitCatalog<TraitDataSink>::CatalogItem mCatalogStore[3];
+        SingleResourceTraitCatalog<TraitDataSink> mCatalog;
 
         TraitPath mPath;
         TraitDataHandle mTDH1;
@@ -104,10 +118,22 @@ class TraitPathStoreTest {
         void TestSetFailedTrait(nlTestSuite *inSuite, void *inContext);
 };
 
-TraitPathStoreTest::TraitPathStoreTest() :
+TraitPathStoreTest::TraitPathStoreTest(bool aUseIndex) :
+            mCatalog(ResourceIdentifier(ResourceIdentifier::SELF_NODE_ID), mCatalogStore, ArraySize(mCatalogStore)),
             mTDH1(1), mTDH2(2), mSchemaEngine(&TestHTrait::TraitSchema)
 {
+    // The catalog hands out dense handles, so populate every slot up to mTDH2.
+    for (TraitDataHandle handle = 0; handle < ArraySize(mSinks); handle++)
+    {
+        mCatalog.AddAt(0, &mSinks[handle], handle);
+    }
+
     mStore.Init(mStorage, ArraySize(mStorage));
+
+    if (aUseIndex)
+    {
+        mStore.InitIndex(mIndex, ArraySize(mIndex), &mCatalog);
+    }
 }
 
 void TraitPathStoreTest::TestInitCleanup(nlTestSuite *inSuite, void *inContext)
@@ -656,68 +682,151 @@ SubscriptionEngine * SubscriptionEngine::GetInstance()
     return gSubscriptionEngine;
 }
 
-TraitPathStoreTest gPathStoreTest;
+TraitPathStoreTest gPathStoreTest(false);
+TraitPathStoreTest gIndexedPathStoreTest(true);
 
 
 
 void TraitPathStoreTest_InitCleanup(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestInitCleanup(inSuite, inContext);
+    gIndexedPathStoreTest.TestInitCleanup(inSuite, inContext);
 }
 
 void TraitPathStoreTest_AddGet(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestAddGet(inSuite, inContext);
+    gIndexedPathStoreTest.TestAddGet(inSuite, inContext);
 }
 
 void TraitPathStoreTest_Full(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestFull(inSuite, inContext);
+    gIndexedPathStoreTest.TestFull(inSuite, inContext);
 }
 
 void TraitPathStoreTest_Includes(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestIncludes(inSuite, inContext);
+    gIndexedPathStoreTest.TestIncludes(inSuite, inContext);
 }
 
 void TraitPathStoreTest_Intersects(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestIntersects(inSuite, inContext);
+    gIndexedPathStoreTest.TestIntersects(inSuite, inContext);
 }
 
 void TraitPathStoreTest_IsPresent(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestIsPresent(inSuite, inContext);
+    gIndexedPathStoreTest.TestIsPresent(inSuite, inContext);
 }
 
 void TraitPathStoreTest_RemoveAndCompact(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestRemoveAndCompact(inSuite, inContext);
+    gIndexedPathStoreTest.TestRemoveAndCompact(inSuite, inContext);
 }
 
 void TraitPathStoreTest_AddItemDedup(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestAddItemDedup(inSuite, inContext);
+    gIndexedPathStoreTest.TestAddItemDedup(inSuite, inContext);
 }
 
 void TraitPathStoreTest_GetFirstGetNext(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestGetFirstGetNext(inSuite, inContext);
+    gIndexedPathStoreTest.TestGetFirstGetNext(inSuite, inContext);
 }
 
 void TraitPathStoreTest_Flags(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestFlags(inSuite, inContext);
+    gIndexedPathStoreTest.TestFlags(inSuite, inContext);
 }
 
 void TraitPathStoreTest_InsertItem(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestInsertItem(inSuite, inContext);
+    gIndexedPathStoreTest.TestInsertItem(inSuite, inContext);
 }
 
 void TraitPathStoreTest_SetFailedTrait(nlTestSuite *inSuite, void *inContext)
 {
     gPathStoreTest.TestSetFailedTrait(inSuite, inContext);
+    gIndexedPathStoreTest.TestSetFailedTrait(inSuite, inContext);
+}
+
+void TraitPathStoreTest_ManyItems(nlTestSuite *inSuite, void *inContext)
+{
+    enum { kNumItems = 256 };
+    static TraitPathStore::Record records[kNumItems];
+    static TraitPathStore::IndexEntry index[4 * kNumItems];
+    const TraitSchemaEngine *schemaEngine = &TestHTrait::TraitSchema;
+
+    // Dedup-add a dictionary item per key, then check that a leaf below each one is included, first with a scanning store
+    // and then with an indexed one. Finally remove the items one by one.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        TraitPathStore store;
+        size_t numIncluded = 0;
+
+        store.Init(records, kNumItems);
+
+        if (pass == 1)
+        {
+            store.InitIndex(index, ArraySize(index), &gIndexedPathStoreTest.mCatalog);
+        }
+
+        for (uint16_t key = 0; key < kNumItems; key++)
+        {
+            TraitPath path(gIndexedPathStoreTest.mTDH1, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, key));
+
+            NL_TEST_ASSERT(inSuite, store.AddItemDedup(path, schemaEngine) == WEAVE_NO_ERROR);
+        }
+
+        for (uint16_t key = 0; key < kNumItems; key++)
+        {
+            TraitPath path(gIndexedPathStoreTest.mTDH1, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Da, key));
+
+            numIncluded += store.Includes(path, schemaEngine) ? 1 : 0;
+        }
+
+        NL_TEST_ASSERT(inSuite, store.GetNumItems() == kNumItems);
+        NL_TEST_ASSERT(inSuite, numIncluded == kNumItems);
+        NL_TEST_ASSERT(inSuite, store.IsTraitPresent(gIndexedPathStoreTest.mTDH1));
+        NL_TEST_ASSERT(inSuite, false == store.IsTraitPresent(gIndexedPathStoreTest.mTDH2));
+
+        // Remove every other item first, so that the remaining ones have to stay reachable while the index entries of their
+        // neighbours are purged.
+        for (int round = 0; round < 2; round++)
+        {
+            for (size_t i = round; i < kNumItems; i += 2)
+            {
+                store.RemoveItemAt(i);
+            }
+
+            for (uint16_t key = 0; key < kNumItems; key++)
+            {
+                TraitPath path(gIndexedPathStoreTest.mTDH1, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, key));
+
+                NL_TEST_ASSERT(inSuite, store.IsPresent(path) == (round == 0 && (key % 2) == 1));
+            }
+        }
+
+        NL_TEST_ASSERT(inSuite, false == store.IsTraitPresent(gIndexedPathStoreTest.mTDH1));
+
+        // Entries are purged from the index as soon as their counts drop to zero.
+        if (pass == 1)
+        {
+            for (size_t i = 0; i < ArraySize(index); i++)
+            {
+                NL_TEST_ASSERT(inSuite, index[i].mTraitPath.mPropertyPathHandle == kNullPropertyPathHandle);
+            }
+        }
+    }
 }
 
 // Test Suite
@@ -738,6 +847,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Flags",  TraitPathStoreTest_Flags),
     NL_TEST_DEF("InsertItem",  TraitPathStoreTest_InsertItem),
     NL_TEST_DEF("SetFailedTrait",  TraitPathStoreTest_SetFailedTrait),
+    NL_TEST_DEF("Many items",  TraitPathStoreTest_ManyItems),
 
     NL_TEST_SENTINEL()
 };
@@ -41,6 +41,7 @@
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #include <sys/select.h>
+#include <unistd.h>
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #include <SystemLayer/SystemError.h>
@@ -188,6 +189,316 @@ static void CheckStarvation(nlTestSuite* inSuite, void* aContext)
     ServiceEvents(lSys, sleepTime);
 }
 
+static const uint32_t kNumOrderedTimers = 16;
+static uint32_t sOrderedTimerDelays[kNumOrderedTimers];
+static uint32_t sNumOrderedTimersHandled;
+static bool sOrderedTimersInOrder;
+
+void HandleOrderedTimer(Layer* aLayer, void* aState, Error aError)
+{
+    const uint32_t lDelay = *static_cast<uint32_t*>(aState);
+
+    // Timers must complete in order of their delays; each has a distinct delay.
+    if (sNumOrderedTimersHandled > 0 && lDelay < sOrderedTimerDelays[sNumOrderedTimersHandled - 1])
+        sOrderedTimersInOrder = false;
+
+    sOrderedTimerDelays[sNumOrderedTimersHandled] = lDelay;
+    sNumOrderedTimersHandled++;
+}
+
+static void CheckOrdering(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    // Delays straddle the boundaries between the levels of the timer wheel; cancelled timers are the odd entries.
+    static uint32_t sDelays[kNumOrderedTimers] = { 300, 1, 65, 64, 0, 63, 129, 7, 250, 128, 2, 200, 700, 5, 66, 90 };
+    const uint32_t kNumExpected = kNumOrderedTimers / 2;
+    Error lError;
+
+    sNumOrderedTimersHandled = 0;
+    sOrderedTimersInOrder = true;
+
+    lSys.CancelTimer(HandleGreedyTimer, aContext);
+
+    for (uint32_t i = 0; i < kNumOrderedTimers; i++)
+    {
+        lError = lSys.StartTimer(sDelays[i], HandleOrderedTimer, &sDelays[i]);
+        NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    }
+
+    for (uint32_t i = 1; i < kNumOrderedTimers; i += 2)
+    {
+        lSys.CancelTimer(HandleOrderedTimer, &sDelays[i]);
+    }
+
+    while (sNumOrderedTimersHandled < kNumExpected)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, sOrderedTimersInOrder);
+    NL_TEST_ASSERT(inSuite, sNumOrderedTimersHandled == kNumExpected);
+
+    for (uint32_t i = 0; i < kNumExpected; i++)
+    {
+        bool lFound = false;
+
+        for (uint32_t j = 0; j < kNumOrderedTimers; j += 2)
+            lFound = lFound || (sOrderedTimerDelays[i] == sDelays[j]);
+
+        NL_TEST_ASSERT(inSuite, lFound);
+    }
+}
+
+static bool sRestartedTimerHandled;
+
+void HandleRestartedTimer(Layer* aLayer, void* aState, Error aError)
+{
+    sRestartedTimerHandled = true;
+}
+
+static void CheckRestart(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    const uint64_t kStart = Layer::GetClock_MonotonicMS();
+    Error lError;
+
+    sRestartedTimerHandled = false;
+
+    // Starting a timer with the same callback and state replaces the running one.
+    lError = lSys.StartTimer(10, HandleRestartedTimer, aContext);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    lError = lSys.StartTimer(100, HandleRestartedTimer, aContext);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    while (!sRestartedTimerHandled)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, Layer::GetClock_MonotonicMS() - kStart >= 100);
+}
+
+static uint32_t sNumWorkHandled;
+
+void HandleScheduledWork(Layer* aLayer, void* aState, Error aError)
+{
+    sNumWorkHandled++;
+}
+
+static void CheckCancelWork(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    uint32_t lOtherState;
+    Error lError;
+
+    sNumWorkHandled = 0;
+
+    // Work scheduled through ScheduleWork can be cancelled like a timer, without affecting other work.
+    lError = lSys.ScheduleWork(HandleScheduledWork, aContext);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    lError = lSys.ScheduleWork(HandleScheduledWork, &lOtherState);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    lSys.CancelTimer(HandleScheduledWork, aContext);
+
+    for (int i = 0; i < 5; i++)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000;
+        ServiceEvents(lSys, sleepTime);
+    }
+
+    NL_TEST_ASSERT(inSuite, sNumWorkHandled == 1);
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+static volatile bool sServiceEventsTimerDone;
+
+void HandleServiceEventsTimer(Layer* aLayer, void* aState, Error aError)
+{
+    sServiceEventsTimerDone = true;
+}
+
+static void CheckServiceEventsTimer(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    Error lError;
+
+    sServiceEventsTimerDone = false;
+
+    // Discard any timer left behind by the starvation test.
+    lSys.CancelTimer(HandleGreedyTimer, aContext);
+
+    lError = lSys.StartTimer(10, HandleServiceEventsTimer, aContext);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    // The layer must sleep no longer than the pending timer, so a long maximum sleep still completes promptly.
+    lError = lSys.ServiceEvents(60000);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    while (!sServiceEventsTimerDone)
+    {
+        lError = lSys.ServiceEvents(1);
+        NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    }
+}
+
+struct PipeWatchState
+{
+    int mReadFD;
+    uint32_t mNumHandled;
+    uint8_t mInterest;
+    uint8_t mLastEvents;
+};
+
+static uint8_t PreparePipeWatch(IOWatch& aWatch)
+{
+    return static_cast<PipeWatchState*>(aWatch.AppState)->mInterest;
+}
+
+static void HandlePipeWatch(IOWatch& aWatch, uint8_t aEvents)
+{
+    PipeWatchState& lState = *static_cast<PipeWatchState*>(aWatch.AppState);
+    uint8_t lByte;
+
+    // Consume only one byte per dispatch so that the backend must notice the descriptor is still readable.
+    if (aEvents & IOWatch::kEvent_Read)
+        static_cast<void>(::read(lState.mReadFD, &lByte, 1));
+
+    // Like an endpoint that has flushed its send queue, lose interest in writing once written.
+    if (aEvents & IOWatch::kEvent_Write)
+        lState.mInterest &= ~IOWatch::kEvent_Write;
+
+    lState.mNumHandled++;
+    lState.mLastEvents = aEvents;
+}
+
+static void CheckIOWatch(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    PipeWatchState lState;
+    IOWatch lWatch;
+    int lPipeFDs[2];
+    Error lError;
+
+    NL_TEST_ASSERT(inSuite, ::pipe(lPipeFDs) == 0);
+
+    lState.mReadFD = lPipeFDs[0];
+    lState.mNumHandled = 0;
+    lState.mInterest = IOWatch::kEvent_Read;
+    lState.mLastEvents = 0;
+
+    lWatch.Init(PreparePipeWatch, HandlePipeWatch, &lState);
+    NL_TEST_ASSERT(inSuite, !lWatch.IsRegistered());
+
+    lError = lSys.RegisterIO(lWatch, lPipeFDs[0]);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lWatch.IsRegistered());
+
+    // Nothing to read yet.
+    lError = lSys.ServiceEvents(0);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 0);
+
+    // A handler that reads one of two bytes must be called again for the second.
+    NL_TEST_ASSERT(inSuite, ::write(lPipeFDs[1], "ab", 2) == 2);
+
+    lError = lSys.ServiceEvents(1000);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 1);
+    NL_TEST_ASSERT(inSuite, lState.mLastEvents == IOWatch::kEvent_Read);
+
+    lError = lSys.ServiceEvents(1000);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 2);
+
+    lError = lSys.ServiceEvents(0);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 2);
+
+    // Once unregistered, the descriptor is no longer dispatched.
+    lSys.UnregisterIO(lWatch);
+    NL_TEST_ASSERT(inSuite, !lWatch.IsRegistered());
+
+    NL_TEST_ASSERT(inSuite, ::write(lPipeFDs[1], "c", 1) == 1);
+
+    lError = lSys.ServiceEvents(0);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 2);
+
+    ::close(lPipeFDs[0]);
+    ::close(lPipeFDs[1]);
+}
+
+static void CheckIOWatchInterest(nlTestSuite* inSuite, void* aContext)
+{
+    TestContext& lContext = *static_cast<TestContext*>(aContext);
+    Layer& lSys = *lContext.mLayer;
+    PipeWatchState lState;
+    IOWatch lWatch;
+    int lPipeFDs[2];
+    Error lError;
+
+    NL_TEST_ASSERT(inSuite, ::pipe(lPipeFDs) == 0);
+
+    lState.mReadFD = lPipeFDs[0];
+    lState.mNumHandled = 0;
+    lState.mInterest = 0;
+    lState.mLastEvents = 0;
+
+    // Watch the write end of the pipe, which is always writable.
+    lWatch.Init(PreparePipeWatch, HandlePipeWatch, &lState);
+
+    lError = lSys.RegisterIO(lWatch, lPipeFDs[1]);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+
+    // Writability the owner is not interested in is neither dispatched nor cuts the sleep short.
+    lError = lSys.ServiceEvents(0);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 0);
+
+    const uint64_t lStart = Layer::GetClock_MonotonicMS();
+
+    lError = lSys.ServiceEvents(50);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 0);
+    NL_TEST_ASSERT(inSuite, Layer::GetClock_MonotonicMS() - lStart >= 40);
+
+    // Once the owner announces its interest, the descriptor is dispatched as writable.
+    lState.mInterest = IOWatch::kEvent_Write;
+    lSys.UpdateIO(lWatch);
+
+    lError = lSys.ServiceEvents(1000);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 1);
+    NL_TEST_ASSERT(inSuite, lState.mLastEvents == IOWatch::kEvent_Write);
+
+    // The handler dropped its interest, so the descriptor is disarmed again.
+    lError = lSys.ServiceEvents(0);
+    NL_TEST_ASSERT(inSuite, lError == WEAVE_SYSTEM_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, lState.mNumHandled == 1);
+
+    lSys.UnregisterIO(lWatch);
+
+    ::close(lPipeFDs[0]);
+    ::close(lPipeFDs[1]);
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
+
 
 // Test Suite
 
@@ -198,6 +509,14 @@ static void CheckStarvation(nlTestSuite* inSuite, void* aContext)
 static const nlTest sTests[] = {
     NL_TEST_DEF("Timer::TestOverflow",             CheckOverflow),
     NL_TEST_DEF("Timer::TestTimerStarvation",      CheckStarvation),
+    NL_TEST_DEF("Timer::TestOrdering",             CheckOrdering),
+    NL_TEST_DEF("Timer::TestRestart",              CheckRestart),
+    NL_TEST_DEF("Timer::TestCancelWork",           CheckCancelWork),
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    NL_TEST_DEF("Timer::TestServiceEvents",        CheckServiceEventsTimer),
+    NL_TEST_DEF("IOWatch::TestReadiness",          CheckIOWatch),
+    NL_TEST_DEF("IOWatch::TestInterest",           CheckIOWatchInterest),
+#endif // WEAVE_SYSTEM_CONFIG_USE_EPOLL
     NL_TEST_SENTINEL()
 };
 
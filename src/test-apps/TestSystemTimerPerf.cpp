@@ -0,0 +1,202 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    Copyright (c) 2016-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This is a microbenchmark for <tt>nl::Weave::System::Timer</tt>. It
+ *      compares the cost of starting and cancelling a large number of
+ *      concurrent timers in the timer wheel of the Weave System Layer
+ *      against the sorted linked list of timers that the wheel replaced.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <SystemLayer/SystemLayer.h>
+#include <SystemLayer/SystemTimer.h>
+
+#include <Weave/Support/ErrorStr.h>
+
+using nl::ErrorStr;
+using namespace nl::Weave::System;
+
+#define NUM_TIMERS          10000
+#define MAX_DELAY_MS        (10 * 60 * 1000)
+
+/**
+ *  A timer of the sorted list, reduced to the state used by its start and cancel algorithms.
+ */
+struct ListTimer
+{
+    Timer::Epoch mAwakenEpoch;
+    ListTimer* mNextTimer;
+};
+
+static ListTimer* sTimerList;
+static ListTimer sListTimers[NUM_TIMERS];
+
+static ObjectPool<Timer, NUM_TIMERS> sTimerPool;
+static Timer* sWheelTimers[NUM_TIMERS];
+
+static uint32_t sDelays[NUM_TIMERS];
+static size_t sCancelOrder[NUM_TIMERS];
+
+// Insert into the list, earliest timer first, as Timer::Start did.
+static void ListStart(ListTimer& aTimer, uint32_t aDelayMilliseconds)
+{
+    aTimer.mAwakenEpoch = Timer::GetCurrentEpoch() + static_cast<Timer::Epoch>(aDelayMilliseconds);
+
+    if (sTimerList == NULL || Timer::IsEarlierEpoch(aTimer.mAwakenEpoch, sTimerList->mAwakenEpoch))
+    {
+        aTimer.mNextTimer = sTimerList;
+        sTimerList = &aTimer;
+    }
+    else
+    {
+        ListTimer* lTimer = sTimerList;
+
+        while (lTimer->mNextTimer)
+        {
+            if (Timer::IsEarlierEpoch(aTimer.mAwakenEpoch, lTimer->mNextTimer->mAwakenEpoch))
+                break;
+
+            lTimer = lTimer->mNextTimer;
+        }
+
+        aTimer.mNextTimer = lTimer->mNextTimer;
+        lTimer->mNextTimer = &aTimer;
+    }
+}
+
+// Remove from the list, as Timer::Cancel did.
+static void ListCancel(ListTimer& aTimer)
+{
+    if (&aTimer == sTimerList)
+    {
+        sTimerList = aTimer.mNextTimer;
+    }
+    else
+    {
+        ListTimer* lTimer = sTimerList;
+
+        while (lTimer->mNextTimer)
+        {
+            if (&aTimer == lTimer->mNextTimer)
+            {
+                lTimer->mNextTimer = aTimer.mNextTimer;
+                break;
+            }
+
+            lTimer = lTimer->mNextTimer;
+        }
+    }
+
+    aTimer.mNextTimer = NULL;
+}
+
+static void HandleTimer(Layer* aLayer, void* aAppState, Error aError)
+{
+}
+
+static void Report(const char* aName, uint64_t aStartMicroseconds, uint64_t aEndMicroseconds)
+{
+    const uint64_t kElapsed = aEndMicroseconds - aStartMicroseconds;
+
+    printf("%-24s %10" PRIu64 " us %10.1f ns/timer\n", aName, kElapsed, (kElapsed * 1000.0) / NUM_TIMERS);
+}
+
+int main(int argc, char *argv[])
+{
+    static Layer sLayer;
+    uint64_t lStart, lStarted, lCancelled;
+    Error lError;
+
+    srand(1);
+
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+    {
+        sDelays[i] = static_cast<uint32_t>(rand()) % MAX_DELAY_MS;
+        sCancelOrder[i] = i;
+    }
+
+    for (size_t i = NUM_TIMERS - 1; i > 0; i--)
+    {
+        const size_t j = static_cast<size_t>(rand()) % (i + 1);
+        const size_t lTemp = sCancelOrder[i];
+
+        sCancelOrder[i] = sCancelOrder[j];
+        sCancelOrder[j] = lTemp;
+    }
+
+    lError = sLayer.Init(NULL);
+    if (lError != WEAVE_SYSTEM_NO_ERROR)
+    {
+        printf("Layer::Init failed: %s\n", ErrorStr(lError));
+        return EXIT_FAILURE;
+    }
+
+    // Keep an extra retention on each timer so that cancelling it does not return it to the pool.
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+    {
+        sWheelTimers[i] = sTimerPool.TryCreate(sLayer);
+        sWheelTimers[i]->Retain();
+    }
+
+    printf("%u concurrent timers, delays up to %u ms\n", NUM_TIMERS, MAX_DELAY_MS);
+
+    lStart = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+        ListStart(sListTimers[i], sDelays[i]);
+    lStarted = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+        ListCancel(sListTimers[sCancelOrder[i]]);
+    lCancelled = Layer::GetClock_MonotonicHiRes();
+
+    Report("list: start", lStart, lStarted);
+    Report("list: cancel", lStarted, lCancelled);
+
+    lStart = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+        sWheelTimers[i]->Start(sDelays[i], HandleTimer, &sDelays[i]);
+    lStarted = Layer::GetClock_MonotonicHiRes();
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+        sLayer.CancelTimer(HandleTimer, &sDelays[sCancelOrder[i]]);
+    lCancelled = Layer::GetClock_MonotonicHiRes();
+
+    Report("wheel: start", lStart, lStarted);
+    Report("wheel: cancel", lStarted, lCancelled);
+
+    for (size_t i = 0; i < NUM_TIMERS; i++)
+        sWheelTimers[i]->Release();
+
+    sLayer.Shutdown();
+
+    return EXIT_SUCCESS;
+}
@@ -35,6 +35,7 @@
 #include <Weave/Core/WeaveTLVData.hpp>
 #include <Weave/Core/WeaveCircularTLVBuffer.h>
 #include <Weave/Support/RandUtils.h>
+#include <Weave/Support/SerializationUtils.h>
 
 #include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
 #include <Weave/Profiles/data-management/DataManagement.h>
@@ -85,6 +86,28 @@ static System::Error GetClock_RealTime(uint64_t & curTime)
 
 } // namespace Private
 
+namespace nl {
+namespace Weave {
+
+class NL_DLL_EXPORT WeaveMessageLayerTestObject
+{
+public:
+    WeaveMessageLayer *msgLayer;
+
+    WEAVE_ERROR EncodeMessageWithLength(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, WeaveConnection *con, uint16_t maxLen)
+    {
+        return msgLayer->EncodeMessageWithLength(msgInfo, msgBuf, con, maxLen);
+    }
+
+    WEAVE_ERROR DecodeChainedMessageWithLength(PacketBuffer *&msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
+            WeaveMessageInfo *msgInfo, PacketBuffer **rPayload, uint32_t *rFrameLen)
+    {
+        return msgLayer->DecodeChainedMessageWithLength(msgBuf, sourceNodeId, con, msgInfo, rPayload, rFrameLen);
+    }
+};
+
+} // namespace Weave
+} // namespace nl
 
 namespace nl {
 namespace Weave {
@@ -116,6 +139,8 @@ SubscriptionEngine * SubscriptionEngine::GetInstance()
 
 static void CheckDataSourceEmptySchema(nlTestSuite *inSuite, void *inContext);
 static void CheckDataSinkEmptySchema(nlTestSuite *inSuite, void *inContext);
+static void CheckDataSourceStructure(nlTestSuite *inSuite, void *inContext);
+static void CheckDataSourceStructureWithArray(nlTestSuite *inSuite, void *inContext);
 
 static void TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite, void *inContext);
 static void TestTdmStatic_SingleLevelMerge(nlTestSuite *inSuite, void *inContext);
@@ -161,6 +186,18 @@ static void TestTdmDictionary_DeleteEntryTwice(nlTestSuite *inSuite, void *inCon
 static void TestRandomizedDataVersions(nlTestSuite *inSuite, void *inContext);
 
 static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_DataElementCache(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_SchemaTreeInfo(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_ChainedNotify(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_ChainedNotifyEndToEnd(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_ReadyQueue(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_NotifyCoalescing(nlTestSuite *inSuite, void *inContext);
+static void TestTdmStatic_DirtyTraitInfoCount(nlTestSuite *inSuite, void *inContext);
+static void TestTdmBitmapSolver_Leaves(nlTestSuite *inSuite, void *inContext);
+static void TestTdmBitmapSolver_Dictionary(nlTestSuite *inSuite, void *inContext);
+static void TestTdmBitmapSolver_DictionaryOverflow(nlTestSuite *inSuite, void *inContext);
+static void TestTdmBitmapSolver_TwoSubscriptions(nlTestSuite *inSuite, void *inContext);
+static void TestTdmBitmapSolver_ReusedTraitInstance(nlTestSuite *inSuite, void *inContext);
 static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite, void *inContext);
 
 // Test Suite
@@ -171,6 +208,8 @@ static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite,
 static const nlTest sTests[] = {
     NL_TEST_DEF("Test TraitDataSource + schema with no properties",  CheckDataSourceEmptySchema),
     NL_TEST_DEF("Test TraitDataSink + schema with no properties",    CheckDataSinkEmptySchema),
+    NL_TEST_DEF("Test TraitDataSource + structure binding",          CheckDataSourceStructure),
+    NL_TEST_DEF("Test TraitDataSource + structure binding with array", CheckDataSourceStructureWithArray),
 
     // Tests the static schema portions of TDM
     NL_TEST_DEF("Test Tdm (Static schema): Single leaf handle", TestTdmStatic_SingleLeafHandle),
@@ -224,6 +263,21 @@ static const nlTest sTests[] = {
 
     NL_TEST_DEF("Test Tdm (Multi Instance): Multi Instance", TestTdmStatic_MultiInstance),
 
+    NL_TEST_DEF("Test Tdm (Static schema): Data element cache", TestTdmStatic_DataElementCache),
+    NL_TEST_DEF("Test Tdm (Static schema): Schema tree info", TestTdmStatic_SchemaTreeInfo),
+    NL_TEST_DEF("Test Tdm (Static schema): Chained notify", TestTdmStatic_ChainedNotify),
+    NL_TEST_DEF("Test Tdm (Static schema): Chained notify end to end", TestTdmStatic_ChainedNotifyEndToEnd),
+    NL_TEST_DEF("Test Tdm (Static schema): Ready queue", TestTdmStatic_ReadyQueue),
+    NL_TEST_DEF("Test Tdm (Static schema): Notify coalescing", TestTdmStatic_NotifyCoalescing),
+    NL_TEST_DEF("Test Tdm (Static schema): Dirty trait instance count", TestTdmStatic_DirtyTraitInfoCount),
+
+    // Tests the bitmap graph solver, regardless of the solver the notification engine is built with
+    NL_TEST_DEF("Test Tdm (Bitmap solver): Leaf handles", TestTdmBitmapSolver_Leaves),
+    NL_TEST_DEF("Test Tdm (Bitmap solver): Addition of one entry, deletion of another", TestTdmBitmapSolver_Dictionary),
+    NL_TEST_DEF("Test Tdm (Bitmap solver): Overflow of dictionary items", TestTdmBitmapSolver_DictionaryOverflow),
+    NL_TEST_DEF("Test Tdm (Bitmap solver): Subscriptions are cleared independently", TestTdmBitmapSolver_TwoSubscriptions),
+    NL_TEST_DEF("Test Tdm (Bitmap solver): Reused trait instance starts clean", TestTdmBitmapSolver_ReusedTraitInstance),
+
     // Tests the allocation of buffer for building and sending Notifies and
     // Updates.
     NL_TEST_DEF("Test Allocate Right Sized Buffer", CheckAllocateRightSizedBufferForNotifications),
@@ -388,6 +442,380 @@ exit:
     return;
 }
 
+//
+// State of the test_c_trait held in a single structure, along with the field descriptors code-gen emits for it.
+//
+struct TestCTraitState
+{
+    bool tcA;
+    int32_t tcB;
+    Schema::Nest::Test::Trait::TestCTrait::StructC tcC;
+    uint32_t tcD;
+};
+
+static const nl::FieldDescriptor TestCTraitStateFieldDescriptors[] =
+{
+    { NULL, offsetof(TestCTraitState, tcA), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeBoolean, 0), 1 },
+    { NULL, offsetof(TestCTraitState, tcB), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeInt32, 0), 2 },
+    { &Schema::Nest::Test::Trait::TestCTrait::StructC::FieldSchema, offsetof(TestCTraitState, tcC), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeStructure, 0), 3 },
+    { NULL, offsetof(TestCTraitState, tcD), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 4 },
+};
+
+static const nl::SchemaFieldDescriptor TestCTraitStateFieldSchema =
+{
+    sizeof(TestCTraitStateFieldDescriptors) / sizeof(TestCTraitStateFieldDescriptors[0]),
+    TestCTraitStateFieldDescriptors,
+    sizeof(TestCTraitState)
+};
+
+// Same as above, but with the context tag of tc_d wrong.
+static const nl::FieldDescriptor TestCTraitStateBadTagFieldDescriptors[] =
+{
+    { NULL, offsetof(TestCTraitState, tcA), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeBoolean, 0), 1 },
+    { NULL, offsetof(TestCTraitState, tcB), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeInt32, 0), 2 },
+    { &Schema::Nest::Test::Trait::TestCTrait::StructC::FieldSchema, offsetof(TestCTraitState, tcC), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeStructure, 0), 3 },
+    { NULL, offsetof(TestCTraitState, tcD), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 5 },
+};
+
+static const nl::SchemaFieldDescriptor TestCTraitStateBadTagFieldSchema =
+{
+    sizeof(TestCTraitStateBadTagFieldDescriptors) / sizeof(TestCTraitStateBadTagFieldDescriptors[0]),
+    TestCTraitStateBadTagFieldDescriptors,
+    sizeof(TestCTraitState)
+};
+
+// Same as above, but with the structure tc_c described as a leaf.
+static const nl::FieldDescriptor TestCTraitStateBadTypeFieldDescriptors[] =
+{
+    { NULL, offsetof(TestCTraitState, tcA), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeBoolean, 0), 1 },
+    { NULL, offsetof(TestCTraitState, tcB), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeInt32, 0), 2 },
+    { NULL, offsetof(TestCTraitState, tcC), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 3 },
+    { NULL, offsetof(TestCTraitState, tcD), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 4 },
+};
+
+static const nl::SchemaFieldDescriptor TestCTraitStateBadTypeFieldSchema =
+{
+    sizeof(TestCTraitStateBadTypeFieldDescriptors) / sizeof(TestCTraitStateBadTypeFieldDescriptors[0]),
+    TestCTraitStateBadTypeFieldDescriptors,
+    sizeof(TestCTraitState)
+};
+
+// Same as above, but missing tc_d.
+static const nl::SchemaFieldDescriptor TestCTraitStateShortFieldSchema =
+{
+    sizeof(TestCTraitStateFieldDescriptors) / sizeof(TestCTraitStateFieldDescriptors[0]) - 1,
+    TestCTraitStateFieldDescriptors,
+    sizeof(TestCTraitState)
+};
+
+class TestCTraitStructureDataSource : public TraitDataSource {
+public:
+    TestCTraitStructureDataSource(bool aBindStructure);
+
+    WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter);
+
+    TestCTraitState mState;
+    bool mGetLeafDataCalled;
+    WEAVE_ERROR mBindError;
+};
+
+TestCTraitStructureDataSource::TestCTraitStructureDataSource(bool aBindStructure)
+    : TraitDataSource(&Schema::Nest::Test::Trait::TestCTrait::TraitSchema)
+{
+    mState.tcA = true;
+    mState.tcB = Schema::Nest::Test::Trait::TestCTrait::ENUM_C_VALUE_2;
+    mState.tcC.scA = 70000;
+    mState.tcC.scB = false;
+    mState.tcD = 17;
+    mGetLeafDataCalled = false;
+    mBindError = WEAVE_NO_ERROR;
+
+    if (aBindStructure)
+    {
+        mBindError = BindStructure(&mState, &TestCTraitStateFieldSchema);
+    }
+}
+
+WEAVE_ERROR TestCTraitStructureDataSource::GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter)
+{
+    mGetLeafDataCalled = true;
+
+    switch (aLeafHandle)
+    {
+        case Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcA:
+            return aWriter.PutBoolean(aTagToWrite, mState.tcA);
+        case Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcB:
+            return aWriter.Put(aTagToWrite, mState.tcB);
+        case Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcC_ScA:
+            return aWriter.Put(aTagToWrite, mState.tcC.scA);
+        case Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcC_ScB:
+            return aWriter.PutBoolean(aTagToWrite, mState.tcC.scB);
+        case Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcD:
+            return aWriter.Put(aTagToWrite, mState.tcD);
+        default:
+            return WEAVE_ERROR_TLV_TAG_NOT_FOUND;
+    }
+}
+
+static void CheckDataSourceStructure(nlTestSuite *inSuite, void *inContext)
+{
+    static const PropertyPathHandle handles[] =
+    {
+        kRootPropertyPathHandle,
+        Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcA,
+        Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcC,
+        Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcC_ScB,
+        Schema::Nest::Test::Trait::TestCTrait::kPropertyHandle_TcD,
+    };
+    TestCTraitStructureDataSource leafSource(false);
+    TestCTraitStructureDataSource structureSource(true);
+    const TraitSchemaEngine *schemaEngine = structureSource.GetSchemaEngine();
+
+    NL_TEST_ASSERT(inSuite, structureSource.mBindError == WEAVE_NO_ERROR);
+
+    // Descriptions that do not match the schema are refused.
+    NL_TEST_ASSERT(inSuite, leafSource.BindStructure(&leafSource.mState, &TestCTraitStateBadTagFieldSchema) == WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+    NL_TEST_ASSERT(inSuite, leafSource.BindStructure(&leafSource.mState, &TestCTraitStateBadTypeFieldSchema) == WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+    NL_TEST_ASSERT(inSuite, leafSource.BindStructure(&leafSource.mState, &TestCTraitStateShortFieldSchema) == WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+    NL_TEST_ASSERT(inSuite, leafSource.BindStructure(&leafSource.mState, NULL) == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // The structure encodes every property exactly as the per-leaf GetLeafData calls do.
+    for (size_t i = 0; i < sizeof(handles) / sizeof(handles[0]); i++)
+    {
+        uint8_t leafBuf[128];
+        uint8_t structureBuf[128];
+        TestCTraitStructureDataSource *sources[] = { &leafSource, &structureSource };
+        uint8_t *bufs[] = { leafBuf, structureBuf };
+        uint32_t lens[2];
+        uint64_t tag = (handles[i] == kRootPropertyPathHandle) ? ContextTag(DataElement::kCsTag_Data)
+                                                                : schemaEngine->GetTag(handles[i]);
+
+        for (size_t j = 0; j < 2; j++)
+        {
+            TLVWriter writer;
+            TLVType dummyContainerType;
+            WEAVE_ERROR err;
+
+            writer.Init(bufs[j], sizeof(leafBuf));
+
+            err = writer.StartContainer(AnonymousTag, kTLVType_Structure, dummyContainerType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = sources[j]->ReadData(handles[i], tag, writer);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = writer.EndContainer(dummyContainerType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = writer.Finalize();
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            lens[j] = writer.GetLengthWritten();
+        }
+
+        NL_TEST_ASSERT(inSuite, lens[0] > 2);
+        NL_TEST_ASSERT(inSuite, lens[0] == lens[1]);
+        NL_TEST_ASSERT(inSuite, memcmp(leafBuf, structureBuf, lens[0]) == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, leafSource.mGetLeafDataCalled == true);
+    NL_TEST_ASSERT(inSuite, structureSource.mGetLeafDataCalled == false);
+}
+
+// A trait with an array property between two scalar properties. Its field descriptors describe the array with two entries,
+// the array itself followed by the descriptor of its elements.
+const TraitSchemaEngine::PropertyInfo gArrayTraitPropertyMap[] = {
+    { kRootPropertyPathHandle, 1 }, // ta_a
+    { kRootPropertyPathHandle, 2 }, // ta_b
+    { kRootPropertyPathHandle, 3 }, // ta_c
+};
+
+enum
+{
+    kArrayTraitPropertyHandle_TaA = 2,
+    kArrayTraitPropertyHandle_TaB = 3,
+    kArrayTraitPropertyHandle_TaC = 4,
+};
+
+const TraitSchemaEngine gArrayTraitSchema = {
+    {
+        0x235AFFF1,
+        gArrayTraitPropertyMap,
+        sizeof(gArrayTraitPropertyMap) / sizeof(gArrayTraitPropertyMap[0]),
+        2,
+#if (TDM_EXTENSION_SUPPORT) || (TDM_VERSIONING_SUPPORT)
+        2,
+#endif
+#if (TDM_DICTIONARY_SUPPORT)
+        NULL,
+#endif
+        NULL,
+        NULL,
+        NULL,
+        NULL,
+#if (TDM_EXTENSION_SUPPORT)
+        NULL,
+#endif
+#if (TDM_VERSIONING_SUPPORT)
+        NULL,
+#endif
+    }
+};
+
+struct TestArrayTraitState
+{
+    uint32_t taA;
+    nl::SerializedFieldTypeUInt32_array taB;
+    uint32_t taC;
+};
+
+static const nl::FieldDescriptor TestArrayTraitStateFieldDescriptors[] =
+{
+    { NULL, offsetof(TestArrayTraitState, taA), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 1 },
+    { NULL, offsetof(TestArrayTraitState, taB) + offsetof(nl::SerializedFieldTypeUInt32_array, num), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeArray, 0), 2 },
+    { NULL, offsetof(TestArrayTraitState, taB) + offsetof(nl::SerializedFieldTypeUInt32_array, buf), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 2 },
+    { NULL, offsetof(TestArrayTraitState, taC), SET_TYPE_AND_FLAGS(nl::SerializedFieldTypeUInt32, 0), 3 },
+};
+
+static const nl::SchemaFieldDescriptor TestArrayTraitStateFieldSchema =
+{
+    sizeof(TestArrayTraitStateFieldDescriptors) / sizeof(TestArrayTraitStateFieldDescriptors[0]),
+    TestArrayTraitStateFieldDescriptors,
+    sizeof(TestArrayTraitState)
+};
+
+// Same as above, but missing ta_c.
+static const nl::SchemaFieldDescriptor TestArrayTraitStateShortFieldSchema =
+{
+    sizeof(TestArrayTraitStateFieldDescriptors) / sizeof(TestArrayTraitStateFieldDescriptors[0]) - 1,
+    TestArrayTraitStateFieldDescriptors,
+    sizeof(TestArrayTraitState)
+};
+
+class TestArrayTraitStructureDataSource : public TraitDataSource {
+public:
+    TestArrayTraitStructureDataSource(bool aBindStructure);
+
+    WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter);
+
+    TestArrayTraitState mState;
+    uint32_t mTaBElements[3];
+    bool mGetLeafDataCalled;
+    WEAVE_ERROR mBindError;
+};
+
+TestArrayTraitStructureDataSource::TestArrayTraitStructureDataSource(bool aBindStructure)
+    : TraitDataSource(&gArrayTraitSchema)
+{
+    mTaBElements[0] = 1;
+    mTaBElements[1] = 300;
+    mTaBElements[2] = 70000;
+    mState.taA = 5;
+    mState.taB.num = sizeof(mTaBElements) / sizeof(mTaBElements[0]);
+    mState.taB.buf = mTaBElements;
+    mState.taC = 9;
+    mGetLeafDataCalled = false;
+    mBindError = WEAVE_NO_ERROR;
+
+    if (aBindStructure)
+    {
+        mBindError = BindStructure(&mState, &TestArrayTraitStateFieldSchema);
+    }
+}
+
+WEAVE_ERROR TestArrayTraitStructureDataSource::GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TLVType containerType;
+
+    mGetLeafDataCalled = true;
+
+    switch (aLeafHandle)
+    {
+        case kArrayTraitPropertyHandle_TaA:
+            return aWriter.Put(aTagToWrite, mState.taA);
+        case kArrayTraitPropertyHandle_TaB:
+            err = aWriter.StartContainer(aTagToWrite, kTLVType_Array, containerType);
+            SuccessOrExit(err);
+
+            for (uint32_t i = 0; i < mState.taB.num; i++)
+            {
+                err = aWriter.Put(AnonymousTag, mState.taB.buf[i]);
+                SuccessOrExit(err);
+            }
+
+            err = aWriter.EndContainer(containerType);
+            break;
+        case kArrayTraitPropertyHandle_TaC:
+            return aWriter.Put(aTagToWrite, mState.taC);
+        default:
+            return WEAVE_ERROR_TLV_TAG_NOT_FOUND;
+    }
+
+exit:
+    return err;
+}
+
+static void CheckDataSourceStructureWithArray(nlTestSuite *inSuite, void *inContext)
+{
+    static const PropertyPathHandle handles[] =
+    {
+        kRootPropertyPathHandle,
+        kArrayTraitPropertyHandle_TaA,
+        kArrayTraitPropertyHandle_TaB,
+        kArrayTraitPropertyHandle_TaC,
+    };
+    TestArrayTraitStructureDataSource leafSource(false);
+    TestArrayTraitStructureDataSource structureSource(true);
+    const TraitSchemaEngine *schemaEngine = structureSource.GetSchemaEngine();
+
+    // The element descriptor of the array is not counted as a field of its own.
+    NL_TEST_ASSERT(inSuite, structureSource.mBindError == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, leafSource.BindStructure(&leafSource.mState, &TestArrayTraitStateShortFieldSchema) == WEAVE_ERROR_WDM_SCHEMA_MISMATCH);
+
+    // The structure encodes every property, the array included, exactly as the per-leaf GetLeafData calls do.
+    for (size_t i = 0; i < sizeof(handles) / sizeof(handles[0]); i++)
+    {
+        uint8_t leafBuf[128];
+        uint8_t structureBuf[128];
+        TestArrayTraitStructureDataSource *sources[] = { &leafSource, &structureSource };
+        uint8_t *bufs[] = { leafBuf, structureBuf };
+        uint32_t lens[2];
+        uint64_t tag = (handles[i] == kRootPropertyPathHandle) ? ContextTag(DataElement::kCsTag_Data)
+                                                                : schemaEngine->GetTag(handles[i]);
+
+        for (size_t j = 0; j < 2; j++)
+        {
+            TLVWriter writer;
+            TLVType dummyContainerType;
+            WEAVE_ERROR err;
+
+            writer.Init(bufs[j], sizeof(leafBuf));
+
+            err = writer.StartContainer(AnonymousTag, kTLVType_Structure, dummyContainerType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = sources[j]->ReadData(handles[i], tag, writer);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = writer.EndContainer(dummyContainerType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            err = writer.Finalize();
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            lens[j] = writer.GetLengthWritten();
+        }
+
+        NL_TEST_ASSERT(inSuite, lens[0] > 2);
+        NL_TEST_ASSERT(inSuite, lens[0] == lens[1]);
+        NL_TEST_ASSERT(inSuite, memcmp(leafBuf, structureBuf, lens[0]) == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, leafSource.mGetLeafDataCalled == true);
+    NL_TEST_ASSERT(inSuite, structureSource.mGetLeafDataCalled == false);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //
 // Testing NotificationEngine + TraitData
@@ -586,6 +1014,8 @@ private:
     std::map <PropertyPathHandle, uint32_t> mModifiedHandles;
     std::set <PropertyPathHandle> mDeletedHandles;
     std::set <PropertyPathHandle> mReplacedDictionaries;
+
+    friend class TestTdm;
 };
 
 TestTdmSink::TestTdmSink()
@@ -690,7 +1120,9 @@ public:
     int Setup();
     int Teardown();
     int Reset();
-    int BuildAndProcessNotify();
+    int BuildAndProcessNotify(NotificationEngine::BitmapGraphSolver *aSolver = NULL, SubscriptionHandler *aSubHandler = NULL);
+    SubscriptionHandler *NewTestSubscription(TraitDataHandle aDataHandle);
+    void FreeTestSubscription(SubscriptionHandler *aSubHandler, NotificationEngine::BitmapGraphSolver &aSolver);
 
     void TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite);
     void TestTdmStatic_SingleLevelMerge(nlTestSuite *inSuite);
@@ -737,6 +1169,19 @@ public:
     void TestRandomizedDataVersions(nlTestSuite *inSuite);
 
     void TestTdmStatic_MultiInstance(nlTestSuite *inSuite);
+    void TestTdmStatic_DataElementCache(nlTestSuite *inSuite);
+    void TestTdmStatic_SchemaTreeInfo(nlTestSuite *inSuite);
+    void TestTdmStatic_ChainedNotify(nlTestSuite *inSuite);
+    void TestTdmStatic_ChainedNotifyEndToEnd(nlTestSuite *inSuite);
+    void TestTdmStatic_ReadyQueue(nlTestSuite *inSuite);
+    void TestTdmStatic_NotifyCoalescing(nlTestSuite *inSuite);
+    void TestTdmStatic_DirtyTraitInfoCount(nlTestSuite *inSuite);
+
+    void TestTdmBitmapSolver_Leaves(nlTestSuite *inSuite);
+    void TestTdmBitmapSolver_Dictionary(nlTestSuite *inSuite);
+    void TestTdmBitmapSolver_DictionaryOverflow(nlTestSuite *inSuite);
+    void TestTdmBitmapSolver_TwoSubscriptions(nlTestSuite *inSuite);
+    void TestTdmBitmapSolver_ReusedTraitInstance(nlTestSuite *inSuite);
 
     void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite);
 
@@ -767,6 +1212,11 @@ private:
     uint32_t mTestCase;
 
     WEAVE_ERROR AllocateBuffer(uint32_t desiredSize, uint32_t minSize);
+
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+    WEAVE_ERROR BuildNotify(NotificationEngine::DataElementCache *aCache, uint8_t *aEncoded, uint32_t aEncodedSize,
+                            uint32_t &aEncodedLen);
+#endif
 };
 
 TestTdm::TestTdm()
@@ -902,8 +1352,9 @@ int TestTdm::Reset()
     return err;
 }
 
-int TestTdm::BuildAndProcessNotify()
+int TestTdm::BuildAndProcessNotify(NotificationEngine::BitmapGraphSolver *aSolver, SubscriptionHandler *aSubHandler)
 {
+    SubscriptionHandler *subHandler = (aSubHandler != NULL) ? aSubHandler : mSubHandler;
     bool isSubscriptionClean;
     NotificationEngine::NotifyRequestBuilder notifyRequest;
     NotificationRequest::Parser notify;
@@ -916,16 +1367,39 @@ int TestTdm::BuildAndProcessNotify()
     uint32_t maxNotificationSize = 0;
     uint32_t maxPayloadSize = 0;
 
-    maxNotificationSize = mSubHandler->GetMaxNotificationSize();
+    maxNotificationSize = subHandler->GetMaxNotificationSize();
 
-    err = mSubHandler->mBinding->AllocateRightSizedBuffer(buf, maxNotificationSize, WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
+    err = subHandler->mBinding->AllocateRightSizedBuffer(buf, maxNotificationSize, WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
     SuccessOrExit(err);
 
-    err = notifyRequest.Init(buf, &writer, mSubHandler, maxPayloadSize);
+    err = notifyRequest.Init(buf, &writer, subHandler, maxPayloadSize);
     SuccessOrExit(err);
 
-    err = mNotificationEngine->BuildSingleNotifyRequestDataList(mSubHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
-    SuccessOrExit(err);
+    if (aSolver == NULL)
+    {
+        err = mNotificationEngine->BuildSingleNotifyRequestDataList(subHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
+        SuccessOrExit(err);
+    }
+    else
+    {
+        // Drive the given solver the way BuildSingleNotifyRequestDataList drives the engine's own.
+        SubscriptionHandler::TraitInstanceInfo *traitInfo = subHandler->GetTraitInstanceInfoList();
+
+        for (size_t i = 0; i < subHandler->GetNumTraitInstances(); i++)
+        {
+            if (traitInfo[i].IsDirty())
+            {
+                err = notifyRequest.MoveToState(NotificationEngine::kNotifyRequestBuilder_BuildDataList);
+                SuccessOrExit(err);
+
+                err = aSolver->RetrieveTraitInstanceData(&notifyRequest, &traitInfo[i], false);
+                SuccessOrExit(err);
+
+                traitInfo[i].ClearDirty();
+                neWriteInProgress = true;
+            }
+        }
+    }
 
     if (neWriteInProgress)
     {
@@ -974,6 +1448,43 @@ exit:
     return err;
 }
 
+SubscriptionHandler *TestTdm::NewTestSubscription(TraitDataHandle aDataHandle)
+{
+    SubscriptionHandler *subHandler = NULL;
+    SubscriptionHandler::TraitInstanceInfo *traitInstance = NULL;
+
+    if (mSubscriptionEngine.NewSubscriptionHandler(&subHandler) != WEAVE_NO_ERROR)
+    {
+        return NULL;
+    }
+
+    // Notifies for this subscription are only ever built, never sent, so it can share the main subscription's binding.
+    subHandler->mBinding = mSubHandler->mBinding;
+
+    traitInstance = mSubscriptionEngine.mTraitInfoPool + mSubscriptionEngine.mNumTraitInfosInPool;
+    subHandler->mTraitInstanceList = traitInstance;
+    subHandler->mNumTraitInstances = 1;
+    ++(mSubscriptionEngine.mNumTraitInfosInPool);
+
+    traitInstance->Init();
+    traitInstance->mTraitDataHandle = aDataHandle;
+    traitInstance->mRequestedVersion = 1;
+
+    subHandler->MoveToState(SubscriptionHandler::kState_SubscriptionEstablished_Idle);
+
+    return subHandler;
+}
+
+void TestTdm::FreeTestSubscription(SubscriptionHandler *aSubHandler, NotificationEngine::BitmapGraphSolver &aSolver)
+{
+    // Have the given solver follow the trait instance pool the way the engine's own solver does.
+    aSolver.ReclaimTraitInstances(aSubHandler->mTraitInstanceList - mSubscriptionEngine.mTraitInfoPool, aSubHandler->mNumTraitInstances,
+                                  mSubscriptionEngine.mNumTraitInfosInPool);
+
+    mSubscriptionEngine.ReclaimTraitInfo(aSubHandler);
+    aSubHandler->InitAsFree();
+}
+
 void TestTdm::TestTdmStatic_MultiInstance(nlTestSuite *inSuite)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -1001,6 +1512,48 @@ exit:
     NL_TEST_ASSERT(inSuite, testPass);
 }
 
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+WEAVE_ERROR TestTdm::BuildNotify(NotificationEngine::DataElementCache *aCache, uint8_t *aEncoded, uint32_t aEncodedSize,
+                                 uint32_t &aEncodedLen)
+{
+    bool isSubscriptionClean;
+    NotificationEngine::NotifyRequestBuilder notifyRequest;
+    PacketBuffer *buf = NULL;
+    TLVWriter writer;
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool neWriteInProgress = false;
+    uint32_t maxPayloadSize = 0;
+
+    err = mSubHandler->mBinding->AllocateRightSizedBuffer(buf, mSubHandler->GetMaxNotificationSize(), WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
+    SuccessOrExit(err);
+
+    err = notifyRequest.Init(buf, &writer, mSubHandler, maxPayloadSize);
+    SuccessOrExit(err);
+
+    notifyRequest.SetDataElementCache(aCache);
+
+    err = mNotificationEngine->BuildSingleNotifyRequestDataList(mSubHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
+    SuccessOrExit(err);
+
+    VerifyOrExit(neWriteInProgress, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    err = notifyRequest.MoveToState(NotificationEngine::kNotifyRequestBuilder_Idle);
+    SuccessOrExit(err);
+
+    VerifyOrExit(buf->DataLength() <= aEncodedSize, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(aEncoded, buf->Start(), buf->DataLength());
+    aEncodedLen = buf->DataLength();
+
+exit:
+    if (buf) {
+        PacketBuffer::Free(buf);
+    }
+
+    return err;
+}
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
+
 void TestTdm::TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -2028,30 +2581,693 @@ exit:
     return err;
 }
 
-void TestTdm::CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite)
+void TestTdm::TestTdmStatic_DataElementCache(nlTestSuite *inSuite)
 {
+#if WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    uint32_t fakeMax = UINT16_MAX;
+    NotificationEngine::DataElementCache &cache = mNotificationEngine->mDataElementCache;
+    uint8_t encoded[3][256];
+    uint32_t encodedLen[3];
+    uint32_t hits, misses;
 
-    err = AllocateBuffer(WDM_MAX_NOTIFICATION_SIZE, WDM_MIN_NOTIFICATION_SIZE);
+    Reset();
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 2);
 
-    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    hits = cache.GetNumHits();
+    misses = cache.GetNumMisses();
 
-    err = AllocateBuffer(fakeMax, fakeMax);
+    // Build the same notify three times: without the cache, then twice through it. Re-arming the trait instance dirty bit stands
+    // in for a second subscriber being interested in the same dirty data within a single pass.
+    for (int i = 0; i < 3; i++)
+    {
+        mSubHandler->GetTraitInstanceInfoList()[0].SetDirty();
 
-    NL_TEST_ASSERT(inSuite, err != WEAVE_NO_ERROR);
-}
+        err = BuildNotify((i == 0) ? NULL : &cache, encoded[i], sizeof(encoded[i]), encodedLen[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
 
-} // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
-}
-}
+    NL_TEST_ASSERT(inSuite, cache.GetNumMisses() == misses + 1);
+    NL_TEST_ASSERT(inSuite, cache.GetNumHits() == hits + 1);
+
+    for (int i = 1; i < 3; i++)
+    {
+        NL_TEST_ASSERT(inSuite, encodedLen[i] == encodedLen[0]);
+        NL_TEST_ASSERT(inSuite, memcmp(encoded[i], encoded[0], encodedLen[0]) == 0);
+    }
+
+    cache.Reset();
+#endif // WDM_PUBLISHER_DATA_ELEMENT_CACHE_SIZE > 0
 }
 
-TestTdm *gTestTdm;
+void TestTdm::TestTdmStatic_ReadyQueue(nlTestSuite *inSuite)
+{
+    SubscriptionHandler *otherHandler = mSubscriptionEngine.mHandlers + 1;
+    uint16_t subHandlerId = mSubscriptionEngine.GetHandlerId(mSubHandler);
+    uint16_t otherHandlerId = mSubscriptionEngine.GetHandlerId(otherHandler);
+    bool subscribeToAllEvents = mSubHandler->mSubscribeToAllEvents;
+    uint64_t firstDirtyTime;
 
-/**
- *  Set up the test suite.
- */
+    Reset();
+    mNotificationEngine->Shutdown();
+    mSubHandler->mFirstDirtyTimeMsec = 0;
+
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mReadyQueueCount == 0);
+
+    // Subscriptions are queued in FIFO order, and only once no matter how often they are enqueued.
+    mNotificationEngine->EnqueueSubscription(otherHandler, false);
+    mNotificationEngine->EnqueueSubscription(mSubHandler, true);
+    mNotificationEngine->EnqueueSubscription(otherHandler, false);
+
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mReadyQueueCount == 2);
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mReadyQueue[mNotificationEngine->mReadyQueueHead] == otherHandlerId);
+    NL_TEST_ASSERT(inSuite,
+                   mNotificationEngine->mReadyQueue[(mNotificationEngine->mReadyQueueHead + 1) % WDM_MAX_NUM_SUBSCRIPTION_HANDLERS] ==
+                       subHandlerId);
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mIsReady[subHandlerId] && mNotificationEngine->mIsReady[otherHandlerId]);
+
+    // Only data changes start the coalescing window; further changes extend it but leave its start alone.
+    NL_TEST_ASSERT(inSuite, otherHandler->mFirstDirtyTimeMsec == 0);
+    NL_TEST_ASSERT(inSuite, mSubHandler->mFirstDirtyTimeMsec != 0);
+    NL_TEST_ASSERT(inSuite, mSubHandler->mLastDirtyTimeMsec == mSubHandler->mFirstDirtyTimeMsec);
+
+    firstDirtyTime = mSubHandler->mFirstDirtyTimeMsec;
+    mNotificationEngine->EnqueueSubscription(mSubHandler, true);
+
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mReadyQueueCount == 2);
+    NL_TEST_ASSERT(inSuite, mSubHandler->mFirstDirtyTimeMsec == firstDirtyTime);
+    NL_TEST_ASSERT(inSuite, mSubHandler->mLastDirtyTimeMsec >= firstDirtyTime);
+
+    // A subscription that does not want events is not picked up by the event sweep.
+    mNotificationEngine->Shutdown();
+    mSubHandler->mSubscribeToAllEvents = false;
+    mNotificationEngine->EnqueueEventSubscriptions();
+
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mReadyQueueCount == 0);
+    NL_TEST_ASSERT(inSuite, !mNotificationEngine->mIsReady[subHandlerId] && !mNotificationEngine->mIsReady[otherHandlerId]);
+
+    // The event sweep only runs once the logger has flagged a new event.
+    mNotificationEngine->mEventsLogged = false;
+    mNotificationEngine->OnEventLogged();
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->mEventsLogged);
+
+    mSubHandler->mSubscribeToAllEvents = subscribeToAllEvents;
+    mSubHandler->mFirstDirtyTimeMsec = 0;
+}
+
+void TestTdm::TestTdmStatic_DirtyTraitInfoCount(nlTestSuite *inSuite)
+{
+    SubscriptionHandler::TraitInstanceInfo *traitInfo;
+    uint16_t numDirty;
+
+    Reset();
+
+    traitInfo = mSubHandler->GetTraitInstanceInfoList();
+
+    for (size_t i = 0; i < mSubHandler->GetNumTraitInstances(); i++)
+    {
+        traitInfo[i].ClearDirty();
+    }
+
+    numDirty = mSubscriptionEngine.mNumDirtyTraitInfos;
+
+    // Only transitions between clean and dirty are counted.
+    traitInfo[0].SetDirty();
+    traitInfo[0].SetDirty();
+    traitInfo[1].SetDirty();
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumDirtyTraitInfos == numDirty + 2);
+
+    traitInfo[0].ClearDirty();
+    traitInfo[0].ClearDirty();
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumDirtyTraitInfos == numDirty + 1);
+
+    // Re-initializing a slot does not touch the count; the slot is only ever re-initialized after it has been released.
+    traitInfo[1].ClearDirty();
+    traitInfo[1].Init();
+    NL_TEST_ASSERT(inSuite, mSubscriptionEngine.mNumDirtyTraitInfos == numDirty);
+}
+
+void TestTdm::TestTdmStatic_NotifyCoalescing(nlTestSuite *inSuite)
+{
+    Reset();
+
+    mSubHandler->mMinNotifyIntervalMsec = 100;
+    mSubHandler->mMaxNotifyIntervalMsec = 300;
+
+    // Without pending data changes, the subscription is never held back.
+    mSubHandler->mFirstDirtyTimeMsec = 0;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 0);
+
+    // A single change is sent once the minimum interval has passed quietly.
+    mSubHandler->mFirstDirtyTimeMsec = 1000;
+    mSubHandler->mLastDirtyTimeMsec = 1000;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 1100);
+
+    // Each further change pushes the notify out by the minimum interval...
+    mSubHandler->mLastDirtyTimeMsec = 1150;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 1250);
+
+    // ...but never past the maximum interval after the first change.
+    mSubHandler->mLastDirtyTimeMsec = 1250;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 1300);
+
+    // Without a maximum interval, the minimum interval caps the delay as well.
+    mSubHandler->mMaxNotifyIntervalMsec = 0;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 1100);
+
+    // Without a minimum interval, nothing is coalesced.
+    mSubHandler->mMinNotifyIntervalMsec = 0;
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 0);
+
+    // Subscriptions that are still being primed are never held back.
+    mSubHandler->mMinNotifyIntervalMsec = 100;
+    mSubHandler->MoveToState(SubscriptionHandler::kState_Subscribing);
+    NL_TEST_ASSERT(inSuite, mNotificationEngine->GetNotifyDueTime(mSubHandler) == 0);
+
+    mSubHandler->mMinNotifyIntervalMsec = 0;
+    mSubHandler->mFirstDirtyTimeMsec = 0;
+    mSubHandler->mLastDirtyTimeMsec = 0;
+    Reset();
+}
+
+void TestTdm::TestTdmStatic_ChainedNotify(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t encoded[WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX];
+    uint32_t encodedLen = 0;
+    uint32_t chainedLen = 0;
+    size_t numBuffers = 0;
+
+    Reset();
+
+    // Build a notify of the whole trait twice: first into a single buffer, then into a small buffer that the builder is allowed
+    // to extend with a chain of further buffers. The encodings must match byte for byte.
+    for (int i = 0; i < 2; i++)
+    {
+        NotificationEngine::NotifyRequestBuilder notifyRequest;
+        PacketBuffer *buf = NULL;
+        TLVWriter writer;
+        bool isSubscriptionClean;
+        bool neWriteInProgress = false;
+        uint32_t maxPayloadSize = 0;
+
+        err = mNotificationEngine->mGraphSolver.SetDirty(mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle,
+                                                         kRootPropertyPathHandle);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        if (i == 0)
+        {
+            err = mSubHandler->mBinding->AllocateRightSizedBuffer(buf, mSubHandler->GetMaxNotificationSize(),
+                                                                  WDM_MIN_NOTIFICATION_SIZE, maxPayloadSize);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        }
+        else
+        {
+            // Reserve most of the buffer so that only a small head room is left for the payload, whatever the pool block size.
+            maxPayloadSize = 64;
+            buf = PacketBuffer::NewWithAvailableSize(WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX - maxPayloadSize, maxPayloadSize);
+            NL_TEST_ASSERT(inSuite, buf != NULL);
+        }
+
+        err = notifyRequest.Init(buf, &writer, mSubHandler, maxPayloadSize);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        if (i == 1)
+        {
+            notifyRequest.AllowChainedBuffers(sizeof(encoded));
+        }
+
+        err = mNotificationEngine->BuildSingleNotifyRequestDataList(mSubHandler, notifyRequest, isSubscriptionClean,
+                                                                     neWriteInProgress);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && neWriteInProgress);
+
+        err = notifyRequest.MoveToState(NotificationEngine::kNotifyRequestBuilder_Idle);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        if (i == 0)
+        {
+            NL_TEST_ASSERT(inSuite, buf->Next() == NULL);
+            memcpy(encoded, buf->Start(), buf->DataLength());
+            encodedLen = buf->DataLength();
+        }
+        else
+        {
+            for (PacketBuffer *cur = buf; cur != NULL; cur = cur->Next())
+            {
+                NL_TEST_ASSERT(inSuite, chainedLen + cur->DataLength() <= encodedLen);
+                NL_TEST_ASSERT(inSuite, memcmp(cur->Start(), encoded + chainedLen, cur->DataLength()) == 0);
+                chainedLen += cur->DataLength();
+                numBuffers++;
+            }
+
+            NL_TEST_ASSERT(inSuite, numBuffers > 1);
+            NL_TEST_ASSERT(inSuite, chainedLen == encodedLen);
+            NL_TEST_ASSERT(inSuite, buf->TotalLength() == encodedLen);
+        }
+
+        PacketBuffer::Free(buf);
+    }
+}
+
+// Copy a buffer chain into a chain of full buffers, the way framed TCP receive delivers a message longer than a buffer.
+static PacketBuffer *CopyToFullBuffers(PacketBuffer *aChain)
+{
+    PacketBuffer *head = NULL;
+    PacketBuffer *cur = NULL;
+
+    for (; aChain != NULL; aChain = aChain->Next())
+    {
+        for (uint16_t offset = 0; offset < aChain->DataLength(); )
+        {
+            uint16_t len;
+
+            if (cur == NULL || cur->AvailableDataLength() == 0)
+            {
+                cur = PacketBuffer::New(0);
+                if (cur == NULL)
+                {
+                    PacketBuffer::Free(head);
+                    return NULL;
+                }
+
+                if (head == NULL)
+                    head = cur;
+                else
+                    head->AddToEnd(cur);
+            }
+
+            len = nl::Weave::min(cur->AvailableDataLength(), static_cast<uint16_t>(aChain->DataLength() - offset));
+            memcpy(cur->Start() + cur->DataLength(), aChain->Start() + offset, len);
+            cur->SetDataLength(cur->DataLength() + len, head);
+            offset += len;
+        }
+    }
+
+    return head;
+}
+
+void TestTdm::TestTdmStatic_ChainedNotifyEndToEnd(nlTestSuite *inSuite)
+{
+    static WeaveFabricState fabricState;
+    static WeaveMessageLayer messageLayer;
+    static WeaveConnection con;
+    const uint64_t kNodeId = 0x18B4300000000001ULL;
+    const uint32_t kNumDictionaryItems = 200;
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    WeaveMessageLayerTestObject msgLayerTestObject;
+    NotificationEngine::NotifyRequestBuilder notifyRequest;
+    NotificationRequest::Parser notify;
+    TLVType dummyType1, dummyType2;
+    WeaveMessageInfo msgInfo;
+    PacketBuffer *buf = NULL;
+    PacketBuffer *received = NULL;
+    PacketBuffer *payload = NULL;
+    TLVWriter writer;
+    TLVReader reader;
+    bool isSubscriptionClean;
+    bool neWriteInProgress = false;
+    uint32_t maxPayloadSize = 0;
+    uint32_t frameLen = 0;
+
+    Reset();
+
+    // Fill a dictionary so that a notify of the whole trait no longer fits in one buffer.
+    for (uint32_t i = 0; i < kNumDictionaryItems; i++)
+    {
+        mTestTdmSource.mDictlValues[i] = { i, i + 1, i + 2 };
+    }
+
+    err = mNotificationEngine->mGraphSolver.SetDirty(mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle,
+                                                     kRootPropertyPathHandle);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Publisher: build the notify in a chain of buffers.
+    err = mSubHandler->mBinding->AllocateRightSizedBuffer(buf, mSubHandler->GetMaxNotificationSize(), WDM_MIN_NOTIFICATION_SIZE,
+                                                          maxPayloadSize);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = notifyRequest.Init(buf, &writer, mSubHandler, maxPayloadSize);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    notifyRequest.AllowChainedBuffers(UINT16_MAX / 2);
+
+    err = mNotificationEngine->BuildSingleNotifyRequestDataList(mSubHandler, notifyRequest, isSubscriptionClean, neWriteInProgress);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && neWriteInProgress);
+
+    err = notifyRequest.MoveToState(NotificationEngine::kNotifyRequestBuilder_Idle);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, buf->TotalLength() > WEAVE_SYSTEM_CONFIG_PACKETBUFFER_CAPACITY_MAX);
+
+    // Send side of the message layer: encode the notify for a connection.
+    err = fabricState.Init();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    fabricState.LocalNodeId = kNodeId;
+    messageLayer.FabricState = &fabricState;
+    msgLayerTestObject.msgLayer = &messageLayer;
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = kNodeId;
+    msgInfo.DestNodeId = kNodeId;
+    msgInfo.KeyId = WeaveKeyId::kNone;
+    msgInfo.EncryptionType = kWeaveEncryptionType_None;
+    msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+    msgInfo.Flags = kWeaveMessageFlag_SourceNodeId | kWeaveMessageFlag_DestNodeId;
+
+    err = msgLayerTestObject.EncodeMessageWithLength(&msgInfo, buf, &con, UINT16_MAX);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Receive side: the connection hands over the message in a chain of full buffers.
+    received = CopyToFullBuffers(buf);
+    NL_TEST_ASSERT(inSuite, received != NULL);
+    PacketBuffer::Free(buf);
+    buf = NULL;
+
+    msgInfo.Clear();
+    err = msgLayerTestObject.DecodeChainedMessageWithLength(received, kNodeId, &con, &msgInfo, &payload, &frameLen);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, received == NULL && payload != NULL && payload->Next() != NULL);
+
+    // Subscriber: parse the notify straight from the chain.
+    reader.Init(payload, UINT32_MAX, true);
+
+    err = reader.Next();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = notify.Init(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = notify.CheckSchemaValidity();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Skip the SubscriptionId and enter the data list.
+    err = reader.EnterContainer(dummyType1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = reader.Next();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = reader.Next();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && reader.GetType() == nl::Weave::TLV::kTLVType_Array);
+
+    err = reader.EnterContainer(dummyType2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = mSubClient->ProcessDataList(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (uint32_t i = 0; i < kNumDictionaryItems; i++)
+    {
+        NL_TEST_ASSERT(inSuite, mTestTdmSink.mModifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Da, i)] == i);
+        NL_TEST_ASSERT(inSuite, mTestTdmSink.mModifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Db, i)] == i + 1);
+        NL_TEST_ASSERT(inSuite, mTestTdmSink.mModifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Dc, i)] == i + 2);
+    }
+
+    PacketBuffer::Free(payload);
+    PacketBuffer::Free(received);
+}
+
+void TestTdm::TestTdmStatic_SchemaTreeInfo(nlTestSuite *inSuite)
+{
+    const TraitSchemaEngine *se = &TestHTrait::TraitSchema;
+    PropertyPathHandle lastHandle = CreatePropertyPathHandle(se->mSchema.mNumSchemaHandleEntries + 1);
+
+    // A copy of the schema has no tree table built for it, so an engine over the copy answers every query by scanning the
+    // handle table; the precomputed answers must match it for every handle and pair of handles.
+    const TraitSchemaEngine scanEngine = { se->mSchema };
+
+    NL_TEST_ASSERT(inSuite, se->HasTreeInfo());
+    NL_TEST_ASSERT(inSuite, !scanEngine.HasTreeInfo());
+
+    for (PropertyPathHandle handle = kRootPropertyPathHandle; handle <= lastHandle; handle++)
+    {
+        bool matches = (se->GetFirstChild(handle) == scanEngine.GetFirstChild(handle)) &&
+                       (se->GetNextChild(se->GetParent(handle), handle) == scanEngine.GetNextChild(scanEngine.GetParent(handle), handle)) &&
+                       (se->IsLeaf(handle) == scanEngine.IsLeaf(handle)) &&
+                       (se->GetDepth(handle) == scanEngine.GetDepth(handle));
+
+        for (PropertyPathHandle other = kRootPropertyPathHandle; other <= lastHandle; other++)
+        {
+            matches = matches && (se->IsParent(handle, other) == scanEngine.IsParent(handle, other)) &&
+                      (se->FindLowestCommonAncestor(handle, other, NULL, NULL) == scanEngine.FindLowestCommonAncestor(handle, other, NULL, NULL));
+        }
+
+        for (uint32_t tag = 0; tag <= UINT8_MAX; tag++)
+        {
+            matches = matches && (se->GetChildHandle(handle, static_cast<uint8_t>(tag)) == scanEngine.GetChildHandle(handle, static_cast<uint8_t>(tag)));
+        }
+
+        NL_TEST_ASSERT(inSuite, matches);
+    }
+
+    NL_TEST_ASSERT(inSuite, se->GetChildHandle(CreatePropertyPathHandle(TestHTrait::kPropertyHandle_K), 2) ==
+                            CreatePropertyPathHandle(TestHTrait::kPropertyHandle_K_Sb));
+}
+
+void TestTdm::TestTdmBitmapSolver_Leaves(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    NotificationEngine::BitmapGraphSolver solver;
+    TraitDataHandle dataHandle = mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle;
+
+    Reset();
+
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_B] = 2;
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_A] = 2;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_B);
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_A);
+
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_B, 2 }, { TestHTrait::kPropertyHandle_A, 2 } },
+                                                { },
+                                                { });
+    VerifyOrExit(testPass, );
+
+    // The next notify only carries what changed since the last one.
+    mTestTdmSink.Reset();
+
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_C] = 3;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_C);
+
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_C, 3 } },
+                                                { },
+                                                { });
+
+exit:
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+void TestTdm::TestTdmBitmapSolver_Dictionary(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    NotificationEngine::BitmapGraphSolver solver;
+    TraitDataHandle dataHandle = mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle;
+
+    Reset();
+
+    // Dictionary elements are tracked by key: the deletion and the addition are both conveyed without replacing the dictionary.
+    mTestTdmSource.mDictlValues[1] = { 1, 1, 1 };
+
+    solver.DeleteKey(dataHandle, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, 0));
+    solver.SetDirty(dataHandle, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, 1));
+
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Da, 1), 1 },
+                                                  { CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Db, 1), 1 },
+                                                  { CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Dc, 1), 1 } },
+                                                { CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, 0) },
+                                                { });
+
+exit:
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+void TestTdm::TestTdmBitmapSolver_DictionaryOverflow(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    NotificationEngine::BitmapGraphSolver solver;
+    TraitDataHandle dataHandle = mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle;
+    std::map <PropertyPathHandle, uint32_t> modifiedHandles;
+
+    Reset();
+
+    // Adding one more element than can be tracked by key results in the dictionary being replaced.
+    for (uint16_t key = 0; key <= WDM_PUBLISHER_BITMAP_SOLVER_MAX_DICTIONARY_ITEMS; key++)
+    {
+        mTestTdmSource.mDictlValues[key] = { 1, 1, 1 };
+        solver.SetDirty(dataHandle, CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value, key));
+
+        modifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Da, key)] = 1;
+        modifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Db, key)] = 1;
+        modifiedHandles[CreatePropertyPathHandle(TestHTrait::kPropertyHandle_L_Value_Dc, key)] = 1;
+    }
+
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets(modifiedHandles,
+                                                { },
+                                                { TestHTrait::kPropertyHandle_L });
+
+exit:
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+void TestTdm::TestTdmBitmapSolver_TwoSubscriptions(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    NotificationEngine::BitmapGraphSolver solver;
+    TraitDataHandle dataHandle = mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle;
+    SubscriptionHandler *otherSubHandler = NULL;
+
+    Reset();
+
+    otherSubHandler = NewTestSubscription(dataHandle);
+    VerifyOrExit(otherSubHandler != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_A] = 2;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_A);
+
+    NL_TEST_ASSERT(inSuite, mSubHandler->GetTraitInstanceInfoList()[0].IsDirty());
+    NL_TEST_ASSERT(inSuite, otherSubHandler->GetTraitInstanceInfoList()[0].IsDirty());
+
+    // Generating the notify for one subscription leaves the other one dirty.
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 2 } },
+                                                { },
+                                                { });
+    VerifyOrExit(testPass, );
+
+    NL_TEST_ASSERT(inSuite, !mSubHandler->GetTraitInstanceInfoList()[0].IsDirty());
+    NL_TEST_ASSERT(inSuite, otherSubHandler->GetTraitInstanceInfoList()[0].IsDirty());
+
+    // A further change starts over for the subscription that is up to date, and adds to what is pending for the other one.
+    mTestTdmSink.Reset();
+
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_B] = 3;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_B);
+
+    err = BuildAndProcessNotify(&solver);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_B, 3 } },
+                                                { },
+                                                { });
+    VerifyOrExit(testPass, );
+
+    mTestTdmSink.Reset();
+
+    err = BuildAndProcessNotify(&solver, otherSubHandler);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 2 }, { TestHTrait::kPropertyHandle_B, 3 } },
+                                                { },
+                                                { });
+
+    NL_TEST_ASSERT(inSuite, !otherSubHandler->GetTraitInstanceInfoList()[0].IsDirty());
+
+exit:
+    if (otherSubHandler != NULL)
+    {
+        FreeTestSubscription(otherSubHandler, solver);
+    }
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+void TestTdm::TestTdmBitmapSolver_ReusedTraitInstance(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool testPass = false;
+    NotificationEngine::BitmapGraphSolver solver;
+    TraitDataHandle dataHandle = mSubHandler->GetTraitInstanceInfoList()[0].mTraitDataHandle;
+    SubscriptionHandler *subHandler = NULL;
+    SubscriptionHandler *reusedSubHandler = NULL;
+    SubscriptionHandler::TraitInstanceInfo *traitInfo = NULL;
+
+    Reset();
+
+    subHandler = NewTestSubscription(dataHandle);
+    VerifyOrExit(subHandler != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    traitInfo = subHandler->GetTraitInstanceInfoList();
+
+    // The subscription goes away with a change still pending.
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_B] = 2;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_B);
+
+    FreeTestSubscription(subHandler, solver);
+
+    reusedSubHandler = NewTestSubscription(dataHandle);
+    VerifyOrExit(reusedSubHandler != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    NL_TEST_ASSERT(inSuite, reusedSubHandler == subHandler);
+    NL_TEST_ASSERT(inSuite, reusedSubHandler->GetTraitInstanceInfoList() == traitInfo);
+    NL_TEST_ASSERT(inSuite, !traitInfo->IsDirty());
+
+    // The new subscription's trait instance is marked dirty before the solver sees a change for it, as when the subscription is
+    // primed; none of the changes pending for the previous subscription carry over.
+    traitInfo->SetDirty();
+
+    mTestTdmSource.mValues[TestHTrait::kPropertyHandle_A] = 3;
+    solver.SetDirty(dataHandle, TestHTrait::kPropertyHandle_A);
+
+    err = BuildAndProcessNotify(&solver, reusedSubHandler);
+    SuccessOrExit(err);
+
+    testPass = mTestTdmSink.ValidateChangeSets( { { TestHTrait::kPropertyHandle_A, 3 } },
+                                                { },
+                                                { });
+
+exit:
+    if (reusedSubHandler != NULL)
+    {
+        FreeTestSubscription(reusedSubHandler, solver);
+    }
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, testPass);
+}
+
+void TestTdm::CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint32_t fakeMax = UINT16_MAX;
+
+    err = AllocateBuffer(WDM_MAX_NOTIFICATION_SIZE, WDM_MIN_NOTIFICATION_SIZE);
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = AllocateBuffer(fakeMax, fakeMax);
+
+    NL_TEST_ASSERT(inSuite, err != WEAVE_NO_ERROR);
+}
+
+} // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+}
+}
+}
+
+TestTdm *gTestTdm;
+
+/**
+ *  Set up the test suite.
+ */
 static int TestSetup(void *inContext)
 {
     static TestTdm testTdm;
@@ -2252,6 +3468,66 @@ static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext)
     gTestTdm->TestTdmStatic_MultiInstance(inSuite);
 }
 
+static void TestTdmStatic_DataElementCache(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_DataElementCache(inSuite);
+}
+
+static void TestTdmStatic_SchemaTreeInfo(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_SchemaTreeInfo(inSuite);
+}
+
+static void TestTdmStatic_ChainedNotify(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_ChainedNotify(inSuite);
+}
+
+static void TestTdmStatic_ChainedNotifyEndToEnd(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_ChainedNotifyEndToEnd(inSuite);
+}
+
+static void TestTdmStatic_ReadyQueue(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_ReadyQueue(inSuite);
+}
+
+static void TestTdmStatic_NotifyCoalescing(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_NotifyCoalescing(inSuite);
+}
+
+static void TestTdmStatic_DirtyTraitInfoCount(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmStatic_DirtyTraitInfoCount(inSuite);
+}
+
+static void TestTdmBitmapSolver_Leaves(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmBitmapSolver_Leaves(inSuite);
+}
+
+static void TestTdmBitmapSolver_Dictionary(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmBitmapSolver_Dictionary(inSuite);
+}
+
+static void TestTdmBitmapSolver_DictionaryOverflow(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmBitmapSolver_DictionaryOverflow(inSuite);
+}
+
+static void TestTdmBitmapSolver_TwoSubscriptions(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmBitmapSolver_TwoSubscriptions(inSuite);
+}
+
+static void TestTdmBitmapSolver_ReusedTraitInstance(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmBitmapSolver_ReusedTraitInstance(inSuite);
+}
+
 static void CheckAllocateRightSizedBufferForNotifications(nlTestSuite *inSuite, void *inContext)
 {
     gTestTdm->CheckAllocateRightSizedBufferForNotifications(inSuite);
@@ -1583,6 +1583,116 @@ void CheckWeaveTLVEmptyFind(nlTestSuite *inSuite, void *inContext)
     NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
 }
 
+void CheckWeaveTLVIndex(nlTestSuite *inSuite, void *inContext)
+{
+    uint8_t buf[2048];
+    TLVWriter writer;
+    TLVReader reader;
+    TLVReader elemReader;
+    TLVType outerContainerType;
+    TLVIndexEntry index[8];
+    size_t numEntries;
+    WEAVE_ERROR err;
+
+    writer.Init(buf, sizeof(buf));
+    writer.ImplicitProfileId = TestProfile_2;
+
+    WriteEncoding1(inSuite, writer);
+
+    reader.Init(buf, writer.GetLengthWritten());
+    reader.ImplicitProfileId = TestProfile_2;
+
+    TestNext<TLVReader>(inSuite, reader);
+
+    err = reader.EnterContainer(outerContainerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // An index too small to hold the members of the container
+    err = reader.BuildIndex(index, 3, numEntries);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    err = reader.BuildIndex(index, 8, numEntries);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, numEntries == 6);
+
+    // Look up the members out of order
+    err = reader.FindIndexedElement(index, numEntries, ProfileTag(TestProfile_2, 65536), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    TestGet<TLVReader, double>(inSuite, elemReader, kTLVType_FloatingPointNumber, ProfileTag(TestProfile_2, 65536), (double)17.9);
+    TestEnd<TLVReader>(inSuite, elemReader);
+
+    err = reader.FindIndexedElement(index, numEntries, ProfileTag(TestProfile_1, 5), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    TestString(inSuite, elemReader, ProfileTag(TestProfile_1, 5), "This is a test");
+
+    err = reader.FindIndexedElement(index, numEntries, ProfileTag(TestProfile_2, 2), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    TestGet<TLVReader, bool>(inSuite, elemReader, kTLVType_Boolean, ProfileTag(TestProfile_2, 2), false);
+
+    err = reader.FindIndexedElement(index, numEntries, ContextTag(0), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    {
+        TLVType outerContainerType2;
+
+        TestAndEnterContainer<TLVReader>(inSuite, elemReader, kTLVType_Array, ContextTag(0), outerContainerType2);
+
+        TestNext<TLVReader>(inSuite, elemReader);
+        TestGet<TLVReader, int8_t>(inSuite, elemReader, kTLVType_SignedInteger, AnonymousTag, 42);
+
+        TestNext<TLVReader>(inSuite, elemReader);
+        TestGet<TLVReader, int8_t>(inSuite, elemReader, kTLVType_SignedInteger, AnonymousTag, -17);
+
+        err = elemReader.ExitContainer(outerContainerType2);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+        TestNext<TLVReader>(inSuite, elemReader);
+        TestString(inSuite, elemReader, ProfileTag(TestProfile_1, 5), "This is a test");
+    }
+
+    err = reader.FindIndexedElement(index, numEntries, ContextTag(1), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+
+    // Duplicate tags resolve to the first occurrence
+    writer.Init(buf, sizeof(buf));
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, outerContainerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.Put(ContextTag(2), (uint32_t) 1);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.Put(ContextTag(1), (uint32_t) 2);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.Put(ContextTag(2), (uint32_t) 3);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.EndContainer(outerContainerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.Finalize();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    reader.Init(buf, writer.GetLengthWritten());
+
+    TestNext<TLVReader>(inSuite, reader);
+
+    err = reader.EnterContainer(outerContainerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = reader.BuildIndex(index, 8, numEntries);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, numEntries == 3);
+
+    err = reader.FindIndexedElement(index, numEntries, ContextTag(2), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    TestGet<TLVReader, uint32_t>(inSuite, elemReader, kTLVType_UnsignedInteger, ContextTag(2), 1);
+
+    err = reader.FindIndexedElement(index, numEntries, ContextTag(1), elemReader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    TestGet<TLVReader, uint32_t>(inSuite, elemReader, kTLVType_UnsignedInteger, ContextTag(1), 2);
+}
+
 uint8_t Encoding2[] =
 {
     // Container 1
@@ -3762,6 +3872,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Weave TLV Utilities",                 CheckWeaveTLVUtilities),
     NL_TEST_DEF("Weave TLV Updater",                   CheckWeaveUpdater),
     NL_TEST_DEF("Weave TLV Empty Find",                CheckWeaveTLVEmptyFind),
+    NL_TEST_DEF("Weave TLV Index",                     CheckWeaveTLVIndex),
     NL_TEST_DEF("Weave Circular TLV buffer, simple",   CheckCircularTLVBufferSimple),
     NL_TEST_DEF("Weave Circular TLV buffer, mid-buffer start", CheckCircularTLVBufferStartMidway),
     NL_TEST_DEF("Weave Circular TLV buffer, straddle", CheckCircularTLVBufferEvictStraddlingEvent),
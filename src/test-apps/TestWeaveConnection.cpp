@@ -0,0 +1,254 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *     This file implements a unit test suite for sending over a Weave
+ *     TCP connection.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include "ToolCommon.h"
+
+using namespace nl::Inet;
+using namespace nl::Weave::System;
+
+#define TOOL_NAME "TestWeaveConnection"
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gNetworkOptions,
+    &gWeaveNodeOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+#define DEFER_TEST_PORT         3300
+#define DEFER_TEST_PEER_NODE_ID 0x18B4300000000002ULL
+#define DEFER_TEST_NUM_MSGS     20
+
+TCPEndPoint *deferServerEP = NULL;
+bool deferConnected = false;
+uint32_t deferBytesReceived = 0;
+
+static void HandleDeferConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    deferConnected = (conErr == WEAVE_NO_ERROR);
+}
+
+static void HandleDeferDataReceived(TCPEndPoint *endPoint, PacketBuffer *data)
+{
+    const uint16_t len = data->TotalLength();
+
+    deferBytesReceived += len;
+
+    endPoint->AckReceive(len);
+    PacketBuffer::Free(data);
+}
+
+static void HandleDeferConnectionReceived(TCPEndPoint *listeningEndPoint, TCPEndPoint *conEndPoint, const IPAddress &peerAddr,
+                                          uint16_t peerPort)
+{
+    conEndPoint->OnDataReceived = HandleDeferDataReceived;
+    deferServerEP = conEndPoint;
+}
+
+static void ServiceNetworkOnce(void)
+{
+    struct timeval sleepTime;
+
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 10000;
+
+    ServiceNetwork(sleepTime);
+}
+
+static WEAVE_ERROR SendTestMessage(WeaveConnection *con, uint8_t aValue)
+{
+    WeaveMessageInfo msgInfo;
+    PacketBuffer *buf = PacketBuffer::New();
+
+    if (buf == NULL)
+        return WEAVE_ERROR_NO_MEMORY;
+
+    buf->Start()[0] = aValue;
+    buf->SetDataLength(1);
+
+    msgInfo.Clear();
+    msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+    msgInfo.KeyId = WeaveKeyId::kNone;
+    msgInfo.EncryptionType = kWeaveEncryptionType_None;
+
+    return con->SendMessage(&msgInfo, buf);
+}
+
+// Test that messages sent while sending is deferred are held back, then written together by FlushSending()
+static void TestDeferSending(nlTestSuite *inSuite, void *inContext)
+{
+    TCPEndPoint *listenEP = NULL;
+    WeaveConnection *con = NULL;
+    IPAddress loopback;
+    uint32_t numSendCalls;
+    uint64_t numBytesSent;
+    uint32_t queuedLen;
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    err = Inet.NewTCPEndPoint(&listenEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = listenEP->Bind(kIPAddressType_IPv6, loopback, DEFER_TEST_PORT, true);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    listenEP->OnConnectionReceived = HandleDeferConnectionReceived;
+    err = listenEP->Listen(1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    con = MessageLayer.NewConnection();
+    NL_TEST_ASSERT(inSuite, con != NULL);
+    if (con == NULL)
+    {
+        listenEP->Free();
+        return;
+    }
+
+    con->OnConnectionComplete = HandleDeferConnectionComplete;
+    err = con->Connect(DEFER_TEST_PEER_NODE_ID, kWeaveAuthMode_Unauthenticated, loopback, DEFER_TEST_PORT);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    for (int i = 0; i < 100 && !(deferConnected && deferServerEP != NULL); i++)
+        ServiceNetworkOnce();
+    NL_TEST_ASSERT(inSuite, deferConnected && deferServerEP != NULL);
+
+    // Flushing a connection that is not deferring sends nothing.
+    err = con->FlushSending();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Messages sent while deferred are queued on the end point, but not written. The event loop is not run
+    // meanwhile, as it writes whatever is queued.
+    con->DeferSending();
+
+    for (uint8_t i = 0; i < DEFER_TEST_NUM_MSGS; i++)
+    {
+        err = SendTestMessage(con, i);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    queuedLen = con->GetTCPEndPoint()->PendingSendLength();
+    NL_TEST_ASSERT(inSuite, queuedLen > DEFER_TEST_NUM_MSGS);
+
+    con->GetTCPEndPoint()->GetSendStatistics(numSendCalls, numBytesSent);
+    NL_TEST_ASSERT(inSuite, numSendCalls == 0 && numBytesSent == 0);
+
+    // Flushing writes the whole queue at once, sharing system calls between the messages.
+    err = con->FlushSending();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    con->GetTCPEndPoint()->GetSendStatistics(numSendCalls, numBytesSent);
+    NL_TEST_ASSERT(inSuite, numBytesSent == queuedLen);
+#if INET_CONFIG_TCP_SEND_MAX_IOVECS > 1
+    NL_TEST_ASSERT(inSuite, numSendCalls < DEFER_TEST_NUM_MSGS);
+#endif
+
+    for (int i = 0; i < 100 && deferBytesReceived < queuedLen; i++)
+        ServiceNetworkOnce();
+    NL_TEST_ASSERT(inSuite, deferBytesReceived == queuedLen);
+
+    // Once flushed, each message is written as it is sent.
+    err = SendTestMessage(con, DEFER_TEST_NUM_MSGS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    con->GetTCPEndPoint()->GetSendStatistics(numSendCalls, numBytesSent);
+    NL_TEST_ASSERT(inSuite, numBytesSent > queuedLen);
+
+    for (int i = 0; i < 100 && deferBytesReceived < numBytesSent; i++)
+        ServiceNetworkOnce();
+    NL_TEST_ASSERT(inSuite, deferBytesReceived == numBytesSent);
+
+    con->Close();
+    if (deferServerEP != NULL)
+        deferServerEP->Free();
+    listenEP->Free();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("WeaveConnection::TestDeferSending", TestDeferSending),
+    NL_TEST_SENTINEL()
+};
+
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, false);
+
+    return (SUCCESS);
+}
+
+static int TestTeardown(void *inContext)
+{
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    SetSIGUSR1Handler();
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    nlTestSuite theSuite = {
+        "weave-connection",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+    return 0;
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+}
@@ -0,0 +1,618 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *     This file implements a unit test suite for the Weave exchange
+ *     manager and its Weave Reliable Messaging (WRMP) scheduling.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include "ToolCommon.h"
+
+using namespace nl::Inet;
+using namespace nl::Weave::System;
+
+#define TOOL_NAME "TestWeaveExchangeMgr"
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gNetworkOptions,
+    &gWeaveNodeOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+#define TEST_PEER_NODE_ID       0x18B4300000000002ULL
+#define TEST_PEER_PORT          3301
+#define TEST_RETRANS_TIMEOUT    200
+
+namespace nl {
+namespace Weave {
+
+class NL_DLL_EXPORT WeaveExchangeManagerTestObject
+{
+public:
+    typedef WeaveExchangeManager::UnsolicitedMessageHandler UnsolicitedMessageHandler;
+
+    static size_t GetContextsInUse(WeaveExchangeManager &mgr) { return mgr.mContextsInUse; }
+    static size_t ContextIndexHash(uint16_t exchangeId, bool isInitiator) { return WeaveExchangeManager::ContextIndexHash(exchangeId, isInitiator); }
+
+    static void SetExchangeId(ExchangeContext *ec, uint16_t exchangeId)
+    {
+        const bool reindex = ec->ExchangeMgr->UnindexContext(ec);
+
+        ec->ExchangeId = exchangeId;
+
+        if (reindex)
+            ec->ExchangeMgr->IndexContext(ec);
+    }
+
+    static ExchangeContext *LookupContext(WeaveExchangeManager &mgr, const WeaveMessageInfo *msgInfo,
+                                          const WeaveExchangeHeader *exchangeHeader)
+    {
+        return mgr.LookupContext(NULL, msgInfo, exchangeHeader);
+    }
+
+    static size_t UMHIndexHash(uint32_t profileId, int16_t msgType) { return WeaveExchangeManager::UMHIndexHash(profileId, msgType); }
+
+    static UnsolicitedMessageHandler *LookupUMH(WeaveExchangeManager &mgr, uint32_t profileId, int16_t msgType)
+    {
+        return mgr.LookupUMH(profileId, msgType, NULL, false);
+    }
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    typedef WeaveExchangeManager::RetransTableEntry RetransTableEntry;
+
+    static RetransTableEntry *GetRetransTableEntry(WeaveExchangeManager &mgr, int i) { return &mgr.RetransTable[i]; }
+    static RetransTableEntry *GetRetransQueue(WeaveExchangeManager &mgr) { return mgr.mRetransQueue; }
+
+    static void ScheduleRetrans(WeaveExchangeManager &mgr, RetransTableEntry *entry, Timer::Epoch retransTime)
+    {
+        mgr.WRMPScheduleRetrans(entry, retransTime);
+    }
+
+    static void UnscheduleRetrans(WeaveExchangeManager &mgr, RetransTableEntry *entry) { mgr.WRMPUnscheduleRetrans(entry); }
+
+    static WEAVE_ERROR AddToRetransTable(WeaveExchangeManager &mgr, ExchangeContext *ec, PacketBuffer *msgBuf, uint32_t msgId,
+                                         RetransTableEntry **rEntry)
+    {
+        return mgr.AddToRetransTable(ec, msgBuf, msgId, NULL, rEntry);
+    }
+
+    static void ScheduleAck(WeaveExchangeManager &mgr, Timer::Epoch ackTime) { mgr.WRMPScheduleAck(ackTime); }
+    static bool IsAckScheduled(WeaveExchangeManager &mgr) { return mgr.mWRMPAckScheduled; }
+    static Timer::Epoch GetNextAckTime(WeaveExchangeManager &mgr) { return mgr.mWRMPNextAckTime; }
+    static void SetNextAckTime(ExchangeContext *ec, Timer::Epoch ackTime) { ec->mWRMPNextAckTime = ackTime; }
+
+    static void ExecuteActions(WeaveExchangeManager &mgr) { mgr.WRMPExecuteActions(); }
+    static void StartTimer(WeaveExchangeManager &mgr) { mgr.WRMPStartTimer(); }
+    static bool IsTimerArmed(WeaveExchangeManager &mgr) { return mgr.mWRMPTimerArmed; }
+    static Timer::Epoch GetTimerExpiry(WeaveExchangeManager &mgr) { return mgr.mWRMPCurrentTimerExpiry; }
+
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    static void UpdatePeerRTT(WeaveExchangeManager &mgr, uint64_t peerNodeId, uint32_t rtt) { mgr.WRMPUpdatePeerRTT(peerNodeId, rtt); }
+
+    static bool GetPeerRTT(WeaveExchangeManager &mgr, uint64_t peerNodeId, uint32_t &srtt, uint32_t &rttVar)
+    {
+        WeaveExchangeManager::PeerRTTEntry *entry = mgr.WRMPFindPeerRTT(peerNodeId);
+
+        if (entry == NULL)
+            return false;
+
+        srtt = entry->srtt;
+        rttVar = entry->rttVar;
+        return true;
+    }
+
+    static uint32_t GetPeerRetransTimeout(WeaveExchangeManager &mgr, uint64_t peerNodeId, uint32_t maxTimeout)
+    {
+        return mgr.WRMPGetPeerRetransTimeout(peerNodeId, maxTimeout);
+    }
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+};
+
+} // namespace Weave
+} // namespace nl
+
+#define TEST_PROFILE_ID         0x235AFFF0
+
+static void HandleTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
+                              uint8_t msgType, PacketBuffer *payload)
+{
+}
+
+static void HandleOtherTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+                                   uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+}
+
+static void HandleAnyTestMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
+                                 uint8_t msgType, PacketBuffer *payload)
+{
+}
+
+static ExchangeContext *NewIndexedContext(nlTestSuite *inSuite, uint16_t exchangeId)
+{
+    IPAddress loopback;
+    ExchangeContext *ec;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    ec = ExchangeMgr.NewContext(TEST_PEER_NODE_ID, loopback, TEST_PEER_PORT, INET_NULL_INTERFACEID, NULL);
+    NL_TEST_ASSERT(inSuite, ec != NULL);
+
+    if (ec != NULL)
+        WeaveExchangeManagerTestObject::SetExchangeId(ec, exchangeId);
+
+    return ec;
+}
+
+static ExchangeContext *LookupTestContext(uint16_t exchangeId, bool fromInitiator)
+{
+    WeaveMessageInfo msgInfo;
+    WeaveExchangeHeader exchangeHeader;
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = TEST_PEER_NODE_ID;
+    msgInfo.DestNodeId = FabricState.LocalNodeId;
+
+    memset(&exchangeHeader, 0, sizeof(exchangeHeader));
+    exchangeHeader.ExchangeId = exchangeId;
+    exchangeHeader.Flags = fromInitiator ? kWeaveExchangeFlag_Initiator : 0;
+
+    return WeaveExchangeManagerTestObject::LookupContext(ExchangeMgr, &msgInfo, &exchangeHeader);
+}
+
+static void TestContextIndex(nlTestSuite *inSuite, void *inContext)
+{
+    const uint16_t id = 0x1000;
+    const uint16_t collidingId = id + WEAVE_CONFIG_EXCHANGE_CONTEXT_HASH_SIZE;
+    ExchangeContext *ec1;
+    ExchangeContext *ec2;
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::ContextIndexHash(id, true) ==
+                                WeaveExchangeManagerTestObject::ContextIndexHash(collidingId, true));
+
+    ec1 = NewIndexedContext(inSuite, id);
+    ec2 = NewIndexedContext(inSuite, collidingId);
+
+    // Contexts that share a bucket are each found by their own exchange identifier.
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, false) == ec1);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(collidingId, false) == ec2);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id + 1, false) == NULL);
+
+    // Messages from an initiator only match exchanges the local node responds to.
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, true) == NULL);
+
+    ec1->SetInitiator(false);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, true) == ec1);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, false) == NULL);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(collidingId, false) == ec2);
+
+    ec1->SetInitiator(true);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, false) == ec1);
+
+    // Removing one context leaves the other in the bucket.
+    ec1->Close();
+    NL_TEST_ASSERT(inSuite, LookupTestContext(id, false) == NULL);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(collidingId, false) == ec2);
+
+    ec2->Close();
+    NL_TEST_ASSERT(inSuite, LookupTestContext(collidingId, false) == NULL);
+}
+
+static void TestContextFreeList(nlTestSuite *inSuite, void *inContext)
+{
+    ExchangeContext *contexts[WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS];
+    IPAddress loopback;
+    const size_t inUse = WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr);
+    size_t count = 0;
+    ExchangeContext *ec;
+
+    // The most recently freed context is the next one handed out.
+    contexts[0] = NewIndexedContext(inSuite, 0x2000);
+    contexts[1] = NewIndexedContext(inSuite, 0x2001);
+    NL_TEST_ASSERT(inSuite, contexts[0] != contexts[1]);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr) == inUse + 2);
+
+    contexts[0]->Close();
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr) == inUse + 1);
+
+    ec = NewIndexedContext(inSuite, 0x2002);
+    NL_TEST_ASSERT(inSuite, ec == contexts[0]);
+    NL_TEST_ASSERT(inSuite, ec->ExchangeMgr == &ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(0x2000, false) == NULL);
+    NL_TEST_ASSERT(inSuite, LookupTestContext(0x2002, false) == ec);
+
+    ec->Close();
+    contexts[1]->Close();
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr) == inUse);
+
+    // Every free context can be handed out once, and all of them come back.
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    for (; count < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; count++)
+    {
+        contexts[count] = ExchangeMgr.NewContext(TEST_PEER_NODE_ID, loopback, TEST_PEER_PORT, INET_NULL_INTERFACEID, NULL);
+        if (contexts[count] == NULL)
+            break;
+    }
+
+    NL_TEST_ASSERT(inSuite, count == WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS - inUse);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr) == WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS);
+
+    while (count > 0)
+        contexts[--count]->Close();
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetContextsInUse(ExchangeMgr) == inUse);
+}
+
+static void TestUnsolicitedHandlerIndex(nlTestSuite *inSuite, void *inContext)
+{
+    typedef WeaveExchangeManagerTestObject::UnsolicitedMessageHandler UnsolicitedMessageHandler;
+
+    const uint8_t msgType = 1;
+    const uint8_t collidingMsgType = msgType + WEAVE_CONFIG_UNSOLICITED_MESSAGE_HANDLER_HASH_SIZE;
+    UnsolicitedMessageHandler *umh;
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::UMHIndexHash(TEST_PROFILE_ID, msgType) ==
+                                WeaveExchangeManagerTestObject::UMHIndexHash(TEST_PROFILE_ID, collidingMsgType));
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType) == NULL);
+
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(TEST_PROFILE_ID, msgType, HandleTestMessage, NULL);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(TEST_PROFILE_ID, collidingMsgType, HandleOtherTestMessage, NULL);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Handlers that share a bucket are each found by their own message type.
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleTestMessage);
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, collidingMsgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleOtherTestMessage);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType + 1) == NULL);
+
+    // Unregistering the head of the bucket leaves the other handler reachable, and vice versa.
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType) == NULL);
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, collidingMsgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleOtherTestMessage);
+
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_NO_UNSOLICITED_MESSAGE_HANDLER);
+
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(TEST_PROFILE_ID, msgType, HandleTestMessage, NULL);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(TEST_PROFILE_ID, collidingMsgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, collidingMsgType) == NULL);
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleTestMessage);
+
+    // A handler for the whole profile catches message types without their own handler.
+    err = ExchangeMgr.RegisterUnsolicitedMessageHandler(TEST_PROFILE_ID, HandleAnyTestMessage, NULL);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleTestMessage);
+    umh = WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, collidingMsgType);
+    NL_TEST_ASSERT(inSuite, umh != NULL && umh->Handler == HandleAnyTestMessage);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID + 1, collidingMsgType) == NULL);
+
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(TEST_PROFILE_ID);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(TEST_PROFILE_ID, msgType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, msgType) == NULL);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::LookupUMH(ExchangeMgr, TEST_PROFILE_ID, collidingMsgType) == NULL);
+}
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+typedef WeaveExchangeManagerTestObject::RetransTableEntry RetransTableEntry;
+
+static WEAVE_ERROR sSendError = WEAVE_NO_ERROR;
+
+static void HandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt)
+{
+    sSendError = err;
+}
+
+static ExchangeContext *NewTestContext(nlTestSuite *inSuite)
+{
+    IPAddress loopback;
+    ExchangeContext *ec;
+
+    NL_TEST_ASSERT(inSuite, IPAddress::FromString("::1", loopback));
+
+    ec = ExchangeMgr.NewContext(TEST_PEER_NODE_ID, loopback, TEST_PEER_PORT, INET_NULL_INTERFACEID, NULL);
+    NL_TEST_ASSERT(inSuite, ec != NULL);
+
+    ec->mWRMPConfig.mInitialRetransTimeout = TEST_RETRANS_TIMEOUT;
+    ec->OnSendError = HandleSendError;
+
+    return ec;
+}
+
+static void TestRetransQueueOrdering(nlTestSuite *inSuite, void *inContext)
+{
+    RetransTableEntry *entries[4];
+    RetransTableEntry *entry;
+    const Timer::Epoch base = Timer::GetCurrentEpoch();
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr) == NULL);
+
+    for (int i = 0; i < 4; i++)
+        entries[i] = WeaveExchangeManagerTestObject::GetRetransTableEntry(ExchangeMgr, i);
+
+    // The queue is ordered by retransmission time; entries due at the same time keep the order they were scheduled in.
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entries[0], base + 300);
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entries[1], base + 100);
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entries[2], base + 200);
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entries[3], base + 100);
+
+    entry = WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, entry == entries[1]);
+    NL_TEST_ASSERT(inSuite, entry->next == entries[3]);
+    NL_TEST_ASSERT(inSuite, entry->next->next == entries[2]);
+    NL_TEST_ASSERT(inSuite, entry->next->next->next == entries[0]);
+    NL_TEST_ASSERT(inSuite, entry->next->next->next->next == NULL);
+
+    // Rescheduling moves an entry rather than queueing it twice.
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entries[1], base + 250);
+
+    entry = WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, entry == entries[3]);
+    NL_TEST_ASSERT(inSuite, entry->next == entries[2]);
+    NL_TEST_ASSERT(inSuite, entry->next->next == entries[1]);
+    NL_TEST_ASSERT(inSuite, entry->next->next->next == entries[0]);
+    NL_TEST_ASSERT(inSuite, entry->next->next->next->next == NULL);
+
+    WeaveExchangeManagerTestObject::UnscheduleRetrans(ExchangeMgr, entries[2]);
+
+    entry = WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, entry == entries[3]);
+    NL_TEST_ASSERT(inSuite, entry->next == entries[1]);
+    NL_TEST_ASSERT(inSuite, entry->next->next == entries[0]);
+    NL_TEST_ASSERT(inSuite, entries[2]->next == NULL);
+
+    for (int i = 0; i < 4; i++)
+        WeaveExchangeManagerTestObject::UnscheduleRetrans(ExchangeMgr, entries[i]);
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr) == NULL);
+}
+
+static void TestRetransmitTiming(nlTestSuite *inSuite, void *inContext)
+{
+    ExchangeContext *ec = NewTestContext(inSuite);
+    PacketBuffer *msgBuf = PacketBuffer::New();
+    RetransTableEntry *entry = NULL;
+    Timer::Epoch before, after;
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, msgBuf != NULL);
+    memset(msgBuf->Start(), 0, 16);
+    msgBuf->SetDataLength(16);
+
+    // A new entry is due one retransmission timeout from now, and the WRMP timer is armed for it.
+    before = Timer::GetCurrentEpoch();
+    err = WeaveExchangeManagerTestObject::AddToRetransTable(ExchangeMgr, ec, msgBuf, 1, &entry);
+    after = Timer::GetCurrentEpoch();
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, entry != NULL);
+    NL_TEST_ASSERT(inSuite, entry->nextRetransTime >= before + TEST_RETRANS_TIMEOUT);
+    NL_TEST_ASSERT(inSuite, entry->nextRetransTime <= after + TEST_RETRANS_TIMEOUT);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr) == entry);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::IsTimerArmed(ExchangeMgr));
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetTimerExpiry(ExchangeMgr) == entry->nextRetransTime);
+
+    // Entries that are not yet due are left alone.
+    WeaveExchangeManagerTestObject::ExecuteActions(ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, entry->sendCount == 0);
+
+    // Once due, the entry is retransmitted and requeued one retransmission timeout later.
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entry, Timer::GetCurrentEpoch());
+    before = Timer::GetCurrentEpoch();
+    WeaveExchangeManagerTestObject::ExecuteActions(ExchangeMgr);
+    WeaveExchangeManagerTestObject::StartTimer(ExchangeMgr);
+
+    NL_TEST_ASSERT(inSuite, entry->exchContext == ec);
+    NL_TEST_ASSERT(inSuite, entry->sendCount == 1);
+    NL_TEST_ASSERT(inSuite, entry->nextRetransTime >= before + TEST_RETRANS_TIMEOUT);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetTimerExpiry(ExchangeMgr) == entry->nextRetransTime);
+
+    // After the last retransmission the entry is dropped, the application is told, and the timer is stopped.
+    sSendError = WEAVE_NO_ERROR;
+    entry->sendCount = ec->mWRMPConfig.mMaxRetrans + 1;
+    WeaveExchangeManagerTestObject::ScheduleRetrans(ExchangeMgr, entry, Timer::GetCurrentEpoch());
+    WeaveExchangeManagerTestObject::ExecuteActions(ExchangeMgr);
+
+    NL_TEST_ASSERT(inSuite, sSendError == WEAVE_ERROR_MESSAGE_NOT_ACKNOWLEDGED);
+    NL_TEST_ASSERT(inSuite, entry->exchContext == NULL);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetRetransQueue(ExchangeMgr) == NULL);
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::IsTimerArmed(ExchangeMgr));
+
+    ec->Close();
+}
+
+static void TestAckTiming(nlTestSuite *inSuite, void *inContext)
+{
+    ExchangeContext *ec;
+    Timer::Epoch now = Timer::GetCurrentEpoch();
+
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::IsAckScheduled(ExchangeMgr));
+
+    // The manager only remembers the earliest pending ack, and wakes up for it.
+    WeaveExchangeManagerTestObject::ScheduleAck(ExchangeMgr, now + 500);
+    WeaveExchangeManagerTestObject::ScheduleAck(ExchangeMgr, now + 100);
+    WeaveExchangeManagerTestObject::ScheduleAck(ExchangeMgr, now + 300);
+
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::IsAckScheduled(ExchangeMgr));
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetNextAckTime(ExchangeMgr) == now + 100);
+
+    WeaveExchangeManagerTestObject::StartTimer(ExchangeMgr);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::IsTimerArmed(ExchangeMgr));
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetTimerExpiry(ExchangeMgr) == now + 100);
+
+    // An exchange whose ack is not yet due keeps it pending and has the manager wake up for it later.
+    ec = NewTestContext(inSuite);
+    now = Timer::GetCurrentEpoch();
+    WeaveExchangeManagerTestObject::SetNextAckTime(ec, now + 1000);
+    ec->SetAckPending(true);
+
+    WeaveExchangeManagerTestObject::ScheduleAck(ExchangeMgr, now);
+    WeaveExchangeManagerTestObject::ExecuteActions(ExchangeMgr);
+
+    NL_TEST_ASSERT(inSuite, ec->IsAckPending());
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::IsAckScheduled(ExchangeMgr));
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetNextAckTime(ExchangeMgr) == now + 1000);
+
+    // Once due, the ack is sent on its own.
+    WeaveExchangeManagerTestObject::SetNextAckTime(ec, now);
+    WeaveExchangeManagerTestObject::ScheduleAck(ExchangeMgr, now);
+    WeaveExchangeManagerTestObject::ExecuteActions(ExchangeMgr);
+    WeaveExchangeManagerTestObject::StartTimer(ExchangeMgr);
+
+    NL_TEST_ASSERT(inSuite, !ec->IsAckPending());
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::IsAckScheduled(ExchangeMgr));
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::IsTimerArmed(ExchangeMgr));
+
+    ec->Close();
+}
+
+static void TestPeerRTTEstimator(nlTestSuite *inSuite, void *inContext)
+{
+#if WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+    const uint64_t slowPeer = TEST_PEER_NODE_ID + 1;
+    const uint64_t fastPeer = TEST_PEER_NODE_ID + 2;
+    uint32_t srtt   = 0;
+    uint32_t rttVar = 0;
+
+    // Without an estimate, the exchange's own timeout is used.
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRetransTimeout(ExchangeMgr, slowPeer, 5000) == 5000);
+
+    // The first sample seeds SRTT = R and RTTVAR = R / 2.
+    WeaveExchangeManagerTestObject::UpdatePeerRTT(ExchangeMgr, slowPeer, 400);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRTT(ExchangeMgr, slowPeer, srtt, rttVar));
+    NL_TEST_ASSERT(inSuite, srtt == 400 && rttVar == 200);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRetransTimeout(ExchangeMgr, slowPeer, 5000) == 1200);
+
+    // Later samples update RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R| and SRTT = 7/8 SRTT + 1/8 R.
+    WeaveExchangeManagerTestObject::UpdatePeerRTT(ExchangeMgr, slowPeer, 200);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRTT(ExchangeMgr, slowPeer, srtt, rttVar));
+    NL_TEST_ASSERT(inSuite, srtt == 375 && rttVar == 200);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRetransTimeout(ExchangeMgr, slowPeer, 5000) == 1175);
+
+    // The timeout never exceeds the exchange's own timeout, nor drops below the configured minimum.
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRetransTimeout(ExchangeMgr, slowPeer, 1000) == 1000);
+
+    WeaveExchangeManagerTestObject::UpdatePeerRTT(ExchangeMgr, fastPeer, 10);
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRetransTimeout(ExchangeMgr, fastPeer, 5000) ==
+                                WEAVE_CONFIG_WRMP_MIN_RETRANS_TIMEOUT);
+
+    // Samples without a specific peer are not kept.
+    WeaveExchangeManagerTestObject::UpdatePeerRTT(ExchangeMgr, kAnyNodeId, 10);
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::GetPeerRTT(ExchangeMgr, kAnyNodeId, srtt, rttVar));
+
+    // Once the table is full, the oldest estimates make room for new peers.
+    for (uint64_t i = 0; i < WEAVE_CONFIG_WRMP_PEER_RTT_TABLE_SIZE; i++)
+        WeaveExchangeManagerTestObject::UpdatePeerRTT(ExchangeMgr, TEST_PEER_NODE_ID + 100 + i, 100);
+
+    NL_TEST_ASSERT(inSuite, !WeaveExchangeManagerTestObject::GetPeerRTT(ExchangeMgr, slowPeer, srtt, rttVar));
+    NL_TEST_ASSERT(inSuite, WeaveExchangeManagerTestObject::GetPeerRTT(ExchangeMgr, TEST_PEER_NODE_ID + 100, srtt, rttVar));
+#endif // WEAVE_CONFIG_WRMP_ADAPTIVE_RETRANS_TIMEOUT
+}
+
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("ExchangeMgr::TestContextIndex", TestContextIndex),
+    NL_TEST_DEF("ExchangeMgr::TestContextFreeList", TestContextFreeList),
+    NL_TEST_DEF("ExchangeMgr::TestUnsolicitedHandlerIndex", TestUnsolicitedHandlerIndex),
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    NL_TEST_DEF("WRMP::TestRetransQueueOrdering", TestRetransQueueOrdering),
+    NL_TEST_DEF("WRMP::TestRetransmitTiming", TestRetransmitTiming),
+    NL_TEST_DEF("WRMP::TestAckTiming", TestAckTiming),
+    NL_TEST_DEF("WRMP::TestPeerRTTEstimator", TestPeerRTTEstimator),
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    NL_TEST_SENTINEL()
+};
+
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, true);
+
+    return (SUCCESS);
+}
+
+static int TestTeardown(void *inContext)
+{
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(int argc, char *argv[])
+{
+    SetSIGUSR1Handler();
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    nlTestSuite theSuite = {
+        "weave-exchange-mgr",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
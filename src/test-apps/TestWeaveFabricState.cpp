@@ -101,6 +101,103 @@ static void CheckSelectNodeAddressWithSubnet(nlTestSuite *inSuite, void *inConte
     }
 }
 
+// Query the duplicate message state that the fabric state keeps for unencrypted UDP messages from a peer.
+static bool IsDuplicateUnencryptedMessage(nlTestSuite *inSuite, uint64_t peerNodeId, uint32_t msgId)
+{
+    WeaveSessionState sessionState;
+    WEAVE_ERROR err;
+
+    err = sFabricState.GetSessionState(peerNodeId, WeaveKeyId::kNone, kWeaveEncryptionType_None, NULL, sessionState);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    return sessionState.IsDuplicateMessage(msgId);
+}
+
+/**
+ * Test that the peer state table finds peers by node id and discards the least recently used peer when full.
+ */
+static void CheckPeerStateReplacement(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kFirstPeerNodeId = 0x18B4300000000100ULL;
+    const uint64_t kNewPeerNodeId = 0x18B4300000010000ULL;
+    const uint32_t kMsgId = 100;
+
+    // Fill the table; the first message from each peer is new, a repeat of it is a duplicate.
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        NL_TEST_ASSERT(inSuite, !IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId + i, kMsgId));
+    for (uint64_t i = 0; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        NL_TEST_ASSERT(inSuite, IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId + i, kMsgId));
+
+    // Use the first peer again, then add a new peer, which discards the second peer.
+    NL_TEST_ASSERT(inSuite, IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId, kMsgId));
+    NL_TEST_ASSERT(inSuite, !IsDuplicateUnencryptedMessage(inSuite, kNewPeerNodeId, kMsgId));
+
+    for (uint64_t i = 2; i < WEAVE_CONFIG_MAX_PEER_NODES; i++)
+        NL_TEST_ASSERT(inSuite, IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId + i, kMsgId));
+    NL_TEST_ASSERT(inSuite, IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId, kMsgId));
+
+    // The second peer starts over, discarding the new peer, which is now the least recently used.
+    NL_TEST_ASSERT(inSuite, !IsDuplicateUnencryptedMessage(inSuite, kFirstPeerNodeId + 1, kMsgId));
+    NL_TEST_ASSERT(inSuite, !IsDuplicateUnencryptedMessage(inSuite, kNewPeerNodeId, kMsgId));
+}
+
+/**
+ * Test finding, allocating and removing session keys by key id and peer node id.
+ */
+static void CheckSessionKeyLookup(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t kFirstPeerNodeId = 0x18B4300000000200ULL;
+    WeaveSessionKey *sessionKeys[WEAVE_CONFIG_MAX_SESSION_KEYS];
+    WeaveSessionKey *sessionKey;
+    WEAVE_ERROR err;
+
+    // Allocate every session key, using the same key id with different peers.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.AllocSessionKey(kFirstPeerNodeId + i, WeaveKeyId::MakeSessionKeyId(1), NULL, sessionKeys[i]);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    err = sFabricState.AllocSessionKey(kFirstPeerNodeId, WeaveKeyId::MakeSessionKeyId(2), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_TOO_MANY_KEYS);
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(1), kFirstPeerNodeId + i, sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && sessionKey == sessionKeys[i]);
+    }
+
+    err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(2), kFirstPeerNodeId, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+
+    // Remove every other key; the rest must still be found.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i += 2)
+        sFabricState.RemoveSessionKey(sessionKeys[i]);
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(1), kFirstPeerNodeId + i, sessionKey);
+        if (i % 2 == 0)
+            NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+        else
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && sessionKey == sessionKeys[i]);
+    }
+
+    // A key id already in use with a peer is rejected; a freed entry can be reused.
+    err = sFabricState.AllocSessionKey(kFirstPeerNodeId + 1, WeaveKeyId::MakeSessionKeyId(1), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_DUPLICATE_KEY_ID);
+
+    err = sFabricState.AllocSessionKey(kFirstPeerNodeId + 1, WeaveKeyId::MakeSessionKeyId(2), NULL, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = sFabricState.GetSessionKey(WeaveKeyId::MakeSessionKeyId(2), kFirstPeerNodeId + 1, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    sFabricState.RemoveSessionKey(sessionKey);
+
+    for (int i = 1; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i += 2)
+        sFabricState.RemoveSessionKey(sessionKeys[i]);
+}
+
 /**
  *  Set up the test suite.
  */
@@ -131,6 +228,8 @@ static const nlTest sTests[] =
     // more thorough collection of tests should be written.
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddress),
     NL_TEST_DEF("WeaveFabricState::SelectNodeAddress", CheckSelectNodeAddressWithSubnet),
+    NL_TEST_DEF("WeaveFabricState::PeerStateReplacement", CheckPeerStateReplacement),
+    NL_TEST_DEF("WeaveFabricState::SessionKeyLookup", CheckSessionKeyLookup),
     NL_TEST_SENTINEL()
 };
 
@@ -0,0 +1,424 @@
+/*
+ *
+ *    Copyright (c) 2020 Google LLC.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *     This file implements a unit test suite for the queue in which the
+ *     Weave Tunnel Agent holds packets for the Service while the tunnel
+ *     to the Service is not yet established.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nlunit-test.h>
+
+#include "ToolCommon.h"
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Profiles/weave-tunneling/WeaveTunnelAgent.h>
+
+#if WEAVE_CONFIG_ENABLE_TUNNELING && INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+using namespace nl::Inet;
+using namespace nl::Weave::System;
+using namespace nl::Weave::Profiles::WeaveTunnel;
+
+namespace nl {
+namespace Inet {
+
+class NL_DLL_EXPORT TunEndPointTestObject
+{
+public:
+    static bool IsReceiveEnabled(const TunEndPoint *endPoint)
+    {
+        return endPoint->mReceiveEnabled;
+    }
+};
+
+} // namespace Inet
+
+namespace Weave {
+namespace Profiles {
+namespace WeaveTunnel {
+
+class NL_DLL_EXPORT WeaveTunnelAgentTestObject
+{
+public:
+    static void SetTunEndPoint(WeaveTunnelAgent &agent, TunEndPoint *endPoint)
+    {
+        agent.mTunEP = endPoint;
+    }
+
+    static WEAVE_ERROR EnQueuePacket(WeaveTunnelAgent &agent, PacketBuffer *pkt)
+    {
+        return agent.EnQueuePacket(pkt);
+    }
+
+    static PacketBuffer *DeQueuePacket(WeaveTunnelAgent &agent)
+    {
+        return agent.DeQueuePacket();
+    }
+
+    static void DumpQueuedMessages(WeaveTunnelAgent &agent)
+    {
+        agent.DumpQueuedMessages();
+    }
+
+    static uint8_t NumQueuedPackets(const WeaveTunnelAgent &agent)
+    {
+        return agent.mNumQueuedMsgs;
+    }
+
+    static bool IsTunReceivePaused(const WeaveTunnelAgent &agent)
+    {
+        return agent.mTunReceivePaused;
+    }
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    // Clear the statistics, as Init() would; the agents under test are not initialized.
+    static void ResetStatistics(WeaveTunnelAgent &agent)
+    {
+        memset(&agent.mWeaveTunnelStats, 0, sizeof(agent.mWeaveTunnelStats));
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+};
+
+} // namespace WeaveTunnel
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#define TOOL_NAME "TestWeaveTunnelQueue"
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gNetworkOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+#define QUEUE_TEST_IPV6_HDR_SIZE       40
+#define QUEUE_TEST_PKT_SIZE            (TUN_HDR_SIZE_IN_BYTES + QUEUE_TEST_IPV6_HDR_SIZE + 8)
+#define QUEUE_TEST_LARGE_PKT_SIZE      1024
+#define QUEUE_TEST_IPPROTO_UDP         17
+#define QUEUE_TEST_IPPROTO_ICMPV6      58
+#define QUEUE_TEST_BULK_PORT           1234
+
+// Build a tunneled IPv6 packet of the given length, tagged with the given id in its flow label.
+static PacketBuffer *MakeQueueTestPacket(bool aControl, uint8_t aId, uint16_t aPktLen)
+{
+    PacketBuffer *buf = PacketBuffer::New(0);
+    uint8_t *ip6;
+
+    VerifyOrExit(buf != NULL, );
+
+    memset(buf->Start(), 0, aPktLen);
+
+    ip6 = buf->Start() + TUN_HDR_SIZE_IN_BYTES;
+    ip6[0] = 0x60;
+    ip6[3] = aId;
+
+    if (aControl)
+    {
+        ip6[6] = QUEUE_TEST_IPPROTO_ICMPV6;
+    }
+    else
+    {
+        ip6[6] = QUEUE_TEST_IPPROTO_UDP;
+        nl::Weave::Encoding::BigEndian::Put16(ip6 + QUEUE_TEST_IPV6_HDR_SIZE, QUEUE_TEST_BULK_PORT);
+        nl::Weave::Encoding::BigEndian::Put16(ip6 + QUEUE_TEST_IPV6_HDR_SIZE + 2, QUEUE_TEST_BULK_PORT);
+    }
+
+    buf->SetDataLength(aPktLen);
+
+exit:
+    return buf;
+}
+
+static uint8_t QueueTestPacketId(const PacketBuffer *aPkt)
+{
+    return aPkt->Start()[TUN_HDR_SIZE_IN_BYTES + 3];
+}
+
+static void EnQueueTestPacket(nlTestSuite *inSuite, WeaveTunnelAgent &agent, bool aControl, uint8_t aId, WEAVE_ERROR aExpectedErr,
+                              uint16_t aPktLen = QUEUE_TEST_PKT_SIZE)
+{
+    PacketBuffer *pkt = MakeQueueTestPacket(aControl, aId, aPktLen);
+    WEAVE_ERROR err;
+
+    NL_TEST_ASSERT(inSuite, pkt != NULL);
+    if (pkt == NULL)
+        return;
+
+    err = WeaveTunnelAgentTestObject::EnQueuePacket(agent, pkt);
+    NL_TEST_ASSERT(inSuite, err == aExpectedErr);
+
+    // A refused packet is left to the caller to free.
+    if (err != WEAVE_NO_ERROR)
+        PacketBuffer::Free(pkt);
+}
+
+// Check that the queue holds the packets of consecutive ids starting at the given one, in order.
+static void CheckDeQueueOrder(nlTestSuite *inSuite, WeaveTunnelAgent &agent, uint8_t aFirstId, uint8_t aNumIds)
+{
+    PacketBuffer *pkt;
+
+    for (uint8_t i = 0; i < aNumIds; i++)
+    {
+        pkt = WeaveTunnelAgentTestObject::DeQueuePacket(agent);
+        NL_TEST_ASSERT(inSuite, pkt != NULL);
+        if (pkt == NULL)
+            return;
+
+        NL_TEST_ASSERT(inSuite, QueueTestPacketId(pkt) == aFirstId + i);
+        PacketBuffer::Free(pkt);
+    }
+
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::DeQueuePacket(agent) == NULL);
+}
+
+// Test that a packet arriving at a full queue displaces the oldest bulk packet, keeping control packets.
+static void TestOldestBulkDroppedFirst(nlTestSuite *inSuite, void *inContext)
+{
+    WeaveTunnelAgent agent;
+    uint8_t i;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    WeaveTunnelAgentTestObject::ResetStatistics(agent);
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    // Fill the queue with bulk and control packets in turn, starting with bulk.
+    for (i = 0; i < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED; i++)
+    {
+        EnQueueTestPacket(inSuite, agent, (i % 2) != 0, i, WEAVE_NO_ERROR);
+    }
+
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED);
+
+    // A control packet takes the place of the oldest bulk packet, which is the first one.
+    EnQueueTestPacket(inSuite, agent, true, i, WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED);
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    {
+        WeaveTunnelStatistics stats;
+
+        NL_TEST_ASSERT(inSuite, agent.GetWeaveTunnelStatistics(stats) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedBulkMessages == 1);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedControlMessages == 0);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mPeakQueuedBytes == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED * QUEUE_TEST_PKT_SIZE);
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    // The packets left keep their arrival order.
+    CheckDeQueueOrder(inSuite, agent, 1, WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED);
+}
+
+#if WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED / QUEUE_TEST_LARGE_PKT_SIZE < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
+// Test that large packets are limited by the size of the queue before its depth, dropping the oldest bulk packet first.
+static void TestByteLimitDropsOldestBulk(nlTestSuite *inSuite, void *inContext)
+{
+    const uint8_t numFit = WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED / QUEUE_TEST_LARGE_PKT_SIZE;
+    WeaveTunnelAgent agent;
+    uint8_t i;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    WeaveTunnelAgentTestObject::ResetStatistics(agent);
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    // Fill the queue to its size with bulk and control packets in turn, starting with bulk.
+    for (i = 0; i < numFit; i++)
+    {
+        EnQueueTestPacket(inSuite, agent, (i % 2) != 0, i, WEAVE_NO_ERROR, QUEUE_TEST_LARGE_PKT_SIZE);
+    }
+
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == numFit);
+
+    // Though the queue is not full, the next packet does not fit until the oldest bulk packet is dropped.
+    EnQueueTestPacket(inSuite, agent, true, i, WEAVE_NO_ERROR, QUEUE_TEST_LARGE_PKT_SIZE);
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == numFit);
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    {
+        WeaveTunnelStatistics stats;
+
+        NL_TEST_ASSERT(inSuite, agent.GetWeaveTunnelStatistics(stats) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedBulkMessages == 1);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedControlMessages == 0);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mPeakQueuedBytes == numFit * QUEUE_TEST_LARGE_PKT_SIZE);
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    CheckDeQueueOrder(inSuite, agent, 1, numFit);
+}
+#endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED / QUEUE_TEST_LARGE_PKT_SIZE < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
+
+// Test that a full queue of control packets refuses further packets and keeps the ones it holds.
+static void TestControlOnlyQueueRefuses(nlTestSuite *inSuite, void *inContext)
+{
+    WeaveTunnelAgent agent;
+    uint8_t i;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    WeaveTunnelAgentTestObject::ResetStatistics(agent);
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    for (i = 0; i < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED; i++)
+    {
+        EnQueueTestPacket(inSuite, agent, true, i, WEAVE_NO_ERROR);
+    }
+
+    // Neither a control nor a bulk packet can take the place of a queued control packet.
+    EnQueueTestPacket(inSuite, agent, true, i, WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL);
+    EnQueueTestPacket(inSuite, agent, false, i + 1, WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL);
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED);
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    {
+        WeaveTunnelStatistics stats;
+
+        NL_TEST_ASSERT(inSuite, agent.GetWeaveTunnelStatistics(stats) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedControlMessages == 1);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mDroppedBulkMessages == 1);
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    CheckDeQueueOrder(inSuite, agent, 0, WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED);
+}
+
+// Test that reading from the Tunnel EndPoint pauses while only control packets fill the queue, and resumes once it drains.
+static void TestReceivePausedWhileQueueFull(nlTestSuite *inSuite, void *inContext)
+{
+    WeaveTunnelAgent agent;
+    TunEndPoint *tunEP = NULL;
+    INET_ERROR err;
+    uint8_t i;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    WeaveTunnelAgentTestObject::ResetStatistics(agent);
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    err = Inet.NewTunEndPoint(&tunEP);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    if (err != INET_NO_ERROR)
+        return;
+
+    WeaveTunnelAgentTestObject::SetTunEndPoint(agent, tunEP);
+
+    for (i = 0; i < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED - 1; i++)
+    {
+        EnQueueTestPacket(inSuite, agent, true, i, WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, !WeaveTunnelAgentTestObject::IsTunReceivePaused(agent));
+    }
+
+    // A full queue holding a bulk packet can still take another packet in its place.
+    EnQueueTestPacket(inSuite, agent, false, i++, WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !WeaveTunnelAgentTestObject::IsTunReceivePaused(agent));
+    NL_TEST_ASSERT(inSuite, TunEndPointTestObject::IsReceiveEnabled(tunEP));
+
+    // Once that is displaced by a control packet, nothing more fits and receive is paused.
+    EnQueueTestPacket(inSuite, agent, true, i++, WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::IsTunReceivePaused(agent));
+    NL_TEST_ASSERT(inSuite, !TunEndPointTestObject::IsReceiveEnabled(tunEP));
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    {
+        WeaveTunnelStatistics stats;
+
+        NL_TEST_ASSERT(inSuite, agent.GetWeaveTunnelStatistics(stats) == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, stats.mQueueStats.mReceivePausedCount == 1);
+    }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+
+    // Draining the queue resumes receive.
+    WeaveTunnelAgentTestObject::DumpQueuedMessages(agent);
+    NL_TEST_ASSERT(inSuite, WeaveTunnelAgentTestObject::NumQueuedPackets(agent) == 0);
+    NL_TEST_ASSERT(inSuite, !WeaveTunnelAgentTestObject::IsTunReceivePaused(agent));
+    NL_TEST_ASSERT(inSuite, TunEndPointTestObject::IsReceiveEnabled(tunEP));
+
+    tunEP->Free();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("WeaveTunnelQueue::TestOldestBulkDroppedFirst", TestOldestBulkDroppedFirst),
+#if WEAVE_CONFIG_TUNNELING_MAX_NUM_BYTES_QUEUED / QUEUE_TEST_LARGE_PKT_SIZE < WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
+    NL_TEST_DEF("WeaveTunnelQueue::TestByteLimitDropsOldestBulk", TestByteLimitDropsOldestBulk),
+#endif
+    NL_TEST_DEF("WeaveTunnelQueue::TestControlOnlyQueueRefuses", TestControlOnlyQueueRefuses),
+    NL_TEST_DEF("WeaveTunnelQueue::TestReceivePausedWhileQueueFull", TestReceivePausedWhileQueueFull),
+    NL_TEST_SENTINEL()
+};
+
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+
+    return (SUCCESS);
+}
+
+static int TestTeardown(void *inContext)
+{
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+#endif // WEAVE_CONFIG_ENABLE_TUNNELING && INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+int main(int argc, char *argv[])
+{
+#if WEAVE_CONFIG_ENABLE_TUNNELING && INET_CONFIG_ENABLE_TUN_ENDPOINT
+    SetSIGUSR1Handler();
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, NULL))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    nlTestSuite theSuite = {
+        "weave-tunnel-queue",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suite against one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else // !(WEAVE_CONFIG_ENABLE_TUNNELING && INET_CONFIG_ENABLE_TUN_ENDPOINT)
+    return 0;
+#endif // !(WEAVE_CONFIG_ENABLE_TUNNELING && INET_CONFIG_ENABLE_TUN_ENDPOINT)
+}
@@ -1012,7 +1012,17 @@ void ServiceEvents(::timeval& aSleepTime)
             printed = true;
         }
     }
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_EPOLL
+    // All sockets are registered with the system layer's readiness backend, which dispatches both I/O and timers.
+    if (SystemLayer.State() == System::kLayerState_Initialized)
+    {
+        const uint32_t kSleepTime = static_cast<uint32_t>(aSleepTime.tv_sec * 1000 + aSleepTime.tv_usec / 1000);
+        System::Error lError = SystemLayer.ServiceEvents(kSleepTime);
+
+        if (lError != WEAVE_SYSTEM_NO_ERROR)
+            printf("ServiceEvents failed: %s\n", ErrorStr(lError));
+    }
+#elif WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     fd_set readFDs, writeFDs, exceptFDs;
     int numFDs = 0;
 
@@ -1036,7 +1046,7 @@ void ServiceEvents(::timeval& aSleepTime)
         printf("select failed: %s\n", ErrorStr(System::MapErrorPOSIX(errno)));
         return;
     }
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
     if (SystemLayer.State() == System::kLayerState_Initialized)
     {
@@ -1044,11 +1054,11 @@ void ServiceEvents(::timeval& aSleepTime)
         static uint32_t sRemainingSystemLayerEventDelay = 0;
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
         SystemLayer.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
 
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
         if (SystemLayer.State() == System::kLayerState_Initialized)
@@ -1081,11 +1091,11 @@ void ServiceEvents(::timeval& aSleepTime)
         static uint32_t sRemainingInetLayerEventDelay = 0;
 #endif // INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES && WEAVE_SYSTEM_CONFIG_USE_LWIP
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
         Inet.HandleSelectResult(selectRes, &readFDs, &writeFDs, &exceptFDs);
 
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && !WEAVE_SYSTEM_CONFIG_USE_EPOLL
 
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES && WEAVE_SYSTEM_CONFIG_USE_LWIP
         if (Inet.State == InetLayer::kState_Initialized)
@@ -18,10 +18,6 @@
 #    limitations under the License.
 #
 
-# Set this value to 1 if you configured weave-bdx-common.cpp to use curl for downloading
-# the requested URI when handling a ReceiveInit
-use_curl_to_download_requested_file=0
-
 if [ -z ${srcdir}]; then
     srcdir=`pwd`
 fi
@@ -29,60 +25,76 @@ if [ -z ${builddir}]; then
     builddir="$srcdir"
 fi
 
-client_program="${builddir}/weave-bdx-client"
-server_program="${builddir}/weave-bdx-server"
+client_program="${builddir}/weave-bdx-client-development"
+server_program="${builddir}/weave-bdx-server-development"
 
 test_file_name="test-file-development.txt"
 test_file="${srcdir}/${test_file_name}"
-rcvd_dir="/tmp"
+rcvd_dir="/tmp/weave-bdx-rcvd"
+temp_dir="/tmp/weave-bdx-temp"
+download_dir="/tmp/weave-bdx-download"
 sent_file="${rcvd_dir}/${test_file_name}"
-rcvd_file="${rcvd_dir}/${test_file_name}.2"
+rcvd_file="${download_dir}/${test_file_name}"
 
-# Proactively remove the received files and set up the directory
-mkdir -p /tmp
+# Proactively remove the received files and set up the directories
+mkdir -p $rcvd_dir $temp_dir $download_dir
 rm $sent_file 2> /dev/null
 rm $rcvd_file 2> /dev/null
 
+# A larger file, sent over many blocks
+large_file_name="test-file-development-large.txt"
+large_file="${temp_dir}/${large_file_name}"
+for i in 1 2 3 4 5 6 7 8; do
+    cat $test_file
+done > $large_file
+
 # Start up the server in the background, suppressing its output for readability
-server_cmd="${server_program} 127.0.0.1"
+server_cmd="${server_program} -a 127.0.0.1 -R ${rcvd_dir}/ -T ${temp_dir}/"
 echo $server_cmd
-${server_cmd} & >/dev/null
+${server_cmd} >/dev/null 2>&1 &
+server_pid=$!
 sleep 1 # give server a chance to start
 
-# send the file from the client
-client_send_cmd="${client_program} 1@127.0.0.1 -o ${test_file_name} --upload"
-echo $client_send_cmd
-${client_send_cmd} 
-echo "Client finished running"
-echo ""
+# Send the files from the client.  The client drives the upload, so when both
+# ends are built with WEAVE_CONFIG_BDX_MAX_WINDOW_SIZE above 1, the blocks of
+# the larger file are sent a window at a time.
+for upload_file in $test_file $large_file; do
+    upload_sent_file="${rcvd_dir}/`basename ${upload_file}`"
+    rm $upload_sent_file 2> /dev/null
 
-# check if the file was sent correctly from client
-diff $test_file $sent_file > /dev/null
-result=${?}
-if [ ${result} -eq 0 ]; then
-    echo "Client sent file successfully!"
-else
-    echo "Client failed file send, error code=${result}"
-    # kill server
-    kill -9 $!
-    exit ${result}
-fi
-echo ""
-sleep 1
+    client_send_cmd="${client_program} 1@127.0.0.1 -r ${upload_file} -p"
+    echo $client_send_cmd
+    ${client_send_cmd}
+    echo "Client finished running"
+    echo ""
+    sleep 1 # give server a chance to finish writing the file
 
-# If the test was successful, run the client in the other direction and verify
-if [ $use_curl_to_download_requested_file -eq 1 ]; then
-client_recv_cmd="${client_program} 1@127.0.0.1 -o file://${sent_file}"
-else
-client_recv_cmd="${client_program} 1@127.0.0.1 -o ${sent_file}"
-fi
+    # check if the file was sent correctly from client
+    diff $upload_file $upload_sent_file > /dev/null
+    result=${?}
+    if [ ${result} -eq 0 ]; then
+        echo "Client sent `basename ${upload_file}` successfully!"
+    else
+        echo "Client failed `basename ${upload_file}` send, error code=${result}"
+        # kill server
+        kill -9 $server_pid
+        exit ${result}
+    fi
+    echo ""
+    sleep 1
+done
+
+# If the test was successful, run the client in the other direction and verify.
+# The server reads the requested file:// URI itself, or with curl when
+# weave-bdx-common-development.cpp is configured to use it.
+client_recv_cmd="${client_program} 1@127.0.0.1 -r file://${sent_file} -R ${download_dir}/"
 
 echo $client_recv_cmd
-${client_recv_cmd} 
+${client_recv_cmd}
 echo "Client finished running"
 echo ""
 
-# check if the file was sent correctly from client
+# check if the file was received correctly by the client
 diff $test_file $rcvd_file > /dev/null
 result=${?}
 if [ ${result} -eq 0 ]; then
@@ -92,6 +104,5 @@ else
 fi
 
 # kill server
-kill -9 $!
+kill -9 $server_pid
 exit ${result}
-